@@ -0,0 +1,209 @@
+/**
+  ******************************************************************************
+  * @file    sensor_bus.c
+  * @author  MEMS Application Team
+  * @brief   This file provides a queue of interrupt driven sensor transfers,
+  *          so that several sensors are read while the MCU sleeps
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "sensor_bus.h"
+
+/** @addtogroup BSP BSP
+ * @{
+ */
+
+/** @addtogroup COMPONENTS COMPONENTS
+ * @{
+ */
+
+/** @addtogroup COMMON COMMON
+ * @{
+ */
+
+/** @addtogroup SENSOR_BUS SENSOR_BUS
+ * @{
+ */
+
+/** @addtogroup SENSOR_BUS_Private_Defines Private defines
+ * @{
+ */
+
+/* The queue is shared by the application and the bus interrupt */
+#ifndef SENSOR_BUS_CRITICAL_SECTION_BEGIN
+#include "cmsis_compiler.h"
+#define SENSOR_BUS_CRITICAL_SECTION_BEGIN( )  uint32_t primask_bit = __get_PRIMASK( ); __disable_irq( )
+#define SENSOR_BUS_CRITICAL_SECTION_END( )    __set_PRIMASK( primask_bit )
+#endif
+
+/**
+ * @}
+ */
+
+/** @addtogroup SENSOR_BUS_Private_Variables Private variables
+ * @{
+ */
+
+/* Transfer in progress, followed by the pending ones */
+static SensorBusTransfer_t *SensorBusHead = NULL;
+static SensorBusTransfer_t *SensorBusTail = NULL;
+
+/**
+ * @}
+ */
+
+/** @addtogroup SENSOR_BUS_Private_Function_Prototypes Private function prototypes
+ * @{
+ */
+
+static uint8_t SensorBus_Start( SensorBusTransfer_t *transfer );
+
+/**
+ * @}
+ */
+
+/** @addtogroup SENSOR_BUS_Public_Functions Public functions
+ * @{
+ */
+
+/**
+ * @brief  Queues a transfer, started at once if the bus is idle
+ * @param  transfer the transfer, owned by the caller until its callback
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ * @note   May be called from a transfer callback, e.g. to chain transfers
+ */
+DrvStatusTypeDef SensorBus_Submit( SensorBusTransfer_t *transfer )
+{
+  uint8_t start = 0;
+
+  if ( transfer == NULL || transfer->handle == NULL )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  transfer->next = NULL;
+
+  SENSOR_BUS_CRITICAL_SECTION_BEGIN( );
+  if ( SensorBusHead == NULL )
+  {
+    SensorBusHead = transfer;
+    start = 1;
+  }
+  else
+  {
+    SensorBusTail->next = transfer;
+  }
+  SensorBusTail = transfer;
+  SENSOR_BUS_CRITICAL_SECTION_END( );
+
+  if ( start == 1 && SensorBus_Start( transfer ) )
+  {
+    SensorBus_TransferComplete( COMPONENT_ERROR );
+  }
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief  Tells whether transfers are queued or in progress
+ * @param  None
+ * @retval 1 if busy, 0 if idle
+ */
+uint8_t SensorBus_IsBusy( void )
+{
+  return ( SensorBusHead != NULL ) ? 1 : 0;
+}
+
+/**
+ * @brief  Completes the transfer in progress and starts the next one. Called by
+ *         the board from the bus interrupt
+ * @param  status COMPONENT_OK or COMPONENT_ERROR
+ * @retval None
+ */
+void SensorBus_TransferComplete( DrvStatusTypeDef status )
+{
+  SensorBusTransfer_t *transfer = SensorBusHead;
+
+  while ( transfer != NULL )
+  {
+    /* The transfer stays at the head during its callback, so that the ones
+       queued by the callback are started after it, in order */
+    if ( transfer->callback != NULL )
+    {
+      transfer->callback( transfer, status );
+    }
+
+    SENSOR_BUS_CRITICAL_SECTION_BEGIN( );
+    SensorBusHead = transfer->next;
+    transfer = SensorBusHead;
+    SENSOR_BUS_CRITICAL_SECTION_END( );
+
+    if ( transfer == NULL || SensorBus_Start( transfer ) == 0 )
+    {
+      return;
+    }
+    status = COMPONENT_ERROR;
+  }
+}
+
+/**
+ * @}
+ */
+
+/** @addtogroup SENSOR_BUS_Private_Functions Private functions
+ * @{
+ */
+
+/**
+ * @brief  Starts a transfer on the board bus
+ * @param  transfer the transfer
+ * @retval 0 in case of success
+ * @retval 1 in case of failure
+ */
+static uint8_t SensorBus_Start( SensorBusTransfer_t *transfer )
+{
+  if ( transfer->isWrite )
+  {
+    return Sensor_IO_Write_IT( transfer->handle, transfer->reg, transfer->pBuffer, transfer->size );
+  }
+  else
+  {
+    return Sensor_IO_Read_IT( transfer->handle, transfer->reg, transfer->pBuffer, transfer->size );
+  }
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
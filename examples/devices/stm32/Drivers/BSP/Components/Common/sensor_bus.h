@@ -0,0 +1,121 @@
+/**
+  ******************************************************************************
+  * @file    sensor_bus.h
+  * @author  MEMS Application Team
+  * @brief   This header file contains the functions prototypes for the
+  *          interrupt driven sensor bus
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SENSOR_BUS_H
+#define __SENSOR_BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "component.h"
+
+/** @addtogroup BSP BSP
+ * @{
+ */
+
+/** @addtogroup COMPONENTS COMPONENTS
+ * @{
+ */
+
+/** @addtogroup COMMON COMMON
+ * @{
+ */
+
+/** @addtogroup SENSOR_BUS SENSOR_BUS
+ * @{
+ */
+
+/** @addtogroup SENSOR_BUS_Public_Types SENSOR_BUS Public Types
+ * @{
+ */
+
+struct SensorBusTransfer_s;
+
+/**
+ * @brief  Transfer completion callback, called from the bus interrupt
+ */
+typedef void ( *SensorBusCallback_t )( struct SensorBusTransfer_s *transfer, DrvStatusTypeDef status );
+
+/**
+ * @brief  Sensor bus transfer structure definition. The transfers are owned by
+ *         the caller and must stay valid until their callback is called.
+ */
+typedef struct SensorBusTransfer_s
+{
+  void *handle;                  /* Sensor handle, as for Sensor_IO_Read/Write */
+  uint8_t reg;                   /* First register, with the auto-increment bit of the sensor if any */
+  uint8_t isWrite;               /* 1 to write the buffer to the sensor, 0 to read it */
+  uint8_t *pBuffer;
+  uint16_t size;
+  SensorBusCallback_t callback;  /* NULL if not needed */
+  void *context;                 /* Left to the caller */
+  struct SensorBusTransfer_s *next;
+} SensorBusTransfer_t;
+
+/**
+ * @}
+ */
+
+/** @addtogroup SENSOR_BUS_Public_Functions SENSOR_BUS Public Functions
+ * @{
+ */
+
+/* Queue, common to all the boards */
+DrvStatusTypeDef SensorBus_Submit( SensorBusTransfer_t *transfer );
+uint8_t SensorBus_IsBusy( void );
+void SensorBus_TransferComplete( DrvStatusTypeDef status );
+
+/* Link functions, implemented by the board: start a transfer and return at once */
+uint8_t Sensor_IO_Read_IT( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead );
+uint8_t Sensor_IO_Write_IT( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite );
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_BUS_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
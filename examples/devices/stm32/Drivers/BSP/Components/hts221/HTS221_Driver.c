@@ -67,6 +67,8 @@ extern uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer,
 * @{
 */
 
+static int32_t HTS221_Div_Round(int32_t numerator, int32_t denominator);
+
 /**
 * @}
 */
@@ -75,6 +77,20 @@ extern uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer,
 * @{
 */
 
+/**
+* @brief  Divide, rounding to the nearest integer.
+* @param  numerator dividend, |numerator| < 2^30.
+* @param  denominator divisor, not 0.
+* @retval Quotient.
+*/
+static int32_t HTS221_Div_Round(int32_t numerator, int32_t denominator)
+{
+  if((numerator < 0) == (denominator < 0))
+    return (numerator + denominator / 2) / denominator;
+  else
+    return (numerator - denominator / 2) / denominator;
+}
+
 /**
 * @}
 */
@@ -271,10 +287,11 @@ HTS221_Error_et HTS221_DeInit(void *handle)
 */
 HTS221_Error_et HTS221_Get_Measurement(void *handle, uint16_t* humidity, int16_t* temperature)
 {
-  if ( HTS221_Get_Temperature( handle, temperature ) == HTS221_ERROR ) return HTS221_ERROR;
-  if ( HTS221_Get_Humidity( handle, humidity ) == HTS221_ERROR ) return HTS221_ERROR;
+  HTS221_Calibration_st calibration;
 
-  return HTS221_OK;
+  if ( HTS221_Get_Calibration( handle, &calibration ) == HTS221_ERROR ) return HTS221_ERROR;
+
+  return HTS221_Get_CalibratedMeasurement( handle, &calibration, humidity, temperature );
 }
 
 /**
@@ -298,41 +315,129 @@ HTS221_Error_et HTS221_Get_RawMeasurement(void *handle, int16_t* humidity, int16
 }
 
 /**
-* @brief  Read HTS221 Humidity output registers, and calculate humidity.
+* @brief  Read HTS221 calibration registers in one burst, and calculate the slopes of the outputs.
+*         The calibration is written at the factory and does not change: read it once at init
+*         and use HTS221_Get_CalibratedMeasurement or HTS221_Calc_Humidity/Temperature afterwards.
 * @param  *handle Device handle.
-* @param  Pointer to the returned humidity value that must be divided by 10 to get the value in [%].
+* @param  calibration pointer to the returned calibration.
 * @retval Error code [HTS221_OK, HTS221_ERROR].
 */
-HTS221_Error_et HTS221_Get_Humidity(void *handle, uint16_t* value)
+HTS221_Error_et HTS221_Get_Calibration(void *handle, HTS221_Calibration_st* calibration)
 {
-  int16_t H0_T0_out, H1_T0_out, H_T_out;
-  int16_t H0_rh, H1_rh;
-  uint8_t buffer[2];
-  float   tmp_f;
+  int16_t H0_T0_out, H1_T0_out, T0_out, T1_out;
+  int32_t H0_rh_x2, H1_rh_x2, T0_degC_x8, T1_degC_x8;
+  uint8_t buffer[HTS221_CALIBRATION_SIZE];
 
-  if(HTS221_ReadReg(handle, HTS221_H0_RH_X2, 2, buffer))
+  if(HTS221_ReadReg(handle, HTS221_H0_RH_X2, HTS221_CALIBRATION_SIZE, buffer))
     return HTS221_ERROR;
-  H0_rh = buffer[0] >> 1;
-  H1_rh = buffer[1] >> 1;
 
-  if(HTS221_ReadReg(handle, HTS221_H0_T0_OUT_L, 2, buffer))
+  H0_rh_x2 = buffer[HTS221_H0_RH_X2 - HTS221_H0_RH_X2];
+  H1_rh_x2 = buffer[HTS221_H1_RH_X2 - HTS221_H0_RH_X2];
+  T0_degC_x8 = (((uint16_t)(buffer[HTS221_T0_T1_DEGC_H2 - HTS221_H0_RH_X2] & 0x03)) << 8) |
+               ((uint16_t)buffer[HTS221_T0_DEGC_X8 - HTS221_H0_RH_X2]);
+  T1_degC_x8 = (((uint16_t)(buffer[HTS221_T0_T1_DEGC_H2 - HTS221_H0_RH_X2] & 0x0C)) << 6) |
+               ((uint16_t)buffer[HTS221_T1_DEGC_X8 - HTS221_H0_RH_X2]);
+  H0_T0_out = (int16_t)((((uint16_t)buffer[HTS221_H0_T0_OUT_H - HTS221_H0_RH_X2]) << 8) |
+                        (uint16_t)buffer[HTS221_H0_T0_OUT_L - HTS221_H0_RH_X2]);
+  H1_T0_out = (int16_t)((((uint16_t)buffer[HTS221_H1_T0_OUT_H - HTS221_H0_RH_X2]) << 8) |
+                        (uint16_t)buffer[HTS221_H1_T0_OUT_L - HTS221_H0_RH_X2]);
+  T0_out = (int16_t)((((uint16_t)buffer[HTS221_T0_OUT_H - HTS221_H0_RH_X2]) << 8) |
+                     (uint16_t)buffer[HTS221_T0_OUT_L - HTS221_H0_RH_X2]);
+  T1_out = (int16_t)((((uint16_t)buffer[HTS221_T1_OUT_H - HTS221_H0_RH_X2]) << 8) |
+                     (uint16_t)buffer[HTS221_T1_OUT_L - HTS221_H0_RH_X2]);
+
+  /* blank or corrupted calibration */
+  if((H1_T0_out == H0_T0_out) || (T1_out == T0_out))
     return HTS221_ERROR;
-  H0_T0_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
 
-  if(HTS221_ReadReg(handle, HTS221_H1_T0_OUT_L, 2, buffer))
+  /* 1/10 of % is 5 times the rH x2 calibration values, 1/10 of 'C 5/4 times the 'C x8 ones */
+  calibration->h_out0 = H0_T0_out;
+  calibration->h_out0_value = (H0_rh_x2 * 5) << HTS221_CALIBRATION_SHIFT;
+  calibration->h_slope = HTS221_Div_Round((H1_rh_x2 - H0_rh_x2) * 5 * (1 << HTS221_CALIBRATION_SHIFT),
+                                          (int32_t)H1_T0_out - H0_T0_out);
+  calibration->t_out0 = T0_out;
+  calibration->t_out0_value = (T0_degC_x8 * 5) << (HTS221_CALIBRATION_SHIFT - 2);
+  calibration->t_slope = HTS221_Div_Round((T1_degC_x8 - T0_degC_x8) * 5 * (1 << (HTS221_CALIBRATION_SHIFT - 2)),
+                                          (int32_t)T1_out - T0_out);
+
+  return HTS221_OK;
+}
+
+/**
+* @brief  Read HTS221 output registers in one burst, and calculate humidity and temperature.
+* @param  *handle Device handle.
+* @param  calibration pointer to the calibration read by HTS221_Get_Calibration.
+* @param  humidity pointer to the returned humidity value that must be divided by 10 to get the value in [%].
+* @param  temperature pointer to the returned temperature value that must be divided by 10 to get the value in ['C].
+* @retval Error code [HTS221_OK, HTS221_ERROR].
+*/
+HTS221_Error_et HTS221_Get_CalibratedMeasurement(void *handle, HTS221_Calibration_st* calibration, uint16_t* humidity, int16_t* temperature)
+{
+  int16_t H_T_out, T_out;
+
+  if(HTS221_Get_RawMeasurement(handle, &H_T_out, &T_out))
     return HTS221_ERROR;
-  H1_T0_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
 
-  if(HTS221_ReadReg(handle, HTS221_HR_OUT_L_REG, 2, buffer))
+  *humidity = HTS221_Calc_Humidity(calibration, H_T_out);
+  *temperature = HTS221_Calc_Temperature(calibration, T_out);
+
+  return HTS221_OK;
+}
+
+/**
+* @brief  Calculate humidity from the raw output, without floating point.
+* @param  calibration pointer to the calibration read by HTS221_Get_Calibration.
+* @param  raw humidity raw value.
+* @retval Humidity value that must be divided by 10 to get the value in [%], 0 to 1000.
+*/
+uint16_t HTS221_Calc_Humidity(HTS221_Calibration_st* calibration, int16_t raw)
+{
+  int64_t tmp;
+
+  tmp = (int64_t)((int32_t)raw - calibration->h_out0) * calibration->h_slope + calibration->h_out0_value;
+  tmp = (tmp + (1 << (HTS221_CALIBRATION_SHIFT - 1))) >> HTS221_CALIBRATION_SHIFT;
+
+  return ( tmp > 1000 ) ? 1000
+         : ( tmp <    0 ) ?    0
+         : ( uint16_t )tmp;
+}
+
+/**
+* @brief  Calculate temperature from the raw output, without floating point.
+* @param  calibration pointer to the calibration read by HTS221_Get_Calibration.
+* @param  raw temperature raw value.
+* @retval Temperature value that must be divided by 10 to get the value in ['C].
+*/
+int16_t HTS221_Calc_Temperature(HTS221_Calibration_st* calibration, int16_t raw)
+{
+  int64_t tmp;
+
+  tmp = (int64_t)((int32_t)raw - calibration->t_out0) * calibration->t_slope + calibration->t_out0_value;
+  tmp = (tmp + (1 << (HTS221_CALIBRATION_SHIFT - 1))) >> HTS221_CALIBRATION_SHIFT;
+
+  return ( tmp > INT16_MAX ) ? INT16_MAX
+         : ( tmp < INT16_MIN ) ? INT16_MIN
+         : ( int16_t )tmp;
+}
+
+/**
+* @brief  Read HTS221 Humidity output registers, and calculate humidity.
+* @param  *handle Device handle.
+* @param  Pointer to the returned humidity value that must be divided by 10 to get the value in [%].
+* @retval Error code [HTS221_OK, HTS221_ERROR].
+*/
+HTS221_Error_et HTS221_Get_Humidity(void *handle, uint16_t* value)
+{
+  HTS221_Calibration_st calibration;
+  int16_t H_T_out;
+
+  if(HTS221_Get_Calibration(handle, &calibration))
     return HTS221_ERROR;
-  H_T_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
 
-  tmp_f = (float)(H_T_out - H0_T0_out) * (float)(H1_rh - H0_rh) / (float)(H1_T0_out - H0_T0_out)  +  H0_rh;
-  tmp_f *= 10.0f;
+  if(HTS221_Get_HumidityRaw(handle, &H_T_out))
+    return HTS221_ERROR;
 
-  *value = ( tmp_f > 1000.0f ) ? 1000
-           : ( tmp_f <    0.0f ) ?    0
-           : ( uint16_t )tmp_f;
+  *value = HTS221_Calc_Humidity(&calibration, H_T_out);
 
   return HTS221_OK;
 }
@@ -363,36 +468,16 @@ HTS221_Error_et HTS221_Get_HumidityRaw(void *handle, int16_t* value)
 */
 HTS221_Error_et HTS221_Get_Temperature(void *handle, int16_t *value)
 {
-  int16_t T0_out, T1_out, T_out, T0_degC_x8_u16, T1_degC_x8_u16;
-  int16_t T0_degC, T1_degC;
-  uint8_t buffer[4], tmp;
-  float   tmp_f;
+  HTS221_Calibration_st calibration;
+  int16_t T_out;
 
-  if(HTS221_ReadReg(handle, HTS221_T0_DEGC_X8, 2, buffer))
-    return HTS221_ERROR;
-  if(HTS221_ReadReg(handle, HTS221_T0_T1_DEGC_H2, 1, &tmp))
+  if(HTS221_Get_Calibration(handle, &calibration))
     return HTS221_ERROR;
 
-  T0_degC_x8_u16 = (((uint16_t)(tmp & 0x03)) << 8) | ((uint16_t)buffer[0]);
-  T1_degC_x8_u16 = (((uint16_t)(tmp & 0x0C)) << 6) | ((uint16_t)buffer[1]);
-  T0_degC = T0_degC_x8_u16 >> 3;
-  T1_degC = T1_degC_x8_u16 >> 3;
-
-  if(HTS221_ReadReg(handle, HTS221_T0_OUT_L, 4, buffer))
+  if(HTS221_Get_TemperatureRaw(handle, &T_out))
     return HTS221_ERROR;
 
-  T0_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
-  T1_out = (((uint16_t)buffer[3]) << 8) | (uint16_t)buffer[2];
-
-  if(HTS221_ReadReg(handle, HTS221_TEMP_OUT_L_REG, 2, buffer))
-    return HTS221_ERROR;
-
-  T_out = (((uint16_t)buffer[1]) << 8) | (uint16_t)buffer[0];
-
-  tmp_f = (float)(T_out - T0_out) * (float)(T1_degC - T0_degC) / (float)(T1_out - T0_out)  +  T0_degC;
-  tmp_f *= 10.0f;
-
-  *value = ( int16_t )tmp_f;
+  *value = HTS221_Calc_Temperature(&calibration, T_out);
 
   return HTS221_OK;
 }
@@ -195,6 +195,21 @@ typedef struct
   HTS221_State_et       irq_enable;       /*!< HTS221_ENABLE/HTS221_DISABLE interrupt on DRDY pin */
 } HTS221_Init_st;
 
+/**
+* @brief  HTS221 calibration structure definition.
+*         The outputs are converted as value = out0_value + (raw - out0) * slope,
+*         in 1/10 of % or 'C, with the slope and out0_value scaled by 2^HTS221_CALIBRATION_SHIFT.
+*/
+typedef struct
+{
+  int16_t               h_out0;           /*!< Raw humidity at the first calibration point */
+  int32_t               h_out0_value;     /*!< Humidity at the first calibration point */
+  int32_t               h_slope;          /*!< Humidity per LSB */
+  int16_t               t_out0;           /*!< Raw temperature at the first calibration point */
+  int32_t               t_out0_value;     /*!< Temperature at the first calibration point */
+  int32_t               t_slope;          /*!< Temperature per LSB */
+} HTS221_Calibration_st;
+
 /**
 * @}
 */
@@ -435,6 +450,16 @@ typedef struct
 #define HTS221_T1_OUT_L        (uint8_t)0x3E
 #define HTS221_T1_OUT_H        (uint8_t)0x3F
 
+/**
+* @brief Size of the calibration registers, from HTS221_H0_RH_X2 to HTS221_T1_OUT_H
+*/
+#define HTS221_CALIBRATION_SIZE   16
+
+/**
+* @brief Fractional bits of the calibration slopes and values, see HTS221_Calibration_st
+*/
+#define HTS221_CALIBRATION_SHIFT  16
+
 
 /**
 * @}
@@ -464,6 +489,10 @@ HTS221_Error_et HTS221_IsMeasurementCompleted(void *handle, HTS221_BitStatus_et*
 
 HTS221_Error_et HTS221_Get_Measurement(void *handle, uint16_t* humidity, int16_t* temperature);
 HTS221_Error_et HTS221_Get_RawMeasurement(void *handle, int16_t* humidity, int16_t* temperature);
+HTS221_Error_et HTS221_Get_Calibration(void *handle, HTS221_Calibration_st* calibration);
+HTS221_Error_et HTS221_Get_CalibratedMeasurement(void *handle, HTS221_Calibration_st* calibration, uint16_t* humidity, int16_t* temperature);
+uint16_t HTS221_Calc_Humidity(HTS221_Calibration_st* calibration, int16_t raw);
+int16_t HTS221_Calc_Temperature(HTS221_Calibration_st* calibration, int16_t raw);
 HTS221_Error_et HTS221_Get_Humidity(void *handle, uint16_t* value);
 HTS221_Error_et HTS221_Get_HumidityRaw(void *handle, int16_t* value);
 HTS221_Error_et HTS221_Get_TemperatureRaw(void *handle, int16_t* value);
@@ -94,13 +94,13 @@ static DrvStatusTypeDef HTS221_T_Get_DRDY_Status( DrvContextTypeDef *handle, uin
  * @{
  */
 
-static DrvStatusTypeDef HTS221_Init( DrvContextTypeDef *handle );
+static DrvStatusTypeDef HTS221_Init( DrvContextTypeDef *handle, HTS221_Combo_Data_t *comboData );
 static DrvStatusTypeDef HTS221_Sensor_Enable( DrvContextTypeDef *handle );
 static DrvStatusTypeDef HTS221_Sensor_Disable( DrvContextTypeDef *handle );
 static DrvStatusTypeDef HTS221_Get_WhoAmI( DrvContextTypeDef *handle, uint8_t *who_am_i );
 static DrvStatusTypeDef HTS221_Check_WhoAmI( DrvContextTypeDef *handle );
-static DrvStatusTypeDef HTS221_Get_Hum( DrvContextTypeDef *handle, float *humidity );
-static DrvStatusTypeDef HTS221_Get_Temp( DrvContextTypeDef *handle, float *temperature );
+static DrvStatusTypeDef HTS221_Get_Hum( DrvContextTypeDef *handle, HTS221_Combo_Data_t *comboData, float *humidity );
+static DrvStatusTypeDef HTS221_Get_Temp( DrvContextTypeDef *handle, HTS221_Combo_Data_t *comboData, float *temperature );
 static DrvStatusTypeDef HTS221_Get_ODR( DrvContextTypeDef *handle, float *odr );
 static DrvStatusTypeDef HTS221_Set_ODR( DrvContextTypeDef *handle, SensorOdr_t odr );
 static DrvStatusTypeDef HTS221_Set_ODR_Value( DrvContextTypeDef *handle, float odr );
@@ -181,7 +181,7 @@ static DrvStatusTypeDef HTS221_H_Init( DrvContextTypeDef *handle )
   /* If yes, skip the initialize function, if not call initialize function */
   if ((((HTS221_H_Data_t *)(((HUMIDITY_Data_t *)(handle->pData))->pComponentData))->comboData->isTempInitialized == 0))
   {
-    if(HTS221_Init(handle) == COMPONENT_ERROR)
+    if(HTS221_Init(handle, ((HTS221_H_Data_t *)(((HUMIDITY_Data_t *)(handle->pData))->pComponentData))->comboData) == COMPONENT_ERROR)
     {
       return COMPONENT_ERROR;
     }
@@ -326,7 +326,7 @@ static DrvStatusTypeDef HTS221_H_Check_WhoAmI( DrvContextTypeDef *handle )
 static DrvStatusTypeDef HTS221_H_Get_Hum( DrvContextTypeDef *handle, float *humidity )
 {
 
-  return HTS221_Get_Hum( handle, humidity );
+  return HTS221_Get_Hum( handle, ((HTS221_H_Data_t *)(((HUMIDITY_Data_t *)(handle->pData))->pComponentData))->comboData, humidity );
 }
 
 
@@ -459,7 +459,7 @@ static DrvStatusTypeDef HTS221_T_Init( DrvContextTypeDef *handle )
   /* If yes, skip the initialize function, if not call initialize function */
   if((((HTS221_T_Data_t *)(((TEMPERATURE_Data_t *)(handle->pData))->pComponentData))->comboData->isHumInitialized == 0))
   {
-    if(HTS221_Init(handle) == COMPONENT_ERROR)
+    if(HTS221_Init(handle, ((HTS221_T_Data_t *)(((TEMPERATURE_Data_t *)(handle->pData))->pComponentData))->comboData) == COMPONENT_ERROR)
     {
       return COMPONENT_ERROR;
     }
@@ -602,7 +602,7 @@ static DrvStatusTypeDef HTS221_T_Check_WhoAmI( DrvContextTypeDef *handle )
 static DrvStatusTypeDef HTS221_T_Get_Temp( DrvContextTypeDef *handle, float *temperature )
 {
 
-  return HTS221_Get_Temp( handle, temperature );
+  return HTS221_Get_Temp( handle, ((HTS221_T_Data_t *)(((TEMPERATURE_Data_t *)(handle->pData))->pComponentData))->comboData, temperature );
 }
 
 
@@ -721,6 +721,98 @@ static DrvStatusTypeDef HTS221_T_Get_DRDY_Status( DrvContextTypeDef *handle, uin
   return COMPONENT_OK;
 }
 
+/**
+ * @}
+ */
+
+/** @addtogroup HTS221_Public_Functions Public functions
+ * @{
+ */
+
+/**
+ * @brief Get the humidity and temperature values of the HTS221 sensor in one burst read
+ * @param handle the humidity sensor device handle
+ * @param humidity pointer where the humidity value is written [%]
+ * @param temperature pointer where the temperature value is written [C]
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef HTS221_H_Get_Hum_Temp( DrvContextTypeDef *handle, float *humidity, float *temperature )
+{
+
+  uint16_t uint16data = 0;
+  int16_t int16data = 0;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&HTS221_H_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* Read data from HTS221. */
+  if ( HTS221_Get_CalibratedMeasurement( (void *)handle, &((HTS221_H_Data_t *)(((HUMIDITY_Data_t *)(handle->pData))->pComponentData))->comboData->calibration, &uint16data, &int16data ) == HTS221_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  *humidity = ( float )uint16data / 10.0f;
+  *temperature = ( float )int16data / 10.0f;
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Queue the burst read of the HTS221 humidity and temperature outputs on the sensor bus
+ * @param handle the humidity sensor device handle
+ * @param transfer the transfer to queue, its callback and context set by the caller
+ * @param pBuffer HTS221_HUM_TEMP_ASYNC_SIZE bytes, to decode with HTS221_H_Decode_Hum_Temp once completed
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef HTS221_H_Get_Hum_Temp_Async( DrvContextTypeDef *handle, SensorBusTransfer_t *transfer, uint8_t *pBuffer )
+{
+
+  if ( handle == NULL || handle->pVTable != ( void * )&HTS221_H_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  transfer->handle = ( void * )handle;
+  /* The MSB of the sub-address enables the address auto increment */
+  transfer->reg = HTS221_HR_OUT_L_REG | 0x80;
+  transfer->isWrite = 0;
+  transfer->pBuffer = pBuffer;
+  transfer->size = HTS221_HUM_TEMP_ASYNC_SIZE;
+
+  return SensorBus_Submit( transfer );
+}
+
+/**
+ * @brief Convert the outputs read by HTS221_H_Get_Hum_Temp_Async
+ * @param handle the humidity sensor device handle
+ * @param pBuffer the buffer of the completed transfer
+ * @param humidity pointer where the humidity value is written [%]
+ * @param temperature pointer where the temperature value is written [C]
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef HTS221_H_Decode_Hum_Temp( DrvContextTypeDef *handle, uint8_t *pBuffer, float *humidity, float *temperature )
+{
+
+  HTS221_Calibration_st *calibration;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&HTS221_H_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  calibration = &((HTS221_H_Data_t *)(((HUMIDITY_Data_t *)(handle->pData))->pComponentData))->comboData->calibration;
+
+  *humidity = ( float )HTS221_Calc_Humidity( calibration, ( int16_t )((((uint16_t)pBuffer[1]) << 8) | pBuffer[0]) ) / 10.0f;
+  *temperature = ( float )HTS221_Calc_Temperature( calibration, ( int16_t )((((uint16_t)pBuffer[3]) << 8) | pBuffer[2]) ) / 10.0f;
+
+  return COMPONENT_OK;
+}
+
 /**
  * @}
  */
@@ -732,10 +824,11 @@ static DrvStatusTypeDef HTS221_T_Get_DRDY_Status( DrvContextTypeDef *handle, uin
 /**
  * @brief Initialize the HTS221 sensor
  * @param handle the device handle
+ * @param comboData the combo data where the calibration is kept
  * @retval COMPONENT_OK in case of success
  * @retval COMPONENT_ERROR in case of failure
  */
-static DrvStatusTypeDef HTS221_Init( DrvContextTypeDef *handle )
+static DrvStatusTypeDef HTS221_Init( DrvContextTypeDef *handle, HTS221_Combo_Data_t *comboData )
 {
 
   if ( HTS221_Check_WhoAmI( handle ) == COMPONENT_ERROR )
@@ -743,6 +836,12 @@ static DrvStatusTypeDef HTS221_Init( DrvContextTypeDef *handle )
     return COMPONENT_ERROR;
   }
 
+  /* Read the calibration once, instead of with every sample */
+  if ( HTS221_Get_Calibration( (void *)handle, &comboData->calibration ) == HTS221_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
   /* Power down the device */
   if ( HTS221_DeActivate( (void *)handle ) == HTS221_ERROR )
   {
@@ -845,22 +944,23 @@ static DrvStatusTypeDef HTS221_Check_WhoAmI( DrvContextTypeDef *handle )
 /**
  * @brief Get the humidity value of the HTS221 sensor
  * @param handle the device handle
+ * @param comboData the combo data where the calibration is kept
  * @param humidity pointer where the value is written
  * @retval COMPONENT_OK in case of success
  * @retval COMPONENT_ERROR in case of failure
  */
-static DrvStatusTypeDef HTS221_Get_Hum( DrvContextTypeDef *handle, float *humidity )
+static DrvStatusTypeDef HTS221_Get_Hum( DrvContextTypeDef *handle, HTS221_Combo_Data_t *comboData, float *humidity )
 {
 
-  uint16_t uint16data = 0;
+  int16_t int16data = 0;
 
   /* Read data from HTS221. */
-  if ( HTS221_Get_Humidity( (void *)handle, &uint16data ) == HTS221_ERROR )
+  if ( HTS221_Get_HumidityRaw( (void *)handle, &int16data ) == HTS221_ERROR )
   {
     return COMPONENT_ERROR;
   }
 
-  *humidity = ( float )uint16data / 10.0f;
+  *humidity = ( float )HTS221_Calc_Humidity( &comboData->calibration, int16data ) / 10.0f;
 
   return COMPONENT_OK;
 }
@@ -868,22 +968,23 @@ static DrvStatusTypeDef HTS221_Get_Hum( DrvContextTypeDef *handle, float *humidi
 /**
  * @brief Get the temperature value of the HTS221 sensor
  * @param handle the device handle
+ * @param comboData the combo data where the calibration is kept
  * @param temperature pointer where the value is written
  * @retval COMPONENT_OK in case of success
  * @retval COMPONENT_ERROR in case of failure
  */
-static DrvStatusTypeDef HTS221_Get_Temp( DrvContextTypeDef *handle, float *temperature )
+static DrvStatusTypeDef HTS221_Get_Temp( DrvContextTypeDef *handle, HTS221_Combo_Data_t *comboData, float *temperature )
 {
 
   int16_t int16data = 0;
 
   /* Read data from HTS221. */
-  if ( HTS221_Get_Temperature( (void *)handle, &int16data ) == HTS221_ERROR )
+  if ( HTS221_Get_TemperatureRaw( (void *)handle, &int16data ) == HTS221_ERROR )
   {
     return COMPONENT_ERROR;
   }
 
-  *temperature = ( float )int16data / 10.0f;
+  *temperature = ( float )HTS221_Calc_Temperature( &comboData->calibration, int16data ) / 10.0f;
 
   return COMPONENT_OK;
 }
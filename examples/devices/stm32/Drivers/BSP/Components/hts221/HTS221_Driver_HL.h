@@ -48,6 +48,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "humidity.h"
 #include "temperature.h"
+#include "sensor_bus.h"
 
 /* Include sensor component drivers. */
 #include "HTS221_Driver.h"
@@ -100,6 +101,7 @@ typedef struct
   uint8_t isTempInitialized;
   uint8_t isHumEnabled;
   uint8_t isTempEnabled;
+  HTS221_Calibration_st calibration;    /* Read once at init, shared by the humidity and temperature sensors */
 } HTS221_Combo_Data_t;
 
 /**
@@ -133,6 +135,21 @@ extern HUMIDITY_Drv_t HTS221_H_Drv;
 extern TEMPERATURE_Drv_t HTS221_T_Drv;
 extern HTS221_Combo_Data_t HTS221_Combo_Data[HTS221_SENSORS_MAX_NUM];
 
+/**
+ * @}
+ */
+
+/** @addtogroup HTS221_Public_Functions Public functions
+ * @{
+ */
+
+/* Size of the buffer of HTS221_H_Get_Hum_Temp_Async: HUMIDITY_OUT_L to TEMP_OUT_H */
+#define HTS221_HUM_TEMP_ASYNC_SIZE  4
+
+DrvStatusTypeDef HTS221_H_Get_Hum_Temp( DrvContextTypeDef *handle, float *humidity, float *temperature );
+DrvStatusTypeDef HTS221_H_Get_Hum_Temp_Async( DrvContextTypeDef *handle, SensorBusTransfer_t *transfer, uint8_t *pBuffer );
+DrvStatusTypeDef HTS221_H_Decode_Hum_Temp( DrvContextTypeDef *handle, uint8_t *pBuffer, float *humidity, float *temperature );
+
 /**
  * @}
  */
@@ -859,6 +859,67 @@ static DrvStatusTypeDef LPS22HB_T_Get_DRDY_Status( DrvContextTypeDef *handle, ui
 }
 
 
+/**
+ * @}
+ */
+
+/** @addtogroup LPS22HB_Public_Functions Public functions
+ * @{
+ */
+
+/**
+ * @brief Queue the burst read of the LPS22HB pressure and temperature outputs on the sensor bus
+ * @param handle the pressure sensor device handle
+ * @param transfer the transfer to queue, its callback and context set by the caller
+ * @param pBuffer LPS22HB_PRESS_TEMP_ASYNC_SIZE bytes, to decode with LPS22HB_P_Decode_Press_Temp once completed
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LPS22HB_P_Get_Press_Temp_Async( DrvContextTypeDef *handle, SensorBusTransfer_t *transfer, uint8_t *pBuffer )
+{
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LPS22HB_P_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* The registers are contiguous and IF_ADD_INC is set by default */
+  transfer->handle = ( void * )handle;
+  transfer->reg = LPS22HB_PRESS_OUT_XL_REG;
+  transfer->isWrite = 0;
+  transfer->pBuffer = pBuffer;
+  transfer->size = LPS22HB_PRESS_TEMP_ASYNC_SIZE;
+
+  return SensorBus_Submit( transfer );
+}
+
+/**
+ * @brief Convert the outputs read by LPS22HB_P_Get_Press_Temp_Async, as LPS22HB_Get_Pressure and LPS22HB_Get_Temperature
+ * @param pBuffer the buffer of the completed transfer
+ * @param pressure pointer where the pressure value is written [hPa]
+ * @param temperature pointer where the temperature value is written [C]
+ * @retval None
+ */
+void LPS22HB_P_Decode_Press_Temp( uint8_t *pBuffer, float *pressure, float *temperature )
+{
+
+  uint32_t raw_press;
+  int16_t raw_temp;
+
+  raw_press = ((uint32_t)pBuffer[0]) | (((uint32_t)pBuffer[1]) << 8) | (((uint32_t)pBuffer[2]) << 16);
+
+  /* convert the 2's complement 24 bit to 2's complement 32 bit */
+  if ( raw_press & 0x00800000 )
+  {
+    raw_press |= 0xFF000000;
+  }
+
+  raw_temp = ( int16_t )((((uint16_t)pBuffer[4]) << 8) + (uint16_t)pBuffer[3]);
+
+  *pressure = ( float )((( int32_t )raw_press * 100) / 4096) / 100.0f;
+  *temperature = ( float )((raw_temp * 10) / 100) / 10.0f;
+}
+
 /**
  * @}
  */
@@ -48,6 +48,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "pressure.h"
 #include "temperature.h"
+#include "sensor_bus.h"
 
 /* Include pressure sensor component drivers. */
 #include "LPS22HB_Driver.h"
@@ -177,6 +178,20 @@ extern LPS22HB_Combo_Data_t LPS22HB_Combo_Data[LPS22HB_SENSORS_MAX_NUM];
 extern LPS22HB_P_ExtDrv_t LPS22HB_P_ExtDrv;
 extern LPS22HB_T_ExtDrv_t LPS22HB_T_ExtDrv;
 
+/**
+ * @}
+ */
+
+/** @addtogroup LPS22HB_Public_Functions Public functions
+ * @{
+ */
+
+/* Size of the buffer of LPS22HB_P_Get_Press_Temp_Async: PRESS_OUT_XL to TEMP_OUT_H */
+#define LPS22HB_PRESS_TEMP_ASYNC_SIZE  5
+
+DrvStatusTypeDef LPS22HB_P_Get_Press_Temp_Async( DrvContextTypeDef *handle, SensorBusTransfer_t *transfer, uint8_t *pBuffer );
+void LPS22HB_P_Decode_Press_Temp( uint8_t *pBuffer, float *pressure, float *temperature );
+
 /**
  * @}
  */
@@ -89,6 +89,7 @@ static DrvStatusTypeDef LSM303AGR_X_Get_DRDY_Status( DrvContextTypeDef *handle,
  */
 
 static DrvStatusTypeDef LSM303AGR_X_Get_Axes_Raw( DrvContextTypeDef *handle, int16_t *pData );
+static DrvStatusTypeDef LSM303AGR_X_Get_Data_Shift( DrvContextTypeDef *handle, uint8_t *shift );
 static DrvStatusTypeDef LSM303AGR_X_Set_ODR_When_Enabled( DrvContextTypeDef *handle, SensorOdr_t odr );
 static DrvStatusTypeDef LSM303AGR_X_Set_ODR_When_Disabled( DrvContextTypeDef *handle, SensorOdr_t odr );
 static DrvStatusTypeDef LSM303AGR_X_Set_ODR_Value_When_Enabled( DrvContextTypeDef *handle, float odr );
@@ -801,6 +802,179 @@ static DrvStatusTypeDef LSM303AGR_X_Get_DRDY_Status( DrvContextTypeDef *handle,
   return COMPONENT_OK;
 }
 
+/**
+ * @}
+ */
+
+/** @addtogroup LSM303AGR_ACC_Public_Functions Public functions
+ * @{
+ */
+
+/**
+ * @brief Stream the samples into the FIFO and raise INT1 once watermark samples are stored.
+ *        The FIFO is emptied first
+ * @param handle the device handle
+ * @param watermark number of samples raising INT1, from 1 to LSM303AGR_X_FIFO_MAX_SAMPLES - 1
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM303AGR_X_FIFO_Stream_Start( DrvContextTypeDef *handle, uint16_t watermark )
+{
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM303AGR_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* FTH is 5 bits wide */
+  if ( watermark == 0 || watermark >= LSM303AGR_X_FIFO_MAX_SAMPLES )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* The bypass mode empties the FIFO */
+  if ( LSM303AGR_ACC_W_FifoMode( (void *)handle, LSM303AGR_ACC_FM_BYPASS ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FIFO_EN( (void *)handle, LSM303AGR_ACC_FIFO_EN_ENABLED ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FifoThreshold( (void *)handle, ( u8_t )watermark ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FIFO_Watermark_on_INT1( (void *)handle, LSM303AGR_ACC_I1_WTM_ENABLED ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FifoMode( (void *)handle, LSM303AGR_ACC_FM_STREAM ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Stop the FIFO streaming started by LSM303AGR_X_FIFO_Stream_Start
+ * @param handle the device handle
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM303AGR_X_FIFO_Stream_Stop( DrvContextTypeDef *handle )
+{
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM303AGR_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FIFO_Watermark_on_INT1( (void *)handle, LSM303AGR_ACC_I1_WTM_DISABLED ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FifoMode( (void *)handle, LSM303AGR_ACC_FM_BYPASS ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_W_FIFO_EN( (void *)handle, LSM303AGR_ACC_FIFO_EN_DISABLED ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Get the number of samples stored in the FIFO
+ * @param handle the device handle
+ * @param nSamples pointer where the number of samples is written
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM303AGR_X_FIFO_Get_Num_Of_Axes( DrvContextTypeDef *handle, uint16_t *nSamples )
+{
+
+  u8_t fss = 0;
+  LSM303AGR_ACC_OVRN_FIFO_t ovrn;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM303AGR_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_R_FifoSamplesAvail( (void *)handle, &fss ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_ACC_R_FifoOverrun( (void *)handle, &ovrn ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* FSS counts up to 31, the overrun flag tells the FIFO is full */
+  *nSamples = ( ovrn == LSM303AGR_ACC_OVRN_FIFO_OVERRUN ) ? LSM303AGR_X_FIFO_MAX_SAMPLES : fss;
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Read samples from the FIFO in one burst
+ * @param handle the device handle
+ * @param pData the samples read, oldest first
+ * @param nSamples number of samples to read, at most the number given by LSM303AGR_X_FIFO_Get_Num_Of_Axes
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM303AGR_X_FIFO_Get_Axes_Raw( DrvContextTypeDef *handle, SensorAxesRaw_t *pData, uint16_t nSamples )
+{
+
+  uint8_t *regValue = ( uint8_t * )pData;
+  uint8_t shift = 0;
+  uint16_t i;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM303AGR_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( nSamples == 0 || nSamples > LSM303AGR_X_FIFO_MAX_SAMPLES )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM303AGR_X_Get_Data_Shift( handle, &shift ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* With the FIFO enabled, the register address rolls back from OUT_Z_H to
+     OUT_X_L, so the whole batch is read in a single transaction */
+  if ( LSM303AGR_ACC_ReadReg( (void *)handle, LSM303AGR_ACC_OUT_X_L, regValue, nSamples * LSM303AGR_X_FIFO_SAMPLE_SIZE ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* Format the data in place, each sample taking the room of its registers */
+  for ( i = 0; i < nSamples; i++, regValue += LSM303AGR_X_FIFO_SAMPLE_SIZE )
+  {
+    pData[i].AXIS_X = ( int16_t )( ( ( uint16_t )regValue[1] << 8 ) | regValue[0] ) >> shift;
+    pData[i].AXIS_Y = ( int16_t )( ( ( uint16_t )regValue[3] << 8 ) | regValue[2] ) >> shift;
+    pData[i].AXIS_Z = ( int16_t )( ( ( uint16_t )regValue[5] << 8 ) | regValue[4] ) >> shift;
+  }
+
+  return COMPONENT_OK;
+}
+
 /**
  * @}
  */
@@ -822,6 +996,36 @@ static DrvStatusTypeDef LSM303AGR_X_Get_Axes_Raw(DrvContextTypeDef *handle, int1
 
   Type3Axis16bit_U raw_data_tmp;
   u8_t shift = 0;
+
+  if ( LSM303AGR_X_Get_Data_Shift( handle, &shift ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* Read output registers from LSM303AGR_ACC_GYRO_OUTX_L_XL to LSM303AGR_ACC_GYRO_OUTZ_H_XL. */
+  if (!LSM303AGR_ACC_Get_Raw_Acceleration( (void *)handle, raw_data_tmp.u8bit ))
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* Format the data. */
+  pData[0] = ( raw_data_tmp.i16bit[0] >> shift );
+  pData[1] = ( raw_data_tmp.i16bit[1] >> shift );
+  pData[2] = ( raw_data_tmp.i16bit[2] >> shift );
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Get the shift of the left-justified outputs in the current operating mode
+ * @param handle the device handle
+ * @param shift pointer where the shift is written: 8 in low power, 6 in normal and 4 in high resolution mode
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+static DrvStatusTypeDef LSM303AGR_X_Get_Data_Shift( DrvContextTypeDef *handle, uint8_t *shift )
+{
+
   LSM303AGR_ACC_LPEN_t lp;
   LSM303AGR_ACC_HR_t hr;
 
@@ -839,34 +1043,23 @@ static DrvStatusTypeDef LSM303AGR_X_Get_Axes_Raw(DrvContextTypeDef *handle, int1
   if (lp == LSM303AGR_ACC_LPEN_ENABLED && hr == LSM303AGR_ACC_HR_DISABLED)
   {
     /* op mode is LP 8-bit */
-    shift = 8;
+    *shift = 8;
   }
   else if (lp == LSM303AGR_ACC_LPEN_DISABLED && hr == LSM303AGR_ACC_HR_DISABLED)
   {
     /* op mode is Normal 10-bit */
-    shift = 6;
+    *shift = 6;
   }
   else if (lp == LSM303AGR_ACC_LPEN_DISABLED && hr == LSM303AGR_ACC_HR_ENABLED)
   {
     /* op mode is HR 12-bit */
-    shift = 4;
+    *shift = 4;
   }
   else
   {
     return COMPONENT_ERROR;
   }
 
-  /* Read output registers from LSM303AGR_ACC_GYRO_OUTX_L_XL to LSM303AGR_ACC_GYRO_OUTZ_H_XL. */
-  if (!LSM303AGR_ACC_Get_Raw_Acceleration( (void *)handle, raw_data_tmp.u8bit ))
-  {
-    return COMPONENT_ERROR;
-  }
-
-  /* Format the data. */
-  pData[0] = ( raw_data_tmp.i16bit[0] >> shift );
-  pData[1] = ( raw_data_tmp.i16bit[1] >> shift );
-  pData[2] = ( raw_data_tmp.i16bit[2] >> shift );
-
   return COMPONENT_OK;
 }
 
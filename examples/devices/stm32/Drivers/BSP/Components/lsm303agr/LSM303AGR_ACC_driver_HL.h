@@ -118,6 +118,25 @@ typedef struct
 
 extern ACCELERO_Drv_t LSM303AGR_X_Drv;
 
+/**
+ * @}
+ */
+
+/** @addtogroup LSM303AGR_ACC_Public_Functions Public functions
+ * @{
+ */
+
+/* Bytes of one sample in the FIFO: X, Y and Z, 16 bits each */
+#define LSM303AGR_X_FIFO_SAMPLE_SIZE  6
+
+/* Samples held by the FIFO */
+#define LSM303AGR_X_FIFO_MAX_SAMPLES  32
+
+DrvStatusTypeDef LSM303AGR_X_FIFO_Stream_Start( DrvContextTypeDef *handle, uint16_t watermark );
+DrvStatusTypeDef LSM303AGR_X_FIFO_Stream_Stop( DrvContextTypeDef *handle );
+DrvStatusTypeDef LSM303AGR_X_FIFO_Get_Num_Of_Axes( DrvContextTypeDef *handle, uint16_t *nSamples );
+DrvStatusTypeDef LSM303AGR_X_FIFO_Get_Axes_Raw( DrvContextTypeDef *handle, SensorAxesRaw_t *pData, uint16_t nSamples );
+
 /**
  * @}
  */
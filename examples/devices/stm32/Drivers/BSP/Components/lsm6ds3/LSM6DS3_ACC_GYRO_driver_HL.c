@@ -1761,6 +1761,189 @@ static DrvStatusTypeDef LSM6DS3_G_Get_DRDY_Status( DrvContextTypeDef *handle, ui
   return COMPONENT_OK;
 }
 
+/**
+ * @}
+ */
+
+/** @addtogroup LSM6DS3_Public_Functions Public functions
+ * @{
+ */
+
+/**
+ * @brief Stream the accelerometer samples into the FIFO, at the accelerometer output data rate,
+ *        and raise INT1 once watermark samples are stored. The FIFO is emptied first.
+ *        The accelerometer must be enabled, from 12.5 Hz
+ * @param handle the accelerometer device handle
+ * @param watermark number of samples raising INT1, from 1 to LSM6DS3_X_FIFO_MAX_SAMPLES
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ * @note The gyroscope samples are kept out of the FIFO
+ */
+DrvStatusTypeDef LSM6DS3_X_FIFO_Stream_Start( DrvContextTypeDef *handle, uint16_t watermark )
+{
+
+  LSM6DS3_ACC_GYRO_ODR_XL_t odr_xl;
+  LSM6DS3_ACC_GYRO_ODR_FIFO_t odr_fifo;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM6DS3_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( watermark == 0 || watermark > LSM6DS3_X_FIFO_MAX_SAMPLES )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* The bypass mode empties the FIFO */
+  if ( LSM6DS3_FIFO_Set_Mode( handle, LSM6DS3_ACC_GYRO_FIFO_MODE_BYPASS ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_FIFO_X_Set_Decimation( handle, LSM6DS3_ACC_GYRO_DEC_FIFO_XL_NO_DECIMATION ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_FIFO_G_Set_Decimation( handle, LSM6DS3_ACC_GYRO_DEC_FIFO_G_DATA_NOT_IN_FIFO ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_ACC_GYRO_R_ODR_XL( (void *)handle, &odr_xl ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* The FIFO ODR codes are the accelerometer ones shifted by one bit, from
+     12.5 Hz to 6.66 kHz. The FIFO must not run faster than the accelerometer */
+  odr_fifo = ( LSM6DS3_ACC_GYRO_ODR_FIFO_t )( odr_xl >> 1 );
+  if ( odr_fifo < LSM6DS3_ACC_GYRO_ODR_FIFO_10Hz || odr_fifo > LSM6DS3_ACC_GYRO_ODR_FIFO_6600Hz )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_ACC_GYRO_W_ODR_FIFO( (void *)handle, odr_fifo ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* The watermark counts 16-bit words, three per sample */
+  if ( LSM6DS3_FIFO_Set_Watermark_Level( handle, watermark * 3 ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_ACC_GYRO_W_FIFO_TSHLD_on_INT1( handle, LSM6DS3_ACC_GYRO_INT1_FTH_ENABLED ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_FIFO_Set_Mode( handle, LSM6DS3_ACC_GYRO_FIFO_MODE_DYN_STREAM_2 ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Stop the FIFO streaming started by LSM6DS3_X_FIFO_Stream_Start
+ * @param handle the accelerometer device handle
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM6DS3_X_FIFO_Stream_Stop( DrvContextTypeDef *handle )
+{
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM6DS3_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_ACC_GYRO_W_FIFO_TSHLD_on_INT1( handle, LSM6DS3_ACC_GYRO_INT1_FTH_DISABLED ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_FIFO_Set_Mode( handle, LSM6DS3_ACC_GYRO_FIFO_MODE_BYPASS ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Get the number of accelerometer samples stored in the FIFO
+ * @param handle the accelerometer device handle
+ * @param nSamples pointer where the number of samples is written
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM6DS3_X_FIFO_Get_Num_Of_Axes( DrvContextTypeDef *handle, uint16_t *nSamples )
+{
+
+  uint16_t nWords = 0;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM6DS3_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( LSM6DS3_FIFO_Get_Num_Of_Samples( handle, &nWords ) == COMPONENT_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  *nSamples = nWords / 3;
+
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief Read accelerometer samples from the FIFO in one burst
+ * @param handle the accelerometer device handle
+ * @param pData the samples read, oldest first
+ * @param nSamples number of samples to read, at most the number given by LSM6DS3_X_FIFO_Get_Num_Of_Axes
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef LSM6DS3_X_FIFO_Get_Axes_Raw( DrvContextTypeDef *handle, SensorAxesRaw_t *pData, uint16_t nSamples )
+{
+
+  uint8_t *regValue = ( uint8_t * )pData;
+  uint16_t i;
+
+  if ( handle == NULL || handle->pVTable != ( void * )&LSM6DS3_X_Drv )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  if ( nSamples == 0 || nSamples > LSM6DS3_X_FIFO_MAX_SAMPLES )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* The register address rolls back from FIFO_DATA_OUT_H to FIFO_DATA_OUT_L,
+     so the whole batch is read in a single transaction */
+  if ( LSM6DS3_ACC_GYRO_ReadReg( (void *)handle, LSM6DS3_ACC_GYRO_FIFO_DATA_OUT_L, regValue, nSamples * LSM6DS3_X_FIFO_SAMPLE_SIZE ) == MEMS_ERROR )
+  {
+    return COMPONENT_ERROR;
+  }
+
+  /* Format the data in place, each sample taking the room of its registers */
+  for ( i = 0; i < nSamples; i++, regValue += LSM6DS3_X_FIFO_SAMPLE_SIZE )
+  {
+    pData[i].AXIS_X = ( ( ( ( int16_t )regValue[1] ) << 8 ) + ( int16_t )regValue[0] );
+    pData[i].AXIS_Y = ( ( ( ( int16_t )regValue[3] ) << 8 ) + ( int16_t )regValue[2] );
+    pData[i].AXIS_Z = ( ( ( ( int16_t )regValue[5] ) << 8 ) + ( int16_t )regValue[4] );
+  }
+
+  return COMPONENT_OK;
+}
+
 /**
  * @}
  */
@@ -298,6 +298,25 @@ extern GYRO_Drv_t LSM6DS3_G_Drv;
 extern LSM6DS3_X_ExtDrv_t LSM6DS3_X_ExtDrv;
 extern LSM6DS3_G_ExtDrv_t LSM6DS3_G_ExtDrv;
 
+/**
+ * @}
+ */
+
+/** @addtogroup LSM6DS3_Public_Functions Public functions
+ * @{
+ */
+
+/* Bytes of one accelerometer sample in the FIFO: X, Y and Z, 16 bits each */
+#define LSM6DS3_X_FIFO_SAMPLE_SIZE  6
+
+/* Accelerometer samples held by the FIFO when the gyroscope is kept out of it */
+#define LSM6DS3_X_FIFO_MAX_SAMPLES  1365
+
+DrvStatusTypeDef LSM6DS3_X_FIFO_Stream_Start( DrvContextTypeDef *handle, uint16_t watermark );
+DrvStatusTypeDef LSM6DS3_X_FIFO_Stream_Stop( DrvContextTypeDef *handle );
+DrvStatusTypeDef LSM6DS3_X_FIFO_Get_Num_Of_Axes( DrvContextTypeDef *handle, uint16_t *nSamples );
+DrvStatusTypeDef LSM6DS3_X_FIFO_Get_Axes_Raw( DrvContextTypeDef *handle, SensorAxesRaw_t *pData, uint16_t nSamples );
+
 /**
  * @}
  */
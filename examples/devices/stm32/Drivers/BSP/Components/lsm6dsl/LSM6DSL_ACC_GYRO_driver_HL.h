@@ -49,6 +49,7 @@ extern "C" {
 
 #include "accelerometer.h"
 #include "gyroscope.h"
+#include "sensor_bus.h"
 
 /* Include accelero sensor component drivers. */
 #include "LSM6DSL_ACC_GYRO_driver.h"
@@ -314,6 +315,31 @@ extern LSM6DSL_X_ExtDrv_t LSM6DSL_X_ExtDrv;
 extern LSM6DSL_G_ExtDrv_t LSM6DSL_G_ExtDrv;
 extern LSM6DSL_Combo_Data_t LSM6DSL_Combo_Data[LSM6DSL_SENSORS_MAX_NUM];
 
+/**
+ * @}
+ */
+
+/** @addtogroup LSM6DSL_Public_Functions Public functions
+ * @{
+ */
+
+/* Size of the buffer of LSM6DSL_X_Get_Axes_Raw_Async: OUTX_L_XL to OUTZ_H_XL */
+#define LSM6DSL_X_AXES_ASYNC_SIZE  6
+
+DrvStatusTypeDef LSM6DSL_X_Get_Axes_Raw_Async( DrvContextTypeDef *handle, SensorBusTransfer_t *transfer, uint8_t *pBuffer );
+void LSM6DSL_X_Decode_Axes_Raw( uint8_t *pBuffer, SensorAxesRaw_t *value );
+
+/* Bytes of one accelerometer sample in the FIFO: X, Y and Z, 16 bits each */
+#define LSM6DSL_X_FIFO_SAMPLE_SIZE  6
+
+/* Accelerometer samples held by the FIFO when the gyroscope is kept out of it */
+#define LSM6DSL_X_FIFO_MAX_SAMPLES  682
+
+DrvStatusTypeDef LSM6DSL_X_FIFO_Stream_Start( DrvContextTypeDef *handle, uint16_t watermark );
+DrvStatusTypeDef LSM6DSL_X_FIFO_Stream_Stop( DrvContextTypeDef *handle );
+DrvStatusTypeDef LSM6DSL_X_FIFO_Get_Num_Of_Axes( DrvContextTypeDef *handle, uint16_t *nSamples );
+DrvStatusTypeDef LSM6DSL_X_FIFO_Get_Axes_Raw( DrvContextTypeDef *handle, SensorAxesRaw_t *pData, uint16_t nSamples );
+
 /**
  * @}
  */
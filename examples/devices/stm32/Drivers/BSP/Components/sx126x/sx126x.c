@@ -44,6 +44,7 @@
 #include "radio.h"
 #include "sx126x.h"
 #include "sx126x_board.h"
+#include "energy_meter.h"
 
 /*
  * Local types definition
@@ -124,6 +125,25 @@ RadioOperatingModes_t SX126xGetOperatingMode( void )
 void SX126xSetOperatingMode( RadioOperatingModes_t mode )
 {
     OperatingMode = mode;
+
+    switch( mode )
+    {
+    case MODE_SLEEP:
+        EnergySetRadioState( ENERGY_RADIO_SLEEP );
+        break;
+    case MODE_STDBY_RC:
+    case MODE_STDBY_XOSC:
+    case MODE_FS:
+        EnergySetRadioState( ENERGY_RADIO_STANDBY );
+        break;
+    case MODE_TX:
+        EnergySetRadioState( ENERGY_RADIO_TX );
+        break;
+    default:
+        // Rx, Rx duty cycle and CAD
+        EnergySetRadioState( ENERGY_RADIO_RX );
+        break;
+    }
 }
 
 void SX126xCheckDeviceReady( void )
@@ -43,6 +43,8 @@
 #include "radio.h"
 #include "sx1272.h"
 #include "timeServer.h"
+#include "latency_stats.h"
+#include "energy_meter.h"
 
 /*
  * Local types definition
@@ -216,12 +218,38 @@ static LoRaBoardCallback_t *LoRaBoardCallbacks;
  */
 SX1272_t SX1272;
 
+#if ( LATENCY_STATS == 1 )
+/*!
+ * DIO IRQ callbacks wrapped with an execution time measurement
+ */
+#define SX1272_DIO_IRQ_TIMED( n )                           \
+static void SX1272OnDio##n##IrqTimed( void* context )       \
+{                                                           \
+    LATENCY_START( );                                       \
+    SX1272OnDio##n##Irq( context );                         \
+    LATENCY_STOP( LATENCY_RADIO_DIO##n );                   \
+}
+
+SX1272_DIO_IRQ_TIMED( 0 )
+SX1272_DIO_IRQ_TIMED( 1 )
+SX1272_DIO_IRQ_TIMED( 2 )
+SX1272_DIO_IRQ_TIMED( 3 )
+SX1272_DIO_IRQ_TIMED( 4 )
+
+/*!
+ * Hardware DIO IRQ callback initialization
+ */
+DioIrqHandler *DioIrq[] = { SX1272OnDio0IrqTimed, SX1272OnDio1IrqTimed,
+                            SX1272OnDio2IrqTimed, SX1272OnDio3IrqTimed,
+                            SX1272OnDio4IrqTimed, NULL };
+#else
 /*!
  * Hardware DIO IRQ callback initialization
  */
 DioIrqHandler *DioIrq[] = { SX1272OnDio0Irq, SX1272OnDio1Irq,
                             SX1272OnDio2Irq, SX1272OnDio3Irq,
                             SX1272OnDio4Irq, NULL };
+#endif
 
 /*!
  * Tx and Rx timers
@@ -1082,6 +1110,25 @@ void SX1272SetOpMode( uint8_t opMode )
         LoRaBoardCallbacks->SX1272BoardSetAntSw( opMode );
     }
     SX1272Write( REG_OPMODE, ( SX1272Read( REG_OPMODE ) & RF_OPMODE_MASK ) | opMode );
+
+    switch( opMode )
+    {
+    case RF_OPMODE_SLEEP:
+        EnergySetRadioState( ENERGY_RADIO_SLEEP );
+        break;
+    case RF_OPMODE_STANDBY:
+    case RF_OPMODE_SYNTHESIZER_TX:
+    case RF_OPMODE_SYNTHESIZER_RX:
+        EnergySetRadioState( ENERGY_RADIO_STANDBY );
+        break;
+    case RF_OPMODE_TRANSMITTER:
+        EnergySetRadioState( ENERGY_RADIO_TX );
+        break;
+    default:
+        // Receiver, receiver single and CAD
+        EnergySetRadioState( ENERGY_RADIO_RX );
+        break;
+    }
 }
 
 void SX1272SetModem( RadioModems_t modem )
@@ -46,6 +46,8 @@
 #include "radio.h"
 #include "sx1276.h"
 #include "timeServer.h"
+#include "latency_stats.h"
+#include "energy_meter.h"
 
 /*
  * Local types definition
@@ -215,12 +217,38 @@ static LoRaBoardCallback_t *LoRaBoardCallbacks;
  */
 SX1276_t SX1276;
 
+#if ( LATENCY_STATS == 1 )
+/*!
+ * DIO IRQ callbacks wrapped with an execution time measurement
+ */
+#define SX1276_DIO_IRQ_TIMED( n )                           \
+static void SX1276OnDio##n##IrqTimed( void* context )       \
+{                                                           \
+    LATENCY_START( );                                       \
+    SX1276OnDio##n##Irq( context );                         \
+    LATENCY_STOP( LATENCY_RADIO_DIO##n );                   \
+}
+
+SX1276_DIO_IRQ_TIMED( 0 )
+SX1276_DIO_IRQ_TIMED( 1 )
+SX1276_DIO_IRQ_TIMED( 2 )
+SX1276_DIO_IRQ_TIMED( 3 )
+SX1276_DIO_IRQ_TIMED( 4 )
+
+/*!
+ * Hardware DIO IRQ callback initialization
+ */
+DioIrqHandler *DioIrq[] = { SX1276OnDio0IrqTimed, SX1276OnDio1IrqTimed,
+                            SX1276OnDio2IrqTimed, SX1276OnDio3IrqTimed,
+                            SX1276OnDio4IrqTimed, NULL };
+#else
 /*!
  * Hardware DIO IRQ callback initialization
  */
 DioIrqHandler *DioIrq[] = { SX1276OnDio0Irq, SX1276OnDio1Irq,
                             SX1276OnDio2Irq, SX1276OnDio3Irq,
                             SX1276OnDio4Irq, NULL };
+#endif
 
 /*!
  * Tx and Rx timers
@@ -1245,6 +1273,25 @@ void SX1276SetOpMode( uint8_t opMode )
       
       SX1276Write( REG_OPMODE, ( SX1276Read( REG_OPMODE ) & RF_OPMODE_MASK ) | opMode );
     }
+
+    switch( opMode )
+    {
+    case RF_OPMODE_SLEEP:
+        EnergySetRadioState( ENERGY_RADIO_SLEEP );
+        break;
+    case RF_OPMODE_STANDBY:
+    case RF_OPMODE_SYNTHESIZER_TX:
+    case RF_OPMODE_SYNTHESIZER_RX:
+        EnergySetRadioState( ENERGY_RADIO_STANDBY );
+        break;
+    case RF_OPMODE_TRANSMITTER:
+        EnergySetRadioState( ENERGY_RADIO_TX );
+        break;
+    default:
+        // Receiver, receiver single and CAD
+        EnergySetRadioState( ENERGY_RADIO_RX );
+        break;
+    }
 }
 
 void SX1276SetModem( RadioModems_t modem )
@@ -252,6 +252,7 @@ typedef enum eATEerror
   AT_UART_LINK_ERROR,    /*additional return code to notify error on UART link*/
   AT_TEST_PARAM_OVERFLOW, /* additonal return code to be compatible whatevery the device modem*/
   AT_JOIN_SLEEP_TRANSITION, /*additional return code to manage the Join request transaction*/
+  AT_BUSY_ERROR,            /*additional return code: the cmd queue of the AT engine is full*/
 } ATEerror_t;
 
 #endif
@@ -26,6 +26,7 @@
 #include "hw_conf.h"
 #include "hw_usart.h"
 #include "i_nucleo_lrwan1_wm_sg_sm_xx.h"
+#include "at_engine.h"
 #include "tiny_sscanf.h"
 
 #include <stdarg.h>
@@ -75,7 +76,38 @@ const struct Modem_s Modem =
 extern ATCmd_t gFlagException;  /*defined in lora_driver.c*/
 
 /* Private typedef -----------------------------------------------------------*/
+/*command in the pipeline of the AT engine*/
+typedef struct
+{
+  void *pdata;                /*receives the value returned by a GET cmd*/
+  bool PlainValue;            /*the whole line is the value, see gFlagException*/
+  bool AnyRetCode;            /*the return code of a CTRL cmd is not checked*/
+  bool ValueReceived;
+  bool InUse;
+  Modem_AT_Done_t *Done;
+  void *Context;
+} ModemCmd_t;
+
+/*wait for asynchronous events of the modem, see AT_ASYNC_EVENT*/
+typedef struct
+{
+  ATCmd_t Cmd;                /*AT_JOIN for the join accept, else downlink data*/
+  char *pdata;                /*receives port, size and data of the downlink*/
+  int8_t DlinkData_Complete;
+  bool InUse;
+  Modem_AT_Done_t *Done;
+  void *Context;
+} ModemEventWait_t;
+
+/*completion of the blocking Modem_AT_Cmd*/
+typedef struct
+{
+  volatile bool Complete;
+  ATEerror_t Status;
+} ModemSync_t;
+
 /* Private define ------------------------------------------------------------*/
+#define AT_EXCEPT_GUARD_TIME     1000     /*quiet line around an AT_EXCEPT cmd, in ms*/
 
 
 /* Private macro -------------------------------------------------------------*/
@@ -87,11 +119,22 @@ char LoRa_AT_Cmd_Buff[DATA_TX_MAX_BUFF_SIZE];    /* Buffer used for AT cmd trans
 
 static uint16_t Offset = 0;   /*write position needed for send command*/
 
-static uint8_t aRxBuffer[5];  /* Buffer used for Rx input character */   
+static ModemCmd_t ModemCmd[AT_ENGINE_QUEUE_SIZE];  /*one per command of the engine queue*/
 
-static char response[DATA_RX_MAX_BUFF_SIZE];  /*has to be the largest of the response*/
-                                              /*not only for return code but also for*/
-                                              /*return value: exemple KEY*/
+static ModemEventWait_t ModemEventWait;
+
+static volatile uint32_t ModemRxLaps = 0;   /*turns of the reception DMA around the ring*/
+
+static void (*ModemNotify)(void) = NULL;
+static void (*ModemEvent)(const char *line) = NULL;
+
+/*prefixes of the lines the modem sends on its own*/
+static const char * const AsyncEventTab[] = {
+  "+JoinAccepted",
+  "+RXPORT",
+  "+PAYLOADSIZE",
+  "+RCV"
+};
 
 /****************************************************************************/
 /*here we have to include a list of AT cmd by the way of #include<file>     */
@@ -112,40 +155,81 @@ static char response[DATA_RX_MAX_BUFF_SIZE];  /*has to be the largest of the res
 
 static uint8_t at_cmd_format(ATCmd_t Cmd, void *ptr, Marker_t Marker);
 
-static HAL_StatusTypeDef at_cmd_send(uint16_t len);
+static ATEerror_t at_cmd_submit(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context);
 
-static ATEerror_t at_cmd_receive(void *pdata);
+static bool at_io_transmit(const uint8_t *buff, uint16_t size);
 
-static ATEerror_t at_cmd_responseAnalysing(const char *ReturnResp);
+static bool at_io_is_tx_busy(void);
+
+static uint32_t at_io_get_rx_count(void);
+
+static uint32_t at_io_get_time(void);
+
+static void at_io_notify(void);
 
-static ATEerror_t at_cmd_receive_async_event(void);
+static int16_t at_cmd_classify(const char *line);
+
+static ATEerror_t at_cmd_responseAnalysing(const char *ReturnResp);
 
 static ATEerror_t at_cmd_AsyncEventAnalysing(const char *ReturnResp,int8_t *Flag);
 
-static ATEerror_t at_cmd_receive_async_event_downlink_data(void *ptr);
+static void at_cmd_line(void *context, const char *line);
+
+static void at_cmd_done(void *context, int16_t result);
+
+static void at_cmd_event(const char *line);
+
+static void at_cmd_event_done(ATEerror_t status);
+
+static void at_cmd_sync_done(void *context, ATEerror_t status);
+
+static ATEerror_t at_cmd_sync_wait(ModemSync_t *Sync);
 
 
 //static void at_cmd_send_noresp(uint16_t len); 
 
+/*serial link of the AT engine: DMA on huart2*/
+static const AtEngineIo_t ModemIo =
+{
+  at_io_transmit,
+  at_io_is_tx_busy,
+  at_io_get_rx_count,
+  at_io_get_time,
+  at_cmd_classify,
+  at_io_notify
+};
+
 /* Exported functions ------------------------------------------------------- */
 
 
 /******************************************************************************
- * @brief  Configures modem UART interface.
+ * @brief  Configures modem UART interface: DMA transmission and circular DMA
+ *         reception, with the idle line interrupt
  * @param  None
  * @retval AT_OK in case of success
  * @retval AT_UART_LINK_ERROR in case of failure
 *****************************************************************************/
 ATEerror_t Modem_IO_Init( void )
 {
-  if ( HW_UART_Modem_Init(BAUD_RATE)== HAL_OK )
+  if ( HW_UART_Modem_Init(BAUD_RATE)!= HAL_OK )
   {
-    return AT_OK;
+    return AT_UART_LINK_ERROR;
   }
-  else
+
+  memset(ModemCmd, 0x00, sizeof ModemCmd);
+  memset(&ModemEventWait, 0x00, sizeof ModemEventWait);
+  ModemRxLaps = 0;
+  AtEngineInit(&ModemIo, at_cmd_event);
+
+  /*huart2.hdmarx must be linked to a channel in circular mode*/
+  if ( HAL_UART_Receive_DMA(&huart2, AtEngineGetRxBuffer(), AT_ENGINE_RX_SIZE) != HAL_OK )
   {
     return AT_UART_LINK_ERROR;
   }
+  __HAL_UART_CLEAR_IDLEFLAG(&huart2);
+  __HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
+
+  return AT_OK;
 }
 
 
@@ -156,26 +240,92 @@ ATEerror_t Modem_IO_Init( void )
 *****************************************************************************/
 void Modem_IO_DeInit( void )
 {
+  __HAL_UART_DISABLE_IT(&huart2, UART_IT_IDLE);
+  HAL_UART_DMAStop(&huart2);
   HAL_UART_MspDeInit(&huart2);
 }
 
 
 /******************************************************************************
- * @brief  Receive data in interrupt mode from modem UART interface.
+ * @brief  Restarts the reception from the modem UART interface when it has
+ *         stopped, e.g. on a UART error. The reception runs on its own from
+ *         Modem_IO_Init on
  * @param  UART handle
  * @retval None
 *****************************************************************************/
 void Modem_UART_Receive_IT(UART_HandleTypeDef *huart)
 {
-  /*UART peripheral in reception process for response returned by slave*/  
-  if(HAL_UART_Receive_IT(huart, (uint8_t *)aRxBuffer,1) != HAL_OK)
+  if (huart->RxState == HAL_UART_STATE_READY)
+  {
+    /*the DMA starts again at the beginning of the ring: two laps ahead, the
+      AT engine sees the bytes lost as an overrun and resynchronizes*/
+    ModemRxLaps += 2;
+    if(HAL_UART_Receive_DMA(huart, AtEngineGetRxBuffer(), AT_ENGINE_RX_SIZE) != HAL_OK)
+    {
+     while (1);
+    }
+  }
+}
+
+
+/******************************************************************************
+ * @brief  Modem UART interrupt, to be called from USART2_IRQHandler
+ * @param  None
+ * @retval None
+*****************************************************************************/
+void Modem_IO_IRQHandler( void )
+{
+  if ( __HAL_UART_GET_FLAG(&huart2, UART_FLAG_IDLE) != RESET )
   {
-   while (1);
-  } 
+    /*end of a burst of the modem*/
+    __HAL_UART_CLEAR_IDLEFLAG(&huart2);
+    AtEngineRxIdle();
+  }
+  HAL_UART_IRQHandler(&huart2);
+}
+
+
+/******************************************************************************
+ * @brief  Modem UART DMA interrupt, to be called from the handlers of the
+ *         DMA channels of huart2. It counts the laps of the reception
+ * @param  None
+ * @retval None
+*****************************************************************************/
+void Modem_IO_DMA_IRQHandler( void )
+{
+  if (huart2.hdmatx != NULL)
+  {
+    HAL_DMA_IRQHandler(huart2.hdmatx);
+  }
+  if (huart2.hdmarx != NULL)
+  {
+    if (__HAL_DMA_GET_FLAG(huart2.hdmarx, __HAL_DMA_GET_TC_FLAG_INDEX(huart2.hdmarx)) != RESET)
+    {
+      ModemRxLaps++;   /*the circular reception wrapped around the ring*/
+    }
+    HAL_DMA_IRQHandler(huart2.hdmarx);
+  }
+}
+
+
+/******************************************************************************
+ * @brief  Registers the callbacks of the AT engine
+ * @param  notify called from the UART interrupt when bytes have been received,
+ *         Modem_AT_Process is then to be called from the main loop
+ *         event called with the lines the modem sends on its own, when no
+ *         AT_ASYNC_EVENT wait takes them
+ * @retval None
+*****************************************************************************/
+void Modem_AT_SetCallbacks( void (*notify)(void), void (*event)(const char *line) )
+{
+  ModemNotify = notify;
+  ModemEvent = event;
 }
 
+
 /******************************************************************************
- * @brief  Handle the AT cmd following their Groupp type
+ * @brief  Handle the AT cmd following their Groupp type, waits for the
+ *         response of the modem. The commands queued before are sent first
  * @param  at_group AT group [control, set , get)
  *         Cmd AT command
  *         pdata pointer to the IN/OUT buffer
@@ -184,88 +334,174 @@ void Modem_UART_Receive_IT(UART_HandleTypeDef *huart)
 ATEerror_t  Modem_AT_Cmd(ATGroup_t at_group, ATCmd_t Cmd, void *pdata )
 
 {
-ATEerror_t Status = AT_END_ERROR;
-HAL_StatusTypeDef HAL_Status;
+ModemSync_t Sync;
+ATEerror_t Status;
+
+  Sync.Complete = false;
+  Sync.Status = AT_END_ERROR;
+
+  if (at_group != AT_EXCEPT)
+  {
+    Status = Modem_AT_Cmd_Async(at_group, Cmd, pdata, at_cmd_sync_done, &Sync);
+    if(Status != AT_OK)
+      return Status;
+    return at_cmd_sync_wait(&Sync);
+  }
+
+  /*the modem wants the line quiet around this cmd, it does not answer*/
+  while (!AtEngineIsIdle())
+  {
+    AtEngineProcess();
+  }
+  HAL_Delay(AT_EXCEPT_GUARD_TIME);
+  Status = at_cmd_submit(at_group, Cmd, pdata, at_cmd_sync_done, &Sync);
+  if(Status != AT_OK)
+    return Status;
+  Status = at_cmd_sync_wait(&Sync);
+  if(Status != AT_OK)
+    return Status;
+  HAL_Delay(AT_EXCEPT_GUARD_TIME);
+  return (AT_OK);
+}
+
+
+/******************************************************************************
+ * @brief  Queues an AT cmd, or waits for asynchronous events, returns at once
+ * @param  at_group AT group [control, set , get, async event, except_1)
+ *         Cmd AT command
+ *         pdata pointer to the IN/OUT buffer, valid until done is called
+ *         done called from Modem_AT_Process with the module status, may be NULL
+ *         context passed to done
+ * @retval AT_OK when queued
+ * @retval AT_BUSY_ERROR when AT_ENGINE_QUEUE_SIZE commands are pending, or
+ *         when an async event wait is pending already
+ * @retval AT_END_ERROR for AT_EXCEPT, only sent by Modem_AT_Cmd
+ *****************************************************************************/
+ATEerror_t Modem_AT_Cmd_Async(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context)
+{
+  if (at_group == AT_EXCEPT)
+  {
+    DBG_PRINTF("AT_EXCEPT is sent by Modem_AT_Cmd\n\r");
+    return (AT_END_ERROR);
+  }
+  return at_cmd_submit(at_group, Cmd, pdata, done, context);
+}
+
+
+/******************************************************************************
+ * @brief  Runs the AT engine: parses the responses, calls the done callbacks
+ *         and sends the next command. To be called from the main loop
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_Process( void )
+{
+  AtEngineProcess();
+}
+
+
+/******************************************************************************
+ * @brief  Queues an AT cmd in the engine, or registers the async event wait
+ * @param  at_group AT group
+ *         Cmd AT command
+ *         pdata pointer to the IN/OUT buffer, valid until done is called
+ *         done called with the module status, may be NULL
+ *         context passed to done
+ * @retval AT_OK when queued
+ *****************************************************************************/
+static ATEerror_t at_cmd_submit(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context)
+{
+ModemCmd_t *Request = NULL;
 uint16_t Len;  
+uint32_t Timeout = AT_RESPONSE_TIMEOUT;
+uint8_t i;
+
+  if (at_group == AT_ASYNC_EVENT)
+  {
+    /*no cmd sent, the events come through at_cmd_event*/
+    if (ModemEventWait.InUse)
+      return (AT_BUSY_ERROR);
+    ModemEventWait.Cmd = Cmd;
+    ModemEventWait.pdata = pdata;
+    ModemEventWait.DlinkData_Complete = (0x1U);
+    ModemEventWait.Done = done;
+    ModemEventWait.Context = context;
+    ModemEventWait.InUse = true;
+    return (AT_OK);
+  }
+
+  for (i = 0; i < AT_ENGINE_QUEUE_SIZE; i++)
+  {
+    if (!ModemCmd[i].InUse)
+    {
+      Request = &ModemCmd[i];
+      break;
+    }
+  }
+  if (Request == NULL)
+    return (AT_BUSY_ERROR);
 
   /*reset At_cmd buffer for each transmission*/
   memset(LoRa_AT_Cmd_Buff, 0x00, sizeof LoRa_AT_Cmd_Buff); 
 
+  Request->PlainValue = false;
+  Request->AnyRetCode = false;
+
   switch (at_group)
   {
   case AT_CTRL:
   {
     Len = at_cmd_format( Cmd, NULL, CTRL_MARKER); 
-    HAL_Status = at_cmd_send(Len);
-    if(HAL_Status != HAL_OK)
-    {  
-        return (AT_UART_LINK_ERROR); /*problem on UART transmission*/
-    }    
-    if(Cmd != AT_RESET)
-    {
-        Status = at_cmd_receive(NULL);   
-        Status = AT_OK;
-    }    
+    if(Cmd == AT_RESET)
+      Timeout = 0;   /*the modem does not answer*/
+    Request->AnyRetCode = true;
+    pdata = NULL;
     break;
   }  
   case AT_SET:
   {
-      Len = at_cmd_format(Cmd, pdata, SET_MARKER); 
-      HAL_Status = at_cmd_send(Len);
-      if(HAL_Status != HAL_OK)
-        return (AT_UART_LINK_ERROR); /*problem on UART transmission*/
-      Status = at_cmd_receive(NULL);
+    Len = at_cmd_format(Cmd, pdata, SET_MARKER); 
+    pdata = NULL;
     break;
   }  
   case AT_GET:
   {
-      Len = at_cmd_format(Cmd, pdata, GET_MARKER);       
-      HAL_Status = at_cmd_send(Len);
-      if(HAL_Status != HAL_OK)
-        return (AT_UART_LINK_ERROR); /*problem on UART transmission*/      
-      Status = at_cmd_receive(pdata);
+    Len = at_cmd_format(Cmd, pdata, GET_MARKER);       
+    Request->PlainValue = (gFlagException == AT_FWVERSION);   /*see comment in lora_driver.c*/
     break;
   }  
-  case AT_ASYNC_EVENT:
-  {
-      if ( Cmd == AT_JOIN)
-      Status = at_cmd_receive_async_event(); 
-      else
-      Status = at_cmd_receive_async_event_downlink_data(pdata);  
-    break;    
-  }  
   case AT_EXCEPT: 
   {
-      HAL_Delay(1000); 
-      Len = at_cmd_format(Cmd, pdata, SET_MARKER); 
-      HAL_Status = at_cmd_send(Len);     
-       if(HAL_Status != HAL_OK)
-        return (AT_UART_LINK_ERROR); /*problem on UART transmission*/  
-       else
-        HAL_Delay(1000); 
-      return (AT_OK);
+    Len = at_cmd_format(Cmd, pdata, SET_MARKER); 
+    Timeout = 0;     /*the modem does not answer*/
+    pdata = NULL;
+    break;
   }        
   case AT_EXCEPT_1:
   {
-      Len = at_cmd_format(Cmd, NULL, SET_MARKER); 
-      HAL_Status = at_cmd_send(Len);     
-       if(HAL_Status != HAL_OK)
-          return (AT_UART_LINK_ERROR); /*problem on UART transmission*/  
-       else
-       {
-         /*Status = at_cmd_receive(NULL);*/
-         return (AT_OK);    
-       }   
+    Len = at_cmd_format(Cmd, NULL, SET_MARKER); 
+    Timeout = 0;     /*the modem does not answer*/
+    pdata = NULL;
+    break;
   }    
   default:  
     DBG_PRINTF("unknow group\n\r");
-    break;
+    return (AT_END_ERROR);
     
   } /*end switch(at_group)*/
-  return Status;
+
+  Request->pdata = pdata;
+  Request->ValueReceived = false;
+  Request->Done = done;
+  Request->Context = context;
+  if (!AtEngineSubmit(LoRa_AT_Cmd_Buff, Len, Timeout, at_cmd_line, at_cmd_done, Request))
+    return (AT_BUSY_ERROR);
+  Request->InUse = true;
+  return (AT_OK);
 }
 
 
+
 /******************************************************************************
  * @brief  format the cmd in order to be send
  * @param  Cmd AT command
@@ -470,301 +706,296 @@ uint8_t value_8;   /*for 8_D*/
 
 
 /******************************************************************************
-  * @brief This function sends an AT cmd to the slave device
-  * @param len: length of the AT cmd to be sent
-  * @retval HAL return code
+  * @brief This function starts the DMA transmission of an AT cmd
+  * @param buff: AT cmd
+  * @param size: length of the AT cmd
+  * @retval true when the transmission started
 ******************************************************************************/
-static HAL_StatusTypeDef at_cmd_send(uint16_t len)
+static bool at_io_transmit(const uint8_t *buff, uint16_t size)
 {
-HAL_StatusTypeDef RetCode;
+  return (HAL_UART_Transmit_DMA(&huart2, (uint8_t *)buff, size) == HAL_OK);
+}
+
 
-  /*transmit the command from master to slave*/
-  RetCode = HAL_UART_Transmit(&huart2, (uint8_t*)LoRa_AT_Cmd_Buff, len, 5000);
-  return ( RetCode);  
+/******************************************************************************
+  * @brief This function tells whether a transmission is ongoing
+  * @param None
+  * @retval true until the last byte has been sent
+******************************************************************************/
+static bool at_io_is_tx_busy(void)
+{
+  return (huart2.gState != HAL_UART_STATE_READY);
 }
 
 
+/******************************************************************************
+  * @brief This function returns the bytes written by the reception DMA since
+  *        Modem_IO_Init: the laps around the ring, plus the DMA position
+  * @param None
+  * @retval count of bytes received, modulo 2^32
+******************************************************************************/
+static uint32_t at_io_get_rx_count(void)
+{
+uint32_t primask = __get_PRIMASK();
+uint32_t laps;
+uint32_t pos;
+
+  __disable_irq();
+  pos = AT_ENGINE_RX_SIZE - __HAL_DMA_GET_COUNTER(huart2.hdmarx);
+  laps = ModemRxLaps;
+  if (__HAL_DMA_GET_FLAG(huart2.hdmarx, __HAL_DMA_GET_TC_FLAG_INDEX(huart2.hdmarx)) != RESET)
+  {
+    /*wrapped, the lap is not counted yet: the position is read again as it
+      may have been taken before the wrap*/
+    laps++;
+    pos = AT_ENGINE_RX_SIZE - __HAL_DMA_GET_COUNTER(huart2.hdmarx);
+  }
+  __set_PRIMASK(primask);
+
+  return (laps * AT_ENGINE_RX_SIZE) + pos;
+}
+
 
 /******************************************************************************
-  * @brief This function receives response from the slave device
-  * @param pdata: pointeur to the value returned by the slave
-  * @retval return code coming from slave
-******************************************************************************/ 
-static ATEerror_t at_cmd_receive(void *pdata)
+  * @brief This function returns the time base of the response timeouts
+  * @param None
+  * @retval time in ms
+******************************************************************************/
+static uint32_t at_io_get_time(void)
+{
+  return HAL_GetTick();
+}
+
+
+/******************************************************************************
+  * @brief This function wakes up the application, from the UART interrupt
+  * @param None
+  * @retval void
+******************************************************************************/
+static void at_io_notify(void)
+{
+  if (ModemNotify != NULL)
+  {
+    ModemNotify();
+  }
+}
+
+
+/******************************************************************************
+  * @brief This function sorts the lines received from the modem
+  * @param line: received line, without its <cr><lf>
+  * @retval ATEerror_t return code, AT_ENGINE_URC for an asynchronous event
+  *         or AT_ENGINE_INFO for a returned value
+******************************************************************************/
+static int16_t at_cmd_classify(const char *line)
+{
+ATEerror_t status;
+int i;
+
+  for (i = 0; i < (sizeof AsyncEventTab / sizeof AsyncEventTab[0]); i++)
+  {
+    if (strncmp(line, AsyncEventTab[i], strlen(AsyncEventTab[i])) == 0)
+    {
+      return (AT_ENGINE_URC);
+    }
+  }
+
+  status = at_cmd_responseAnalysing(line);
+  if (status == AT_END_ERROR)
+  {
+    return (AT_ENGINE_INFO);
+  }
+  return (status);
+}
+
+
+/******************************************************************************
+  * @brief This function receives a line of the response to an AT cmd
+  * @param context: ModemCmd_t of the cmd
+  * @param line: received line
+  * @retval void
+******************************************************************************/
+static void at_cmd_line(void *context, const char *line)
 {
-uint8_t  ResponseComplete = 0;
-int8_t i = 0;
-int8_t charnumber = 0;
+ModemCmd_t *Request = (ModemCmd_t *)context;
 char *ptrChr;
-ATEerror_t RetCode;
-uint8_t NoReturnCode =1;   /*to discriminate the Get return code from return value*/
-  
-  /*cleanup the response buffer*/
-  memset(response, 0x00, 16); 
 
-  /*UART peripheral in reception process for response returned by slave*/  
-  if(HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) != HAL_OK)
+  /*the first line returned to a GET cmd is its value*/
+  if ((Request->pdata != NULL) && !Request->ValueReceived)
   {
-   while (1);
-  } 
-  
-   
-  while (!ResponseComplete)
-  {  
-   
-      while (HW_UART_Modem_IsNewCharReceived() == RESET);   
-    
-      /*process the response*/    
-      response[i] = HW_UART_Modem_GetNewChar();
-         
-      /*wait up to carriage return OR the line feed marker*/
-       if (/*(response[i] =='\r') || */(response[i] == '\n'))
-       {
-        if(pdata == NULL) /*return code following a SET cmd or simple AT cmd*/
-        { 
-          if (i>1)  /*return code following a SET cmd or simple AT cmd- we skip the first <cr><ln>*/
-          {
-            i= 0;
-            ResponseComplete = 1;
-            RetCode = at_cmd_responseAnalysing(&response[2]);  /* to skip the '\0' in position [0]*/
-            break;
-          }  
-        }
-        else    /* returned value following a GET cmd */
-        {
-          if (i!= 0 && NoReturnCode)
-          {
-            /*first statement to get back the return value*/
-            response[i] = '\0';
-            if (gFlagException != AT_FWVERSION)         /*see comment in loara_driver.c*/
-            {  
-              ptrChr = strchr(&response[1],'=');       /*to skip the '\0''\r'*/
-              strcpy(pdata,ptrChr+1);
-              gFlagException = AT_END_AT;
-            }
-            else
-            { 
-              strcpy(pdata,&response[1]);  
-            } 
-            memset(response, 0x00, 16);
-            i= -1;             /*to compensate the next index iteration and restart in [0]*/
-            NoReturnCode = 0;  /*return code for the Get cmd*/
-          }
-          else
-          {
-            if (i>1)
-            { 
-              /*second statement to get back the return code*/
-              i= 0;
-              ResponseComplete = 1;   /*when value + return code have been trapped*/
-              RetCode = at_cmd_responseAnalysing(response);
-              memset(response, 0x00, 16);
-              break;        
-            }   
-          }
-        }  
-       }   
-       else
-       {
-        if (i ==  (DATA_RX_MAX_BUFF_SIZE-1)) /* frame overflow */           
-         {  
-           i = 0; 
-           return (AT_TEST_PARAM_OVERFLOW);
-         } 
-       }
-        i++;
-      HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) ;
-      charnumber++;
-  } 
-      huart2.gState = HAL_UART_STATE_READY;
-      huart2.RxState = HAL_UART_STATE_READY;        /*to be checked since was validated with previous */
-      return ( RetCode);                            /*version of HAL .. there was not Rx field state*/
+    ptrChr = strchr(line, '=');
+    if (!Request->PlainValue && (ptrChr != NULL))
+    {
+      strcpy(Request->pdata, ptrChr + 1);
+      gFlagException = AT_END_AT;
+    }
+    else
+    {
+      strcpy(Request->pdata, line);
+    }
+    Request->ValueReceived = true;
+  }
 }
 
 
+/******************************************************************************
+  * @brief This function completes an AT cmd
+  * @param context: ModemCmd_t of the cmd
+  * @param result: return code of the modem or AT_ENGINE_xxx error
+  * @retval void
+******************************************************************************/
+static void at_cmd_done(void *context, int16_t result)
+{
+ModemCmd_t *Request = (ModemCmd_t *)context;
+ATEerror_t Status;
+
+  if (result == AT_ENGINE_OVERFLOW)
+    Status = AT_TEST_PARAM_OVERFLOW;
+  else if (result < 0)
+    Status = AT_UART_LINK_ERROR;   /*not sent, or no answer of the modem*/
+  else if (Request->AnyRetCode)
+    Status = AT_OK;
+  else
+    Status = (ATEerror_t)result;
+
+  /*released first, done may queue the next cmd*/
+  Request->InUse = false;
+  if (Request->Done != NULL)
+  {
+    Request->Done(Request->Context, Status);
+  }
+}
 
 
 /******************************************************************************
-  * @brief This function receives asynchronus event from the slave device
-  * @param none
-  * @retval return code coming from slave
-******************************************************************************/ 
-static ATEerror_t at_cmd_receive_async_event(void)
+  * @brief This function receives the lines the modem sends on its own: they
+  *        answer the pending AT_ASYNC_EVENT wait, else go to the event
+  *        callback
+  * @param line: received line
+  * @retval void
+******************************************************************************/
+static void at_cmd_event(const char *line)
 {
-uint8_t  ResponseComplete = 0;
-int8_t i = 0;
-int8_t charnumber = 0;
+ModemEventWait_t *Wait = &ModemEventWait;
 char *ptrChr;
-ATEerror_t RetCode;
-uint8_t NoReturnCode =1;   /*too discriminate the Get reurn code from return value*/
-  
-  /*cleanup the response buffer*/
-  memset(response, 0x00, 16); 
 
-  /*UART peripheral in reception process for response returned by slave*/  
-  if(HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) != HAL_OK)
+  if (Wait->InUse)
   {
-   while (1);
-  } 
-  
-  while (!ResponseComplete)
-  {  
-   
-    while (HW_UART_Modem_IsNewCharReceived() == RESET);   
-    
-    /*process the response*/    
-    response[i] = HW_UART_Modem_GetNewChar();
-            
-    /*wait up to carriage return OR the line feed marker*/
-    if (/*(response[i] =='\r') || */(response[i] == '\n'))       
+    if (Wait->Cmd == AT_JOIN)
     {
-      if (i!= 0 && NoReturnCode)      /*trap the asynchronous event*/
+      /*the first event tells whether the join is accepted*/
+      at_cmd_event_done(at_cmd_AsyncEventAnalysing(line, NULL));
+      return;
+    }
+
+    /*sequence of events to be trapped: +RXPORT , +PAYLOADSIZE , +RCV*/
+    if (at_cmd_AsyncEventAnalysing(line, &Wait->DlinkData_Complete) == AT_OK)
+    {
+      ptrChr = strchr(line, '=');
+      if ((ptrChr != NULL) && (Wait->pdata != NULL))
       {
-        /*first statement to get back the return value*/
-        response[i] = '\0';
-        ptrChr = strchr(&response[1],'+');       /*to skip the '\0''\r'*/
-        RetCode = at_cmd_AsyncEventAnalysing(ptrChr,NULL);
-        memset(response, 0x00, 16);
-        i= -1;             /*to compensate the next index iteration and restart in [0]*/
-        NoReturnCode = 0;  /*return code for the Get cmd*/
-        break;
+        strcpy(Wait->pdata, ptrChr + 1);
+        Wait->pdata += strlen(ptrChr + 1);
+        *Wait->pdata++ = ',';     /* introduce separator in order to discriminate port, size and data*/
       }
-      else
+      if (Wait->DlinkData_Complete & (0x1u << 2))
       {
-        if (i>1)
-        { 
-          /*second statement to get back the return code*/
-          i= 0;
-          ResponseComplete = 1;   /*when value + return code have been trapped*/
-          RetCode = at_cmd_responseAnalysing(response);
-          memset(response, 0x00, 16);
-          break;        
-        }   
+        at_cmd_event_done(AT_OK);
       }
-    }   
-    else
-    {
-      if (i ==  (DATA_RX_MAX_BUFF_SIZE-1)) /* frame overflow */           
-      {  
-        i = 0; 
-        return (AT_TEST_PARAM_OVERFLOW);
-      } 
+      return;
     }
-      i++;
-      HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) ;
-      charnumber++;
-  } 
-      huart2.gState = HAL_UART_STATE_READY;
-      huart2.RxState = HAL_UART_STATE_READY;        /*to be checked since was validated with previous */
-      return ( RetCode);                            /*version of HAL .. there was not Rx field state*/
+  }
+
+  if (ModemEvent != NULL)
+  {
+    ModemEvent(line);
+  }
 }
 
 
+/******************************************************************************
+  * @brief This function completes the AT_ASYNC_EVENT wait
+  * @param status: module status
+  * @retval void
+******************************************************************************/
+static void at_cmd_event_done(ATEerror_t status)
+{
+Modem_AT_Done_t *Done = ModemEventWait.Done;
+
+  /*released first, done may wait for the next event*/
+  ModemEventWait.InUse = false;
+  if (Done != NULL)
+  {
+    Done(ModemEventWait.Context, status);
+  }
+}
+
 
 /******************************************************************************
-  * @brief This function receives asynchronus event from the slave device
-  * @param none
-  * @retval return code coming from slave
-******************************************************************************/ 
-static ATEerror_t at_cmd_receive_async_event_downlink_data(void *pdata)
+  * @brief This function completes the blocking Modem_AT_Cmd
+  * @param context: ModemSync_t of the caller
+  * @param status: module status
+  * @retval void
+******************************************************************************/
+static void at_cmd_sync_done(void *context, ATEerror_t status)
 {
+ModemSync_t *Sync = (ModemSync_t *)context;
 
-int8_t i = 0;
-int8_t charnumber = 0;
-char *ptrChr;
-ATEerror_t RetCode;
-uint8_t NoReturnCode =1;   /*too discriminate the Get reurn code from return value*/
-int8_t DlinkData_Complete = (0x1U);
+  Sync->Status = status;
+  Sync->Complete = true;
+}
 
-  /*cleanup the response buffer*/
-  memset(response, 0x00, 16); 
 
-  /*UART peripheral in reception process for response returned by slave*/  
-  if(HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) != HAL_OK)
+/******************************************************************************
+  * @brief This function runs the AT engine until a blocking cmd completes
+  * @param Sync: completion of the cmd
+  * @retval module status
+******************************************************************************/
+static ATEerror_t at_cmd_sync_wait(ModemSync_t *Sync)
+{
+  while (!Sync->Complete)
   {
-   while (1);
-  } 
-  
-   
-  while ( !(DlinkData_Complete & (0x1u <<2)))   /*received sequence not complete*/
-  {  
-   
-    while (HW_UART_Modem_IsNewCharReceived() == RESET);   
-    
-    /*process the response*/    
-    response[i] = HW_UART_Modem_GetNewChar();
-            
-      /*wait up to carriage return OR the line feed marker*/
-       if ((response[i] =='\r') || (response[i] == '\n'))        
-       {
-          if (i!= 0 && NoReturnCode)      /*trap the asynchronous events associated to network downlink data*/
-          {
-            /*sequence of events to be trapped: +RXPORT , +PAYLOADSIZE , +RCV*/
-            response[i] = '\0';
-            ptrChr = strchr(&response[0],'+');   /*Here when we go out from low power mode the prefix is*/
-                                                /* '\r' only. We do not skip the '\0''\r' - USI behavior ...*/
-            RetCode = at_cmd_AsyncEventAnalysing(ptrChr,&DlinkData_Complete);
-            if(RetCode == AT_OK)
-            {
-                ptrChr = strchr(&response[1],'=');       /*to skip the '\0''\r'*/
-                strcpy(pdata,ptrChr+1);
-                pdata = (char*)pdata + strlen(ptrChr+1);
-                *((char*)pdata) = ',';                  /* introduce separator in order to discriminate port, size and data*/
-                pdata = (char*)pdata + 1;
-            }   
-                
-            memset(response, 0x00, 16);
-            i= -1;             /*to compensate the next index iteration and restart in [0]*/
-//      NoReturnCode = 0;  /*return code for the Get cmd*/
-//                  break;
-          } 
-       }   
-       else
-       {
-          if (i ==  (DATA_RX_MAX_BUFF_SIZE-1)) /* frame overflow */           
-          {  
-            i = 0; 
-            return (AT_TEST_PARAM_OVERFLOW);
-          } 
-       }
-       i++;
-       HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) ;
-       charnumber++;
-  } 
-       huart2.gState = HAL_UART_STATE_READY;
-       huart2.RxState = HAL_UART_STATE_READY;        /*to be checked since was validated with previous */
-       return ( RetCode);                            /*version of HAL .. there was not Rx field state*/
+    AtEngineProcess();
+  }
+  return Sync->Status;
 }
 
+
 /******************************************************************************
   * @brief This function does analysis of the response received by the device
-  * @param response: pointer to the received response
-  * @retval ATEerror_t error type 
+  * @param ReturnResp: received line, without its <cr><lf>
+  * @retval ATEerror_t error type, AT_END_ERROR when not a return code
 ******************************************************************************/
 static ATEerror_t at_cmd_responseAnalysing(const char *ReturnResp)
 {
-ATEerror_t status;
+const char *RetCodeStr;
+size_t len;
 int i;
 
-    status = AT_END_ERROR;
-
     for (i = 0; i < AT_END_ERROR; i++)
     {   
-      if (strncmp(ReturnResp, ATE_RetCode[i].RetCodeStr, (ATE_RetCode[i].SizeRetCodeStr-1)) == 0)
+      /*the return codes of the table are framed by <cr> and <lf>*/
+      RetCodeStr = ATE_RetCode[i].RetCodeStr;
+      while (*RetCodeStr == '\r')
+      {
+        RetCodeStr++;
+      }
+      len = strcspn(RetCodeStr, "\r\n");
+      if ((strlen(ReturnResp) == len) && (strncmp(ReturnResp, RetCodeStr, len) == 0))
       {
         /* command has been found found*/
-        status = ATE_RetCode[i].RetCode;
-        return (status);
+        return (ATE_RetCode[i].RetCode);
       }          
     }
-      return (status);
+    return (AT_END_ERROR);
 }
 
 
 
 /******************************************************************************
   * @brief This function does analysis of the asynchronous event received by the device
-  * @param response: pointer to the received response
+  * @param ReturnResp: received line, without its <cr><lf>
+  * @param Flag: progress of the downlink data sequence, NULL for the join
   * @retval ATEerror_t error type 
 ******************************************************************************/
 static ATEerror_t at_cmd_AsyncEventAnalysing(const char *ReturnResp, int8_t *Flag)
@@ -773,13 +1004,18 @@ ATEerror_t status;
 
     status = AT_END_ERROR;
 
-    if (strncmp(ReturnResp, "+JoinAccepted\r", sizeof("+JoinAccepted\r")-1) == 0)
+    if (strncmp(ReturnResp, "+JoinAccepted", sizeof("+JoinAccepted")-1) == 0)
     {
       /* event has been identified*/
       status = AT_OK;
       return (status);
     }     
     
+    if (Flag == NULL)
+    {
+      return (status);
+    }
+
     /*following statements for network downlink data analysis*/
     if (strncmp(ReturnResp, "+RXPORT", sizeof("+RXPORT")-1) == 0)
     {
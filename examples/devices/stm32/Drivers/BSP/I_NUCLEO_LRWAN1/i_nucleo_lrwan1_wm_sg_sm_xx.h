@@ -43,6 +43,11 @@
                                           /*it is the worst-case when sending*/
                                           /*a max payload equal to 64 bytes*/
 
+#ifndef AT_RESPONSE_TIMEOUT
+#define AT_RESPONSE_TIMEOUT      5000     /*time allowed to the modem for the*/
+                                          /*return code of a cmd, in ms*/
+#endif
+
 typedef enum ATGroup
 {
   AT_CTRL = 0,
@@ -130,6 +135,9 @@ typedef struct sReceivedDataBinary
 }sReceivedDataBinary_t;
 
 
+/*completion of a queued AT cmd, see Modem_AT_Cmd_Async*/
+typedef void (Modem_AT_Done_t)(void *context, ATEerror_t status);
+
 /*type definition for return code analysis*/
 typedef  char* ATEerrorStr_t;
 
@@ -192,7 +200,8 @@ ATEerror_t Modem_IO_Init( void ) ;
 void Modem_IO_DeInit( void ) ;
 
 /******************************************************************************
- * @brief  Receive data in interrupt mode from modem UART interface.
+ * @brief  Restarts the reception from the modem UART interface when it has
+ *         stopped, e.g. on a UART error
  * @param  UART handle
  * @retval None
 *****************************************************************************/
@@ -207,6 +216,52 @@ void Modem_UART_Receive_IT(UART_HandleTypeDef *huart);
  *****************************************************************************/
 ATEerror_t Modem_AT_Cmd(ATGroup_t at_group, ATCmd_t Cmd, void *pdata );
 
+/******************************************************************************
+ * @brief  Queues an AT cmd, or waits for the asynchronous events of the
+ *         modem (AT_ASYNC_EVENT), returns at once. Up to AT_ENGINE_QUEUE_SIZE
+ *         cmds are pending at once, sent one after the other. AT_EXCEPT,
+ *         which needs the line quiet around it, is only sent by Modem_AT_Cmd
+ * @param  at_group AT group [control, set , get, async event, except_1)
+ *         Cmd AT command
+ *         pdata pointer to the IN/OUT buffer, valid until done is called
+ *         done called from Modem_AT_Process with the module status, may be NULL
+ *         context passed to done
+ * @retval AT_OK when queued
+ * @retval AT_BUSY_ERROR when the queue is full or an event wait is pending
+ *****************************************************************************/
+ATEerror_t Modem_AT_Cmd_Async(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context);
+
+/******************************************************************************
+ * @brief  Runs the AT engine: parses the responses, calls the done callbacks
+ *         and sends the next cmd. To be called from the main loop when
+ *         notified, and often enough for the response timeouts
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_Process( void );
+
+/******************************************************************************
+ * @brief  Registers the callbacks of the AT engine
+ * @param  notify called from the UART interrupt when bytes have been received
+ *         event called with the lines the modem sends on its own
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_SetCallbacks( void (*notify)(void), void (*event)(const char *line) );
+
+/******************************************************************************
+ * @brief  Modem UART interrupt, to be called from the USART IRQ handler
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_IO_IRQHandler( void );
+
+/******************************************************************************
+ * @brief  Modem UART DMA interrupt, to be called from the DMA IRQ handlers
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_IO_DMA_IRQHandler( void );
+
 
 
 #ifdef __cplusplus
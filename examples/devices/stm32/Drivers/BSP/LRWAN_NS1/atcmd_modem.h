@@ -203,6 +203,7 @@ __attribute__ ((unused))
  */
 typedef enum
 {
+  ATCTL_RET_BUSY = -4,            /* AT engine queue full */
   ATCTL_RET_TIMEOUT = -3,         /* RX data timeout */
   ATCTL_RET_ERR = -2,             /* Unknown command */
   ATCTL_RET_CMD_ERR = -1,         /* Get command +CMD: ERROR(x) */
@@ -25,6 +25,7 @@
 #include "hw_conf.h"
 #include "hw_usart.h"
 #include "lrwan_ns1_atcmd.h"
+#include "at_engine.h"
 #include "tiny_sscanf.h"
 #include "timeServer.h"
 
@@ -33,12 +34,42 @@
 #include "debug.h"
 
 #define ATCTL_WAKEUP    1
+#define ATCTL_WAKEUP_SIZE               (4)         /* 0xFF sent ahead of each command */
+#define ATCTL_DR_TIMEOUT                (3000)      /* ms, first line of AT+DR */
+#define ATCTL_TAG_SIZE                  (12)
+
+/*the commands and lines of the RisingHF modem are longer than the defaults of
+  the AT engine: the projects define these sizes for every file, e.g.
+  AT_ENGINE_CMD_SIZE=304 and AT_ENGINE_LINE_SIZE=250*/
+#if (AT_ENGINE_CMD_SIZE < (ATCTL_WAKEUP_SIZE + DATA_TX_MAX_BUFF_SIZE)) || (AT_ENGINE_LINE_SIZE < ATCTL_CMD_BUF_SIZE)
+#error "AT_ENGINE_CMD_SIZE or AT_ENGINE_LINE_SIZE too small for the RisingHF modem"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/*command in the pipeline of the AT engine*/
+typedef struct
+{
+  ATCmd_t Cmd;
+  char Tag[ATCTL_TAG_SIZE];   /*name of the command in its response lines: +Tag: ...*/
+  atctl_data_t *dt;           /*receives the parsed response*/
+  atctl_ret_t RetCode;        /*of the first line of the response*/
+  uint8_t Lines;              /*lines of the response parsed*/
+  uint8_t Follow;             /*further lines of the response to parse*/
+  bool InUse;
+  Modem_AT_Done_t *Done;
+  void *Context;
+} ModemCmd_t;
+
+/*completion of the blocking commands*/
+typedef struct
+{
+  volatile bool Complete;
+  atctl_ret_t Status;
+} ModemSync_t;
 
 /*Globle variables------------------------------------------------------------*/
-uint32_t record_num = 0;
 uint8_t atctl_dl_buf[256];
 char LoRa_AT_Cmd_Buff[DATA_TX_MAX_BUFF_SIZE];    /* Buffer used for AT cmd transmission */
-char response[DATA_RX_MAX_BUFF_SIZE];   /*not only for return code but also for return value: exemple KEY*/
 
 /* Private functions ---------------------------------------------------------*/
 static atctl_ret_t atctl_parse(char *buf, int len, atctl_data_t *dt);
@@ -52,13 +83,42 @@ static atctl_ret_t atctl_dr(char *buf, int len, atctl_data_t *dt);
 static atctl_ret_t atctl_mode(char *buf, int len, atctl_data_t *dt);
 static atctl_ret_t atctl_lw(char *buf, int len, atctl_data_t *dt);
 static atctl_ret_t atctl_delay(char *buf, int len, atctl_data_t *dt);
-static HAL_StatusTypeDef at_cmd_send(uint16_t len);
 
 static uint8_t at_cmd_format(ATCmd_t Cmd, void *ptr, Marker_t Marker);
+static atctl_ret_t at_cmd_submit(ATCmd_t Cmd, const char *name, uint16_t len, atctl_data_t *dt,
+                                 Modem_AT_Done_t *done, void *context);
+static bool at_io_transmit(const uint8_t *buff, uint16_t size);
+static bool at_io_is_tx_busy(void);
+static uint32_t at_io_get_rx_count(void);
+static uint32_t at_io_get_time(void);
+static void at_io_notify(void);
+static int16_t at_cmd_classify(const char *line);
+static void at_cmd_line(void *context, const char *line);
+static void at_cmd_done(void *context, int16_t result);
+static void at_cmd_event(const char *line);
+static void at_cmd_sync_done(void *context, atctl_ret_t status);
+static atctl_ret_t at_cmd_sync_wait(ModemSync_t *Sync);
 
 /* Private variables ---------------------------------------------------------*/
 static uint16_t Offset = 0;   /*write position needed for sendb command*/
-static uint8_t aRxBuffer[5];  /* Buffer used for Rx input character */
+static char ModemFrame[ATCTL_WAKEUP_SIZE + DATA_TX_MAX_BUFF_SIZE];  /*wakeup and command*/
+static ModemCmd_t ModemCmd[AT_ENGINE_QUEUE_SIZE];  /*one per command of the engine queue*/
+static volatile uint32_t ModemRxLaps = 0;   /*turns of the reception DMA around the ring*/
+static uint16_t ModemEventCount = 0;        /*lines stored for atctl_rx*/
+static void (*ModemNotify)(void) = NULL;
+static void (*ModemEvent)(const char *line) = NULL;
+
+/*serial link of the AT engine: DMA on huart1*/
+static const AtEngineIo_t ModemIo =
+{
+  at_io_transmit,
+  at_io_is_tx_busy,
+  at_io_get_rx_count,
+  at_io_get_time,
+  at_cmd_classify,
+  at_io_notify
+};
+
 static const atctl_cmd_list_t atctl_cmd_list[] = {
   {AT,             "AT",          atctl_at},
   {AT_FDEFAULT,    "FDEFAULT",    NULL},
@@ -724,27 +784,26 @@ static int atctl_buf(char *buf, char *fmt, va_list ap)
 }
 
 /**************************************************************
-* @brief  Send the command and receive
+* @brief  Send the command and receive, through the AT engine
 * @param  *dt: atctl_data_t
 * @retval LoRa return code
 **************************************************************/
 atctl_ret_t atctl_tx(atctl_data_t *dt, ATCmd_t cmd, char *fmt, ...)
 {
   char buf[256];
-  uint8_t wakeup_ch[4] = {0xFF, 0xFF, 0xFF, 0xFF};
   va_list ap;
   int i, len;
-  atctl_ret_t ret = ATCTL_RET_CMD_ERR;
-  HAL_StatusTypeDef HAL_Status;
+  ModemSync_t Sync;
+  atctl_ret_t ret;
 
-  for (i=0; i<AT_MAX; i++)
+  for (i=0; i<sizeof(atctl_cmd_list) / sizeof(atctl_cmd_list_t); i++)
   {
     if (cmd == atctl_cmd_list[i].cmd)
     {
       break;
     }
   }
-  if (i == AT_MAX)
+  if (i == sizeof(atctl_cmd_list) / sizeof(atctl_cmd_list_t))
   {
     return ATCTL_RET_ERR;
   }
@@ -753,13 +812,6 @@ atctl_ret_t atctl_tx(atctl_data_t *dt, ATCmd_t cmd, char *fmt, ...)
   len = atctl_buf(buf, fmt, ap);
   va_end(ap);
 
-  atctl_reset();
-
-  if (ATCTL_WAKEUP)
-  {
-    HAL_UART_Transmit(&huart1, wakeup_ch, strlen((char *)wakeup_ch), 5000);
-  }
-
   memset(LoRa_AT_Cmd_Buff, 0x00, sizeof LoRa_AT_Cmd_Buff);
 
   if ( (len != 0) && (cmd != AT) )
@@ -778,27 +830,13 @@ atctl_ret_t atctl_tx(atctl_data_t *dt, ATCmd_t cmd, char *fmt, ...)
     }
   }
 
-  HAL_Status = at_cmd_send(len);
-  if (HAL_Status != HAL_OK)
+  Sync.Complete = false;
+  ret = at_cmd_submit(cmd, atctl_cmd_list[i].name, len, dt, at_cmd_sync_done, &Sync);
+  if (ret != ATCTL_RET_IDLE)
   {
-    return (ATCTL_RET_ERR); /*problem on UART transmission*/
+    return ret;
   }
-  if (cmd != AT_RESET)
-  {
-    ret = at_cmd_receive(cmd, dt);
-  }
-#if defined CMD_DEBUG
-  if (len)
-  {
-    at_printf_send((uint8_t *)LoRa_AT_Cmd_Buff, len);
-  }
-
-  if (response[0] != '\0')
-  {
-    at_printf_send((uint8_t *)response, strlen(response));
-  }
-#endif
-  return ret;
+  return at_cmd_sync_wait(&Sync);
 }
 
 /**************************************************************
@@ -865,21 +903,32 @@ atctl_ret_t atctl_rx(atctl_data_t *dt, int timeout)
 }
 
 /******************************************************************************
-* @brief  Configures modem UART interface.
+* @brief  Configures modem UART interface: DMA transmission and circular DMA
+*         reception, with the idle line interrupt
 * @param  None
-* @retval AT_OK in case of success
-* @retval AT_UART_LINK_ERROR in case of failure
+* @retval HAL_OK in case of success
+* @retval HAL_ERROR in case of failure
 *****************************************************************************/
 HAL_StatusTypeDef Modem_IO_Init( void )
 {
-  if ( HW_UART_Modem_Init(BAUD_RATE)== HAL_OK )
+  if ( HW_UART_Modem_Init(BAUD_RATE)!= HAL_OK )
   {
-    return HAL_OK;
+    return HAL_ERROR;
   }
-  else
+
+  memset(ModemCmd, 0x00, sizeof ModemCmd);
+  ModemRxLaps = 0;
+  AtEngineInit(&ModemIo, at_cmd_event);
+
+  /*huart1.hdmarx must be linked to a channel in circular mode*/
+  if ( HAL_UART_Receive_DMA(&huart1, AtEngineGetRxBuffer(), AT_ENGINE_RX_SIZE) != HAL_OK )
   {
     return HAL_ERROR;
   }
+  __HAL_UART_CLEAR_IDLEFLAG(&huart1);
+  __HAL_UART_ENABLE_IT(&huart1, UART_IT_IDLE);
+
+  return HAL_OK;
 }
 
 
@@ -890,89 +939,232 @@ HAL_StatusTypeDef Modem_IO_Init( void )
 *****************************************************************************/
 void Modem_IO_DeInit( void )
 {
+  __HAL_UART_DISABLE_IT(&huart1, UART_IT_IDLE);
+  HAL_UART_DMAStop(&huart1);
   HAL_UART_MspDeInit(&huart2);
   HAL_UART_MspDeInit(&huart1);
 }
 
+
+/******************************************************************************
+* @brief  Modem UART interrupt, to be called from USART1_IRQHandler
+* @param  None
+* @retval None
+*****************************************************************************/
+void Modem_IO_IRQHandler( void )
+{
+  if ( __HAL_UART_GET_FLAG(&huart1, UART_FLAG_IDLE) != RESET )
+  {
+    /*end of a burst of the modem*/
+    __HAL_UART_CLEAR_IDLEFLAG(&huart1);
+    AtEngineRxIdle();
+  }
+  HAL_UART_IRQHandler(&huart1);
+}
+
+
 /******************************************************************************
- * @brief  Handle the AT cmd following their Groupp type
+* @brief  Modem UART DMA interrupt, to be called from the handlers of the
+*         DMA channels of huart1. It counts the laps of the reception
+* @param  None
+* @retval None
+*****************************************************************************/
+void Modem_IO_DMA_IRQHandler( void )
+{
+  if (huart1.hdmatx != NULL)
+  {
+    HAL_DMA_IRQHandler(huart1.hdmatx);
+  }
+  if (huart1.hdmarx != NULL)
+  {
+    if (__HAL_DMA_GET_FLAG(huart1.hdmarx, __HAL_DMA_GET_TC_FLAG_INDEX(huart1.hdmarx)) != RESET)
+    {
+      ModemRxLaps++;   /*the circular reception wrapped around the ring*/
+    }
+    HAL_DMA_IRQHandler(huart1.hdmarx);
+  }
+}
+
+
+/******************************************************************************
+* @brief  Registers the callbacks of the AT engine
+* @param  notify called from the UART interrupt when bytes have been received,
+*         Modem_AT_Process is then to be called from the main loop
+*         event called with the lines the modem sends on its own (e.g. the
+*         end of a join or of a send), else they are stored for atctl_rx
+* @retval None
+*****************************************************************************/
+void Modem_AT_SetCallbacks( void (*notify)(void), void (*event)(const char *line) )
+{
+  ModemNotify = notify;
+  ModemEvent = event;
+}
+
+
+/******************************************************************************
+ * @brief  Handle the AT cmd following their Groupp type, waits for the
+ *         response of the modem. The commands queued before are sent first
  * @param  at_group AT group [control, set , get)
  *         Cmd AT command
  *         pdata pointer to the IN/OUT buffer
- * @retval module status
+ * @retval module status, the response is parsed into dt
  *****************************************************************************/
 ATEerror_t  Modem_AT_Cmd(ATGroup_t at_group, ATCmd_t Cmd, void *pdata )
 {
-ATEerror_t Status = ATCTL_RET_ERR;
-HAL_StatusTypeDef HAL_Status;
+ModemSync_t Sync;
+ATEerror_t Status;
+
+  Sync.Complete = false;
+  Status = Modem_AT_Cmd_Async(at_group, Cmd, pdata, at_cmd_sync_done, &Sync);
+  if (Status != ATCTL_RET_IDLE)
+  {
+    return Status;
+  }
+  return at_cmd_sync_wait(&Sync);
+}
+
+
+/******************************************************************************
+ * @brief  Queues an AT cmd, returns at once
+ * @param  at_group AT group [control, set , get)
+ *         Cmd AT command
+ *         pdata pointer to the IN buffer, copied
+ *         done called from Modem_AT_Process with the module status once the
+ *         response is parsed into dt, may be NULL
+ *         context passed to done
+ * @retval ATCTL_RET_IDLE when queued
+ * @retval ATCTL_RET_BUSY when AT_ENGINE_QUEUE_SIZE commands are pending
+ * @retval ATCTL_RET_ERR for an unknown group
+ *****************************************************************************/
+ATEerror_t Modem_AT_Cmd_Async(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context)
+{
 uint16_t Len = 0;
-uint8_t wakeup_ch[4] = {0xFF, 0xFF, 0xFF, 0xFF};
 
   /*reset At_cmd buffer for each transmission*/
   memset(LoRa_AT_Cmd_Buff, 0x00, sizeof LoRa_AT_Cmd_Buff);
 
-  atctl_reset();
-
-  if (ATCTL_WAKEUP)
-  {
-    HAL_UART_Transmit(&huart1, wakeup_ch, strlen((char *)wakeup_ch), 5000);
-  }
-
   switch (at_group)
   {
     case AT_CTRL:
     {
       Len = at_cmd_format( Cmd, NULL, CTRL_MARKER);
-      HAL_Status = at_cmd_send(Len);
-      if (HAL_Status != HAL_OK)
-      {
-        return (ATCTL_RET_ERR); /*problem on UART transmission*/
-      }
-      Status = at_cmd_receive(Cmd, &dt);
       break;
     }
     case AT_SET:
     {
       Len = at_cmd_format(Cmd, pdata, SET_MARKER);
-      HAL_Status = at_cmd_send(Len);
-      if (HAL_Status != HAL_OK)
-      {
-        return (ATCTL_RET_ERR); /*problem on UART transmission*/
-      }
-      Status = at_cmd_receive(Cmd, &dt);
       break;
     }
     case AT_GET:
     {
       Len = at_cmd_format(Cmd, pdata, GET_MARKER);
-      HAL_Status = at_cmd_send(Len);
-      if (HAL_Status != HAL_OK)
-      {
-        return (ATCTL_RET_ERR); /*problem on UART transmission*/
-      }
-      Status = at_cmd_receive(Cmd, &dt);
       break;
     }
     default:
       DBG_PRINTF("unknow group\n\r");
-      break;
+      return (ATCTL_RET_ERR);
 
   } /*end switch(at_group)*/
 
-#if defined CMD_DEBUG
-  if (Len)
+  return at_cmd_submit(Cmd, CmdTab[Cmd], Len, &dt, done, context);
+}
+
+
+/******************************************************************************
+ * @brief  Runs the AT engine: parses the responses, calls the done callbacks
+ *         and sends the next command. To be called from the main loop
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_Process( void )
+{
+  AtEngineProcess();
+}
+
+
+/******************************************************************************
+ * @brief  Queues the AT cmd of LoRa_AT_Cmd_Buff in the engine, behind the
+ *         wakeup characters. The RisingHF modem has no final result code:
+ *         the response ends once the line has been quiet for
+ *         ATCTL_RX_TIMEOUT
+ * @param  Cmd AT command
+ *         name name of the command, e.g. "+ID=DevEui" or "ID": its response
+ *         lines start with +ID:
+ *         len length of the formated command
+ *         dt receives the parsed response
+ *         done called with the LoRa return code, may be NULL
+ *         context passed to done
+ * @retval ATCTL_RET_IDLE when queued
+ *****************************************************************************/
+static atctl_ret_t at_cmd_submit(ATCmd_t Cmd, const char *name, uint16_t len, atctl_data_t *dt,
+                                 Modem_AT_Done_t *done, void *context)
+{
+ModemCmd_t *Request = NULL;
+uint32_t Timeout = ATCTL_RX_TIMEOUT;
+uint16_t Size = 0;
+uint8_t i;
+
+  for (i = 0; i < AT_ENGINE_QUEUE_SIZE; i++)
+  {
+    if (!ModemCmd[i].InUse)
+    {
+      Request = &ModemCmd[i];
+      break;
+    }
+  }
+  if (Request == NULL)
   {
-    at_printf_send((uint8_t *)LoRa_AT_Cmd_Buff, Len);
+    return (ATCTL_RET_BUSY);
   }
 
-  if (response[0] != '\0')
+  if (*name == '+')
+  {
+    name++;
+  }
+  for (i = 0; (i < ATCTL_TAG_SIZE - 1) && (name[i] != '\0') && (name[i] != '='); i++)
   {
-    at_printf_send((uint8_t *)response, strlen(response));
+    Request->Tag[i] = name[i];
   }
+  Request->Tag[i] = '\0';
+  if (i == 0)
+  {
+    strcpy(Request->Tag, "AT");   /*AT answers +AT: OK*/
+  }
+
+  if (Cmd == AT_RESET)
+  {
+    Timeout = 0;   /*the modem does not answer*/
+  } else if (Cmd == AT_DR)
+  {
+    Timeout = ATCTL_DR_TIMEOUT;
+  }
+
+  if (ATCTL_WAKEUP)
+  {
+    memset(ModemFrame, 0xFF, ATCTL_WAKEUP_SIZE);
+    Size = ATCTL_WAKEUP_SIZE;
+  }
+  memcpy(&ModemFrame[Size], LoRa_AT_Cmd_Buff, len);
+  Size += len;
+
+#if defined CMD_DEBUG
+  at_printf_send((uint8_t *)LoRa_AT_Cmd_Buff, len);
 #endif
-  return Status;
-}
 
+  Request->Cmd = Cmd;
+  Request->dt = dt;
+  Request->RetCode = ATCTL_RET_IDLE;
+  Request->Lines = 0;
+  Request->Follow = 0;
+  Request->Done = done;
+  Request->Context = context;
+  if (!AtEngineSubmitQuiet(ModemFrame, Size, Timeout, ATCTL_RX_TIMEOUT, at_cmd_line, at_cmd_done, Request))
+  {
+    return (ATCTL_RET_BUSY);
+  }
+  Request->InUse = true;
+  return (ATCTL_RET_IDLE);
+}
 
 /******************************************************************************
  * @brief  format the cmd in order to be send
@@ -1313,183 +1505,310 @@ static uint8_t at_cmd_format(ATCmd_t Cmd, void *ptr, Marker_t Marker)
 }
 
 /******************************************************************************
-* @brief This function sends an AT cmd to the slave device
+* @brief This function sends an AT cmd to debug in PC
 * @param len: length of the AT cmd to be sent
 * @retval HAL return code
 ******************************************************************************/
-static HAL_StatusTypeDef at_cmd_send(uint16_t len)
+HAL_StatusTypeDef at_printf_send(uint8_t *buf, uint16_t len)
 {
   HAL_StatusTypeDef RetCode;
 
-  /*transmit the command from master to slave*/
-  RetCode = HAL_UART_Transmit(&huart1, (uint8_t*)LoRa_AT_Cmd_Buff, len, 5000);
+  /*transmit the command from master to debug*/
+  RetCode = HAL_UART_Transmit(&huart2, (uint8_t *)buf, len, 5000);
   return ( RetCode);
 }
 
 /******************************************************************************
-* @brief This function sends an AT cmd to debug in PC
-* @param len: length of the AT cmd to be sent
-* @retval HAL return code
+* @brief This function starts the DMA transmission of an AT cmd
+* @param buff: AT cmd
+* @param size: length of the AT cmd
+* @retval true when the transmission started
 ******************************************************************************/
-HAL_StatusTypeDef at_printf_send(uint8_t *buf, uint16_t len)
+static bool at_io_transmit(const uint8_t *buff, uint16_t size)
 {
-  HAL_StatusTypeDef RetCode;
+  return (HAL_UART_Transmit_DMA(&huart1, (uint8_t *)buff, size) == HAL_OK);
+}
 
-  /*transmit the command from master to debug*/
-  RetCode = HAL_UART_Transmit(&huart2, (uint8_t *)buf, len, 5000);
-  return ( RetCode);
+/******************************************************************************
+* @brief This function tells whether a transmission is ongoing
+* @param None
+* @retval true until the last byte has been sent
+******************************************************************************/
+static bool at_io_is_tx_busy(void)
+{
+  return (huart1.gState != HAL_UART_STATE_READY);
 }
 
 /******************************************************************************
-* @brief This function receives response from the slave device
-* @param viod
-* @retval LoRa return code
+* @brief This function returns the bytes written by the reception DMA since
+*        Modem_IO_Init: the laps around the ring, plus the DMA position
+* @param None
+* @retval count of bytes received, modulo 2^32
 ******************************************************************************/
-atctl_ret_t at_cmd_receive_evt(void)
+static uint32_t at_io_get_rx_count(void)
 {
-  uint8_t  ResponseComplete = 0;
+  uint32_t primask = __get_PRIMASK();
+  uint32_t laps;
+  uint32_t pos;
+
+  __disable_irq();
+  pos = AT_ENGINE_RX_SIZE - __HAL_DMA_GET_COUNTER(huart1.hdmarx);
+  laps = ModemRxLaps;
+  if (__HAL_DMA_GET_FLAG(huart1.hdmarx, __HAL_DMA_GET_TC_FLAG_INDEX(huart1.hdmarx)) != RESET)
+  {
+    /*wrapped, the lap is not counted yet: the position is read again as it
+      may have been taken before the wrap*/
+    laps++;
+    pos = AT_ENGINE_RX_SIZE - __HAL_DMA_GET_COUNTER(huart1.hdmarx);
+  }
+  __set_PRIMASK(primask);
 
-  atctl_ret_t RetCode = ATCTL_RET_CMD_OK;
-  uint32_t time_ms = 0;
-  /*cleanup the response buffer*/
-  memset(response, 0x00, sizeof(response));
+  return (laps * AT_ENGINE_RX_SIZE) + pos;
+}
 
-  record_num = 0;
+/******************************************************************************
+* @brief This function returns the time base of the response timeouts
+* @param None
+* @retval time in ms
+******************************************************************************/
+static uint32_t at_io_get_time(void)
+{
+  return HAL_GetTick();
+}
 
-  /*UART peripheral in reception process for response returned by slave*/
-  if (HAL_UART_Receive_IT(&huart1, (uint8_t *)aRxBuffer,1) != HAL_OK)
+/******************************************************************************
+* @brief This function wakes up the application, from the UART interrupt
+* @param None
+* @retval void
+******************************************************************************/
+static void at_io_notify(void)
+{
+  if (ModemNotify != NULL)
   {
-    while (1);
+    ModemNotify();
   }
+}
+
+/******************************************************************************
+* @brief This function sorts the lines received from the modem: the RisingHF
+*        modem has no final result code, every line is information
+* @param line: received line, without its <cr><lf>
+* @retval AT_ENGINE_INFO
+******************************************************************************/
+static int16_t at_cmd_classify(const char *line)
+{
+  return (AT_ENGINE_INFO);
+}
 
+/******************************************************************************
+* @brief This function parses a line of the response to an AT cmd. Only the
+*        lines named after the cmd belong to it: the others, e.g. the end of
+*        a previous join or send, are events
+* @param context: ModemCmd_t of the cmd
+* @param line: received line
+* @retval void
+******************************************************************************/
+static void at_cmd_line(void *context, const char *line)
+{
+  ModemCmd_t *Request = (ModemCmd_t *)context;
+  int len = strlen(Request->Tag);
+  atctl_ret_t RetCode;
 
-  time_ms = TimerGetCurrentTime();
+#if defined CMD_DEBUG
+  at_printf_send((uint8_t *)line, strlen(line));
+#endif
+
+  if ( (line[0] != '+') || (strncasecmp(line + 1, Request->Tag, len) != 0) || (line[len + 1] != ':') )
+  {
+    at_cmd_event(line);
+    return;
+  }
 
-  while (!ResponseComplete)
+  if (Request->Lines == 0)
   {
-    while (HW_UART_Modem_IsNewCharReceived() == RESET)
+    memset(Request->dt, 0, sizeof(atctl_data_t));
+    Request->RetCode = atctl_parse((char *)line, strlen(line), Request->dt);
+    Request->Lines++;
+
+    /*the lines parsed further, as many as the response has*/
+    switch (Request->RetCode)
     {
-      if (record_num!=0)
-      {
-        if (response[record_num-1] != '\n')
+      case ATCTL_RET_CMD_MSG:
+        if ( (Request->dt->msg.sta == ATCTL_MSG_START) &&
+             ( (Request->Cmd == AT_CMSG) || (Request->Cmd == AT_CMSGHEX) ) )
         {
-          continue;
+          Request->Follow = 1;     /* dump TX echo*/
         }
-      }
-      if (TimerGetElapsedTime(time_ms) > 300)
-      {
-        ResponseComplete = 1;
         break;
-      }
-    }
-
-    if (ResponseComplete)
-    {
-      break;
-    }
-
-    time_ms = TimerGetCurrentTime();
-
-    /*process the response*/
-    response[record_num] = HW_UART_Modem_GetNewChar();
-
-    if (response[record_num] == '\0')
-    {
-      continue;
+      case ATCTL_RET_CMD_JOIN:
+        if (Request->dt->join.sta == ATCTL_MSG_START)
+        {
+          Request->Follow = 1;
+        }
+        break;
+      case ATCTL_RET_CMD_ID:
+        Request->Follow = 2;
+        break;
+      case ATCTL_RET_CMD_DR:
+        Request->Follow = 1;
+        break;
+      case ATCTL_RET_CMD_DELAY:
+        Request->Follow = 3;
+        break;
+      default:
+        break;
     }
+    return;
+  }
 
-    /*process the rx data in the atctl_rx_byte*/
-    atctl_rx_byte(response[record_num++]);
-
-    HAL_UART_Receive_IT(&huart1, (uint8_t *)aRxBuffer,1) ;
+  if (Request->Follow == 0)
+  {
+    /*beyond the response, e.g. the end of a send: left to the application*/
+    at_cmd_event(line);
+    return;
   }
-  huart1.gState = HAL_UART_STATE_READY;
-  huart1.RxState = HAL_UART_STATE_READY;        /*to be checked since was validated with previous */
 
-  return RetCode;
+  RetCode = atctl_parse((char *)line, strlen(line), Request->dt);
+  Request->Lines++;
+  Request->Follow--;
+  if ( ( (Request->RetCode == ATCTL_RET_CMD_ID) || (Request->RetCode == ATCTL_RET_CMD_DELAY) ) &&
+       (RetCode != Request->RetCode) )
+  {
+    Request->Follow = 0;
+  }
 }
 
 /******************************************************************************
-* @brief This function receives response from the slave device and parse
-* @param Cmd: command type
-* @param *dt: atctl_data_t type
-* @retval LoRa return code
+* @brief This function completes an AT cmd
+* @param context: ModemCmd_t of the cmd
+* @param result: 0 at the end of the response, or AT_ENGINE_xxx error
+* @retval void
 ******************************************************************************/
-atctl_ret_t at_cmd_receive(ATCmd_t Cmd, atctl_data_t *dt)
+static void at_cmd_done(void *context, int16_t result)
 {
-  uint8_t  ResponseComplete = 0;
-  uint16_t i = 0;
-  uint32_t time_ms = 0;
-
-  atctl_ret_t RetCode = ATCTL_RET_IDLE;
+  ModemCmd_t *Request = (ModemCmd_t *)context;
+  atctl_ret_t Status;
 
-  uint32_t response_timeout = 0;
-  /*cleanup the response buffer*/
-  memset(response, 0x00, sizeof(response));
-
-  /*UART peripheral in reception process for response returned by slave*/
-  if (HAL_UART_Receive_IT(&huart1, (uint8_t *)aRxBuffer,1) != HAL_OK)
+  if (result == AT_ENGINE_TIMEOUT)
+  {
+    Status = ATCTL_RET_IDLE;   /*no answer of the modem*/
+  } else if (result < 0)
   {
-    while (1);
+    Status = ATCTL_RET_ERR;    /*not sent, or response lost*/
+  }
+  else
+  {
+    Status = Request->RetCode;
   }
 
+  /*released first, done may queue the next cmd*/
+  Request->InUse = false;
+  if (Request->Done != NULL)
+  {
+    Request->Done(Request->Context, Status);
+  }
+}
 
-  time_ms = TimerGetCurrentTime();
+/******************************************************************************
+* @brief This function receives the lines the modem sends on its own: they go
+*        to the event callback, else are stored for atctl_rx
+* @param line: received line
+* @retval void
+******************************************************************************/
+static void at_cmd_event(const char *line)
+{
+  if (ModemEvent != NULL)
+  {
+    ModemEvent(line);
+    return;
+  }
 
-  while (!ResponseComplete)
+  while (*line != '\0')
   {
-    while (HW_UART_Modem_IsNewCharReceived() == RESET)
-    {
-      if ((Cmd == AT_DR) && (i == 0))
-      {
-        response_timeout = 3000;
-      }
-      else
-      {
-        response_timeout = 300;
-      }
+    atctl_rx_byte((uint8_t)*line++);
+  }
+  atctl_rx_byte('\r');
+  atctl_rx_byte('\n');
+  ModemEventCount++;
+}
 
-      if (TimerGetElapsedTime(time_ms) > response_timeout)
-      {
-        ResponseComplete = 1;
-        break;
-      }
-    }
+/******************************************************************************
+* @brief This function completes a blocking cmd
+* @param context: ModemSync_t of the caller
+* @param status: LoRa return code
+* @retval void
+******************************************************************************/
+static void at_cmd_sync_done(void *context, atctl_ret_t status)
+{
+  ModemSync_t *Sync = (ModemSync_t *)context;
 
-    if (ResponseComplete)
-    {
-      break;
-    }
+  Sync->Status = status;
+  Sync->Complete = true;
+}
 
-    time_ms = TimerGetCurrentTime();
+/******************************************************************************
+* @brief This function runs the AT engine until a blocking cmd completes
+* @param Sync: completion of the cmd
+* @retval LoRa return code
+******************************************************************************/
+static atctl_ret_t at_cmd_sync_wait(ModemSync_t *Sync)
+{
+  while (!Sync->Complete)
+  {
+    AtEngineProcess();
+  }
+  return Sync->Status;
+}
 
-    /*process the response*/
-    response[i] = HW_UART_Modem_GetNewChar();
+/******************************************************************************
+* @brief This function receives the lines the modem sends on its own, until
+*        the line has been quiet for ATCTL_RX_TIMEOUT. They are stored for
+*        atctl_rx when no event callback is registered
+* @param viod
+* @retval LoRa return code
+******************************************************************************/
+atctl_ret_t at_cmd_receive_evt(void)
+{
+  uint16_t count = ModemEventCount;
+  uint32_t time_ms = HAL_GetTick();
 
-    if (response[i] == '\0')
+  while ((HAL_GetTick() - time_ms) < ATCTL_RX_TIMEOUT)
+  {
+    AtEngineProcess();
+    if (ModemEventCount != count)
     {
-      continue;
+      count = ModemEventCount;
+      time_ms = HAL_GetTick();
     }
+  }
 
-    /*process the rx data in the atctl_rx_byte*/
-    atctl_rx_byte(response[i]);
-
-    i++;
+  return ATCTL_RET_CMD_OK;
+}
 
-    HAL_UART_Receive_IT(&huart1, (uint8_t *)aRxBuffer,1) ;
-  }
-  huart1.gState = HAL_UART_STATE_READY;
-  huart1.RxState = HAL_UART_STATE_READY;        /*to be checked since was validated with previous */
+/******************************************************************************
+* @brief This function receives lines the modem sends on its own, e.g. the
+*        end of a join, and parses them as the response to Cmd
+* @param Cmd: command type
+* @param *dt: atctl_data_t type
+* @retval LoRa return code, ATCTL_RET_IDLE when nothing was received
+******************************************************************************/
+atctl_ret_t at_cmd_receive(ATCmd_t Cmd, atctl_data_t *dt)
+{
+  uint16_t i = 0;
+  atctl_ret_t RetCode = ATCTL_RET_IDLE;
 
+  at_cmd_receive_evt();
 
   /* need to parse the rx data, and RetCode indicates the result */
-  if (i == 0)
+  if ( (atctl_sta != ATCTL_RX_DONE) && ( (atctl_sta != ATCTL_PARSE_DONE) || (atctl_rx_tmp_cnt == 0) ) )
   {
     return RetCode;
   }
 
   memset(dt, 0, sizeof(atctl_data_t));
   /*handle  and parse the rx data*/
+  RetCode = atctl_rx(dt, ATCTL_RX_TIMEOUT);
+
   RetCode = atctl_rx(dt, 300);//300ms
 
   /*do next base on the parsed data*/
@@ -204,6 +204,9 @@ typedef enum eBandPlans
   BAND_MAX,
 } BandPlans_t;
 
+/*completion of a queued AT cmd, see Modem_AT_Cmd_Async*/
+typedef void (Modem_AT_Done_t)(void *context, atctl_ret_t status);
+
 uint16_t at_cmd_vprintf(const char *format, ...);
 
 /* Exported constants --------------------------------------------------------*/
@@ -219,9 +222,10 @@ uint16_t at_cmd_vprintf(const char *format, ...);
 /* Exported functions ------------------------------------------------------- */
 
 /******************************************************************************
- * @brief  Configures modem UART interface.
+ * @brief  Configures modem UART interface: DMA transmission and circular DMA
+ *         reception, with the idle line interrupt
  * @param  None
- * @retval AT_OK in case of success
+ * @retval HAL_OK in case of success
  * @retval HAL_ERROR in case of failure
 *****************************************************************************/
 HAL_StatusTypeDef Modem_IO_Init( void ) ;
@@ -234,15 +238,18 @@ HAL_StatusTypeDef Modem_IO_Init( void ) ;
 void Modem_IO_DeInit( void ) ;
 
 /******************************************************************************
-* @brief This function receives response from the slave device and parse
+* @brief This function receives lines the modem sends on its own, e.g. the
+*        end of a join, and parses them as the response to Cmd
 * @param Cmd: command type
 * @param *dt: atctl_data_t type
-* @retval LoRa return code
+* @retval LoRa return code, ATCTL_RET_IDLE when nothing was received
 ******************************************************************************/
 atctl_ret_t at_cmd_receive(ATCmd_t Cmd, atctl_data_t *dt);
 
 /******************************************************************************
-* @brief This function receives response from the slave device
+* @brief This function receives the lines the modem sends on its own, until
+*        the line has been quiet for ATCTL_RX_TIMEOUT. They are stored for
+*        atctl_rx when no event callback is registered
 * @param viod
 * @retval LoRa return code
 ******************************************************************************/
@@ -256,7 +263,7 @@ atctl_ret_t at_cmd_receive_evt(void);
 atctl_ret_t atctl_rx(atctl_data_t *dt, int timeout);
 
 /**************************************************************
-* @brief  Send the command and receive
+* @brief  Send the command and receive, through the AT engine
 * @param  *dt: atctl_data_t
 * @retval LoRa return code
 **************************************************************/
@@ -264,8 +271,62 @@ atctl_ret_t atctl_tx(atctl_data_t *dt, ATCmd_t cmd, char *fmt, ...);
 
 HAL_StatusTypeDef at_printf_send(uint8_t *buf, uint16_t len);
 
+/******************************************************************************
+ * @brief  Handle the AT cmd following their Groupp type, waits for the
+ *         response of the modem. The commands queued before are sent first
+ * @param  at_group AT group [control, set , get)
+ *         Cmd AT command
+ *         pdata pointer to the IN/OUT buffer
+ * @retval module status, the response is parsed into dt
+ *****************************************************************************/
 ATEerror_t  Modem_AT_Cmd(ATGroup_t at_group, ATCmd_t Cmd, void *pdata );
 
+/******************************************************************************
+ * @brief  Queues an AT cmd, returns at once. Up to AT_ENGINE_QUEUE_SIZE cmds
+ *         are pending at once, sent one after the other
+ * @param  at_group AT group [control, set , get)
+ *         Cmd AT command
+ *         pdata pointer to the IN buffer, copied
+ *         done called from Modem_AT_Process with the module status once the
+ *         response is parsed into dt, may be NULL
+ *         context passed to done
+ * @retval ATCTL_RET_IDLE when queued
+ * @retval ATCTL_RET_BUSY when the queue is full
+ *****************************************************************************/
+ATEerror_t Modem_AT_Cmd_Async(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context);
+
+/******************************************************************************
+ * @brief  Runs the AT engine: parses the responses, calls the done callbacks
+ *         and sends the next cmd. To be called from the main loop when
+ *         notified, and often enough for the response timeouts
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_Process( void );
+
+/******************************************************************************
+ * @brief  Registers the callbacks of the AT engine
+ * @param  notify called from the UART interrupt when bytes have been received
+ *         event called with the lines the modem sends on its own, else they
+ *         are stored for atctl_rx
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_SetCallbacks( void (*notify)(void), void (*event)(const char *line) );
+
+/******************************************************************************
+ * @brief  Modem UART interrupt, to be called from the USART IRQ handler
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_IO_IRQHandler( void );
+
+/******************************************************************************
+ * @brief  Modem UART DMA interrupt, to be called from the DMA IRQ handlers
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_IO_DMA_IRQHandler( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@
 #include "hw_conf.h"
 #include "hw_usart.h"
 #include "atcmd.h"
+#include "at_engine.h"
 #include "tiny_sscanf.h"
 
 #include <stdarg.h>
@@ -34,6 +35,23 @@
 
 /* External variables --------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
+/*command in the pipeline of the AT engine*/
+typedef struct
+{
+  void *pdata;                /*receives the value returned by a GET cmd*/
+  bool ValueReceived;
+  bool InUse;
+  Modem_AT_Done_t *Done;
+  void *Context;
+} ModemCmd_t;
+
+/*completion of the blocking Modem_AT_Cmd*/
+typedef struct
+{
+  volatile bool Complete;
+  ATEerror_t Status;
+} ModemSync_t;
+
 /* Private define ------------------------------------------------------------*/
 
 
@@ -46,11 +64,12 @@ char LoRa_AT_Cmd_Buff[DATA_TX_MAX_BUFF_SIZE];    /* Buffer used for AT cmd trans
 
 static uint16_t Offset = 0;   /*write position needed for sendb command*/
 
-static uint8_t aRxBuffer[5];  /* Buffer used for Rx input character */
+static ModemCmd_t ModemCmd[AT_ENGINE_QUEUE_SIZE];  /*one per command of the engine queue*/
 
-static char response[DATA_RX_MAX_BUFF_SIZE];  /*has to be the largest of the response*/
-                                            /*not only for return code but also for*/
-                                            /*return value: exemple KEY*/
+static volatile uint32_t ModemRxLaps = 0;   /*turns of the reception DMA around the ring*/
+
+static void (*ModemNotify)(void) = NULL;
+static void (*ModemEvent)(const char *line) = NULL;
 
 /****************************************************************************/
 /*here we have to include a list of AT cmd by the way of #include<file>     */
@@ -70,34 +89,68 @@ static char response[DATA_RX_MAX_BUFF_SIZE];  /*has to be the largest of the res
 
 static uint8_t at_cmd_format(ATCmd_t Cmd, void *ptr, Marker_t Marker);
 
-static HAL_StatusTypeDef at_cmd_send(uint16_t len);
+static bool at_io_transmit(const uint8_t *buff, uint16_t size);
+
+static bool at_io_is_tx_busy(void);
+
+static uint32_t at_io_get_rx_count(void);
+
+static uint32_t at_io_get_time(void);
+
+static int16_t at_cmd_responseAnalysing(const char *line);
+
+static void at_io_notify(void);
 
-static ATEerror_t at_cmd_receive(void *pdata);
+static void at_cmd_line(void *context, const char *line);
 
-static ATEerror_t at_cmd_responseAnalysing(const char *ReturnResp);
+static void at_cmd_done(void *context, int16_t result);
 
-//static void at_cmd_send_noresp(uint16_t len);
+static void at_cmd_event(const char *line);
+
+static void at_cmd_sync_done(void *context, ATEerror_t status);
+
+/*serial link of the AT engine: DMA on huart2*/
+static const AtEngineIo_t ModemIo =
+{
+  at_io_transmit,
+  at_io_is_tx_busy,
+  at_io_get_rx_count,
+  at_io_get_time,
+  at_cmd_responseAnalysing,
+  at_io_notify
+};
 
 
 /* Exported functions ------------------------------------------------------- */
 
 
 /******************************************************************************
- * @brief  Configures modem UART interface.
+ * @brief  Configures modem UART interface: DMA transmission and circular DMA
+ *         reception, with the idle line interrupt
  * @param  None
  * @retval AT_OK in case of success
  * @retval AT_UART_LINK_ERROR in case of failure
 *****************************************************************************/
 ATEerror_t Modem_IO_Init( void )
 {
-  if ( HW_UART_Modem_Init(BAUD_RATE)== HAL_OK )
+  if ( HW_UART_Modem_Init(BAUD_RATE)!= HAL_OK )
   {
-    return AT_OK;
+    return AT_UART_LINK_ERROR;
   }
-  else
+
+  memset(ModemCmd, 0x00, sizeof ModemCmd);
+  ModemRxLaps = 0;
+  AtEngineInit(&ModemIo, at_cmd_event);
+
+  /*huart2.hdmarx must be linked to a channel in circular mode*/
+  if ( HAL_UART_Receive_DMA(&huart2, AtEngineGetRxBuffer(), AT_ENGINE_RX_SIZE) != HAL_OK )
   {
     return AT_UART_LINK_ERROR;
   }
+  __HAL_UART_CLEAR_IDLEFLAG(&huart2);
+  __HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
+
+  return AT_OK;
 }
 
 
@@ -108,12 +161,69 @@ ATEerror_t Modem_IO_Init( void )
 *****************************************************************************/
 void Modem_IO_DeInit( void )
 {
+  __HAL_UART_DISABLE_IT(&huart2, UART_IT_IDLE);
+  HAL_UART_DMAStop(&huart2);
   HAL_UART_MspDeInit(&huart2);
 }
 
 
 /******************************************************************************
- * @brief  Handle the AT cmd following their Groupp type
+ * @brief  Modem UART interrupt, to be called from USART2_IRQHandler
+ * @param  None
+ * @retval None
+*****************************************************************************/
+void Modem_IO_IRQHandler( void )
+{
+  if ( __HAL_UART_GET_FLAG(&huart2, UART_FLAG_IDLE) != RESET )
+  {
+    /*end of a burst of the modem*/
+    __HAL_UART_CLEAR_IDLEFLAG(&huart2);
+    AtEngineRxIdle();
+  }
+  HAL_UART_IRQHandler(&huart2);
+}
+
+
+/******************************************************************************
+ * @brief  Modem UART DMA interrupt, to be called from the handlers of the
+ *         DMA channels of huart2. It counts the laps of the reception
+ * @param  None
+ * @retval None
+*****************************************************************************/
+void Modem_IO_DMA_IRQHandler( void )
+{
+  if (huart2.hdmatx != NULL)
+  {
+    HAL_DMA_IRQHandler(huart2.hdmatx);
+  }
+  if (huart2.hdmarx != NULL)
+  {
+    if (__HAL_DMA_GET_FLAG(huart2.hdmarx, __HAL_DMA_GET_TC_FLAG_INDEX(huart2.hdmarx)) != RESET)
+    {
+      ModemRxLaps++;   /*the circular reception wrapped around the ring*/
+    }
+    HAL_DMA_IRQHandler(huart2.hdmarx);
+  }
+}
+
+
+/******************************************************************************
+ * @brief  Registers the callbacks of the AT engine
+ * @param  notify called from the UART interrupt when bytes have been received,
+ *         Modem_AT_Process is then to be called from the main loop
+ *         event called with the lines the modem sends on its own
+ * @retval None
+*****************************************************************************/
+void Modem_AT_SetCallbacks( void (*notify)(void), void (*event)(const char *line) )
+{
+  ModemNotify = notify;
+  ModemEvent = event;
+}
+
+
+/******************************************************************************
+ * @brief  Handle the AT cmd following their Groupp type, waits for the
+ *         response of the modem. The commands queued before are sent first
  * @param  at_group AT group [control, set , get)
  *         Cmd AT command
  *         pdata pointer to the IN/OUT buffer
@@ -121,9 +231,51 @@ void Modem_IO_DeInit( void )
  *****************************************************************************/
 ATEerror_t  Modem_AT_Cmd(ATGroup_t at_group, ATCmd_t Cmd, void *pdata )
 {
-ATEerror_t Status = AT_END_ERROR;
-HAL_StatusTypeDef HAL_Status;
+ModemSync_t Sync;
+ATEerror_t Status;
+
+  Sync.Complete = false;
+  Sync.Status = AT_END_ERROR;
+
+  Status = Modem_AT_Cmd_Async(at_group, Cmd, pdata, at_cmd_sync_done, &Sync);
+  if(Status != AT_OK)
+    return Status;
+
+  while (!Sync.Complete)
+  {
+    AtEngineProcess();
+  }
+  return Sync.Status;
+}
+
+
+/******************************************************************************
+ * @brief  Queues an AT cmd, returns at once
+ * @param  at_group AT group [control, set , get)
+ *         Cmd AT command
+ *         pdata pointer to the IN/OUT buffer, valid until done is called
+ *         done called from Modem_AT_Process with the module status, may be NULL
+ *         context passed to done
+ * @retval AT_OK when queued
+ * @retval AT_BUSY_ERROR when AT_ENGINE_QUEUE_SIZE commands are pending
+ *****************************************************************************/
+ATEerror_t Modem_AT_Cmd_Async(ATGroup_t at_group, ATCmd_t Cmd, void *pdata, Modem_AT_Done_t *done, void *context)
+{
+ModemCmd_t *Request = NULL;
 uint16_t Len;  
+uint32_t Timeout = AT_RESPONSE_TIMEOUT;
+uint8_t i;
+
+  for (i = 0; i < AT_ENGINE_QUEUE_SIZE; i++)
+  {
+    if (!ModemCmd[i].InUse)
+    {
+      Request = &ModemCmd[i];
+      break;
+    }
+  }
+  if (Request == NULL)
+    return (AT_BUSY_ERROR);
 
    /*reset At_cmd buffer for each transmission*/
    memset(LoRa_AT_Cmd_Buff, 0x00, sizeof LoRa_AT_Cmd_Buff); 
@@ -133,37 +285,48 @@ uint16_t Len;
   case AT_CTRL:
   {
       Len = at_cmd_format( Cmd, NULL, CTRL_MARKER); 
-      HAL_Status = at_cmd_send(Len);
-       if(HAL_Status != HAL_OK)
-          return (AT_UART_LINK_ERROR); /*problem on UART transmission*/
-      if(Cmd != AT_RESET)       
-          Status = at_cmd_receive(NULL);   
+      if(Cmd == AT_RESET)       
+          Timeout = 0;   /*the modem does not answer*/
+      pdata = NULL;
     break;
   }  
   case AT_SET:
   {
       Len = at_cmd_format(Cmd, pdata, SET_MARKER); 
-      HAL_Status = at_cmd_send(Len);
-      if(HAL_Status != HAL_OK)
-        return (AT_UART_LINK_ERROR); /*problem on UART transmission*/
-      Status = at_cmd_receive(NULL);
+      pdata = NULL;
     break;
   }  
   case AT_GET:
   {
       Len = at_cmd_format(Cmd, pdata, GET_MARKER);       
-      HAL_Status = at_cmd_send(Len);
-      if(HAL_Status != HAL_OK)
-        return (AT_UART_LINK_ERROR); /*problem on UART transmission*/      
-      Status = at_cmd_receive(pdata);
     break;
   }  
   default:
     DBG_PRINTF("unknow group\n\r");
-    break;
+    return (AT_END_ERROR);
     
   } /*end switch (at_group)*/
-  return Status;
+
+  Request->pdata = pdata;
+  Request->ValueReceived = false;
+  Request->Done = done;
+  Request->Context = context;
+  if (!AtEngineSubmit(LoRa_AT_Cmd_Buff, Len, Timeout, at_cmd_line, at_cmd_done, Request))
+    return (AT_BUSY_ERROR);
+  Request->InUse = true;
+  return (AT_OK);
+}
+
+
+/******************************************************************************
+ * @brief  Runs the AT engine: parses the responses, calls the done callbacks
+ *         and sends the next command. To be called from the main loop
+ * @param  None
+ * @retval None
+ *****************************************************************************/
+void Modem_AT_Process( void )
+{
+  AtEngineProcess();
 }
 
 
@@ -355,146 +518,177 @@ char value_c;      /*for 8_C*/
 
 
 /******************************************************************************
-  * @brief This function sends an AT cmd to the slave device
-  * @param len: length of the AT cmd to be sent
-  * @retval HAL return code
+  * @brief This function starts the DMA transmission of an AT cmd
+  * @param buff: AT cmd
+  * @param size: length of the AT cmd
+  * @retval true when the transmission started
 ******************************************************************************/
-static HAL_StatusTypeDef at_cmd_send(uint16_t len)
+static bool at_io_transmit(const uint8_t *buff, uint16_t size)
 {
-HAL_StatusTypeDef RetCode;
-
-  /*transmit the command from master to slave*/
-  RetCode = HAL_UART_Transmit(&huart2, (uint8_t*)LoRa_AT_Cmd_Buff, len, 5000);
-  return ( RetCode);  
+  return (HAL_UART_Transmit_DMA(&huart2, (uint8_t *)buff, size) == HAL_OK);
 }
 
 
-
 /******************************************************************************
-  * @brief This function receives response from the slave device
-  * @param pdata: pointeur to the value returned by the slave
-  * @retval return code coming from slave
-******************************************************************************/ 
-static ATEerror_t at_cmd_receive(void *pdata)
+  * @brief This function tells whether a transmission is ongoing
+  * @param None
+  * @retval true until the last byte has been sent
+******************************************************************************/
+static bool at_io_is_tx_busy(void)
 {
-uint8_t  ResponseComplete = 0;
-int8_t i = 0;
-int8_t charnumber = 0;
-ATEerror_t RetCode;
-uint8_t NoReturnCode =1;   /*to discriminate the Get return code from return value*/
-  
-  /*cleanup the response buffer*/
-  memset(response, 0x00, 16); 
+  return (huart2.gState != HAL_UART_STATE_READY);
+}
+
 
-  /*UART peripheral in reception process for response returned by slave*/  
-  if(HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) != HAL_OK)
+/******************************************************************************
+  * @brief This function returns the bytes written by the reception DMA since
+  *        Modem_IO_Init: the laps around the ring, plus the DMA position
+  * @param None
+  * @retval count of bytes received, modulo 2^32
+******************************************************************************/
+static uint32_t at_io_get_rx_count(void)
+{
+uint32_t primask = __get_PRIMASK();
+uint32_t laps;
+uint32_t pos;
+
+  __disable_irq();
+  pos = AT_ENGINE_RX_SIZE - __HAL_DMA_GET_COUNTER(huart2.hdmarx);
+  laps = ModemRxLaps;
+  if (__HAL_DMA_GET_FLAG(huart2.hdmarx, __HAL_DMA_GET_TC_FLAG_INDEX(huart2.hdmarx)) != RESET)
   {
-   while (1);
-  } 
-   
-  while (!ResponseComplete)
-  {  
-    while (HW_UART_Modem_IsNewCharReceived() == RESET);   
-  
-   /*process the response*/    
-    response[i] = HW_UART_Modem_GetNewChar();
-   
-   /*wait up to carriage return OR the line feed marker*/
-   if (/*(response[i] =='\r') || */(response[i] == '\n'))
-   {
-     if(pdata == NULL) /*return code following a SET cmd or simple AT cmd*/
-     { 
-       if (i>1)  /*return code following a SET cmd or simple AT cmd- we skip the first <cr><ln>*/
-       {
-         i= 0;
-         ResponseComplete = 1;
-         RetCode = at_cmd_responseAnalysing(response);
-           break;
-       }  
-     }
-     else    /* returned value following a GET cmd */
-     {
-       if (i!= 0 && NoReturnCode)
-       {
-         /*first statement to get back the return value*/
-         response[i] = '\0';
-         strcpy(pdata,response);
-         memset(response, 0x00, 16);
-         i= -1;  /*to compensate the next index iteration and restart in [0]*/
-         NoReturnCode = 0;  /*return code for the Get cmd*/
-       }
-       else
-       {
-         if (i>1)
-         { 
-           /*second statement to get back the return code*/
-           i= 0;
-           ResponseComplete = 1;   /*when value + return code have been trapped*/
-           RetCode = at_cmd_responseAnalysing(response);
-           memset(response, 0x00, 16);
-           break;        
-         }   
-       }
-     }  
-   }   
-   else
-   {
-     if (i ==  (DATA_RX_MAX_BUFF_SIZE-1)) /* frame overflow */           
-     {  
-       i = 0; 
-       return (AT_TEST_PARAM_OVERFLOW);
-     } 
-   }
-     i++;
-    HAL_UART_Receive_IT(&huart2, (uint8_t *)aRxBuffer,1) ;
-    charnumber++;
-  } /*end while(!Responsablecomplete)*/
-  huart2.gState = HAL_UART_STATE_READY;
-  huart2.RxState = HAL_UART_STATE_READY;        /*to be checked since was validated with previous */
-  return ( RetCode);                            /*version of HAL .. there was not Rx field state*/
+    /*wrapped, the lap is not counted yet: the position is read again as it
+      may have been taken before the wrap*/
+    laps++;
+    pos = AT_ENGINE_RX_SIZE - __HAL_DMA_GET_COUNTER(huart2.hdmarx);
+  }
+  __set_PRIMASK(primask);
+
+  return (laps * AT_ENGINE_RX_SIZE) + pos;
 }
 
 
+/******************************************************************************
+  * @brief This function returns the time base of the response timeouts
+  * @param None
+  * @retval time in ms
+******************************************************************************/
+static uint32_t at_io_get_time(void)
+{
+  return HAL_GetTick();
+}
+
 
 /******************************************************************************
   * @brief This function does analysis of the response received by the device
-  * @param response: pointer to the received response
-  * @retval ATEerror_t error type 
+  * @param line: received line, without its <cr><lf>
+  * @retval ATEerror_t error type, or AT_ENGINE_INFO for a returned value
 ******************************************************************************/
-static ATEerror_t at_cmd_responseAnalysing(const char *ReturnResp)
+static int16_t at_cmd_responseAnalysing(const char *line)
 {
-ATEerror_t status;
 int i;
+size_t len;
 
-    status = AT_END_ERROR;
-
-    for (i = 0; i < AT_END_ERROR; i++)
+    for (i = 0; i < (sizeof ATE_RetCode / sizeof ATE_RetCode[0]); i++)
     {   
-      if (strncmp(ReturnResp, ATE_RetCode[i].RetCodeStr, (ATE_RetCode[i].SizeRetCodeStr-1)) == 0)
+      /*the return codes are framed by <cr><lf>*/
+      len = ATE_RetCode[i].SizeRetCodeStr - 5;
+      if ((strlen(line) == len) && (strncmp(line, ATE_RetCode[i].RetCodeStr + 2, len) == 0))
       {
-        /* command has been found found*/
-        status = ATE_RetCode[i].RetCode;
-        return (status);
+        return (ATE_RetCode[i].RetCode);
       }          
     }
-      return (status);
+    return (AT_ENGINE_INFO);
+}
+
+
+/******************************************************************************
+  * @brief This function wakes up the application, from the UART interrupt
+  * @param None
+  * @retval void
+******************************************************************************/
+static void at_io_notify(void)
+{
+  if (ModemNotify != NULL)
+  {
+    ModemNotify();
+  }
 }
 
 
 /******************************************************************************
-  * @brief This function sends an AT cmd to the slave device
-  * @brief It is an AT cmd without response from slave device
-  * @param len: length of the AT cmd to be sent
+  * @brief This function receives a line of the response to an AT cmd
+  * @param context: ModemCmd_t of the cmd
+  * @param line: received line
   * @retval void
-******************************************************************************/ 
-//static void at_cmd_send_noresp(uint16_t len)
-//{
-//  /*transmit the command from master to slave*/
-//  if(HAL_UART_Transmit(&huart2, (uint8_t*)LoRa_AT_Cmd_Buff, len, 5000) != HAL_OK) 
-//  {
-//   while (1);
-//  } 
-//}
+******************************************************************************/
+static void at_cmd_line(void *context, const char *line)
+{
+ModemCmd_t *Request = (ModemCmd_t *)context;
+
+  /*the first line returned to a GET cmd is its value*/
+  if ((Request->pdata != NULL) && !Request->ValueReceived)
+  {
+    strcpy(Request->pdata, line);
+    Request->ValueReceived = true;
+  }
+}
+
+
+/******************************************************************************
+  * @brief This function completes an AT cmd
+  * @param context: ModemCmd_t of the cmd
+  * @param result: return code of the modem or AT_ENGINE_xxx error
+  * @retval void
+******************************************************************************/
+static void at_cmd_done(void *context, int16_t result)
+{
+ModemCmd_t *Request = (ModemCmd_t *)context;
+ATEerror_t Status;
+
+  if (result == AT_ENGINE_OVERFLOW)
+    Status = AT_TEST_PARAM_OVERFLOW;
+  else if (result < 0)
+    Status = AT_UART_LINK_ERROR;   /*not sent, or no answer of the modem*/
+  else
+    Status = (ATEerror_t)result;
+
+  /*released first, done may queue the next cmd*/
+  Request->InUse = false;
+  if (Request->Done != NULL)
+  {
+    Request->Done(Request->Context, Status);
+  }
+}
+
+
+/******************************************************************************
+  * @brief This function receives the lines the modem sends on its own
+  * @param line: received line
+  * @retval void
+******************************************************************************/
+static void at_cmd_event(const char *line)
+{
+  if (ModemEvent != NULL)
+  {
+    ModemEvent(line);
+  }
+}
+
+
+/******************************************************************************
+  * @brief This function completes the blocking Modem_AT_Cmd
+  * @param context: ModemSync_t of the caller
+  * @param status: module status
+  * @retval void
+******************************************************************************/
+static void at_cmd_sync_done(void *context, ATEerror_t status)
+{
+ModemSync_t *Sync = (ModemSync_t *)context;
+
+  Sync->Status = status;
+  Sync->Complete = true;
+}
 
 
 /******************************************************************************
@@ -69,6 +69,7 @@ extern "C" {
 #include "humidity.h"
 #include "temperature.h"
 #include "pressure.h"
+#include "sensor_bus.h"
 
 /** @addtogroup BSP BSP
  * @{
@@ -249,6 +250,7 @@ extern "C" {
  */
 
 DrvStatusTypeDef Sensor_IO_Init( void );
+void Sensor_IO_IRQHandler( void );
 DrvStatusTypeDef LSM6DS0_Sensor_IO_ITConfig( void );
 DrvStatusTypeDef LSM6DS3_Sensor_IO_ITConfig( void );
 DrvStatusTypeDef LPS22HB_Sensor_IO_ITConfig( void );
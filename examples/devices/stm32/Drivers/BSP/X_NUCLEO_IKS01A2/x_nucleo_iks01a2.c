@@ -217,6 +217,12 @@ uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint
 {
   DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
 
+  /* the bus belongs to the interrupt driven transfers until they are done */
+  if ( SensorBus_IsBusy() )
+  {
+    return 1;
+  }
+
   /* call I2C_EXPBD Read data bus function */
   if ( I2C_EXPBD_WriteData( ctx->address, WriteAddr, pBuffer, nBytesToWrite ) )
   {
@@ -243,6 +249,12 @@ uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16
 {
   DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
 
+  /* the bus belongs to the interrupt driven transfers until they are done */
+  if ( SensorBus_IsBusy() )
+  {
+    return 1;
+  }
+
   /* call I2C_EXPBD Read data bus function */
   if ( I2C_EXPBD_ReadData( ctx->address, ReadAddr, pBuffer, nBytesToRead ) )
   {
@@ -256,6 +268,120 @@ uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16
 
 
 
+/**
+ * @brief  Starts writing a buffer to the sensor, SensorBus_TransferComplete is
+ *         called from the I2C interrupt once done
+ * @param  handle instance handle
+ * @param  WriteAddr specifies the internal sensor address register to be written to
+ * @param  pBuffer pointer to data buffer, kept until the transfer is complete
+ * @param  nBytesToWrite number of bytes to be written
+ * @retval 0 in case of success
+ * @retval 1 in case of failure
+ */
+uint8_t Sensor_IO_Write_IT( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+
+  if ( HAL_I2C_Mem_Write_IT( &I2C_EXPBD_Handle, ctx->address, ( uint16_t )WriteAddr, I2C_MEMADD_SIZE_8BIT, pBuffer,
+                             nBytesToWrite ) != HAL_OK )
+  {
+    return 1;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+
+
+/**
+ * @brief  Starts reading from the sensor to buffer, SensorBus_TransferComplete
+ *         is called from the I2C interrupt once done
+ * @param  handle instance handle
+ * @param  ReadAddr specifies the internal sensor address register to be read from
+ * @param  pBuffer pointer to data buffer
+ * @param  nBytesToRead number of bytes to be read
+ * @retval 0 in case of success
+ * @retval 1 in case of failure
+ */
+uint8_t Sensor_IO_Read_IT( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+
+  if ( HAL_I2C_Mem_Read_IT( &I2C_EXPBD_Handle, ctx->address, ( uint16_t )ReadAddr, I2C_MEMADD_SIZE_8BIT, pBuffer,
+                            nBytesToRead ) != HAL_OK )
+  {
+    return 1;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+
+
+/**
+ * @brief  Handles the I2C event and error interrupts, to be called from the
+ *         I2C IRQ handler(s) of the application
+ * @param  None
+ * @retval None
+ */
+void Sensor_IO_IRQHandler( void )
+{
+  HAL_I2C_EV_IRQHandler( &I2C_EXPBD_Handle );
+  HAL_I2C_ER_IRQHandler( &I2C_EXPBD_Handle );
+}
+
+
+
+/**
+ * @brief  Memory Tx transfer completed callback
+ * @param  hi2c I2C handle
+ * @retval None
+ */
+void HAL_I2C_MemTxCpltCallback( I2C_HandleTypeDef *hi2c )
+{
+  if ( hi2c == &I2C_EXPBD_Handle )
+  {
+    SensorBus_TransferComplete( COMPONENT_OK );
+  }
+}
+
+
+
+/**
+ * @brief  Memory Rx transfer completed callback
+ * @param  hi2c I2C handle
+ * @retval None
+ */
+void HAL_I2C_MemRxCpltCallback( I2C_HandleTypeDef *hi2c )
+{
+  if ( hi2c == &I2C_EXPBD_Handle )
+  {
+    SensorBus_TransferComplete( COMPONENT_OK );
+  }
+}
+
+
+
+/**
+ * @brief  I2C error callback, the bus is re-initialized as for blocking transfers
+ * @param  hi2c I2C handle
+ * @retval None
+ */
+void HAL_I2C_ErrorCallback( I2C_HandleTypeDef *hi2c )
+{
+  if ( hi2c == &I2C_EXPBD_Handle )
+  {
+    I2C_EXPBD_Error( 0 );  /* the address is not used */
+    SensorBus_TransferComplete( COMPONENT_ERROR );
+  }
+}
+
+
+
 /******************************* I2C Routines *********************************/
 
 /**
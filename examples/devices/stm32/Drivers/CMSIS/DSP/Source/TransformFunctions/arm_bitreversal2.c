@@ -0,0 +1,103 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_bitreversal2.c
+ * Description:  Bitreversal functions
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: Cortex-M cores
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_math.h"
+#include "arm_common_tables.h"
+
+/*
+ * C version of arm_bitreversal2.S, for the host build of Tests/ the
+ * assembly file does not support. The device projects link the .S file.
+ * Link one of them, not both.
+ */
+
+/*
+* @brief  In-place bit reversal function.
+* @param[in, out] *pSrc        points to the in-place buffer of 32-bit data type.
+* @param[in]      bitRevLen    bit reversal table length
+* @param[in]      *pBitRevTab  points to bit reversal table.
+* @return none.
+*/
+
+void arm_bitreversal_32(
+uint32_t * pSrc,
+const uint16_t bitRevLen,
+const uint16_t * pBitRevTab)
+{
+   uint32_t a, b, i, tmp;
+
+   /* the table holds byte offsets of complex q31/f32 values */
+   for (i = 0u; i < bitRevLen; i += 2u)
+   {
+      a = pBitRevTab[i] >> 2u;
+      b = pBitRevTab[i + 1u] >> 2u;
+
+      /* real */
+      tmp = pSrc[a];
+      pSrc[a] = pSrc[b];
+      pSrc[b] = tmp;
+
+      /* imaginary */
+      tmp = pSrc[a + 1u];
+      pSrc[a + 1u] = pSrc[b + 1u];
+      pSrc[b + 1u] = tmp;
+   }
+}
+
+/*
+* @brief  In-place bit reversal function.
+* @param[in, out] *pSrc        points to the in-place buffer of 16-bit data type.
+* @param[in]      bitRevLen    bit reversal table length
+* @param[in]      *pBitRevTab  points to bit reversal table.
+* @return none.
+*/
+
+void arm_bitreversal_16(
+uint16_t * pSrc,
+const uint16_t bitRevLen,
+const uint16_t * pBitRevTab)
+{
+   uint32_t a, b, i;
+   uint16_t tmp;
+
+   /* same table as arm_bitreversal_32: the offsets of q15 values are halved */
+   for (i = 0u; i < bitRevLen; i += 2u)
+   {
+      a = pBitRevTab[i] >> 2u;
+      b = pBitRevTab[i + 1u] >> 2u;
+
+      /* real */
+      tmp = pSrc[a];
+      pSrc[a] = pSrc[b];
+      pSrc[b] = tmp;
+
+      /* imaginary */
+      tmp = pSrc[a + 1u];
+      pSrc[a + 1u] = pSrc[b + 1u];
+      pSrc[b + 1u] = tmp;
+   }
+}
@@ -0,0 +1,183 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_biquad_cascade_df1_f32.c
+ * Description:  Processing function for the floating-point Biquad cascade DirectFormI(DF1) filter, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of FilteringFunctions/arm_biquad_cascade_df1_f32.c, see arm_x86_utils.h.
+ * The feed-forward part b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] of a chunk of
+ * outputs is computed in the lanes, the recursive part sample by sample. The
+ * recursion is bound by the latency of its multiply-adds, so the stages run
+ * two at a time: the second stage filters each output of the first one as
+ * soon as it is known, and the two recursions overlap
+ */
+
+/* Samples per chunk, a multiple of X86_LANES */
+#define BIQUAD_CHUNK     64u
+
+/* One stage, or two in a row */
+static void arm_biquad_stages_f32(
+  const float32_t * pCoeffs,
+  float32_t * pState,
+  const float32_t * pIn,
+  float32_t * pOut,
+  uint32_t blockSize,
+  uint32_t numStages)
+{
+  float32_t x[BIQUAD_CHUNK + 2u];                /*  x[n-2], x[n-1], then the chunk */
+  float32_t ff[BIQUAD_CHUNK];                    /*  Feed-forward part of the chunk */
+  float32_t acc, acc2;                           /*  Simulates the accumulators */
+  float32_t b0, b1, b2, a1, a2;                  /*  First stage coefficients  */
+  float32_t c0 = 0.0f, c1 = 0.0f, c2 = 0.0f, d1 = 0.0f, d2 = 0.0f;  /* Second stage */
+  float32_t Yn1, Yn2;                            /*  First stage state         */
+  float32_t Xm1 = 0.0f, Xm2 = 0.0f, Ym1 = 0.0f, Ym2 = 0.0f;  /*  Second stage state */
+  x86_f32_t vb0, vb1, vb2;
+  uint32_t sample = blockSize;                   /*  loop counters             */
+  uint32_t n, len;
+
+  b0 = pCoeffs[0];
+  b1 = pCoeffs[1];
+  b2 = pCoeffs[2];
+  a1 = pCoeffs[3];
+  a2 = pCoeffs[4];
+
+  x[1] = pState[0];
+  x[0] = pState[1];
+  Yn1 = pState[2];
+  Yn2 = pState[3];
+
+  if (numStages == 2u)
+  {
+    c0 = pCoeffs[5];
+    c1 = pCoeffs[6];
+    c2 = pCoeffs[7];
+    d1 = pCoeffs[8];
+    d2 = pCoeffs[9];
+
+    Xm1 = pState[4];
+    Xm2 = pState[5];
+    Ym1 = pState[6];
+    Ym2 = pState[7];
+  }
+
+  vb0 = x86_f32_set1(b0);
+  vb1 = x86_f32_set1(b1);
+  vb2 = x86_f32_set1(b2);
+
+  while (sample > 0u)
+  {
+    len = (sample < BIQUAD_CHUNK) ? sample : BIQUAD_CHUNK;
+
+    /* The chunk is copied first, the stages may run in place */
+    memcpy(&x[2], pIn, len * sizeof(float32_t));
+    pIn += len;
+
+    for (n = 0u; n + X86_LANES <= len; n += X86_LANES)
+    {
+      x86_f32_store(&ff[n], x86_f32_add(x86_f32_add(x86_f32_mul(vb0, x86_f32_load(&x[n + 2u])),
+                                                    x86_f32_mul(vb1, x86_f32_load(&x[n + 1u]))),
+                                        x86_f32_mul(vb2, x86_f32_load(&x[n]))));
+    }
+
+    for (; n < len; n++)
+    {
+      ff[n] = (b0 * x[n + 2u]) + (b1 * x[n + 1u]) + (b2 * x[n]);
+    }
+
+    if (numStages == 2u)
+    {
+      for (n = 0u; n < len; n++)
+      {
+        acc = ff[n] + (a1 * Yn1) + (a2 * Yn2);
+        Yn2 = Yn1;
+        Yn1 = acc;
+
+        acc2 = (c0 * acc) + (c1 * Xm1) + (c2 * Xm2) + (d1 * Ym1) + (d2 * Ym2);
+        *pOut++ = acc2;
+        Xm2 = Xm1;
+        Xm1 = acc;
+        Ym2 = Ym1;
+        Ym1 = acc2;
+      }
+    }
+    else
+    {
+      for (n = 0u; n < len; n++)
+      {
+        acc = ff[n] + (a1 * Yn1) + (a2 * Yn2);
+        *pOut++ = acc;
+        Yn2 = Yn1;
+        Yn1 = acc;
+      }
+    }
+
+    x[0] = x[len];
+    x[1] = x[len + 1u];
+    sample -= len;
+  }
+
+  pState[0] = x[1];
+  pState[1] = x[0];
+  pState[2] = Yn1;
+  pState[3] = Yn2;
+
+  if (numStages == 2u)
+  {
+    pState[4] = Xm1;
+    pState[5] = Xm2;
+    pState[6] = Ym1;
+    pState[7] = Ym2;
+  }
+}
+
+void arm_biquad_cascade_df1_f32(
+  const arm_biquad_casd_df1_inst_f32 * S,
+  float32_t * pSrc,
+  float32_t * pDst,
+  uint32_t blockSize)
+{
+  float32_t *pIn = pSrc;                             /*  source pointer            */
+  float32_t *pState = S->pState;                     /*  pState pointer            */
+  float32_t *pCoeffs = S->pCoeffs;                   /*  coefficient pointer       */
+  uint32_t stage = S->numStages;                 /*  loop counter              */
+  uint32_t numStages;                            /*  Stages of the pass        */
+
+  do
+  {
+    numStages = (stage >= 2u) ? 2u : 1u;
+
+    arm_biquad_stages_f32(pCoeffs, pState, pIn, pDst, blockSize, numStages);
+
+    /* The stages after the first ones run in place */
+    pCoeffs += 5u * numStages;
+    pState += 4u * numStages;
+    pIn = pDst;
+    stage -= numStages;
+
+  } while (stage > 0u);
+}
@@ -0,0 +1,203 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_biquad_cascade_df1_q31.c
+ * Description:  Processing function for the Q31 Biquad cascade filter, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of FilteringFunctions/arm_biquad_cascade_df1_q31.c, see arm_x86_utils.h.
+ * The feed-forward part b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] of a chunk of
+ * outputs is computed in the lanes, the recursive part sample by sample. The
+ * recursion is bound by the latency of its multiply-adds, so the stages run
+ * two at a time: the second stage filters each output of the first one as
+ * soon as it is known, and the two recursions overlap
+ */
+
+/* Samples per chunk, a multiple of X86_LANES */
+#define BIQUAD_CHUNK     64u
+
+/* One stage, or two in a row */
+static void arm_biquad_stages_q31(
+  const arm_biquad_casd_df1_inst_q31 * S,
+  const q31_t * pCoeffs,
+  q31_t * pState,
+  const q31_t * pIn,
+  q31_t * pOut,
+  uint32_t blockSize,
+  uint32_t numStages)
+{
+  q31_t x[BIQUAD_CHUNK + 2u];                    /*  x[n-2], x[n-1], then the chunk */
+  q63_t ff[BIQUAD_CHUNK];                        /*  Feed-forward part of the chunk */
+  q63_t acc, acc2;                               /*  accumulators                  */
+  uint32_t lShift = 32u - ((uint32_t) S->postShift + 1u);  /*  Shift to be applied to the output */
+  q31_t b0, b1, b2, a1, a2;                      /*  First stage coefficients      */
+  q31_t c0 = 0, c1 = 0, c2 = 0, d1 = 0, d2 = 0;  /*  Second stage coefficients     */
+  q31_t Yn1, Yn2;                                /*  First stage state             */
+  q31_t Xm1 = 0, Xm2 = 0, Ym1 = 0, Ym2 = 0;      /*  Second stage state            */
+  x86_i32_t vb0, vb1, vb2, x0, x1, x2;
+  uint32_t sample = blockSize;                   /*  loop counters                 */
+  uint32_t n, len;
+
+  b0 = pCoeffs[0];
+  b1 = pCoeffs[1];
+  b2 = pCoeffs[2];
+  a1 = pCoeffs[3];
+  a2 = pCoeffs[4];
+
+  x[1] = pState[0];
+  x[0] = pState[1];
+  Yn1 = pState[2];
+  Yn2 = pState[3];
+
+  if (numStages == 2u)
+  {
+    c0 = pCoeffs[5];
+    c1 = pCoeffs[5 + 1];
+    c2 = pCoeffs[5 + 2];
+    d1 = pCoeffs[5 + 3];
+    d2 = pCoeffs[5 + 4];
+
+    Xm1 = pState[4];
+    Xm2 = pState[5];
+    Ym1 = pState[6];
+    Ym2 = pState[7];
+  }
+
+  vb0 = x86_i32_set1(b0);
+  vb1 = x86_i32_set1(b1);
+  vb2 = x86_i32_set1(b2);
+
+  while (sample > 0u)
+  {
+    len = (sample < BIQUAD_CHUNK) ? sample : BIQUAD_CHUNK;
+
+    /* The chunk is copied first, the stages may run in place */
+    memcpy(&x[2], pIn, len * sizeof(q31_t));
+    pIn += len;
+
+    for (n = 0u; n + X86_LANES <= len; n += X86_LANES)
+    {
+      x0 = x86_q31_load(&x[n + 2u]);
+      x1 = x86_q31_load(&x[n + 1u]);
+      x2 = x86_q31_load(&x[n]);
+      x86_i64_store_even_odd(&ff[n],
+                             x86_i64_add(x86_i64_add(x86_i64_mul_even(vb0, x0), x86_i64_mul_even(vb1, x1)),
+                                         x86_i64_mul_even(vb2, x2)),
+                             x86_i64_add(x86_i64_add(x86_i64_mul_odd(vb0, x0), x86_i64_mul_odd(vb1, x1)),
+                                         x86_i64_mul_odd(vb2, x2)));
+    }
+
+    for (; n < len; n++)
+    {
+      ff[n] = (q63_t) b0 * x[n + 2u];
+      ff[n] += (q63_t) b1 * x[n + 1u];
+      ff[n] += (q63_t) b2 * x[n];
+    }
+
+    if (numStages == 2u)
+    {
+      for (n = 0u; n < len; n++)
+      {
+        acc = ff[n];
+        acc += (q63_t) a1 * Yn1;
+        acc += (q63_t) a2 * Yn2;
+        acc = acc >> lShift;
+        Yn2 = Yn1;
+        Yn1 = (q31_t) acc;
+
+        acc2 = (q63_t) c0 * Yn1;
+        acc2 += (q63_t) c1 * Xm1;
+        acc2 += (q63_t) c2 * Xm2;
+        acc2 += (q63_t) d1 * Ym1;
+        acc2 += (q63_t) d2 * Ym2;
+        acc2 = acc2 >> lShift;
+        *pOut++ = (q31_t) acc2;
+        Xm2 = Xm1;
+        Xm1 = Yn1;
+        Ym2 = Ym1;
+        Ym1 = (q31_t) acc2;
+      }
+    }
+    else
+    {
+      for (n = 0u; n < len; n++)
+      {
+        acc = ff[n];
+        acc += (q63_t) a1 * Yn1;
+        acc += (q63_t) a2 * Yn2;
+        acc = acc >> lShift;
+        Yn2 = Yn1;
+        Yn1 = (q31_t) acc;
+        *pOut++ = (q31_t) acc;
+      }
+    }
+
+    x[0] = x[len];
+    x[1] = x[len + 1u];
+    sample -= len;
+  }
+
+  pState[0] = x[1];
+  pState[1] = x[0];
+  pState[2] = Yn1;
+  pState[3] = Yn2;
+
+  if (numStages == 2u)
+  {
+    pState[4] = Xm1;
+    pState[5] = Xm2;
+    pState[6] = Ym1;
+    pState[7] = Ym2;
+  }
+}
+
+void arm_biquad_cascade_df1_q31(
+  const arm_biquad_casd_df1_inst_q31 * S,
+  q31_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  q31_t *pIn = pSrc;                             /*  source pointer            */
+  q31_t *pState = S->pState;                     /*  pState pointer            */
+  q31_t *pCoeffs = S->pCoeffs;                   /*  coefficient pointer       */
+  uint32_t stage = S->numStages;                 /*  loop counter              */
+  uint32_t numStages;                            /*  Stages of the pass        */
+
+  do
+  {
+    numStages = (stage >= 2u) ? 2u : 1u;
+
+    arm_biquad_stages_q31(S, pCoeffs, pState, pIn, pDst, blockSize, numStages);
+
+    /* The stages after the first ones run in place */
+    pCoeffs += 5u * numStages;
+    pState += 4u * numStages;
+    pIn = pDst;
+    stage -= numStages;
+
+  } while (stage > 0u);
+}
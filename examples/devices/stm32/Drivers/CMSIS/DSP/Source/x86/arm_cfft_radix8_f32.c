@@ -0,0 +1,412 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_cfft_radix8_f32.c
+ * Description:  Radix-8 Decimation in Frequency CFFT & CIFFT Floating point processing function, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of TransformFunctions/arm_cfft_radix8_f32.c, see arm_x86_utils.h.
+ * The butterflies of a stage are independent: the lanes compute X86_LANES of
+ * them with the operations of the C version, in the same order
+ */
+
+/* Lane 0 set: the butterflies of j = 0, which the C version does not rotate */
+static const union
+{
+   uint32_t u[X86_LANES];
+   float32_t f[X86_LANES];
+} FirstLane = { { 0xFFFFFFFFu } };
+
+/*
+* @brief  Radix-8 butterfly of the X86_LANES butterflies of the lanes, without
+*         the twiddle factors: the outputs of the j = 0 butterflies of the C
+*         version, and the values the other ones rotate.
+* @param[in, out] re  real parts of the 8 points
+* @param[in, out] im  imaginary parts of the 8 points
+* @return none.
+*/
+static __inline void arm_radix8_x86(x86_f32_t * re, x86_f32_t * im)
+{
+   const x86_f32_t C81 = x86_f32_set1(0.70710678118f);
+   x86_f32_t r1, r2, r3, r4, r5, r6, r7, r8;
+   x86_f32_t s1, s2, s3, s4, s5, s6, s7, s8;
+   x86_f32_t t1, t2;
+
+   r1 = x86_f32_add(re[0], re[4]);
+   r5 = x86_f32_sub(re[0], re[4]);
+   r2 = x86_f32_add(re[1], re[5]);
+   r6 = x86_f32_sub(re[1], re[5]);
+   r3 = x86_f32_add(re[2], re[6]);
+   r7 = x86_f32_sub(re[2], re[6]);
+   r4 = x86_f32_add(re[3], re[7]);
+   r8 = x86_f32_sub(re[3], re[7]);
+   t1 = x86_f32_sub(r1, r3);
+   r1 = x86_f32_add(r1, r3);
+   r3 = x86_f32_sub(r2, r4);
+   r2 = x86_f32_add(r2, r4);
+   re[0] = x86_f32_add(r1, r2);
+   re[4] = x86_f32_sub(r1, r2);
+
+   s1 = x86_f32_add(im[0], im[4]);
+   s5 = x86_f32_sub(im[0], im[4]);
+   s2 = x86_f32_add(im[1], im[5]);
+   s6 = x86_f32_sub(im[1], im[5]);
+   s3 = x86_f32_add(im[2], im[6]);
+   s7 = x86_f32_sub(im[2], im[6]);
+   s4 = x86_f32_add(im[3], im[7]);
+   s8 = x86_f32_sub(im[3], im[7]);
+   t2 = x86_f32_sub(s1, s3);
+   s1 = x86_f32_add(s1, s3);
+   s3 = x86_f32_sub(s2, s4);
+   s2 = x86_f32_add(s2, s4);
+   im[0] = x86_f32_add(s1, s2);
+   im[4] = x86_f32_sub(s1, s2);
+
+   re[2] = x86_f32_add(t1, s3);
+   re[6] = x86_f32_sub(t1, s3);
+   im[2] = x86_f32_sub(t2, r3);
+   im[6] = x86_f32_add(t2, r3);
+
+   r1 = x86_f32_mul(x86_f32_sub(r6, r8), C81);
+   r6 = x86_f32_mul(x86_f32_add(r6, r8), C81);
+   s1 = x86_f32_mul(x86_f32_sub(s6, s8), C81);
+   s6 = x86_f32_mul(x86_f32_add(s6, s8), C81);
+   t1 = x86_f32_sub(r5, r1);
+   r5 = x86_f32_add(r5, r1);
+   r8 = x86_f32_sub(r7, r6);
+   r7 = x86_f32_add(r7, r6);
+   t2 = x86_f32_sub(s5, s1);
+   s5 = x86_f32_add(s5, s1);
+   s8 = x86_f32_sub(s7, s6);
+   s7 = x86_f32_add(s7, s6);
+   re[1] = x86_f32_add(r5, s7);
+   re[7] = x86_f32_sub(r5, s7);
+   re[5] = x86_f32_add(t1, s8);
+   re[3] = x86_f32_sub(t1, s8);
+   im[1] = x86_f32_sub(s5, r7);
+   im[7] = x86_f32_add(s5, r7);
+   im[5] = x86_f32_sub(t2, r8);
+   im[3] = x86_f32_add(t2, r8);
+}
+
+/*
+* @brief  One butterfly of the C version, rotated by the twiddle factors co
+*         and si of the points 1 to 7, or not rotated when co is NULL.
+* @param[in, out] pSrc  points to the in-place buffer.
+* @param[in]      i1    index of the first point.
+* @param[in]      n2    distance between the points.
+* @return none.
+*/
+static void arm_radix8_c(
+float32_t * pSrc,
+uint32_t i1,
+uint32_t n2,
+const float32_t * co,
+const float32_t * si)
+{
+   const float32_t C81 = 0.70710678118f;
+   float32_t re[8], im[8];
+   float32_t r1, r2, r3, r4, r5, r6, r7, r8;
+   float32_t s1, s2, s3, s4, s5, s6, s7, s8;
+   float32_t t1, t2, p1, p2, p3, p4;
+   uint32_t k;
+
+   for (k = 0u; k < 8u; k++)
+   {
+      re[k] = pSrc[2u * (i1 + k * n2)];
+      im[k] = pSrc[2u * (i1 + k * n2) + 1u];
+   }
+
+   r1 = re[0] + re[4];
+   r5 = re[0] - re[4];
+   r2 = re[1] + re[5];
+   r6 = re[1] - re[5];
+   r3 = re[2] + re[6];
+   r7 = re[2] - re[6];
+   r4 = re[3] + re[7];
+   r8 = re[3] - re[7];
+   t1 = r1 - r3;
+   r1 = r1 + r3;
+   r3 = r2 - r4;
+   r2 = r2 + r4;
+   re[0] = r1 + r2;
+   re[4] = r1 - r2;
+
+   s1 = im[0] + im[4];
+   s5 = im[0] - im[4];
+   s2 = im[1] + im[5];
+   s6 = im[1] - im[5];
+   s3 = im[2] + im[6];
+   s7 = im[2] - im[6];
+   s4 = im[3] + im[7];
+   s8 = im[3] - im[7];
+   t2 = s1 - s3;
+   s1 = s1 + s3;
+   s3 = s2 - s4;
+   s2 = s2 + s4;
+   im[0] = s1 + s2;
+   im[4] = s1 - s2;
+
+   re[2] = t1 + s3;
+   re[6] = t1 - s3;
+   im[2] = t2 - r3;
+   im[6] = t2 + r3;
+
+   r1 = (r6 - r8) * C81;
+   r6 = (r6 + r8) * C81;
+   s1 = (s6 - s8) * C81;
+   s6 = (s6 + s8) * C81;
+   t1 = r5 - r1;
+   r5 = r5 + r1;
+   r8 = r7 - r6;
+   r7 = r7 + r6;
+   t2 = s5 - s1;
+   s5 = s5 + s1;
+   s8 = s7 - s6;
+   s7 = s7 + s6;
+   re[1] = r5 + s7;
+   re[7] = r5 - s7;
+   re[5] = t1 + s8;
+   re[3] = t1 - s8;
+   im[1] = s5 - r7;
+   im[7] = s5 + r7;
+   im[5] = t2 - r8;
+   im[3] = t2 + r8;
+
+   for (k = 0u; k < 8u; k++)
+   {
+      if ((k > 0u) && (co != NULL))
+      {
+         p1 = co[k] * re[k];
+         p2 = si[k] * im[k];
+         p3 = co[k] * im[k];
+         p4 = si[k] * re[k];
+         re[k] = p1 + p2;
+         im[k] = p3 - p4;
+      }
+      pSrc[2u * (i1 + k * n2)] = re[k];
+      pSrc[2u * (i1 + k * n2) + 1u] = im[k];
+   }
+}
+
+/* Stage of the C version, for the distances the lanes do not divide */
+static void arm_radix8_stage_c(
+float32_t * pSrc,
+uint32_t fftLen,
+uint32_t n1,
+uint32_t n2,
+const float32_t * pCoef,
+uint32_t twidCoefModifier)
+{
+   float32_t co[8], si[8];
+   uint32_t i1, j, k, id;
+
+   for (i1 = 0u; i1 < fftLen; i1 += n1)
+   {
+      arm_radix8_c(pSrc, i1, n2, NULL, NULL);
+   }
+
+   if (n2 < 8u)
+      return;
+
+   for (j = 1u; j < n2; j++)
+   {
+      for (k = 1u; k < 8u; k++)
+      {
+         id = k * j * twidCoefModifier;
+         co[k] = pCoef[2u * id];
+         si[k] = pCoef[2u * id + 1u];
+      }
+
+      for (i1 = j; i1 < fftLen; i1 += n1)
+      {
+         arm_radix8_c(pSrc, i1, n2, co, si);
+      }
+   }
+}
+
+/*
+* Stage whose distance n2 the lanes divide: the lanes hold the butterflies
+* j to j + X86_LANES - 1, whose points are consecutive.
+*/
+static void arm_radix8_stage_x86(
+float32_t * pSrc,
+uint32_t fftLen,
+uint32_t n1,
+uint32_t n2,
+const float32_t * pCoef,
+uint32_t twidCoefModifier)
+{
+   float32_t co[X86_LANES], si[X86_LANES];
+   x86_f32_t re[8], im[8], vco[8], vsi[8], r, i, first;
+   uint32_t i1, j, k, l, id;
+
+   for (j = 0u; j < n2; j += X86_LANES)
+   {
+      for (k = 1u; k < 8u; k++)
+      {
+         for (l = 0u; l < X86_LANES; l++)
+         {
+            id = k * (j + l) * twidCoefModifier;
+            co[l] = pCoef[2u * id];
+            si[l] = pCoef[2u * id + 1u];
+         }
+         vco[k] = x86_f32_load(co);
+         vsi[k] = x86_f32_load(si);
+      }
+
+      first = (j == 0u) ? x86_f32_load(FirstLane.f) : x86_f32_zero();
+
+      for (i1 = j; i1 < fftLen; i1 += n1)
+      {
+         for (k = 0u; k < 8u; k++)
+         {
+            x86_cf32_load(&pSrc[2u * (i1 + k * n2)], &re[k], &im[k]);
+         }
+
+         arm_radix8_x86(re, im);
+
+         for (k = 1u; k < 8u; k++)
+         {
+            r = x86_f32_add(x86_f32_mul(vco[k], re[k]), x86_f32_mul(vsi[k], im[k]));
+            i = x86_f32_sub(x86_f32_mul(vco[k], im[k]), x86_f32_mul(vsi[k], re[k]));
+            re[k] = x86_f32_select(first, re[k], r);
+            im[k] = x86_f32_select(first, im[k], i);
+         }
+
+         for (k = 0u; k < 8u; k++)
+         {
+            x86_cf32_store(&pSrc[2u * (i1 + k * n2)], re[k], im[k]);
+         }
+      }
+   }
+}
+
+/*
+* Last stage, n2 = 1: the 8 points of a butterfly are consecutive, the
+* X86_LANES butterflies are transposed to a butterfly per lane.
+*/
+static void arm_radix8_last_x86(
+float32_t * pSrc,
+uint32_t fftLen)
+{
+   x86_f32_t v[X86_LANES], col[16], re[8], im[8];
+   float32_t *p;
+   uint32_t i1, c, k, l;
+
+   for (i1 = 0u; i1 + 8u * X86_LANES <= fftLen; i1 += 8u * X86_LANES)
+   {
+      p = &pSrc[2u * i1];
+
+      for (c = 0u; c < 16u / X86_LANES; c++)
+      {
+         for (l = 0u; l < X86_LANES; l++)
+         {
+            v[l] = x86_f32_load(p + 16u * l + c * X86_LANES);
+         }
+         x86_f32_transpose(v);
+         for (l = 0u; l < X86_LANES; l++)
+         {
+            col[c * X86_LANES + l] = v[l];
+         }
+      }
+
+      for (k = 0u; k < 8u; k++)
+      {
+         re[k] = col[2u * k];
+         im[k] = col[2u * k + 1u];
+      }
+
+      arm_radix8_x86(re, im);
+
+      for (k = 0u; k < 8u; k++)
+      {
+         col[2u * k] = re[k];
+         col[2u * k + 1u] = im[k];
+      }
+
+      for (c = 0u; c < 16u / X86_LANES; c++)
+      {
+         for (l = 0u; l < X86_LANES; l++)
+         {
+            v[l] = col[c * X86_LANES + l];
+         }
+         x86_f32_transpose(v);
+         for (l = 0u; l < X86_LANES; l++)
+         {
+            x86_f32_store(p + 16u * l + c * X86_LANES, v[l]);
+         }
+      }
+   }
+
+   for (; i1 < fftLen; i1 += 8u)
+   {
+      arm_radix8_c(pSrc, i1, 1u, NULL, NULL);
+   }
+}
+
+/*
+* @brief  Core function for the floating-point CFFT butterfly process.
+* @param[in, out] *pSrc            points to the in-place buffer of floating-point data type.
+* @param[in]      fftLen           length of the FFT.
+* @param[in]      *pCoef           points to the twiddle coefficient buffer.
+* @param[in]      twidCoefModifier twiddle coefficient modifier that supports different size FFTs with the same twiddle factor table.
+* @return none.
+*/
+
+void arm_radix8_butterfly_f32(
+float32_t * pSrc,
+uint16_t fftLen,
+const float32_t * pCoef,
+uint16_t twidCoefModifier)
+{
+   uint32_t n1, n2;
+   uint32_t modifier = twidCoefModifier;
+
+   n2 = fftLen;
+
+   do
+   {
+      n1 = n2;
+      n2 = n2 >> 3;
+
+      if ((n2 >= 8u) && ((n2 % X86_LANES) == 0u))
+      {
+         arm_radix8_stage_x86(pSrc, fftLen, n1, n2, pCoef, modifier);
+      }
+      else if (n2 == 1u)
+      {
+         arm_radix8_last_x86(pSrc, fftLen);
+      }
+      else
+      {
+         arm_radix8_stage_c(pSrc, fftLen, n1, n2, pCoef, modifier);
+      }
+
+      modifier <<= 3;
+   } while (n2 > 7u);
+}
@@ -0,0 +1,70 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_dot_prod_f32.c
+ * Description:  Floating-point dot product, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of BasicMathFunctions/arm_dot_prod_f32.c, see arm_x86_utils.h.
+ * The sum is split across the lanes: not the same rounding as the C version
+ */
+
+void arm_dot_prod_f32(
+  float32_t * pSrcA,
+  float32_t * pSrcB,
+  uint32_t blockSize,
+  float32_t * result)
+{
+  x86_f32_t acc = x86_f32_zero();                /* Lane accumulators */
+  float32_t sum;                                 /* Temporary result storage */
+  uint32_t blkCnt;                               /* loop counter */
+
+  /* X86_LANES products at a time, one partial sum per lane */
+  blkCnt = blockSize / X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    acc = x86_f32_add(acc, x86_f32_mul(x86_f32_load(pSrcA), x86_f32_load(pSrcB)));
+    pSrcA += X86_LANES;
+    pSrcB += X86_LANES;
+
+    blkCnt--;
+  }
+
+  sum = x86_f32_hsum(acc);
+
+  blkCnt = blockSize % X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    sum += (*pSrcA++) * (*pSrcB++);
+
+    blkCnt--;
+  }
+
+  *result = sum;
+}
@@ -0,0 +1,73 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_dot_prod_q15.c
+ * Description:  Q15 dot product, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of BasicMathFunctions/arm_dot_prod_q15.c, see arm_x86_utils.h.
+ */
+
+void arm_dot_prod_q15(
+  q15_t * pSrcA,
+  q15_t * pSrcB,
+  uint32_t blockSize,
+  q63_t * result)
+{
+  x86_i64_t acc = x86_i64_zero();                /* Lane accumulators */
+  x86_i32_t a, b;
+  q63_t sum;                                     /* Temporary result storage */
+  uint32_t blkCnt;                               /* loop counter */
+
+  blkCnt = blockSize / X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    a = x86_q15_load(pSrcA);
+    b = x86_q15_load(pSrcB);
+
+    acc = x86_i64_add(acc, x86_i64_mul_even(a, b));
+    acc = x86_i64_add(acc, x86_i64_mul_odd(a, b));
+    pSrcA += X86_LANES;
+    pSrcB += X86_LANES;
+
+    blkCnt--;
+  }
+
+  sum = x86_i64_hsum(acc);
+
+  blkCnt = blockSize % X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    sum += (q63_t) ((q31_t) * pSrcA++ * *pSrcB++);
+
+    blkCnt--;
+  }
+
+  *result = sum;
+}
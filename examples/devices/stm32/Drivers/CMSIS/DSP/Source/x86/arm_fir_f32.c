@@ -0,0 +1,114 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_fir_f32.c
+ * Description:  Floating-point FIR filter processing function, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of FilteringFunctions/arm_fir_f32.c, see arm_x86_utils.h.
+ * The lanes compute X86_LANES consecutive outputs, each summing its taps in
+ * the order of the C version
+ */
+
+void arm_fir_f32(
+const arm_fir_instance_f32 * S,
+float32_t * pSrc,
+float32_t * pDst,
+uint32_t blockSize)
+{
+   float32_t *pState = S->pState;                 /* State pointer */
+   float32_t *pCoeffs = S->pCoeffs;               /* Coefficient pointer */
+   float32_t *px;                                 /* Temporary pointer for state buffer */
+   uint32_t numTaps = S->numTaps;                 /* Number of filter coefficients in the filter */
+   uint32_t i, blkCnt;                            /* Loop counters */
+   x86_f32_t acc0, acc1, c;                       /* Accumulators of two blocks of outputs */
+   float32_t acc;
+
+   /* The new samples go after the numTaps - 1 samples of the previous frame */
+   memcpy(&(S->pState[(numTaps - 1u)]), pSrc, blockSize * sizeof(float32_t));
+
+   /* 2 * X86_LANES outputs at a time, the two sums hide the latency of the adds */
+   blkCnt = blockSize / (2u * X86_LANES);
+
+   while (blkCnt > 0u)
+   {
+      acc0 = x86_f32_zero();
+      acc1 = x86_f32_zero();
+      px = pState;
+
+      for (i = 0u; i < numTaps; i++)
+      {
+         c = x86_f32_set1(pCoeffs[i]);
+         acc0 = x86_f32_add(acc0, x86_f32_mul(x86_f32_load(px), c));
+         acc1 = x86_f32_add(acc1, x86_f32_mul(x86_f32_load(px + X86_LANES), c));
+         px++;
+      }
+
+      x86_f32_store(pDst, acc0);
+      x86_f32_store(pDst + X86_LANES, acc1);
+      pDst += 2u * X86_LANES;
+      pState += 2u * X86_LANES;
+
+      blkCnt--;
+   }
+
+   blkCnt = blockSize % (2u * X86_LANES);
+
+   if (blkCnt >= X86_LANES)
+   {
+      acc0 = x86_f32_zero();
+      px = pState;
+
+      for (i = 0u; i < numTaps; i++)
+      {
+         acc0 = x86_f32_add(acc0, x86_f32_mul(x86_f32_load(px++), x86_f32_set1(pCoeffs[i])));
+      }
+
+      x86_f32_store(pDst, acc0);
+      pDst += X86_LANES;
+      pState += X86_LANES;
+      blkCnt -= X86_LANES;
+   }
+
+   while (blkCnt > 0u)
+   {
+      acc = 0.0f;
+      px = pState;
+
+      for (i = 0u; i < numTaps; i++)
+      {
+         acc += *px++ * pCoeffs[i];
+      }
+
+      *pDst++ = acc;
+      pState = pState + 1;
+      blkCnt--;
+   }
+
+   /* Copy the last numTaps - 1 samples to the start of the state buffer */
+   memmove(S->pState, pState, (numTaps - 1u) * sizeof(float32_t));
+}
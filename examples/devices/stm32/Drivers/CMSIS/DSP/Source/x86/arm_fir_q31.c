@@ -0,0 +1,98 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_fir_q31.c
+ * Description:  Q31 FIR filter processing function, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of FilteringFunctions/arm_fir_q31.c, see arm_x86_utils.h.
+ * The lanes compute X86_LANES consecutive outputs, each summing its taps in
+ * the order of the C version
+ */
+
+void arm_fir_q31(
+  const arm_fir_instance_q31 * S,
+  q31_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  q31_t *pState = S->pState;                     /* State pointer */
+  q31_t *pCoeffs = S->pCoeffs;                   /* Coefficient pointer */
+  q31_t *px;                                     /* Temporary pointer for state buffer */
+  q63_t acc;                                     /* Accumulator */
+  x86_i64_t accEven, accOdd;                     /* Accumulators of the even and odd outputs */
+  x86_i32_t x, c;
+  uint32_t numTaps = S->numTaps;                 /* Number of taps in the filter */
+  uint32_t i, blkCnt;                            /* Loop counters */
+
+  /* The new samples go after the numTaps - 1 samples of the previous frame */
+  memcpy(&(S->pState[(numTaps - 1u)]), pSrc, blockSize * sizeof(q31_t));
+
+  blkCnt = blockSize / X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    accEven = x86_i64_zero();
+    accOdd = x86_i64_zero();
+    px = pState;
+
+    for (i = 0u; i < numTaps; i++)
+    {
+      x = x86_q31_load(px++);
+      c = x86_i32_set1(pCoeffs[i]);
+      accEven = x86_i64_add(accEven, x86_i64_mul_even(x, c));
+      accOdd = x86_i64_add(accOdd, x86_i64_mul_odd(x, c));
+    }
+
+    /* 2.62 to 1.31 */
+    x86_q31_store(pDst, x86_i32_narrow(accEven, accOdd, 31));
+    pDst += X86_LANES;
+    pState += X86_LANES;
+
+    blkCnt--;
+  }
+
+  blkCnt = blockSize % X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    acc = 0;
+    px = pState;
+
+    for (i = 0u; i < numTaps; i++)
+    {
+      acc += (q63_t) * px++ * pCoeffs[i];
+    }
+
+    *pDst++ = (q31_t) (acc >> 31u);
+    pState = pState + 1;
+    blkCnt--;
+  }
+
+  /* Copy the last numTaps - 1 samples to the start of the state buffer */
+  memmove(S->pState, pState, (numTaps - 1u) * sizeof(q31_t));
+}
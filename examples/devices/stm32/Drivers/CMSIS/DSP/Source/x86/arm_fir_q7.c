@@ -0,0 +1,96 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_fir_q7.c
+ * Description:  Q7 FIR filter processing function, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of FilteringFunctions/arm_fir_q7.c, see arm_x86_utils.h.
+ * The lanes compute X86_LANES consecutive outputs, each summing its taps in
+ * the order of the C version
+ */
+
+void arm_fir_q7(
+  const arm_fir_instance_q7 * S,
+  q7_t * pSrc,
+  q7_t * pDst,
+  uint32_t blockSize)
+{
+  q7_t *pState = S->pState;                     /* State pointer */
+  q7_t *pCoeffs = S->pCoeffs;                   /* Coefficient pointer */
+  q7_t *px;                                     /* Temporary pointer for state buffer */
+  q31_t acc;                                     /* Accumulator */
+  x86_i32_t accLanes;                               /* Accumulators of the outputs */
+  x86_i32_t x, c;
+  uint32_t numTaps = S->numTaps;                 /* Number of taps in the filter */
+  uint32_t i, blkCnt;                            /* Loop counters */
+
+  /* The new samples go after the numTaps - 1 samples of the previous frame */
+  memcpy(&(S->pState[(numTaps - 1u)]), pSrc, blockSize * sizeof(q7_t));
+
+  blkCnt = blockSize / X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    accLanes = x86_i32_zero();
+    px = pState;
+
+    for (i = 0u; i < numTaps; i++)
+    {
+      x = x86_q7_load(px++);
+      c = x86_i32_set1(pCoeffs[i]);
+      accLanes = x86_i32_add(accLanes, x86_i32_mul(x, c));
+    }
+
+    /* 2.14 to 1.7, saturated */
+    x86_q7_store_sat(pDst, x86_i32_sra(accLanes, 7));
+    pDst += X86_LANES;
+    pState += X86_LANES;
+
+    blkCnt--;
+  }
+
+  blkCnt = blockSize % X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    acc = 0;
+    px = pState;
+
+    for (i = 0u; i < numTaps; i++)
+    {
+      acc += (q15_t) * px++ * pCoeffs[i];
+    }
+
+    *pDst++ = (q7_t) __SSAT((acc >> 7), 8);
+    pState = pState + 1;
+    blkCnt--;
+  }
+
+  /* Copy the last numTaps - 1 samples to the start of the state buffer */
+  memmove(S->pState, pState, (numTaps - 1u) * sizeof(q7_t));
+}
@@ -0,0 +1,81 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_min_f32.c
+ * Description:  Minimum value of a floating-point vector, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of StatisticsFunctions/arm_min_f32.c, see arm_x86_utils.h.
+ * The lanes find the value, a scan then finds the first sample holding it,
+ * the index the C version reports
+ */
+
+void arm_min_f32(
+  float32_t * pSrc,
+  uint32_t blockSize,
+  float32_t * pResult,
+  uint32_t * pIndex)
+{
+  x86_f32_t acc;                                 /* Lane minima */
+  float32_t out;                                     /* Temporary variables to store the output value. */
+  uint32_t i, outIndex;                          /* loop counter */
+
+  /* Smallest value */
+  out = pSrc[0];
+  i = 1u;
+
+  if (blockSize >= X86_LANES)
+  {
+    acc = x86_f32_load(pSrc);
+
+    for (i = X86_LANES; i + X86_LANES <= blockSize; i += X86_LANES)
+    {
+      acc = x86_f32_min(acc, x86_f32_load(pSrc + i));
+    }
+
+    out = x86_f32_hmin(acc);
+  }
+
+  for (; i < blockSize; i++)
+  {
+    if (pSrc[i] < out)
+    {
+      out = pSrc[i];
+    }
+  }
+
+  /* First sample holding it */
+  outIndex = 0u;
+
+  while ((outIndex < blockSize - 1u) && (pSrc[outIndex] != out))
+  {
+    outIndex++;
+  }
+
+  *pResult = pSrc[outIndex];
+  *pIndex = outIndex;
+}
@@ -0,0 +1,106 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_var_f32.c
+ * Description:  Variance of the elements of a floating-point vector, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of StatisticsFunctions/arm_var_f32.c, see arm_x86_utils.h.
+ * The sums are split across the lanes: not the same rounding as the C version
+ */
+
+void arm_var_f32(
+                 float32_t * pSrc,
+                 uint32_t blockSize,
+                 float32_t * pResult)
+{
+    x86_f32_t acc, in, vMean;   /* Lane accumulators */
+    float32_t fMean, fValue;
+    uint32_t blkCnt;            /* loop counter */
+    float32_t * pInput = pSrc;
+    float32_t sum;
+    float32_t fSum;
+
+    if (blockSize <= 1u)
+    {
+        *pResult = 0;
+        return;
+    }
+
+    /* Mean */
+    acc = x86_f32_zero();
+    blkCnt = blockSize / X86_LANES;
+
+    while (blkCnt > 0u)
+    {
+        acc = x86_f32_add(acc, x86_f32_load(pInput));
+        pInput += X86_LANES;
+
+        blkCnt--;
+    }
+
+    sum = x86_f32_hsum(acc);
+    blkCnt = blockSize % X86_LANES;
+
+    while (blkCnt > 0u)
+    {
+        sum += *pInput++;
+
+        blkCnt--;
+    }
+
+    fMean = sum / (float32_t) blockSize;
+
+    /* Squares of the deviations */
+    pInput = pSrc;
+    vMean = x86_f32_set1(fMean);
+    acc = x86_f32_zero();
+    blkCnt = blockSize / X86_LANES;
+
+    while (blkCnt > 0u)
+    {
+        in = x86_f32_sub(x86_f32_load(pInput), vMean);
+        acc = x86_f32_add(acc, x86_f32_mul(in, in));
+        pInput += X86_LANES;
+
+        blkCnt--;
+    }
+
+    fSum = x86_f32_hsum(acc);
+    blkCnt = blockSize % X86_LANES;
+
+    while (blkCnt > 0u)
+    {
+        fValue = *pInput++ - fMean;
+        fSum += fValue * fValue;
+
+        blkCnt--;
+    }
+
+    /* Variance */
+    *pResult = fSum / (float32_t)(blockSize - 1.0f);
+}
@@ -0,0 +1,92 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_var_q31.c
+ * Description:  Variance of an array of Q31 type, x86 version
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arm_x86_utils.h"
+
+/*
+ * x86 version of StatisticsFunctions/arm_var_q31.c, see arm_x86_utils.h.
+ */
+
+void arm_var_q31(
+  q31_t * pSrc,
+  uint32_t blockSize,
+  q31_t * pResult)
+{
+  x86_i64_t accSum, accSquares;                  /* Lane accumulators */
+  x86_i32_t vin;
+  q63_t sum;                                     /* Accumulator */
+  q63_t meanOfSquares, squareOfMean;             /* square of mean and mean of square */
+  q31_t in;                                      /* input value */
+  uint32_t blkCnt;                               /* loop counter */
+  q63_t sumOfSquares;                            /* Accumulator */
+
+  if (blockSize == 1u)
+  {
+    *pResult = 0;
+    return;
+  }
+
+  accSum = x86_i64_zero();
+  accSquares = x86_i64_zero();
+  blkCnt = blockSize / X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    /* 1.31 to 9.23, as the C version */
+    vin = x86_i32_sra(x86_q31_load(pSrc), 8);
+    accSum = x86_i64_add(accSum, x86_i64_add(x86_i64_widen_lo(vin), x86_i64_widen_hi(vin)));
+    accSquares = x86_i64_add(accSquares, x86_i64_mul_even(vin, vin));
+    accSquares = x86_i64_add(accSquares, x86_i64_mul_odd(vin, vin));
+    pSrc += X86_LANES;
+
+    blkCnt--;
+  }
+
+  sum = x86_i64_hsum(accSum);
+  sumOfSquares = x86_i64_hsum(accSquares);
+  blkCnt = blockSize % X86_LANES;
+
+  while (blkCnt > 0u)
+  {
+    in = *pSrc++ >> 8u;
+    sum += in;
+    sumOfSquares += ((q63_t) (in) * (in));
+
+    blkCnt--;
+  }
+
+  /* Compute Mean of squares of the input samples
+   * and then store the result in a temporary variable, meanOfSquares. */
+  meanOfSquares = sumOfSquares / (q63_t)(blockSize - 1u);
+
+  /* Compute square of mean */
+  squareOfMean = sum * sum / (q63_t)(blockSize * (blockSize - 1u));
+
+  /* Compute standard deviation and then store the result to the destination */
+  *pResult = (meanOfSquares - squareOfMean) >> 15u;
+}
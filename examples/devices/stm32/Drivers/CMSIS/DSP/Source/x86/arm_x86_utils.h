@@ -0,0 +1,484 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_x86_utils.h
+ * Description:  Vector helpers of the x86 kernels, over SSE4.1 or AVX2
+ *
+ * $Date:        27. January 2017
+ * $Revision:    V.1.5.1
+ *
+ * Target Processor: x86-64 hosts
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2017 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The files of this directory replace the C files of the same name for the
+ * host build of Tests/. They give the results of the Cortex-M0 paths of the
+ * C files: the same integer results, and for floating point the same
+ * operations in the same order, except for the sums over a whole block
+ * (dot product, mean, power, variance) which are split across the lanes.
+ *
+ * A vector holds X86_LANES 32-bit lanes, q7 and q15 samples are widened to
+ * 32 bits on load. 64-bit accumulators hold the products of the even lanes
+ * and of the odd lanes of a vector in two vectors of X86_LANES / 2 lanes.
+ */
+
+#ifndef _ARM_X86_UTILS_H
+#define _ARM_X86_UTILS_H
+
+#include <string.h>
+#include "arm_math.h"
+
+#if defined (__AVX2__)
+
+#include <immintrin.h>
+
+#define X86_LANES 8
+
+typedef __m256  x86_f32_t;
+typedef __m256i x86_i32_t;
+typedef __m256i x86_i64_t;
+
+#elif defined (__SSE4_1__)
+
+#include <smmintrin.h>
+
+#define X86_LANES 4
+
+typedef __m128  x86_f32_t;
+typedef __m128i x86_i32_t;
+typedef __m128i x86_i64_t;
+
+#else
+#error "the x86 kernels need SSE4.1 or AVX2, build them with -msse4.1 or -mavx2"
+#endif
+
+#if defined (__AVX2__)
+
+/* ---------------------------- AVX2 ---------------------------- */
+
+static __inline x86_f32_t x86_f32_load(const float32_t * p)    { return _mm256_loadu_ps(p); }
+static __inline void x86_f32_store(float32_t * p, x86_f32_t a) { _mm256_storeu_ps(p, a); }
+static __inline x86_f32_t x86_f32_set1(float32_t a)            { return _mm256_set1_ps(a); }
+static __inline x86_f32_t x86_f32_zero(void)                   { return _mm256_setzero_ps(); }
+static __inline x86_f32_t x86_f32_add(x86_f32_t a, x86_f32_t b) { return _mm256_add_ps(a, b); }
+static __inline x86_f32_t x86_f32_sub(x86_f32_t a, x86_f32_t b) { return _mm256_sub_ps(a, b); }
+static __inline x86_f32_t x86_f32_mul(x86_f32_t a, x86_f32_t b) { return _mm256_mul_ps(a, b); }
+static __inline x86_f32_t x86_f32_min(x86_f32_t a, x86_f32_t b) { return _mm256_min_ps(a, b); }
+static __inline x86_f32_t x86_f32_max(x86_f32_t a, x86_f32_t b) { return _mm256_max_ps(a, b); }
+
+/* a where the lane of mask is set, b elsewhere */
+static __inline x86_f32_t x86_f32_select(x86_f32_t mask, x86_f32_t a, x86_f32_t b)
+{
+  return _mm256_blendv_ps(b, a, mask);
+}
+
+/* Loads X86_LANES complex values, as their real parts and imaginary parts */
+static __inline void x86_cf32_load(const float32_t * p, x86_f32_t * re, x86_f32_t * im)
+{
+  __m256 a = _mm256_loadu_ps(p);
+  __m256 b = _mm256_loadu_ps(p + 8);
+  __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  __m256 i = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+  /* the shuffles work in 128-bit halves: 0 1 4 5 2 3 6 7 back in order */
+  *re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), 0xD8));
+  *im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(i), 0xD8));
+}
+
+static __inline void x86_cf32_store(float32_t * p, x86_f32_t re, x86_f32_t im)
+{
+  __m256 lo = _mm256_unpacklo_ps(re, im);
+  __m256 hi = _mm256_unpackhi_ps(re, im);
+
+  _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+  _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+/* Transposes X86_LANES vectors of X86_LANES lanes */
+static __inline void x86_f32_transpose(x86_f32_t * v)
+{
+  __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+  __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+  __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+  __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+  __m256 t4 = _mm256_unpacklo_ps(v[4], v[5]);
+  __m256 t5 = _mm256_unpackhi_ps(v[4], v[5]);
+  __m256 t6 = _mm256_unpacklo_ps(v[6], v[7]);
+  __m256 t7 = _mm256_unpackhi_ps(v[6], v[7]);
+  __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+  v[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+  v[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+  v[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+  v[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+  v[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+  v[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+  v[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+  v[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+static __inline x86_i32_t x86_q31_load(const q31_t * p)
+{
+  return _mm256_loadu_si256((const __m256i *) p);
+}
+
+static __inline x86_i32_t x86_q15_load(const q15_t * p)
+{
+  return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) p));
+}
+
+static __inline x86_i32_t x86_q7_load(const q7_t * p)
+{
+  return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) p));
+}
+
+static __inline void x86_q31_store(q31_t * p, x86_i32_t a)
+{
+  _mm256_storeu_si256((__m256i *) p, a);
+}
+
+/* Stores the lanes saturated to 16 bits, as __SSAT(x, 16) */
+static __inline void x86_q15_store_sat(q15_t * p, x86_i32_t a)
+{
+  __m128i s = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+
+  _mm_storeu_si128((__m128i *) p, s);
+}
+
+/* Stores the lanes saturated to 8 bits, as __SSAT(x, 8) */
+static __inline void x86_q7_store_sat(q7_t * p, x86_i32_t a)
+{
+  __m128i s = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+
+  _mm_storel_epi64((__m128i *) p, _mm_packs_epi16(s, s));
+}
+
+static __inline x86_i32_t x86_i32_set1(int32_t a)                { return _mm256_set1_epi32(a); }
+static __inline x86_i32_t x86_i32_zero(void)                     { return _mm256_setzero_si256(); }
+static __inline x86_i32_t x86_i32_add(x86_i32_t a, x86_i32_t b)  { return _mm256_add_epi32(a, b); }
+static __inline x86_i32_t x86_i32_mul(x86_i32_t a, x86_i32_t b)  { return _mm256_mullo_epi32(a, b); }
+static __inline x86_i32_t x86_i32_min(x86_i32_t a, x86_i32_t b)  { return _mm256_min_epi32(a, b); }
+static __inline x86_i32_t x86_i32_max(x86_i32_t a, x86_i32_t b)  { return _mm256_max_epi32(a, b); }
+static __inline x86_i32_t x86_i32_sra(x86_i32_t a, int n)        { return _mm256_srai_epi32(a, n); }
+
+static __inline x86_i64_t x86_i64_zero(void)                     { return _mm256_setzero_si256(); }
+static __inline x86_i64_t x86_i64_add(x86_i64_t a, x86_i64_t b)  { return _mm256_add_epi64(a, b); }
+static __inline x86_i64_t x86_i64_srl(x86_i64_t a, int n)        { return _mm256_srli_epi64(a, n); }
+static __inline x86_i64_t x86_i64_sll(x86_i64_t a, int n)        { return _mm256_slli_epi64(a, n); }
+
+/* 64-bit products of the even lanes and of the odd lanes of a and b */
+static __inline x86_i64_t x86_i64_mul_even(x86_i32_t a, x86_i32_t b)
+{
+  return _mm256_mul_epi32(a, b);
+}
+
+static __inline x86_i64_t x86_i64_mul_odd(x86_i32_t a, x86_i32_t b)
+{
+  return _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+}
+
+/* Sign extends the lower and the upper half of the lanes */
+static __inline x86_i64_t x86_i64_widen_lo(x86_i32_t a)
+{
+  return _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a));
+}
+
+static __inline x86_i64_t x86_i64_widen_hi(x86_i32_t a)
+{
+  return _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1));
+}
+
+/* Lower 32 bits of the even lanes of even, upper 32 bits of the odd lanes of odd */
+static __inline x86_i32_t x86_i32_blend_odd(x86_i64_t even, x86_i64_t odd)
+{
+  return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+/* Stores the X86_LANES products of x86_i64_mul_even and x86_i64_mul_odd in order */
+static __inline void x86_i64_store_even_odd(q63_t * p, x86_i64_t even, x86_i64_t odd)
+{
+  __m256i lo = _mm256_unpacklo_epi64(even, odd);
+  __m256i hi = _mm256_unpackhi_epi64(even, odd);
+
+  _mm256_storeu_si256((__m256i *) p, _mm256_permute2x128_si256(lo, hi, 0x20));
+  _mm256_storeu_si256((__m256i *) (p + 4), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+#else
+
+/* ---------------------------- SSE4.1 ---------------------------- */
+
+static __inline x86_f32_t x86_f32_load(const float32_t * p)    { return _mm_loadu_ps(p); }
+static __inline void x86_f32_store(float32_t * p, x86_f32_t a) { _mm_storeu_ps(p, a); }
+static __inline x86_f32_t x86_f32_set1(float32_t a)            { return _mm_set1_ps(a); }
+static __inline x86_f32_t x86_f32_zero(void)                   { return _mm_setzero_ps(); }
+static __inline x86_f32_t x86_f32_add(x86_f32_t a, x86_f32_t b) { return _mm_add_ps(a, b); }
+static __inline x86_f32_t x86_f32_sub(x86_f32_t a, x86_f32_t b) { return _mm_sub_ps(a, b); }
+static __inline x86_f32_t x86_f32_mul(x86_f32_t a, x86_f32_t b) { return _mm_mul_ps(a, b); }
+static __inline x86_f32_t x86_f32_min(x86_f32_t a, x86_f32_t b) { return _mm_min_ps(a, b); }
+static __inline x86_f32_t x86_f32_max(x86_f32_t a, x86_f32_t b) { return _mm_max_ps(a, b); }
+
+static __inline x86_f32_t x86_f32_select(x86_f32_t mask, x86_f32_t a, x86_f32_t b)
+{
+  return _mm_blendv_ps(b, a, mask);
+}
+
+static __inline void x86_cf32_load(const float32_t * p, x86_f32_t * re, x86_f32_t * im)
+{
+  __m128 a = _mm_loadu_ps(p);
+  __m128 b = _mm_loadu_ps(p + 4);
+
+  *re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  *im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static __inline void x86_cf32_store(float32_t * p, x86_f32_t re, x86_f32_t im)
+{
+  _mm_storeu_ps(p, _mm_unpacklo_ps(re, im));
+  _mm_storeu_ps(p + 4, _mm_unpackhi_ps(re, im));
+}
+
+static __inline void x86_f32_transpose(x86_f32_t * v)
+{
+  _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+}
+
+static __inline x86_i32_t x86_q31_load(const q31_t * p)
+{
+  return _mm_loadu_si128((const __m128i *) p);
+}
+
+static __inline x86_i32_t x86_q15_load(const q15_t * p)
+{
+  return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *) p));
+}
+
+static __inline x86_i32_t x86_q7_load(const q7_t * p)
+{
+  int32_t w;
+
+  memcpy(&w, p, sizeof(w));
+  return _mm_cvtepi8_epi32(_mm_cvtsi32_si128(w));
+}
+
+static __inline void x86_q31_store(q31_t * p, x86_i32_t a)
+{
+  _mm_storeu_si128((__m128i *) p, a);
+}
+
+static __inline void x86_q15_store_sat(q15_t * p, x86_i32_t a)
+{
+  _mm_storel_epi64((__m128i *) p, _mm_packs_epi32(a, a));
+}
+
+static __inline void x86_q7_store_sat(q7_t * p, x86_i32_t a)
+{
+  __m128i s = _mm_packs_epi32(a, a);
+  int32_t w = _mm_cvtsi128_si32(_mm_packs_epi16(s, s));
+
+  memcpy(p, &w, sizeof(w));
+}
+
+static __inline x86_i32_t x86_i32_set1(int32_t a)                { return _mm_set1_epi32(a); }
+static __inline x86_i32_t x86_i32_zero(void)                     { return _mm_setzero_si128(); }
+static __inline x86_i32_t x86_i32_add(x86_i32_t a, x86_i32_t b)  { return _mm_add_epi32(a, b); }
+static __inline x86_i32_t x86_i32_mul(x86_i32_t a, x86_i32_t b)  { return _mm_mullo_epi32(a, b); }
+static __inline x86_i32_t x86_i32_min(x86_i32_t a, x86_i32_t b)  { return _mm_min_epi32(a, b); }
+static __inline x86_i32_t x86_i32_max(x86_i32_t a, x86_i32_t b)  { return _mm_max_epi32(a, b); }
+static __inline x86_i32_t x86_i32_sra(x86_i32_t a, int n)        { return _mm_srai_epi32(a, n); }
+
+static __inline x86_i64_t x86_i64_zero(void)                     { return _mm_setzero_si128(); }
+static __inline x86_i64_t x86_i64_add(x86_i64_t a, x86_i64_t b)  { return _mm_add_epi64(a, b); }
+static __inline x86_i64_t x86_i64_srl(x86_i64_t a, int n)        { return _mm_srli_epi64(a, n); }
+static __inline x86_i64_t x86_i64_sll(x86_i64_t a, int n)        { return _mm_slli_epi64(a, n); }
+
+static __inline x86_i64_t x86_i64_mul_even(x86_i32_t a, x86_i32_t b)
+{
+  return _mm_mul_epi32(a, b);
+}
+
+static __inline x86_i64_t x86_i64_mul_odd(x86_i32_t a, x86_i32_t b)
+{
+  return _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+}
+
+static __inline x86_i64_t x86_i64_widen_lo(x86_i32_t a)
+{
+  return _mm_cvtepi32_epi64(a);
+}
+
+static __inline x86_i64_t x86_i64_widen_hi(x86_i32_t a)
+{
+  return _mm_cvtepi32_epi64(_mm_srli_si128(a, 8));
+}
+
+static __inline x86_i32_t x86_i32_blend_odd(x86_i64_t even, x86_i64_t odd)
+{
+  return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+static __inline void x86_i64_store_even_odd(q63_t * p, x86_i64_t even, x86_i64_t odd)
+{
+  _mm_storeu_si128((__m128i *) p, _mm_unpacklo_epi64(even, odd));
+  _mm_storeu_si128((__m128i *) (p + 2), _mm_unpackhi_epi64(even, odd));
+}
+
+#endif /* #if defined (__AVX2__) */
+
+/* ------------------------- both sets ------------------------- */
+
+/* Arithmetic shift of the 64-bit lanes, which neither set has */
+static __inline x86_i64_t x86_i64_sra(x86_i64_t a, int n)
+{
+#if defined (__AVX2__)
+  __m256i sign = _mm256_shuffle_epi32(_mm256_srai_epi32(a, 31), _MM_SHUFFLE(3, 3, 1, 1));
+
+  return _mm256_xor_si256(_mm256_srli_epi64(_mm256_xor_si256(a, sign), n), sign);
+#else
+  __m128i sign = _mm_shuffle_epi32(_mm_srai_epi32(a, 31), _MM_SHUFFLE(3, 3, 1, 1));
+
+  return _mm_xor_si128(_mm_srli_epi64(_mm_xor_si128(a, sign), n), sign);
+#endif
+}
+
+/*
+ * Lanes of (q31_t) (acc >> n) for the X86_LANES accumulators of even and odd,
+ * 0 < n < 32: the lower 32 bits of the arithmetic and of the logical shift
+ * are the same.
+ */
+static __inline x86_i32_t x86_i32_narrow(x86_i64_t even, x86_i64_t odd, int n)
+{
+  return x86_i32_blend_odd(x86_i64_srl(even, n), x86_i64_sll(odd, 32 - n));
+}
+
+/*
+ * __SSAT(x, 16) of arm_math.h, whose Cortex-M0 version builds the bound in a
+ * loop, for the sample by sample recursions.
+ */
+static __inline q31_t x86_ssat16(q31_t x)
+{
+  return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+/* Horizontal reductions, lane 0 first */
+static __inline float32_t x86_f32_hsum(x86_f32_t a)
+{
+  float32_t l[X86_LANES], sum = 0.0f;
+  uint32_t i;
+
+  x86_f32_store(l, a);
+  for (i = 0u; i < X86_LANES; i++)
+  {
+    sum += l[i];
+  }
+  return sum;
+}
+
+static __inline float32_t x86_f32_hmin(x86_f32_t a)
+{
+  float32_t l[X86_LANES], out;
+  uint32_t i;
+
+  x86_f32_store(l, a);
+  out = l[0];
+  for (i = 1u; i < X86_LANES; i++)
+  {
+    out = (l[i] < out) ? l[i] : out;
+  }
+  return out;
+}
+
+static __inline float32_t x86_f32_hmax(x86_f32_t a)
+{
+  float32_t l[X86_LANES], out;
+  uint32_t i;
+
+  x86_f32_store(l, a);
+  out = l[0];
+  for (i = 1u; i < X86_LANES; i++)
+  {
+    out = (l[i] > out) ? l[i] : out;
+  }
+  return out;
+}
+
+/* Sum of the lanes, wrapping as the 32-bit accumulators of the C files */
+static __inline q31_t x86_i32_hsum(x86_i32_t a)
+{
+  q31_t l[X86_LANES];
+  uint32_t i, sum = 0u;
+
+  x86_q31_store(l, a);
+  for (i = 0u; i < X86_LANES; i++)
+  {
+    sum += (uint32_t) l[i];
+  }
+  return (q31_t) sum;
+}
+
+static __inline q31_t x86_i32_hmin(x86_i32_t a)
+{
+  q31_t l[X86_LANES], out;
+  uint32_t i;
+
+  x86_q31_store(l, a);
+  out = l[0];
+  for (i = 1u; i < X86_LANES; i++)
+  {
+    out = (l[i] < out) ? l[i] : out;
+  }
+  return out;
+}
+
+static __inline q31_t x86_i32_hmax(x86_i32_t a)
+{
+  q31_t l[X86_LANES], out;
+  uint32_t i;
+
+  x86_q31_store(l, a);
+  out = l[0];
+  for (i = 1u; i < X86_LANES; i++)
+  {
+    out = (l[i] > out) ? l[i] : out;
+  }
+  return out;
+}
+
+static __inline q63_t x86_i64_hsum(x86_i64_t a)
+{
+  q63_t l[X86_LANES / 2];
+  uint64_t sum = 0u;
+  uint32_t i;
+
+  memcpy(l, &a, sizeof(l));
+  for (i = 0u; i < X86_LANES / 2; i++)
+  {
+    sum += (uint64_t) l[i];
+  }
+  return (q63_t) sum;
+}
+
+#endif /* _ARM_X86_UTILS_H */
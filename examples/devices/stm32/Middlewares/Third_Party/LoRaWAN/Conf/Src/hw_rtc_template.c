@@ -283,8 +283,9 @@ TimerTime_t HW_RTC_Tick2ms( uint32_t tick )
  */
 void HW_RTC_SetAlarm( uint32_t timeout )
 {
-  /* we don't go in Low Power mode for timeout below MIN_ALARM_DELAY */
-  if ( (MIN_ALARM_DELAY + McuWakeUpTimeCal ) < ((timeout - HW_RTC_GetTimerElapsedTime( ) )) )
+  /* we don't go in Low Power mode for timeout below MIN_ALARM_DELAY, nor when
+     sleeping is cheaper than paying the stop mode transition */
+  if ( (MIN_ALARM_DELAY + McuWakeUpTimeCal + HW_RTC_ms2Tick( LPM_GetBreakEvenTime( LPM_StopMode ) ) ) < ((timeout - HW_RTC_GetTimerElapsedTime( ) )) )
   {
     LPM_SetStopMode(LPM_RTC_Id , LPM_Enable );
   }
@@ -0,0 +1,415 @@
+/**
+  ******************************************************************************
+  * @file    cayenne_lpp.c
+  * @author  MCD Application Team
+  * @brief   Cayenne LPP payload encoder
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "lora.h"
+#include "cayenne_lpp.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* channel and type */
+#define LPP_HEADER_SIZE             2
+
+/* The agent reads 16-bit values as signed, even the unsigned types */
+#define LPP_INT16_MAX               0x7FFF
+#define LPP_INT24_MAX               0x7FFFFF
+#define LPP_INT24_MIN               ( -0x800000 )
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t *lpp_append(lpp_Buffer_t *lpp, uint8_t channel, uint8_t type);
+static uint8_t lpp_get_field_size(uint8_t type);
+static void lpp_put16(uint8_t *p, uint16_t value);
+static void lpp_put24(uint8_t *p, int32_t value);
+static void lpp_reverse(uint8_t *p, uint8_t size);
+static void lpp_rotate(uint8_t *p, uint8_t size, uint8_t shift);
+
+/* Functions Definition ------------------------------------------------------*/
+void lpp_init(lpp_Buffer_t *lpp, uint8_t *buff, uint8_t capacity)
+{
+  lpp->Buff = buff;
+  lpp->Capacity = capacity;
+  lpp->Priority = LPP_PRIORITY_HIGHEST;
+  lpp_reset(lpp);
+}
+
+void lpp_reset(lpp_Buffer_t *lpp)
+{
+  lpp->Size = 0;
+  lpp->Length = 0;
+  lpp->NbFields = 0;
+  lpp->NbSelected = 0;
+}
+
+void lpp_set_priority(lpp_Buffer_t *lpp, uint8_t priority)
+{
+  lpp->Priority = priority;
+}
+
+bool lpp_add_digital_input(lpp_Buffer_t *lpp, uint8_t channel, uint8_t value)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_DIGITAL_INPUT);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  p[0] = value;
+  return true;
+}
+
+bool lpp_add_digital_output(lpp_Buffer_t *lpp, uint8_t channel, uint8_t value)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_DIGITAL_OUTPUT);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  p[0] = value;
+  return true;
+}
+
+bool lpp_add_analog_input(lpp_Buffer_t *lpp, uint8_t channel, int16_t value)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_ANALOG_INPUT);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(p, (uint16_t)value);
+  return true;
+}
+
+bool lpp_add_analog_output(lpp_Buffer_t *lpp, uint8_t channel, int16_t value)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_ANALOG_OUTPUT);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(p, (uint16_t)value);
+  return true;
+}
+
+bool lpp_add_luminosity(lpp_Buffer_t *lpp, uint8_t channel, uint16_t lux)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_LUMINOSITY);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(p, (lux > LPP_INT16_MAX) ? LPP_INT16_MAX : lux);
+  return true;
+}
+
+bool lpp_add_presence(lpp_Buffer_t *lpp, uint8_t channel, uint8_t value)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_PRESENCE);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  p[0] = value;
+  return true;
+}
+
+bool lpp_add_temperature(lpp_Buffer_t *lpp, uint8_t channel, int16_t celsius)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_TEMPERATURE);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(p, (uint16_t)celsius);
+  return true;
+}
+
+bool lpp_add_relative_humidity(lpp_Buffer_t *lpp, uint8_t channel, uint8_t rh)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_RELATIVE_HUMIDITY);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  p[0] = rh;
+  return true;
+}
+
+bool lpp_add_accelerometer(lpp_Buffer_t *lpp, uint8_t channel, int16_t x, int16_t y, int16_t z)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_ACCELEROMETER);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(&p[0], (uint16_t)x);
+  lpp_put16(&p[2], (uint16_t)y);
+  lpp_put16(&p[4], (uint16_t)z);
+  return true;
+}
+
+bool lpp_add_barometric_pressure(lpp_Buffer_t *lpp, uint8_t channel, uint16_t hpa)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_BAROMETRIC_PRESSURE);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(p, (hpa > LPP_INT16_MAX) ? LPP_INT16_MAX : hpa);
+  return true;
+}
+
+bool lpp_add_gyrometer(lpp_Buffer_t *lpp, uint8_t channel, int16_t x, int16_t y, int16_t z)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_GYROMETER);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put16(&p[0], (uint16_t)x);
+  lpp_put16(&p[2], (uint16_t)y);
+  lpp_put16(&p[4], (uint16_t)z);
+  return true;
+}
+
+bool lpp_add_gps(lpp_Buffer_t *lpp, uint8_t channel, int32_t latitude, int32_t longitude, int32_t altitude)
+{
+  uint8_t *p = lpp_append(lpp, channel, LPP_GPS);
+
+  if (p == NULL)
+  {
+    return false;
+  }
+  lpp_put24(&p[0], latitude);
+  lpp_put24(&p[3], longitude);
+  lpp_put24(&p[6], altitude);
+  return true;
+}
+
+uint8_t lpp_get_max_size(void)
+{
+  return LORA_GetMaxPayloadSize();
+}
+
+uint8_t lpp_get_remaining(lpp_Buffer_t *lpp, uint8_t maxSize)
+{
+  return (lpp->Length < maxSize) ? (maxSize - lpp->Length) : 0;
+}
+
+uint8_t lpp_fit(lpp_Buffer_t *lpp, uint8_t maxSize)
+{
+  uint8_t selected[LPP_MAX_FIELDS];
+  uint8_t fieldSize[LPP_MAX_FIELDS];
+  uint8_t maxPriority = 0;
+  uint8_t size = 0;
+  uint8_t offset = 0;
+  uint8_t i;
+  uint8_t n;
+  uint16_t priority;
+
+  for (i = 0; i < lpp->NbFields; i++)
+  {
+    fieldSize[i] = LPP_HEADER_SIZE + lpp_get_field_size(lpp->Buff[offset + 1]);
+    offset += fieldSize[i];
+    selected[i] = 0;
+    if (lpp->FieldPriority[i] > maxPriority)
+    {
+      maxPriority = lpp->FieldPriority[i];
+    }
+  }
+
+  lpp->NbSelected = 0;
+  for (priority = LPP_PRIORITY_HIGHEST; priority <= maxPriority; priority++)
+  {
+    for (i = 0; i < lpp->NbFields; i++)
+    {
+      if ((lpp->FieldPriority[i] == priority) && ((size + fieldSize[i]) <= maxSize))
+      {
+        selected[i] = 1;
+        size += fieldSize[i];
+        lpp->NbSelected++;
+      }
+    }
+  }
+
+  /* move each deferred field behind the others, keeping the order of both sets */
+  offset = 0;
+  i = 0;
+  for (n = 0; n < lpp->NbFields; n++)
+  {
+    if (selected[i] != 0)
+    {
+      offset += fieldSize[i];
+      i++;
+    }
+    else
+    {
+      uint8_t deferredSize = fieldSize[i];
+      uint8_t deferredPriority = lpp->FieldPriority[i];
+      uint8_t j;
+
+      lpp_rotate(&lpp->Buff[offset], lpp->Length - offset, deferredSize);
+      for (j = i; j < (lpp->NbFields - 1); j++)
+      {
+        selected[j] = selected[j + 1];
+        fieldSize[j] = fieldSize[j + 1];
+        lpp->FieldPriority[j] = lpp->FieldPriority[j + 1];
+      }
+      selected[j] = 0;
+      fieldSize[j] = deferredSize;
+      lpp->FieldPriority[j] = deferredPriority;
+    }
+  }
+
+  lpp->Size = size;
+  return size;
+}
+
+bool lpp_next(lpp_Buffer_t *lpp)
+{
+  uint8_t i;
+
+  for (i = 0; i < (lpp->Length - lpp->Size); i++)
+  {
+    lpp->Buff[i] = lpp->Buff[lpp->Size + i];
+  }
+  for (i = 0; i < (lpp->NbFields - lpp->NbSelected); i++)
+  {
+    lpp->FieldPriority[i] = lpp->FieldPriority[lpp->NbSelected + i];
+  }
+
+  lpp->Length -= lpp->Size;
+  lpp->NbFields -= lpp->NbSelected;
+  lpp->Size = 0;
+  lpp->NbSelected = 0;
+
+  return lpp->NbFields != 0;
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Reserves a field at the end of the buffer and writes its header
+ * @param  lpp: buffer
+ * @param  channel: data channel
+ * @param  type: data type
+ * @retval Where to write the value, NULL when the field does not fit
+ */
+static uint8_t *lpp_append(lpp_Buffer_t *lpp, uint8_t channel, uint8_t type)
+{
+  uint16_t size = LPP_HEADER_SIZE + lpp_get_field_size(type);
+  uint8_t *p = &lpp->Buff[lpp->Length];
+
+  if ((lpp->NbFields >= LPP_MAX_FIELDS) || ((lpp->Length + size) > lpp->Capacity))
+  {
+    return NULL;
+  }
+
+  p[0] = channel;
+  p[1] = type;
+  lpp->FieldPriority[lpp->NbFields++] = lpp->Priority;
+  lpp->Length += size;
+
+  return &p[LPP_HEADER_SIZE];
+}
+
+/**
+ * @brief  Returns the size of the value of a data type
+ * @param  type: data type
+ * @retval Size in bytes
+ */
+static uint8_t lpp_get_field_size(uint8_t type)
+{
+  switch (type)
+  {
+    case LPP_ANALOG_INPUT:
+    case LPP_ANALOG_OUTPUT:
+    case LPP_LUMINOSITY:
+    case LPP_TEMPERATURE:
+    case LPP_BAROMETRIC_PRESSURE:
+      return 2;
+    case LPP_ACCELEROMETER:
+    case LPP_GYROMETER:
+      return 6;
+    case LPP_GPS:
+      return 9;
+    default:
+      /* digital input/output, presence, relative humidity */
+      return 1;
+  }
+}
+
+static void lpp_put16(uint8_t *p, uint16_t value)
+{
+  p[0] = (value >> 8) & 0xFF;
+  p[1] = value & 0xFF;
+}
+
+static void lpp_put24(uint8_t *p, int32_t value)
+{
+  if (value > LPP_INT24_MAX)
+  {
+    value = LPP_INT24_MAX;
+  }
+  else if (value < LPP_INT24_MIN)
+  {
+    value = LPP_INT24_MIN;
+  }
+  p[0] = ((uint32_t)value >> 16) & 0xFF;
+  p[1] = ((uint32_t)value >> 8) & 0xFF;
+  p[2] = (uint32_t)value & 0xFF;
+}
+
+static void lpp_reverse(uint8_t *p, uint8_t size)
+{
+  uint8_t i;
+
+  for (i = 0; i < (size / 2); i++)
+  {
+    uint8_t tmp = p[i];
+    p[i] = p[size - 1 - i];
+    p[size - 1 - i] = tmp;
+  }
+}
+
+/**
+ * @brief  Rotates bytes to the left in place
+ * @param  p: bytes to rotate
+ * @param  size: number of bytes
+ * @param  shift: rotation, the first shift bytes end up last
+ * @retval None
+ */
+static void lpp_rotate(uint8_t *p, uint8_t size, uint8_t shift)
+{
+  lpp_reverse(p, shift);
+  lpp_reverse(p + shift, size - shift);
+  lpp_reverse(p, size);
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file    cayenne_lpp.h
+  * @author  MCD Application Team
+  * @brief   Header for cayenne_lpp.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CAYENNE_LPP_H__
+#define __CAYENNE_LPP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Data types, as decoded by the agent (lib/dataModels/cayenneLpp.js) */
+#define LPP_DIGITAL_INPUT           0     /* 1 byte */
+#define LPP_DIGITAL_OUTPUT          1     /* 1 byte */
+#define LPP_ANALOG_INPUT            2     /* 2 bytes, 0.01 signed */
+#define LPP_ANALOG_OUTPUT           3     /* 2 bytes, 0.01 signed */
+#define LPP_LUMINOSITY              101   /* 2 bytes, 1 lux */
+#define LPP_PRESENCE                102   /* 1 byte */
+#define LPP_TEMPERATURE             103   /* 2 bytes, 0.1 degC signed */
+#define LPP_RELATIVE_HUMIDITY       104   /* 1 byte, 0.5 % unsigned */
+#define LPP_ACCELEROMETER           113   /* 2 bytes per axis, 0.001 G signed */
+#define LPP_BAROMETRIC_PRESSURE     115   /* 2 bytes, 0.1 hPa */
+#define LPP_GYROMETER               134   /* 2 bytes per axis, 0.01 deg/s signed */
+#define LPP_GPS                     136   /* 3 bytes lat/lon 0.0001 deg, 3 bytes alt 0.01 m */
+
+/* Maximum number of fields in a buffer */
+#ifndef LPP_MAX_FIELDS
+#define LPP_MAX_FIELDS              24
+#endif
+
+/* Priority of the fields added after lpp_init, 0 is the highest */
+#define LPP_PRIORITY_HIGHEST        0
+
+/* Exported types ------------------------------------------------------------*/
+/*!
+ * Cayenne LPP buffer. Fields are appended as channel, type, value. The
+ * fields selected by lpp_fit are at the start of the buffer, the deferred
+ * ones follow them.
+ */
+typedef struct
+{
+  /*points to the application data buffer*/
+  uint8_t *Buff;
+  /*size of Buff*/
+  uint8_t Capacity;
+  /*size of the fields selected for the next frame*/
+  uint8_t Size;
+  /*size of all the fields, selected and deferred*/
+  uint8_t Length;
+  /*number of fields, selected and deferred*/
+  uint8_t NbFields;
+  /*number of fields selected for the next frame*/
+  uint8_t NbSelected;
+  /*priority given to the next fields*/
+  uint8_t Priority;
+  /*priority of each field*/
+  uint8_t FieldPriority[LPP_MAX_FIELDS];
+} lpp_Buffer_t;
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes an empty buffer, the next fields get the highest priority
+ * @param  lpp: buffer to initialize
+ * @param  buff: storage of the fields, usually the application data buffer
+ * @param  capacity: size of buff
+ * @retval None
+ */
+void lpp_init(lpp_Buffer_t *lpp, uint8_t *buff, uint8_t capacity);
+
+/**
+ * @brief  Drops all the fields, selected and deferred
+ * @param  lpp: buffer
+ * @retval None
+ */
+void lpp_reset(lpp_Buffer_t *lpp);
+
+/**
+ * @brief  Sets the priority of the fields added next
+ * @param  lpp: buffer
+ * @param  priority: LPP_PRIORITY_HIGHEST or above, higher values are dropped first
+ * @retval None
+ */
+void lpp_set_priority(lpp_Buffer_t *lpp, uint8_t priority);
+
+/**
+ * @brief  Appends a field. The lpp_add_* functions return false, leaving the
+ *         buffer untouched, when the field does not fit in the buffer
+ * @param  lpp: buffer
+ * @param  channel: data channel
+ * @param  value: value in the unit of the data type (see LPP_xxx)
+ * @retval true when the field was added
+ */
+bool lpp_add_digital_input(lpp_Buffer_t *lpp, uint8_t channel, uint8_t value);
+bool lpp_add_digital_output(lpp_Buffer_t *lpp, uint8_t channel, uint8_t value);
+bool lpp_add_analog_input(lpp_Buffer_t *lpp, uint8_t channel, int16_t value);
+bool lpp_add_analog_output(lpp_Buffer_t *lpp, uint8_t channel, int16_t value);
+bool lpp_add_luminosity(lpp_Buffer_t *lpp, uint8_t channel, uint16_t lux);
+bool lpp_add_presence(lpp_Buffer_t *lpp, uint8_t channel, uint8_t value);
+bool lpp_add_temperature(lpp_Buffer_t *lpp, uint8_t channel, int16_t celsius);
+bool lpp_add_relative_humidity(lpp_Buffer_t *lpp, uint8_t channel, uint8_t rh);
+bool lpp_add_accelerometer(lpp_Buffer_t *lpp, uint8_t channel, int16_t x, int16_t y, int16_t z);
+bool lpp_add_barometric_pressure(lpp_Buffer_t *lpp, uint8_t channel, uint16_t hpa);
+bool lpp_add_gyrometer(lpp_Buffer_t *lpp, uint8_t channel, int16_t x, int16_t y, int16_t z);
+bool lpp_add_gps(lpp_Buffer_t *lpp, uint8_t channel, int32_t latitude, int32_t longitude, int32_t altitude);
+
+/**
+ * @brief  Returns the application payload size allowed at the current data
+ *         rate, pending MAC commands deducted (LoRaMacQueryTxPossible)
+ * @param  None
+ * @retval Payload size in bytes
+ */
+uint8_t lpp_get_max_size(void);
+
+/**
+ * @brief  Returns the room left for the next fields in a frame of maxSize bytes
+ * @param  lpp: buffer
+ * @param  maxSize: frame payload size, e.g. from lpp_get_max_size
+ * @retval Free bytes, 0 when the fields already exceed maxSize
+ */
+uint8_t lpp_get_remaining(lpp_Buffer_t *lpp, uint8_t maxSize);
+
+/**
+ * @brief  Selects the fields of the next frame: by decreasing priority, and in
+ *         the order they were added within a priority, every field that still
+ *         fits in maxSize. The selected fields are moved to the start of the
+ *         buffer, keeping their order, the others are deferred behind them
+ * @param  lpp: buffer
+ * @param  maxSize: frame payload size, e.g. from lpp_get_max_size
+ * @retval Size of the selected fields, to be sent from the start of the buffer
+ */
+uint8_t lpp_fit(lpp_Buffer_t *lpp, uint8_t maxSize);
+
+/**
+ * @brief  Drops the selected fields once sent, the deferred fields become the
+ *         content of the buffer. Calling lpp_reset instead drops them too
+ * @param  lpp: buffer
+ * @retval true when deferred fields are left
+ */
+bool lpp_next(lpp_Buffer_t *lpp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CAYENNE_LPP_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
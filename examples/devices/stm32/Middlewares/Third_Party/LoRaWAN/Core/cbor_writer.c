@@ -0,0 +1,321 @@
+/**
+  ******************************************************************************
+  * @file    cbor_writer.c
+  * @author  MCD Application Team
+  * @brief   Streaming CBOR encoder for uplink payloads
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "cbor_writer.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Major types */
+#define CBOR_UINT                   0x00
+#define CBOR_NEGINT                 0x20
+#define CBOR_BYTES                  0x40
+#define CBOR_TEXT                   0x60
+#define CBOR_ARRAY                  0x80
+#define CBOR_MAP                    0xA0
+#define CBOR_SIMPLE                 0xE0
+
+/* Additional information */
+#define CBOR_AI_1BYTE               24
+#define CBOR_AI_2BYTES              25
+#define CBOR_AI_4BYTES              26
+
+#define CBOR_FALSE                  ( CBOR_SIMPLE | 20 )
+#define CBOR_TRUE                   ( CBOR_SIMPLE | 21 )
+#define CBOR_NULL                   ( CBOR_SIMPLE | 22 )
+#define CBOR_FLOAT16                ( CBOR_SIMPLE | CBOR_AI_2BYTES )
+#define CBOR_FLOAT32                ( CBOR_SIMPLE | CBOR_AI_4BYTES )
+
+/* Half precision */
+#define HALF_INFINITY               0x7C00
+#define HALF_NAN                    0x7E00
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void cbor_write(cbor_Writer_t *writer, const uint8_t *data, uint16_t size);
+static void cbor_put_head(cbor_Writer_t *writer, uint8_t major, uint32_t value);
+static void cbor_put_half(cbor_Writer_t *writer, uint16_t half);
+static uint32_t cbor_float_bits(float value);
+static bool cbor_float_to_half(uint32_t bits, bool exact, uint16_t *half);
+
+/* Functions Definition ------------------------------------------------------*/
+void cbor_init(cbor_Writer_t *writer, uint8_t *buff, uint8_t capacity)
+{
+  writer->Buff = buff;
+  writer->Capacity = capacity;
+  writer->Size = 0;
+}
+
+void cbor_put_map(cbor_Writer_t *writer, uint16_t nbPairs)
+{
+  cbor_put_head(writer, CBOR_MAP, nbPairs);
+}
+
+void cbor_put_array(cbor_Writer_t *writer, uint16_t nbItems)
+{
+  cbor_put_head(writer, CBOR_ARRAY, nbItems);
+}
+
+void cbor_put_uint(cbor_Writer_t *writer, uint32_t value)
+{
+  cbor_put_head(writer, CBOR_UINT, value);
+}
+
+void cbor_put_int(cbor_Writer_t *writer, int32_t value)
+{
+  if (value < 0)
+  {
+    /* -1 - value, without overflowing on INT32_MIN */
+    cbor_put_head(writer, CBOR_NEGINT, ~(uint32_t)value);
+  }
+  else
+  {
+    cbor_put_head(writer, CBOR_UINT, (uint32_t)value);
+  }
+}
+
+void cbor_put_string(cbor_Writer_t *writer, const char *str)
+{
+  uint16_t size = 0;
+
+  while (str[size] != '\0')
+  {
+    size++;
+  }
+  cbor_put_head(writer, CBOR_TEXT, size);
+  cbor_write(writer, (const uint8_t *)str, size);
+}
+
+void cbor_put_bytes(cbor_Writer_t *writer, const uint8_t *data, uint16_t size)
+{
+  cbor_put_head(writer, CBOR_BYTES, size);
+  cbor_write(writer, data, size);
+}
+
+void cbor_put_bool(cbor_Writer_t *writer, bool value)
+{
+  uint8_t byte = value ? CBOR_TRUE : CBOR_FALSE;
+
+  cbor_write(writer, &byte, 1);
+}
+
+void cbor_put_null(cbor_Writer_t *writer)
+{
+  uint8_t byte = CBOR_NULL;
+
+  cbor_write(writer, &byte, 1);
+}
+
+void cbor_put_float(cbor_Writer_t *writer, float value)
+{
+  uint32_t bits = cbor_float_bits(value);
+  uint16_t half;
+  uint8_t data[5];
+
+  if (cbor_float_to_half(bits, true, &half))
+  {
+    cbor_put_half(writer, half);
+  }
+  else
+  {
+    data[0] = CBOR_FLOAT32;
+    data[1] = (bits >> 24) & 0xFF;
+    data[2] = (bits >> 16) & 0xFF;
+    data[3] = (bits >> 8) & 0xFF;
+    data[4] = bits & 0xFF;
+    cbor_write(writer, data, sizeof(data));
+  }
+}
+
+void cbor_put_float16(cbor_Writer_t *writer, float value)
+{
+  uint16_t half;
+
+  cbor_float_to_half(cbor_float_bits(value), false, &half);
+  cbor_put_half(writer, half);
+}
+
+uint16_t cbor_get_size(cbor_Writer_t *writer)
+{
+  return writer->Size;
+}
+
+bool cbor_is_valid(cbor_Writer_t *writer)
+{
+  return (writer->Buff != NULL) && (writer->Size <= writer->Capacity);
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Appends bytes, only counted without buffer or once they do not fit:
+ *         Size then exceeds Capacity and no further byte is written
+ * @param  writer: writer
+ * @param  data: bytes
+ * @param  size: number of bytes
+ * @retval None
+ */
+static void cbor_write(cbor_Writer_t *writer, const uint8_t *data, uint16_t size)
+{
+  uint16_t i;
+
+  if ((writer->Buff != NULL) && ((writer->Size + size) <= writer->Capacity))
+  {
+    for (i = 0; i < size; i++)
+    {
+      writer->Buff[writer->Size + i] = data[i];
+    }
+  }
+  writer->Size += size;
+}
+
+/**
+ * @brief  Puts an initial byte and its argument in the fewest bytes
+ * @param  writer: writer
+ * @param  major: major type
+ * @param  value: argument, value or length
+ * @retval None
+ */
+static void cbor_put_head(cbor_Writer_t *writer, uint8_t major, uint32_t value)
+{
+  uint8_t data[5];
+  uint16_t size;
+
+  if (value < CBOR_AI_1BYTE)
+  {
+    data[0] = major | value;
+    size = 1;
+  }
+  else if (value <= 0xFF)
+  {
+    data[0] = major | CBOR_AI_1BYTE;
+    data[1] = value;
+    size = 2;
+  }
+  else if (value <= 0xFFFF)
+  {
+    data[0] = major | CBOR_AI_2BYTES;
+    data[1] = (value >> 8) & 0xFF;
+    data[2] = value & 0xFF;
+    size = 3;
+  }
+  else
+  {
+    data[0] = major | CBOR_AI_4BYTES;
+    data[1] = (value >> 24) & 0xFF;
+    data[2] = (value >> 16) & 0xFF;
+    data[3] = (value >> 8) & 0xFF;
+    data[4] = value & 0xFF;
+    size = 5;
+  }
+  cbor_write(writer, data, size);
+}
+
+static void cbor_put_half(cbor_Writer_t *writer, uint16_t half)
+{
+  uint8_t data[3];
+
+  data[0] = CBOR_FLOAT16;
+  data[1] = (half >> 8) & 0xFF;
+  data[2] = half & 0xFF;
+  cbor_write(writer, data, sizeof(data));
+}
+
+static uint32_t cbor_float_bits(float value)
+{
+  union
+  {
+    float f;
+    uint32_t u;
+  } bits;
+
+  bits.f = value;
+  return bits.u;
+}
+
+/**
+ * @brief  Converts a single precision float to half precision with integer
+ *         operations only, the MCU has no FPU
+ * @param  bits: single precision float
+ * @param  exact: true to fail rather than round
+ * @param  half: half precision float, rounded to nearest even
+ * @retval false when exact is set and the value is not representable
+ */
+static bool cbor_float_to_half(uint32_t bits, bool exact, uint16_t *half)
+{
+  uint16_t sign = (bits >> 16) & 0x8000;
+  int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127;
+  uint32_t mantissa = bits & 0x7FFFFF;
+  uint32_t shift;
+  uint32_t rest;
+  uint32_t result;
+
+  if (exponent == 128)
+  {
+    /* infinity, or NaN made canonical */
+    *half = sign | ((mantissa == 0) ? HALF_INFINITY : HALF_NAN);
+    return true;
+  }
+  if ((exponent == -127) && (mantissa == 0))
+  {
+    *half = sign;
+    return true;
+  }
+  if (exponent > 15)
+  {
+    *half = sign | HALF_INFINITY;
+    return !exact;
+  }
+  if (exponent < -25)
+  {
+    /* below half of the smallest subnormal, includes single subnormals */
+    *half = sign;
+    return !exact;
+  }
+
+  if (exponent >= -14)
+  {
+    /* normal: drop 13 mantissa bits, the exponent field follows in result */
+    shift = 13;
+    mantissa |= (uint32_t)(exponent + 15) << 23;
+  }
+  else
+  {
+    /* subnormal: the implicit bit becomes explicit */
+    shift = (uint32_t)(-1 - exponent);
+    mantissa |= 0x800000;
+  }
+
+  result = mantissa >> shift;
+  rest = mantissa & ((1UL << shift) - 1);
+  if (exact && (rest != 0))
+  {
+    return false;
+  }
+  /* round to nearest even, a carry into the exponent is correct, up to infinity */
+  if ((rest > (1UL << (shift - 1))) || ((rest == (1UL << (shift - 1))) && ((result & 1) != 0)))
+  {
+    result++;
+  }
+  *half = sign | (uint16_t)result;
+  return true;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
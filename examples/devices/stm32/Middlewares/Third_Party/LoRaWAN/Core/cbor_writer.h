@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    cbor_writer.h
+  * @author  MCD Application Team
+  * @brief   Header for cbor_writer.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CBOR_WRITER_H__
+#define __CBOR_WRITER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/*!
+ * CBOR writer (RFC 8949), encoding items in place as they are put. Integers,
+ * lengths and floats use the preferred (shortest) serialization. Maps and
+ * arrays have a definite length: put the number of pairs or elements, then
+ * the items.
+ */
+typedef struct
+{
+  /*points to the output buffer, NULL to only compute the encoded size*/
+  uint8_t *Buff;
+  /*size of Buff*/
+  uint8_t Capacity;
+  /*encoded size, keeps counting past Capacity*/
+  uint16_t Size;
+} cbor_Writer_t;
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes a writer. With a NULL buffer the writer only computes the
+ *         encoded size, to check a message fits before encoding it
+ * @param  writer: writer to initialize
+ * @param  buff: output buffer, usually the application data buffer, or NULL
+ * @param  capacity: size of buff
+ * @retval None
+ */
+void cbor_init(cbor_Writer_t *writer, uint8_t *buff, uint8_t capacity);
+
+/**
+ * @brief  Puts the header of a map
+ * @param  writer: writer
+ * @param  nbPairs: number of key/value pairs following
+ * @retval None
+ */
+void cbor_put_map(cbor_Writer_t *writer, uint16_t nbPairs);
+
+/**
+ * @brief  Puts the header of an array
+ * @param  writer: writer
+ * @param  nbItems: number of items following
+ * @retval None
+ */
+void cbor_put_array(cbor_Writer_t *writer, uint16_t nbItems);
+
+/**
+ * @brief  Puts an unsigned integer, also used for small integer map keys
+ * @param  writer: writer
+ * @param  value: value
+ * @retval None
+ */
+void cbor_put_uint(cbor_Writer_t *writer, uint32_t value);
+
+/**
+ * @brief  Puts a signed integer
+ * @param  writer: writer
+ * @param  value: value
+ * @retval None
+ */
+void cbor_put_int(cbor_Writer_t *writer, int32_t value);
+
+/**
+ * @brief  Puts a text string, also used for short string map keys
+ * @param  writer: writer
+ * @param  str: NUL terminated UTF-8 string
+ * @retval None
+ */
+void cbor_put_string(cbor_Writer_t *writer, const char *str);
+
+/**
+ * @brief  Puts a byte string
+ * @param  writer: writer
+ * @param  data: bytes
+ * @param  size: number of bytes
+ * @retval None
+ */
+void cbor_put_bytes(cbor_Writer_t *writer, const uint8_t *data, uint16_t size);
+
+/**
+ * @brief  Puts a boolean
+ * @param  writer: writer
+ * @param  value: value
+ * @retval None
+ */
+void cbor_put_bool(cbor_Writer_t *writer, bool value);
+
+/**
+ * @brief  Puts null
+ * @param  writer: writer
+ * @retval None
+ */
+void cbor_put_null(cbor_Writer_t *writer);
+
+/**
+ * @brief  Puts a float as a half precision float when this is exact, as a
+ *         single precision float otherwise
+ * @param  writer: writer
+ * @param  value: value
+ * @retval None
+ */
+void cbor_put_float(cbor_Writer_t *writer, float value);
+
+/**
+ * @brief  Puts a float rounded to half precision (11 significant bits, about
+ *         3 decimal digits, +/-65504), for sensor values of known resolution
+ * @param  writer: writer
+ * @param  value: value
+ * @retval None
+ */
+void cbor_put_float16(cbor_Writer_t *writer, float value);
+
+/**
+ * @brief  Returns the encoded size
+ * @param  writer: writer
+ * @retval Size in bytes, may exceed the capacity, see cbor_is_valid
+ */
+uint16_t cbor_get_size(cbor_Writer_t *writer);
+
+/**
+ * @brief  Tells whether the whole message fits in the buffer
+ * @param  writer: writer
+ * @retval false when items were lost for lack of room, or with a NULL buffer
+ */
+bool cbor_is_valid(cbor_Writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CBOR_WRITER_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -159,6 +159,14 @@ static void TraceBeaconInfo(MlmeIndication_t *mlmeIndication);
 static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
 {
     TVL2( PRINTNOW(); PRINTF("APP> McpsConfirm STATUS: %s\r\n", EventInfoStatusStrings[mcpsConfirm->Status] ); )
+    TVL2( PRINTF("APP> McpsConfirm energy: %u uJ\r\n", mcpsConfirm->Energy ); )
+    if( mcpsConfirm->McpsRequest == MCPS_CONFIRMED )
+    {
+        TVL2( PRINTF("APP> McpsConfirm ack: %d, trans: %d/%d, airtime: %u ms, backoff: %u ms%s\r\n",
+                     mcpsConfirm->AckReceived, mcpsConfirm->NbRetries, mcpsConfirm->NbTrials,
+                     mcpsConfirm->TotalTimeOnAir, mcpsConfirm->BackoffTime,
+                     mcpsConfirm->Abandoned ? ", abandoned" : "" ); )
+    }
   
     if( mcpsConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK )
     {
@@ -617,6 +625,37 @@ LoraFlagStatus LORA_JoinStatus( void)
   }
 }
 
+uint8_t LORA_GetMaxPayloadSize( void )
+{
+  LoRaMacTxInfo_t txInfo;
+
+  /* the MAC returns early, leaving it untouched, on parameter errors */
+  txInfo.MaxPossibleApplicationDataSize = 0;
+  LoRaMacQueryTxPossible( 0, &txInfo );
+
+  return txInfo.MaxPossibleApplicationDataSize;
+}
+
+TimerTime_t LORA_GetTxTimeOff( void )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_TX_TIME_OFF;
+  mibReq.Param.TxTimeOff = 0;
+  LoRaMacMibGetRequestConfirm( &mibReq );
+
+  return mibReq.Param.TxTimeOff;
+}
+
+void LORA_SetRetransPolicy( const RetransPolicy_t *policy )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_RETRANS_POLICY;
+  mibReq.Param.RetransPolicy = policy;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+}
+
 
 
 bool LORA_send(lora_AppData_t* AppData, LoraConfirm_t IsTxConfirmed)
@@ -654,6 +693,7 @@ bool LORA_send(lora_AppData_t* AppData, LoraConfirm_t IsTxConfirmed)
             mcpsReq.Req.Confirmed.fPort = AppData->Port;
             mcpsReq.Req.Confirmed.fBufferSize = AppData->BuffSize;
             mcpsReq.Req.Confirmed.fBuffer = AppData->Buff;
+            /* upper bound, the retransmission policy may lower it */
             mcpsReq.Req.Confirmed.NbTrials = 8;
             mcpsReq.Req.Confirmed.Datarate = LoRaParamInit->TxDatarate;
         }
@@ -827,8 +867,8 @@ static void TraceUpLinkFrame(McpsConfirm_t *mcpsConfirm)
     mibReq.Type = MIB_DEVICE_CLASS;
     LoRaMacMibGetRequestConfirm( &mibReq );
   
-    TVL2( PRINTF("\r\n" );)
-    TVL2( PRINTNOW(); PRINTF("#= U/L FRAME %lu =# Class %c, Port %d, data size %d, pwr %d, ", \
+    TVL2( TPRINTF("\r\n" );)
+    TVL2( TPRINTNOW(); TPRINTF("#= U/L FRAME %lu =# Class %c, Port %d, data size %d, pwr %d, ", \
                              mcpsConfirm->UpLinkCounter, \
                              "ABC"[mibReq.Param.Class], \
                              AppData.Port, \
@@ -838,7 +878,7 @@ static void TraceUpLinkFrame(McpsConfirm_t *mcpsConfirm)
     mibGet.Type  = MIB_CHANNELS_MASK;
     if( LoRaMacMibGetRequestConfirm( &mibGet ) == LORAMAC_STATUS_OK )
     {
-        TVL2( PRINTF( "Channel Mask ");)
+        TVL2( TPRINTF( "Channel Mask ");)
 #if defined( REGION_AS923 ) || defined( REGION_CN779 ) || \
     defined( REGION_EU868 ) || defined( REGION_IN865 ) || \
     defined( REGION_KR920 ) || defined( REGION_EU433 ) || \
@@ -855,11 +895,11 @@ static void TraceUpLinkFrame(McpsConfirm_t *mcpsConfirm)
 
 #endif
         {
-            TVL2( PRINTF( "%04X ", mibGet.Param.ChannelsMask[i] );)
+            TVL2( TPRINTF( "%04X ", mibGet.Param.ChannelsMask[i] );)
         }
     }
 
-    TVL2( PRINTF("\r\n\r\n" );)
+    TVL2( TPRINTF("\r\n\r\n" );)
 } 
 
 
@@ -867,8 +907,8 @@ static void TraceDownLinkFrame(McpsIndication_t *mcpsIndication)
 {
     const char *slotStrings[] = { "1", "2", "C", "Ping-Slot", "Multicast Ping-Slot" };
   
-    TVL2( PRINTF("\r\n" );)
-    TVL2( PRINTNOW(); PRINTF("#= D/L FRAME %lu =# RxWin %s, Port %d, data size %d, rssi %d, snr %d\r\n\r\n", \
+    TVL2( TPRINTF("\r\n" );)
+    TVL2( TPRINTNOW(); TPRINTF("#= D/L FRAME %lu =# RxWin %s, Port %d, data size %d, rssi %d, snr %d\r\n\r\n", \
                              mcpsIndication->DownLinkCounter, \
                              slotStrings[mcpsIndication->RxSlot], \
                              mcpsIndication->Port, \
@@ -893,8 +933,8 @@ static void TraceBeaconInfo(MlmeIndication_t *mlmeIndication)
         snr = ( mlmeIndication->BeaconInfo.Snr & 0xFF ) >> 2;
     }  
     
-    TVL2( PRINTF("\r\n" );)
-    TVL2( PRINTNOW(); PRINTF("#= BEACON %lu =#, GW desc %d, rssi %d, snr %ld\r\n\r\n", \
+    TVL2( TPRINTF("\r\n" );)
+    TVL2( TPRINTNOW(); TPRINTF("#= BEACON %lu =#, GW desc %d, rssi %d, snr %ld\r\n\r\n", \
                              mlmeIndication->BeaconInfo.Time, \
                              mlmeIndication->BeaconInfo.GwSpecific.InfoDesc, \
                              mlmeIndication->BeaconInfo.Rssi, \
@@ -232,6 +232,29 @@ void LORA_Join( void);
  */
 LoraFlagStatus LORA_JoinStatus( void);
 
+/**
+ * @brief Get the application payload size allowed at the current datarate
+ * @Note pending MAC commands are deducted, the size is 0 when they leave no room
+ * @param [IN] none
+ * @retval payload size in bytes
+ */
+uint8_t LORA_GetMaxPayloadSize( void );
+
+/**
+ * @brief Get the time left before the duty cycle allows an uplink
+ * @Note the time-offs of the join requests are included when not joined
+ * @param [IN] none
+ * @retval time-off in ms, 0 when an uplink can be sent now
+ */
+TimerTime_t LORA_GetTxTimeOff( void );
+
+/**
+ * @brief Set the retransmission policy of the confirmed uplinks
+ * @param [IN] policy, e.g. &RetransAdaptivePolicy, NULL for the default of the MAC
+ * @retval none
+ */
+void LORA_SetRetransPolicy( const RetransPolicy_t *policy );
+
 /**
  * @brief change Lora Class
  * @Note callback LORA_ConfirmClass informs upper layer that the change has occured
@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file    time_series.c
+  * @author  MCD Application Team
+  * @brief   Delta and varint encoded time series for uplink payloads
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "time_series.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* version, number of channels and number of samples */
+#define TS_HEADER_SIZE              3
+#define TS_NB_SAMPLES_INDEX         2
+#define TS_MAX_SAMPLES              255
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t ts_zigzag(int32_t value);
+static uint8_t ts_varint_size(uint32_t value);
+static uint8_t ts_put_varint(uint8_t *p, uint32_t value);
+
+/* Functions Definition ------------------------------------------------------*/
+bool ts_init(ts_Writer_t *ts, uint8_t *buff, uint8_t capacity, uint8_t nbChannels, uint32_t age, uint32_t period)
+{
+  uint8_t i;
+
+  ts->Buff = buff;
+  ts->Capacity = capacity;
+  ts->Size = 0;
+  ts->NbChannels = 0;
+  ts->NbSamples = 0;
+
+  if ((nbChannels == 0) || (nbChannels > TS_MAX_CHANNELS) ||
+      (capacity < (TS_HEADER_SIZE + ts_varint_size(age) + ts_varint_size(period))))
+  {
+    return false;
+  }
+
+  ts->NbChannels = nbChannels;
+  for (i = 0; i < nbChannels; i++)
+  {
+    /* the newest values are deltas from 0 */
+    ts->Previous[i] = 0;
+  }
+  buff[0] = TS_VERSION;
+  buff[1] = nbChannels;
+  buff[TS_NB_SAMPLES_INDEX] = 0;
+  ts->Size = TS_HEADER_SIZE;
+  ts->Size += ts_put_varint(&buff[ts->Size], age);
+  ts->Size += ts_put_varint(&buff[ts->Size], period);
+  return true;
+}
+
+bool ts_add_sample(ts_Writer_t *ts, const int16_t *values)
+{
+  uint16_t size = 0;
+  uint8_t i;
+
+  if ((ts->NbChannels == 0) || (ts->NbSamples == TS_MAX_SAMPLES))
+  {
+    return false;
+  }
+
+  for (i = 0; i < ts->NbChannels; i++)
+  {
+    size += ts_varint_size(ts_zigzag((int32_t)values[i] - ts->Previous[i]));
+  }
+  if ((ts->Size + size) > ts->Capacity)
+  {
+    return false;
+  }
+
+  for (i = 0; i < ts->NbChannels; i++)
+  {
+    ts->Size += ts_put_varint(&ts->Buff[ts->Size], ts_zigzag((int32_t)values[i] - ts->Previous[i]));
+    ts->Previous[i] = values[i];
+  }
+  ts->NbSamples++;
+  ts->Buff[TS_NB_SAMPLES_INDEX] = ts->NbSamples;
+  return true;
+}
+
+uint8_t ts_get_size(ts_Writer_t *ts)
+{
+  return ts->Size;
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Maps signed to unsigned values, small magnitudes to small values:
+ *         0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+ * @param  value: signed value
+ * @retval unsigned value
+ */
+static uint32_t ts_zigzag(int32_t value)
+{
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static uint8_t ts_varint_size(uint32_t value)
+{
+  uint8_t size = 1;
+
+  while (value >= 0x80)
+  {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+/**
+ * @brief  Puts a varint: 7 bits per byte, least significant first, the most
+ *         significant bit set on all the bytes but the last one
+ * @param  p: destination, 5 bytes at most
+ * @param  value: value
+ * @retval Number of bytes written
+ */
+static uint8_t ts_put_varint(uint8_t *p, uint32_t value)
+{
+  uint8_t size = 0;
+
+  while (value >= 0x80)
+  {
+    p[size++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  p[size++] = value;
+  return size;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
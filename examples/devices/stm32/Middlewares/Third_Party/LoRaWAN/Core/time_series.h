@@ -0,0 +1,101 @@
+/**
+  ******************************************************************************
+  * @file    time_series.h
+  * @author  MCD Application Team
+  * @brief   Header for time_series.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TIME_SERIES_H__
+#define __TIME_SERIES_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Format version, as decoded by the agent (lib/dataModels/timeSeries.js) */
+#define TS_VERSION                  1
+
+/* Maximum number of channels of a series */
+#ifndef TS_MAX_CHANNELS
+#define TS_MAX_CHANNELS             8
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/*!
+ * Time series writer. The payload is:
+ *   version, number of channels, number of samples   1 byte each
+ *   age of the newest sample in ms                   varint
+ *   sampling period in ms                            varint
+ *   samples, newest first, one value per channel     zig-zag varint
+ * The values of the newest sample are sent as such, the following ones as the
+ * difference with the sample before them, i.e. one period more recent.
+ */
+typedef struct
+{
+  /*points to the application data buffer*/
+  uint8_t *Buff;
+  /*size of Buff, or less to fit the payload allowed at the current DR*/
+  uint8_t Capacity;
+  /*encoded size*/
+  uint8_t Size;
+  uint8_t NbChannels;
+  uint8_t NbSamples;
+  /*values of the last sample added*/
+  int16_t Previous[TS_MAX_CHANNELS];
+} ts_Writer_t;
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes a writer and puts the header of the series
+ * @param  ts: writer to initialize
+ * @param  buff: output buffer, usually the application data buffer
+ * @param  capacity: size of buff, e.g. limited to LORA_GetMaxPayloadSize
+ * @param  nbChannels: number of values per sample, up to TS_MAX_CHANNELS
+ * @param  age: time elapsed since the newest sample in ms
+ * @param  period: sampling period in ms
+ * @retval false when the header does not fit or nbChannels is out of range
+ */
+bool ts_init(ts_Writer_t *ts, uint8_t *buff, uint8_t capacity, uint8_t nbChannels, uint32_t age, uint32_t period);
+
+/**
+ * @brief  Appends a sample, one period older than the previous one
+ * @param  ts: writer
+ * @param  values: one value per channel
+ * @retval false, leaving the writer untouched, when the sample does not fit
+ */
+bool ts_add_sample(ts_Writer_t *ts, const int16_t *values);
+
+/**
+ * @brief  Returns the encoded size
+ * @param  ts: writer
+ * @retval Size in bytes
+ */
+uint8_t ts_get_size(ts_Writer_t *ts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIME_SERIES_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -46,13 +46,7 @@ DEALINGS WITH THE SOFTWARE
             (r)[15] = (v)[15] << 1;                                 \
     } while (0)
     
-#define XOR(v, r) do {                                          \
-            int32_t i;                                                  \
-            for (i = 0; i < 16; i++)     \
-        {   \
-                    (r)[i] = (r)[i] ^ (v)[i]; \
-        }                          \
-    } while (0) \
+#define XOR(v, r) memxor16((r), (v))
 
 
 void AES_CMAC_Init(AES_CMAC_CTX *ctx)
@@ -71,7 +65,7 @@ void AES_CMAC_SetKey(AES_CMAC_CTX *ctx, const uint8_t key[AES_CMAC_KEY_LENGTH])
 void AES_CMAC_Update(AES_CMAC_CTX *ctx, const uint8_t *data, uint32_t len)
 {
             uint32_t mlen;
-        uint8_t in[16];
+        uint8_t in[16] ALIGN(4);
     
             if (ctx->M_n > 0) {
                   mlen = MIN(16 - ctx->M_n, len);
@@ -90,9 +84,9 @@ void AES_CMAC_Update(AES_CMAC_CTX *ctx, const uint8_t *data, uint32_t len)
                     XOR(data, ctx->X);
                     //rijndael_encrypt(&ctx->rijndael, ctx->X, ctx->X);
 
-                    memcpy1(in, &ctx->X[0], 16); //Bestela ez du ondo iten
+                    memcpy16(in, &ctx->X[0]); //Bestela ez du ondo iten
             aes_encrypt( in, in, &ctx->rijndael);
-                    memcpy1(&ctx->X[0], in, 16);
+                    memcpy16(&ctx->X[0], in);
 
                     data += 16;
                     len -= 16;
@@ -104,8 +98,8 @@ void AES_CMAC_Update(AES_CMAC_CTX *ctx, const uint8_t *data, uint32_t len)
    
 void AES_CMAC_Final(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX *ctx)
 {
-            uint8_t K[16];
-        uint8_t in[16];
+            uint8_t K[16] ALIGN(4);
+        uint8_t in[16] ALIGN(4);
             /* generate subkey K1 */
             memset1(K, '\0', 16);
 
@@ -145,7 +139,7 @@ void AES_CMAC_Final(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX *ctx)
 
            //rijndael_encrypt(&ctx->rijndael, ctx->X, digest);
 
-       memcpy1(in, &ctx->X[0], 16); //Bestela ez du ondo iten
+       memcpy16(in, &ctx->X[0]); //Bestela ez du ondo iten
        aes_encrypt(in, digest, &ctx->rijndael);
            memset1(K, 0, sizeof K);
 
@@ -41,11 +41,13 @@ DEALINGS WITH THE SOFTWARE
 #define AES_CMAC_KEY_LENGTH     16
 #define AES_CMAC_DIGEST_LENGTH  16
  
+/* X and M_last lead the structure so that they stay word aligned
+   (aes_context is 241 bytes long) and the block helpers take the word path */
 typedef struct _AES_CMAC_CTX {
-            aes_context    rijndael;
             uint8_t        X[16];
             uint8_t        M_last[16];
             uint32_t       M_n;
+            aes_context    rijndael;
     } AES_CMAC_CTX;
    
 //#include <sys/cdefs.h>
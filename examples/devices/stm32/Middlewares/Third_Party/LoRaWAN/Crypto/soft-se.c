@@ -29,7 +29,10 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
 #include "cmac.h"
 #include "radio.h"
 
-#define NUM_OF_KEYS      22
+/*
+ * Unicast keys, MC_KE_KEY, three keys per multicast group and SLOT_RAND_ZERO_KEY
+ */
+#define NUM_OF_KEYS      ( 9 + ( 3 * LORAMAC_MAX_MC_CTX ) + 1 )
 #define KEY_SIZE         16
 
 /*!
@@ -137,6 +140,20 @@ SecureElementStatus_t ComputeCmac( uint8_t* buffer, uint16_t size, KeyIdentifier
     return retval;
 }
 
+/*
+ * Checks if the key is the root key of a multicast group. Root keys are
+ * provisioned encrypted with the MC_KE_KEY, the session keys derived from
+ * them and SLOT_RAND_ZERO_KEY are stored as is.
+ *
+ * \param[IN]  keyID          - Key identifier
+ * \retval                    - true for MC_KEY( 0 ) to MC_KEY( LORAMAC_MAX_MC_CTX - 1 )
+ */
+static bool IsMcRootKey( KeyIdentifier_t keyID )
+{
+    return ( keyID >= MC_KEY_0 ) && ( keyID <= MC_NWK_S_KEY_LAST ) &&
+           ( ( ( keyID - MC_KEY_0 ) % 3 ) == 0 );
+}
+
 /*
  * Dummy callback in case if the user provides NULL function pointer
  */
@@ -162,18 +179,12 @@ SecureElementStatus_t SecureElementInit( EventNvmCtxChanged seNvmCtxChanged )
     SeNvmCtx.KeyList[itr++].KeyID = NWK_S_ENC_KEY;
     SeNvmCtx.KeyList[itr++].KeyID = APP_S_KEY;
     SeNvmCtx.KeyList[itr++].KeyID = MC_KE_KEY;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_KEY_0;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_APP_S_KEY_0;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_NWK_S_KEY_0;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_KEY_1;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_APP_S_KEY_1;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_NWK_S_KEY_1;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_KEY_2;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_APP_S_KEY_2;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_NWK_S_KEY_2;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_KEY_3;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_APP_S_KEY_3;
-    SeNvmCtx.KeyList[itr++].KeyID = MC_NWK_S_KEY_3;
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        SeNvmCtx.KeyList[itr++].KeyID = MC_KEY( i );
+        SeNvmCtx.KeyList[itr++].KeyID = MC_APP_S_KEY( i );
+        SeNvmCtx.KeyList[itr++].KeyID = MC_NWK_S_KEY( i );
+    }
     SeNvmCtx.KeyList[itr++].KeyID = SLOT_RAND_ZERO_KEY;
 
     // Assign callback
@@ -221,8 +232,8 @@ SecureElementStatus_t SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
     {
         if( SeNvmCtx.KeyList[i].KeyID == keyID )
         {
-            if( LORAMAC_CRYPTO_MULITCAST_KEYS < SeNvmCtx.KeyList[i].KeyID )
-            {  // Decrypt the key if its a Mulitcast key
+            if( IsMcRootKey( keyID ) == true )
+            {  // Decrypt the key if its a Mulitcast root key
 
                 uint8_t decryptedKey[16] = { 0 };
 
@@ -231,6 +242,9 @@ SecureElementStatus_t SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
                 {
                     return retval;
                 }
+                memcpy1( SeNvmCtx.KeyList[i].KeyValue, decryptedKey, KEY_SIZE );
+                SeNvmCtxChanged( );
+                return SECURE_ELEMENT_SUCCESS;
             }
             else
             {
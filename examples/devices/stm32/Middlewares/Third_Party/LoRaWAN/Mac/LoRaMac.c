@@ -46,6 +46,7 @@
 #include "LoRaMacAdr.h"
 
 #include "LoRaMac.h"
+#include "latency_stats.h"
 #include "util_console.h"
 
 /*!
@@ -78,6 +79,21 @@
  */
 #define BACKOFF_DC_24_HOURS                         10000
 
+/*!
+ * Number of buckets of the multicast address lookup table. Power of two and
+ * at least twice LORAMAC_MAX_MC_CTX to keep the probe sequences short.
+ */
+#if ( LORAMAC_MAX_MC_CTX <= 4 )
+#define LORAMAC_MC_LOOKUP_BITS                      3
+#elif ( LORAMAC_MAX_MC_CTX <= 8 )
+#define LORAMAC_MC_LOOKUP_BITS                      4
+#elif ( LORAMAC_MAX_MC_CTX <= 16 )
+#define LORAMAC_MC_LOOKUP_BITS                      5
+#else
+#define LORAMAC_MC_LOOKUP_BITS                      6
+#endif
+#define LORAMAC_MC_LOOKUP_SIZE                      ( 1 << LORAMAC_MC_LOOKUP_BITS )
+
 /*!
  * LoRaMac internal states
  */
@@ -324,6 +340,14 @@ typedef struct sLoRaMacCtx
     */
     TimerEvent_t AckTimeoutTimer;
     /*
+    * Retransmission policy of the confirmed uplinks, NULL for the default
+    */
+    const RetransPolicy_t* RetransPolicy;
+    /*
+    * Time of the MCPS request of the confirmed uplink in progress
+    */
+    TimerTime_t McpsRequestTime;
+    /*
     * Last transmission time on air
     */
     TimerTime_t TxTimeOnAir;
@@ -356,6 +380,15 @@ typedef struct sLoRaMacCtx
     */
     LoRaMacRequestHandling_t AllowRequests;
     /*
+    * Open-addressed lookup table on the multicast DevAddr. Each bucket holds
+    * the MulticastChannelList index plus one, 0 marks an empty bucket.
+    */
+    uint8_t MulticastLookup[LORAMAC_MC_LOOKUP_SIZE];
+    /*
+    * Received frames dropped per stage of the receive pipeline
+    */
+    RxDropStats_t RxDropStats;
+    /*
     * Non-volatile module context structure
     */
     LoRaMacNvmCtx_t* NvmCtx;
@@ -576,6 +609,29 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh );
  */
 static void CalculateBackOff( uint8_t channel );
 
+/*
+ * \brief Fills the parameters of the back-off of the last uplink
+ *
+ * \param [OUT] calcBackOff Parameters of RegionCalcBackOff
+ * \param [IN]  channel     Channel of the last uplink
+ */
+static void GetCalcBackOffParams( CalcBackOffParams_t* calcBackOff, uint8_t channel );
+
+/*
+ * \brief Fills the parameters of the channel selection
+ *
+ * \param [OUT] nextChan  Parameters of RegionNextChannel
+ */
+static void GetNextChanParams( NextChanParams_t* nextChan );
+
+/*
+ * \brief Computes the time left before the duty cycle allows a transmission,
+ *        without updating the duty cycle state nor drawing a channel
+ *
+ * \retval Time-off in ms, 0 when a channel is available now
+ */
+static TimerTime_t GetTxTimeOff( void );
+
 /*
  * \brief Function to remove pending MAC commands
  *
@@ -649,6 +705,22 @@ LoRaMacCtxs_t* GetCtxs( void );
  */
 LoRaMacStatus_t RestoreCtxs( LoRaMacCtxs_t* contexts );
 
+/*!
+ * \brief   Rebuilds the multicast address lookup table from the enabled
+ *          entries of the multicast channel list
+ */
+static void RebuildMulticastLookup( void );
+
+/*!
+ * \brief   Looks up an enabled multicast channel by its address
+ *
+ * \param [IN] address Device address of the received frame
+ *
+ * \retval  Pointer to the multicast context, NULL if the address does not
+ *          belong to an enabled multicast group
+ */
+static MulticastCtx_t* FindMulticastChannel( uint32_t address );
+
 /*!
  * \brief   Determines the frame type
  *
@@ -688,7 +760,7 @@ static bool StopRetransmission( void );
  * \brief Handles the ACK retries algorithm.
  *        Increments the re-tries counter up until the specified number of
  *        trials or the allowed maximum. Decrease the uplink datarate every 2
- *        trials.
+ *        trials, or as the retransmission policy decides.
  */
 static void AckTimeoutRetriesProcess( void );
 
@@ -698,6 +770,37 @@ static void AckTimeoutRetriesProcess( void );
  */
 static void AckTimeoutRetriesFinalize( void );
 
+/*!
+ * \brief Returns the trials of a confirmed uplink, from the retransmission
+ *        policy if any
+ *
+ * \param [IN] nbTrials Trials requested by the application
+ *
+ * \retval Trials, from 1 to MAX_ACK_RETRIES
+ */
+static uint8_t GetRetransNbTrials( uint8_t nbTrials );
+
+/*!
+ * \brief Checks if the retransmission policy abandons the confirmed uplink
+ *
+ * \retval Returns true if it should be stopped.
+ */
+static bool CheckRetransStale( void );
+
+/*!
+ * \brief Checks if the retransmission of a confirmed uplink lowers the
+ *        datarate, every 2 trials unless the retransmission policy decides
+ *
+ * \retval Returns true to use the next lower datarate.
+ */
+static bool CheckRetransStepDownDr( void );
+
+/*!
+ * \brief Sends the same frame again, after the back-off of the retransmission
+ *        policy for confirmed uplinks
+ */
+static void RetransmitFrame( void );
+
 /*!
  * \brief Calls the callback to indicate that a context changed
  */
@@ -835,6 +938,9 @@ static void OnRadioTxDone( void )
 
 static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
 {
+    EnergyStop( ENERGY_RX_WINDOW );
+    EnergyStop( ENERGY_BEACON );
+
     RxDoneParams.LastRxDone = TimerGetCurrentTime( );
     RxDoneParams.Payload = payload;
     RxDoneParams.Size = size;
@@ -867,6 +973,9 @@ static void OnRadioTxTimeout( void )
 
 static void OnRadioRxError( void )
 {
+    EnergyStop( ENERGY_RX_WINDOW );
+    EnergyStop( ENERGY_BEACON );
+
     LoRaMacRadioEvents.Events.RxError = 1;
 
     if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->MacProcessNotify != NULL ) )
@@ -877,6 +986,9 @@ static void OnRadioRxError( void )
 
 static void OnRadioRxTimeout( void )
 {
+    EnergyStop( ENERGY_RX_WINDOW );
+    EnergyStop( ENERGY_BEACON );
+
     LoRaMacRadioEvents.Events.RxTimeout = 1;
 
     if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->MacProcessNotify != NULL ) )
@@ -1022,8 +1134,26 @@ static void ProcessRadioRxDone( void )
         }
     }
 
+    // Stage 1: MAC header and length. Only downlink frame types of the
+    // LoRaWAN R1 major version are accepted.
+    if( size < LORAMAC_MHDR_FIELD_SIZE )
+    {
+        MacCtx.RxDropStats.Header++;
+        MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
+        PrepareRxDoneAbort( );
+        return;
+    }
+
     macHdr.Value = payload[pktHeaderLen++];
 
+    if( macHdr.Bits.Major != 0 )
+    {
+        MacCtx.RxDropStats.Header++;
+        MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
+        PrepareRxDoneAbort( );
+        return;
+    }
+
     switch( macHdr.Bits.MType )
     {
         case FRAME_TYPE_JOIN_ACCEPT:
@@ -1103,12 +1233,48 @@ static void ProcessRadioRxDone( void )
                 getPhy.Attribute = PHY_MAX_PAYLOAD_REPEATER;
             }
             phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
-            if( MAX( 0, ( int16_t )( ( int16_t ) size - ( int16_t ) LORA_MAC_FRMPAYLOAD_OVERHEAD ) ) > ( int16_t )phyParam.Value )
+            if( ( size < ( LORAMAC_MHDR_FIELD_SIZE + LORAMAC_FHDR_MIN_FIELD_SIZE + LORAMAC_MIC_FIELD_SIZE ) ) ||
+                ( MAX( 0, ( int16_t )( ( int16_t ) size - ( int16_t ) LORA_MAC_FRMPAYLOAD_OVERHEAD ) ) > ( int16_t )phyParam.Value ) )
             {
+                MacCtx.RxDropStats.Header++;
                 MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
                 PrepareRxDoneAbort( );
                 return;
             }
+
+            // Stage 2: address filter on the raw buffer. Frames of other devices
+            // are dropped before they are parsed and before any crypto runs.
+            uint32_t rxDevAddr = ( uint32_t )payload[pktHeaderLen];
+            rxDevAddr |= ( ( uint32_t )payload[pktHeaderLen + 1] << 8 );
+            rxDevAddr |= ( ( uint32_t )payload[pktHeaderLen + 2] << 16 );
+            rxDevAddr |= ( ( uint32_t )payload[pktHeaderLen + 3] << 24 );
+
+            multicast = 0;
+            downLinkCounter = 0;
+            MulticastCtx_t* mcChannel = FindMulticastChannel( rxDevAddr );
+            if( mcChannel != NULL )
+            {
+                multicast = 1;
+                addrID = mcChannel->AddrID;
+                downLinkCounter = *( mcChannel->DownLinkCounter );
+                address = mcChannel->Address;
+            }
+            else if( rxDevAddr != address )
+            {
+                // We are not the destination of this frame.
+                MacCtx.RxDropStats.Address++;
+                MacCtx.McpsIndication.DevAddress = rxDevAddr;
+                MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ADDRESS_FAIL;
+
+                // Abort the reception, if we are not in RX_SLOT_WIN_CLASS_C
+                if( MacCtx.McpsIndication.RxSlot != RX_SLOT_WIN_CLASS_C )
+                {
+                    PrepareRxDoneAbort( );
+                }
+                return;
+            }
+
+            // Stage 3: full parsing
             macMsgData.Buffer = payload;
             macMsgData.BufSize = size;
             macMsgData.FRMPayload = MacCtx.RxPayload;
@@ -1116,6 +1282,7 @@ static void ProcessRadioRxDone( void )
 
             if( LORAMAC_PARSER_SUCCESS != LoRaMacParserData( &macMsgData ) )
             {
+                MacCtx.RxDropStats.Parser++;
                 MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
                 PrepareRxDoneAbort( );
                 return;
@@ -1127,27 +1294,13 @@ static void ProcessRadioRxDone( void )
             FType_t fType;
             if( LORAMAC_STATUS_OK != DetermineFrameType( &macMsgData, &fType ) )
             {
+                MacCtx.RxDropStats.Parser++;
                 MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
                 PrepareRxDoneAbort( );
                 return;
             }
 
-            //Check if it is a multicast message
-            multicast = 0;
-            downLinkCounter = 0;
-            for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
-            {
-                if( ( MacCtx.NvmCtx->MulticastChannelList[i].Address == macMsgData.FHDR.DevAddr ) &&
-                    ( MacCtx.NvmCtx->MulticastChannelList[i].IsEnabled == true ) )
-                {
-                    multicast = 1;
-                    addrID = MacCtx.NvmCtx->MulticastChannelList[i].AddrID;
-                    downLinkCounter = *( MacCtx.NvmCtx->MulticastChannelList[i].DownLinkCounter );
-                    address = MacCtx.NvmCtx->MulticastChannelList[i].Address;
-                    break;
-                }
-            }
-
+            // Stage 4: frame counter and MIC
             // Get maximum allowed counter difference
             getPhy.Attribute = PHY_MAX_FCNT_GAP;
             phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
@@ -1156,6 +1309,7 @@ static void ProcessRadioRxDone( void )
             fCntHandlerStatus = LoRaMacGetFCntDown( addrID, fType, &macMsgData, MacCtx.NvmCtx->Version, phyParam.Value, &fCntID, &downLinkCounter );
             if( fCntHandlerStatus != LORAMAC_FCNT_HANDLER_SUCCESS )
             {
+                MacCtx.RxDropStats.FCnt++;
                 if( fCntHandlerStatus == LORAMAC_FCNT_HANDLER_CHECK_FAIL )
                 {
                     // Catch the case of repeated downlink frame counter
@@ -1183,6 +1337,7 @@ static void ProcessRadioRxDone( void )
             macCryptoStatus = LoRaMacCryptoUnsecureMessage( addrID, address, fCntID, downLinkCounter, &macMsgData );
             if( macCryptoStatus != LORAMAC_CRYPTO_SUCCESS )
             {
+                MacCtx.RxDropStats.Mic++;
                 if( macCryptoStatus == LORAMAC_CRYPTO_FAIL_ADDRESS )
                 {
                     // We are not the destination of this frame.
@@ -1331,6 +1486,7 @@ static void ProcessRadioRxDone( void )
             MacCtx.MacFlags.Bits.McpsInd = 1;
             break;
         default:
+            MacCtx.RxDropStats.Header++;
             MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
             PrepareRxDoneAbort( );
             break;
@@ -1516,6 +1672,13 @@ static void LoRaMacHandleRequestEvents( void )
         // Handle callbacks
         if( reqEvents.Bits.McpsReq == 1 )
         {
+            // The uplink, its retransmissions and Rx windows are over
+            MacCtx.McpsConfirm.Energy = EnergyStop( ENERGY_UPLINK );
+            if( ( MacCtx.McpsConfirm.McpsRequest == MCPS_CONFIRMED ) &&
+                ( MacCtx.RetransPolicy != NULL ) && ( MacCtx.RetransPolicy->OnResult != NULL ) )
+            {
+                MacCtx.RetransPolicy->OnResult( MacCtx.McpsConfirm.AckReceived, MacCtx.McpsConfirm.NbRetries );
+            }
             MacCtx.MacPrimitives->MacMcpsConfirm( &MacCtx.McpsConfirm );
         }
 
@@ -1592,7 +1755,13 @@ static void LoRaMacHandleMcpsRequest( void )
             {
                 stopRetransmission = CheckRetransConfirmedUplink( );
 
-                if( MacCtx.NvmCtx->Version.Fields.Minor == 0 )
+                if( ( stopRetransmission == false ) && ( CheckRetransStale( ) == true ) )
+                {// The policy gives up the frame, fresher data waits
+                    MacCtx.McpsConfirm.Abandoned = true;
+                    MacCtx.McpsConfirm.NbRetries = MacCtx.NvmCtx->AckTimeoutRetriesCounter;
+                    stopRetransmission = true;
+                }
+                else if( MacCtx.NvmCtx->Version.Fields.Minor == 0 )
                 {
                     if( stopRetransmission == false )
                     {
@@ -1620,7 +1789,7 @@ static void LoRaMacHandleMcpsRequest( void )
             // Reset the state of the AckTimeout
             MacCtx.NvmCtx->AckTimeoutRetry = false;
             // Sends the same frame again
-            OnTxDelayedTimerEvent( NULL );
+            RetransmitFrame( );
         }
     }
 }
@@ -1682,6 +1851,7 @@ static void LoRaMacCheckForRxAbort( void )
 void LoRaMacProcess( void )
 {
     uint8_t noTx = false;
+    LATENCY_START( );
 
     LoRaMacHandleIrqEvents( );
     LoRaMacClassBProcess( );
@@ -1708,6 +1878,8 @@ void LoRaMacProcess( void )
         LoRaMacEnableRequests( LORAMAC_REQUEST_HANDLING_ON );
     }
     LoRaMacHandleIndicationEvents( );
+
+    LATENCY_STOP( LATENCY_MAC_PROCESS );
 }
 
 static void OnTxDelayedTimerEvent( void* context )
@@ -1827,6 +1999,8 @@ static void OnAckTimeoutTimerEvent( void* context )
 
 static void RxWindowSetup( bool rxContinuous, uint32_t maxRxWindow )
 {
+    EnergyStart( ENERGY_RX_WINDOW );
+
     if( rxContinuous == false )
     {
         Radio.Rx( maxRxWindow );
@@ -2378,18 +2552,7 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     // Update back-off
     CalculateBackOff( MacCtx.NvmCtx->LastTxChannel );
 
-    nextChan.AggrTimeOff = MacCtx.AggregatedTimeOff;
-    nextChan.Datarate = MacCtx.NvmCtx->MacParams.ChannelsDatarate;
-    nextChan.DutyCycleEnabled = MacCtx.NvmCtx->DutyCycleOn;
-    if( MacCtx.NvmCtx->NetworkActivation == ACTIVATION_TYPE_NONE )
-    {
-        nextChan.Joined = false;
-    }
-    else
-    {
-        nextChan.Joined = true;
-    }
-    nextChan.LastAggrTx = MacCtx.AggregatedLastTxDoneTime;
+    GetNextChanParams( &nextChan );
 
     // Select channel
     status = RegionNextChannel( MacCtx.NvmCtx->Region, &nextChan, &MacCtx.NvmCtx->Channel, &dutyCycleTimeOff, &MacCtx.AggregatedTimeOff );
@@ -2500,30 +2663,64 @@ static void CalculateBackOff( uint8_t channel )
 {
     CalcBackOffParams_t calcBackOff;
 
+    GetCalcBackOffParams( &calcBackOff, channel );
+
+    // Update regional back-off
+    RegionCalcBackOff( MacCtx.NvmCtx->Region, &calcBackOff );
+
+    // Update aggregated time-off. This must be an assignment and no incremental
+    // update as we do only calculate the time-off based on the last transmission
+    MacCtx.AggregatedTimeOff = ( MacCtx.TxTimeOnAir * MacCtx.NvmCtx->AggregatedDCycle - MacCtx.TxTimeOnAir );
+}
+
+static void GetCalcBackOffParams( CalcBackOffParams_t* calcBackOff, uint8_t channel )
+{
     if( MacCtx.NvmCtx->NetworkActivation == ACTIVATION_TYPE_NONE )
     {
-        calcBackOff.Joined = false;
+        calcBackOff->Joined = false;
     }
     else
     {
-        calcBackOff.Joined = true;
+        calcBackOff->Joined = true;
     }
-    calcBackOff.DutyCycleEnabled = MacCtx.NvmCtx->DutyCycleOn;
-    calcBackOff.Channel = channel;
-    calcBackOff.ElapsedTime = TimerGetElapsedTime( MacCtx.InitializationTime );
-    calcBackOff.TxTimeOnAir = MacCtx.TxTimeOnAir;
-    calcBackOff.LastTxIsJoinRequest = false;
+    calcBackOff->DutyCycleEnabled = MacCtx.NvmCtx->DutyCycleOn;
+    calcBackOff->Channel = channel;
+    calcBackOff->ElapsedTime = TimerGetElapsedTime( MacCtx.InitializationTime );
+    calcBackOff->TxTimeOnAir = MacCtx.TxTimeOnAir;
+    calcBackOff->LastTxIsJoinRequest = false;
     if( ( MacCtx.MacFlags.Bits.MlmeReq == 1 ) && ( LoRaMacConfirmQueueIsCmdActive( MLME_JOIN ) == true ) )
     {
-        calcBackOff.LastTxIsJoinRequest = true;
+        calcBackOff->LastTxIsJoinRequest = true;
     }
+}
 
-    // Update regional back-off
-    RegionCalcBackOff( MacCtx.NvmCtx->Region, &calcBackOff );
+static void GetNextChanParams( NextChanParams_t* nextChan )
+{
+    nextChan->AggrTimeOff = MacCtx.AggregatedTimeOff;
+    nextChan->Datarate = MacCtx.NvmCtx->MacParams.ChannelsDatarate;
+    nextChan->DutyCycleEnabled = MacCtx.NvmCtx->DutyCycleOn;
+    if( MacCtx.NvmCtx->NetworkActivation == ACTIVATION_TYPE_NONE )
+    {
+        nextChan->Joined = false;
+    }
+    else
+    {
+        nextChan->Joined = true;
+    }
+    nextChan->LastAggrTx = MacCtx.AggregatedLastTxDoneTime;
+}
 
-    // Update aggregated time-off. This must be an assignment and no incremental
-    // update as we do only calculate the time-off based on the last transmission
-    MacCtx.AggregatedTimeOff = ( MacCtx.TxTimeOnAir * MacCtx.NvmCtx->AggregatedDCycle - MacCtx.TxTimeOnAir );
+static TimerTime_t GetTxTimeOff( void )
+{
+    GetTxTimeOffParams_t txTimeOff;
+
+    // Same back-off as the next ScheduleTx, computed by the region on
+    // copies of its bands and channel mask
+    GetCalcBackOffParams( &txTimeOff.CalcBackOff, MacCtx.NvmCtx->LastTxChannel );
+    GetNextChanParams( &txTimeOff.NextChan );
+    txTimeOff.NextChan.AggrTimeOff = ( MacCtx.TxTimeOnAir * MacCtx.NvmCtx->AggregatedDCycle - MacCtx.TxTimeOnAir );
+
+    return RegionGetTxTimeOff( MacCtx.NvmCtx->Region, &txTimeOff );
 }
 
 static void RemoveMacCommands( LoRaMacRxSlot_t rxSlot, LoRaMacFrameCtrl_t fCtrl, Mcps_t request )
@@ -2759,6 +2956,14 @@ LoRaMacStatus_t SendFrameOnChannel( uint8_t channel )
 
     MacCtx.MacState |= LORAMAC_TX_RUNNING;
 
+    // Retransmissions stay in the account opened by the first transmission,
+    // join requests are not accounted as uplinks
+    if( MacCtx.TxMsg.Type != LORAMAC_MSG_TYPE_JOIN_REQUEST )
+    {
+        EnergyStart( ENERGY_UPLINK );
+    }
+    MacCtx.McpsConfirm.TotalTimeOnAir += MacCtx.TxTimeOnAir;
+
     // Send now
     Radio.Send( MacCtx.PktBuffer, MacCtx.PktBufferLen );
 
@@ -2859,9 +3064,59 @@ LoRaMacStatus_t RestoreCtxs( LoRaMacCtxs_t* contexts )
         return LORAMAC_STATUS_CONFIRM_QUEUE_ERROR;
     }
 
+    // The restored downlink counter references may point to a previous image
+    LoRaMacFCntHandlerSetMulticastReference( MacCtx.NvmCtx->MulticastChannelList );
+    RebuildMulticastLookup( );
+
     return LORAMAC_STATUS_OK;
 }
 
+static uint8_t MulticastLookupHash( uint32_t address )
+{
+    // Multiplicative hashing on 32 bits, whatever the width of long: the
+    // top LORAMAC_MC_LOOKUP_BITS bits of the product are the best mixed ones
+    return ( uint8_t )( ( uint32_t )( address * 2654435761u ) >> ( 32 - LORAMAC_MC_LOOKUP_BITS ) );
+}
+
+static void RebuildMulticastLookup( void )
+{
+    memset1( MacCtx.MulticastLookup, 0, sizeof( MacCtx.MulticastLookup ) );
+
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        if( MacCtx.NvmCtx->MulticastChannelList[i].IsEnabled == false )
+        {
+            continue;
+        }
+        uint8_t bucket = MulticastLookupHash( MacCtx.NvmCtx->MulticastChannelList[i].Address );
+
+        // Linear probing. The table is at least twice as large as the list,
+        // hence a free bucket always exists.
+        while( MacCtx.MulticastLookup[bucket] != 0 )
+        {
+            bucket = ( bucket + 1 ) & ( LORAMAC_MC_LOOKUP_SIZE - 1 );
+        }
+        MacCtx.MulticastLookup[bucket] = i + 1;
+    }
+}
+
+static MulticastCtx_t* FindMulticastChannel( uint32_t address )
+{
+    uint8_t bucket = MulticastLookupHash( address );
+
+    while( MacCtx.MulticastLookup[bucket] != 0 )
+    {
+        MulticastCtx_t* mcChannel = &MacCtx.NvmCtx->MulticastChannelList[MacCtx.MulticastLookup[bucket] - 1];
+
+        if( mcChannel->Address == address )
+        {
+            return mcChannel;
+        }
+        bucket = ( bucket + 1 ) & ( LORAMAC_MC_LOOKUP_SIZE - 1 );
+    }
+    return NULL;
+}
+
 LoRaMacStatus_t DetermineFrameType( LoRaMacMessageData_t* macMsg, FType_t* fType )
 {
     if( ( macMsg == NULL ) || ( fType == NULL ) )
@@ -2994,7 +3249,7 @@ static void AckTimeoutRetriesProcess( void )
     if( ( MacCtx.NvmCtx->AckTimeoutRetriesCounter < MacCtx.NvmCtx->AckTimeoutRetries ) && ( MacCtx.NvmCtx->AckTimeoutRetriesCounter <= MAX_ACK_RETRIES ) )
     {
         MacCtx.NvmCtx->AckTimeoutRetriesCounter++;
-        if( ( MacCtx.NvmCtx->AckTimeoutRetriesCounter % 2 ) == 1 )
+        if( CheckRetransStepDownDr( ) == true )
         {
             GetPhyParams_t getPhy;
             PhyParam_t phyParam;
@@ -3023,6 +3278,57 @@ static void AckTimeoutRetriesFinalize( void )
     MacCtx.McpsConfirm.NbRetries = MacCtx.NvmCtx->AckTimeoutRetriesCounter;
 }
 
+static uint8_t GetRetransNbTrials( uint8_t nbTrials )
+{
+    if( ( MacCtx.RetransPolicy != NULL ) && ( MacCtx.RetransPolicy->GetNbTrials != NULL ) )
+    {
+        nbTrials = MacCtx.RetransPolicy->GetNbTrials( nbTrials );
+    }
+    // AckTimeoutRetriesProcess stops counting past MAX_ACK_RETRIES
+    return MIN( MAX( nbTrials, 1 ), MAX_ACK_RETRIES );
+}
+
+static bool CheckRetransStepDownDr( void )
+{
+    if( ( MacCtx.RetransPolicy == NULL ) || ( MacCtx.RetransPolicy->StepDownDatarate == NULL ) )
+    {
+        return ( MacCtx.NvmCtx->AckTimeoutRetriesCounter % 2 ) == 1;
+    }
+    return MacCtx.RetransPolicy->StepDownDatarate( MacCtx.NvmCtx->AckTimeoutRetriesCounter - 1 );
+}
+
+static bool CheckRetransStale( void )
+{
+    if( ( MacCtx.RetransPolicy == NULL ) || ( MacCtx.RetransPolicy->IsStale == NULL ) )
+    {
+        return false;
+    }
+    return MacCtx.RetransPolicy->IsStale( TimerGetElapsedTime( MacCtx.McpsRequestTime ) );
+}
+
+static void RetransmitFrame( void )
+{
+    TimerTime_t backoff = 0;
+
+    if( ( MacCtx.McpsConfirm.McpsRequest == MCPS_CONFIRMED ) &&
+        ( MacCtx.RetransPolicy != NULL ) && ( MacCtx.RetransPolicy->GetBackoff != NULL ) )
+    {
+        backoff = MacCtx.RetransPolicy->GetBackoff( MacCtx.NvmCtx->AckTimeoutRetriesCounter - 1 );
+    }
+
+    if( backoff == 0 )
+    {
+        OnTxDelayedTimerEvent( NULL );
+    }
+    else
+    {// Send later, the duty cycle is checked then
+        MacCtx.McpsConfirm.BackoffTime += backoff;
+        MacCtx.MacState |= LORAMAC_TX_DELAYED;
+        TimerSetValue( &MacCtx.TxDelayedTimer, backoff );
+        TimerStart( &MacCtx.TxDelayedTimer );
+    }
+}
+
 static void CallNvmCtxCallback( LoRaMacNvmCtxModule_t module )
 {
     if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->NvmContextChange != NULL ) )
@@ -3272,8 +3578,13 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
         return LORAMAC_STATUS_FCNT_HANDLER_ERROR;
     }
 
-    // Set multicast downlink counter reference
+    // Set multicast address identifiers and downlink counter reference
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        MacCtx.NvmCtx->MulticastChannelList[i].AddrID = ( AddressIdentifier_t )i;
+    }
     LoRaMacFCntHandlerSetMulticastReference( MacCtx.NvmCtx->MulticastChannelList );
+    RebuildMulticastLookup( );
 
     // Random seed initialization
     srand1( Radio.Random( ) );
@@ -3543,6 +3854,31 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
             mibGet->Param.DefaultAntennaGain = MacCtx.NvmCtx->MacParamsDefaults.AntennaGain;
             break;
         }
+        case MIB_RX_DROP_STATS:
+        {
+            mibGet->Param.RxDropStats = MacCtx.RxDropStats;
+            break;
+        }
+        case MIB_LATENCY_STATS:
+        {
+            mibGet->Param.LatencyStats = LatencyGetStats( );
+            break;
+        }
+        case MIB_ENERGY_STATS:
+        {
+            EnergyGetStats( &mibGet->Param.EnergyStats );
+            break;
+        }
+        case MIB_TX_TIME_OFF:
+        {
+            mibGet->Param.TxTimeOff = GetTxTimeOff( );
+            break;
+        }
+        case MIB_RETRANS_POLICY:
+        {
+            mibGet->Param.RetransPolicy = MacCtx.RetransPolicy;
+            break;
+        }
         default:
         {
             status = LoRaMacClassBMibGetRequestConfirm( mibGet );
@@ -3916,6 +4252,48 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             }
             break;
         }
+        case MIB_MC_GROUP_KEYS:
+        {
+            McGroupKeys_t* groupKeys = &mibSet->Param.McGroupKeys;
+
+            if( groupKeys->AddrID >= LORAMAC_MAX_MC_CTX )
+            {
+                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                break;
+            }
+            if( groupKeys->McKey != NULL )
+            {
+                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_KEY( groupKeys->AddrID ), groupKeys->McKey ) )
+                {
+                    return LORAMAC_STATUS_CRYPTO_ERROR;
+                }
+                // The session keys of a group set up by LoRaMacMulticastChannelSet
+                // derive from its root key and address
+                uint32_t mcAddress = MacCtx.NvmCtx->MulticastChannelList[groupKeys->AddrID].Address;
+                if( mcAddress != 0 )
+                {
+                    if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoDeriveMcSessionKeyPair( groupKeys->AddrID, mcAddress ) )
+                    {
+                        return LORAMAC_STATUS_CRYPTO_ERROR;
+                    }
+                }
+            }
+            if( groupKeys->McAppSKey != NULL )
+            {
+                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_APP_S_KEY( groupKeys->AddrID ), groupKeys->McAppSKey ) )
+                {
+                    return LORAMAC_STATUS_CRYPTO_ERROR;
+                }
+            }
+            if( groupKeys->McNwkSKey != NULL )
+            {
+                if( LORAMAC_CRYPTO_SUCCESS != LoRaMacCryptoSetKey( MC_NWK_S_KEY( groupKeys->AddrID ), groupKeys->McNwkSKey ) )
+                {
+                    return LORAMAC_STATUS_CRYPTO_ERROR;
+                }
+            }
+            break;
+        }
         case MIB_PUBLIC_NETWORK:
         {
             MacCtx.NvmCtx->PublicNetwork = mibSet->Param.EnablePublicNetwork;
@@ -4139,6 +4517,26 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             }
             break;
         }
+        case MIB_RX_DROP_STATS:
+        {
+            memset1( ( uint8_t* ) &MacCtx.RxDropStats, 0, sizeof( RxDropStats_t ) );
+            break;
+        }
+        case MIB_LATENCY_STATS:
+        {
+            LatencyReset( );
+            break;
+        }
+        case MIB_ENERGY_STATS:
+        {
+            EnergyResetStats( );
+            break;
+        }
+        case MIB_RETRANS_POLICY:
+        {
+            MacCtx.RetransPolicy = mibSet->Param.RetransPolicy;
+            break;
+        }
         default:
         {
             status = LoRaMacMibClassBSetRequestConfirm( mibSet );
@@ -4199,7 +4597,12 @@ LoRaMacStatus_t LoRaMacMulticastChannelSet( MulticastChannel_t channel )
     {
         return LORAMAC_STATUS_BUSY;
     }
+    if( channel.AddrID >= LORAMAC_MAX_MC_CTX )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
 
+    MacCtx.NvmCtx->MulticastChannelList[channel.AddrID].AddrID = channel.AddrID;
     MacCtx.NvmCtx->MulticastChannelList[channel.AddrID].Address = channel.Address;
     MacCtx.NvmCtx->MulticastChannelList[channel.AddrID].IsEnabled = channel.IsEnabled;
     MacCtx.NvmCtx->MulticastChannelList[channel.AddrID].Frequency = channel.Frequency;
@@ -4209,6 +4612,8 @@ LoRaMacStatus_t LoRaMacMulticastChannelSet( MulticastChannel_t channel )
     // Calculate class b parameters
     LoRaMacClassBSetMulticastPeriodicity( &MacCtx.NvmCtx->MulticastChannelList[channel.AddrID] );
 
+    RebuildMulticastLookup( );
+
     EventMacNvmCtxChanged( );
     EventRegionNvmCtxChanged( );
     return LORAMAC_STATUS_OK;
@@ -4419,7 +4824,9 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest )
         case MCPS_CONFIRMED:
         {
             readyToSend = true;
-            MacCtx.NvmCtx->AckTimeoutRetries = mcpsRequest->Req.Confirmed.NbTrials;
+            MacCtx.NvmCtx->AckTimeoutRetries = GetRetransNbTrials( mcpsRequest->Req.Confirmed.NbTrials );
+            MacCtx.McpsConfirm.NbTrials = MacCtx.NvmCtx->AckTimeoutRetries;
+            MacCtx.McpsRequestTime = TimerGetCurrentTime( );
 
             macHdr.Bits.MType = FRAME_TYPE_DATA_CONFIRMED_UP;
             fPort = mcpsRequest->Req.Confirmed.fPort;
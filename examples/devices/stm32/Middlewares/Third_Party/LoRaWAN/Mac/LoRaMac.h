@@ -74,6 +74,8 @@
 #include "systime.h"
 #include "radio.h"
 #include "LoRaMacTypes.h"
+#include "energy_meter.h"
+#include "retrans_policy.h"
 
 /*!
  * Maximum number of times the MAC layer tries to get an acknowledge.
@@ -108,16 +110,6 @@
  */
 #define LORA_MAC_FRMPAYLOAD_OVERHEAD                13 // MHDR(1) + FHDR(7) + Port(1) + MIC(4)
 
-/*!
- * Maximum number of multicast context
- */
-#define   LORAMAC_MAX_MC_CTX       4
-
-/*!
- * Start value for multicast keys enumeration
- */
-#define LORAMAC_CRYPTO_MULITCAST_KEYS   127
-
 /*!
  * LoRaWAN devices classes definition
  *
@@ -842,6 +834,29 @@ typedef struct sMcpsConfirm
      * The uplink channel related to the frame
      */
     uint32_t Channel;
+    /*!
+     * Energy drawn by the MCU and the radio in uJ, from the first
+     * transmission of the frame up to this confirm, Rx windows included
+     */
+    uint32_t Energy;
+    /*!
+     * Trials allowed for the frame, confirmed uplinks only
+     */
+    uint8_t NbTrials;
+    /*!
+     * Time on air of all the transmissions of the frame
+     */
+    TimerTime_t TotalTimeOnAir;
+    /*!
+     * Time the retransmissions waited for the back-off of the retransmission
+     * policy
+     */
+    TimerTime_t BackoffTime;
+    /*!
+     * Set if the retransmission policy abandoned the frame before its last
+     * trial
+     */
+    bool Abandoned;
 }McpsConfirm_t;
 
 /*!
@@ -1240,6 +1255,12 @@ typedef struct sMlmeIndication
  * \ref MIB_MC_KEY_3                             | NO  | YES
  * \ref MIB_MC_APP_S_KEY_3                       | NO  | YES
  * \ref MIB_MC_NWK_S_KEY_3                       | NO  | YES
+ * \ref MIB_MC_GROUP_KEYS                        | NO  | YES
+ * \ref MIB_RX_DROP_STATS                        | YES | YES
+ * \ref MIB_LATENCY_STATS                        | YES | YES
+ * \ref MIB_ENERGY_STATS                         | YES | YES
+ * \ref MIB_TX_TIME_OFF                          | YES | NO
+ * \ref MIB_RETRANS_POLICY                       | YES | YES
  * \ref MIB_PUBLIC_NETWORK                       | YES | YES
  * \ref MIB_REPEATER_SUPPORT                     | YES | YES
  * \ref MIB_CHANNELS                             | YES | NO
@@ -1658,8 +1679,91 @@ typedef enum eMib
      * The allowed ranges are region specific. Please refer to \ref DR_0 to \ref DR_15 for details.
      */
      MIB_PING_SLOT_DATARATE,
+    /*!
+     * Multicast keys of any multicast group up to \ref LORAMAC_MAX_MC_CTX
+     */
+    MIB_MC_GROUP_KEYS,
+    /*!
+     * Counters of received downlinks dropped by each stage of the receive
+     * pipeline. Setting this attribute resets the counters.
+     */
+    MIB_RX_DROP_STATS,
+    /*!
+     * Timer lateness and execution time statistics, collected when
+     * LATENCY_STATS is set. Setting this attribute resets the statistics.
+     */
+    MIB_LATENCY_STATS,
+    /*!
+     * Energy drawn per uplink, Rx window and beacon window. Setting this
+     * attribute resets the statistics.
+     */
+    MIB_ENERGY_STATS,
+    /*!
+     * Time left before the duty cycle allows an uplink, in ms
+     */
+    MIB_TX_TIME_OFF,
+    /*!
+     * Retransmission policy of the confirmed uplinks, NULL for the default
+     * behaviour of the MAC
+     */
+    MIB_RETRANS_POLICY,
 }Mib_t;
 
+/*!
+ * Multicast group keys, used with \ref MIB_MC_GROUP_KEYS
+ */
+typedef struct sMcGroupKeys
+{
+    /*!
+     * Multicast group the keys belong to
+     */
+    AddressIdentifier_t AddrID;
+    /*!
+     * Multicast root key, encrypted with the McKEKey ( \ref MIB_MC_KE_KEY ).
+     * When the group address is set by \ref LoRaMacMulticastChannelSet, the
+     * session keys are derived from it. Set to NULL to keep the current key.
+     */
+    uint8_t* McKey;
+    /*!
+     * Multicast Application session key, overrides the derived one.
+     * Set to NULL to keep the current key.
+     */
+    uint8_t* McAppSKey;
+    /*!
+     * Multicast Network session key, overrides the derived one.
+     * Set to NULL to keep the current key.
+     */
+    uint8_t* McNwkSKey;
+}McGroupKeys_t;
+
+/*!
+ * Received frames dropped per stage of the receive pipeline, used with
+ * \ref MIB_RX_DROP_STATS
+ */
+typedef struct sRxDropStats
+{
+    /*!
+     * Frames with an invalid MAC header, major version or length
+     */
+    uint32_t Header;
+    /*!
+     * Downlinks addressed neither to the device nor to an enabled multicast group
+     */
+    uint32_t Address;
+    /*!
+     * Downlinks which could not be parsed
+     */
+    uint32_t Parser;
+    /*!
+     * Downlinks rejected by the frame counter check
+     */
+    uint32_t FCnt;
+    /*!
+     * Downlinks which failed the MIC verification or decryption
+     */
+    uint32_t Mic;
+}RxDropStats_t;
+
 /*!
  * LoRaMAC MIB parameters
  */
@@ -2045,6 +2149,45 @@ typedef union uMibParam
      * Related MIB type: \ref MIB_PING_SLOT_DATARATE
      */
     int8_t PingSlotDatarate;
+    /*!
+     * Multicast group keys
+     *
+     * Related MIB type: \ref MIB_MC_GROUP_KEYS
+     */
+    McGroupKeys_t McGroupKeys;
+    /*!
+     * Receive pipeline drop counters
+     *
+     * Related MIB type: \ref MIB_RX_DROP_STATS
+     */
+    RxDropStats_t RxDropStats;
+    /*!
+     * Timer lateness and execution time statistics
+     *
+     * Related MIB type: \ref MIB_LATENCY_STATS
+     *
+     * \remark LatencyStats_t of latency_stats.h, whose size depends on the
+     *         application configuration
+     */
+    const struct sLatencyStats* LatencyStats;
+    /*!
+     * Energy statistics
+     *
+     * Related MIB type: \ref MIB_ENERGY_STATS
+     */
+    EnergyStats_t EnergyStats;
+    /*!
+     * Duty cycle time-off
+     *
+     * Related MIB type: \ref MIB_TX_TIME_OFF
+     */
+    TimerTime_t TxTimeOff;
+    /*!
+     * Retransmission policy
+     *
+     * Related MIB type: \ref MIB_RETRANS_POLICY
+     */
+    const RetransPolicy_t* RetransPolicy;
 }MibParam_t;
 
 /*!
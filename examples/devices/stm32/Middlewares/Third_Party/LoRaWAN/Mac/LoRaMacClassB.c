@@ -55,6 +55,84 @@ typedef struct sLoRaMacClassBNvmCtx
     BeaconContext_t BeaconCtx;
 } LoRaMacClassBNvmCtx_t;
 
+/*
+ * Precomputed slot parameters of a single unicast or multicast address
+ */
+typedef struct sLoRaMacClassBSlotEntry
+{
+    /*!
+    * Address the entry was computed for
+    */
+    uint32_t Address;
+    /*!
+    * Ping period the entry was computed for
+    */
+    uint16_t PingPeriod;
+    /*!
+    * Pseudo random ping offset of the current beacon period
+    */
+    uint16_t PingOffset;
+    /*!
+    * Floor plan frequency of the current beacon period
+    */
+    uint32_t Frequency;
+    /*!
+    * Set when the entry matches the schedule beacon time
+    */
+    bool IsValid;
+} LoRaMacClassBSlotEntry_t;
+
+/*
+ * Slot schedule of a beacon period. It is computed once after the beacon
+ * and consumed by the ping and multicast slot state machines.
+ */
+typedef struct sLoRaMacClassBSlotSchedule
+{
+    /*!
+    * Beacon time the schedule was computed for
+    */
+    TimerTime_t BeaconTime;
+    /*!
+    * Point in time where the beacon period starts
+    */
+    TimerTime_t PeriodStart;
+    /*!
+    * Unicast ping slot entry
+    */
+    LoRaMacClassBSlotEntry_t PingSlot;
+    /*!
+    * Multicast slot entries
+    */
+    LoRaMacClassBSlotEntry_t MulticastSlots[LORAMAC_MAX_MC_CTX];
+} LoRaMacClassBSlotSchedule_t;
+
+/*
+ * Beacon drift estimation context
+ */
+typedef struct sLoRaMacClassBDriftCtx
+{
+    /*!
+    * Time of the last beacon reception used as drift sample
+    */
+    TimerTime_t LastBeaconRx;
+    /*!
+    * Estimated drift of the local clock in us per beacon interval
+    */
+    int32_t DriftPerInterval;
+    /*!
+    * Filtered absolute residual of the drift estimation in us
+    */
+    int32_t Jitter;
+    /*!
+    * Number of consecutive beacon receptions
+    */
+    uint8_t NbSamples;
+    /*!
+    * Set if the estimator predicts the beacon arrival
+    */
+    bool IsLocked;
+} LoRaMacClassBDriftCtx_t;
+
 /*
  * LoRaMac Class B Context structure
  */
@@ -89,6 +167,14 @@ typedef struct sLoRaMacClassBCtx
     * Non-volatile module context.
     */
     LoRaMacClassBNvmCtx_t* NvmCtx;
+    /*!
+    * Slot schedule of the current beacon period.
+    */
+    LoRaMacClassBSlotSchedule_t SlotSchedule;
+    /*!
+    * Beacon drift estimation.
+    */
+    LoRaMacClassBDriftCtx_t BeaconDrift;
 } LoRaMacClassBCtx_t;
 
 /*!
@@ -127,7 +213,6 @@ static LoRaMacClassBNvmCtx_t NvmCtx;
  */
 static void ComputePingOffset( uint64_t beaconTime, uint32_t address, uint16_t pingPeriod, uint16_t *pingOffset )
 {
-    uint8_t zeroKey[16];
     uint8_t buffer[16];
     uint8_t cipher[16];
     uint32_t result = 0;
@@ -136,7 +221,6 @@ static void ComputePingOffset( uint64_t beaconTime, uint32_t address, uint16_t p
      */
     uint32_t time = ( beaconTime % ( ( ( uint64_t ) 1 ) << 32 ) );
 
-    memset1( zeroKey, 0, 16 );
     memset1( buffer, 0, 16 );
     memset1( cipher, 0, 16 );
 
@@ -150,8 +234,7 @@ static void ComputePingOffset( uint64_t beaconTime, uint32_t address, uint16_t p
     buffer[6] = ( address >> 16 ) & 0xFF;
     buffer[7] = ( address >> 24 ) & 0xFF;
 
-    SecureElementSetKey( SLOT_RAND_ZERO_KEY, zeroKey );
-
+    // The zero key has been set up once in LoRaMacClassBInit
     SecureElementAesEncrypt( buffer, 16, SLOT_RAND_ZERO_KEY, cipher );
 
     result = ( ( ( uint32_t ) cipher[0] ) + ( ( ( uint32_t ) cipher[1] ) * 256 ) );
@@ -223,6 +306,181 @@ static uint32_t CalcDownlinkChannelAndFrequency( uint32_t devAddr, TimerTime_t b
     return frequency;
 }
 
+/*!
+ * \brief Updates a slot schedule entry. The ping offset and the floor plan
+ *        frequency are only recomputed if the entry does not match the
+ *        beacon period, the address or the ping period anymore.
+ *
+ * \param [IN] entry The slot schedule entry
+ *
+ * \param [IN] address The unicast or multicast address
+ *
+ * \param [IN] pingPeriod The ping period of the address
+ */
+static void UpdateSlotEntry( LoRaMacClassBSlotEntry_t* entry, uint32_t address, uint16_t pingPeriod )
+{
+    if( ( entry->IsValid == true ) && ( entry->Address == address ) && ( entry->PingPeriod == pingPeriod ) )
+    {
+        return;
+    }
+
+    entry->Address = address;
+    entry->PingPeriod = pingPeriod;
+    entry->PingOffset = 0;
+    if( pingPeriod != 0 )
+    {
+        ComputePingOffset( Ctx.SlotSchedule.BeaconTime, address, pingPeriod, &entry->PingOffset );
+    }
+    entry->Frequency = CalcDownlinkChannelAndFrequency( address, Ctx.SlotSchedule.BeaconTime, CLASSB_BEACON_INTERVAL );
+    entry->IsValid = true;
+}
+
+/*!
+ * \brief Calculates the point in time where the beacon period of the given
+ *        time starts, even if the beacon was missed.
+ *
+ * \param [IN] currentTime The current time
+ *
+ * \retval Start of the beacon period
+ */
+static TimerTime_t CalcBeaconPeriodStart( TimerTime_t currentTime )
+{
+    return currentTime - ( ( currentTime - Ctx.NvmCtx->BeaconCtx.LastBeaconRx ) % CLASSB_BEACON_INTERVAL );
+}
+
+/*!
+ * \brief Computes the slot schedule of the current beacon period for the
+ *        unicast address and for all multicast channels.
+ *
+ * \param [IN] currentTime The current time
+ */
+static void UpdateSlotSchedule( TimerTime_t currentTime )
+{
+    MulticastCtx_t *cur = Ctx.LoRaMacClassBParams.MulticastChannels;
+
+    Ctx.SlotSchedule.BeaconTime = Ctx.NvmCtx->BeaconCtx.BeaconTime;
+    Ctx.SlotSchedule.PeriodStart = CalcBeaconPeriodStart( currentTime );
+
+    Ctx.SlotSchedule.PingSlot.IsValid = false;
+    UpdateSlotEntry( &Ctx.SlotSchedule.PingSlot, *Ctx.LoRaMacClassBParams.LoRaMacDevAddr,
+                     Ctx.NvmCtx->PingSlotCtx.PingPeriod );
+
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        Ctx.SlotSchedule.MulticastSlots[i].IsValid = false;
+        if( cur != NULL )
+        {
+            UpdateSlotEntry( &Ctx.SlotSchedule.MulticastSlots[i], cur[i].Address, cur[i].PingPeriod );
+        }
+    }
+}
+
+/*!
+ * \brief Updates the beacon drift estimation with the reception time of a
+ *        beacon.
+ *
+ * \param [IN] beaconRx Time when the beacon was received
+ */
+static void UpdateBeaconDrift( TimerTime_t beaconRx )
+{
+    LoRaMacClassBDriftCtx_t* drift = &Ctx.BeaconDrift;
+    TimerTime_t elapsed = beaconRx - drift->LastBeaconRx;
+    uint32_t nbIntervals = ( elapsed + ( CLASSB_BEACON_INTERVAL / 2 ) ) / CLASSB_BEACON_INTERVAL;
+    int32_t sample = 0;
+    int32_t residual = 0;
+
+    if( ( drift->NbSamples == 0 ) || ( nbIntervals == 0 ) || ( nbIntervals > CLASSB_DRIFT_MAX_INTERVALS ) )
+    {
+        // No usable reference, restart the estimation
+        drift->NbSamples = 1;
+        drift->IsLocked = false;
+        drift->LastBeaconRx = beaconRx;
+        return;
+    }
+
+    // Arrival error of the beacon in us per beacon interval
+    sample = ( int32_t )( elapsed - ( nbIntervals * CLASSB_BEACON_INTERVAL ) );
+    sample = ( sample * 1000 ) / ( int32_t )nbIntervals;
+    drift->LastBeaconRx = beaconRx;
+
+    if( ( sample > ( CLASSB_DRIFT_MAX_ERROR * 1000 ) ) || ( sample < -( CLASSB_DRIFT_MAX_ERROR * 1000 ) ) )
+    {
+        drift->NbSamples = 1;
+        drift->IsLocked = false;
+        return;
+    }
+
+    if( drift->NbSamples == 1 )
+    {
+        // First sample initializes the estimation
+        drift->DriftPerInterval = sample;
+        drift->Jitter = ( sample < 0 ) ? -sample : sample;
+    }
+    else
+    {
+        residual = sample - drift->DriftPerInterval;
+        drift->DriftPerInterval += residual / ( 1 << CLASSB_DRIFT_FILTER_SHIFT );
+        residual = ( residual < 0 ) ? -residual : residual;
+        drift->Jitter += ( residual - drift->Jitter ) / ( 1 << CLASSB_DRIFT_FILTER_SHIFT );
+    }
+
+    if( drift->NbSamples < UINT8_MAX )
+    {
+        drift->NbSamples++;
+    }
+    drift->IsLocked = ( drift->NbSamples > CLASSB_DRIFT_MIN_SAMPLES );
+}
+
+/*!
+ * \brief Drops the drift lock after a missed beacon. The last beacon
+ *        reception is kept as reference for the next sample.
+ */
+static void UnlockBeaconDrift( void )
+{
+    if( Ctx.BeaconDrift.NbSamples > 1 )
+    {
+        Ctx.BeaconDrift.NbSamples = 1;
+    }
+    Ctx.BeaconDrift.IsLocked = false;
+}
+
+/*!
+ * \brief Calculates the receive error of the beacon window based on the
+ *        drift estimation.
+ *
+ * \retval Receive error in ms
+ */
+static uint32_t CalcDriftRxError( void )
+{
+    uint32_t rxError = CLASSB_DRIFT_RX_ERROR_MIN;
+
+    rxError += ( ( uint32_t )Ctx.BeaconDrift.Jitter * CLASSB_DRIFT_JITTER_FACTOR + 999 ) / 1000;
+
+    // Never exceed the receive error of the default window
+    return MIN( rxError, Ctx.LoRaMacClassBParams.LoRaMacParams->SystemMaxRxError );
+}
+
+/*!
+ * \brief Applies the estimated drift to the delay of the next beacon.
+ *
+ * \param [IN] nextBeaconRx Nominal time of the next beacon
+ *
+ * \param [IN] beaconEventTime Delay until the next beacon
+ *
+ * \retval Corrected delay until the next beacon
+ */
+static TimerTime_t ApplyBeaconDrift( TimerTime_t nextBeaconRx, TimerTime_t beaconEventTime )
+{
+    uint32_t nbIntervals = ( nextBeaconRx - Ctx.BeaconDrift.LastBeaconRx + ( CLASSB_BEACON_INTERVAL / 2 ) ) / CLASSB_BEACON_INTERVAL;
+    int32_t correction = ( Ctx.BeaconDrift.DriftPerInterval * ( int32_t )nbIntervals ) / 1000;
+
+    if( ( correction < 0 ) && ( ( TimerTime_t )( -correction ) >= beaconEventTime ) )
+    {
+        return beaconEventTime;
+    }
+    return beaconEventTime + correction;
+}
+
 /*!
  * \brief Calculates the correct frequency and opens up the beacon reception window.
  *
@@ -267,6 +525,15 @@ static void RxBeaconSetup( TimerTime_t rxTime, bool activateDefaultChannel )
 
     if( ( Ctx.NvmCtx->BeaconCtx.Ctrl.BeaconAcquired == 1 ) || ( Ctx.NvmCtx->BeaconCtx.Ctrl.AcquisitionPending == 1 ) )
     {
+        uint32_t rxError = Ctx.LoRaMacClassBParams.LoRaMacParams->SystemMaxRxError;
+
+        if( ( activateDefaultChannel == false ) && ( Ctx.BeaconDrift.IsLocked == true ) )
+        {
+            // The drift estimation predicts the beacon arrival. Open the
+            // narrowest window which is safe.
+            rxError = CalcDriftRxError( );
+        }
+
         // Apply the symbol timeout only if we have acquired the beacon
         // Otherwise, take the window enlargement into account
         // Read beacon datarate
@@ -277,7 +544,7 @@ static void RxBeaconSetup( TimerTime_t rxTime, bool activateDefaultChannel )
         RegionComputeRxWindowParameters( *Ctx.LoRaMacClassBParams.LoRaMacRegion,
                                         ( int8_t )phyParam.Value, // datarate
                                         Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
-                                        Ctx.LoRaMacClassBParams.LoRaMacParams->SystemMaxRxError,
+                                        rxError,
                                         &beaconRxConfig );
         windowTimeout = beaconRxConfig.WindowTimeout;
     }
@@ -286,6 +553,7 @@ static void RxBeaconSetup( TimerTime_t rxTime, bool activateDefaultChannel )
     rxBeaconSetup.RxTime = rxTime;
     rxBeaconSetup.Frequency = frequency;
 
+    EnergyStart( ENERGY_BEACON );
     RegionRxBeaconSetup( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &rxBeaconSetup, &Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
 
     Ctx.LoRaMacClassBParams.MlmeIndication->BeaconInfo.Frequency = frequency;
@@ -307,9 +575,14 @@ static bool CalcNextSlotTime( uint16_t slotOffset, uint16_t pingPeriod, uint16_t
     TimerTime_t slotTime = 0;
     TimerTime_t currentTime = TimerGetCurrentTime( );
 
-    // Calculate the point in time of the last beacon even if we missed it
-    slotTime = ( ( currentTime - Ctx.NvmCtx->BeaconCtx.LastBeaconRx ) % CLASSB_BEACON_INTERVAL );
-    slotTime = currentTime - slotTime;
+    // The beacon period start is part of the slot schedule. Only recalculate
+    // it if the schedule is outdated.
+    if( ( currentTime < Ctx.SlotSchedule.PeriodStart ) ||
+        ( ( currentTime - Ctx.SlotSchedule.PeriodStart ) >= CLASSB_BEACON_INTERVAL ) )
+    {
+        Ctx.SlotSchedule.PeriodStart = CalcBeaconPeriodStart( currentTime );
+    }
+    slotTime = Ctx.SlotSchedule.PeriodStart;
 
     // Add the reserved time and the ping offset
     slotTime += CLASSB_BEACON_RESERVED;
@@ -390,6 +663,8 @@ static void InitClassBDefaults( void )
     // Init variables to default
     memset1( ( uint8_t* ) &Ctx.NvmCtx->BeaconCtx, 0, sizeof( BeaconContext_t ) );
     memset1( ( uint8_t* ) &Ctx.NvmCtx->PingSlotCtx, 0, sizeof( PingSlotContext_t ) );
+    memset1( ( uint8_t* ) &Ctx.SlotSchedule, 0, sizeof( LoRaMacClassBSlotSchedule_t ) );
+    memset1( ( uint8_t* ) &Ctx.BeaconDrift, 0, sizeof( LoRaMacClassBDriftCtx_t ) );
 
     // Setup default temperature
     Ctx.NvmCtx->BeaconCtx.Temperature = 25.0;
@@ -477,8 +752,18 @@ static TimerTime_t UpdateBeaconState( LoRaMacEventInfoStatus_t status,
     beaconEventTime = CalcDelayForNextBeacon( currentTime, Ctx.NvmCtx->BeaconCtx.LastBeaconRx );
     Ctx.NvmCtx->BeaconCtx.NextBeaconRx = currentTime + beaconEventTime;
 
-    // Take temperature compensation into account
-    beaconEventTime = TimerTempCompensation( beaconEventTime, Ctx.NvmCtx->BeaconCtx.Temperature );
+    if( Ctx.BeaconDrift.IsLocked == true )
+    {
+        // The measured drift includes the temperature effects already.
+        // Open the window earlier by the remaining receive error.
+        beaconEventTime = ApplyBeaconDrift( Ctx.NvmCtx->BeaconCtx.NextBeaconRx, beaconEventTime );
+        windowMovement = CalcDriftRxError( );
+    }
+    else
+    {
+        // Take temperature compensation into account
+        beaconEventTime = TimerTempCompensation( beaconEventTime, Ctx.NvmCtx->BeaconCtx.Temperature );
+    }
 
     // Move the window
     if( beaconEventTime > windowMovement )
@@ -487,6 +772,9 @@ static TimerTime_t UpdateBeaconState( LoRaMacEventInfoStatus_t status,
     }
     Ctx.NvmCtx->BeaconCtx.NextBeaconRxAdjusted = currentTime + beaconEventTime;
 
+    // Compute the slot schedule of the beacon period
+    UpdateSlotSchedule( currentTime );
+
     // Start the RX slot state machine for ping and multicast slots
     LoRaMacClassBStartRxSlots( );
 
@@ -535,6 +823,11 @@ void LoRaMacClassBInit( LoRaMacClassBParams_t *classBParams, LoRaMacClassBCallba
     // Assign callback
     Ctx.EventNvmCtxChanged = classBNvmCtxChanged;
 
+    // Set up the zero key for the ping slot randomization once
+    uint8_t zeroKey[16];
+    memset1( zeroKey, 0, 16 );
+    SecureElementSetKey( SLOT_RAND_ZERO_KEY, zeroKey );
+
     // Initialize timers
     TimerInit( &Ctx.BeaconTimer, LoRaMacClassBBeaconTimerEvent );
     TimerInit( &Ctx.PingSlotTimer, LoRaMacClassBPingSlotTimerEvent );
@@ -751,6 +1044,9 @@ static void LoRaMacClassBProcessBeacon( void )
             // We have to update the beacon time, since we missed a beacon
             Ctx.NvmCtx->BeaconCtx.BeaconTime += ( CLASSB_BEACON_INTERVAL / 1000 );
 
+            // The drift estimation lost the beacon. Fall back to the window enlargement
+            UnlockBeaconDrift( );
+
             // Enlarge window timeouts to increase the chance to receive the next beacon
             EnlargeWindowTimeout( );
 
@@ -904,10 +1200,15 @@ static void LoRaMacClassBProcessPingSlot( void )
     {
         case PINGSLOT_STATE_CALC_PING_OFFSET:
         {
-            ComputePingOffset( Ctx.NvmCtx->BeaconCtx.BeaconTime,
-                                            *Ctx.LoRaMacClassBParams.LoRaMacDevAddr,
-                                            Ctx.NvmCtx->PingSlotCtx.PingPeriod,
-                                            &( Ctx.NvmCtx->PingSlotCtx.PingOffset ) );
+            if( Ctx.SlotSchedule.BeaconTime != Ctx.NvmCtx->BeaconCtx.BeaconTime )
+            {
+                // The beacon time changed without a schedule update
+                UpdateSlotSchedule( TimerGetCurrentTime( ) );
+            }
+            // Take the ping offset from the slot schedule
+            UpdateSlotEntry( &Ctx.SlotSchedule.PingSlot, *Ctx.LoRaMacClassBParams.LoRaMacDevAddr,
+                             Ctx.NvmCtx->PingSlotCtx.PingPeriod );
+            Ctx.NvmCtx->PingSlotCtx.PingOffset = Ctx.SlotSchedule.PingSlot.PingOffset;
             Ctx.NvmCtx->PingSlotState = PINGSLOT_STATE_SET_TIMER;
         }
             // Intentional fall through
@@ -947,7 +1248,7 @@ static void LoRaMacClassBProcessPingSlot( void )
             if( Ctx.NvmCtx->PingSlotCtx.Ctrl.CustomFreq == 0 )
             {
                 // Restore floor plan
-                frequency = CalcDownlinkChannelAndFrequency( *Ctx.LoRaMacClassBParams.LoRaMacDevAddr, Ctx.NvmCtx->BeaconCtx.BeaconTime, CLASSB_BEACON_INTERVAL );
+                frequency = Ctx.SlotSchedule.PingSlot.Frequency;
             }
 
             // Open the ping slot window only, if there is no multicast ping slot
@@ -965,6 +1266,7 @@ static void LoRaMacClassBProcessPingSlot( void )
 
                 RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &pingSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
 
+                EnergyStart( ENERGY_RX_WINDOW );
                 if( pingSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
@@ -1030,13 +1332,16 @@ static void LoRaMacClassBProcessMulticastSlot( void )
     {
         case PINGSLOT_STATE_CALC_PING_OFFSET:
         {
-            // Compute all offsets for every multicast slots
-            for( uint8_t i = 0; i < 4; i++ )
+            if( Ctx.SlotSchedule.BeaconTime != Ctx.NvmCtx->BeaconCtx.BeaconTime )
+            {
+                // The beacon time changed without a schedule update
+                UpdateSlotSchedule( TimerGetCurrentTime( ) );
+            }
+            // Take the offsets for every multicast slots from the slot schedule
+            for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
             {
-                ComputePingOffset( Ctx.NvmCtx->BeaconCtx.BeaconTime,
-                                                cur->Address,
-                                                cur->PingPeriod,
-                                                &( cur->PingOffset ) );
+                UpdateSlotEntry( &Ctx.SlotSchedule.MulticastSlots[i], cur->Address, cur->PingPeriod );
+                cur->PingOffset = Ctx.SlotSchedule.MulticastSlots[i].PingOffset;
                 cur++;
             }
             Ctx.NvmCtx->MulticastSlotState = PINGSLOT_STATE_SET_TIMER;
@@ -1047,7 +1352,7 @@ static void LoRaMacClassBProcessMulticastSlot( void )
             cur = Ctx.LoRaMacClassBParams.MulticastChannels;
             Ctx.NvmCtx->PingSlotCtx.NextMulticastChannel = NULL;
 
-            for( uint8_t i = 0; i < 4; i++ )
+            for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
             {
                 // Calculate the next slot time for every multicast slot
                 if( CalcNextSlotTime( cur->PingOffset, cur->PingPeriod, cur->PingNb, &slotTime ) == true )
@@ -1107,7 +1412,8 @@ static void LoRaMacClassBProcessMulticastSlot( void )
             if( frequency == 0 )
             {
                 // Restore floor plan
-                frequency = CalcDownlinkChannelAndFrequency( Ctx.NvmCtx->PingSlotCtx.NextMulticastChannel->Address, Ctx.NvmCtx->BeaconCtx.BeaconTime, CLASSB_BEACON_INTERVAL );
+                uint8_t index = Ctx.NvmCtx->PingSlotCtx.NextMulticastChannel - Ctx.LoRaMacClassBParams.MulticastChannels;
+                frequency = Ctx.SlotSchedule.MulticastSlots[index].Frequency;
             }
 
             Ctx.NvmCtx->MulticastSlotState = PINGSLOT_STATE_RX;
@@ -1130,6 +1436,7 @@ static void LoRaMacClassBProcessMulticastSlot( void )
                 TimerStart( &Ctx.PingSlotTimer );
             }
 
+            EnergyStart( ENERGY_RX_WINDOW );
             if( multicastSlotRxConfig.RxContinuous == false )
             {
                 Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
@@ -1212,6 +1519,7 @@ bool LoRaMacClassBRxBeacon( uint8_t *payload, uint16_t size )
             if( beaconProcessed == true )
             {
                 Ctx.NvmCtx->BeaconCtx.LastBeaconRx = TimerGetCurrentTime( ) - Radio.TimeOnAir( MODEM_LORA, size );
+                UpdateBeaconDrift( Ctx.NvmCtx->BeaconCtx.LastBeaconRx );
                 Ctx.NvmCtx->BeaconCtx.Ctrl.BeaconAcquired = 1;
                 Ctx.NvmCtx->BeaconCtx.Ctrl.BeaconMode = 1;
                 ResetWindowTimeout( );
@@ -112,4 +112,38 @@
  */
 #define CLASSB_WINDOW_MOVE_EXPANSION_FACTOR         2
 
+/*!
+ * Number of consecutive beacons the drift estimator needs before it narrows
+ * the beacon window
+ */
+#define CLASSB_DRIFT_MIN_SAMPLES                    3
+
+/*!
+ * Filter coefficient of the drift estimator as power of two ( 1 / 2^x )
+ */
+#define CLASSB_DRIFT_FILTER_SHIFT                   2
+
+/*!
+ * Maximum number of beacon intervals between two drift samples
+ */
+#define CLASSB_DRIFT_MAX_INTERVALS                  4
+
+/*!
+ * Maximum accepted beacon arrival error per beacon interval in ms. Larger
+ * errors restart the drift estimation
+ */
+#define CLASSB_DRIFT_MAX_ERROR                      20
+
+/*!
+ * Minimum receive error in ms applied to the beacon window while the drift
+ * estimator is locked
+ */
+#define CLASSB_DRIFT_RX_ERROR_MIN                   2
+
+/*!
+ * Multiplier applied to the filtered residual of the drift estimation to
+ * obtain the receive error
+ */
+#define CLASSB_DRIFT_JITTER_FACTOR                  3
+
 #endif // __LORAMACCLASSBCONFIG_H__
@@ -75,7 +75,7 @@
 /*
  * Number of security context entries
  */
-#define NUM_OF_SEC_CTX                  5
+#define NUM_OF_SEC_CTX                  ( LORAMAC_MAX_MC_CTX + 1 )
 
 /*
  * Size of the module context
@@ -134,21 +134,9 @@ typedef struct sLoRaMacCryptoNvmCtx
      */
     uint32_t FCntDown;
     /*!
-     * Multicast downlink counter for index 0
+     * Multicast downlink counters, indexed by multicast group
      */
-    uint32_t McFCntDown0;
-    /*!
-     * Multicast downlink counter for index 1
-     */
-    uint32_t McFCntDown1;
-    /*!
-     * Multicast downlink counter for index 2
-     */
-    uint32_t McFCntDown2;
-    /*!
-     * Multicast downlink counter for index 3
-     */
-    uint32_t McFCntDown3;
+    uint32_t McFCntDown[LORAMAC_MAX_MC_CTX];
     /*
      * RJcount1 is a counter incremented with every Rejoin request Type 1 frame transmitted.
      */
@@ -218,16 +206,9 @@ static LoRaMacCryptoCtx_t CryptoCtx;
 static LoRaMacCryptoNvmCtx_t NvmCryptoCtx;
 
 /*
- * Key-Address list
+ * Key-Address list, indexed by address identifier. Filled in LoRaMacCryptoInit.
  */
-static KeyAddr_t KeyAddrList[NUM_OF_SEC_CTX] =
-    {
-        { MULTICAST_0_ADDR, MC_APP_S_KEY_0, MC_NWK_S_KEY_0, MC_KEY_0 },
-        { MULTICAST_1_ADDR, MC_APP_S_KEY_1, MC_NWK_S_KEY_1, MC_KEY_1 },
-        { MULTICAST_2_ADDR, MC_APP_S_KEY_2, MC_NWK_S_KEY_2, MC_KEY_2 },
-        { MULTICAST_3_ADDR, MC_APP_S_KEY_3, MC_NWK_S_KEY_3, MC_KEY_3 },
-        { UNICAST_DEV_ADDR, APP_S_KEY, NWK_S_ENC_KEY, NO_KEY }
-    };
+static KeyAddr_t KeyAddrList[NUM_OF_SEC_CTX];
 
 /*
  * Local functions
@@ -253,7 +234,7 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, uint16_t size, Key
 
     uint8_t bufferIndex = 0;
     uint16_t ctr = 1;
-    uint8_t sBlock[16] = { 0 };
+    uint8_t sBlock[16] ALIGN( 4 ) = { 0 };
     uint8_t aBlock[16] = { 0 };
 
     aBlock[0] = 0x01;
@@ -279,10 +260,7 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, uint16_t size, Key
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
 
-        for( uint8_t i = 0; i < 16; i++ )
-        {
-            buffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
-        }
+        memxor16( buffer + bufferIndex, sBlock );
         size -= 16;
         bufferIndex += 16;
     }
@@ -294,10 +272,7 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, uint16_t size, Key
         {
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
-        for( uint8_t i = 0; i < size; i++ )
-        {
-            buffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
-        }
+        memxor1( buffer + bufferIndex, sBlock, size );
     }
 
     return LORAMAC_CRYPTO_SUCCESS;
@@ -322,7 +297,7 @@ static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint
     }
 
     uint8_t bufferIndex = 0;
-    uint8_t sBlock[16] = { 0 };
+    uint8_t sBlock[16] ALIGN( 4 ) = { 0 };
     uint8_t aBlock[16] = { 0 };
 
     aBlock[0] = 0x01;
@@ -368,10 +343,7 @@ static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint
         {
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
-        for( uint8_t i = 0; i < size; i++ )
-        {
-            buffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
-        }
+        memxor1( buffer + bufferIndex, sBlock, size );
     }
 
     return LORAMAC_CRYPTO_SUCCESS;
@@ -686,13 +658,10 @@ static LoRaMacCryptoStatus_t ComputeCmacB1( uint8_t* msg, uint16_t len, KeyIdent
  */
 static LoRaMacCryptoStatus_t GetKeyAddrItem( AddressIdentifier_t addrID, KeyAddr_t** item )
 {
-    for( uint8_t i = 0; i < NUM_OF_SEC_CTX; i++ )
+    if( addrID < NUM_OF_SEC_CTX )
     {
-        if( KeyAddrList[i].AddrID == addrID )
-        {
-            *item = &( KeyAddrList[i] );
-            return LORAMAC_CRYPTO_SUCCESS;
-        }
+        *item = &( KeyAddrList[addrID] );
+        return LORAMAC_CRYPTO_SUCCESS;
     }
     return LORAMAC_CRYPTO_ERROR_INVALID_ADDR_ID;
 }
@@ -840,36 +809,31 @@ static LoRaMacCryptoStatus_t DeriveLifeTimeSessionKey( KeyIdentifier_t keyID, ui
 static bool CheckFCntDown( FCntIdentifier_t fCntID, uint32_t currentDown )
 {
     uint32_t lastDown = 0;
-    switch( fCntID )
+    if( ( fCntID >= MC_FCNT_DOWN_0 ) && ( fCntID <= MC_FCNT_DOWN_LAST ) )
     {
-        case FCNT_UP:
-            return false;
-        case N_FCNT_DOWN:
-            lastDown = CryptoCtx.NvmCtx->NFCntDown;
-            CryptoCtx.NvmCtx->LastDownFCnt = &CryptoCtx.NvmCtx->NFCntDown;
-            break;
-        case A_FCNT_DOWN:
-            lastDown = CryptoCtx.NvmCtx->AFCntDown;
-            CryptoCtx.NvmCtx->LastDownFCnt = &CryptoCtx.NvmCtx->AFCntDown;
-            break;
-        case FCNT_DOWN:
-            lastDown = CryptoCtx.NvmCtx->FCntDown;
-            CryptoCtx.NvmCtx->LastDownFCnt = &CryptoCtx.NvmCtx->FCntDown;
-            break;
-        case MC_FCNT_DOWN_0:
-            lastDown = CryptoCtx.NvmCtx->McFCntDown0;
-            break;
-        case MC_FCNT_DOWN_1:
-            lastDown = CryptoCtx.NvmCtx->McFCntDown1;
-            break;
-        case MC_FCNT_DOWN_2:
-            lastDown = CryptoCtx.NvmCtx->McFCntDown2;
-            break;
-        case MC_FCNT_DOWN_3:
-            lastDown = CryptoCtx.NvmCtx->McFCntDown3;
-            break;
-        default:
-            return false;
+        lastDown = CryptoCtx.NvmCtx->McFCntDown[fCntID - MC_FCNT_DOWN_0];
+    }
+    else
+    {
+        switch( fCntID )
+        {
+            case FCNT_UP:
+                return false;
+            case N_FCNT_DOWN:
+                lastDown = CryptoCtx.NvmCtx->NFCntDown;
+                CryptoCtx.NvmCtx->LastDownFCnt = &CryptoCtx.NvmCtx->NFCntDown;
+                break;
+            case A_FCNT_DOWN:
+                lastDown = CryptoCtx.NvmCtx->AFCntDown;
+                CryptoCtx.NvmCtx->LastDownFCnt = &CryptoCtx.NvmCtx->AFCntDown;
+                break;
+            case FCNT_DOWN:
+                lastDown = CryptoCtx.NvmCtx->FCntDown;
+                CryptoCtx.NvmCtx->LastDownFCnt = &CryptoCtx.NvmCtx->FCntDown;
+                break;
+            default:
+                return false;
+        }
     }
     if( ( currentDown > lastDown ) ||
         // For LoRaWAN 1.0.X only. Allow downlink frames of 0
@@ -893,31 +857,26 @@ static bool CheckFCntDown( FCntIdentifier_t fCntID, uint32_t currentDown )
  */
 static void UpdateFCntDown( FCntIdentifier_t fCntID, uint32_t currentDown )
 {
-    switch( fCntID )
+    if( ( fCntID >= MC_FCNT_DOWN_0 ) && ( fCntID <= MC_FCNT_DOWN_LAST ) )
     {
-        case N_FCNT_DOWN:
-            CryptoCtx.NvmCtx->NFCntDown = currentDown;
-            break;
-        case A_FCNT_DOWN:
-            CryptoCtx.NvmCtx->AFCntDown = currentDown;
-            break;
-        case FCNT_DOWN:
-            CryptoCtx.NvmCtx->FCntDown = currentDown;
-            break;
-        case MC_FCNT_DOWN_0:
-            CryptoCtx.NvmCtx->McFCntDown0 = currentDown;
-            break;
-        case MC_FCNT_DOWN_1:
-            CryptoCtx.NvmCtx->McFCntDown1 = currentDown;
-            break;
-        case MC_FCNT_DOWN_2:
-            CryptoCtx.NvmCtx->McFCntDown2 = currentDown;
-            break;
-        case MC_FCNT_DOWN_3:
-            CryptoCtx.NvmCtx->McFCntDown3 = currentDown;
-            break;
-        default:
-            break;
+        CryptoCtx.NvmCtx->McFCntDown[fCntID - MC_FCNT_DOWN_0] = currentDown;
+    }
+    else
+    {
+        switch( fCntID )
+        {
+            case N_FCNT_DOWN:
+                CryptoCtx.NvmCtx->NFCntDown = currentDown;
+                break;
+            case A_FCNT_DOWN:
+                CryptoCtx.NvmCtx->AFCntDown = currentDown;
+                break;
+            case FCNT_DOWN:
+                CryptoCtx.NvmCtx->FCntDown = currentDown;
+                break;
+            default:
+                break;
+        }
     }
     CryptoCtx.EventCryptoNvmCtxChanged( );
 }
@@ -933,10 +892,10 @@ void ResetFCnts( void )
     CryptoCtx.NvmCtx->AFCntDown = FCNT_DOWN_INITAL_VALUE;
     CryptoCtx.NvmCtx->FCntDown = FCNT_DOWN_INITAL_VALUE;
 
-    CryptoCtx.NvmCtx->McFCntDown0 = FCNT_DOWN_INITAL_VALUE;
-    CryptoCtx.NvmCtx->McFCntDown1 = FCNT_DOWN_INITAL_VALUE;
-    CryptoCtx.NvmCtx->McFCntDown2 = FCNT_DOWN_INITAL_VALUE;
-    CryptoCtx.NvmCtx->McFCntDown3 = FCNT_DOWN_INITAL_VALUE;
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        CryptoCtx.NvmCtx->McFCntDown[i] = FCNT_DOWN_INITAL_VALUE;
+    }
 
     CryptoCtx.EventCryptoNvmCtxChanged( );
 }
@@ -965,6 +924,19 @@ LoRaMacCryptoStatus_t LoRaMacCryptoInit( EventNvmCtxChanged cryptoNvmCtxChanged
     // Assign non volatile context
     CryptoCtx.NvmCtx = &NvmCryptoCtx;
 
+    // Build the key-address list, one entry per multicast group plus unicast
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        KeyAddrList[i].AddrID = ( AddressIdentifier_t )i;
+        KeyAddrList[i].AppSkey = MC_APP_S_KEY( i );
+        KeyAddrList[i].NwkSkey = MC_NWK_S_KEY( i );
+        KeyAddrList[i].RootKey = MC_KEY( i );
+    }
+    KeyAddrList[UNICAST_DEV_ADDR].AddrID = UNICAST_DEV_ADDR;
+    KeyAddrList[UNICAST_DEV_ADDR].AppSkey = APP_S_KEY;
+    KeyAddrList[UNICAST_DEV_ADDR].NwkSkey = NWK_S_ENC_KEY;
+    KeyAddrList[UNICAST_DEV_ADDR].RootKey = NO_KEY;
+
     // Assign callback
     if( cryptoNvmCtxChanged != 0 )
     {
@@ -1459,6 +1431,11 @@ LoRaMacCryptoStatus_t LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID,
         return retval;
     }
     FRMPayloadDecryptionKeyID = curItem->AppSkey;
+    if( addrID != UNICAST_DEV_ADDR )
+    {
+        // Multicast downlinks are authenticated with the group McNwkSKey
+        micComputationKeyID = curItem->NwkSkey;
+    }
 
     // Check if it is our address
     if( address != macMsg->FHDR.DevAddr )
@@ -53,21 +53,9 @@ typedef struct sFCntList
      */
     uint32_t FCntDown;
     /*!
-     * Multicast downlink counter for index 0
+     * Multicast downlink counters, indexed by multicast group
      */
-    uint32_t McFCntDown0;
-    /*!
-     * Multicast downlink counter for index 1
-     */
-    uint32_t McFCntDown1;
-    /*!
-     * Multicast downlink counter for index 2
-     */
-    uint32_t McFCntDown2;
-    /*!
-     * Multicast downlink counter for index 3
-     */
-    uint32_t McFCntDown3;
+    uint32_t McFCntDown[LORAMAC_MAX_MC_CTX];
 }FCntList_t;
 
 
@@ -148,46 +136,35 @@ LoRaMacFCntHandlerStatus_t LoRaMacGetFCntDown( AddressIdentifier_t addrID, FType
     }
 
     // Determine the frame counter identifier and choose counter from FCntList
-    switch( addrID )
+    if( addrID < UNICAST_DEV_ADDR )
+    {
+        *fCntID = MC_FCNT_DOWN( addrID );
+        previousDown = FCntHandlerNvmCtx.FCntList.McFCntDown[addrID];
+    }
+    else if( addrID == UNICAST_DEV_ADDR )
     {
-        case UNICAST_DEV_ADDR:
-            if( lrWanVersion.Fields.Minor == 1 )
+        if( lrWanVersion.Fields.Minor == 1 )
+        {
+            if( ( fType == FRAME_TYPE_A ) || ( fType == FRAME_TYPE_D ) )
             {
-                if( ( fType == FRAME_TYPE_A ) || ( fType == FRAME_TYPE_D ) )
-                {
-                    *fCntID = A_FCNT_DOWN;
-                    previousDown = FCntHandlerNvmCtx.FCntList.AFCntDown;
-                }
-                else
-                {
-                    *fCntID = N_FCNT_DOWN;
-                    previousDown = FCntHandlerNvmCtx.FCntList.NFCntDown;
-                }
+                *fCntID = A_FCNT_DOWN;
+                previousDown = FCntHandlerNvmCtx.FCntList.AFCntDown;
             }
             else
-            { // For LoRaWAN 1.0.X
-                *fCntID = FCNT_DOWN;
-                previousDown = FCntHandlerNvmCtx.FCntList.FCntDown;
+            {
+                *fCntID = N_FCNT_DOWN;
+                previousDown = FCntHandlerNvmCtx.FCntList.NFCntDown;
             }
-            break;
-        case MULTICAST_0_ADDR:
-            *fCntID = MC_FCNT_DOWN_0;
-            previousDown = FCntHandlerNvmCtx.FCntList.McFCntDown0;
-            break;
-        case MULTICAST_1_ADDR:
-            *fCntID = MC_FCNT_DOWN_1;
-            previousDown = FCntHandlerNvmCtx.FCntList.McFCntDown1;
-            break;
-        case MULTICAST_2_ADDR:
-            *fCntID = MC_FCNT_DOWN_2;
-            previousDown = FCntHandlerNvmCtx.FCntList.McFCntDown3;
-            break;
-        case MULTICAST_3_ADDR:
-            *fCntID = MC_FCNT_DOWN_3;
-            previousDown = FCntHandlerNvmCtx.FCntList.McFCntDown3;
-            break;
-        default:
-            return LORAMAC_FCNT_HANDLER_ERROR;
+        }
+        else
+        { // For LoRaWAN 1.0.X
+            *fCntID = FCNT_DOWN;
+            previousDown = FCntHandlerNvmCtx.FCntList.FCntDown;
+        }
+    }
+    else
+    {
+        return LORAMAC_FCNT_HANDLER_ERROR;
     }
 
     // For LoRaWAN 1.0.X only, allow downlink frames of 0
@@ -230,6 +207,13 @@ LoRaMacFCntHandlerStatus_t LoRaMacGetFCntDown( AddressIdentifier_t addrID, FType
 
 LoRaMacFCntHandlerStatus_t LoRaMacSetFCntDown( FCntIdentifier_t fCntID, uint32_t currentDown )
 {
+    if( ( fCntID >= MC_FCNT_DOWN_0 ) && ( fCntID <= MC_FCNT_DOWN_LAST ) )
+    {
+        FCntHandlerNvmCtx.FCntList.McFCntDown[fCntID - MC_FCNT_DOWN_0] = currentDown;
+        NvmCtxChanged( );
+        return LORAMAC_FCNT_HANDLER_SUCCESS;
+    }
+
     switch( fCntID )
     {
         case FCNT_UP:
@@ -243,18 +227,6 @@ LoRaMacFCntHandlerStatus_t LoRaMacSetFCntDown( FCntIdentifier_t fCntID, uint32_t
         case FCNT_DOWN:
             FCntHandlerNvmCtx.FCntList.FCntDown = currentDown;
             break;
-        case MC_FCNT_DOWN_0:
-            FCntHandlerNvmCtx.FCntList.McFCntDown0 = currentDown;
-            break;
-        case MC_FCNT_DOWN_1:
-            FCntHandlerNvmCtx.FCntList.McFCntDown1 = currentDown;
-            break;
-        case MC_FCNT_DOWN_2:
-            FCntHandlerNvmCtx.FCntList.McFCntDown2 = currentDown;
-            break;
-        case MC_FCNT_DOWN_3:
-            FCntHandlerNvmCtx.FCntList.McFCntDown3 = currentDown;
-            break;
         default:
             return LORAMAC_FCNT_HANDLER_ERROR;
     }
@@ -293,10 +265,10 @@ LoRaMacFCntHandlerStatus_t LoRaMacResetFCnts( void )
     FCntHandlerNvmCtx.FCntList.AFCntDown = FCNT_DOWN_INITAL_VALUE;
     FCntHandlerNvmCtx.FCntList.FCntDown = FCNT_DOWN_INITAL_VALUE;
 
-    FCntHandlerNvmCtx.FCntList.McFCntDown0 = FCNT_DOWN_INITAL_VALUE;
-    FCntHandlerNvmCtx.FCntList.McFCntDown1 = FCNT_DOWN_INITAL_VALUE;
-    FCntHandlerNvmCtx.FCntList.McFCntDown2 = FCNT_DOWN_INITAL_VALUE;
-    FCntHandlerNvmCtx.FCntList.McFCntDown3 = FCNT_DOWN_INITAL_VALUE;
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        FCntHandlerNvmCtx.FCntList.McFCntDown[i] = FCNT_DOWN_INITAL_VALUE;
+    }
 
     NvmCtxChanged( );
 
@@ -310,10 +282,10 @@ LoRaMacFCntHandlerStatus_t LoRaMacFCntHandlerSetMulticastReference( MulticastCtx
         return LORAMAC_FCNT_HANDLER_ERROR_NPE;
     }
 
-    multicastList[0].DownLinkCounter = &FCntHandlerNvmCtx.FCntList.McFCntDown0;
-    multicastList[1].DownLinkCounter = &FCntHandlerNvmCtx.FCntList.McFCntDown1;
-    multicastList[2].DownLinkCounter = &FCntHandlerNvmCtx.FCntList.McFCntDown2;
-    multicastList[3].DownLinkCounter = &FCntHandlerNvmCtx.FCntList.McFCntDown3;
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        multicastList[i].DownLinkCounter = &FCntHandlerNvmCtx.FCntList.McFCntDown[i];
+    }
 
     return LORAMAC_FCNT_HANDLER_SUCCESS;
 }
@@ -65,6 +65,12 @@
 /*! MIC field size */
 #define LORAMAC_MIC_FIELD_SIZE              4
 
+/*! Frame header minimum size, DevAddr, FCtrl and FCnt without FOpts */
+#define LORAMAC_FHDR_MIN_FIELD_SIZE         7
+
+/*! Join-accept message size, without CFList */
+#define LORAMAC_JOIN_ACCEPT_MSG_SIZE        17
+
 /*! Join-request message size */
 #define LORAMAC_JOIN_REQ_MSG_SIZE           23
 
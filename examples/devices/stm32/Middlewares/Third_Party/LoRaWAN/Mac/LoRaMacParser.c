@@ -21,6 +21,29 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
 #include "LoRaMacParser.h"
 #include "utilities.h"
 
+/*!
+ * Reads a 16 bits little endian field
+ *
+ * \param [IN] src Field
+ * \retval Value of the field
+ */
+static inline uint16_t GetUint16Le( const uint8_t* src )
+{
+    return ( uint16_t )( src[0] | ( src[1] << 8 ) );
+}
+
+/*!
+ * Reads a 32 bits little endian field
+ *
+ * \param [IN] src Field
+ * \retval Value of the field
+ */
+static inline uint32_t GetUint32Le( const uint8_t* src )
+{
+    return ( uint32_t )src[0] | ( ( uint32_t )src[1] << 8 ) |
+           ( ( uint32_t )src[2] << 16 ) | ( ( uint32_t )src[3] << 24 );
+}
+
 LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t* macMsg )
 {
     if( ( macMsg == 0 ) || ( macMsg->Buffer == 0 ) )
@@ -28,39 +51,37 @@ LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t* macMs
         return LORAMAC_PARSER_ERROR_NPE;
     }
 
-    uint16_t bufItr = 0;
+    // The CFList is the only optional field, any other size is malformed
+    if( ( macMsg->BufSize != LORAMAC_JOIN_ACCEPT_MSG_SIZE ) &&
+        ( macMsg->BufSize != ( LORAMAC_JOIN_ACCEPT_MSG_SIZE + LORAMAC_C_FLIST_FIELD_SIZE ) ) )
+    {
+        return LORAMAC_PARSER_FAIL;
+    }
 
-    macMsg->MHDR.Value = macMsg->Buffer[bufItr++];
+    const uint8_t* cursor = macMsg->Buffer;
 
-    memcpy1( macMsg->JoinNonce, &macMsg->Buffer[bufItr], 3 );
-    bufItr = bufItr + 3;
+    macMsg->MHDR.Value = *cursor++;
 
-    memcpy1( macMsg->NetID, &macMsg->Buffer[bufItr], 3 );
-    bufItr = bufItr + 3;
+    memcpy1( macMsg->JoinNonce, cursor, LORAMAC_JOIN_NONCE_FIELD_SIZE );
+    cursor += LORAMAC_JOIN_NONCE_FIELD_SIZE;
 
-    macMsg->DevAddr = ( uint32_t ) macMsg->Buffer[bufItr++];
-    macMsg->DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 8 );
-    macMsg->DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 16 );
-    macMsg->DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 24 );
+    memcpy1( macMsg->NetID, cursor, LORAMAC_NET_ID_FIELD_SIZE );
+    cursor += LORAMAC_NET_ID_FIELD_SIZE;
 
-    macMsg->DLSettings.Value = macMsg->Buffer[bufItr++];
+    macMsg->DevAddr = GetUint32Le( cursor );
+    cursor += LORAMAC_FHDR_DEV_ADD_FIELD_SIZE;
 
-    macMsg->RxDelay = macMsg->Buffer[bufItr++];
+    macMsg->DLSettings.Value = *cursor++;
 
-    if( ( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE - bufItr ) == LORAMAC_C_FLIST_FIELD_SIZE )
-    {
-        memcpy1( macMsg->CFList, &macMsg->Buffer[bufItr], LORAMAC_C_FLIST_FIELD_SIZE );
-        bufItr = bufItr + LORAMAC_C_FLIST_FIELD_SIZE;
-    }
-    else if( ( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE - bufItr ) > 0 )
+    macMsg->RxDelay = *cursor++;
+
+    if( macMsg->BufSize != LORAMAC_JOIN_ACCEPT_MSG_SIZE )
     {
-        return LORAMAC_PARSER_FAIL;
+        memcpy16( macMsg->CFList, cursor );
+        cursor += LORAMAC_C_FLIST_FIELD_SIZE;
     }
 
-    macMsg->MIC = ( uint32_t ) macMsg->Buffer[bufItr++];
-    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 8 );
-    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 16 );
-    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 24 );
+    macMsg->MIC = GetUint32Le( cursor );
 
     return LORAMAC_PARSER_SUCCESS;
 }
@@ -72,47 +93,46 @@ LoRaMacParserStatus_t LoRaMacParserData( LoRaMacMessageData_t* macMsg )
         return LORAMAC_PARSER_ERROR_NPE;
     }
 
-    uint16_t bufItr = 0;
+    // Reject the frames too short for the mandatory fields before any read
+    if( macMsg->BufSize < ( LORAMAC_MHDR_FIELD_SIZE + LORAMAC_FHDR_MIN_FIELD_SIZE + LORAMAC_MIC_FIELD_SIZE ) )
+    {
+        return LORAMAC_PARSER_FAIL;
+    }
 
-    macMsg->MHDR.Value = macMsg->Buffer[bufItr++];
+    const uint8_t* cursor = macMsg->Buffer;
+    const uint8_t* micField = macMsg->Buffer + macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE;
 
-    macMsg->FHDR.DevAddr = macMsg->Buffer[bufItr++];
-    macMsg->FHDR.DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 8 );
-    macMsg->FHDR.DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 16 );
-    macMsg->FHDR.DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 24 );
+    macMsg->MHDR.Value = *cursor++;
 
-    macMsg->FHDR.FCtrl.Value = macMsg->Buffer[bufItr++];
+    macMsg->FHDR.DevAddr = GetUint32Le( cursor );
+    cursor += LORAMAC_FHDR_DEV_ADD_FIELD_SIZE;
 
-    macMsg->FHDR.FCnt = macMsg->Buffer[bufItr++];
-    macMsg->FHDR.FCnt |= macMsg->Buffer[bufItr++] << 8;
+    macMsg->FHDR.FCtrl.Value = *cursor++;
 
-    if( macMsg->FHDR.FCtrl.Bits.FOptsLen <= 15 )
-    {
-        memcpy1( macMsg->FHDR.FOpts, &macMsg->Buffer[bufItr], macMsg->FHDR.FCtrl.Bits.FOptsLen );
-        bufItr = bufItr + macMsg->FHDR.FCtrl.Bits.FOptsLen;
-    }
-    else
+    macMsg->FHDR.FCnt = GetUint16Le( cursor );
+    cursor += LORAMAC_FHDR_F_CNT_FIELD_SIZE;
+
+    // FOptsLen must fit before the MIC
+    if( macMsg->FHDR.FCtrl.Bits.FOptsLen > ( micField - cursor ) )
     {
         return LORAMAC_PARSER_FAIL;
     }
+    memcpy1( macMsg->FHDR.FOpts, cursor, macMsg->FHDR.FCtrl.Bits.FOptsLen );
+    cursor += macMsg->FHDR.FCtrl.Bits.FOptsLen;
 
     // Initialize anyway with zero.
     macMsg->FPort = 0;
     macMsg->FRMPayloadSize = 0;
 
-    if( ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE ) > 0 )
+    if( cursor < micField )
     {
-        macMsg->FPort = macMsg->Buffer[bufItr++];
+        macMsg->FPort = *cursor++;
 
-        macMsg->FRMPayloadSize = ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE );
-        memcpy1( macMsg->FRMPayload, &macMsg->Buffer[bufItr], macMsg->FRMPayloadSize );
-        bufItr = bufItr + macMsg->FRMPayloadSize;
+        macMsg->FRMPayloadSize = ( uint8_t )( micField - cursor );
+        memcpy1( macMsg->FRMPayload, cursor, macMsg->FRMPayloadSize );
     }
 
-    macMsg->MIC = ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE )];
-    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 1] << 8 );
-    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 2] << 16 );
-    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 3] << 24 );
+    macMsg->MIC = GetUint32Le( micField );
 
     return LORAMAC_PARSER_SUCCESS;
 }
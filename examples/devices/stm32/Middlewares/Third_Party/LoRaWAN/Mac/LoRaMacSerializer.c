@@ -21,6 +21,36 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
 #include "LoRaMacSerializer.h"
 #include "utilities.h"
 
+/*!
+ * Writes a 16 bits little endian field
+ *
+ * \param [IN] dst   Field
+ * \param [IN] value Value of the field
+ * \retval Next field
+ */
+static inline uint8_t* PutUint16Le( uint8_t* dst, uint16_t value )
+{
+    dst[0] = value & 0xFF;
+    dst[1] = ( value >> 8 ) & 0xFF;
+    return dst + 2;
+}
+
+/*!
+ * Writes a 32 bits little endian field
+ *
+ * \param [IN] dst   Field
+ * \param [IN] value Value of the field
+ * \retval Next field
+ */
+static inline uint8_t* PutUint32Le( uint8_t* dst, uint32_t value )
+{
+    dst[0] = value & 0xFF;
+    dst[1] = ( value >> 8 ) & 0xFF;
+    dst[2] = ( value >> 16 ) & 0xFF;
+    dst[3] = ( value >> 24 ) & 0xFF;
+    return dst + 4;
+}
+
 LoRaMacSerializerStatus_t LoRaMacSerializerJoinRequest( LoRaMacMessageJoinRequest_t* macMsg )
 {
     if( ( macMsg == 0 ) || ( macMsg->Buffer == 0 ) )
@@ -44,13 +74,11 @@ LoRaMacSerializerStatus_t LoRaMacSerializerJoinRequest( LoRaMacMessageJoinReques
     memcpyr( &macMsg->Buffer[bufItr], macMsg->DevEUI, LORAMAC_DEV_EUI_FIELD_SIZE );
     bufItr += LORAMAC_DEV_EUI_FIELD_SIZE;
 
-    macMsg->Buffer[bufItr++] = macMsg->DevNonce & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->DevNonce >> 8 ) & 0xFF;
+    PutUint16Le( &macMsg->Buffer[bufItr], macMsg->DevNonce );
+    bufItr += 2;
 
-    macMsg->Buffer[bufItr++] = macMsg->MIC & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 8 ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 16 ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 24 ) & 0xFF;
+    PutUint32Le( &macMsg->Buffer[bufItr], macMsg->MIC );
+    bufItr += LORAMAC_MIC_FIELD_SIZE;
 
     macMsg->BufSize = bufItr;
 
@@ -82,8 +110,7 @@ LoRaMacSerializerStatus_t LoRaMacSerializerReJoinType1( LoRaMacMessageReJoinType
     memcpyr( &macMsg->Buffer[bufItr], macMsg->DevEUI, LORAMAC_DEV_EUI_FIELD_SIZE );
     bufItr += LORAMAC_DEV_EUI_FIELD_SIZE;
 
-    macMsg->Buffer[bufItr++] = macMsg->RJcount1 & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->RJcount1 >> 8 ) & 0xFF;
+    PutUint16Le( &macMsg->Buffer[bufItr], macMsg->RJcount1 );
 
     return LORAMAC_SERIALIZER_SUCCESS;
 }
@@ -113,8 +140,7 @@ LoRaMacSerializerStatus_t LoRaMacSerializerReJoinType0or2( LoRaMacMessageReJoinT
     memcpyr( &macMsg->Buffer[bufItr], macMsg->DevEUI, LORAMAC_DEV_EUI_FIELD_SIZE );
     bufItr += LORAMAC_DEV_EUI_FIELD_SIZE;
 
-    macMsg->Buffer[bufItr++] = macMsg->RJcount0 & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->RJcount0 >> 8 ) & 0xFF;
+    PutUint16Le( &macMsg->Buffer[bufItr], macMsg->RJcount0 );
 
     return LORAMAC_SERIALIZER_SUCCESS;
 }
@@ -126,58 +152,46 @@ LoRaMacSerializerStatus_t LoRaMacSerializerData( LoRaMacMessageData_t* macMsg )
         return LORAMAC_SERIALIZER_ERROR_NPE;
     }
 
-    uint16_t bufItr = 0;
-
-    // Check macMsg->BufSize
+    // Check macMsg->BufSize against the whole frame, MIC included
     uint16_t computedBufSize =   LORAMAC_MHDR_FIELD_SIZE
-                               + LORAMAC_FHDR_DEV_ADD_FIELD_SIZE
-                               + LORAMAC_FHDR_F_CTRL_FIELD_SIZE
-                               + LORAMAC_FHDR_F_CNT_FIELD_SIZE;
+                               + LORAMAC_FHDR_MIN_FIELD_SIZE
+                               + macMsg->FHDR.FCtrl.Bits.FOptsLen
+                               + LORAMAC_MIC_FIELD_SIZE;
 
-    if( macMsg->FRMPayloadSize == 0 )
-    {
-        if( macMsg->BufSize < computedBufSize )
-        {
-            return LORAMAC_SERIALIZER_ERROR_BUF_SIZE;
-        }
-    }
-    else
+    if( macMsg->FRMPayloadSize > 0 )
     {   //If FRMPayload >0, FPort field is present.
-        if( macMsg->BufSize < computedBufSize + macMsg->FHDR.FCtrl.Bits.FOptsLen + macMsg->FRMPayloadSize + LORAMAC_F_PORT_FIELD_SIZE )
-        {
-            return LORAMAC_SERIALIZER_ERROR_BUF_SIZE;
-        }
+        computedBufSize += LORAMAC_F_PORT_FIELD_SIZE + macMsg->FRMPayloadSize;
     }
 
-    macMsg->Buffer[bufItr++] = macMsg->MHDR.Value;
+    if( macMsg->BufSize < computedBufSize )
+    {
+        return LORAMAC_SERIALIZER_ERROR_BUF_SIZE;
+    }
 
-    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr >> 8 ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr >> 16 ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr >> 24 ) & 0xFF;
+    uint8_t* cursor = macMsg->Buffer;
 
-    macMsg->Buffer[bufItr++] = macMsg->FHDR.FCtrl.Value;
+    *cursor++ = macMsg->MHDR.Value;
 
-    macMsg->Buffer[bufItr++] = macMsg->FHDR.FCnt & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.FCnt >> 8 ) & 0xFF;
+    cursor = PutUint32Le( cursor, macMsg->FHDR.DevAddr );
 
-    memcpy1( &macMsg->Buffer[bufItr], macMsg->FHDR.FOpts, macMsg->FHDR.FCtrl.Bits.FOptsLen );
-    bufItr = bufItr + macMsg->FHDR.FCtrl.Bits.FOptsLen;
+    *cursor++ = macMsg->FHDR.FCtrl.Value;
+
+    cursor = PutUint16Le( cursor, macMsg->FHDR.FCnt );
+
+    memcpy1( cursor, macMsg->FHDR.FOpts, macMsg->FHDR.FCtrl.Bits.FOptsLen );
+    cursor += macMsg->FHDR.FCtrl.Bits.FOptsLen;
 
     if( macMsg->FRMPayloadSize > 0 )
     {
-        macMsg->Buffer[bufItr++] = macMsg->FPort;
-    }
+        *cursor++ = macMsg->FPort;
 
-    memcpy1( &macMsg->Buffer[bufItr], macMsg->FRMPayload, macMsg->FRMPayloadSize );
-    bufItr = bufItr + macMsg->FRMPayloadSize;
+        memcpy1( cursor, macMsg->FRMPayload, macMsg->FRMPayloadSize );
+        cursor += macMsg->FRMPayloadSize;
+    }
 
-    macMsg->Buffer[bufItr++] = macMsg->MIC & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 8 ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 16 ) & 0xFF;
-    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 24 ) & 0xFF;
+    PutUint32Le( cursor, macMsg->MIC );
 
-    macMsg->BufSize = bufItr;
+    macMsg->BufSize = computedBufSize;
 
     return LORAMAC_SERIALIZER_SUCCESS;
 }
@@ -49,6 +49,44 @@
  */
 #define LORAMAC_CRYPTO_MULITCAST_KEYS   127
 
+/*!
+ * Maximum number of multicast contexts (groups)
+ *
+ * \remark May be overridden at build time. Each group owns one address
+ *         identifier, one downlink frame counter and three keys.
+ */
+#ifndef LORAMAC_MAX_MC_CTX
+#define LORAMAC_MAX_MC_CTX              4
+#endif
+
+#if ( LORAMAC_MAX_MC_CTX < 4 )
+#error "LORAMAC_MAX_MC_CTX must be at least 4 (MIB_MC_KEY_0..3 are always exposed)"
+#endif
+
+#if ( LORAMAC_MAX_MC_CTX > 32 )
+#error "LORAMAC_MAX_MC_CTX exceeds the multicast key identifier range"
+#endif
+
+/*!
+ * Multicast downlink frame counter identifier of group id
+ */
+#define MC_FCNT_DOWN( id )              ( ( FCntIdentifier_t )( MC_FCNT_DOWN_0 + ( id ) ) )
+
+/*!
+ * Multicast root key identifier of group id
+ */
+#define MC_KEY( id )                    ( ( KeyIdentifier_t )( MC_KEY_0 + ( 3 * ( id ) ) ) )
+
+/*!
+ * Multicast application session key identifier of group id
+ */
+#define MC_APP_S_KEY( id )              ( ( KeyIdentifier_t )( MC_APP_S_KEY_0 + ( 3 * ( id ) ) ) )
+
+/*!
+ * Multicast network session key identifier of group id
+ */
+#define MC_NWK_S_KEY( id )              ( ( KeyIdentifier_t )( MC_NWK_S_KEY_0 + ( 3 * ( id ) ) ) )
+
 /*!
  * LoRaWAN Frame type enumeration to differ between the possible data up/down frame configurations.
  *
@@ -123,6 +161,10 @@ typedef enum eFCntIdentifier
      * Multicast downlink counter for index 3
      */
     MC_FCNT_DOWN_3,
+    /*!
+     * Multicast downlink counters for the remaining indexes, see \ref MC_FCNT_DOWN
+     */
+    MC_FCNT_DOWN_LAST = MC_FCNT_DOWN_0 + LORAMAC_MAX_MC_CTX - 1,
 }FCntIdentifier_t;
 
 /*!
@@ -214,6 +256,11 @@ typedef enum eKeyIdentifier
      * Multicast Network session key index 3
      */
     MC_NWK_S_KEY_3,
+    /*!
+     * Multicast keys for the remaining indexes, see \ref MC_KEY,
+     * \ref MC_APP_S_KEY and \ref MC_NWK_S_KEY
+     */
+    MC_NWK_S_KEY_LAST = MC_NWK_S_KEY_0 + ( 3 * ( LORAMAC_MAX_MC_CTX - 1 ) ),
     /*!
      * Zero key for slot randomization in class B
      */
@@ -246,9 +293,10 @@ typedef enum eAddressIdentifier
      */
     MULTICAST_3_ADDR = 3,
     /*!
-     * Unicast End-device address
+     * Unicast End-device address. Multicast groups beyond index 3 use the
+     * identifiers in between.
      */
-    UNICAST_DEV_ADDR = 4,
+    UNICAST_DEV_ADDR = LORAMAC_MAX_MC_CTX,
 }AddressIdentifier_t;
 
 /*!
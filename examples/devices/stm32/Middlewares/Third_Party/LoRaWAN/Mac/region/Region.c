@@ -53,6 +53,7 @@
 #define AS923_ALTERNATE_DR( )                      AS923_CASE { return RegionAS923AlternateDr( currentDr, type ); }
 #define AS923_CALC_BACKOFF( )                      AS923_CASE { RegionAS923CalcBackOff( calcBackOff ); break; }
 #define AS923_NEXT_CHANNEL( )                      AS923_CASE { return RegionAS923NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define AS923_GET_TX_TIME_OFF( )                   AS923_CASE { return RegionAS923GetTxTimeOff( txTimeOff ); }
 #define AS923_CHANNEL_ADD( )                       AS923_CASE { return RegionAS923ChannelAdd( channelAdd ); }
 #define AS923_CHANNEL_REMOVE( )                    AS923_CASE { return RegionAS923ChannelsRemove( channelRemove ); }
 #define AS923_SET_CONTINUOUS_WAVE( )               AS923_CASE { RegionAS923SetContinuousWave( continuousWave ); break; }
@@ -78,6 +79,7 @@
 #define AS923_ALTERNATE_DR( )
 #define AS923_CALC_BACKOFF( )
 #define AS923_NEXT_CHANNEL( )
+#define AS923_GET_TX_TIME_OFF( )
 #define AS923_CHANNEL_ADD( )
 #define AS923_CHANNEL_REMOVE( )
 #define AS923_SET_CONTINUOUS_WAVE( )
@@ -107,6 +109,7 @@
 #define AU915_ALTERNATE_DR( )                      AU915_CASE { return RegionAU915AlternateDr( currentDr, type ); }
 #define AU915_CALC_BACKOFF( )                      AU915_CASE { RegionAU915CalcBackOff( calcBackOff ); break; }
 #define AU915_NEXT_CHANNEL( )                      AU915_CASE { return RegionAU915NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define AU915_GET_TX_TIME_OFF( )                   AU915_CASE { return RegionAU915GetTxTimeOff( txTimeOff ); }
 #define AU915_CHANNEL_ADD( )                       AU915_CASE { return RegionAU915ChannelAdd( channelAdd ); }
 #define AU915_CHANNEL_REMOVE( )                    AU915_CASE { return RegionAU915ChannelsRemove( channelRemove ); }
 #define AU915_SET_CONTINUOUS_WAVE( )               AU915_CASE { RegionAU915SetContinuousWave( continuousWave ); break; }
@@ -132,6 +135,7 @@
 #define AU915_ALTERNATE_DR( )
 #define AU915_CALC_BACKOFF( )
 #define AU915_NEXT_CHANNEL( )
+#define AU915_GET_TX_TIME_OFF( )
 #define AU915_CHANNEL_ADD( )
 #define AU915_CHANNEL_REMOVE( )
 #define AU915_SET_CONTINUOUS_WAVE( )
@@ -161,6 +165,7 @@
 #define CN470_ALTERNATE_DR( )                      CN470_CASE { return RegionCN470AlternateDr( currentDr, type ); }
 #define CN470_CALC_BACKOFF( )                      CN470_CASE { RegionCN470CalcBackOff( calcBackOff ); break; }
 #define CN470_NEXT_CHANNEL( )                      CN470_CASE { return RegionCN470NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define CN470_GET_TX_TIME_OFF( )                   CN470_CASE { return RegionCN470GetTxTimeOff( txTimeOff ); }
 #define CN470_CHANNEL_ADD( )                       CN470_CASE { return RegionCN470ChannelAdd( channelAdd ); }
 #define CN470_CHANNEL_REMOVE( )                    CN470_CASE { return RegionCN470ChannelsRemove( channelRemove ); }
 #define CN470_SET_CONTINUOUS_WAVE( )               CN470_CASE { RegionCN470SetContinuousWave( continuousWave ); break; }
@@ -186,6 +191,7 @@
 #define CN470_ALTERNATE_DR( )
 #define CN470_CALC_BACKOFF( )
 #define CN470_NEXT_CHANNEL( )
+#define CN470_GET_TX_TIME_OFF( )
 #define CN470_CHANNEL_ADD( )
 #define CN470_CHANNEL_REMOVE( )
 #define CN470_SET_CONTINUOUS_WAVE( )
@@ -215,6 +221,7 @@
 #define CN779_ALTERNATE_DR( )                      CN779_CASE { return RegionCN779AlternateDr( currentDr, type ); }
 #define CN779_CALC_BACKOFF( )                      CN779_CASE { RegionCN779CalcBackOff( calcBackOff ); break; }
 #define CN779_NEXT_CHANNEL( )                      CN779_CASE { return RegionCN779NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define CN779_GET_TX_TIME_OFF( )                   CN779_CASE { return RegionCN779GetTxTimeOff( txTimeOff ); }
 #define CN779_CHANNEL_ADD( )                       CN779_CASE { return RegionCN779ChannelAdd( channelAdd ); }
 #define CN779_CHANNEL_REMOVE( )                    CN779_CASE { return RegionCN779ChannelsRemove( channelRemove ); }
 #define CN779_SET_CONTINUOUS_WAVE( )               CN779_CASE { RegionCN779SetContinuousWave( continuousWave ); break; }
@@ -240,6 +247,7 @@
 #define CN779_ALTERNATE_DR( )
 #define CN779_CALC_BACKOFF( )
 #define CN779_NEXT_CHANNEL( )
+#define CN779_GET_TX_TIME_OFF( )
 #define CN779_CHANNEL_ADD( )
 #define CN779_CHANNEL_REMOVE( )
 #define CN779_SET_CONTINUOUS_WAVE( )
@@ -269,6 +277,7 @@
 #define EU433_ALTERNATE_DR( )                      EU433_CASE { return RegionEU433AlternateDr( currentDr, type ); }
 #define EU433_CALC_BACKOFF( )                      EU433_CASE { RegionEU433CalcBackOff( calcBackOff ); break; }
 #define EU433_NEXT_CHANNEL( )                      EU433_CASE { return RegionEU433NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define EU433_GET_TX_TIME_OFF( )                   EU433_CASE { return RegionEU433GetTxTimeOff( txTimeOff ); }
 #define EU433_CHANNEL_ADD( )                       EU433_CASE { return RegionEU433ChannelAdd( channelAdd ); }
 #define EU433_CHANNEL_REMOVE( )                    EU433_CASE { return RegionEU433ChannelsRemove( channelRemove ); }
 #define EU433_SET_CONTINUOUS_WAVE( )               EU433_CASE { RegionEU433SetContinuousWave( continuousWave ); break; }
@@ -294,6 +303,7 @@
 #define EU433_ALTERNATE_DR( )
 #define EU433_CALC_BACKOFF( )
 #define EU433_NEXT_CHANNEL( )
+#define EU433_GET_TX_TIME_OFF( )
 #define EU433_CHANNEL_ADD( )
 #define EU433_CHANNEL_REMOVE( )
 #define EU433_SET_CONTINUOUS_WAVE( )
@@ -323,6 +333,7 @@
 #define EU868_ALTERNATE_DR( )                      EU868_CASE { return RegionEU868AlternateDr( currentDr, type ); }
 #define EU868_CALC_BACKOFF( )                      EU868_CASE { RegionEU868CalcBackOff( calcBackOff ); break; }
 #define EU868_NEXT_CHANNEL( )                      EU868_CASE { return RegionEU868NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define EU868_GET_TX_TIME_OFF( )                   EU868_CASE { return RegionEU868GetTxTimeOff( txTimeOff ); }
 #define EU868_CHANNEL_ADD( )                       EU868_CASE { return RegionEU868ChannelAdd( channelAdd ); }
 #define EU868_CHANNEL_REMOVE( )                    EU868_CASE { return RegionEU868ChannelsRemove( channelRemove ); }
 #define EU868_SET_CONTINUOUS_WAVE( )               EU868_CASE { RegionEU868SetContinuousWave( continuousWave ); break; }
@@ -348,6 +359,7 @@
 #define EU868_ALTERNATE_DR( )
 #define EU868_CALC_BACKOFF( )
 #define EU868_NEXT_CHANNEL( )
+#define EU868_GET_TX_TIME_OFF( )
 #define EU868_CHANNEL_ADD( )
 #define EU868_CHANNEL_REMOVE( )
 #define EU868_SET_CONTINUOUS_WAVE( )
@@ -377,6 +389,7 @@
 #define KR920_ALTERNATE_DR( )                      KR920_CASE { return RegionKR920AlternateDr( currentDr, type ); }
 #define KR920_CALC_BACKOFF( )                      KR920_CASE { RegionKR920CalcBackOff( calcBackOff ); break; }
 #define KR920_NEXT_CHANNEL( )                      KR920_CASE { return RegionKR920NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define KR920_GET_TX_TIME_OFF( )                   KR920_CASE { return RegionKR920GetTxTimeOff( txTimeOff ); }
 #define KR920_CHANNEL_ADD( )                       KR920_CASE { return RegionKR920ChannelAdd( channelAdd ); }
 #define KR920_CHANNEL_REMOVE( )                    KR920_CASE { return RegionKR920ChannelsRemove( channelRemove ); }
 #define KR920_SET_CONTINUOUS_WAVE( )               KR920_CASE { RegionKR920SetContinuousWave( continuousWave ); break; }
@@ -402,6 +415,7 @@
 #define KR920_ALTERNATE_DR( )
 #define KR920_CALC_BACKOFF( )
 #define KR920_NEXT_CHANNEL( )
+#define KR920_GET_TX_TIME_OFF( )
 #define KR920_CHANNEL_ADD( )
 #define KR920_CHANNEL_REMOVE( )
 #define KR920_SET_CONTINUOUS_WAVE( )
@@ -431,6 +445,7 @@
 #define IN865_ALTERNATE_DR( )                      IN865_CASE { return RegionIN865AlternateDr( currentDr, type ); }
 #define IN865_CALC_BACKOFF( )                      IN865_CASE { RegionIN865CalcBackOff( calcBackOff ); break; }
 #define IN865_NEXT_CHANNEL( )                      IN865_CASE { return RegionIN865NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define IN865_GET_TX_TIME_OFF( )                   IN865_CASE { return RegionIN865GetTxTimeOff( txTimeOff ); }
 #define IN865_CHANNEL_ADD( )                       IN865_CASE { return RegionIN865ChannelAdd( channelAdd ); }
 #define IN865_CHANNEL_REMOVE( )                    IN865_CASE { return RegionIN865ChannelsRemove( channelRemove ); }
 #define IN865_SET_CONTINUOUS_WAVE( )               IN865_CASE { RegionIN865SetContinuousWave( continuousWave ); break; }
@@ -456,6 +471,7 @@
 #define IN865_ALTERNATE_DR( )
 #define IN865_CALC_BACKOFF( )
 #define IN865_NEXT_CHANNEL( )
+#define IN865_GET_TX_TIME_OFF( )
 #define IN865_CHANNEL_ADD( )
 #define IN865_CHANNEL_REMOVE( )
 #define IN865_SET_CONTINUOUS_WAVE( )
@@ -485,6 +501,7 @@
 #define US915_ALTERNATE_DR( )                      US915_CASE { return RegionUS915AlternateDr( currentDr, type ); }
 #define US915_CALC_BACKOFF( )                      US915_CASE { RegionUS915CalcBackOff( calcBackOff ); break; }
 #define US915_NEXT_CHANNEL( )                      US915_CASE { return RegionUS915NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define US915_GET_TX_TIME_OFF( )                   US915_CASE { return RegionUS915GetTxTimeOff( txTimeOff ); }
 #define US915_CHANNEL_ADD( )                       US915_CASE { return RegionUS915ChannelAdd( channelAdd ); }
 #define US915_CHANNEL_REMOVE( )                    US915_CASE { return RegionUS915ChannelsRemove( channelRemove ); }
 #define US915_SET_CONTINUOUS_WAVE( )               US915_CASE { RegionUS915SetContinuousWave( continuousWave ); break; }
@@ -510,6 +527,7 @@
 #define US915_ALTERNATE_DR( )
 #define US915_CALC_BACKOFF( )
 #define US915_NEXT_CHANNEL( )
+#define US915_GET_TX_TIME_OFF( )
 #define US915_CHANNEL_ADD( )
 #define US915_CHANNEL_REMOVE( )
 #define US915_SET_CONTINUOUS_WAVE( )
@@ -539,6 +557,7 @@
 #define RU864_ALTERNATE_DR( )                      RU864_CASE { return RegionRU864AlternateDr( currentDr, type ); }
 #define RU864_CALC_BACKOFF( )                      RU864_CASE { RegionRU864CalcBackOff( calcBackOff ); break; }
 #define RU864_NEXT_CHANNEL( )                      RU864_CASE { return RegionRU864NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define RU864_GET_TX_TIME_OFF( )                   RU864_CASE { return RegionRU864GetTxTimeOff( txTimeOff ); }
 #define RU864_CHANNEL_ADD( )                       RU864_CASE { return RegionRU864ChannelAdd( channelAdd ); }
 #define RU864_CHANNEL_REMOVE( )                    RU864_CASE { return RegionRU864ChannelsRemove( channelRemove ); }
 #define RU864_SET_CONTINUOUS_WAVE( )               RU864_CASE { RegionRU864SetContinuousWave( continuousWave ); break; }
@@ -564,6 +583,7 @@
 #define RU864_ALTERNATE_DR( )
 #define RU864_CALC_BACKOFF( )
 #define RU864_NEXT_CHANNEL( )
+#define RU864_GET_TX_TIME_OFF( )
 #define RU864_CHANNEL_ADD( )
 #define RU864_CHANNEL_REMOVE( )
 #define RU864_SET_CONTINUOUS_WAVE( )
@@ -971,6 +991,27 @@ LoRaMacStatus_t RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nex
     }
 }
 
+TimerTime_t RegionGetTxTimeOff( LoRaMacRegion_t region, GetTxTimeOffParams_t* txTimeOff )
+{
+    switch( region )
+    {
+        AS923_GET_TX_TIME_OFF( );
+        AU915_GET_TX_TIME_OFF( );
+        CN470_GET_TX_TIME_OFF( );
+        CN779_GET_TX_TIME_OFF( );
+        EU433_GET_TX_TIME_OFF( );
+        EU868_GET_TX_TIME_OFF( );
+        KR920_GET_TX_TIME_OFF( );
+        IN865_GET_TX_TIME_OFF( );
+        US915_GET_TX_TIME_OFF( );
+        RU864_GET_TX_TIME_OFF( );
+        default:
+        {
+            return 0;
+        }
+    }
+}
+
 LoRaMacStatus_t RegionChannelAdd( LoRaMacRegion_t region, ChannelAddParams_t* channelAdd )
 {
     switch( region )
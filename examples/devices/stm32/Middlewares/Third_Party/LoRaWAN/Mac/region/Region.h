@@ -1229,6 +1229,22 @@ typedef struct sNextChanParams
     bool DutyCycleEnabled;
 }NextChanParams_t;
 
+/*!
+ * Parameter structure for the function RegionGetTxTimeOff.
+ */
+typedef struct sGetTxTimeOffParams
+{
+    /*!
+     * Channel selection parameters of the next uplink, with the aggregated
+     * time-off of the last one.
+     */
+    NextChanParams_t NextChan;
+    /*!
+     * Back-off parameters of the last uplink.
+     */
+    CalcBackOffParams_t CalcBackOff;
+}GetTxTimeOffParams_t;
+
 /*!
  * Parameter structure for the function RegionChannelsAdd.
  */
@@ -1577,6 +1593,20 @@ void RegionCalcBackOff( LoRaMacRegion_t region, CalcBackOffParams_t* calcBackOff
  */
 LoRaMacStatus_t RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time to wait before the duty cycle lets the next uplink
+ *        go, as RegionCalcBackOff and RegionNextChannel would find it. Neither
+ *        the bands, the channel masks nor the aggregated time-off are updated,
+ *        no channel is drawn and no carrier sense is done.
+ *
+ * \param [IN] region LoRaWAN region.
+ *
+ * \param [IN] txTimeOff Pointer to the function parameters.
+ *
+ * \retval Time-off in ms, 0 when a channel is available now.
+ */
+TimerTime_t RegionGetTxTimeOff( LoRaMacRegion_t region, GetTxTimeOffParams_t* txTimeOff );
+
 /*!
  * \brief Adds a channel.
  *
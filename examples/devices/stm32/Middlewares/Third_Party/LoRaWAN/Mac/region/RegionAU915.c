@@ -963,6 +963,50 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     }
 }
 
+TimerTime_t RegionAU915GetTxTimeOff( GetTxTimeOffParams_t* txTimeOff )
+{
+    RegionCommonCalcBackOffParams_t calcBackOffParams;
+    Band_t bands[AU915_MAX_NB_BANDS];
+    uint16_t channelsMask[CHANNELS_MASK_SIZE];
+    uint8_t enabledChannels[AU915_MAX_NB_CHANNELS];
+    uint8_t delayTx = 0;
+    TimerTime_t nextTxDelay;
+
+    calcBackOffParams.Channels = NvmCtx.Channels;
+    calcBackOffParams.Bands = NvmCtx.Bands;
+    calcBackOffParams.LastTxIsJoinRequest = txTimeOff->CalcBackOff.LastTxIsJoinRequest;
+    calcBackOffParams.Joined = txTimeOff->CalcBackOff.Joined;
+    calcBackOffParams.DutyCycleEnabled = txTimeOff->CalcBackOff.DutyCycleEnabled;
+    calcBackOffParams.Channel = txTimeOff->CalcBackOff.Channel;
+    calcBackOffParams.ElapsedTime = txTimeOff->CalcBackOff.ElapsedTime;
+    calcBackOffParams.TxTimeOnAir = txTimeOff->CalcBackOff.TxTimeOnAir;
+
+    // Band time-offs after the back-off of the last uplink, in a copy
+    nextTxDelay = RegionCommonGetBandsTimeOff( &calcBackOffParams, bands, AU915_MAX_NB_BANDS );
+
+    // Channel mask as the next RegionAU915NextChannel sees it
+    RegionCommonChanMaskCopy( channelsMask, NvmCtx.ChannelsMaskRemaining, CHANNELS_MASK_SIZE );
+    if( RegionCommonCountChannels( channelsMask, 0, 4 ) == 0 )
+    { // Default channels reactivated
+        RegionCommonChanMaskCopy( channelsMask, NvmCtx.ChannelsMask, 4 );
+    }
+    if( txTimeOff->NextChan.Datarate >= DR_6 )
+    {
+        if( ( channelsMask[4] & CHANNELS_MASK_500KHZ_MASK ) == 0 )
+        {
+            channelsMask[4] = NvmCtx.ChannelsMask[4];
+        }
+    }
+
+    if( ( CountNbOfEnabledChannels( txTimeOff->NextChan.Datarate,
+                                    channelsMask, NvmCtx.Channels, bands, enabledChannels, &delayTx ) > 0 ) ||
+        ( delayTx == 0 ) )
+    { // A channel is available, or none supports the datarate
+        nextTxDelay = 0;
+    }
+    return MAX( nextTxDelay, RegionCommonGetAggregatedTimeOff( txTimeOff->NextChan.AggrTimeOff, txTimeOff->NextChan.LastAggrTx ) );
+}
+
 LoRaMacStatus_t RegionAU915ChannelAdd( ChannelAddParams_t* channelAdd )
 {
     return LORAMAC_STATUS_PARAMETER_INVALID;
@@ -444,6 +444,17 @@ void RegionCN470CalcBackOff( CalcBackOffParams_t* calcBackOff );
  */
 LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time to wait before the duty cycle lets the next uplink
+ *        go, without updating the bands, the channel mask nor the aggregated
+ *        time-off.
+ *
+ * \param [IN] txTimeOff Pointer to the function parameters.
+ *
+ * \retval Time-off in ms, 0 when a channel is available now.
+ */
+TimerTime_t RegionCN470GetTxTimeOff( GetTxTimeOffParams_t* txTimeOff );
+
 /*!
  * \brief Adds a channel.
  *
@@ -205,6 +205,28 @@ TimerTime_t RegionCommonUpdateBandTimeOff( bool joined, bool dutyCycle, Band_t*
     return nextTxDelay;
 }
 
+TimerTime_t RegionCommonGetBandsTimeOff( RegionCommonCalcBackOffParams_t* calcBackOffParams, Band_t* bands, uint8_t nbBands )
+{
+    RegionCommonCalcBackOffParams_t calcBackOff = *calcBackOffParams;
+
+    memcpy1( ( uint8_t* )bands, ( uint8_t* )calcBackOffParams->Bands, nbBands * sizeof( Band_t ) );
+    calcBackOff.Bands = bands;
+
+    RegionCommonCalcBackOff( &calcBackOff );
+    return RegionCommonUpdateBandTimeOff( calcBackOff.Joined, calcBackOff.DutyCycleEnabled, bands, nbBands );
+}
+
+TimerTime_t RegionCommonGetAggregatedTimeOff( TimerTime_t aggrTimeOff, TimerTime_t lastAggrTx )
+{
+    TimerTime_t elapsed = TimerGetElapsedTime( lastAggrTx );
+
+    if( aggrTimeOff <= elapsed )
+    {
+        return 0;
+    }
+    return aggrTimeOff - elapsed;
+}
+
 uint8_t RegionCommonParseLinkAdrReq( uint8_t* payload, RegionCommonLinkAdrParams_t* linkAdrParams )
 {
     uint8_t retIndex = 0;
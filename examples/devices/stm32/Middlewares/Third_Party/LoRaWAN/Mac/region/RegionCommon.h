@@ -313,6 +313,34 @@ void RegionCommonSetBandTxDone( bool joined, Band_t* band, TimerTime_t lastTxDon
  */
 TimerTime_t RegionCommonUpdateBandTimeOff( bool joined, bool dutyCycle, Band_t* bands, uint8_t nbBands );
 
+/*!
+ * \brief Computes the time-offs of the bands the next uplink will see, without
+ *        updating the bands: the back-off of the last uplink and the time-off
+ *        update are applied to a copy of them.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] calcBackOffParams The back-off parameters of the last uplink.
+ *
+ * \param [OUT] bands Copy of calcBackOffParams->Bands with the time-offs left.
+ *
+ * \param [IN] nbBands The number of bands available.
+ *
+ * \retval Returns the time which must be waited to perform the next uplink.
+ */
+TimerTime_t RegionCommonGetBandsTimeOff( RegionCommonCalcBackOffParams_t* calcBackOffParams, Band_t* bands, uint8_t nbBands );
+
+/*!
+ * \brief Computes the aggregated time-off left, without resetting it.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] aggrTimeOff The aggregated time-off of the last uplink.
+ *
+ * \param [IN] lastAggrTx The time of the last aggregated TX.
+ *
+ * \retval Returns the time which must be waited to perform the next uplink.
+ */
+TimerTime_t RegionCommonGetAggregatedTimeOff( TimerTime_t aggrTimeOff, TimerTime_t lastAggrTx );
+
 /*!
  * \brief Parses the parameter of an LinkAdrRequest.
  *        This is a generic function and valid for all regions.
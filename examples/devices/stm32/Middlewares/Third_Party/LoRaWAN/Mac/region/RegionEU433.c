@@ -905,6 +905,43 @@ LoRaMacStatus_t RegionEU433NextChannel( NextChanParams_t* nextChanParams, uint8_
     }
 }
 
+TimerTime_t RegionEU433GetTxTimeOff( GetTxTimeOffParams_t* txTimeOff )
+{
+    RegionCommonCalcBackOffParams_t calcBackOffParams;
+    Band_t bands[EU433_MAX_NB_BANDS];
+    uint16_t channelsMask[CHANNELS_MASK_SIZE];
+    uint8_t enabledChannels[EU433_MAX_NB_CHANNELS];
+    uint8_t delayTx = 0;
+    TimerTime_t nextTxDelay;
+
+    calcBackOffParams.Channels = NvmCtx.Channels;
+    calcBackOffParams.Bands = NvmCtx.Bands;
+    calcBackOffParams.LastTxIsJoinRequest = txTimeOff->CalcBackOff.LastTxIsJoinRequest;
+    calcBackOffParams.Joined = txTimeOff->CalcBackOff.Joined;
+    calcBackOffParams.DutyCycleEnabled = txTimeOff->CalcBackOff.DutyCycleEnabled;
+    calcBackOffParams.Channel = txTimeOff->CalcBackOff.Channel;
+    calcBackOffParams.ElapsedTime = txTimeOff->CalcBackOff.ElapsedTime;
+    calcBackOffParams.TxTimeOnAir = txTimeOff->CalcBackOff.TxTimeOnAir;
+
+    // Band time-offs after the back-off of the last uplink, in a copy
+    nextTxDelay = RegionCommonGetBandsTimeOff( &calcBackOffParams, bands, EU433_MAX_NB_BANDS );
+
+    // Channel mask as the next RegionEU433NextChannel sees it
+    RegionCommonChanMaskCopy( channelsMask, NvmCtx.ChannelsMask, CHANNELS_MASK_SIZE );
+    if( RegionCommonCountChannels( channelsMask, 0, 1 ) == 0 )
+    { // Default channels reactivated
+        channelsMask[0] |= LC( 1 ) + LC( 2 ) + LC( 3 );
+    }
+
+    if( ( CountNbOfEnabledChannels( txTimeOff->NextChan.Joined, txTimeOff->NextChan.Datarate,
+                                    channelsMask, NvmCtx.Channels, bands, enabledChannels, &delayTx ) > 0 ) ||
+        ( delayTx == 0 ) )
+    { // A channel is available, or none supports the datarate
+        nextTxDelay = 0;
+    }
+    return MAX( nextTxDelay, RegionCommonGetAggregatedTimeOff( txTimeOff->NextChan.AggrTimeOff, txTimeOff->NextChan.LastAggrTx ) );
+}
+
 LoRaMacStatus_t RegionEU433ChannelAdd( ChannelAddParams_t* channelAdd )
 {
     bool drInvalid = false;
@@ -0,0 +1,393 @@
+/**
+  ******************************************************************************
+  * @file    at_engine.c
+  * @author  MCD Application Team
+  * @brief   Non blocking AT command pipeline over a DMA serial link
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "at_engine.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/**
+ * Command waiting in the queue
+ */
+typedef struct
+{
+  char Cmd[AT_ENGINE_CMD_SIZE];
+  uint16_t Size;
+  uint32_t Timeout;
+  uint32_t Quiet;                 /* 0 when the response ends on a final result */
+  AtEngineLine_t *Line;
+  AtEngineDone_t *Done;
+  void *Context;
+} AtEngineCmd_t;
+
+/**
+ * State of the command at the head of the queue
+ */
+typedef enum
+{
+  AT_ENGINE_STATE_IDLE,       /* not sent yet, or the queue is empty */
+  AT_ENGINE_STATE_RESPONSE,   /* sent, waiting for the final result */
+  AT_ENGINE_STATE_DRAIN,      /* a late final result may still come, held */
+} AtEngineState_t;
+
+/* Private defines -----------------------------------------------------------*/
+#if (AT_ENGINE_RX_SIZE & (AT_ENGINE_RX_SIZE - 1)) != 0
+#error "AT_ENGINE_RX_SIZE must be a power of 2"
+#endif
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const AtEngineIo_t *Io;
+static AtEngineUrc_t *Urc;
+
+static AtEngineCmd_t Queue[AT_ENGINE_QUEUE_SIZE];
+static uint8_t QueueHead;                 /* running command */
+static uint8_t QueueCount;
+
+static AtEngineState_t State;
+static uint32_t StartTime;                /* of the transmission, or of the drain */
+static bool Overflow;                     /* a line of the response was truncated */
+static bool Answered;                     /* a line of the response was received */
+
+static uint8_t RxBuffer[AT_ENGINE_RX_SIZE];
+static uint32_t RxCount;                  /* bytes parsed, modulo 2^32 */
+static uint32_t RxTime;                   /* of the last bytes parsed */
+
+static char Line[AT_ENGINE_LINE_SIZE];
+static uint16_t LineLength;
+static bool LineTruncated;
+static bool LineSkipped;                  /* the start of the line was lost */
+
+/* Private function prototypes -----------------------------------------------*/
+static void AtEngineRxChar(char c);
+static void AtEngineRxOverrun(void);
+static void AtEngineDispatch(const char *line, bool truncated);
+static void AtEngineRun(void);
+static void AtEngineComplete(int16_t result);
+static void AtEngineDrain(void);
+
+/* Functions Definition ------------------------------------------------------*/
+void AtEngineInit(const AtEngineIo_t *io, AtEngineUrc_t *urc)
+{
+  Io = io;
+  Urc = urc;
+  QueueHead = 0;
+  QueueCount = 0;
+  State = AT_ENGINE_STATE_IDLE;
+  Overflow = false;
+  Answered = false;
+  RxCount = 0;
+  RxTime = io->GetTime();
+  LineLength = 0;
+  LineTruncated = false;
+  LineSkipped = false;
+}
+
+uint8_t *AtEngineGetRxBuffer(void)
+{
+  return RxBuffer;
+}
+
+bool AtEngineSubmit(const char *cmd, uint16_t size, uint32_t timeout,
+                    AtEngineLine_t *line, AtEngineDone_t *done, void *context)
+{
+  return AtEngineSubmitQuiet(cmd, size, timeout, 0, line, done, context);
+}
+
+bool AtEngineSubmitQuiet(const char *cmd, uint16_t size, uint32_t timeout, uint32_t quiet,
+                         AtEngineLine_t *line, AtEngineDone_t *done, void *context)
+{
+  AtEngineCmd_t *slot;
+
+  if ((QueueCount == AT_ENGINE_QUEUE_SIZE) || (size > AT_ENGINE_CMD_SIZE))
+  {
+    return false;
+  }
+
+  slot = &Queue[(QueueHead + QueueCount) % AT_ENGINE_QUEUE_SIZE];
+  memcpy(slot->Cmd, cmd, size);
+  slot->Size = size;
+  slot->Timeout = timeout;
+  slot->Quiet = quiet;
+  slot->Line = line;
+  slot->Done = done;
+  slot->Context = context;
+  QueueCount++;
+  return true;
+}
+
+void AtEngineProcess(void)
+{
+  uint32_t start = RxCount;
+  uint32_t count = Io->GetRxCount();
+
+  if ((count - start) > AT_ENGINE_RX_SIZE)
+  {
+    AtEngineRxOverrun();
+  }
+  else if (count != start)
+  {
+    RxTime = Io->GetTime();
+    while (RxCount != count)
+    {
+      AtEngineRxChar((char)RxBuffer[RxCount & (AT_ENGINE_RX_SIZE - 1)]);
+      RxCount++;
+    }
+
+    /* the receiver may have lapped the bytes while they were parsed */
+    if ((Io->GetRxCount() - start) > AT_ENGINE_RX_SIZE)
+    {
+      AtEngineRxOverrun();
+    }
+  }
+
+  AtEngineRun();
+}
+
+void AtEngineRxIdle(void)
+{
+  if (Io->Notify != NULL)
+  {
+    Io->Notify();
+  }
+}
+
+bool AtEngineIsIdle(void)
+{
+  return QueueCount == 0;
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Splits the bytes received into lines, the empty ones are skipped
+ * @param  c: byte received
+ * @retval None
+ */
+static void AtEngineRxChar(char c)
+{
+  if (c == '\n')
+  {
+    if ((LineLength != 0) && !LineSkipped)
+    {
+      Line[LineLength] = '\0';
+      AtEngineDispatch(Line, LineTruncated);
+    }
+    LineLength = 0;
+    LineTruncated = false;
+    LineSkipped = false;
+  }
+  else if (c != '\r')
+  {
+    if (LineLength < (AT_ENGINE_LINE_SIZE - 1))
+    {
+      Line[LineLength++] = c;
+    }
+    else
+    {
+      LineTruncated = true;
+    }
+  }
+}
+
+/**
+ * @brief  Skips the bytes the receiver overwrote before they were parsed: the
+ *         unread bytes and the line in progress are dropped, the running
+ *         command fails and the drain window opens, as its final result may
+ *         have been lost or may still come
+ * @param  None
+ * @retval None
+ */
+static void AtEngineRxOverrun(void)
+{
+  RxCount = Io->GetRxCount();
+  RxTime = Io->GetTime();
+  LineLength = 0;
+  LineTruncated = false;
+  LineSkipped = true;
+
+  if (State == AT_ENGINE_STATE_RESPONSE)
+  {
+    AtEngineComplete(AT_ENGINE_RX_OVERRUN);
+  }
+  else
+  {
+    AtEngineDrain();
+  }
+}
+
+/**
+ * @brief  Hands a line to the running command or to the unsolicited handler
+ * @param  line: line, without its end of line
+ * @param  truncated: the end of the line was dropped
+ * @retval None
+ */
+static void AtEngineDispatch(const char *line, bool truncated)
+{
+  AtEngineCmd_t *cmd = &Queue[QueueHead];
+  int16_t result = Io->Classify(line);
+
+  if (result == AT_ENGINE_URC)
+  {
+    if (Urc != NULL)
+    {
+      Urc(line);
+    }
+  }
+  else if (State != AT_ENGINE_STATE_RESPONSE)
+  {
+    if (result == AT_ENGINE_INFO)
+    {
+      if (Urc != NULL)
+      {
+        Urc(line);
+      }
+    }
+    else if (State == AT_ENGINE_STATE_DRAIN)
+    {
+      /* the late final result of the previous command, the next one may go */
+      State = AT_ENGINE_STATE_IDLE;
+    }
+  }
+  else if (result == AT_ENGINE_INFO)
+  {
+    Answered = true;
+    if (truncated)
+    {
+      Overflow = true;
+    }
+    if (cmd->Line != NULL)
+    {
+      cmd->Line(cmd->Context, line);
+    }
+  }
+  else
+  {
+    AtEngineComplete(Overflow ? AT_ENGINE_OVERFLOW : result);
+  }
+}
+
+/**
+ * @brief  Response state machine: times out the running command, closes the
+ *         drain window, then starts the next command when the link is free
+ * @param  None
+ * @retval None
+ */
+static void AtEngineRun(void)
+{
+  AtEngineCmd_t *cmd;
+  uint32_t now = Io->GetTime();
+
+  if (State == AT_ENGINE_STATE_RESPONSE)
+  {
+    cmd = &Queue[QueueHead];
+    if (cmd->Timeout == 0)
+    {
+      /* no response expected, the command buffer is released once sent */
+      if (!Io->IsTxBusy())
+      {
+        AtEngineComplete(0);
+      }
+    }
+    else if ((cmd->Quiet != 0) && Answered)
+    {
+      if ((now - RxTime) >= cmd->Quiet)
+      {
+        AtEngineComplete(0);
+      }
+    }
+    else if ((now - StartTime) >= cmd->Timeout)
+    {
+      AtEngineComplete(AT_ENGINE_TIMEOUT);
+    }
+  }
+
+  if (State == AT_ENGINE_STATE_DRAIN)
+  {
+    /* over once the line has been quiet since the window opened */
+    if (((now - StartTime) >= AT_ENGINE_DRAIN_TIME) && ((now - RxTime) >= AT_ENGINE_DRAIN_TIME))
+    {
+      State = AT_ENGINE_STATE_IDLE;
+    }
+  }
+
+  while ((State == AT_ENGINE_STATE_IDLE) && (QueueCount != 0) && !Io->IsTxBusy())
+  {
+    cmd = &Queue[QueueHead];
+    if (Io->Transmit((const uint8_t *)cmd->Cmd, cmd->Size))
+    {
+      State = AT_ENGINE_STATE_RESPONSE;
+      StartTime = Io->GetTime();
+      Overflow = false;
+      Answered = false;
+    }
+    else
+    {
+      AtEngineComplete(AT_ENGINE_TX_ERROR);
+    }
+  }
+}
+
+/**
+ * @brief  Removes the running command from the queue, then reports its result
+ * @param  result: final result code or AT_ENGINE_xxx error
+ * @retval None
+ */
+static void AtEngineComplete(int16_t result)
+{
+  AtEngineCmd_t *cmd = &Queue[QueueHead];
+  AtEngineDone_t *done = cmd->Done;
+  void *context = cmd->Context;
+  /* sent but completed without its final result, a late one may still come */
+  bool drain = (result == AT_ENGINE_TIMEOUT) || (result == AT_ENGINE_RX_OVERRUN) ||
+               ((cmd->Timeout == 0) && (result != AT_ENGINE_TX_ERROR));
+
+  /* released first, the handler may queue the next command */
+  QueueHead = (QueueHead + 1) % AT_ENGINE_QUEUE_SIZE;
+  QueueCount--;
+  State = AT_ENGINE_STATE_IDLE;
+  if (drain)
+  {
+    AtEngineDrain();
+  }
+
+  if (done != NULL)
+  {
+    done(context, result);
+  }
+}
+
+/**
+ * @brief  Opens the drain window after a command completed without its final
+ *         result: lines keep going to the unsolicited handler, a final result
+ *         is dropped and closes the window, else the window closes once the
+ *         line has been quiet for AT_ENGINE_DRAIN_TIME. No command is sent
+ *         meanwhile, so that a late final result cannot complete it
+ * @param  None
+ * @retval None
+ */
+static void AtEngineDrain(void)
+{
+  if (State == AT_ENGINE_STATE_IDLE)
+  {
+    State = AT_ENGINE_STATE_DRAIN;
+    StartTime = Io->GetTime();
+  }
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
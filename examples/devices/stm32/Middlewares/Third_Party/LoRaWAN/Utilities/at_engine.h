@@ -0,0 +1,181 @@
+/**
+  ******************************************************************************
+  * @file    at_engine.h
+  * @author  MCD Application Team
+  * @brief   Header for at_engine.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AT_ENGINE_H__
+#define __AT_ENGINE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Commands queued at once */
+#ifndef AT_ENGINE_QUEUE_SIZE
+#define AT_ENGINE_QUEUE_SIZE        4
+#endif
+
+/* Longest command, in bytes */
+#ifndef AT_ENGINE_CMD_SIZE
+#define AT_ENGINE_CMD_SIZE          80
+#endif
+
+/* Longest response line, terminating zero included */
+#ifndef AT_ENGINE_LINE_SIZE
+#define AT_ENGINE_LINE_SIZE         64
+#endif
+
+/* Receive ring, a power of 2. It holds the bytes received between two
+ * AtEngineProcess calls */
+#ifndef AT_ENGINE_RX_SIZE
+#define AT_ENGINE_RX_SIZE           256
+#endif
+
+/* Quiet time of the line, in ms, that closes the drain window: the window
+ * opens when a command completes without its final result (timeout, no
+ * response expected, receive overrun), the next command is held until then */
+#ifndef AT_ENGINE_DRAIN_TIME
+#define AT_ENGINE_DRAIN_TIME        500
+#endif
+
+/* Results of a command besides the final result codes of the modem (>= 0) */
+#define AT_ENGINE_TIMEOUT           -1    /* no final result in time */
+#define AT_ENGINE_TX_ERROR          -2    /* the transmission could not start */
+#define AT_ENGINE_OVERFLOW          -3    /* a response line was truncated */
+#define AT_ENGINE_RX_OVERRUN        -4    /* received bytes were overwritten */
+
+/* Classes of the response lines, besides the final result codes */
+#define AT_ENGINE_INFO              -1    /* response of the current command */
+#define AT_ENGINE_URC               -2    /* unsolicited result code */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Serial link of the modem. Transmit starts a transfer (e.g. DMA) and returns
+ * at once; the receiver writes the AT_ENGINE_RX_SIZE bytes of the ring
+ * returned by AtEngineGetRxBuffer circularly (e.g. circular DMA). GetRxCount
+ * returns the number of bytes written since AtEngineInit, modulo 2^32, so
+ * that a receiver lapping the unread bytes is detected.
+ */
+typedef struct
+{
+  bool (*Transmit)(const uint8_t *buff, uint16_t size);  /* false when it cannot start */
+  bool (*IsTxBusy)(void);
+  uint32_t (*GetRxCount)(void);                         /* bytes written, wrapping */
+  uint32_t (*GetTime)(void);                            /* in ms */
+  /* returns the final result code of a line, AT_ENGINE_INFO or AT_ENGINE_URC */
+  int16_t (*Classify)(const char *line);
+  /* called from AtEngineRxIdle, e.g. to wake up the main loop; may be NULL */
+  void (*Notify)(void);
+} AtEngineIo_t;
+
+/* response line of a command, in the order received */
+typedef void (AtEngineLine_t)(void *context, const char *line);
+
+/* final result code of a command, or AT_ENGINE_TIMEOUT, TX_ERROR, OVERFLOW or
+ * RX_OVERRUN */
+typedef void (AtEngineDone_t)(void *context, int16_t result);
+
+/* unsolicited line, or information line received while no command waits for
+ * a response */
+typedef void (AtEngineUrc_t)(const char *line);
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes the engine, the queue is empty
+ * @param  io: serial link, kept by reference
+ * @param  urc: unsolicited line handler, may be NULL
+ * @retval None
+ */
+void AtEngineInit(const AtEngineIo_t *io, AtEngineUrc_t *urc);
+
+/**
+ * @brief  Returns the receive ring, for the receiver to write into
+ * @param  None
+ * @retval AT_ENGINE_RX_SIZE bytes
+ */
+uint8_t *AtEngineGetRxBuffer(void);
+
+/**
+ * @brief  Queues a command, sent once the previous ones have completed
+ * @param  cmd: command, copied
+ * @param  size: size of the command, up to AT_ENGINE_CMD_SIZE
+ * @param  timeout: time allowed for the final result in ms from the start of
+ *         the transmission, 0 when the modem does not answer (e.g. reset):
+ *         the command completes once sent, then the drain window opens
+ * @param  line: response line handler, may be NULL
+ * @param  done: completion handler, may be NULL
+ * @param  context: passed to the handlers
+ * @retval false when the queue is full or the command too long
+ */
+bool AtEngineSubmit(const char *cmd, uint16_t size, uint32_t timeout,
+                    AtEngineLine_t *line, AtEngineDone_t *done, void *context);
+
+/**
+ * @brief  Queues a command of a modem without final result codes: its
+ *         response ends once the line has been quiet for quiet ms after the
+ *         first line, done then gets 0
+ * @param  cmd: command, copied
+ * @param  size: size of the command, up to AT_ENGINE_CMD_SIZE
+ * @param  timeout: time allowed for the first line in ms from the start of
+ *         the transmission
+ * @param  quiet: quiet time ending the response, in ms
+ * @param  line: response line handler, may be NULL
+ * @param  done: completion handler, may be NULL
+ * @param  context: passed to the handlers
+ * @retval false when the queue is full or the command too long
+ */
+bool AtEngineSubmitQuiet(const char *cmd, uint16_t size, uint32_t timeout, uint32_t quiet,
+                         AtEngineLine_t *line, AtEngineDone_t *done, void *context);
+
+/**
+ * @brief  Parses the bytes received, completes the commands and starts the
+ *         next one. The handlers are called from here. To be called from the
+ *         main loop when notified, and often enough for the timeouts
+ * @param  None
+ * @retval None
+ */
+void AtEngineProcess(void);
+
+/**
+ * @brief  Signals an idle line, from the UART interrupt
+ * @param  None
+ * @retval None
+ */
+void AtEngineRxIdle(void);
+
+/**
+ * @brief  Tells whether commands are queued or running
+ * @param  None
+ * @retval true when the queue is empty
+ */
+bool AtEngineIsIdle(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AT_ENGINE_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
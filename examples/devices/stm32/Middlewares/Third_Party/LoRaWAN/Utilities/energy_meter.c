@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    energy_meter.c
+  * @author  MCD Application Team
+  * @brief   Energy accounting from the MCU and radio state residency
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "utilities_conf.h"
+#include "energy_meter.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#ifndef ENERGY_SUPPLY_MV
+#define ENERGY_SUPPLY_MV              3300
+#endif
+#ifndef ENERGY_MCU_RUN_UA
+#define ENERGY_MCU_RUN_UA             4600
+#endif
+#ifndef ENERGY_MCU_SLEEP_UA
+#define ENERGY_MCU_SLEEP_UA           1300
+#endif
+#ifndef ENERGY_MCU_STOP_UA
+#define ENERGY_MCU_STOP_UA            1
+#endif
+#ifndef ENERGY_RADIO_SLEEP_UA
+#define ENERGY_RADIO_SLEEP_UA         1
+#endif
+#ifndef ENERGY_RADIO_STANDBY_UA
+#define ENERGY_RADIO_STANDBY_UA       1600
+#endif
+#ifndef ENERGY_RADIO_TX_UA
+#define ENERGY_RADIO_TX_UA            90000
+#endif
+#ifndef ENERGY_RADIO_RX_UA
+#define ENERGY_RADIO_RX_UA            11500
+#endif
+
+/* Private macros ------------------------------------------------------------*/
+#define ENERGY_UW( ua )               ( ( ( ua ) * ENERGY_SUPPLY_MV ) / 1000 )
+
+/* Private variables ---------------------------------------------------------*/
+/* Power drawn in each state, in uW */
+static const uint32_t EnergyRadioPower[] =
+{
+  ENERGY_UW( ENERGY_RADIO_SLEEP_UA ),
+  ENERGY_UW( ENERGY_RADIO_STANDBY_UA ),
+  ENERGY_UW( ENERGY_RADIO_TX_UA ),
+  ENERGY_UW( ENERGY_RADIO_RX_UA ),
+};
+
+static const uint32_t EnergyMcuPower[] =
+{
+  ENERGY_UW( ENERGY_MCU_RUN_UA ),
+  ENERGY_UW( ENERGY_MCU_SLEEP_UA ),
+  ENERGY_UW( ENERGY_MCU_STOP_UA ),
+};
+
+/* Energy integrated so far, in uW x RTC ticks */
+static uint64_t EnergyIntegral;
+/* Power drawn in the current states, in uW */
+static uint32_t EnergyPower;
+static EnergyRadioState_t EnergyRadio;
+static EnergyMcuState_t EnergyMcu;
+static uint32_t EnergyLastUpdate;
+static uint32_t EnergyTicksPerSecond;
+
+/* Integral value when each account was opened */
+static uint64_t EnergyMark[ENERGY_NB_ACCOUNTS];
+static uint8_t EnergyOpen[ENERGY_NB_ACCOUNTS];
+/* Integral value at the last statistics reset */
+static uint64_t EnergyResetMark;
+
+static EnergyStats_t EnergyStats;
+
+/* Private function prototypes -----------------------------------------------*/
+/**
+ * @brief  Integrates the current power up to now, to be called with IRQs disabled
+ * @param  None
+ * @retval Energy integral in uW x RTC ticks
+ */
+static uint64_t EnergyUpdate(void);
+
+/* Functions Definition ------------------------------------------------------*/
+void EnergyInit(void)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  EnergyTicksPerSecond = HW_RTC_ms2Tick(1000);
+  EnergyLastUpdate = HW_RTC_GetTimerValue();
+  EnergyIntegral = 0;
+  EnergyResetMark = 0;
+  EnergyRadio = ENERGY_RADIO_SLEEP;
+  EnergyMcu = ENERGY_MCU_RUN;
+  EnergyPower = EnergyRadioPower[EnergyRadio] + EnergyMcuPower[EnergyMcu];
+  memset1((uint8_t *)EnergyOpen, 0, sizeof(EnergyOpen));
+  memset1((uint8_t *)&EnergyStats, 0, sizeof(EnergyStats));
+
+  RESTORE_PRIMASK( );
+}
+
+void EnergySetRadioState(EnergyRadioState_t state)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  if (state != EnergyRadio)
+  {
+    EnergyUpdate();
+    EnergyRadio = state;
+    EnergyPower = EnergyRadioPower[EnergyRadio] + EnergyMcuPower[EnergyMcu];
+  }
+
+  RESTORE_PRIMASK( );
+}
+
+void EnergySetMcuState(EnergyMcuState_t state)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  if (state != EnergyMcu)
+  {
+    EnergyUpdate();
+    EnergyMcu = state;
+    EnergyPower = EnergyRadioPower[EnergyRadio] + EnergyMcuPower[EnergyMcu];
+  }
+
+  RESTORE_PRIMASK( );
+}
+
+void EnergyStart(EnergyAccount_t account)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  if (EnergyOpen[account] == 0)
+  {
+    EnergyMark[account] = EnergyUpdate();
+    EnergyOpen[account] = 1;
+  }
+
+  RESTORE_PRIMASK( );
+}
+
+uint32_t EnergyStop(EnergyAccount_t account)
+{
+  EnergyAccountStats_t *stats = &EnergyStats.Account[account];
+  uint32_t energy = 0;
+
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  if (EnergyOpen[account] != 0)
+  {
+    EnergyOpen[account] = 0;
+    energy = (uint32_t)((EnergyUpdate() - EnergyMark[account]) / EnergyTicksPerSecond);
+    stats->Count++;
+    stats->Last = energy;
+    stats->Total += energy;
+  }
+
+  RESTORE_PRIMASK( );
+
+  return energy;
+}
+
+void EnergyGetStats(EnergyStats_t *stats)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  EnergyStats.Total = (uint32_t)((EnergyUpdate() - EnergyResetMark) / EnergyTicksPerSecond);
+  *stats = EnergyStats;
+
+  RESTORE_PRIMASK( );
+}
+
+void EnergyResetStats(void)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  memset1((uint8_t *)&EnergyStats, 0, sizeof(EnergyStats));
+  EnergyResetMark = EnergyUpdate();
+
+  RESTORE_PRIMASK( );
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+static uint64_t EnergyUpdate(void)
+{
+  uint32_t now = HW_RTC_GetTimerValue();
+
+  /* intentional wrap around */
+  EnergyIntegral += (uint64_t)EnergyPower * (uint32_t)(now - EnergyLastUpdate);
+  EnergyLastUpdate = now;
+
+  return EnergyIntegral;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    energy_meter.h
+  * @author  MCD Application Team
+  * @brief   Header for energy_meter.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ENERGY_METER_H__
+#define __ENERGY_METER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Radio states, each with its own current in the board table
+ */
+typedef enum
+{
+  ENERGY_RADIO_SLEEP,
+  ENERGY_RADIO_STANDBY,       /* standby and frequency synthesis */
+  ENERGY_RADIO_TX,
+  ENERGY_RADIO_RX,            /* receive and CAD */
+} EnergyRadioState_t;
+
+/**
+ * MCU states, each with its own current in the board table
+ */
+typedef enum
+{
+  ENERGY_MCU_RUN,
+  ENERGY_MCU_SLEEP,
+  ENERGY_MCU_STOP,            /* stop and off modes */
+} EnergyMcuState_t;
+
+/**
+ * Accounts energy is attributed to. They may overlap: an uplink includes
+ * its Rx windows.
+ */
+typedef enum
+{
+  ENERGY_UPLINK,              /* first transmission of a data frame up to its MCPS confirm */
+  ENERGY_RX_WINDOW,           /* Rx window opening up to Rx done, error or timeout */
+  ENERGY_BEACON,              /* beacon window opening up to its end */
+  ENERGY_NB_ACCOUNTS
+} EnergyAccount_t;
+
+/**
+ * Energy spent per account, in uJ
+ */
+typedef struct
+{
+  uint32_t Count;             /* closed accounts */
+  uint32_t Last;              /* energy of the last closed account */
+  uint32_t Total;             /* energy of all closed accounts */
+} EnergyAccountStats_t;
+
+typedef struct
+{
+  uint32_t Total;             /* energy drawn by the MCU and the radio, in uJ */
+  EnergyAccountStats_t Account[ENERGY_NB_ACCOUNTS];
+} EnergyStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Starts the energy integration, the MCU running and the radio asleep
+ * @param  None
+ * @retval None
+ */
+void EnergyInit(void);
+
+/**
+ * @brief  Notifies a radio state transition, called by the radio driver
+ * @param  state: new radio state
+ * @retval None
+ */
+void EnergySetRadioState(EnergyRadioState_t state);
+
+/**
+ * @brief  Notifies an MCU state transition, called by the low power manager
+ * @param  state: new MCU state
+ * @retval None
+ */
+void EnergySetMcuState(EnergyMcuState_t state);
+
+/**
+ * @brief  Opens an account, does nothing when it is already open
+ * @param  account: account to open
+ * @retval None
+ */
+void EnergyStart(EnergyAccount_t account);
+
+/**
+ * @brief  Closes an account
+ * @param  account: account to close
+ * @retval energy spent since the account was opened in uJ, 0 if it was not open
+ */
+uint32_t EnergyStop(EnergyAccount_t account);
+
+/**
+ * @brief  Copies the energy statistics
+ * @param  stats: destination of the statistics
+ * @retval None
+ */
+void EnergyGetStats(EnergyStats_t *stats);
+
+/**
+ * @brief  Clears the energy statistics, open accounts stay open
+ * @param  None
+ * @retval None
+ */
+void EnergyResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ENERGY_METER_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    latency_stats.c
+  * @author  MCD Application Team
+  * @brief   Timer lateness and execution time instrumentation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "latency_stats.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static LatencyStats_t LatencyStats;
+
+#if ( LATENCY_STATS == 1 )
+static const char * const LatencyProbeName[LATENCY_NB_PROBES] =
+{
+  "timer cb",
+  "mac process",
+  "dio0",
+  "dio1",
+  "dio2",
+  "dio3",
+  "dio4",
+  "irqoff TimerStart",
+  "irqoff TimerStop",
+  "irqoff TraceSend",
+};
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+/* Functions Definition ------------------------------------------------------*/
+void LatencyInit(void)
+{
+#if ( LATENCY_STATS == 1 )
+#if ( __CORTEX_M >= 3 )
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  /* On Cortex-M0+ SysTick is already running for the HAL tick */
+  LatencyReset();
+#endif
+}
+
+uint32_t LatencyGetCycles(void)
+{
+#if defined( LATENCY_GET_CYCLES )
+  return LATENCY_GET_CYCLES();
+#elif ( __CORTEX_M >= 3 )
+  return DWT->CYCCNT;
+#else
+  uint32_t tick;
+  uint32_t val;
+
+  /* retry if the HAL tick moved while SysTick was read */
+  do
+  {
+    tick = HAL_GetTick();
+    val = SysTick->VAL;
+  } while (tick != HAL_GetTick());
+
+  return (tick * (SysTick->LOAD + 1)) + (SysTick->LOAD - val);
+#endif
+}
+
+void LatencyProbeAdd(LatencyProbe_t probe, uint32_t cycles)
+{
+  LatencyProbeStats_t *stats = &LatencyStats.Probe[probe];
+
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  stats->Count++;
+  stats->Total += cycles;
+  if (cycles > stats->Max)
+  {
+    stats->Max = cycles;
+  }
+
+  RESTORE_PRIMASK( );
+}
+
+void LatencyTimerAdd(void ( *callback )( void *context ), uint32_t lateTicks)
+{
+  LatencyTimerStats_t *stats = NULL;
+  uint32_t bin = 0;
+  uint32_t i;
+
+  while ((lateTicks >> bin) != 0)
+  {
+    bin++;
+  }
+  if (bin >= LATENCY_HIST_BINS)
+  {
+    bin = LATENCY_HIST_BINS - 1;
+  }
+
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  for (i = 0; i < LATENCY_NB_TIMERS; i++)
+  {
+    if ((LatencyStats.Timer[i].Callback == callback) || (LatencyStats.Timer[i].Callback == NULL))
+    {
+      stats = &LatencyStats.Timer[i];
+      break;
+    }
+  }
+
+  if (stats == NULL)
+  {
+    LatencyStats.TimerDropped++;
+  }
+  else
+  {
+    stats->Callback = callback;
+    if (stats->Hist[bin] != UINT16_MAX)
+    {
+      stats->Hist[bin]++;
+    }
+    if (lateTicks > stats->Max)
+    {
+      stats->Max = lateTicks;
+    }
+  }
+
+  RESTORE_PRIMASK( );
+}
+
+const LatencyStats_t *LatencyGetStats(void)
+{
+  return &LatencyStats;
+}
+
+void LatencyReset(void)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  memset1((uint8_t *)&LatencyStats, 0, sizeof(LatencyStats));
+
+  RESTORE_PRIMASK( );
+}
+
+void LatencyPrint(void)
+{
+#if ( LATENCY_STATS == 1 )
+  LatencyStats_t stats;
+  uint32_t i;
+  uint32_t j;
+
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  stats = LatencyStats;
+
+  RESTORE_PRIMASK( );
+
+  PRINTF("latency (cycles @ %uHz): section count max avg\n\r", SystemCoreClock);
+  for (i = 0; i < LATENCY_NB_PROBES; i++)
+  {
+    if (stats.Probe[i].Count != 0)
+    {
+      PRINTF("%s %u %u %u\n\r", LatencyProbeName[i], stats.Probe[i].Count,
+             stats.Probe[i].Max, stats.Probe[i].Total / stats.Probe[i].Count);
+    }
+  }
+
+  PRINTF("timer lateness (ticks): callback max hist[0,1,2,4..]\n\r");
+  for (i = 0; (i < LATENCY_NB_TIMERS) && (stats.Timer[i].Callback != NULL); i++)
+  {
+    PRINTF("%08X %u", (uint32_t)(uintptr_t)stats.Timer[i].Callback, stats.Timer[i].Max);
+    for (j = 0; j < LATENCY_HIST_BINS; j++)
+    {
+      PRINTF(" %u", stats.Timer[i].Hist[j]);
+    }
+    PRINTF("\n\r");
+  }
+  if (stats.TimerDropped != 0)
+  {
+    PRINTF("untracked expiries %u\n\r", stats.TimerDropped);
+  }
+#endif
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @file    latency_stats.h
+  * @author  MCD Application Team
+  * @brief   Header for latency_stats.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LATENCY_STATS_H__
+#define __LATENCY_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "utilities_conf.h"
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef LATENCY_STATS
+#define LATENCY_STATS                0
+#endif
+
+/* Number of timer callbacks tracked individually */
+#ifndef LATENCY_NB_TIMERS
+#define LATENCY_NB_TIMERS            16
+#endif
+
+/* Lateness histogram bins: bin 0 is on time, bin n counts a lateness in
+   [2^(n-1), 2^n[ RTC ticks, the last bin collects everything above */
+#define LATENCY_HIST_BINS            8
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Measured sections
+ */
+typedef enum
+{
+  LATENCY_TIMER_CB,           /* TimerIrqHandler callbacks (exec_cb) */
+  LATENCY_MAC_PROCESS,        /* LoRaMacProcess */
+  LATENCY_RADIO_DIO0,         /* SX1272/SX1276 OnDio0Irq .. OnDio4Irq */
+  LATENCY_RADIO_DIO1,
+  LATENCY_RADIO_DIO2,
+  LATENCY_RADIO_DIO3,
+  LATENCY_RADIO_DIO4,
+  LATENCY_IRQOFF_TIMER_START, /* IRQs disabled in TimerStart */
+  LATENCY_IRQOFF_TIMER_STOP,  /* IRQs disabled in TimerStop */
+  LATENCY_IRQOFF_TRACE,       /* IRQs disabled in TraceSend */
+  LATENCY_NB_PROBES
+} LatencyProbe_t;
+
+/**
+ * Execution time of a measured section, in core clock cycles
+ */
+typedef struct
+{
+  uint32_t Count;
+  uint32_t Max;
+  uint32_t Total;             /* wraps, Total / Count is meaningful until then */
+} LatencyProbeStats_t;
+
+/**
+ * Lateness of the callbacks of one timer, in RTC ticks, from the alarm the
+ * timer was coalesced on: its slack (TimerSetSlack) is not counted
+ */
+typedef struct
+{
+  void ( *Callback )( void *context ); /* identifies the timer, NULL when unused */
+  uint32_t Max;
+  uint16_t Hist[LATENCY_HIST_BINS];
+} LatencyTimerStats_t;
+
+/**
+ * Statistics read with MIB_LATENCY_STATS, a pointer to struct sLatencyStats in
+ * the MAC interface which does not depend on this configuration
+ */
+typedef struct sLatencyStats
+{
+  LatencyProbeStats_t Probe[LATENCY_NB_PROBES];
+  LatencyTimerStats_t Timer[LATENCY_NB_TIMERS];
+  uint32_t TimerDropped;      /* expiries of timers not fitting in Timer[] */
+} LatencyStats_t;
+
+/* Exported macros -----------------------------------------------------------*/
+#if ( LATENCY_STATS == 1 )
+/* LATENCY_START() declares the start variable, like BACKUP_PRIMASK() it must be
+   placed before the matching LATENCY_STOP() in the same scope */
+#define LATENCY_START()               uint32_t latency_start = LatencyGetCycles()
+#define LATENCY_STOP( probe )         LatencyProbeAdd( ( probe ), LatencyGetCycles() - latency_start )
+#define LATENCY_TIMER( cb, late )     LatencyTimerAdd( ( cb ), ( late ) )
+#else
+#define LATENCY_START()
+#define LATENCY_STOP( probe )
+#define LATENCY_TIMER( cb, late )
+#endif
+
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Starts the cycle counter: DWT CYCCNT on Cortex-M3/M4, SysTick
+ *         (down counter extended by the HAL tick) on Cortex-M0+
+ * @param  None
+ * @retval None
+ */
+void LatencyInit(void);
+
+/**
+ * @brief  Reads the cycle counter
+ * @note   On Cortex-M0+ the value is only monotonic if IRQs were not masked
+ *         across a SysTick reload. A platform with neither counter defines
+ *         LATENCY_GET_CYCLES() in hw_conf.h instead
+ * @param  None
+ * @retval Core clock cycles
+ */
+uint32_t LatencyGetCycles(void);
+
+/**
+ * @brief  Accounts one execution of a measured section
+ * @param  probe: measured section
+ * @param  cycles: duration in core clock cycles
+ * @retval None
+ */
+void LatencyProbeAdd(LatencyProbe_t probe, uint32_t cycles);
+
+/**
+ * @brief  Accounts one timer expiry
+ * @param  callback: callback of the expired timer
+ * @param  lateTicks: delay between the timer deadline and its dispatch, in RTC ticks
+ * @retval None
+ */
+void LatencyTimerAdd(void ( *callback )( void *context ), uint32_t lateTicks);
+
+/**
+ * @brief  Returns the statistics collected so far
+ * @param  None
+ * @retval Statistics, all zero when LATENCY_STATS is not set
+ */
+const LatencyStats_t *LatencyGetStats(void);
+
+/**
+ * @brief  Clears the statistics
+ * @param  None
+ * @retval None
+ */
+void LatencyReset(void);
+
+/**
+ * @brief  Dumps the statistics on the trace output (vcom)
+ * @param  None
+ * @retval None
+ */
+void LatencyPrint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LATENCY_STATS_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -20,14 +20,54 @@
 /* Includes ------------------------------------------------------------------*/
 #include "hw.h"
 #include "low_power_manager.h"
+#include "timeServer.h"
+#include "energy_meter.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
+#ifndef LPM_SLEEP_POWER_UW
+#define LPM_SLEEP_POWER_UW          3000
+#endif
+#ifndef LPM_STOP_POWER_UW
+#define LPM_STOP_POWER_UW           5
+#endif
+#ifndef LPM_OFF_POWER_UW
+#define LPM_OFF_POWER_UW            2
+#endif
+#ifndef LPM_STOP_TRANSITION_NJ
+#define LPM_STOP_TRANSITION_NJ      9000
+#endif
+#ifndef LPM_OFF_TRANSITION_NJ
+#define LPM_OFF_TRANSITION_NJ       400000
+#endif
+
+#if ( LPM_STOP_POWER_UW >= LPM_SLEEP_POWER_UW ) || ( LPM_OFF_POWER_UW >= LPM_STOP_POWER_UW )
+#error "LPM power figures must decrease from sleep to stop to off mode"
+#endif
+#if ( LPM_OFF_TRANSITION_NJ < LPM_STOP_TRANSITION_NJ )
+#error "LPM_OFF_TRANSITION_NJ must not be lower than LPM_STOP_TRANSITION_NJ"
+#endif
+
 /* Private macros ------------------------------------------------------------*/
+/* Idle time (ms, rounded up) above which the deeper mode spends less energy:
+   extraTransition [nJ] / powerSaved [uW] */
+#define LPM_BREAK_EVEN_MS( extraTransition, powerSaved ) \
+  ( ( ( extraTransition ) + ( powerSaved ) - 1 ) / ( powerSaved ) )
+
 /* Private variables ---------------------------------------------------------*/
 static uint32_t StopModeDisable = 0;
 static uint32_t OffModeDisable = 0;
 
+/* Break-even time of each mode against the next lighter one */
+static const uint32_t LPM_BreakEvenTime[LPM_OffMode + 1] =
+{
+  0,
+  LPM_BREAK_EVEN_MS( LPM_STOP_TRANSITION_NJ, LPM_SLEEP_POWER_UW - LPM_STOP_POWER_UW ),
+  LPM_BREAK_EVEN_MS( LPM_OFF_TRANSITION_NJ - LPM_STOP_TRANSITION_NJ, LPM_STOP_POWER_UW - LPM_OFF_POWER_UW ),
+};
+
+static LPM_Stats_t LPM_Stats;
+
 /* Global variables ----------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 /* Functions Definition ------------------------------------------------------*/
@@ -88,37 +128,85 @@ void LPM_SetStopMode(LPM_Id_t id, LPM_SetMode_t mode)
 
 void LPM_EnterLowPower(void)
 {
-  if( StopModeDisable )
+  LPM_GetMode_t mode = LPM_GetMode( );
+  uint32_t timeToEvent = TimerGetTimeToNextEvent( );
+  int16_t wakeUpTicks = HW_RTC_getMcuWakeUpTime( );
+  uint32_t wakeUpTime = ( wakeUpTicks > 0 ) ? HW_RTC_Tick2ms( wakeUpTicks ) : 0;
+  uint32_t start;
+
+  /**
+   * The vetoes give the deepest mode allowed, step back to a lighter mode
+   * while the next timer deadline is too close to amortize the transition
+   */
+  while( ( mode != LPM_SleepMode ) &&
+         ( timeToEvent < ( LPM_BreakEvenTime[mode] + wakeUpTime ) ) )
   {
-    /**
-     * SLEEP mode is required
-     */
-    LPM_EnterSleepMode();
-    LPM_ExitSleepMode();
+    mode = ( mode == LPM_OffMode ) ? LPM_StopMode : LPM_SleepMode;
+    LPM_Stats.Demotions++;
   }
-  else
-  { 
-    if( OffModeDisable )
+
+  start = HW_RTC_GetTimerValue( );
+
+  /* off mode is accounted at the stop mode current */
+  EnergySetMcuState( ( mode == LPM_SleepMode ) ? ENERGY_MCU_SLEEP : ENERGY_MCU_STOP );
+
+  switch( mode )
+  {
+    case LPM_SleepMode:
+    {
+      LPM_EnterSleepMode();
+      LPM_ExitSleepMode();
+      break;
+    }
+    case LPM_StopMode:
     {
-      /**
-       * STOP mode is required
-       */
       LPM_EnterStopMode();
       LPM_ExitStopMode();
+      break;
     }
-    else
+    default:
     {
-      /**
-       * OFF mode is required
-       */
       LPM_EnterOffMode();
       LPM_ExitOffMode();
+      break;
     }
   }
 
+  EnergySetMcuState( ENERGY_MCU_RUN );
+
+  LPM_Stats.Entries[mode]++;
+  LPM_Stats.Residency[mode] += HW_RTC_GetTimerValue( ) - start;
+
   return;
 }
 
+uint32_t LPM_GetBreakEvenTime(LPM_GetMode_t mode)
+{
+  return LPM_BreakEvenTime[mode];
+}
+
+void LPM_GetStats(LPM_Stats_t *stats)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  *stats = LPM_Stats;
+
+  RESTORE_PRIMASK( );
+}
+
+void LPM_ResetStats(void)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  memset1( ( uint8_t * )&LPM_Stats, 0, sizeof( LPM_Stats ) );
+
+  RESTORE_PRIMASK( );
+}
+
 LPM_GetMode_t LPM_GetMode(void)
 {
   LPM_GetMode_t mode_selected;
@@ -44,6 +44,16 @@ typedef enum
   LPM_OffMode,
 } LPM_GetMode_t;
 
+/**
+ * Low power residency counters, indexed by LPM_GetMode_t
+ */
+typedef struct
+{
+  uint32_t Entries[LPM_OffMode + 1];   /* number of times the mode was entered */
+  uint32_t Residency[LPM_OffMode + 1]; /* RTC ticks spent in the mode, exit included */
+  uint32_t Demotions;                  /* entries where a lighter mode than allowed was cheaper */
+} LPM_Stats_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
@@ -78,6 +88,28 @@ void LPM_SetOffMode(LPM_Id_t id, LPM_SetMode_t mode);
  */
 void LPM_EnterLowPower(void);
 
+/**
+ * @brief  Returns the idle time above which the given mode costs less energy than the next lighter one,
+ *         from the LPM_xxx_POWER_UW and LPM_xxx_TRANSITION_NJ costs
+ * @param  mode: LPM_StopMode or LPM_OffMode
+ * @retval break-even time in ms, 0 for LPM_SleepMode
+ */
+uint32_t LPM_GetBreakEvenTime(LPM_GetMode_t mode);
+
+/**
+ * @brief  Copies the low power residency counters
+ * @param  stats: destination of the counters
+ * @retval None
+ */
+void LPM_GetStats(LPM_Stats_t *stats);
+
+/**
+ * @brief  Clears the low power residency counters
+ * @param  None
+ * @retval None
+ */
+void LPM_ResetStats(void);
+
 /**
  * @brief  This API is called by the low power manager in a critical section (PRIMASK bit set) to allow the
  *         application to implement dedicated code before entering Sleep Mode
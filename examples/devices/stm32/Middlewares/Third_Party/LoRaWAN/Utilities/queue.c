@@ -18,208 +18,176 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
 #include <stdint.h>
+#include "hw.h"
 #include "queue.h"
 /* Private define ------------------------------------------------------------*/
-#define ELEMENT_SIZE_LEN 2
 /* Private typedef -----------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
+/* Orders the data accesses before the index update that publishes them */
+#define QUEUE_BARRIER()   __DMB()
 /* Private function prototypes -----------------------------------------------*/
-static void queue_copy(uint8_t* out, const uint8_t* in, uint16_t size);
-static int16_t circular_queue_get_free_size(queue_param_t* queue);
-static void add_elementSize_and_inc_writeIdx(queue_param_t* queue,uint16_t element_size);
 
 /* Public functions ----------------------------------------------------------*/
 void circular_queue_init(queue_param_t* queue, uint8_t* queue_buff, uint16_t queue_size)
 {
-  queue->queue_read_idx=0;
-  queue->queue_write_idx=0;
-  queue->queue_nb_element=0;
   queue->queue_buff=queue_buff;
   queue->queue_size=queue_size;
-  queue->queue_full=0;
+  queue->queue_write_idx=0;
+  queue->queue_wrap_idx=queue_size;
+  queue->queue_read_idx=0;
+  queue->queue_reserved_idx=0;
 }
 
-int circular_queue_add(queue_param_t* queue, uint8_t* buff, uint16_t buff_size)
+uint8_t* circular_queue_reserve(queue_param_t* queue, uint16_t size)
 {
-  int status;  
-  int16_t free_buff_len=circular_queue_get_free_size(queue);
-  
-  if ((buff_size+ELEMENT_SIZE_LEN<=free_buff_len)&& 
-      ((queue->queue_write_idx+buff_size+ELEMENT_SIZE_LEN<=queue->queue_size) 
-        || (queue->queue_write_idx>=queue->queue_size-ELEMENT_SIZE_LEN))) /*elementSize cut in 2 or elementSize at Top*/
+  uint16_t write_idx=queue->queue_write_idx;
+  uint16_t read_idx=queue->queue_read_idx;
+
+  QUEUE_BARRIER();
+
+  if (write_idx>=read_idx)
   {
-    //add in one element
-    add_elementSize_and_inc_writeIdx(queue, buff_size);
-    queue_copy(queue->queue_buff+queue->queue_write_idx,buff,buff_size);
-    queue->queue_write_idx+=buff_size;
-    /*modulo queue_size*/
-    if (queue->queue_write_idx==queue->queue_size)
+    /* data, if any, lies in [read_idx, write_idx[: try the end of the buffer first.
+       write_idx must not catch up read_idx, it would read as empty */
+    if ((write_idx+size<queue->queue_size) || 
+        ((write_idx+size==queue->queue_size) && (read_idx!=0)))
     {
-        queue->queue_write_idx=0;
+      queue->queue_reserved_idx=write_idx;
+      return queue->queue_buff+write_idx;
     }
-    //add one element
-    queue->queue_nb_element++; 
-    /*in case que is full*/
-    if (queue->queue_write_idx== queue->queue_read_idx)
+    /* then the start of the buffer */
+    if (size<read_idx)
     {
-      queue->queue_full=1;
+      queue->queue_reserved_idx=0;
+      return queue->queue_buff;
     }
-    status=0;
   }
-  else if (buff_size+2*ELEMENT_SIZE_LEN<=free_buff_len)
+  else if (write_idx+size<read_idx)
   {
-    //split buffer in two elements
-    /*fill top of queue with first element of size top_size*/
-    uint16_t top_size = queue->queue_size-(queue->queue_write_idx+ELEMENT_SIZE_LEN);
-    add_elementSize_and_inc_writeIdx(queue,top_size);
-    queue_copy(queue->queue_buff+queue->queue_write_idx,buff,top_size);
-    queue->queue_write_idx=0;
-
-    /*fill bottom of queue with second element of size buff_size-top_size*/
-    buff_size-=top_size;
-    add_elementSize_and_inc_writeIdx(queue, buff_size);
-    queue_copy(queue->queue_buff+queue->queue_write_idx,buff+top_size,buff_size);
-    queue->queue_write_idx+=buff_size;
-    // add two elements
-    queue->queue_nb_element+=2;
-    /*in case que is full*/
-    if (queue->queue_write_idx== queue->queue_read_idx)
-    {
-      queue->queue_full=1;
-    }    
-    status =0;
+    /* data lies in [read_idx, wrap_idx[ and [0, write_idx[ */
+    queue->queue_reserved_idx=write_idx;
+    return queue->queue_buff+write_idx;
   }
-  else
-  {
-    status=-1;
-  }
-  return status;
+  return NULL;
 }
 
-int circular_queue_get(queue_param_t* queue, uint8_t** buff, uint16_t* buff_size)
+uint8_t* circular_queue_reserve_max(queue_param_t* queue, uint16_t* size)
 {
-  int status;
-  if (queue->queue_nb_element==0)
+  uint16_t write_idx=queue->queue_write_idx;
+  uint16_t read_idx=queue->queue_read_idx;
+  uint16_t span;
+
+  QUEUE_BARRIER();
+
+  if (write_idx>=read_idx)
   {
-    status=-1;
+    /* the end of the buffer, the start is used by the next reservation */
+    span=queue->queue_size-write_idx-((read_idx==0)?1:0);
   }
   else
   {
-    uint16_t size;
-    uint16_t read_idx=queue->queue_read_idx;
-    /*retreive and remove 1st element' size and content*/
-    size=(uint16_t) queue->queue_buff[read_idx++]<<8;
-    /*wrap if needed*/
-    if (read_idx==queue->queue_size)
-    {
-      read_idx=0;
-    }
-    size|=(uint16_t) queue->queue_buff[read_idx++];
-    /*wrap if needed*/
-    if (read_idx==queue->queue_size)
-    {
-      read_idx=0;
-    }
-    *buff= queue->queue_buff+read_idx;
-
-    * buff_size=size;
-    status=0;
+    span=read_idx-write_idx-1;
   }
-  return status;
-}
-
-int circular_queue_remove(queue_param_t* queue)
-{
-  int status;
-  if (queue->queue_nb_element==0)
+  if (span==0)
   {
-      status=-1;
+    return NULL;
   }
-  else
+  if (*size>span)
   {
-    uint16_t size;
-    /*retreive and remove 1st element' size and content*/
-    size=(uint16_t) queue->queue_buff[queue->queue_read_idx++]<<8;
-    if (queue->queue_read_idx==queue->queue_size)
-    {
-      queue->queue_read_idx=0;
-    }
-    size|=(uint16_t) queue->queue_buff[queue->queue_read_idx++];
-    if (queue->queue_read_idx==queue->queue_size)
-    {
-      queue->queue_read_idx=0;
-    }
-    /* increment read index*/
-    queue->queue_read_idx+=size;
-    /*modulo queue_size*/
-    if (queue->queue_read_idx==queue->queue_size)
-    {
-        queue->queue_read_idx=0;
-    }
-    /* decrement number of element*/
-    queue->queue_nb_element--;
-    queue->queue_full=0;
-    status=0;
+    *size=span;
   }
-  return status;
+  queue->queue_reserved_idx=write_idx;
+  return queue->queue_buff+write_idx;
 }
 
-int circular_queue_sense(queue_param_t* queue)
+uint16_t circular_queue_get_free_size(queue_param_t* queue)
 {
-  int status;
-  if (queue->queue_nb_element==0)
-  {
-    status=-1;
-  }
-  else
+  uint16_t write_idx=queue->queue_write_idx;
+  uint16_t read_idx=queue->queue_read_idx;
+
+  QUEUE_BARRIER();
+
+  if (write_idx>=read_idx)
   {
-    status=0;
+    /* the end of the buffer and the start, one byte is kept free before read_idx */
+    return queue->queue_size-write_idx+read_idx-1;
   }
-  return status;
+  return read_idx-write_idx-1;
 }
 
-/* Private functions ---------------------------------------------------------*/
-static int16_t circular_queue_get_free_size(queue_param_t* queue)
+void circular_queue_commit(queue_param_t* queue, uint16_t size)
 {
-  int16_t free_size;
-  if (queue->queue_write_idx>=queue->queue_read_idx)
+  uint16_t write_idx=queue->queue_write_idx;
+  uint16_t new_write_idx=queue->queue_reserved_idx+size;
+
+  if ((queue->queue_reserved_idx!=write_idx) || (new_write_idx==queue->queue_size))
   {
-    free_size=queue->queue_size-(queue->queue_write_idx-queue->queue_read_idx); 
+    /* wrapped: the data before the wrap ends at the current write index */
+    if (new_write_idx==queue->queue_size)
+    {
+      write_idx=queue->queue_size;
+      new_write_idx=0;
+    }
+    queue->queue_wrap_idx=write_idx;
   }
-  else
+  /* publish the data, then the index */
+  QUEUE_BARRIER();
+  queue->queue_write_idx=new_write_idx;
+}
+
+int circular_queue_peek(queue_param_t* queue, uint8_t** buff, uint16_t* buff_size)
+{
+  uint16_t write_idx=queue->queue_write_idx;
+  uint16_t read_idx=queue->queue_read_idx;
+
+  QUEUE_BARRIER();
+
+  if (write_idx<read_idx)
   {
-    free_size=(queue->queue_read_idx-queue->queue_write_idx); 
+    if (read_idx==queue->queue_wrap_idx)
+    {
+      /* all data before the wrap is consumed */
+      read_idx=0;
+      queue->queue_read_idx=0;
+    }
+    else
+    {
+      *buff=queue->queue_buff+read_idx;
+      *buff_size=queue->queue_wrap_idx-read_idx;
+      return 0;
+    }
   }
-  if ( queue->queue_full==1)
+  if (write_idx==read_idx)
   {
-    free_size=0;
+    return -1;
   }
-  return free_size;
+  *buff=queue->queue_buff+read_idx;
+  *buff_size=write_idx-read_idx;
+  return 0;
 }
 
-static void queue_copy(uint8_t* out, const uint8_t* in, uint16_t size)
+void circular_queue_release(queue_param_t* queue, uint16_t size)
 {
-  while(size--)
+  uint16_t write_idx=queue->queue_write_idx;
+  uint16_t read_idx=queue->queue_read_idx+size;
+
+  if ((write_idx<read_idx) && (read_idx==queue->queue_wrap_idx))
   {
-    *out++= *in++;
+    read_idx=0;
   }
+  /* done with the data, then publish the index */
+  QUEUE_BARRIER();
+  queue->queue_read_idx=read_idx;
 }
 
-static void add_elementSize_and_inc_writeIdx(queue_param_t* queue,uint16_t element_size)
+int circular_queue_sense(queue_param_t* queue)
 {
-  queue->queue_buff[queue->queue_write_idx++]=(uint8_t) (element_size>>8);
-  /*wrap if needed*/
-  if ( queue->queue_write_idx == queue->queue_size)
-  {
-    queue->queue_write_idx=0;
-  }
-  queue->queue_buff[queue->queue_write_idx++]=(uint8_t) (element_size);
-  /*wrap if needed*/
-  if ( queue->queue_write_idx == queue->queue_size)
-  {
-    queue->queue_write_idx=0;
-  }
+  uint8_t* buff;
+  uint16_t buff_size;
+
+  return circular_queue_peek(queue, &buff, &buff_size);
 }
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
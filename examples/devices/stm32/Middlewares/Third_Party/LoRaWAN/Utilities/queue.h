@@ -22,15 +22,20 @@
 #define __UTIL_QUEUE_H
 
 /* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
 /* Exported types ------------------------------------------------------------*/
 
+/* Single producer / single consumer byte ring. Data is always reserved
+   contiguously, so the consumer can hand any peeked span to a DMA as is.
+   The producer only writes write_idx and wrap_idx, the consumer only writes
+   read_idx, hence no interrupt masking is needed between the two sides. */
 typedef struct{
-    uint16_t queue_read_idx;          //read index in the queue
-    uint16_t queue_write_idx;         //write index in the queue
-    uint16_t queue_nb_element;//number of element in the queue
-    uint16_t queue_size;      //size in bytes if the queue
-    uint8_t* queue_buff;      //queue buffer pointer
-    uint8_t  queue_full;      //manage when queue_write_idx is equel to read_idx after adding
+    uint8_t* queue_buff;                /* queue buffer pointer */
+    uint16_t queue_size;                /* size in bytes of the queue */
+    volatile uint16_t queue_write_idx;  /* end of the committed data, producer owned */
+    volatile uint16_t queue_wrap_idx;   /* end of the data before the last wrap, producer owned */
+    volatile uint16_t queue_read_idx;   /* start of the committed data, consumer owned */
+    uint16_t queue_reserved_idx;        /* start of the pending reservation, producer owned */
 } queue_param_t;
 
 
@@ -40,47 +45,68 @@ typedef struct{
 /* Exported functions ------------------------------------------------------- */ 
 
 /**
-  * @brief   init circular queue with queue_buff and its queue_size
-  * @param  queue: pointer on queue structure   to be handled
-  * @param  queue_buff; pointer on element(s) to be added 
-  * @param  queue_size:  of queue_buff in Bytes
+  * @brief  init circular queue with queue_buff and its queue_size
+  * @param  queue: pointer on queue structure to be handled
+  * @param  queue_buff: pointer on the queue buffer
+  * @param  queue_size: size of queue_buff in Bytes
   */
 void circular_queue_init(queue_param_t* queue, uint8_t* queue_buff, uint16_t queue_size);
 
 /**
-  * @brief  queue_add the buff in the queue
-  * @note   buff can be added in one element, or splitted in 2 elements when added at end of the queue buffer
+  * @brief  reserve contiguous space at the end of the queue (producer)
+  * @note   the data is not visible to the consumer before circular_queue_commit
   * @param  queue: pointer on queue structure to be handled
-  * @param  buff the buffer to be added on the queue
-  * @param  buff_size the size of buff to be added
-  * @retval 0 when OK, return -1 when no space left
+  * @param  size: number of bytes to reserve
+  * @retval pointer on the reserved space, NULL when no contiguous space is left
   */
-int circular_queue_add(queue_param_t* queue, uint8_t* buff, uint16_t buff_size);
+uint8_t* circular_queue_reserve(queue_param_t* queue, uint16_t size);
 
 /**
-  * @brief  queue_add the buff in the queue
-  * @note   sense if elements are present in the queue
+  * @brief  reserve the first contiguous space available, up to size bytes (producer)
+  * @note   used to split data over the end of the buffer: after committing this
+  *         reservation, the next one starts at the beginning of the buffer
   * @param  queue: pointer on queue structure to be handled
-  * @retval return 0 when element(s) in the queue, return -1 no element in the queue
+  * @param  size: number of bytes wanted, updated with the number of bytes reserved
+  * @retval pointer on the reserved space, NULL when the queue is full
   */
-int circular_queue_sense(queue_param_t* queue);
+uint8_t* circular_queue_reserve_max(queue_param_t* queue, uint16_t* size);
+
+/**
+  * @brief  number of bytes the producer can still write, split or not (producer)
+  * @param  queue: pointer on queue structure to be handled
+  * @retval number of free bytes
+  */
+uint16_t circular_queue_get_free_size(queue_param_t* queue);
 
 /**
-  * @brief  retreive head element from the queue 
-  * @note   removes only one element
+  * @brief  publish the data written in the last reservation (producer)
   * @param  queue: pointer on queue structure to be handled
-  * @param  buff pointer on the head element retreived
-  * @param  buff_size the size of head element
-  * @retval return 0 when element in the queue, return -1 no element in the queue
+  * @param  size: number of bytes written, at most the reserved size
   */
-int circular_queue_get(queue_param_t* queue, uint8_t** buff, uint16_t* buff_size);
+void circular_queue_commit(queue_param_t* queue, uint16_t size);
 
 /**
-  * @brief  remove head element from the queue 
-  * @note   removes only one element
+  * @brief  get the oldest contiguous span of committed data (consumer)
+  * @note   the span may hold several committed elements
   * @param  queue: pointer on queue structure to be handled
-  * @retval return 0 when element in the queue, return -1 no element in the queue
+  * @param  buff: pointer on the span
+  * @param  buff_size: size of the span
+  * @retval return 0 when data is available, return -1 when the queue is empty
   */
-int circular_queue_remove(queue_param_t* queue);
+int circular_queue_peek(queue_param_t* queue, uint8_t** buff, uint16_t* buff_size);
+
+/**
+  * @brief  release data returned by circular_queue_peek (consumer)
+  * @param  queue: pointer on queue structure to be handled
+  * @param  size: number of bytes to release, at most the peeked size
+  */
+void circular_queue_release(queue_param_t* queue, uint16_t size);
+
+/**
+  * @brief  sense if data is present in the queue
+  * @param  queue: pointer on queue structure to be handled
+  * @retval return 0 when data is in the queue, return -1 when the queue is empty
+  */
+int circular_queue_sense(queue_param_t* queue);
 
 #endif //UTIL_QUEUE
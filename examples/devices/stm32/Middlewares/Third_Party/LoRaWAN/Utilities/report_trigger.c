@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file    report_trigger.c
+  * @author  MCD Application Team
+  * @brief   Uplinks triggered by the changes of the samples
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "report_trigger.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t ReportDistance(int16_t a, int16_t b);
+
+/* Functions Definition ------------------------------------------------------*/
+void ReportInit(ReportChannel_t *channel, const ReportRule_t *rule, uint32_t now)
+{
+  channel->Rule = rule;
+  channel->Reported = 0;
+  channel->Previous = 0;
+  /* as if the minimum interval had just elapsed; the times wrap around */
+  channel->ReportTime = now - rule->MinInterval;
+  channel->Sampled = false;
+  channel->Above = false;
+  channel->Triggered = true;
+}
+
+bool ReportSample(ReportChannel_t *channel, int16_t sample)
+{
+  const ReportRule_t *rule = channel->Rule;
+  bool triggered = false;
+
+  if (!channel->Sampled)
+  {
+    /* the first sample is reported anyway, it only sets the threshold state */
+    channel->Above = (rule->Hysteresis != 0) && (sample >= rule->Threshold);
+  }
+  else
+  {
+    if ((rule->Deadband != 0) &&
+        (ReportDistance(sample, channel->Reported) >= (uint32_t)rule->Deadband))
+    {
+      triggered = true;
+    }
+    if ((rule->RateOfChange != 0) &&
+        (ReportDistance(sample, channel->Previous) >= (uint32_t)rule->RateOfChange))
+    {
+      triggered = true;
+    }
+    /* the samples must go back below Threshold - Hysteresis to trigger the
+     * next rising crossing, the noise around the threshold is ignored */
+    if (rule->Hysteresis != 0)
+    {
+      if (!channel->Above && (sample >= rule->Threshold))
+      {
+        channel->Above = true;
+        triggered = true;
+      }
+      else if (channel->Above && ((int32_t)sample <= ((int32_t)rule->Threshold - rule->Hysteresis)))
+      {
+        channel->Above = false;
+        triggered = true;
+      }
+    }
+  }
+
+  channel->Previous = sample;
+  channel->Sampled = true;
+  if (triggered)
+  {
+    channel->Triggered = true;
+  }
+  return triggered;
+}
+
+uint32_t ReportGetDelay(const ReportChannel_t *channels, uint8_t nb, uint32_t now)
+{
+  const ReportRule_t *rule;
+  uint32_t delay = REPORT_NONE;
+  uint32_t elapsed;
+  uint32_t due;
+  uint8_t i;
+
+  for (i = 0; i < nb; i++)
+  {
+    rule = channels[i].Rule;
+    elapsed = now - channels[i].ReportTime;
+    if (channels[i].Triggered)
+    {
+      due = (elapsed >= rule->MinInterval) ? 0 : (rule->MinInterval - elapsed);
+      if (due < delay)
+      {
+        delay = due;
+      }
+    }
+    if (rule->MaxInterval != 0)
+    {
+      due = (elapsed >= rule->MaxInterval) ? 0 : (rule->MaxInterval - elapsed);
+      if (due < delay)
+      {
+        delay = due;
+      }
+    }
+  }
+  return delay;
+}
+
+void ReportDone(ReportChannel_t *channels, uint8_t nb, uint32_t now)
+{
+  uint8_t i;
+
+  for (i = 0; i < nb; i++)
+  {
+    channels[i].Reported = channels[i].Previous;
+    channels[i].ReportTime = now;
+    /* a channel not sampled yet is reported with its first sample */
+    channels[i].Triggered = !channels[i].Sampled;
+  }
+}
+
+void ReportPostpone(ReportChannel_t *channels, uint8_t nb, uint32_t now)
+{
+  uint8_t i;
+
+  for (i = 0; i < nb; i++)
+  {
+    channels[i].ReportTime = now;
+  }
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Returns the distance between two samples, without overflow
+ * @param  a: sample
+ * @param  b: sample
+ * @retval |a - b|
+ */
+static uint32_t ReportDistance(int16_t a, int16_t b)
+{
+  int32_t difference = (int32_t)a - b;
+
+  return (difference < 0) ? (uint32_t)(-difference) : (uint32_t)difference;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
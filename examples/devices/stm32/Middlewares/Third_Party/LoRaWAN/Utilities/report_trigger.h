@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file    report_trigger.h
+  * @author  MCD Application Team
+  * @brief   Header for report_trigger.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __REPORT_TRIGGER_H__
+#define __REPORT_TRIGGER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* No report is due */
+#define REPORT_NONE                 UINT32_MAX
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Conditions on the samples of one sensor that call for an uplink, in the
+ * unit of the samples. Times are in ms.
+ */
+typedef struct
+{
+  int16_t Deadband;           /* change from the value last reported, 0 to disable */
+  int16_t RateOfChange;       /* change from the previous sample, 0 to disable */
+  int16_t Threshold;          /* level whose crossings are reported */
+  int16_t Hysteresis;         /* of the falling crossing, 0 disables the threshold */
+  uint32_t MinInterval;       /* a triggered report waits until then after the last one */
+  uint32_t MaxInterval;       /* reported at least that often, 0 to disable */
+} ReportRule_t;
+
+/**
+ * State of the rule of one sensor
+ */
+typedef struct
+{
+  const ReportRule_t *Rule;
+  int16_t Reported;           /* sample value when last reported */
+  int16_t Previous;           /* previous sample */
+  uint32_t ReportTime;        /* time of the last report */
+  bool Sampled;               /* Previous is valid */
+  bool Above;                 /* the samples are past the threshold */
+  bool Triggered;             /* a change waits to be reported */
+} ReportChannel_t;
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes a channel, its first sample is reported right away
+ * @param  channel: channel to initialize
+ * @param  rule: rule of the channel, kept by reference
+ * @param  now: current time in ms
+ * @retval None
+ */
+void ReportInit(ReportChannel_t *channel, const ReportRule_t *rule, uint32_t now);
+
+/**
+ * @brief  Evaluates the rule of a channel on a new sample
+ * @param  channel: channel
+ * @param  sample: sample
+ * @retval true when the sample triggers a report
+ */
+bool ReportSample(ReportChannel_t *channel, int16_t sample);
+
+/**
+ * @brief  Returns the time left before a report is due on any of the channels
+ * @param  channels: channels sent together in an uplink
+ * @param  nb: number of channels
+ * @param  now: current time in ms
+ * @retval delay in ms, 0 when due now, REPORT_NONE when nothing is due
+ */
+uint32_t ReportGetDelay(const ReportChannel_t *channels, uint8_t nb, uint32_t now);
+
+/**
+ * @brief  Records the uplink of the last sample of all the channels
+ * @param  channels: channels sent together in an uplink
+ * @param  nb: number of channels
+ * @param  now: current time in ms
+ * @retval None
+ */
+void ReportDone(ReportChannel_t *channels, uint8_t nb, uint32_t now);
+
+/**
+ * @brief  Restarts the intervals of the channels, keeping their triggers, when
+ *         the uplink was refused
+ * @param  channels: channels sent together in an uplink
+ * @param  nb: number of channels
+ * @param  now: current time in ms
+ * @retval None
+ */
+void ReportPostpone(ReportChannel_t *channels, uint8_t nb, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REPORT_TRIGGER_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file    retrans_policy.c
+  * @author  MCD Application Team
+  * @brief   Adaptive retransmission policy of the confirmed uplinks
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "utilities.h"
+#include "retrans_policy.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* ACK rate of 100 %, in 1/256 units */
+#define RETRANS_RATE_ONE              256
+/* Weight of a transmission in the ACK rate, 1/8 */
+#define RETRANS_RATE_SHIFT            3
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* The trials requested by the application, no back-off, no age limit */
+static const RetransAdaptiveConfig_t RetransDefaultConfig = { 0, 0, 0, 0, 0 };
+
+static const RetransAdaptiveConfig_t *RetransConfig = &RetransDefaultConfig;
+static uint16_t RetransAckRate = RETRANS_RATE_ONE;
+static bool RetransFresher = false;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t RetransGetNbTrials(uint8_t nbTrials);
+static uint32_t RetransGetBackoff(uint8_t retry);
+static bool RetransStepDownDatarate(uint8_t retry);
+static bool RetransIsStale(uint32_t age);
+static void RetransOnResult(bool ackReceived, uint8_t nbTrans);
+
+/* Exported variables --------------------------------------------------------*/
+const RetransPolicy_t RetransAdaptivePolicy =
+{
+  RetransGetNbTrials,
+  RetransGetBackoff,
+  RetransStepDownDatarate,
+  RetransIsStale,
+  RetransOnResult
+};
+
+/* Functions Definition ------------------------------------------------------*/
+void RetransAdaptiveInit(const RetransAdaptiveConfig_t *config)
+{
+  RetransConfig = config;
+  RetransAckRate = RETRANS_RATE_ONE;
+  RetransFresher = false;
+}
+
+void RetransFresherData(void)
+{
+  RetransFresher = true;
+}
+
+uint16_t RetransGetAckRate(void)
+{
+  return RetransAckRate;
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+static uint8_t RetransGetNbTrials(uint8_t nbTrials)
+{
+  const RetransAdaptiveConfig_t *config = RetransConfig;
+
+  /* a new frame, nothing fresher than it yet */
+  RetransFresher = false;
+
+  if (config->MaxTrials == 0)
+  {
+    return nbTrials;
+  }
+  /* when most transmissions are lost the cell is congested: retransmitting
+   * adds to the collisions and rarely gets the ACK sooner */
+  return config->MinTrials +
+         (((uint32_t)(config->MaxTrials - config->MinTrials) * RetransAckRate + RETRANS_RATE_ONE / 2) >> 8);
+}
+
+static uint32_t RetransGetBackoff(uint8_t retry)
+{
+  const RetransAdaptiveConfig_t *config = RetransConfig;
+  uint32_t mean = config->BackoffBase;
+
+  if (mean == 0)
+  {
+    return 0;
+  }
+  while ((retry > 1) && (mean < config->BackoffMax))
+  {
+    mean <<= 1;
+    retry--;
+  }
+  if (mean > config->BackoffMax)
+  {
+    mean = config->BackoffMax;
+  }
+  /* uniform over [mean / 2, 3 * mean / 2], the nodes that collided together
+   * do not retransmit together */
+  return (uint32_t)randr((int32_t)(mean / 2), (int32_t)(mean + mean / 2));
+}
+
+static bool RetransStepDownDatarate(uint8_t retry)
+{
+  /* every second retransmission as the MAC does, unless the losses look like
+   * collisions: a longer frame would collide more */
+  return ((retry % 2) == 0) && (RetransAckRate >= RETRANS_RATE_ONE / 2);
+}
+
+static bool RetransIsStale(uint32_t age)
+{
+  if (RetransFresher)
+  {
+    RetransFresher = false;
+    return true;
+  }
+  return (RetransConfig->MaxAge != 0) && (age >= RetransConfig->MaxAge);
+}
+
+static void RetransOnResult(bool ackReceived, uint8_t nbTrans)
+{
+  uint8_t lost = nbTrans;
+
+  if (ackReceived && (lost > 0))
+  {
+    lost--;
+  }
+
+  while (lost-- > 0)
+  {
+    RetransAckRate -= RetransAckRate >> RETRANS_RATE_SHIFT;
+  }
+  if (ackReceived)
+  {
+    RetransAckRate += (RETRANS_RATE_ONE - RetransAckRate) >> RETRANS_RATE_SHIFT;
+  }
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
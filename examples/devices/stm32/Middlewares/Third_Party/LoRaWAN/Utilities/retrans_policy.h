@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+  * @file    retrans_policy.h
+  * @author  MCD Application Team
+  * @brief   Header for retrans_policy.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __RETRANS_POLICY_H__
+#define __RETRANS_POLICY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Retransmission policy of the confirmed uplinks, set with MIB_RETRANS_POLICY.
+ * A NULL hook keeps the behaviour of the MAC. Times are in ms.
+ */
+typedef struct
+{
+  /**
+   * @brief  Returns the trials of a new confirmed uplink
+   * @param  nbTrials: trials requested by the application
+   * @retval trials, from 1 to MAX_ACK_RETRIES
+   */
+  uint8_t (*GetNbTrials)(uint8_t nbTrials);
+  /**
+   * @brief  Returns the delay of a retransmission, after the ACK timeout
+   * @param  retry: 1 for the first retransmission
+   * @retval delay in ms
+   */
+  uint32_t (*GetBackoff)(uint8_t retry);
+  /**
+   * @brief  Tells whether a retransmission lowers the datarate
+   * @param  retry: 1 for the first retransmission
+   * @retval true to use the next lower datarate
+   */
+  bool (*StepDownDatarate)(uint8_t retry);
+  /**
+   * @brief  Tells whether the frame is abandoned instead of retransmitted
+   * @param  age: time since the first transmission of the frame
+   * @retval true to abandon the frame
+   */
+  bool (*IsStale)(uint32_t age);
+  /**
+   * @brief  Reports the outcome of a confirmed uplink
+   * @param  ackReceived: the frame was acknowledged
+   * @param  nbTrans: transmissions of the frame
+   * @retval None
+   */
+  void (*OnResult)(bool ackReceived, uint8_t nbTrans);
+} RetransPolicy_t;
+
+/**
+ * Parameters of the adaptive policy. Times are in ms.
+ */
+typedef struct
+{
+  uint8_t MinTrials;          /* trials when no transmission is acknowledged */
+  uint8_t MaxTrials;          /* trials when every transmission is acknowledged */
+  uint32_t BackoffBase;       /* mean delay of the first retransmission, 0 to disable */
+  uint32_t BackoffMax;        /* cap of the mean delay, doubled on each retransmission */
+  uint32_t MaxAge;            /* older frames are abandoned, 0 to disable */
+} RetransAdaptiveConfig_t;
+
+/* External variables --------------------------------------------------------*/
+/**
+ * Adaptive policy: the trials follow the recent ACK rate, the retransmissions
+ * wait a randomized exponential back-off, the datarate is only lowered while
+ * most transmissions are acknowledged and the stale frames are abandoned
+ */
+extern const RetransPolicy_t RetransAdaptivePolicy;
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes the adaptive policy, the ACK rate starts at 100 %
+ * @param  config: parameters, kept by reference
+ * @retval None
+ */
+void RetransAdaptiveInit(const RetransAdaptiveConfig_t *config);
+
+/**
+ * @brief  Tells the adaptive policy that a fresher sample waits for the
+ *         uplink in progress. That uplink is abandoned at its next retry.
+ * @param  None
+ * @retval None
+ */
+void RetransFresherData(void);
+
+/**
+ * @brief  Returns the recent ACK rate of the adaptive policy
+ * @param  None
+ * @retval acknowledged transmissions in 1/256 units
+ */
+uint16_t RetransGetAckRate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RETRANS_POLICY_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,146 @@
+/**
+  ******************************************************************************
+  * @file    sensor_window.c
+  * @author  MCD Application Team
+  * @brief   Windowed sensor samples summarized with CMSIS-DSP
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "arm_math.h"
+#include "sensor_window.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Largest deviation from the window center once scaled: one bit of headroom
+ * keeps the q15 variance computed by arm_std_q15 from saturating */
+#define SENSOR_WINDOW_MAX_DEVIATION   0x3FFF
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static int16_t SensorWindowUnscale(int32_t value, int8_t shift);
+
+/* Functions Definition ------------------------------------------------------*/
+void SensorWindowInit(SensorWindow_t *window, int16_t *samples, uint16_t capacity)
+{
+  window->Samples = samples;
+  window->Capacity = capacity;
+  window->Head = 0;
+  window->Count = 0;
+}
+
+void SensorWindowPush(SensorWindow_t *window, int16_t sample)
+{
+  window->Samples[window->Head] = sample;
+  window->Head = (window->Head + 1) % window->Capacity;
+  if (window->Count < window->Capacity)
+  {
+    window->Count++;
+  }
+}
+
+int16_t SensorWindowGetSample(SensorWindow_t *window, uint16_t age)
+{
+  return window->Samples[(window->Head + window->Capacity - 1 - age) % window->Capacity];
+}
+
+void SensorWindowReset(SensorWindow_t *window)
+{
+  window->Head = 0;
+  window->Count = 0;
+}
+
+bool SensorWindowFlush(SensorWindow_t *window, SensorWindowStats_t *stats)
+{
+  /* the statistics do not depend on the order of the samples: while the ring
+   * has not wrapped they are at the start of the storage, then it is full */
+  q15_t *samples = window->Samples;
+  uint32_t count = window->Count;
+  uint32_t index;
+  q15_t min;
+  q15_t max;
+  q15_t mean;
+  q15_t std;
+  int32_t center;
+  int32_t deviation;
+  int8_t shift;
+
+  if (count == 0)
+  {
+    return false;
+  }
+
+  arm_min_q15(samples, count, &min, &index);
+  arm_max_q15(samples, count, &max, &index);
+
+  /* sensor values sit in a narrow part of the q15 range: center the samples
+   * and scale them up, so the fixed point mean and standard deviation keep
+   * their resolution */
+  center = max - (((int32_t)max - min) >> 1);
+  if (center == INT16_MIN)
+  {
+    /* -center must be a q15 offset */
+    center++;
+  }
+  deviation = max - center;
+  if (deviation > SENSOR_WINDOW_MAX_DEVIATION)
+  {
+    shift = -1;
+  }
+  else
+  {
+    shift = 0;
+    while ((shift < 14) && ((deviation << (shift + 1)) <= SENSOR_WINDOW_MAX_DEVIATION))
+    {
+      shift++;
+    }
+  }
+  arm_offset_q15(samples, (q15_t)(-center), samples, count);
+  arm_shift_q15(samples, shift, samples, count);
+
+  arm_mean_q15(samples, count, &mean);
+  arm_std_q15(samples, count, &std);
+
+  stats->Min = min;
+  stats->Max = max;
+  stats->Mean = center + SensorWindowUnscale(mean, shift);
+  stats->Std = SensorWindowUnscale(std, shift);
+  stats->Count = count;
+
+  SensorWindowReset(window);
+  return true;
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Brings a scaled value back to the unit of the samples
+ * @param  value: scaled value
+ * @param  shift: left shift applied to the samples, -1 to 14
+ * @retval value rounded to the nearest unit, saturated
+ */
+static int16_t SensorWindowUnscale(int32_t value, int8_t shift)
+{
+  if (shift > 0)
+  {
+    value = (value + (1L << (shift - 1))) >> shift;
+  }
+  else if (shift < 0)
+  {
+    value <<= 1;
+  }
+  return (int16_t)__SSAT(value, 16);
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    sensor_window.h
+  * @author  MCD Application Team
+  * @brief   Header for sensor_window.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SENSOR_WINDOW_H__
+#define __SENSOR_WINDOW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Ring buffer of the samples of one sensor, in a fixed point unit chosen by
+ * the application (e.g. 0.01 degC). The oldest samples are overwritten once
+ * the buffer is full.
+ */
+typedef struct
+{
+  int16_t *Samples;           /* storage of Capacity samples */
+  uint16_t Capacity;
+  uint16_t Head;              /* index of the next sample */
+  uint16_t Count;             /* samples held, up to Capacity */
+} SensorWindow_t;
+
+/**
+ * Summary of a window, in the unit of the samples
+ */
+typedef struct
+{
+  int16_t Min;
+  int16_t Max;
+  int16_t Mean;
+  int16_t Std;                /* sample standard deviation, 0 with a single sample */
+  uint16_t Count;             /* samples summarized */
+} SensorWindowStats_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Initializes an empty window
+ * @param  window: window to initialize
+ * @param  samples: storage of the samples
+ * @param  capacity: number of samples of the storage
+ * @retval None
+ */
+void SensorWindowInit(SensorWindow_t *window, int16_t *samples, uint16_t capacity);
+
+/**
+ * @brief  Appends a sample, overwriting the oldest one when the window is full
+ * @param  window: window
+ * @param  sample: sample
+ * @retval None
+ */
+void SensorWindowPush(SensorWindow_t *window, int16_t sample);
+
+/**
+ * @brief  Returns a sample, for the application to send the samples themselves
+ * @param  window: window
+ * @param  age: 0 for the newest sample, up to the number of samples held - 1
+ * @retval sample
+ */
+int16_t SensorWindowGetSample(SensorWindow_t *window, uint16_t age);
+
+/**
+ * @brief  Empties the window
+ * @param  window: window
+ * @retval None
+ */
+void SensorWindowReset(SensorWindow_t *window);
+
+/**
+ * @brief  Summarizes the window with the CMSIS-DSP q15 statistics kernels,
+ *         then empties it for the next uplink. The samples are scaled in
+ *         place to use the q15 range, so the window cannot be summarized twice
+ * @param  window: window
+ * @param  stats: summary of the window
+ * @retval false when the window is empty, stats is then left untouched
+ */
+bool SensorWindowFlush(SensorWindow_t *window, SensorWindowStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_WINDOW_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -34,6 +34,7 @@ Maintainer: Miguel Luis, Gregory Cristian and Wael Guibene
 #include <time.h>
 #include "hw.h"
 #include "timeServer.h"
+#include "latency_stats.h"
 //#include "low_power.h"
 
 
@@ -48,10 +49,18 @@ Maintainer: Miguel Luis, Gregory Cristian and Wael Guibene
       }                           \
       else                        \
       {                           \
+        LATENCY_START();          \
         _callback_( context );               \
+        LATENCY_STOP( LATENCY_TIMER_CB ); \
       }                           \
   } while(0);                   
 
+/*!
+ * Lateness of a timer dispatched at now: from the alarm it was coalesced on,
+ * the slack up to the alarm being deliberate, or else from its own deadline
+ */
+#define TIMER_LATENESS( now, deadline, alarm )                                 \
+  ( ( ( now ) > MAX( ( deadline ), ( alarm ) ) ) ? ( ( now ) - MAX( ( deadline ), ( alarm ) ) ) : 0 )
 
 
 /*!
@@ -59,6 +68,11 @@ Maintainer: Miguel Luis, Gregory Cristian and Wael Guibene
  */
 static TimerEvent_t *TimerListHead = NULL;
 
+/*!
+ * Alarm currently programmed for the list, in ticks from TimerContext
+ */
+static uint32_t TimerAlarmTimestamp = 0;
+
 /*!
  * \brief Adds or replace the head timer of the list.
  *
@@ -96,10 +110,23 @@ static void TimerSetTimeout( TimerEvent_t *obj );
  */
 static bool TimerExists( TimerEvent_t *obj );
 
+/*!
+ * \brief Computes the latest alarm time serving obj within its slack
+ *
+ * \remark Walks the timers starting before that time and clips the alarm to
+ *         the end of their own window, so every one of them is due (and
+ *         executed by TimerIrqHandler) when the alarm fires.
+ *
+ * \param [IN]  obj Head of the timer list
+ * \retval alarm time in ticks from TimerContext
+ */
+static uint32_t TimerGetCoalescedAlarm( TimerEvent_t *obj );
+
 void TimerInit( TimerEvent_t *obj, void ( *callback )( void *context ) )
 {
   obj->Timestamp = 0;
   obj->ReloadValue = 0;
+  obj->Slack = 0;
   obj->IsStarted = false;
   obj->IsNext2Expire = false;
   obj->Callback = callback;
@@ -120,9 +147,11 @@ void TimerStart( TimerEvent_t *obj )
   
   DISABLE_IRQ( );
   
+  LATENCY_START();
 
   if( ( obj == NULL ) || ( TimerExists( obj ) == true ) )
   {
+    LATENCY_STOP( LATENCY_IRQOFF_TIMER_START );
     RESTORE_PRIMASK( );
     return;
   }
@@ -147,8 +176,16 @@ void TimerStart( TimerEvent_t *obj )
     else
     {
       TimerInsertTimer( obj);
+
+      /* the new timer window closes before the programmed alarm */
+      if( ( TimerListHead->IsNext2Expire == true ) &&
+          ( ( obj->Timestamp + obj->Slack ) < TimerAlarmTimestamp ) )
+      {
+        TimerSetTimeout( TimerListHead );
+      }
     }
   }
+  LATENCY_STOP( LATENCY_IRQOFF_TIMER_START );
   RESTORE_PRIMASK( );
 }
 
@@ -169,6 +206,7 @@ void TimerIrqHandler( void )
   uint32_t old =  HW_RTC_GetTimerContext( );
   uint32_t now =  HW_RTC_SetTimerContext( );
   uint32_t DeltaContext = now - old; //intentionnal wrap around
+  uint32_t alarm;
   
   /* Update timeStamp based upon new Time Reference*/
   /* because delta context should never exceed 2^32*/
@@ -188,22 +226,34 @@ void TimerIrqHandler( void )
     }
   }
   
+  /* timers coalesced on this alarm are due as well, even if the wake-up
+     compensation brought us here a few ticks early */
+  alarm = ( TimerAlarmTimestamp > DeltaContext ) ? ( TimerAlarmTimestamp - DeltaContext ) : 0;
+
   /* execute imediately the alarm callback */
   if ( TimerListHead != NULL )
   {
     cur = TimerListHead;
     TimerListHead = TimerListHead->Next;
     cur->IsStarted = false;
+    /* the head Timestamp and the alarm are still relative to the previous context */
+    LATENCY_TIMER( cur->Callback, TIMER_LATENESS( DeltaContext, cur->Timestamp, TimerAlarmTimestamp ) );
     exec_cb( cur->Callback, cur->Context );
   }
 
 
   // remove all the expired object from the list
-  while( ( TimerListHead != NULL ) && ( TimerListHead->Timestamp < HW_RTC_GetTimerElapsedTime(  )  ))
+  while( ( TimerListHead != NULL ) &&
+         ( ( TimerListHead->Timestamp < HW_RTC_GetTimerElapsedTime(  ) ) || ( TimerListHead->Timestamp <= alarm ) ) )
   {
    cur = TimerListHead;
    TimerListHead = TimerListHead->Next;
    cur->IsStarted = false;
+   /* back to the previous context: the deadline of a timer overdue at the IRQ
+      was rebased to 0, the alarm it was coalesced on stands for it */
+   LATENCY_TIMER( cur->Callback, TIMER_LATENESS( DeltaContext + HW_RTC_GetTimerElapsedTime( ),
+                                                 ( cur->Timestamp != 0 ) ? ( cur->Timestamp + DeltaContext ) : 0,
+                                                 TimerAlarmTimestamp ) );
    exec_cb( cur->Callback, cur->Context );
   }
 
@@ -220,12 +270,15 @@ void TimerStop( TimerEvent_t *obj )
   
   DISABLE_IRQ( );
   
+  LATENCY_START();
+
   TimerEvent_t* prev = TimerListHead;
   TimerEvent_t* cur = TimerListHead;
 
   // List is empty or the Obj to stop does not exist 
   if( ( TimerListHead == NULL ) || ( obj == NULL ) )
   {
+    LATENCY_STOP( LATENCY_IRQOFF_TIMER_STOP );
     RESTORE_PRIMASK( );
     return;
   }
@@ -287,6 +340,7 @@ void TimerStop( TimerEvent_t *obj )
     }   
   }
   
+  LATENCY_STOP( LATENCY_IRQOFF_TIMER_STOP );
   RESTORE_PRIMASK( );
 }  
   
@@ -316,6 +370,11 @@ void TimerSetValue( TimerEvent_t *obj, uint32_t value )
   obj->ReloadValue = ticks;
 }
 
+void TimerSetSlack( TimerEvent_t *obj, uint32_t slack )
+{
+  obj->Slack = HW_RTC_ms2Tick( slack );
+}
+
 TimerTime_t TimerGetCurrentTime( void )
 {
   uint32_t now = HW_RTC_GetTimerValue( );
@@ -330,6 +389,27 @@ TimerTime_t TimerGetElapsedTime( TimerTime_t past )
   return HW_RTC_Tick2ms( nowInTicks- pastInTicks );
 }
 
+TimerTime_t TimerGetTimeToNextEvent( void )
+{
+  uint32_t elapsed;
+  uint32_t next;
+
+  if( TimerListHead == NULL )
+  {
+    return UINT32_MAX;
+  }
+
+  /* with slack the wake-up is the coalesced alarm, not the head deadline */
+  next = ( TimerListHead->IsNext2Expire == true ) ? TimerAlarmTimestamp : TimerListHead->Timestamp;
+
+  elapsed = HW_RTC_GetTimerElapsedTime( );
+  if( next <= elapsed )
+  {
+    return 0;
+  }
+  return HW_RTC_Tick2ms( next - elapsed );
+}
+
 static bool TimerExists( TimerEvent_t *obj )
 {
   TimerEvent_t* cur = TimerListHead;
@@ -354,7 +434,25 @@ static void TimerSetTimeout( TimerEvent_t *obj )
   {
     obj->Timestamp = HW_RTC_GetTimerElapsedTime(  ) + minTicks;
   }
-  HW_RTC_SetAlarm( obj->Timestamp );
+  TimerAlarmTimestamp = TimerGetCoalescedAlarm( obj );
+  HW_RTC_SetAlarm( TimerAlarmTimestamp );
+}
+
+static uint32_t TimerGetCoalescedAlarm( TimerEvent_t *obj )
+{
+  uint32_t alarm = obj->Timestamp + obj->Slack;
+  TimerEvent_t* cur = obj->Next;
+
+  /* the list is sorted by Timestamp: nothing after the alarm can lower it */
+  while( ( cur != NULL ) && ( cur->Timestamp <= alarm ) )
+  {
+    if( ( cur->Timestamp + cur->Slack ) < alarm )
+    {
+      alarm = cur->Timestamp + cur->Slack;
+    }
+    cur = cur->Next;
+  }
+  return alarm;
 }
 
 TimerTime_t TimerTempCompensation( TimerTime_t period, float temperature )
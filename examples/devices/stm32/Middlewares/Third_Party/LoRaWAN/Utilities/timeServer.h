@@ -52,6 +52,7 @@ typedef struct TimerEvent_s
 {
     uint32_t Timestamp;                  //! Expiring timer value in ticks from TimerContext
     uint32_t ReloadValue;                //! Reload Value when Timer is restarted
+    uint32_t Slack;                      //! Ticks the expiry may be postponed to share a wake-up
     bool IsStarted;                      //! Is the timer currently running
     bool IsNext2Expire;                  //! Is the next timer to expire
     void ( *Callback )( void* context ); //! Timer IRQ callback function
@@ -132,6 +133,19 @@ void TimerReset( TimerEvent_t *obj );
  */
 void TimerSetValue( TimerEvent_t *obj, uint32_t value );
 
+/*!
+ * \brief Set how late the timer may expire
+ *
+ * \remark The timer then fires anywhere in [timeout, timeout + slack] so that
+ *         timers with overlapping windows are served by a single RTC wake-up.
+ *         Timers needing exact expiry (e.g. MAC Rx windows) keep the default
+ *         zero slack. Applies from the next TimerStart.
+ *
+ * \param [IN] obj   Structure containing the timer object parameters
+ * \param [IN] slack Tolerated expiry delay in ms
+ */
+void TimerSetSlack( TimerEvent_t *obj, uint32_t slack );
+
 /*!
  * \brief Read the current time
  *
@@ -147,6 +161,14 @@ TimerTime_t TimerGetCurrentTime( void );
  */
 TimerTime_t TimerGetElapsedTime( TimerTime_t savedTime );
 
+/*!
+ * \brief Return the time left until the next timer expires
+ *
+ * \retval time             time in ms until the list head fires, 0 when it is
+ *                          already due and UINT32_MAX when no timer is running
+ */
+TimerTime_t TimerGetTimeToNextEvent( void );
+
 /*!
  * \brief Computes the temperature compensation for a period of time on a
  *        specific temperature.
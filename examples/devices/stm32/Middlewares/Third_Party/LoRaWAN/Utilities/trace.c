@@ -25,19 +25,66 @@
 #include "queue.h"
 #include "trace.h"
 #include "low_power_manager.h"
+#include "latency_stats.h"
 #include "debug.h"
+#include "hw.h"
 /* Private typedef -----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
 /* Private macros ------------------------------------------------------------*/
 
 #define TEMPBUFSIZE 256
 
+/* Size of the queue holding the traces of interrupts preempting the producer */
+#ifndef DBG_TRACE_OVERFLOW_SIZE
+#define DBG_TRACE_OVERFLOW_SIZE 128
+#endif
+
+#define TRACE_DROPPED_MARKER_SIZE 32
+
+#if ( TRACE_BINARY == 1 )
+#define TRACE_BIN_SYNC        0xA5U        /* first byte of a committed record */
+#define TRACE_BIN_WRAP        0xFFFFFFFFU  /* rest of the ring is unused, go to 0 */
+#define TRACE_BIN_MAX_ARGS    8
+#define TRACE_BIN_HDR_WORDS   3            /* header, timestamp, format address */
+#endif
+
 /* Private variables ---------------------------------------------------------*/
 static queue_param_t MsgTraceQueue;
 static uint8_t MsgTraceQueueBuff[DBG_TRACE_MSG_QUEUE_SIZE];
 
 __IO ITStatus TracePeripheralReady = SET;
 
+/* Set while a producer writes into MsgTraceQueue. MsgTraceQueue has a single
+   producer: a trace issued from an interrupt preempting it goes to
+   TraceOverflowQueue, which the producer moves to MsgTraceQueue when done.
+   A preempting interrupt always completes before the code it preempted
+   resumes, so testing and setting the flags needs no interrupt masking */
+static __IO ITStatus TraceProducerBusy = RESET;
+
+/* Traces of preempting interrupts, each one prefixed with its length. Only a
+   third level of preemption drops a trace */
+static queue_param_t TraceOverflowQueue;
+static uint8_t TraceOverflowQueueBuff[DBG_TRACE_OVERFLOW_SIZE];
+static __IO ITStatus TraceOverflowBusy = RESET;
+
+/* Traces dropped since TraceInit, and the count already reported in the output */
+static __IO uint32_t TraceDropped;
+static uint32_t TraceDroppedReported;
+
+/* Bytes of MsgTraceQueue handed to OutputTrace */
+static uint16_t TraceTextInFlight;
+
+#if ( TRACE_BINARY == 1 )
+/* Binary records ring. Records are reserved contiguously, a header word of
+   0 marks a record still being written by its producer */
+static uint32_t TraceBinRing[DBG_TRACE_BIN_RING_SIZE];
+static __IO uint16_t TraceBinHead;
+static __IO uint16_t TraceBinTail;
+static uint16_t TraceBinSeq;
+/* Words handed to OutputTrace, 0 when a text trace or nothing is in flight */
+static uint16_t TraceBinInFlight;
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -49,49 +96,175 @@ __IO ITStatus TracePeripheralReady = SET;
  */
 static void Trace_TxCpltCallback(void);
 
+/**
+ * @brief  Gets the next span to transmit, text traces first
+ * @param  buffer pointer on the span
+ * @param  bufSize size of the span in bytes
+ * @note   Must only be called by the owner of the output
+ * @retval 0 when a span is available, -1 otherwise
+ */
+static int TraceNextSpan(uint8_t** buffer, uint16_t* bufSize);
+
+/**
+ * @brief  Starts a transfer if the output is idle and traces are pending
+ * @param  none
+ * @retval None
+ */
+static void TraceKick(void);
+
+/**
+ * @brief  Formats a trace and writes it in the queues
+ * @param  strFormat format string
+ * @param  vaArgs arguments
+ * @param  countDrop 1 to count the trace as dropped when it does not fit
+ * @retval 0 when ok, -1 when the trace did not fit
+ */
+static int32_t TraceFormat(const char *strFormat, va_list vaArgs, uint32_t countDrop);
+
+/**
+ * @brief  Writes data in MsgTraceQueue, split over the end of the buffer if needed
+ * @param  data data to write
+ * @param  len number of bytes
+ * @note   Must only be called by the producer of MsgTraceQueue
+ * @retval 0 when ok, -1 when there is not enough room, nothing is written then
+ */
+static int32_t TraceWrite(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief  Writes a "[n traces dropped]" marker for the drops not reported yet
+ * @param  len room to leave for the trace that follows the marker
+ * @note   Must only be called by the producer of MsgTraceQueue
+ * @retval None
+ */
+static void TraceReportDropped(uint16_t len);
+
+/**
+ * @brief  Moves the traces of TraceOverflowQueue to MsgTraceQueue, then
+ *         releases the producer role of MsgTraceQueue
+ * @retval None
+ */
+static void TraceReleaseProducer(void);
+
+/**
+ * @brief  Takes a producer role if nobody holds it
+ * @param  flag busy flag of the role
+ * @retval 1 when taken, 0 when held by a preempted producer
+ */
+static uint32_t TraceAcquire(__IO ITStatus *flag);
+
+/**
+ * @brief  Counts a dropped trace
+ * @retval None
+ */
+static void TraceCountDropped(void);
+
+#if ( TRACE_BINARY == 1 )
+/**
+ * @brief  Reserves contiguous words in the binary ring
+ * @param  len number of words
+ * @note   Must be called with interrupts disabled
+ * @retval Index of the reserved words, -1 when the ring is full
+ */
+static int32_t TraceBinReserve(uint16_t len);
+
+/**
+ * @brief  Number of committed words readable from the tail in one transfer
+ * @note   Must only be called by the owner of the output
+ * @retval Number of words
+ */
+static uint16_t TraceBinSpan(void);
+#endif
+
 /* Functions Definition ------------------------------------------------------*/
 void TraceInit( void )
 {
   OutputInit(Trace_TxCpltCallback);
 
   circular_queue_init(&MsgTraceQueue, MsgTraceQueueBuff, DBG_TRACE_MSG_QUEUE_SIZE);
+  circular_queue_init(&TraceOverflowQueue, TraceOverflowQueueBuff, DBG_TRACE_OVERFLOW_SIZE);
+  TraceDropped = 0;
+  TraceDroppedReported = 0;
 
   return;
 }
 
 int32_t TraceSend( const char *strFormat, ...)
 {
-  char buf[TEMPBUFSIZE];
+  int32_t status;
   va_list vaArgs;
-  uint8_t* buffer;
-  va_start( vaArgs, strFormat);
-  uint16_t bufSize=vsnprintf(buf,TEMPBUFSIZE,strFormat, vaArgs);
+
+  va_start(vaArgs, strFormat);
+  status = TraceFormat(strFormat, vaArgs, 1);
   va_end(vaArgs);
-  int status=0;
-  
+
+  return status;
+}
+
+int32_t TraceSendWait( const char *strFormat, ...)
+{
+  va_list vaArgs;
+
+  va_start(vaArgs, strFormat);
+  /* the trace is short enough to fit once the output has drained the queue */
+  while (TraceFormat(strFormat, vaArgs, 0) != 0)
+  {
+    va_end(vaArgs);
+    va_start(vaArgs, strFormat);
+  }
+  va_end(vaArgs);
+
+  return 0;
+}
+
+uint32_t TraceGetDropped( void )
+{
+  return TraceDropped;
+}
+
+int32_t TraceSendBin( uint32_t nbArgs, const char *strFormat, ...)
+{
+#if ( TRACE_BINARY == 1 )
+  __IO uint32_t *record;
+  int32_t index;
+  uint32_t seq;
+  va_list vaArgs;
+
+  if (nbArgs > TRACE_BIN_MAX_ARGS)
+  {
+    return -1;
+  }
+
   BACKUP_PRIMASK();
-  
-  DISABLE_IRQ(); /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
-  //DBG_GPIO_SET(GPIOB, GPIO_PIN_15);
-  //DBG_GPIO_RST(GPIOB, GPIO_PIN_15);
-  status =circular_queue_add(&MsgTraceQueue,(uint8_t*)buf, bufSize);
-  
-  if ((status==0 ) && (TracePeripheralReady==SET))
-  {
-    circular_queue_get(&MsgTraceQueue,&buffer,&bufSize);
-    TracePeripheralReady = RESET;
-    //DBG_GPIO_RST(GPIOB, GPIO_PIN_12);
-    LPM_SetStopMode(LPM_UART_TX_Id , LPM_Disable );
 
-    RESTORE_PRIMASK();
-    OutputTrace(buffer, bufSize);
+  DISABLE_IRQ(); /**< Only the index update is protected, the record is written with IRQs enabled */
+  index = TraceBinReserve(TRACE_BIN_HDR_WORDS + nbArgs);
+  seq = TraceBinSeq++;
+  RESTORE_PRIMASK();
+
+  if (index < 0)
+  {
+    TraceCountDropped();
+    return -1;
   }
-  else
+
+  record = &TraceBinRing[index];
+  record[1] = HW_RTC_GetTimerValue();
+  record[2] = (uint32_t)strFormat;
+  va_start(vaArgs, strFormat);
+  for (uint32_t i = 0; i < nbArgs; i++)
   {
-    RESTORE_PRIMASK();
+    record[TRACE_BIN_HDR_WORDS + i] = va_arg(vaArgs, uint32_t);
   }
-  
-  return status;
+  va_end(vaArgs);
+  /* Commit */
+  record[0] = TRACE_BIN_SYNC | (nbArgs << 8) | (seq << 16);
+
+  TraceKick();
+
+  return 0;
+#else
+  return -1;
+#endif
 }
 
 const char *TraceGetFileName(const char *fullpath)
@@ -112,25 +285,260 @@ const char *TraceGetFileName(const char *fullpath)
 
 /* Private Functions Definition ------------------------------------------------------*/
 
-static void Trace_TxCpltCallback(void)
+static int32_t TraceFormat(const char *strFormat, va_list vaArgs, uint32_t countDrop)
+{
+  char buf[TEMPBUFSIZE + 1];
+  int32_t status = -1;
+  uint8_t* buffer;
+  int len = vsnprintf(&buf[1], TEMPBUFSIZE, strFormat, vaArgs);
+
+  if (len < 0)
+  {
+    return -1;
+  }
+  if (len >= TEMPBUFSIZE)
+  {
+    /* truncated by vsnprintf */
+    len = TEMPBUFSIZE - 1;
+  }
+
+  if (TraceAcquire(&TraceProducerBusy) != 0)
+  {
+    TraceReportDropped(len);
+    status = TraceWrite((uint8_t *)&buf[1], len);
+    TraceReleaseProducer();
+    TraceKick();
+  }
+  else if (TraceAcquire(&TraceOverflowBusy) != 0)
+  {
+    /* preempting the producer: keep the trace whole, behind its length */
+    buffer = circular_queue_reserve(&TraceOverflowQueue, len + 1);
+    if (buffer != NULL)
+    {
+      buf[0] = (char)len;
+      memcpy(buffer, buf, len + 1);
+      circular_queue_commit(&TraceOverflowQueue, len + 1);
+      status = 0;
+    }
+    TraceOverflowBusy = RESET;
+  }
+
+  if ((status != 0) && (countDrop != 0))
+  {
+    TraceCountDropped();
+  }
+  return status;
+}
+
+static int32_t TraceWrite(const uint8_t *data, uint16_t len)
+{
+  uint8_t* buffer;
+  uint16_t size;
+
+  if (len > circular_queue_get_free_size(&MsgTraceQueue))
+  {
+    return -1;
+  }
+  while (len != 0)
+  {
+    size = len;
+    buffer = circular_queue_reserve_max(&MsgTraceQueue, &size);
+    memcpy(buffer, data, size);
+    circular_queue_commit(&MsgTraceQueue, size);
+    data += size;
+    len -= size;
+  }
+  return 0;
+}
+
+static void TraceReportDropped(uint16_t len)
+{
+  char marker[TRACE_DROPPED_MARKER_SIZE];
+  uint32_t dropped = TraceDropped;
+  int markerLen;
+
+  if (dropped != TraceDroppedReported)
+  {
+    markerLen = snprintf(marker, sizeof(marker), "\r\n[%u traces dropped]\r\n", (unsigned)(dropped - TraceDroppedReported));
+    if (((markerLen + len) <= circular_queue_get_free_size(&MsgTraceQueue)) &&
+        (TraceWrite((uint8_t *)marker, markerLen) == 0))
+    {
+      TraceDroppedReported = dropped;
+    }
+  }
+}
+
+static void TraceReleaseProducer(void)
+{
+  uint8_t* buffer;
+  uint16_t size;
+  uint16_t len;
+
+  do
+  {
+    while (circular_queue_peek(&TraceOverflowQueue, &buffer, &size) == 0)
+    {
+      len = buffer[0];
+      if (TraceWrite(&buffer[1], len) != 0)
+      {
+        TraceCountDropped();
+      }
+      circular_queue_release(&TraceOverflowQueue, len + 1);
+    }
+    TraceProducerBusy = RESET;
+    /* an interrupt may have filled TraceOverflowQueue after the last peek */
+  } while ((circular_queue_sense(&TraceOverflowQueue) == 0) && (TraceAcquire(&TraceProducerBusy) != 0));
+}
+
+static uint32_t TraceAcquire(__IO ITStatus *flag)
+{
+  if (*flag == SET)
+  {
+    return 0;
+  }
+  *flag = SET;
+  return 1;
+}
+
+static void TraceCountDropped(void)
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ();
+  TraceDropped++;
+  RESTORE_PRIMASK();
+}
+
+#if ( TRACE_BINARY == 1 )
+static int32_t TraceBinReserve(uint16_t len)
+{
+  uint16_t head = TraceBinHead;
+  uint16_t tail = TraceBinTail;
+
+  if (head >= tail)
+  {
+    /* One word is always kept free so that head == tail means empty */
+    if ((head + len) < (DBG_TRACE_BIN_RING_SIZE + ((tail != 0) ? 1 : 0)))
+    {
+      TraceBinRing[head] = 0;
+      TraceBinHead = (head + len) % DBG_TRACE_BIN_RING_SIZE;
+      return head;
+    }
+    if (len < tail)
+    {
+      TraceBinRing[head] = TRACE_BIN_WRAP;
+      TraceBinRing[0] = 0;
+      TraceBinHead = len;
+      return 0;
+    }
+  }
+  else if ((head + len) < tail)
+  {
+    TraceBinRing[head] = 0;
+    TraceBinHead = head + len;
+    return head;
+  }
+  return -1;
+}
+
+static uint16_t TraceBinSpan(void)
+{
+  uint16_t head = TraceBinHead;
+  uint16_t index = TraceBinTail;
+  uint32_t header;
+
+  if ((index != head) && (TraceBinRing[index] == TRACE_BIN_WRAP))
+  {
+    index = 0;
+    TraceBinTail = 0;
+  }
+  while ((index != head) && (index < DBG_TRACE_BIN_RING_SIZE))
+  {
+    header = TraceBinRing[index];
+    if ((header & 0xFF) != TRACE_BIN_SYNC)
+    {
+      /* Record not committed yet, or wrap marker */
+      break;
+    }
+    index += TRACE_BIN_HDR_WORDS + ((header >> 8) & 0xFF);
+  }
+  return index - TraceBinTail;
+}
+#endif
+
+static int TraceNextSpan(uint8_t** buffer, uint16_t* bufSize)
+{
+  if (circular_queue_peek(&MsgTraceQueue, buffer, bufSize) == 0)
+  {
+    TraceTextInFlight = *bufSize;
+    return 0;
+  }
+#if ( TRACE_BINARY == 1 )
+  *bufSize = TraceBinSpan();
+  if (*bufSize != 0)
+  {
+    TraceBinInFlight = *bufSize;
+    *buffer = (uint8_t *)&TraceBinRing[TraceBinTail];
+    *bufSize *= sizeof(uint32_t);
+    return 0;
+  }
+#endif
+  return -1;
+}
+
+static void TraceKick(void)
 {
-  int status;
   uint8_t* buffer;
   uint16_t bufSize;
 
   BACKUP_PRIMASK();
 
-  DISABLE_IRQ(); /**< Disable all interrupts by setting PRIMASK bit on Cortex*/
-  /* Remove element just sent to UART */
-  circular_queue_remove(&MsgTraceQueue);
+  DISABLE_IRQ(); /**< Only the output ownership is arbitrated with IRQs disabled */
+  LATENCY_START();
+  if ((TracePeripheralReady == SET) && (TraceNextSpan(&buffer, &bufSize) == 0))
+  {
+    TracePeripheralReady = RESET;
+    //DBG_GPIO_RST(GPIOB, GPIO_PIN_12);
+    LPM_SetStopMode(LPM_UART_TX_Id , LPM_Disable );
+
+    LATENCY_STOP(LATENCY_IRQOFF_TRACE);
+    RESTORE_PRIMASK();
+    OutputTrace(buffer, bufSize);
+  }
+  else
+  {
+    LATENCY_STOP(LATENCY_IRQOFF_TRACE);
+    RESTORE_PRIMASK();
+  }
+}
+
+static void Trace_TxCpltCallback(void)
+{
+  uint8_t* buffer;
+  uint16_t bufSize;
+
+#if ( TRACE_BINARY == 1 )
+  if (TraceBinInFlight != 0)
+  {
+    /* Release the binary records just sent to UART */
+    TraceBinTail = (TraceBinTail + TraceBinInFlight) % DBG_TRACE_BIN_RING_SIZE;
+    TraceBinInFlight = 0;
+  }
+  else
+#endif
+  {
+    /* Release the text just sent to UART */
+    circular_queue_release(&MsgTraceQueue, TraceTextInFlight);
+    TraceTextInFlight = 0;
+  }
   //DBG_GPIO_SET(GPIOB, GPIO_PIN_13);
   //DBG_GPIO_RST(GPIOB, GPIO_PIN_13);
-  /* Sense if new data to be sent */
-  status=circular_queue_sense(&MsgTraceQueue);
 
-  if ( status == 0) 
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ(); /**< A trace committed by a higher priority IRQ must not be missed before releasing the output */
+  if (TraceNextSpan(&buffer, &bufSize) == 0)
   {
-    circular_queue_get(&MsgTraceQueue,&buffer,&bufSize);
     RESTORE_PRIMASK();
     //DBG_GPIO_SET(GPIOB, GPIO_PIN_14);
     //DBG_GPIO_RST(GPIOB, GPIO_PIN_14);
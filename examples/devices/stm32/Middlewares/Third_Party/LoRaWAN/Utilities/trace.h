@@ -44,11 +44,47 @@ void TraceInit( void );
 /**
  * @brief TraceSend decode the strFormat and post it to the circular queue for printing
  *
+ * @note  A trace from an interrupt preempting another TraceSend is kept aside
+ *        and queued when the preempted call completes. A trace that does not
+ *        fit is dropped and counted, the output then shows "[n traces dropped]"
  * @param:  None
  * @retval: 0 when ok, -1 when circular queue is full
  */
 int32_t TraceSend( const char *strFormat, ...);
 
+/**
+ * @brief TraceSendWait same as TraceSend, waits for room in the circular queue
+ *
+ * @note  Must not be called from an interrupt or with interrupts disabled
+ * @param:  None
+ * @retval: 0
+ */
+int32_t TraceSendWait( const char *strFormat, ...);
+
+/**
+ * @brief TraceGetDropped returns the number of traces dropped since TraceInit
+ *
+ * @param:  None
+ * @retval: number of text and binary traces dropped
+ */
+uint32_t TraceGetDropped( void );
+
+/**
+ * @brief TraceSendBin records a trace without formatting it on target
+ *
+ * @note  The record is a sequence of little endian 32-bit words:
+ *        header (0xA5 | nbArgs << 8 | sequence << 16), RTC timer value,
+ *        address of strFormat, then the nbArgs raw arguments. The host
+ *        renders the text by looking strFormat, and any %s argument, up
+ *        in the firmware ELF file (Utilities/trace-decode.js). Text traces never contain the 0xA5 byte,
+ *        so both kinds of traces can share the output. A gap in the sequence
+ *        number means records were dropped because the ring was full.
+ * @param:  nbArgs number of arguments following strFormat, at most 8
+ * @param:  strFormat constant format string
+ * @retval: 0 when ok, -1 when the ring is full or TRACE_BINARY is not set
+ */
+int32_t TraceSendBin( uint32_t nbArgs, const char *strFormat, ...);
+
 /**
  * @brief  TraceGetFileName: Return filename string extracted from full path information
  * @param  *fullPath Fullpath string (path + filename)
@@ -30,7 +30,7 @@ extern "C"
 {
 #endif
 
-#define PPRINTF(...)     do{ } while( 0!= TraceSend(__VA_ARGS__) ) //Polling Mode
+#define PPRINTF(...)     do{  TraceSendWait(__VA_ARGS__); }while(0) //Polling Mode
 
 #define PRINTF(...)     do{  TraceSend(__VA_ARGS__); }while(0)
 #define PRINTNOW()      do{                                                           \
@@ -38,6 +38,21 @@ extern "C"
                           TraceSend("%3ds%03d: ",stime.Seconds, stime.SubSeconds); \
                          }while(0) 
 
+/* Number of arguments following the format string, up to 8 */
+#define TRACE_NARGS(...) TRACE_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0)
+#define TRACE_NARGS_(_f, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+/* Hot path traces: binary records when TRACE_BINARY is set, text otherwise.
+   Arguments must be integers of at most 32 bits or pointers, %s arguments
+   must point to constant strings */
+#if ( TRACE_BINARY == 1 )
+#define TPRINTF(...)    do{  TraceSendBin(TRACE_NARGS(__VA_ARGS__), __VA_ARGS__); }while(0)
+#define TPRINTNOW()     do{ }while(0)
+#else
+#define TPRINTF(...)    do{  TraceSend(__VA_ARGS__); }while(0)
+#define TPRINTNOW()     PRINTNOW()
+#endif
+
 #define TVL1(X)    do{ if(VERBOSE_LEVEL>=VERBOSE_LEVEL_1) { X } }while(0);
 #define TVL2(X)    do{ if(VERBOSE_LEVEL>=VERBOSE_LEVEL_2) { X } }while(0);
 
@@ -15,6 +15,8 @@ Maintainer: Miguel Luis and Gregory Cristian
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include "utilities.h"
 
 /*!
@@ -43,8 +45,74 @@ int32_t randr( int32_t min, int32_t max )
     return ( int32_t )rand1( ) % ( max - min + 1 ) + min;
 }
 
+/*!
+ * Word loads and stores of the aligned fast paths, on byte buffers the
+ * compiler must not assume are never accessed as words. GCC and ARM Compiler 6
+ * take a may_alias word type. The other compilers (ARM Compiler 5, IAR) go
+ * through memcpy, which may alias anything: the uint32_t pointer tells them
+ * the address is aligned, so the copy is a single LDR or STR.
+ */
+#if defined( __GNUC__ )
+typedef uint32_t __attribute__( ( __may_alias__ ) ) Word_t;
+
+static inline uint32_t LoadWord( const uint8_t *src )
+{
+    return *( const Word_t* )src;
+}
+
+static inline void StoreWord( uint8_t *dst, uint32_t word )
+{
+    *( Word_t* )dst = word;
+}
+#else
+static inline uint32_t LoadWord( const uint8_t *src )
+{
+    uint32_t word;
+
+    memcpy( &word, ( const uint32_t* )( const void* )src, sizeof( word ) );
+    return word;
+}
+
+static inline void StoreWord( uint8_t *dst, uint32_t word )
+{
+    memcpy( ( uint32_t* )( void* )dst, &word, sizeof( word ) );
+}
+#endif
+
+/*!
+ * Below this size the head/tail handling costs more than the word loop saves
+ */
+#define MEM_WORD_PATH_MIN_SIZE                      8
+
+#define MEM_IS_WORD_ALIGNED( a )                    ( ( ( uintptr_t )( a ) & 3 ) == 0 )
+
 void memcpy1( uint8_t *dst, const uint8_t *src, uint16_t size )
 {
+    if( ( size >= MEM_WORD_PATH_MIN_SIZE ) && ( ( ( ( uintptr_t )dst ^ ( uintptr_t )src ) & 3 ) == 0 ) )
+    {
+        while( MEM_IS_WORD_ALIGNED( dst ) == false )
+        {
+            *dst++ = *src++;
+            size--;
+        }
+        while( size >= 16 )
+        {
+            StoreWord( dst, LoadWord( src ) );
+            StoreWord( dst + 4, LoadWord( src + 4 ) );
+            StoreWord( dst + 8, LoadWord( src + 8 ) );
+            StoreWord( dst + 12, LoadWord( src + 12 ) );
+            dst += 16;
+            src += 16;
+            size -= 16;
+        }
+        while( size >= 4 )
+        {
+            StoreWord( dst, LoadWord( src ) );
+            dst += 4;
+            src += 4;
+            size -= 4;
+        }
+    }
     while( size-- )
     {
         *dst++ = *src++;
@@ -53,21 +121,117 @@ void memcpy1( uint8_t *dst, const uint8_t *src, uint16_t size )
 
 void memcpyr( uint8_t *dst, const uint8_t *src, uint16_t size )
 {
-    dst = dst + ( size - 1 );
+    // dst points one past the last byte and is walked downwards
+    dst = dst + size;
+    // src + k lands on dst - 1 - k: both sides reach a word boundary together
+    // only when ( src + dst ) is a multiple of 4
+    if( ( size >= MEM_WORD_PATH_MIN_SIZE ) && ( ( ( ( uintptr_t )dst + ( uintptr_t )src ) & 3 ) == 0 ) )
+    {
+        while( MEM_IS_WORD_ALIGNED( src ) == false )
+        {
+            *--dst = *src++;
+            size--;
+        }
+        while( size >= 4 )
+        {
+            dst -= 4;
+            StoreWord( dst, __REV( LoadWord( src ) ) );
+            src += 4;
+            size -= 4;
+        }
+    }
     while( size-- )
     {
-        *dst-- = *src++;
+        *--dst = *src++;
     }
 }
 
 void memset1( uint8_t *dst, uint8_t value, uint16_t size )
 {
+    if( size >= MEM_WORD_PATH_MIN_SIZE )
+    {
+        uint32_t pattern = value * 0x01010101UL;
+
+        while( MEM_IS_WORD_ALIGNED( dst ) == false )
+        {
+            *dst++ = value;
+            size--;
+        }
+        while( size >= 16 )
+        {
+            StoreWord( dst, pattern );
+            StoreWord( dst + 4, pattern );
+            StoreWord( dst + 8, pattern );
+            StoreWord( dst + 12, pattern );
+            dst += 16;
+            size -= 16;
+        }
+        while( size >= 4 )
+        {
+            StoreWord( dst, pattern );
+            dst += 4;
+            size -= 4;
+        }
+    }
     while( size-- )
     {
         *dst++ = value;
     }
 }
 
+void memxor1( uint8_t *dst, const uint8_t *src, uint16_t size )
+{
+    if( ( size >= MEM_WORD_PATH_MIN_SIZE ) && ( ( ( ( uintptr_t )dst ^ ( uintptr_t )src ) & 3 ) == 0 ) )
+    {
+        while( MEM_IS_WORD_ALIGNED( dst ) == false )
+        {
+            *dst++ ^= *src++;
+            size--;
+        }
+        while( size >= 4 )
+        {
+            StoreWord( dst, LoadWord( dst ) ^ LoadWord( src ) );
+            dst += 4;
+            src += 4;
+            size -= 4;
+        }
+    }
+    while( size-- )
+    {
+        *dst++ ^= *src++;
+    }
+}
+
+void memcpy16( uint8_t *dst, const uint8_t *src )
+{
+    if( MEM_IS_WORD_ALIGNED( ( uintptr_t )dst | ( uintptr_t )src ) == true )
+    {
+        StoreWord( dst, LoadWord( src ) );
+        StoreWord( dst + 4, LoadWord( src + 4 ) );
+        StoreWord( dst + 8, LoadWord( src + 8 ) );
+        StoreWord( dst + 12, LoadWord( src + 12 ) );
+    }
+    else
+    {
+        memcpy1( dst, src, 16 );
+    }
+}
+
+void memxor16( uint8_t *dst, const uint8_t *src )
+{
+    if( MEM_IS_WORD_ALIGNED( ( uintptr_t )dst | ( uintptr_t )src ) == true )
+    {
+        StoreWord( dst, LoadWord( dst ) ^ LoadWord( src ) );
+        StoreWord( dst + 4, LoadWord( dst + 4 ) ^ LoadWord( src + 4 ) );
+        StoreWord( dst + 8, LoadWord( dst + 8 ) ^ LoadWord( src + 8 ) );
+        StoreWord( dst + 12, LoadWord( dst + 12 ) ^ LoadWord( src + 12 ) );
+    }
+    else
+    {
+        memxor1( dst, src, 16 );
+    }
+}
+
 int8_t Nibble2HexChar( uint8_t a )
 {
     if( a < 10 )
@@ -156,6 +156,35 @@ void memcpyr( uint8_t *dst, const uint8_t *src, uint16_t size );
  */
 void memset1( uint8_t *dst, uint8_t value, uint16_t size );
 
+/*!
+ * \brief XORs size elements of src array into dst array
+ *
+ * \param [IN/OUT] dst  Destination array, dst[i] ^= src[i]
+ * \param [IN]     src  Source array
+ * \param [IN]     size Number of bytes to be processed
+ */
+void memxor1( uint8_t *dst, const uint8_t *src, uint16_t size );
+
+/*!
+ * \brief Copies one 16 bytes block ( AES block ) of src array to dst array
+ *
+ * \remark Uses word transfers when both arrays are word aligned
+ *
+ * \param [OUT] dst Destination block
+ * \param [IN]  src Source block
+ */
+void memcpy16( uint8_t *dst, const uint8_t *src );
+
+/*!
+ * \brief XORs one 16 bytes block ( AES block ) of src array into dst array
+ *
+ * \remark Uses word transfers when both arrays are word aligned
+ *
+ * \param [IN/OUT] dst Destination block, dst[i] ^= src[i]
+ * \param [IN]     src Source block
+ */
+void memxor16( uint8_t *dst, const uint8_t *src );
+
 /*!
  * \brief Converts a nibble to an hexadecimal character
  *
@@ -0,0 +1,316 @@
+/**
+  ******************************************************************************
+  * @file    vibration.c
+  * @author  MCD Application Team
+  * @brief   Vibration features of accelerometer windows with CMSIS-DSP
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "vibration.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+#if VIBRATION_FFT_SIZE == 128
+#define VIBRATION_CFFT                arm_cfft_sR_q15_len64
+#elif VIBRATION_FFT_SIZE == 256
+#define VIBRATION_CFFT                arm_cfft_sR_q15_len128
+#elif VIBRATION_FFT_SIZE == 512
+#define VIBRATION_CFFT                arm_cfft_sR_q15_len256
+#else
+#error "VIBRATION_FFT_SIZE must be 128, 256 or 512"
+#endif
+
+/* the real FFT twiddle tables hold the coefficients of 8192 points */
+#define VIBRATION_RFFT_MODIFIER       (8192 / VIBRATION_FFT_SIZE)
+
+/* spectral lines from DC to half the sampling rate */
+#define VIBRATION_NB_BINS             (VIBRATION_FFT_SIZE / 2 + 1)
+
+/* Largest deviation from the window center once scaled, as in sensor_window.c */
+#define VIBRATION_MAX_DEVIATION       0x3FFF
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* defined in arm_rfft_init_q15.c */
+extern const q15_t realCoefAQ15[];
+extern const q15_t realCoefBQ15[];
+
+/* arm_rfft_init_q15 is not used: it would link the tables of all the sizes */
+static const arm_rfft_instance_q15 Rfft =
+{
+  VIBRATION_FFT_SIZE,
+  0,                                  /* forward */
+  1,                                  /* bit reversed output */
+  VIBRATION_RFFT_MODIFIER,
+  (q15_t *)realCoefAQ15,
+  (q15_t *)realCoefBQ15,
+  &VIBRATION_CFFT
+};
+
+/* real FFT output, then the power of its lines: the power of a line takes
+ * the place of its real and imaginary parts */
+static union
+{
+  q15_t Lines[2 * VIBRATION_FFT_SIZE];
+  uint32_t Power[VIBRATION_FFT_SIZE];
+} Spectrum;
+
+/* Private function prototypes -----------------------------------------------*/
+static void VibrationHann(q15_t *samples);
+static void VibrationPower(void);
+static void VibrationPeaks(int8_t shift, VibrationPeak_t *peaks);
+static int16_t VibrationBandRms(uint32_t first, uint32_t last, int8_t shift);
+static int16_t VibrationUnscale(int32_t value, int8_t shift);
+static uint32_t VibrationSqrt(uint64_t value);
+
+/* Functions Definition ------------------------------------------------------*/
+void VibrationExtract(int16_t *samples, VibrationFeatures_t *features)
+{
+  q15_t *x = samples;
+  uint32_t index;
+  uint32_t first;
+  uint32_t last;
+  q15_t min;
+  q15_t max;
+  q15_t mean;
+  q15_t rms;
+  int32_t center;
+  int32_t deviation;
+  int32_t peak;
+  uint32_t crest;
+  int8_t shift;
+  uint8_t band;
+
+  /* center on the middle of the range and scale up, as SensorWindowFlush
+   * does, so the fixed point kernels keep the resolution of small vibrations */
+  arm_min_q15(x, VIBRATION_FFT_SIZE, &min, &index);
+  arm_max_q15(x, VIBRATION_FFT_SIZE, &max, &index);
+  center = max - (((int32_t)max - min) >> 1);
+  if (center == INT16_MIN)
+  {
+    center++;
+  }
+  deviation = max - center;
+  if (deviation > VIBRATION_MAX_DEVIATION)
+  {
+    shift = -1;
+  }
+  else
+  {
+    shift = 0;
+    while ((shift < 14) && ((deviation << (shift + 1)) <= VIBRATION_MAX_DEVIATION))
+    {
+      shift++;
+    }
+  }
+  arm_offset_q15(x, (q15_t)(-center), x, VIBRATION_FFT_SIZE);
+  arm_shift_q15(x, shift, x, VIBRATION_FFT_SIZE);
+
+  /* the mean (e.g. gravity) is not part of the vibration; the scaled samples
+   * stay within +/-VIBRATION_MAX_DEVIATION, removing it cannot saturate */
+  arm_mean_q15(x, VIBRATION_FFT_SIZE, &mean);
+  arm_offset_q15(x, (q15_t)(-mean), x, VIBRATION_FFT_SIZE);
+
+  arm_rms_q15(x, VIBRATION_FFT_SIZE, &rms);
+  arm_min_q15(x, VIBRATION_FFT_SIZE, &min, &index);
+  arm_max_q15(x, VIBRATION_FFT_SIZE, &max, &index);
+  peak = ((int32_t)max > -(int32_t)min) ? max : -(int32_t)min;
+
+  features->Rms = VibrationUnscale(rms, shift);
+  features->Crest = 0;
+  if (rms != 0)
+  {
+    crest = ((uint32_t)peak << 8) / (uint32_t)rms;
+    features->Crest = (crest > UINT16_MAX) ? UINT16_MAX : (uint16_t)crest;
+  }
+
+  VibrationHann(x);
+  arm_rfft_q15(&Rfft, x, Spectrum.Lines);
+  VibrationPower();
+
+  VibrationPeaks(shift, features->Peaks);
+
+  /* DC and half the sampling rate are left out */
+  for (band = 0; band < VIBRATION_NB_BANDS; band++)
+  {
+    first = ((uint32_t)band * (VIBRATION_NB_BINS - 1)) / VIBRATION_NB_BANDS;
+    last = (((uint32_t)band + 1) * (VIBRATION_NB_BINS - 1)) / VIBRATION_NB_BANDS;
+    if (first == 0)
+    {
+      first = 1;
+    }
+    features->Bands[band] = VibrationBandRms(first, last, shift);
+  }
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+/**
+ * @brief  Applies a Hann window, limiting the leakage of the peaks into the
+ *         neighbouring lines
+ * @param  samples: VIBRATION_FFT_SIZE samples, windowed in place
+ * @retval None
+ */
+static void VibrationHann(q15_t *samples)
+{
+  uint32_t i;
+  int32_t weight;
+
+  for (i = 0; i < VIBRATION_FFT_SIZE; i++)
+  {
+    /* 0.5 - 0.5 * cos(2 * pi * i / N), arm_cos_q15 maps [0, 1) to [0, 2 * pi) */
+    weight = 0x4000 - (arm_cos_q15((q15_t)(i * (0x8000 / VIBRATION_FFT_SIZE))) >> 1);
+    samples[i] = (q15_t)(((int32_t)samples[i] * weight) >> 15);
+  }
+}
+
+/**
+ * @brief  Computes the power of the lines from DC to half the sampling rate.
+ *         arm_cmplx_mag_q15 and arm_cmplx_mag_squared_q15 keep 15 bits of
+ *         re^2 + im^2 and lose the lines below 1% of the largest possible one
+ * @param  None
+ * @retval None
+ */
+static void VibrationPower(void)
+{
+  uint32_t bin;
+  int32_t re;
+  int32_t im;
+
+  for (bin = 0; bin < VIBRATION_NB_BINS; bin++)
+  {
+    re = Spectrum.Lines[2 * bin];
+    im = Spectrum.Lines[2 * bin + 1];
+    Spectrum.Power[bin] = (uint32_t)(re * re) + (uint32_t)(im * im);
+  }
+}
+
+/**
+ * @brief  Finds the largest local maxima of the spectrum
+ * @param  shift: left shift applied to the samples
+ * @param  peaks: VIBRATION_NB_PEAKS peaks, largest first
+ * @retval None
+ */
+static void VibrationPeaks(int8_t shift, VibrationPeak_t *peaks)
+{
+  const uint32_t *power = Spectrum.Power;
+  uint32_t largest[VIBRATION_NB_PEAKS];
+  uint16_t bins[VIBRATION_NB_PEAKS];
+  uint16_t bin;
+  uint8_t i;
+
+  for (i = 0; i < VIBRATION_NB_PEAKS; i++)
+  {
+    largest[i] = 0;
+    bins[i] = 0;
+  }
+
+  for (bin = 1; bin < (VIBRATION_NB_BINS - 1); bin++)
+  {
+    if ((power[bin] > power[bin - 1]) && (power[bin] >= power[bin + 1]) &&
+        (power[bin] > largest[VIBRATION_NB_PEAKS - 1]))
+    {
+      i = VIBRATION_NB_PEAKS - 1;
+      while ((i > 0) && (largest[i - 1] < power[bin]))
+      {
+        largest[i] = largest[i - 1];
+        bins[i] = bins[i - 1];
+        i--;
+      }
+      largest[i] = power[bin];
+      bins[i] = bin;
+    }
+  }
+
+  for (i = 0; i < VIBRATION_NB_PEAKS; i++)
+  {
+    peaks[i].Bin = bins[i];
+    /* arm_rfft_q15 divides by N: a sinusoid of amplitude A gives a line of
+     * A / 2, halved by the coherent gain of the window */
+    peaks[i].Amplitude = VibrationUnscale((int32_t)VibrationSqrt(largest[i]) << 2, shift);
+  }
+}
+
+/**
+ * @brief  Computes the RMS of a band of the spectrum (Parseval)
+ * @param  first: first line of the band
+ * @param  last: line following the band
+ * @param  shift: left shift applied to the samples
+ * @retval RMS in the unit of the samples
+ */
+static int16_t VibrationBandRms(uint32_t first, uint32_t last, int8_t shift)
+{
+  uint64_t power = 0;
+
+  while (first < last)
+  {
+    power += Spectrum.Power[first++];
+  }
+  /* a line of power P holds 2 * P of the mean square of the windowed
+   * samples, and the window keeps 3/8 of the mean square */
+  return VibrationUnscale((int32_t)VibrationSqrt((power * 16) / 3), shift);
+}
+
+/**
+ * @brief  Brings a scaled value back to the unit of the samples
+ * @param  value: scaled value
+ * @param  shift: left shift applied to the samples, -1 to 14
+ * @retval value rounded to the nearest unit, saturated
+ */
+static int16_t VibrationUnscale(int32_t value, int8_t shift)
+{
+  if (shift > 0)
+  {
+    value = (value + (1L << (shift - 1))) >> shift;
+  }
+  else if (shift < 0)
+  {
+    value <<= 1;
+  }
+  return (int16_t)__SSAT(value, 16);
+}
+
+/**
+ * @brief  Integer square root, bit by bit
+ * @param  value: value
+ * @retval square root rounded down
+ */
+static uint32_t VibrationSqrt(uint64_t value)
+{
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+
+  while (bit > value)
+  {
+    bit >>= 2;
+  }
+  while (bit != 0)
+  {
+    if (value >= (root + bit))
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file    vibration.h
+  * @author  MCD Application Team
+  * @brief   Header for vibration.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __VIBRATION_H__
+#define __VIBRATION_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Samples per window: 128, 256 or 512 */
+#ifndef VIBRATION_FFT_SIZE
+#define VIBRATION_FFT_SIZE          256
+#endif
+
+/* Spectral peaks reported */
+#ifndef VIBRATION_NB_PEAKS
+#define VIBRATION_NB_PEAKS          3
+#endif
+
+/* Bands of equal width between 0 and half the sampling rate */
+#ifndef VIBRATION_NB_BANDS
+#define VIBRATION_NB_BANDS          4
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * Spectral peak. Its frequency is Bin * sampling rate / VIBRATION_FFT_SIZE
+ */
+typedef struct
+{
+  uint16_t Bin;
+  int16_t Amplitude;          /* of the sinusoid, 0 when fewer peaks were found */
+} VibrationPeak_t;
+
+/**
+ * Features of a window of one accelerometer axis, in the unit of the samples
+ */
+typedef struct
+{
+  int16_t Rms;                /* of the samples less their mean */
+  uint16_t Crest;             /* largest deviation from the mean / Rms, 8 fractional bits */
+  VibrationPeak_t Peaks[VIBRATION_NB_PEAKS];  /* largest first */
+  int16_t Bands[VIBRATION_NB_BANDS];          /* RMS of each band, lowest band first */
+} VibrationFeatures_t;
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Extracts the features of a window with the CMSIS-DSP q15 kernels.
+ *         The samples are overwritten: they are centered, scaled to use the
+ *         q15 range and Hann windowed in place before the real FFT
+ * @param  samples: VIBRATION_FFT_SIZE samples of one axis, oldest first
+ * @param  features: features of the window
+ * @retval None
+ */
+void VibrationExtract(int16_t *samples, VibrationFeatures_t *features);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VIBRATION_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
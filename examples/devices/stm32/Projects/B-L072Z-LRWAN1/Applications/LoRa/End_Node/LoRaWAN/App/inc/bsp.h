@@ -73,6 +73,33 @@ void  BSP_sensor_Init( void  );
  */
 void BSP_sensor_Read( sensor_t *sensor_data);
 
+/**
+ * @brief  starts reading the sensors in the background, the MCU may sleep
+ *         meanwhile but not enter stop mode
+ *
+ * @note   OnDone is called from the bus interrupt
+ * @param  OnDone called once the sensors are read
+ * @retval None
+ */
+void BSP_sensor_Start( void ( *OnDone )( void ) );
+
+/**
+ * @brief  returns the values read since BSP_sensor_Start, or reads them
+ *         with BSP_sensor_Read if the background read failed
+ *
+ * @note   to be called once OnDone is called
+ * @retval sensor_data
+ */
+void BSP_sensor_Get( sensor_t *sensor_data );
+
+/**
+ * @brief  sensor bus interrupt handler
+ *
+ * @note none
+ * @retval None
+ */
+void BSP_sensor_IRQHandler( void );
+
 #ifdef __cplusplus
 }
 #endif
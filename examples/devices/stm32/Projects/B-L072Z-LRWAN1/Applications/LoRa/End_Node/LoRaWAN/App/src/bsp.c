@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include "hw.h"
 #include "timeServer.h"
+#include "low_power_manager.h"
 #include "bsp.h"
 #if defined(LRWAN_NS1)
 #include "lrwan_ns1_humidity.h"
@@ -59,6 +60,18 @@
 void *HUMIDITY_handle = NULL;
 void *TEMPERATURE_handle = NULL;
 void *PRESSURE_handle = NULL;
+
+/* background read, one bus transfer per sensor */
+#define SENSOR_TRANSFER_NB 2
+static SensorBusTransfer_t HumTempTransfer;
+static SensorBusTransfer_t PressTempTransfer;
+static uint8_t HumTempBuffer[HTS221_HUM_TEMP_ASYNC_SIZE];
+static uint8_t PressTempBuffer[LPS22HB_PRESS_TEMP_ASYNC_SIZE];
+static uint8_t TransferPending = 0;
+static DrvStatusTypeDef TransferStatus = COMPONENT_OK;
+static void ( *TransferOnDone )( void ) = NULL;
+
+static void BSP_sensor_OnTransferDone( SensorBusTransfer_t *transfer, DrvStatusTypeDef status );
 #endif
 
 void BSP_sensor_Read( sensor_t *sensor_data)
@@ -69,8 +82,12 @@ void BSP_sensor_Read( sensor_t *sensor_data)
   float PRESSURE_Value = 0;
 
 #if defined(SENSOR_ENABLED) || defined (LRWAN_NS1)
-  BSP_HUMIDITY_Get_Hum(HUMIDITY_handle, &HUMIDITY_Value);
-  BSP_TEMPERATURE_Get_Temp(TEMPERATURE_handle, &TEMPERATURE_Value);
+  /* the polling accesses are refused while a background read uses the bus */
+  while ( SensorBus_IsBusy( ) )
+  {
+  }
+  /* HTS221 humidity and temperature in one burst, with the calibration read at init */
+  HTS221_H_Get_Hum_Temp(HUMIDITY_handle, &HUMIDITY_Value, &TEMPERATURE_Value);
   BSP_PRESSURE_Get_Press(PRESSURE_handle, &PRESSURE_Value);
 #endif  
   sensor_data->humidity    = HUMIDITY_Value;
@@ -82,6 +99,69 @@ void BSP_sensor_Read( sensor_t *sensor_data)
   /* USER CODE END 5 */
 }
 
+void BSP_sensor_Start( void ( *OnDone )( void ) )
+{
+#if defined(SENSOR_ENABLED) || defined (LRWAN_NS1)
+  TransferOnDone = OnDone;
+  TransferStatus = COMPONENT_OK;
+  TransferPending = SENSOR_TRANSFER_NB;
+
+  /* the I2C peripheral is stopped in stop mode */
+  LPM_SetStopMode( LPM_SENSOR_Id, LPM_Disable );
+
+  /* both transfers are queued at once, the second one starts from the bus
+     interrupt that completes the first one */
+  HumTempTransfer.callback = BSP_sensor_OnTransferDone;
+  if ( HTS221_H_Get_Hum_Temp_Async( HUMIDITY_handle, &HumTempTransfer, HumTempBuffer ) != COMPONENT_OK )
+  {
+    BSP_sensor_OnTransferDone( &HumTempTransfer, COMPONENT_ERROR );
+  }
+  /* refused if the pressure sensor found is not a LPS22HB */
+  PressTempTransfer.callback = BSP_sensor_OnTransferDone;
+  if ( LPS22HB_P_Get_Press_Temp_Async( PRESSURE_handle, &PressTempTransfer, PressTempBuffer ) != COMPONENT_OK )
+  {
+    BSP_sensor_OnTransferDone( &PressTempTransfer, COMPONENT_ERROR );
+  }
+#else
+  OnDone( );
+#endif
+}
+
+void BSP_sensor_Get( sensor_t *sensor_data )
+{
+#if defined(SENSOR_ENABLED) || defined (LRWAN_NS1)
+  float HUMIDITY_Value = 0;
+  float TEMPERATURE_Value = 0;
+  float PRESSURE_Value = 0;
+  float PRESSURE_TEMPERATURE_Value = 0;
+
+  if ( TransferStatus != COMPONENT_OK )
+  {
+    BSP_sensor_Read( sensor_data );
+    return;
+  }
+
+  HTS221_H_Decode_Hum_Temp( HUMIDITY_handle, HumTempBuffer, &HUMIDITY_Value, &TEMPERATURE_Value );
+  LPS22HB_P_Decode_Press_Temp( PressTempBuffer, &PRESSURE_Value, &PRESSURE_TEMPERATURE_Value );
+
+  sensor_data->humidity    = HUMIDITY_Value;
+  sensor_data->temperature = TEMPERATURE_Value;
+  sensor_data->pressure    = PRESSURE_Value;
+
+  sensor_data->latitude  = (int32_t) ((STSOP_LATTITUDE  * MAX_GPS_POS) /90);
+  sensor_data->longitude = (int32_t) ((STSOP_LONGITUDE  * MAX_GPS_POS )/180);
+#else
+  BSP_sensor_Read( sensor_data );
+#endif
+}
+
+void BSP_sensor_IRQHandler( void )
+{
+#if defined(SENSOR_ENABLED) || defined (LRWAN_NS1)
+  Sensor_IO_IRQHandler( );
+#endif
+}
+
 void  BSP_sensor_Init( void  )
 {
   /* USER CODE BEGIN 6 */
@@ -100,4 +180,27 @@ void  BSP_sensor_Init( void  )
     /* USER CODE END 6 */
 }
 
+#if defined(SENSOR_ENABLED) || defined (LRWAN_NS1)
+static void BSP_sensor_OnTransferDone( SensorBusTransfer_t *transfer, DrvStatusTypeDef status )
+{
+  uint8_t pending;
+
+  /* called from the bus interrupt, or from BSP_sensor_Start on a refused transfer */
+  BACKUP_PRIMASK();
+  DISABLE_IRQ( );
+  if ( status != COMPONENT_OK )
+  {
+    TransferStatus = COMPONENT_ERROR;
+  }
+  pending = --TransferPending;
+  RESTORE_PRIMASK( );
+
+  if ( pending == 0 )
+  {
+    LPM_SetStopMode( LPM_SENSOR_Id, LPM_Enable );
+    TransferOnDone( );
+  }
+}
+#endif
+
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
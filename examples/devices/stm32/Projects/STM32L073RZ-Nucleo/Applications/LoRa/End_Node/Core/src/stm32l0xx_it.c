@@ -34,6 +34,7 @@ Maintainer: Miguel Luis and Gregory Cristian
 /* Includes ------------------------------------------------------------------*/
 #include "hw.h"
 #include "vcom.h"
+#include "bsp.h"
 #include "stm32l0xx_it.h"
 
 
@@ -190,6 +191,11 @@ void RTC_IRQHandler( void )
   HW_RTC_IrqHandler ( );
 }
 
+void I2C1_IRQHandler( void )
+{
+  BSP_sensor_IRQHandler( );
+}
+
 void EXTI0_1_IRQHandler( void )
 {
   HAL_GPIO_EXTI_IRQHandler( GPIO_PIN_0 );
@@ -34,8 +34,31 @@ typedef enum
   LPM_GPS_Id =      (1 << 3),
   LPM_UART_RX_Id =  (1 << 4),
   LPM_UART_TX_Id =  (1 << 5),
+  LPM_SENSOR_Id =   (1 << 6),
 } LPM_Id_t;
 
+/* Low power governor costs: average power drawn in each mode (uW) and energy
+   spent entering and leaving it (nJ, clock tree restart included).
+   uW x ms = nJ, so the break-even idle time of a mode is simply
+   transition / power saved */
+#define LPM_SLEEP_POWER_UW          3000
+#define LPM_STOP_POWER_UW           5
+#define LPM_OFF_POWER_UW            2
+#define LPM_STOP_TRANSITION_NJ      9000
+#define LPM_OFF_TRANSITION_NJ       400000
+
+/* Energy meter current table (uA) at the supply voltage (mV). The MCU runs at
+   32 MHz, off mode is accounted as stop. A single Tx figure is used, measured
+   at the output power the application configures (SX1276 shield, +14 dBm on RFO) */
+#define ENERGY_SUPPLY_MV            3300
+#define ENERGY_MCU_RUN_UA           4600
+#define ENERGY_MCU_SLEEP_UA         1300
+#define ENERGY_MCU_STOP_UA          1
+#define ENERGY_RADIO_SLEEP_UA       1
+#define ENERGY_RADIO_STANDBY_UA     1600
+#define ENERGY_RADIO_RX_UA          11500
+#define ENERGY_RADIO_TX_UA          29000
+
 #define OutputInit  vcom_Init
 #define OutputTrace vcom_Trace
 
@@ -51,6 +74,17 @@ typedef enum
 #define DBG_TRACE_MSG_QUEUE_SIZE 512
 #endif
 
+/* Set to 1 to record TPRINTF traces as binary records (RTC timestamp, format
+   string address and raw arguments) instead of formatting them on target */
+#define TRACE_BINARY 0
+
+/* Size of the binary trace ring, in 32-bit words */
+#define DBG_TRACE_BIN_RING_SIZE 128
+
+/* Set to 1 to collect timer lateness and execution time statistics
+   (latency_stats.h), read with MIB_LATENCY_STATS or dumped with LatencyPrint */
+#define LATENCY_STATS 0
+
   /* Exported types ------------------------------------------------------------*/
   /* Exported constants --------------------------------------------------------*/
   /* External variables --------------------------------------------------------*/
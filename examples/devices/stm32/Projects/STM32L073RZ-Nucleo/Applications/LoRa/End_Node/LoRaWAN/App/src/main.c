@@ -21,28 +21,92 @@
 #include "hw.h"
 #include "low_power_manager.h"
 #include "lora.h"
+#include "cayenne_lpp.h"
+#include "cbor_writer.h"
+#include "time_series.h"
 #include "bsp.h"
+#include "sensor_window.h"
+#include "report_trigger.h"
 #include "timeServer.h"
+#include "latency_stats.h"
+#include "energy_meter.h"
+#include "retrans_policy.h"
 #include "vcom.h"
 #include "version.h"
 
 /* Private typedef -----------------------------------------------------------*/
+/*!
+ * Sensors sampled between two uplinks
+ */
+typedef enum
+{
+  SENSOR_PRESSURE,            /* in hPa * 10 */
+  SENSOR_TEMPERATURE,         /* in degC * 100 */
+  SENSOR_HUMIDITY,            /* in % * 10 */
+  SENSOR_NB
+} Sensor_t;
+
 /* Private define ------------------------------------------------------------*/
 
 /*!
  * CAYENNE_LPP is myDevices Application server.
  */
 #define CAYENNE_LPP
-#define LPP_DATATYPE_DIGITAL_INPUT  0x0
-#define LPP_DATATYPE_DIGITAL_OUTPUT 0x1
-#define LPP_DATATYPE_HUMIDITY       0x68
-#define LPP_DATATYPE_TEMPERATURE    0x67
-#define LPP_DATATYPE_BAROMETER      0x73
 #define LPP_APP_PORT 99
 /*!
- * Defines the application data transmission duty cycle. 5s, value in [ms].
+ * CBOR_PAYLOAD sends a CBOR map, for devices provisioned with the agent's
+ * cbor data model. Used when CAYENNE_LPP is not defined.
+ */
+/* #define CBOR_PAYLOAD */
+/*!
+ * TIMESERIES_PAYLOAD sends the samples themselves rather than their summary,
+ * for devices provisioned with the agent's timeseries data model. Used when
+ * neither CAYENNE_LPP nor CBOR_PAYLOAD are defined.
+ */
+/* #define TIMESERIES_PAYLOAD */
+#if ( defined( CAYENNE_LPP ) + defined( CBOR_PAYLOAD ) + defined( TIMESERIES_PAYLOAD ) ) > 1
+#error "define one of CAYENNE_LPP, CBOR_PAYLOAD or TIMESERIES_PAYLOAD"
+#endif
+/*!
+ * Parts of the CBOR map, each one adds to the previous ones
+ */
+#define CBOR_MEANS                                  0   /* window means */
+#define CBOR_STATUS                                 1   /* battery level and led state */
+#define CBOR_SUMMARIES                              2   /* window min, max and std */
+/*!
+ * Defines the period of the join attempts, and of the uplink attempts the MAC
+ * refuses. value in [ms].
  */
 #define APP_TX_DUTYCYCLE                            10000
+/*!
+ * Tolerated delay of the transmission timer, lets it share a wake-up with
+ * other timers. value in [ms].
+ */
+#define APP_TX_DUTYCYCLE_SLACK                      500
+/*!
+ * Shortest interval between two uplinks triggered by the sensors (see
+ * ReportRules). value in [ms].
+ */
+#define APP_REPORT_MIN_INTERVAL                     5000
+/*!
+ * Longest interval between two uplinks, sent even when the sensors do not
+ * change. value in [ms].
+ */
+#define APP_REPORT_MAX_INTERVAL                     300000
+/*!
+ * Defines the sensor sampling period. The samples taken between two uplinks
+ * are sent as their min, max, mean and standard deviation. value in [ms].
+ */
+#define SENSOR_SAMPLE_PERIOD                        1000
+/*!
+ * Tolerated delay of the sampling timer. value in [ms].
+ */
+#define SENSOR_SAMPLE_PERIOD_SLACK                  100
+/*!
+ * Samples kept per sensor, the oldest ones are dropped when the uplinks are
+ * more than SENSOR_WINDOW_SIZE sampling periods apart
+ */
+#define SENSOR_WINDOW_SIZE                          32
 /*!
  * LoRaWAN Adaptive Data Rate
  * @note Please note that when ADR is enabled the end-device should be static
@@ -69,7 +133,7 @@
 /*!
  * User application data buffer size
  */
-#define LORAWAN_APP_DATA_BUFF_SIZE                           64
+#define LORAWAN_APP_DATA_BUFF_SIZE                           128
 /*!
  * User application data
  */
@@ -99,6 +163,32 @@ static void LORA_TxNeeded ( void );
 /* LoRa endNode send request*/
 static void Send( void* context );
 
+/* schedules the next uplink from the report triggers and the duty cycle*/
+static void ReportSchedule( void );
+
+/* (re)starts the tx timer*/
+static void TxTimerStart( TimerTime_t delay );
+
+#ifdef CBOR_PAYLOAD
+/* encodes the sensor windows as a CBOR map*/
+static void CborEncode( cbor_Writer_t *writer, SensorWindowStats_t *stats, uint8_t batteryLevel, uint8_t level );
+#endif
+
+/* start the sensor sampling*/
+static void SampleStart( void );
+
+/* reads the sensors into their windows*/
+static void Sample( void );
+
+/* puts the values read into the sensor windows*/
+static void SamplePush( sensor_t *sensor_data );
+
+/* background sensor read completion, from the bus interrupt*/
+static void OnSampleReadDone( void );
+
+/* sampling timer callback function*/
+static void OnSampleTimerEvent( void* context );
+
 /* start the tx process*/
 static void LoraStartTx(TxEventType_t EventType);
 
@@ -121,12 +211,60 @@ static LoRaMainCallback_t LoRaMainCallbacks = { HW_GetBatteryLevel,
                                                 LoraMacProcessNotify};
 LoraFlagStatus LoraMacProcessRequest=LORA_RESET;
 LoraFlagStatus AppProcessRequest=LORA_RESET;
+LoraFlagStatus SampleProcessRequest=LORA_RESET;
 /*!
  * Specifies the state of the application LED
  */
 static uint8_t AppLedStateOn = RESET;
                                                
 static TimerEvent_t TxTimer;
+static TxEventType_t TxEventType = TX_ON_EVENT;
+
+static TimerEvent_t SampleTimer;
+static TimerTime_t SampleTime;
+
+/*!
+ * Samples of each sensor since the last uplink
+ */
+static int16_t SensorSamples[SENSOR_NB][SENSOR_WINDOW_SIZE];
+static SensorWindow_t SensorWindow[SENSOR_NB];
+
+/*!
+ * Changes of each sensor that trigger an uplink with TX_ON_TIMER, evaluated on
+ * every sample. An uplink carries all the sensors.
+ */
+static const ReportRule_t ReportRules[SENSOR_NB] =
+{
+  /* deadband, rate of change per sample, threshold, hysteresis, min and max intervals */
+  { 10, 5, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },         /* 1 hPa, 0.5 hPa */
+  { 50, 30, 3000, 100, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },   /* 0.5 degC, 0.3 degC, above 30 degC */
+  { 30, 20, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },        /* 3 %, 2 % */
+};
+static ReportChannel_t ReportChannel[SENSOR_NB];
+
+/*!
+ * Retransmissions of the confirmed uplinks: 1 to 8 trials following the ACK
+ * rate, a back-off from 2 s doubling up to 32 s, and no retransmission of a
+ * frame older than 1 min or when a fresher report is due
+ */
+static const RetransAdaptiveConfig_t RetransConfig = { 1, 8, 2000, 32000, 60000 };
+
+#ifdef CAYENNE_LPP
+/*!
+ * Cayenne LPP fields of the application data
+ */
+static lpp_Buffer_t Lpp;
+#elif defined( CBOR_PAYLOAD )
+/*!
+ * CBOR encoder of the application data
+ */
+static cbor_Writer_t Cbor;
+#elif defined( TIMESERIES_PAYLOAD )
+/*!
+ * Time series encoder of the application data
+ */
+static ts_Writer_t Ts;
+#endif
 
 #ifdef USE_B_L072Z_LRWAN1
 /*!
@@ -162,6 +300,12 @@ int main( void )
   
   /* Configure the hardware*/
   HW_Init();
+
+  /* Start the latency instrumentation, no-op unless LATENCY_STATS is set */
+  LatencyInit();
+
+  /* Start the energy accounting, read with MIB_ENERGY_STATS */
+  EnergyInit();
   
   /* USER CODE BEGIN 1 */
   /* USER CODE END 1 */
@@ -173,13 +317,28 @@ int main( void )
   
   /* Configure the Lora Stack*/
   LORA_Init( &LoRaMainCallbacks, &LoRaParamInit);
+
+  RetransAdaptiveInit( &RetransConfig );
+  LORA_SetRetransPolicy( &RetransAdaptivePolicy );
   
   LORA_Join();
   
+  SampleStart( );
+  
   LoraStartTx( TX_ON_TIMER) ;
   
   while( 1 )
   {
+    if (SampleProcessRequest==LORA_SET)
+    {
+      sensor_t sensor_data;
+
+      /*reset notification flag*/
+      SampleProcessRequest=LORA_RESET;
+      BSP_sensor_Get( &sensor_data );
+      SamplePush( &sensor_data );
+      ReportSchedule( );
+    }
     if (AppProcessRequest==LORA_SET)
     {
       /*reset notification flag*/
@@ -198,7 +357,7 @@ int main( void )
     
     /* if an interrupt has occurred after DISABLE_IRQ, it is kept pending 
      * and cortex will not enter low power anyway  */
-    if ((LoraMacProcessRequest!=LORA_SET) && (AppProcessRequest!=LORA_SET))
+    if ((LoraMacProcessRequest!=LORA_SET) && (AppProcessRequest!=LORA_SET) && (SampleProcessRequest!=LORA_SET))
     {
 #ifndef LOW_POWER_DISABLE
       LPM_EnterLowPower( );
@@ -230,21 +389,39 @@ static void LORA_HasJoined( void )
 static void Send( void* context )
 {
   /* USER CODE BEGIN 3 */
-  uint16_t pressure = 0;
-  int16_t temperature = 0;
-  uint16_t humidity = 0;
+#ifndef TIMESERIES_PAYLOAD
   uint8_t batteryLevel;
-  sensor_t sensor_data;
+  SensorWindowStats_t stats[SENSOR_NB];
+#endif
+  uint8_t s;
+  TimerTime_t timeOff;
   
   if ( LORA_JoinStatus () != LORA_SET)
   {
     /*Not joined, try again later*/
     LORA_Join();
+    if ( TxEventType == TX_ON_TIMER )
+    {
+      TxTimerStart( APP_TX_DUTYCYCLE );
+    }
+    return;
+  }
+
+  /* wait for the duty cycle rather than be refused by the MAC, the samples
+     keep going into the windows meanwhile */
+  timeOff = LORA_GetTxTimeOff( );
+  if ( timeOff != 0 )
+  {
+    TxTimerStart( timeOff );
     return;
   }
   
   TVL1(PRINTF("SEND REQUEST\n\r");)
-#ifndef CAYENNE_LPP
+#if !defined( CAYENNE_LPP ) && !defined( CBOR_PAYLOAD ) && !defined( TIMESERIES_PAYLOAD )
+  uint16_t pressure = 0;
+  int16_t temperature = 0;
+  uint16_t humidity = 0;
+  sensor_t sensor_data;
   int32_t latitude, longitude = 0;
   uint16_t altitudeGps = 0;
 #endif
@@ -253,54 +430,113 @@ static void Send( void* context )
   TimerInit( &TxLedTimer, OnTimerLedEvent );
   
   TimerSetValue(  &TxLedTimer, 200);
+  TimerSetSlack(  &TxLedTimer, 100);
   
   LED_On( LED_RED1 ) ; 
   
   TimerStart( &TxLedTimer );  
 #endif
 
-  BSP_sensor_Read( &sensor_data );
+#ifndef TIMESERIES_PAYLOAD
+  /* summarize the samples since the last uplink, with one taken now */
+  Sample( );
+  for ( s = 0; s < SENSOR_NB; s++ )
+  {
+    SensorWindowFlush( &SensorWindow[s], &stats[s] );
+  }
+#endif
 
 #ifdef CAYENNE_LPP
   uint8_t cchannel=0;
-  //temperature = ( int16_t )( sensor_data.temperature * 10 );     /* in �C * 10 */
-  pressure    = ( uint16_t )( sensor_data.pressure * 100 / 10 );  /* in hPa / 10 */
-  humidity    = ( uint16_t )( sensor_data.humidity * 2 );        /* in %*2     */
   uint32_t i = 0;
-  uint16_t temperatureDegreeC = HW_GetTemperatureLevel();
-  uint16_t temperatureDegreeC_Int= (temperatureDegreeC)>>8;
-  uint16_t temperatureDegreeC_Frac= ((temperatureDegreeC-(temperatureDegreeC_Int<<8))*100)>>8;
-  temperature = ( int16_t )( temperatureDegreeC_Int* 10 + temperatureDegreeC_Frac/10);
   batteryLevel = HW_GetBatteryLevel( );                     /* 1 (very low) to 254 (fully charged) */
 
   AppData.Port = LPP_APP_PORT;
 
-  AppData.Buff[i++] = cchannel++;
-  AppData.Buff[i++] = LPP_DATATYPE_BAROMETER;
-  AppData.Buff[i++] = ( pressure >> 8 ) & 0xFF;
-  AppData.Buff[i++] = pressure & 0xFF;
-  AppData.Buff[i++] = cchannel++;
-  AppData.Buff[i++] = LPP_DATATYPE_TEMPERATURE; 
-  AppData.Buff[i++] = ( temperature >> 8 ) & 0xFF;
-  AppData.Buff[i++] = temperature & 0xFF;
-  AppData.Buff[i++] = cchannel++;
-  AppData.Buff[i++] = LPP_DATATYPE_HUMIDITY;
-  AppData.Buff[i++] = humidity & 0xFF;
-#if defined( REGION_US915 ) || defined ( REGION_AU915 )
-  /* The maximum payload size does not allow to send more data for lowest DRs */
-#else
-  AppData.Buff[i++] = cchannel++;
-  AppData.Buff[i++] = LPP_DATATYPE_DIGITAL_INPUT; 
-  AppData.Buff[i++] = batteryLevel*100/254;
-  AppData.Buff[i++] = cchannel++;
-  AppData.Buff[i++] = LPP_DATATYPE_DIGITAL_OUTPUT; 
-  AppData.Buff[i++] = AppLedStateOn;
-#endif  /* REGION_XX915 */
+  lpp_init( &Lpp, AppData.Buff, LORAWAN_APP_DATA_BUFF_SIZE );
+  lpp_add_barometric_pressure( &Lpp, cchannel++, stats[SENSOR_PRESSURE].Mean );        /* in hPa / 10 */
+  lpp_add_temperature( &Lpp, cchannel++, stats[SENSOR_TEMPERATURE].Mean / 10 );        /* in degC * 10 */
+  lpp_add_relative_humidity( &Lpp, cchannel++, stats[SENSOR_HUMIDITY].Mean / 5 );      /* in %*2 */
+  /* dropped when the payload size allowed at the current DR is too small */
+  lpp_set_priority( &Lpp, LPP_PRIORITY_HIGHEST + 1 );
+  lpp_add_digital_input( &Lpp, cchannel++, batteryLevel*100/254 );
+  lpp_add_digital_output( &Lpp, cchannel++, AppLedStateOn );
+  /* min, max and standard deviation of each sensor over the window, dropped first */
+  lpp_set_priority( &Lpp, LPP_PRIORITY_HIGHEST + 2 );
+  lpp_add_barometric_pressure( &Lpp, cchannel++, stats[SENSOR_PRESSURE].Min );
+  lpp_add_barometric_pressure( &Lpp, cchannel++, stats[SENSOR_PRESSURE].Max );
+  lpp_add_barometric_pressure( &Lpp, cchannel++, stats[SENSOR_PRESSURE].Std );
+  lpp_add_temperature( &Lpp, cchannel++, stats[SENSOR_TEMPERATURE].Min / 10 );
+  lpp_add_temperature( &Lpp, cchannel++, stats[SENSOR_TEMPERATURE].Max / 10 );
+  lpp_add_temperature( &Lpp, cchannel++, stats[SENSOR_TEMPERATURE].Std / 10 );
+  lpp_add_relative_humidity( &Lpp, cchannel++, stats[SENSOR_HUMIDITY].Min / 5 );
+  lpp_add_relative_humidity( &Lpp, cchannel++, stats[SENSOR_HUMIDITY].Max / 5 );
+  lpp_add_relative_humidity( &Lpp, cchannel++, stats[SENSOR_HUMIDITY].Std / 5 );
+
+  i = lpp_fit( &Lpp, lpp_get_max_size( ) );
+#elif defined( CBOR_PAYLOAD )
+  uint32_t i = 0;
+  uint8_t maxSize;
+  uint8_t level;
+
+  batteryLevel = HW_GetBatteryLevel( );                     /* 1 (very low) to 254 (fully charged) */
+
+  AppData.Port = LORAWAN_APP_PORT;
+
+  /* size the map first, the window summaries, then the battery level and the
+     led state, are dropped when the payload allowed at the current DR is too small */
+  maxSize = LORA_GetMaxPayloadSize( );
+  for ( level = CBOR_SUMMARIES; level > CBOR_MEANS; level-- )
+  {
+    cbor_init( &Cbor, NULL, 0 );
+    CborEncode( &Cbor, stats, batteryLevel, level );
+    if ( cbor_get_size( &Cbor ) <= maxSize )
+    {
+      break;
+    }
+  }
+
+  cbor_init( &Cbor, AppData.Buff, LORAWAN_APP_DATA_BUFF_SIZE );
+  CborEncode( &Cbor, stats, batteryLevel, level );
+  if ( cbor_is_valid( &Cbor ) )
+  {
+    i = cbor_get_size( &Cbor );
+  }
+#elif defined( TIMESERIES_PAYLOAD )
+  uint32_t i = 0;
+  int16_t values[SENSOR_NB];
+  uint16_t age;
+
+  AppData.Port = LORAWAN_APP_PORT;
+
+  /* the newest samples that fit in the payload allowed at the current DR,
+     the older ones are dropped */
+  if ( ts_init( &Ts, AppData.Buff, MIN( LORA_GetMaxPayloadSize( ), LORAWAN_APP_DATA_BUFF_SIZE ),
+                SENSOR_NB, TimerGetElapsedTime( SampleTime ), SENSOR_SAMPLE_PERIOD ) )
+  {
+    for ( age = 0; age < SensorWindow[0].Count; age++ )
+    {
+      for ( s = 0; s < SENSOR_NB; s++ )
+      {
+        values[s] = SensorWindowGetSample( &SensorWindow[s], age );
+      }
+      if ( !ts_add_sample( &Ts, values ) )
+      {
+        break;
+      }
+    }
+    i = ts_get_size( &Ts );
+  }
+  for ( s = 0; s < SENSOR_NB; s++ )
+  {
+    SensorWindowReset( &SensorWindow[s] );
+  }
 #else  /* not CAYENNE_LPP */
 
-  temperature = ( int16_t )( sensor_data.temperature * 100 );     /* in �C * 100 */
-  pressure    = ( uint16_t )( sensor_data.pressure * 100 / 10 );  /* in hPa / 10 */
-  humidity    = ( uint16_t )( sensor_data.humidity * 10 );        /* in %*10     */
+  BSP_sensor_Read( &sensor_data );
+  temperature = stats[SENSOR_TEMPERATURE].Mean;                   /* in �C * 100 */
+  pressure    = stats[SENSOR_PRESSURE].Mean;                      /* in hPa / 10 */
+  humidity    = stats[SENSOR_HUMIDITY].Mean;                      /* in %*10     */
   latitude = sensor_data.latitude;
   longitude= sensor_data.longitude;
   uint32_t i = 0;
@@ -342,11 +578,158 @@ static void Send( void* context )
 #endif  /* CAYENNE_LPP */
   AppData.BuffSize = i;
   
-  LORA_send( &AppData, LORAWAN_DEFAULT_CONFIRM_MSG_STATE);
+  /* false when the MAC took the uplink */
+  if ( LORA_send( &AppData, LORAWAN_DEFAULT_CONFIRM_MSG_STATE) == false )
+  {
+    ReportDone( ReportChannel, SENSOR_NB, TimerGetCurrentTime( ) );
+  }
+  else
+  {
+    ReportPostpone( ReportChannel, SENSOR_NB, TimerGetCurrentTime( ) );
+    /* a confirmed uplink still retransmitting gives way to this report */
+    RetransFresherData( );
+  }
+  ReportSchedule( );
   
   /* USER CODE END 3 */
 }
 
+static void ReportSchedule( void )
+{
+  uint32_t delay;
+
+  if ( ( TxEventType != TX_ON_TIMER ) || ( LORA_JoinStatus( ) != LORA_SET ) )
+  {
+    /* uplinks on the button, or join attempts paced by the tx timer */
+    return;
+  }
+
+  delay = ReportGetDelay( ReportChannel, SENSOR_NB, TimerGetCurrentTime( ) );
+  if ( delay == 0 )
+  {
+    delay = LORA_GetTxTimeOff( );
+  }
+
+  if ( delay == 0 )
+  {
+    TimerStop( &TxTimer );
+    AppProcessRequest=LORA_SET;
+  }
+  else if ( delay != REPORT_NONE )
+  {
+    TxTimerStart( delay );
+  }
+  else
+  {
+    TimerStop( &TxTimer );
+  }
+}
+
+static void TxTimerStart( TimerTime_t delay )
+{
+  TimerStop( &TxTimer );
+  TimerSetValue( &TxTimer, delay );
+  TimerStart( &TxTimer );
+}
+
+#ifdef CBOR_PAYLOAD
+static void CborEncode( cbor_Writer_t *writer, SensorWindowStats_t *stats, uint8_t batteryLevel, uint8_t level )
+{
+  /* keys are the object_id of the device attributes */
+  cbor_put_map( writer, ( level >= CBOR_SUMMARIES ) ? 8 : ( level >= CBOR_STATUS ) ? 5 : 3 );
+  cbor_put_string( writer, "bp0" );
+  cbor_put_float( writer, stats[SENSOR_PRESSURE].Mean / 10.0f );           /* in hPa */
+  cbor_put_string( writer, "t1" );
+  cbor_put_float16( writer, stats[SENSOR_TEMPERATURE].Mean / 100.0f );     /* in degC */
+  cbor_put_string( writer, "rh2" );
+  cbor_put_float16( writer, stats[SENSOR_HUMIDITY].Mean / 10.0f );         /* in % */
+  if ( level >= CBOR_STATUS )
+  {
+    cbor_put_string( writer, "di3" );
+    cbor_put_uint( writer, batteryLevel*100/254 );
+    cbor_put_string( writer, "do4" );
+    cbor_put_uint( writer, AppLedStateOn );
+  }
+  if ( level >= CBOR_SUMMARIES )
+  {
+    /* [min, max, std] over the window */
+    cbor_put_string( writer, "bp0s" );
+    cbor_put_array( writer, 3 );
+    cbor_put_float( writer, stats[SENSOR_PRESSURE].Min / 10.0f );
+    cbor_put_float( writer, stats[SENSOR_PRESSURE].Max / 10.0f );
+    cbor_put_float16( writer, stats[SENSOR_PRESSURE].Std / 10.0f );
+    cbor_put_string( writer, "t1s" );
+    cbor_put_array( writer, 3 );
+    cbor_put_float16( writer, stats[SENSOR_TEMPERATURE].Min / 100.0f );
+    cbor_put_float16( writer, stats[SENSOR_TEMPERATURE].Max / 100.0f );
+    cbor_put_float16( writer, stats[SENSOR_TEMPERATURE].Std / 100.0f );
+    cbor_put_string( writer, "rh2s" );
+    cbor_put_array( writer, 3 );
+    cbor_put_float16( writer, stats[SENSOR_HUMIDITY].Min / 10.0f );
+    cbor_put_float16( writer, stats[SENSOR_HUMIDITY].Max / 10.0f );
+    cbor_put_float16( writer, stats[SENSOR_HUMIDITY].Std / 10.0f );
+  }
+}
+#endif
+
+static void SampleStart( void )
+{
+  uint8_t s;
+
+  for ( s = 0; s < SENSOR_NB; s++ )
+  {
+    SensorWindowInit( &SensorWindow[s], SensorSamples[s], SENSOR_WINDOW_SIZE );
+    ReportInit( &ReportChannel[s], &ReportRules[s], TimerGetCurrentTime( ) );
+  }
+  TimerInit( &SampleTimer, OnSampleTimerEvent );
+  TimerSetValue( &SampleTimer, SENSOR_SAMPLE_PERIOD );
+  TimerSetSlack( &SampleTimer, SENSOR_SAMPLE_PERIOD_SLACK );
+  TimerStart( &SampleTimer );
+}
+
+static void Sample( void )
+{
+  sensor_t sensor_data;
+
+  BSP_sensor_Read( &sensor_data );
+  SamplePush( &sensor_data );
+}
+
+static void SamplePush( sensor_t *sensor_data )
+{
+  int16_t values[SENSOR_NB];
+  uint8_t s;
+
+  SampleTime = TimerGetCurrentTime( );
+  values[SENSOR_PRESSURE] = ( int16_t )( sensor_data->pressure * 10 );
+#ifdef CAYENNE_LPP
+  /* MCU temperature, in degC * 256 */
+  values[SENSOR_TEMPERATURE] = ( int16_t )( ( ( int32_t )( int16_t )HW_GetTemperatureLevel( ) * 100 ) >> 8 );
+#else
+  values[SENSOR_TEMPERATURE] = ( int16_t )( sensor_data->temperature * 100 );
+#endif
+  values[SENSOR_HUMIDITY] = ( int16_t )( sensor_data->humidity * 10 );
+
+  for ( s = 0; s < SENSOR_NB; s++ )
+  {
+    SensorWindowPush( &SensorWindow[s], values[s] );
+    ReportSample( &ReportChannel[s], values[s] );
+  }
+}
+
+static void OnSampleTimerEvent( void* context )
+{
+  /*Wait for next sample*/
+  TimerStart( &SampleTimer );
+  
+  /*read the sensors while the MCU sleeps*/
+  BSP_sensor_Start( OnSampleReadDone );
+}
+
+static void OnSampleReadDone( void )
+{
+  SampleProcessRequest=LORA_SET;
+}
 
 static void LORA_RxData( lora_AppData_t *AppData )
 {
@@ -421,19 +804,20 @@ static void LORA_RxData( lora_AppData_t *AppData )
 
 static void OnTxTimerEvent( void* context )
 {
-  /*Wait for next tx slot*/
-  TimerStart( &TxTimer);
-  
+  /*Restarted by Send or ReportSchedule*/
   AppProcessRequest=LORA_SET;
 }
 
 static void LoraStartTx(TxEventType_t EventType)
 {
+  TxEventType = EventType;
+  /* also holds back the button uplinks for the duty cycle */
+  TimerInit( &TxTimer, OnTxTimerEvent );
+  TimerSetSlack( &TxTimer,  APP_TX_DUTYCYCLE_SLACK);
+
   if (EventType == TX_ON_TIMER)
   {
-    /* send everytime timer elapses */
-    TimerInit( &TxTimer, OnTxTimerEvent );
-    TimerSetValue( &TxTimer,  APP_TX_DUTYCYCLE); 
+    /* send when the sensors trigger a report, see ReportRules */
     OnTxTimerEvent( NULL );
   }
   else
@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    bench_dsp.c
+  * @author  MCD Application Team
+  * @brief   CMSIS-DSP kernels of DSP/Source/x86 against the C versions of
+  *          bench/dsp_ref.c, per kernel and per type, on a 256 sample block
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include <stdio.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_LOOPS       20000
+#define BLOCK_SIZE        256
+#define FIR_TAPS          32
+#define BIQUAD_STAGES     2
+
+/* Private macro -------------------------------------------------------------*/
+/* Keeps the results live across iterations */
+#define CLOBBER( p )      __asm__ volatile( "" : : "r"( p ) : "memory" )
+
+/* Private variables ---------------------------------------------------------*/
+static float32_t F32Src[BLOCK_SIZE + FIR_TAPS], F32Dst[2 * 1024];
+static q31_t Q31Src[BLOCK_SIZE + FIR_TAPS], Q31Dst[BLOCK_SIZE];
+static q15_t Q15Src[BLOCK_SIZE + FIR_TAPS], Q15Dst[BLOCK_SIZE];
+static q7_t Q7Src[BLOCK_SIZE + FIR_TAPS], Q7Dst[BLOCK_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+static double Now( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Time per call of one statement */
+#define TIME( result, call )                                                       \
+  do{                                                                              \
+    double start = Now( );                                                         \
+    for( uint32_t k = 0; k < BENCH_LOOPS; k++ )                                    \
+    {                                                                              \
+      call;                                                                        \
+      CLOBBER( F32Dst );                                                           \
+    }                                                                              \
+    result = ( Now( ) - start ) * 1e9 / BENCH_LOOPS;                               \
+  }while(0)
+
+/* C version then x86 version of a kernel over n samples */
+#define BENCH( label, n, refCall, call )                                           \
+  do{                                                                              \
+    double refNs, ns;                                                              \
+    TIME( refNs, refCall );                                                        \
+    TIME( ns, call );                                                              \
+    printf( "%-24s %9.1f ns %9.1f ns %8.1f Msample/s  x%.2f\n", label, refNs, ns,  \
+            ( n ) * 1e3 / ns, refNs / ns );                                        \
+  }while(0)
+
+/* Dot product, FIR, mean, power, min, max of one type */
+#define BENCH_TYPE( type, t, powtype, src, dst )                                   \
+  do{                                                                              \
+    static type state[FIR_TAPS + BLOCK_SIZE], stateRef[FIR_TAPS + BLOCK_SIZE];     \
+    arm_fir_instance_##t fir = { FIR_TAPS, state, src };                           \
+    arm_fir_instance_##t firRef = { FIR_TAPS, stateRef, src };                     \
+    powtype p;                                                                     \
+    type v;                                                                        \
+    uint32_t i;                                                                    \
+    BENCH( "dot_prod_" #t, BLOCK_SIZE,                                             \
+           ref_arm_dot_prod_##t( src, src + 1, BLOCK_SIZE, &p ),                   \
+           arm_dot_prod_##t( src, src + 1, BLOCK_SIZE, &p ) );                     \
+    BENCH( "fir_" #t " 32 taps", BLOCK_SIZE,                                       \
+           ref_arm_fir_##t( &firRef, src, dst, BLOCK_SIZE ),                       \
+           arm_fir_##t( &fir, src, dst, BLOCK_SIZE ) );                            \
+    BENCH( "mean_" #t, BLOCK_SIZE,                                                 \
+           ref_arm_mean_##t( src, BLOCK_SIZE, &v ),                                \
+           arm_mean_##t( src, BLOCK_SIZE, &v ) );                                  \
+    BENCH( "power_" #t, BLOCK_SIZE,                                                \
+           ref_arm_power_##t( src, BLOCK_SIZE, &p ),                               \
+           arm_power_##t( src, BLOCK_SIZE, &p ) );                                 \
+    BENCH( "min_" #t, BLOCK_SIZE,                                                  \
+           ref_arm_min_##t( src, BLOCK_SIZE, &v, &i ),                             \
+           arm_min_##t( src, BLOCK_SIZE, &v, &i ) );                               \
+    BENCH( "max_" #t, BLOCK_SIZE,                                                  \
+           ref_arm_max_##t( src, BLOCK_SIZE, &v, &i ),                             \
+           arm_max_##t( src, BLOCK_SIZE, &v, &i ) );                               \
+  }while(0)
+
+/* Biquad cascade and variance of one type, q7 has neither */
+#define BENCH_IIR( type, t, shift, src, dst )                                      \
+  do{                                                                              \
+    static type state[4 * BIQUAD_STAGES], stateRef[4 * BIQUAD_STAGES];             \
+    arm_biquad_casd_df1_inst_##t iir = { BIQUAD_STAGES, state, coeffs##t, shift }; \
+    arm_biquad_casd_df1_inst_##t iirRef = { BIQUAD_STAGES, stateRef, coeffs##t,    \
+                                            shift };                               \
+    type v;                                                                        \
+    BENCH( "biquad_df1_" #t " 2 stages", BLOCK_SIZE,                               \
+           ref_arm_biquad_cascade_df1_##t( &iirRef, src, dst, BLOCK_SIZE ),        \
+           arm_biquad_cascade_df1_##t( &iir, src, dst, BLOCK_SIZE ) );             \
+    BENCH( "var_" #t, BLOCK_SIZE,                                                  \
+           ref_arm_var_##t( src, BLOCK_SIZE, &v ),                                 \
+           arm_var_##t( src, BLOCK_SIZE, &v ) );                                   \
+  }while(0)
+
+int main( void )
+{
+  /* low pass sections, in 2.30 and 2.14 for a post shift of 1 */
+  static float32_t coeffsf32[5 * BIQUAD_STAGES] =
+  {
+    0.2f, 0.4f, 0.2f, 0.5f, -0.3f,
+    0.2f, 0.4f, 0.2f, 0.6f, -0.2f
+  };
+  static q31_t coeffsq31[5 * BIQUAD_STAGES];
+  static q15_t coeffsq15[6 * BIQUAD_STAGES];
+
+  for( uint32_t i = 0; i < BLOCK_SIZE + FIR_TAPS; i++ )
+  {
+    F32Src[i] = ( float32_t )( ( i * 37 ) % 101 ) / 101.0f - 0.5f;
+    Q31Src[i] = ( q31_t )( F32Src[i] * 2147483648.0f );
+    Q15Src[i] = ( q15_t )( Q31Src[i] >> 16 );
+    Q7Src[i] = ( q7_t )( Q31Src[i] >> 24 );
+  }
+  for( uint32_t i = 0; i < 5 * BIQUAD_STAGES; i++ )
+  {
+    coeffsq31[i] = ( q31_t )( coeffsf32[i] * 1073741824.0f );
+    coeffsq15[i + i / 5 + ( ( i % 5 ) != 0 )] = ( q15_t )( coeffsf32[i] * 16384.0f );
+  }
+
+#if defined( __AVX2__ )
+  printf( "x86 kernels: AVX2\n" );
+#elif defined( __SSE4_1__ )
+  printf( "x86 kernels: SSE4.1\n" );
+#else
+  printf( "x86 kernels: none, the C versions against themselves\n" );
+#endif
+  printf( "%-24s %12s %12s\n", "kernel", "C", "x86" );
+
+  BENCH_TYPE( float32_t, f32, float32_t, F32Src, F32Dst );
+  BENCH_IIR( float32_t, f32, , F32Src, F32Dst );
+  BENCH_TYPE( q31_t, q31, q63_t, Q31Src, Q31Dst );
+  BENCH_IIR( q31_t, q31, 1, Q31Src, Q31Dst );
+  BENCH_TYPE( q15_t, q15, q63_t, Q15Src, Q15Dst );
+  BENCH_IIR( q15_t, q15, 1, Q15Src, Q15Dst );
+  BENCH_TYPE( q7_t, q7, q31_t, Q7Src, Q7Dst );
+
+  /* in place: the same buffer transformed back and forth */
+  BENCH( "cfft_f32 256", 256,
+         ref_arm_cfft_f32( &arm_cfft_sR_f32_len256, F32Dst, ( uint8_t )( k & 1 ), 1 ),
+         arm_cfft_f32( &arm_cfft_sR_f32_len256, F32Dst, ( uint8_t )( k & 1 ), 1 ) );
+  BENCH( "cfft_f32 1024", 1024,
+         ref_arm_cfft_f32( &arm_cfft_sR_f32_len1024, F32Dst, ( uint8_t )( k & 1 ), 1 ),
+         arm_cfft_f32( &arm_cfft_sR_f32_len1024, F32Dst, ( uint8_t )( k & 1 ), 1 ) );
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+  * @file    bench_memcpy.c
+  * @author  MCD Application Team
+  * @brief   Memory helpers of utilities.c: word paths against the byte loops
+  *          they replaced, aligned and mismatched, and the AES-CMAC of a
+  *          LoRaWAN sized frame. Built without auto vectorization nor loop
+  *          to memcpy conversion, so that the host runs scalar code as the
+  *          Cortex-M0+ does
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include "hw.h"
+#include "cmac.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_LOOPS       200000
+
+/* Private macro -------------------------------------------------------------*/
+/* Keeps the destination live across iterations */
+#define CLOBBER( p )      __asm__ volatile( "" : : "r"( p ) : "memory" )
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Src[288] __attribute__( ( aligned( 8 ) ) );
+static uint8_t Dst[288] __attribute__( ( aligned( 8 ) ) );
+
+/* Private functions ---------------------------------------------------------*/
+static double Now( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Byte loops of the previous utilities.c */
+__attribute__( ( noinline ) ) static void ByteCopy( uint8_t *dst, const uint8_t *src, uint16_t size )
+{
+  while( size-- )
+  {
+    *dst++ = *src++;
+  }
+}
+
+__attribute__( ( noinline ) ) static void ByteSet( uint8_t *dst, uint8_t value, uint16_t size )
+{
+  while( size-- )
+  {
+    *dst++ = value;
+  }
+}
+
+__attribute__( ( noinline ) ) static void ByteXor( uint8_t *dst, const uint8_t *src, uint16_t size )
+{
+  while( size-- )
+  {
+    *dst++ ^= *src++;
+  }
+}
+
+#define BENCH( label, call )                                                       \
+  do{                                                                              \
+    double start = Now( );                                                         \
+    for( uint32_t k = 0; k < BENCH_LOOPS; k++ )                                    \
+    {                                                                              \
+      call;                                                                        \
+      CLOBBER( Dst );                                                              \
+    }                                                                              \
+    printf( "%-28s %8.1f ns\n", label, ( Now( ) - start ) * 1e9 / BENCH_LOOPS );   \
+  }while(0)
+
+int main( void )
+{
+  static const uint16_t sizes[] = { 16, 64, 255 };
+
+  for( uint32_t i = 0; i < sizeof( Src ); i++ )
+  {
+    Src[i] = ( uint8_t )i;
+  }
+
+  for( uint32_t s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); s++ )
+  {
+    uint16_t n = sizes[s];
+
+    printf( "-- %u bytes\n", n );
+    BENCH( "byte copy", ByteCopy( Dst, Src, n ) );
+    BENCH( "memcpy1 aligned", memcpy1( Dst, Src, n ) );
+    BENCH( "memcpy1 same misalignment", memcpy1( Dst + 1, Src + 1, n ) );
+    BENCH( "memcpy1 mismatched", memcpy1( Dst + 1, Src, n ) );
+    BENCH( "memcpyr aligned", memcpyr( Dst, Src, n & ~3 ) );
+    BENCH( "byte set", ByteSet( Dst, 0x5A, n ) );
+    BENCH( "memset1", memset1( Dst, 0x5A, n ) );
+    BENCH( "byte xor", ByteXor( Dst, Src, n ) );
+    BENCH( "memxor1", memxor1( Dst, Src, n ) );
+  }
+
+  printf( "-- AES-CMAC\n" );
+  {
+    static const uint8_t key[16] = { 0 };
+    uint8_t digest[16];
+    AES_CMAC_CTX ctx;
+
+    BENCH( "cmac 64 bytes",
+           AES_CMAC_Init( &ctx ); AES_CMAC_SetKey( &ctx, key );
+           AES_CMAC_Update( &ctx, Src, 64 ); AES_CMAC_Final( digest, &ctx ); Dst[0] = digest[0] );
+  }
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
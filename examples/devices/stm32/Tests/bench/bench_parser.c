@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+  * @file    bench_parser.c
+  * @author  MCD Application Team
+  * @brief   LoRaMac data frame parser and serializer against their versions
+  *          before the bounds checks: same output, frames per second
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <time.h>
+#include "hw.h"
+#include "LoRaMacParser.h"
+#include "LoRaMacSerializer.h"
+#include "legacy_parser.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_FRAMES          4096
+#define BENCH_ITERATIONS      4000000
+#define BENCH_MAX_PAYLOAD     52
+
+/* Private typedef -----------------------------------------------------------*/
+typedef LoRaMacParserStatus_t ( *Parser_t )( LoRaMacMessageData_t *macMsg );
+typedef LoRaMacSerializerStatus_t ( *Serializer_t )( LoRaMacMessageData_t *macMsg );
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Frames[BENCH_FRAMES][256];
+static uint8_t Sizes[BENCH_FRAMES];
+static uint8_t Payload[256];
+static uint8_t Payload2[256];
+/* Sink of the parsed fields, keeps the calls from being optimized out */
+static volatile uint32_t Sink;
+static uint32_t RandState = 1;
+
+/* Private functions ---------------------------------------------------------*/
+static double Now( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t Rand( void )
+{
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState;
+}
+
+/* Uplinks of random FOpts and payload sizes, the same bytes from both versions */
+static int BuildFrames( void )
+{
+  for( int i = 0; i < BENCH_FRAMES; i++ )
+  {
+    LoRaMacMessageData_t msg = { 0 };
+    LoRaMacMessageData_t legacy;
+    LoRaMacMessageData_t parsed = { 0 };
+    LoRaMacMessageData_t legacyParsed = { 0 };
+    uint8_t legacyFrame[256];
+
+    msg.Buffer = Frames[i];
+    msg.BufSize = 255;
+    msg.MHDR.Value = 0x60;
+    msg.FHDR.DevAddr = Rand( );
+    msg.FHDR.FCnt = Rand( );
+    msg.FHDR.FCtrl.Value = Rand( ) & 0xF0;
+    msg.FHDR.FCtrl.Bits.FOptsLen = Rand( ) % 16;
+    for( int k = 0; k < 15; k++ )
+    {
+      msg.FHDR.FOpts[k] = Rand( );
+    }
+    msg.FRMPayloadSize = Rand( ) % BENCH_MAX_PAYLOAD;
+    for( int k = 0; k < msg.FRMPayloadSize; k++ )
+    {
+      Payload[k] = Rand( );
+    }
+    msg.FRMPayload = Payload;
+    msg.FPort = 1 + Rand( ) % 200;
+    msg.MIC = Rand( );
+
+    legacy = msg;
+    legacy.Buffer = legacyFrame;
+    if( ( LoRaMacSerializerData( &msg ) != LORAMAC_SERIALIZER_SUCCESS ) ||
+        ( LegacyLoRaMacSerializerData( &legacy ) != LORAMAC_SERIALIZER_SUCCESS ) ||
+        ( legacy.BufSize != msg.BufSize ) || ( memcmp( legacyFrame, Frames[i], msg.BufSize ) != 0 ) )
+    {
+      printf( "serializers differ on frame %d\n", i );
+      return -1;
+    }
+    Sizes[i] = msg.BufSize;
+
+    parsed.Buffer = legacyParsed.Buffer = Frames[i];
+    parsed.BufSize = legacyParsed.BufSize = Sizes[i];
+    parsed.FRMPayload = Payload;
+    legacyParsed.FRMPayload = Payload2;
+    if( ( LoRaMacParserData( &parsed ) != LORAMAC_PARSER_SUCCESS ) ||
+        ( LegacyLoRaMacParserData( &legacyParsed ) != LORAMAC_PARSER_SUCCESS ) ||
+        ( parsed.FHDR.DevAddr != legacyParsed.FHDR.DevAddr ) || ( parsed.FHDR.FCnt != legacyParsed.FHDR.FCnt ) ||
+        ( parsed.FPort != legacyParsed.FPort ) || ( parsed.MIC != legacyParsed.MIC ) ||
+        ( parsed.FRMPayloadSize != legacyParsed.FRMPayloadSize ) ||
+        ( memcmp( Payload, Payload2, parsed.FRMPayloadSize ) != 0 ) ||
+        ( memcmp( parsed.FHDR.FOpts, legacyParsed.FHDR.FOpts, parsed.FHDR.FCtrl.Bits.FOptsLen ) != 0 ) )
+    {
+      printf( "parsers differ on frame %d\n", i );
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static double BenchParser( Parser_t parser )
+{
+  LoRaMacMessageData_t msg = { 0 };
+  double start = Now( );
+
+  msg.FRMPayload = Payload;
+  for( long i = 0; i < BENCH_ITERATIONS; i++ )
+  {
+    msg.Buffer = Frames[i % BENCH_FRAMES];
+    msg.BufSize = Sizes[i % BENCH_FRAMES];
+    parser( &msg );
+    Sink += msg.MIC;
+  }
+  return BENCH_ITERATIONS / ( Now( ) - start ) / 1e6;
+}
+
+static double BenchSerializer( Serializer_t serializer )
+{
+  LoRaMacMessageData_t msg = { 0 };
+  uint8_t frame[256];
+  double start = Now( );
+
+  msg.Buffer = frame;
+  msg.FRMPayload = Payload;
+  for( long i = 0; i < BENCH_ITERATIONS; i++ )
+  {
+    msg.BufSize = 255;
+    msg.FHDR.FCtrl.Bits.FOptsLen = i & 15;
+    msg.FRMPayloadSize = ( i * 7 ) % BENCH_MAX_PAYLOAD;
+    msg.MIC = i;
+    serializer( &msg );
+    Sink += frame[msg.BufSize - 1];
+  }
+  return BENCH_ITERATIONS / ( Now( ) - start ) / 1e6;
+}
+
+int main( void )
+{
+  if( BuildFrames( ) != 0 )
+  {
+    return 1;
+  }
+  printf( "%d frames, same output from both versions\n", BENCH_FRAMES );
+
+  printf( "parser       legacy %6.2f Mframes/s, bounds checked %6.2f Mframes/s\n",
+          BenchParser( LegacyLoRaMacParserData ), BenchParser( LoRaMacParserData ) );
+  printf( "serializer   legacy %6.2f Mframes/s, bounds checked %6.2f Mframes/s\n",
+          BenchSerializer( LegacyLoRaMacSerializerData ), BenchSerializer( LoRaMacSerializerData ) );
+
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,148 @@
+/**
+  ******************************************************************************
+  * @file    bench_queue.c
+  * @author  MCD Application Team
+  * @brief   Trace queue throughput: the SPSC ring (queue.c) against the
+  *          element queue it replaced (legacy_queue.c). The producer pushes
+  *          bursts of messages and the consumer drains them as the trace
+  *          completion callback does, one transfer per span or per element
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include "hw.h"
+#include "queue.h"
+#include "legacy_queue.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_QUEUE_SIZE      256
+#define BENCH_MESSAGES        4000000
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t QueueBuff[BENCH_QUEUE_SIZE];
+static uint8_t Message[BENCH_QUEUE_SIZE];
+/* Sink of the consumed bytes, keeps the copies from being optimized out */
+static volatile uint32_t Sink;
+
+/* Private functions ---------------------------------------------------------*/
+static double Now( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void BenchRing( uint16_t size, uint16_t burst, double *ns, double *transfers )
+{
+  queue_param_t q;
+  uint32_t sent = 0;
+  uint32_t spans = 0;
+  uint8_t *p;
+  uint16_t len;
+  double start;
+
+  circular_queue_init( &q, QueueBuff, sizeof( QueueBuff ) );
+  start = Now( );
+  while( sent < BENCH_MESSAGES )
+  {
+    for( uint16_t i = 0; i < burst; i++, sent++ )
+    {
+      BACKUP_PRIMASK( );
+      DISABLE_IRQ( );
+      p = circular_queue_reserve( &q, size );
+      RESTORE_PRIMASK( );
+      if( p == NULL )
+      {
+        break;
+      }
+      memcpy( p, Message, size );
+      circular_queue_commit( &q, size );
+    }
+    while( circular_queue_peek( &q, &p, &len ) == 0 )
+    {
+      Sink += p[len - 1];
+      circular_queue_release( &q, len );
+      spans++;
+    }
+  }
+  *ns = ( Now( ) - start ) * 1e9 / sent;
+  *transfers = ( double )spans / sent;
+}
+
+static void BenchLegacy( uint16_t size, uint16_t burst, double *ns, double *transfers )
+{
+  legacy_queue_t q;
+  uint32_t sent = 0;
+  uint32_t elements = 0;
+  uint8_t *p;
+  uint16_t len;
+  double start;
+
+  legacy_queue_init( &q, QueueBuff, sizeof( QueueBuff ) );
+  start = Now( );
+  while( sent < BENCH_MESSAGES )
+  {
+    for( uint16_t i = 0; i < burst; i++, sent++ )
+    {
+      int status;
+
+      BACKUP_PRIMASK( );
+      DISABLE_IRQ( );
+      status = legacy_queue_add( &q, Message, size );
+      RESTORE_PRIMASK( );
+      if( status != 0 )
+      {
+        break;
+      }
+    }
+    while( legacy_queue_get( &q, &p, &len ) == 0 )
+    {
+      Sink += p[len - 1];
+      BACKUP_PRIMASK( );
+      DISABLE_IRQ( );
+      legacy_queue_remove( &q );
+      RESTORE_PRIMASK( );
+      elements++;
+    }
+  }
+  *ns = ( Now( ) - start ) * 1e9 / sent;
+  *transfers = ( double )elements / sent;
+}
+
+int main( void )
+{
+  static const uint16_t sizes[] = { 8, 32, 80 };
+  static const uint16_t bursts[] = { 1, 4 };
+
+  memset( Message, 'x', sizeof( Message ) );
+  printf( "queue %d bytes, %d messages per run\n", BENCH_QUEUE_SIZE, BENCH_MESSAGES );
+  printf( "size burst |   ring ns/msg xfer/msg | legacy ns/msg xfer/msg\n" );
+  for( uint32_t s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); s++ )
+  {
+    for( uint32_t b = 0; b < sizeof( bursts ) / sizeof( bursts[0] ); b++ )
+    {
+      double ringNs, ringXfer, legacyNs, legacyXfer;
+
+      BenchRing( sizes[s], bursts[b], &ringNs, &ringXfer );
+      BenchLegacy( sizes[s], bursts[b], &legacyNs, &legacyXfer );
+      printf( "%4u %5u | %13.1f %8.2f | %13.1f %8.2f\n", sizes[s], bursts[b],
+              ringNs, ringXfer, legacyNs, legacyXfer );
+    }
+  }
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ref.c
+  * @author  MCD Application Team
+  * @brief   C versions of the CMSIS-DSP kernels the x86 files replace,
+  *          compiled from the library sources under the ref_ prefix
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+/* The library sources below define the ref_ functions of dsp_ref.h */
+#define arm_dot_prod_f32           ref_arm_dot_prod_f32
+#define arm_dot_prod_q31           ref_arm_dot_prod_q31
+#define arm_dot_prod_q15           ref_arm_dot_prod_q15
+#define arm_dot_prod_q7            ref_arm_dot_prod_q7
+#define arm_fir_f32                ref_arm_fir_f32
+#define arm_fir_q31                ref_arm_fir_q31
+#define arm_fir_q15                ref_arm_fir_q15
+#define arm_fir_q7                 ref_arm_fir_q7
+#define arm_biquad_cascade_df1_f32 ref_arm_biquad_cascade_df1_f32
+#define arm_biquad_cascade_df1_q31 ref_arm_biquad_cascade_df1_q31
+#define arm_biquad_cascade_df1_q15 ref_arm_biquad_cascade_df1_q15
+#define arm_mean_f32               ref_arm_mean_f32
+#define arm_mean_q31               ref_arm_mean_q31
+#define arm_mean_q15               ref_arm_mean_q15
+#define arm_mean_q7                ref_arm_mean_q7
+#define arm_power_f32              ref_arm_power_f32
+#define arm_power_q31              ref_arm_power_q31
+#define arm_power_q15              ref_arm_power_q15
+#define arm_power_q7               ref_arm_power_q7
+#define arm_min_f32                ref_arm_min_f32
+#define arm_min_q31                ref_arm_min_q31
+#define arm_min_q15                ref_arm_min_q15
+#define arm_min_q7                 ref_arm_min_q7
+#define arm_max_f32                ref_arm_max_f32
+#define arm_max_q31                ref_arm_max_q31
+#define arm_max_q15                ref_arm_max_q15
+#define arm_max_q7                 ref_arm_max_q7
+#define arm_var_f32                ref_arm_var_f32
+#define arm_var_q31                ref_arm_var_q31
+#define arm_var_q15                ref_arm_var_q15
+#define arm_cfft_f32               ref_arm_cfft_f32
+#define arm_cfft_radix8by2_f32     ref_arm_cfft_radix8by2_f32
+#define arm_cfft_radix8by4_f32     ref_arm_cfft_radix8by4_f32
+#define arm_radix8_butterfly_f32   ref_arm_radix8_butterfly_f32
+
+/* Private functions ---------------------------------------------------------*/
+#include "BasicMathFunctions/arm_dot_prod_f32.c"
+#include "BasicMathFunctions/arm_dot_prod_q31.c"
+#include "BasicMathFunctions/arm_dot_prod_q15.c"
+#include "BasicMathFunctions/arm_dot_prod_q7.c"
+#include "FilteringFunctions/arm_fir_f32.c"
+#include "FilteringFunctions/arm_fir_q31.c"
+#include "FilteringFunctions/arm_fir_q15.c"
+#include "FilteringFunctions/arm_fir_q7.c"
+#include "FilteringFunctions/arm_biquad_cascade_df1_f32.c"
+#include "FilteringFunctions/arm_biquad_cascade_df1_q31.c"
+#include "FilteringFunctions/arm_biquad_cascade_df1_q15.c"
+#include "StatisticsFunctions/arm_mean_f32.c"
+#include "StatisticsFunctions/arm_mean_q31.c"
+#include "StatisticsFunctions/arm_mean_q15.c"
+#include "StatisticsFunctions/arm_mean_q7.c"
+#include "StatisticsFunctions/arm_power_f32.c"
+#include "StatisticsFunctions/arm_power_q31.c"
+#include "StatisticsFunctions/arm_power_q15.c"
+#include "StatisticsFunctions/arm_power_q7.c"
+#include "StatisticsFunctions/arm_min_f32.c"
+#include "StatisticsFunctions/arm_min_q31.c"
+#include "StatisticsFunctions/arm_min_q15.c"
+#include "StatisticsFunctions/arm_min_q7.c"
+#include "StatisticsFunctions/arm_max_f32.c"
+#include "StatisticsFunctions/arm_max_q31.c"
+#include "StatisticsFunctions/arm_max_q15.c"
+#include "StatisticsFunctions/arm_max_q7.c"
+#include "StatisticsFunctions/arm_var_f32.c"
+#include "StatisticsFunctions/arm_var_q31.c"
+#include "StatisticsFunctions/arm_var_q15.c"
+#include "TransformFunctions/arm_cfft_f32.c"
+#include "TransformFunctions/arm_cfft_radix8_f32.c"
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ref.h
+  * @author  MCD Application Team
+  * @brief   C versions of the CMSIS-DSP kernels the x86 files of
+  *          DSP/Source/x86 replace, renamed ref_<name>: the reference of the
+  *          conformance test and of the benchmark of the x86 kernels
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_REF_H__
+#define __DSP_REF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "arm_math.h"
+
+/* Exported functions ------------------------------------------------------- */
+void ref_arm_dot_prod_f32( float32_t *pSrcA, float32_t *pSrcB, uint32_t blockSize, float32_t *result );
+void ref_arm_dot_prod_q31( q31_t *pSrcA, q31_t *pSrcB, uint32_t blockSize, q63_t *result );
+void ref_arm_dot_prod_q15( q15_t *pSrcA, q15_t *pSrcB, uint32_t blockSize, q63_t *result );
+void ref_arm_dot_prod_q7( q7_t *pSrcA, q7_t *pSrcB, uint32_t blockSize, q31_t *result );
+void ref_arm_fir_f32( const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize );
+void ref_arm_fir_q31( const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst, uint32_t blockSize );
+void ref_arm_fir_q15( const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize );
+void ref_arm_fir_q7( const arm_fir_instance_q7 *S, q7_t *pSrc, q7_t *pDst, uint32_t blockSize );
+void ref_arm_biquad_cascade_df1_f32( const arm_biquad_casd_df1_inst_f32 *S, float32_t *pSrc, float32_t *pDst,
+                                    uint32_t blockSize );
+void ref_arm_biquad_cascade_df1_q31( const arm_biquad_casd_df1_inst_q31 *S, q31_t *pSrc, q31_t *pDst,
+                                    uint32_t blockSize );
+void ref_arm_biquad_cascade_df1_q15( const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc, q15_t *pDst,
+                                    uint32_t blockSize );
+void ref_arm_mean_f32( float32_t *pSrc, uint32_t blockSize, float32_t *pResult );
+void ref_arm_mean_q31( q31_t *pSrc, uint32_t blockSize, q31_t *pResult );
+void ref_arm_mean_q15( q15_t *pSrc, uint32_t blockSize, q15_t *pResult );
+void ref_arm_mean_q7( q7_t *pSrc, uint32_t blockSize, q7_t *pResult );
+void ref_arm_power_f32( float32_t *pSrc, uint32_t blockSize, float32_t *pResult );
+void ref_arm_power_q31( q31_t *pSrc, uint32_t blockSize, q63_t *pResult );
+void ref_arm_power_q15( q15_t *pSrc, uint32_t blockSize, q63_t *pResult );
+void ref_arm_power_q7( q7_t *pSrc, uint32_t blockSize, q31_t *pResult );
+void ref_arm_min_f32( float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex );
+void ref_arm_min_q31( q31_t *pSrc, uint32_t blockSize, q31_t *pResult, uint32_t *pIndex );
+void ref_arm_min_q15( q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex );
+void ref_arm_min_q7( q7_t *pSrc, uint32_t blockSize, q7_t *pResult, uint32_t *pIndex );
+void ref_arm_max_f32( float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex );
+void ref_arm_max_q31( q31_t *pSrc, uint32_t blockSize, q31_t *pResult, uint32_t *pIndex );
+void ref_arm_max_q15( q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex );
+void ref_arm_max_q7( q7_t *pSrc, uint32_t blockSize, q7_t *pResult, uint32_t *pIndex );
+void ref_arm_var_f32( float32_t *pSrc, uint32_t blockSize, float32_t *pResult );
+void ref_arm_var_q31( q31_t *pSrc, uint32_t blockSize, q31_t *pResult );
+void ref_arm_var_q15( q15_t *pSrc, uint32_t blockSize, q15_t *pResult );
+void ref_arm_cfft_f32( const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_REF_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
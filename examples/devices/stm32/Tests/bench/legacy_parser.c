@@ -0,0 +1,138 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+    (C)2013 Semtech
+ ___ _____ _   ___ _  _____ ___  ___  ___ ___
+/ __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+\__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+|___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+embedded.connectivity.solutions===============
+
+Description: LoRa MAC data frame parser and serializer before the bounds
+             checks, kept as the reference of the parser benchmark
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+
+Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
+            Daniel Jaeckle ( STACKFORCE ),  Johannes Bruder ( STACKFORCE )
+*/
+#include "legacy_parser.h"
+#include "utilities.h"
+
+LoRaMacParserStatus_t LegacyLoRaMacParserData( LoRaMacMessageData_t* macMsg )
+{
+    if( ( macMsg == 0 ) || ( macMsg->Buffer == 0 ) )
+    {
+        return LORAMAC_PARSER_ERROR_NPE;
+    }
+
+    uint16_t bufItr = 0;
+
+    macMsg->MHDR.Value = macMsg->Buffer[bufItr++];
+
+    macMsg->FHDR.DevAddr = macMsg->Buffer[bufItr++];
+    macMsg->FHDR.DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 8 );
+    macMsg->FHDR.DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 16 );
+    macMsg->FHDR.DevAddr |= ( ( uint32_t ) macMsg->Buffer[bufItr++] << 24 );
+
+    macMsg->FHDR.FCtrl.Value = macMsg->Buffer[bufItr++];
+
+    macMsg->FHDR.FCnt = macMsg->Buffer[bufItr++];
+    macMsg->FHDR.FCnt |= macMsg->Buffer[bufItr++] << 8;
+
+    if( macMsg->FHDR.FCtrl.Bits.FOptsLen <= 15 )
+    {
+        memcpy1( macMsg->FHDR.FOpts, &macMsg->Buffer[bufItr], macMsg->FHDR.FCtrl.Bits.FOptsLen );
+        bufItr = bufItr + macMsg->FHDR.FCtrl.Bits.FOptsLen;
+    }
+    else
+    {
+        return LORAMAC_PARSER_FAIL;
+    }
+
+    // Initialize anyway with zero.
+    macMsg->FPort = 0;
+    macMsg->FRMPayloadSize = 0;
+
+    if( ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE ) > 0 )
+    {
+        macMsg->FPort = macMsg->Buffer[bufItr++];
+
+        macMsg->FRMPayloadSize = ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE );
+        memcpy1( macMsg->FRMPayload, &macMsg->Buffer[bufItr], macMsg->FRMPayloadSize );
+        bufItr = bufItr + macMsg->FRMPayloadSize;
+    }
+
+    macMsg->MIC = ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE )];
+    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 1] << 8 );
+    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 2] << 16 );
+    macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 3] << 24 );
+
+    return LORAMAC_PARSER_SUCCESS;
+}
+
+LoRaMacSerializerStatus_t LegacyLoRaMacSerializerData( LoRaMacMessageData_t* macMsg )
+{
+    if( ( macMsg == 0 ) || ( macMsg->Buffer == 0 ) )
+    {
+        return LORAMAC_SERIALIZER_ERROR_NPE;
+    }
+
+    uint16_t bufItr = 0;
+
+    // Check macMsg->BufSize
+    uint16_t computedBufSize =   LORAMAC_MHDR_FIELD_SIZE
+                               + LORAMAC_FHDR_DEV_ADD_FIELD_SIZE
+                               + LORAMAC_FHDR_F_CTRL_FIELD_SIZE
+                               + LORAMAC_FHDR_F_CNT_FIELD_SIZE;
+
+    if( macMsg->FRMPayloadSize == 0 )
+    {
+        if( macMsg->BufSize < computedBufSize )
+        {
+            return LORAMAC_SERIALIZER_ERROR_BUF_SIZE;
+        }
+    }
+    else
+    {   //If FRMPayload >0, FPort field is present.
+        if( macMsg->BufSize < computedBufSize + macMsg->FHDR.FCtrl.Bits.FOptsLen + macMsg->FRMPayloadSize + LORAMAC_F_PORT_FIELD_SIZE )
+        {
+            return LORAMAC_SERIALIZER_ERROR_BUF_SIZE;
+        }
+    }
+
+    macMsg->Buffer[bufItr++] = macMsg->MHDR.Value;
+
+    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr ) & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr >> 8 ) & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr >> 16 ) & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.DevAddr >> 24 ) & 0xFF;
+
+    macMsg->Buffer[bufItr++] = macMsg->FHDR.FCtrl.Value;
+
+    macMsg->Buffer[bufItr++] = macMsg->FHDR.FCnt & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->FHDR.FCnt >> 8 ) & 0xFF;
+
+    memcpy1( &macMsg->Buffer[bufItr], macMsg->FHDR.FOpts, macMsg->FHDR.FCtrl.Bits.FOptsLen );
+    bufItr = bufItr + macMsg->FHDR.FCtrl.Bits.FOptsLen;
+
+    if( macMsg->FRMPayloadSize > 0 )
+    {
+        macMsg->Buffer[bufItr++] = macMsg->FPort;
+    }
+
+    memcpy1( &macMsg->Buffer[bufItr], macMsg->FRMPayload, macMsg->FRMPayloadSize );
+    bufItr = bufItr + macMsg->FRMPayloadSize;
+
+    macMsg->Buffer[bufItr++] = macMsg->MIC & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 8 ) & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 16 ) & 0xFF;
+    macMsg->Buffer[bufItr++] = ( macMsg->MIC >> 24 ) & 0xFF;
+
+    macMsg->BufSize = bufItr;
+
+    return LORAMAC_SERIALIZER_SUCCESS;
+}
@@ -0,0 +1,44 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+    (C)2013 Semtech
+ ___ _____ _   ___ _  _____ ___  ___  ___ ___
+/ __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+\__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+|___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+embedded.connectivity.solutions===============
+
+Description: LoRa MAC data frame parser and serializer before the bounds
+             checks, kept as the reference of the parser benchmark
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+
+Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
+            Daniel Jaeckle ( STACKFORCE ),  Johannes Bruder ( STACKFORCE )
+*/
+#ifndef __LEGACY_PARSER_H__
+#define __LEGACY_PARSER_H__
+
+#include "LoRaMacParser.h"
+#include "LoRaMacSerializer.h"
+
+/*!
+ * Parse a serialized data message without checking its size.
+ *
+ * \param[IN/OUT] macMsg       - Data message object
+ * \retval                     - Status of the operation
+ */
+LoRaMacParserStatus_t LegacyLoRaMacParserData( LoRaMacMessageData_t* macMsg );
+
+/*!
+ * Creates serialized data message, without counting the MIC in the buffer size.
+ *
+ * \param[IN/OUT] macMsg       - Data message object
+ * \retval                     - Status of the operation
+ */
+LoRaMacSerializerStatus_t LegacyLoRaMacSerializerData( LoRaMacMessageData_t* macMsg );
+
+#endif // __LEGACY_PARSER_H__
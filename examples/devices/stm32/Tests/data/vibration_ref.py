@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+#
+# Reference features of vibration.c, computed in double precision with numpy
+# on random multi-tone windows with noise and offset.
+#
+#   python3 vibration_ref.py [size] [cases] [seed] > vibration_<size>.txt
+#
+# Each case is two lines: the samples of the window, then the RMS, the crest
+# factor, the lines of the 3 largest peaks, their amplitudes and the RMS of
+# the 4 bands, as test_vibration.c reads them.
+
+import sys
+import numpy as np
+
+NB_PEAKS = 3
+NB_BANDS = 4
+
+
+def features(x):
+    n = len(x)
+    xc = x - x.mean()
+    rms = np.sqrt(np.mean(xc ** 2))
+    crest = np.max(np.abs(xc)) / rms if rms else 0
+    hann = 0.5 - 0.5 * np.cos(2 * np.pi * np.arange(n) / n)
+    mag = np.abs(np.fft.rfft(xc * hann)) / n
+    # amplitude of a sinusoid: 2 / N * |X| over the coherent gain 0.5 of Hann
+    amp = mag * 4
+    peaks = [b for b in range(1, n // 2) if mag[b] > mag[b - 1] and mag[b] >= mag[b + 1]]
+    peaks = sorted(peaks, key=lambda b: -mag[b])[:NB_PEAKS]
+    bands = []
+    for b in range(NB_BANDS):
+        first = max(1, b * (n // 2) // NB_BANDS)
+        last = (b + 1) * (n // 2) // NB_BANDS
+        # Hann power gain 3/8
+        bands.append(np.sqrt(2 * np.sum(mag[first:last] ** 2) * 8 / 3))
+    return rms, crest, peaks, [amp[b] for b in peaks], bands
+
+
+def main():
+    n = int(sys.argv[1]) if len(sys.argv) > 1 else 256
+    cases = int(sys.argv[2]) if len(sys.argv) > 2 else 48
+    rng = np.random.default_rng(int(sys.argv[3]) if len(sys.argv) > 3 else 1)
+    t = np.arange(n)
+    for _ in range(cases):
+        scale = 10 ** rng.uniform(1, 4)
+        x = np.full(n, rng.uniform(-16000, 16000))
+        for _ in range(rng.integers(1, 4)):
+            line = rng.integers(3, n // 2 - 3) + (0 if rng.random() < 0.5 else rng.uniform(0, 1))
+            x += scale * rng.uniform(0.2, 1) * np.sin(2 * np.pi * line * t / n + rng.uniform(0, 6.3))
+        x += rng.normal(0, scale * 0.02, n)
+        x = np.clip(np.round(x), -32768, 32767)
+        rms, crest, peaks, amps, bands = features(x)
+        print(' '.join(str(int(v)) for v in x))
+        print('%f %f %s %s %s' % (rms, crest, ' '.join(map(str, peaks)),
+                                  ' '.join('%f' % a for a in amps),
+                                  ' '.join('%f' % b for b in bands)))
+
+
+if __name__ == '__main__':
+    main()
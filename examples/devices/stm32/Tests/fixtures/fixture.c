@@ -0,0 +1,182 @@
+/**
+  ******************************************************************************
+  * @file    fixture.c
+  * @author  MCD Application Team
+  * @brief   JSON writer of the payload fixtures. The output is stable, so that
+  *          "make test" can compare it with the fixtures checked in
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fixture.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FIXTURE_MAX_DEPTH     8
+
+/* Private variables ---------------------------------------------------------*/
+/* Nesting below "expected", and whether the current level has an item yet */
+static int Depth;
+static bool HasItem[FIXTURE_MAX_DEPTH];
+static bool InCase;
+
+static const char Base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Private functions ---------------------------------------------------------*/
+static void Indent(int level)
+{
+  for (int i = 0; i < level; i++)
+  {
+    putchar('\t');
+  }
+}
+
+/* Separator and key of the next item of the current level */
+static void Item(const char *key)
+{
+  printf("%s\n", HasItem[Depth] ? "," : "");
+  HasItem[Depth] = true;
+  Indent(Depth + 4);
+  if (key != NULL)
+  {
+    printf("\"%s\": ", key);
+  }
+}
+
+static void Close(char bracket)
+{
+  bool hasItem = HasItem[Depth];
+
+  Depth--;
+  if (hasItem)
+  {
+    putchar('\n');
+    Indent(Depth + 4);
+  }
+  putchar(bracket);
+}
+
+static void EndCase(void)
+{
+  if (InCase)
+  {
+    Close('}');
+    printf("\n\t\t}");
+  }
+}
+
+/* Public functions ----------------------------------------------------------*/
+void FixtureBegin(const char *generator)
+{
+  printf("{\n\t\"generator\": \"%s\",\n\t\"cases\": [", generator);
+  InCase = false;
+}
+
+void FixtureCase(const char *description, const uint8_t *payload, uint16_t size)
+{
+  EndCase();
+  printf("%s\n\t\t{\n", InCase ? "," : "");
+  printf("\t\t\t\"description\": \"%s\",\n\t\t\t\"payload\": \"", description);
+  for (uint16_t i = 0; i < size; i += 3)
+  {
+    uint32_t bits = (uint32_t)payload[i] << 16;
+
+    if (i + 1 < size)
+    {
+      bits |= (uint32_t)payload[i + 1] << 8;
+    }
+    if (i + 2 < size)
+    {
+      bits |= payload[i + 2];
+    }
+    putchar(Base64[(bits >> 18) & 0x3F]);
+    putchar(Base64[(bits >> 12) & 0x3F]);
+    putchar((i + 1 < size) ? Base64[(bits >> 6) & 0x3F] : '=');
+    putchar((i + 2 < size) ? Base64[bits & 0x3F] : '=');
+  }
+  printf("\",\n\t\t\t\"expected\": {");
+  InCase = true;
+  Depth = 0;
+  HasItem[0] = false;
+}
+
+void FixtureNumber(const char *key, double value)
+{
+  char text[32];
+
+  /* shortest form reading back as the same double, as JavaScript prints it */
+  if ((fabs(value) < 1e15) && (value == (int64_t)value))
+  {
+    snprintf(text, sizeof(text), "%.0f", value);
+  }
+  else
+  {
+    for (int digits = 1; digits <= 17; digits++)
+    {
+      snprintf(text, sizeof(text), "%.*g", digits, value);
+      if (strtod(text, NULL) == value)
+      {
+        break;
+      }
+    }
+  }
+  Item(key);
+  printf("%s", text);
+}
+
+void FixtureBool(const char *key, bool value)
+{
+  Item(key);
+  printf("%s", value ? "true" : "false");
+}
+
+void FixtureString(const char *key, const char *value)
+{
+  Item(key);
+  printf("\"%s\"", value);
+}
+
+void FixtureObjectBegin(const char *key)
+{
+  Item(key);
+  putchar('{');
+  HasItem[++Depth] = false;
+}
+
+void FixtureObjectEnd(void)
+{
+  Close('}');
+}
+
+void FixtureArrayBegin(const char *key)
+{
+  Item(key);
+  putchar('[');
+  HasItem[++Depth] = false;
+}
+
+void FixtureArrayEnd(void)
+{
+  Close(']');
+}
+
+void FixtureEnd(void)
+{
+  EndCase();
+  printf("\n\t]\n}\n");
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
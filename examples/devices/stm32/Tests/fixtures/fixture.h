@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    fixture.h
+  * @author  MCD Application Team
+  * @brief   JSON writer of the payload fixtures: payloads encoded by the
+  *          firmware, with the values the agent must decode from them
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FIXTURE_H__
+#define __FIXTURE_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Starts the fixture file, on stdout
+ * @param  generator: source of the generator, from the repository root
+ * @retval None
+ */
+void FixtureBegin(const char *generator);
+
+/**
+ * @brief  Starts a case, its expected values follow until the next case
+ * @param  description: what the case covers
+ * @param  payload: payload encoded by the firmware, written in base64
+ * @param  size: size of payload
+ * @retval None
+ */
+void FixtureCase(const char *description, const uint8_t *payload, uint16_t size);
+
+/**
+ * @brief  Writes an expected value. key is NULL inside an array
+ * @param  key: name of the value
+ * @param  value: value
+ * @retval None
+ */
+void FixtureNumber(const char *key, double value);
+void FixtureBool(const char *key, bool value);
+void FixtureString(const char *key, const char *value);
+
+/**
+ * @brief  Opens and closes an object or an array of expected values
+ * @param  key: name of the object or array, NULL inside an array
+ * @retval None
+ */
+void FixtureObjectBegin(const char *key);
+void FixtureObjectEnd(void);
+void FixtureArrayBegin(const char *key);
+void FixtureArrayEnd(void);
+
+/**
+ * @brief  Ends the last case and the fixture file
+ * @param  None
+ * @retval None
+ */
+void FixtureEnd(void);
+
+#endif /* __FIXTURE_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
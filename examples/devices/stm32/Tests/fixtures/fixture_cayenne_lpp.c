@@ -0,0 +1,185 @@
+/**
+  ******************************************************************************
+  * @file    fixture_cayenne_lpp.c
+  * @author  MCD Application Team
+  * @brief   Cayenne LPP payloads encoded by cayenne_lpp.c, with the values
+  *          lib/dataModels/cayenneLpp.js must decode from them
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fixture.h"
+#include "cayenne_lpp.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Buff[242];
+static lpp_Buffer_t Lpp;
+
+/* Private functions ---------------------------------------------------------*/
+/* lpp_get_max_size stand-in for the LoRaWAN layer, largest payload of EU868 */
+uint8_t LORA_GetMaxPayloadSize(void)
+{
+  return sizeof(Buff);
+}
+
+static void Case(const char *description)
+{
+  FixtureCase(description, Lpp.Buff, Lpp.Size ? Lpp.Size : Lpp.Length);
+}
+
+static void Axes(const char *key, double x, double y, double z)
+{
+  FixtureObjectBegin(key);
+  FixtureNumber("x", x);
+  FixtureNumber("y", y);
+  FixtureNumber("z", z);
+  FixtureObjectEnd();
+}
+
+static void Gps(const char *key, double latitude, double longitude, double altitude)
+{
+  FixtureObjectBegin(key);
+  FixtureNumber("latitude", latitude);
+  FixtureNumber("longitude", longitude);
+  FixtureNumber("altitude", altitude);
+  FixtureObjectEnd();
+}
+
+/* One field of each type, raw values divided by their resolution */
+static void EveryType(void)
+{
+  lpp_init(&Lpp, Buff, sizeof(Buff));
+  lpp_add_barometric_pressure(&Lpp, 0, 10132);
+  lpp_add_temperature(&Lpp, 1, -125);
+  lpp_add_relative_humidity(&Lpp, 2, 97);
+  lpp_add_digital_input(&Lpp, 3, 88);
+  lpp_add_digital_output(&Lpp, 4, 1);
+  lpp_add_gps(&Lpp, 5, 423456, -87654, 1234567);
+  lpp_add_accelerometer(&Lpp, 6, 1, -2, 1000);
+  lpp_add_gyrometer(&Lpp, 7, -100, 200, 32767);
+  lpp_add_luminosity(&Lpp, 8, 32767);
+  lpp_add_analog_input(&Lpp, 9, -1234);
+  lpp_add_analog_output(&Lpp, 10, 4321);
+  lpp_add_presence(&Lpp, 11, 1);
+
+  Case("every type");
+  FixtureNumber("barometric_pressure_0", 10132 / 10.0);
+  FixtureNumber("temperature_1", -125 / 10.0);
+  FixtureNumber("relative_humidity_2", 97 / 2.0);
+  FixtureNumber("digital_in_3", 88);
+  FixtureNumber("digital_out_4", 1);
+  Gps("gps_5", 423456 / 10000.0, -87654 / 10000.0, 1234567 / 100.0);
+  Axes("accelerometer_6", 1 / 1000.0, -2 / 1000.0, 1000 / 1000.0);
+  Axes("gyrometer_7", -100 / 100.0, 200 / 100.0, 32767 / 100.0);
+  FixtureNumber("luminosity_8", 32767);
+  FixtureNumber("analog_in_9", -1234 / 100.0);
+  FixtureNumber("analog_out_10", 4321 / 100.0);
+  FixtureNumber("presence_11", 1);
+}
+
+/* Unsigned values above the int16 range the agent reads are clamped */
+static void Clamping(void)
+{
+  lpp_init(&Lpp, Buff, sizeof(Buff));
+  lpp_add_barometric_pressure(&Lpp, 0, 65535);
+  lpp_add_luminosity(&Lpp, 1, 40000);
+
+  Case("unsigned values clamped to the int16 range");
+  FixtureNumber("barometric_pressure_0", 32767 / 10.0);
+  FixtureNumber("luminosity_1", 32767);
+}
+
+/* Statistics of the frame of main.c, lowest priority */
+static void SendStatistics(void)
+{
+  FixtureNumber("barometric_pressure_5", 10101 / 10.0);
+  FixtureNumber("barometric_pressure_6", 10155 / 10.0);
+  FixtureNumber("barometric_pressure_7", 12 / 10.0);
+  FixtureNumber("temperature_8", 198 / 10.0);
+  FixtureNumber("temperature_9", 231 / 10.0);
+  FixtureNumber("temperature_10", -7 / 10.0);
+  FixtureNumber("relative_humidity_11", 85 / 2.0);
+  FixtureNumber("relative_humidity_12", 99 / 2.0);
+  FixtureNumber("relative_humidity_13", 3 / 2.0);
+}
+
+/* Send() of main.c: means, then the status, then the statistics */
+static void SendLayout(uint8_t maxSize, const char *first, const char *deferred)
+{
+  uint8_t channel = 0;
+
+  lpp_init(&Lpp, Buff, sizeof(Buff));
+  lpp_add_barometric_pressure(&Lpp, channel++, 10132);
+  lpp_add_temperature(&Lpp, channel++, 215);
+  lpp_add_relative_humidity(&Lpp, channel++, 91);
+
+  lpp_set_priority(&Lpp, LPP_PRIORITY_HIGHEST + 1);
+  lpp_add_digital_input(&Lpp, channel++, 98);
+  lpp_add_digital_output(&Lpp, channel++, 0);
+
+  lpp_set_priority(&Lpp, LPP_PRIORITY_HIGHEST + 2);
+  lpp_add_barometric_pressure(&Lpp, channel++, 10101);
+  lpp_add_barometric_pressure(&Lpp, channel++, 10155);
+  lpp_add_barometric_pressure(&Lpp, channel++, 12);
+  lpp_add_temperature(&Lpp, channel++, 198);
+  lpp_add_temperature(&Lpp, channel++, 231);
+  lpp_add_temperature(&Lpp, channel++, -7);
+  lpp_add_relative_humidity(&Lpp, channel++, 85);
+  lpp_add_relative_humidity(&Lpp, channel++, 99);
+  lpp_add_relative_humidity(&Lpp, channel++, 3);
+
+  lpp_fit(&Lpp, maxSize);
+
+  Case(first);
+  FixtureNumber("barometric_pressure_0", 10132 / 10.0);
+  FixtureNumber("temperature_1", 215 / 10.0);
+  FixtureNumber("relative_humidity_2", 91 / 2.0);
+  FixtureNumber("digital_in_3", 98);
+  FixtureNumber("digital_out_4", 0);
+  if (deferred == NULL)
+  {
+    FixtureNumber("barometric_pressure_5", 10101 / 10.0);
+    FixtureNumber("barometric_pressure_6", 10155 / 10.0);
+    FixtureNumber("barometric_pressure_7", 12 / 10.0);
+    FixtureNumber("temperature_8", 198 / 10.0);
+    FixtureNumber("temperature_9", 231 / 10.0);
+    FixtureNumber("temperature_10", -7 / 10.0);
+    FixtureNumber("relative_humidity_11", 85 / 2.0);
+    FixtureNumber("relative_humidity_12", 99 / 2.0);
+    FixtureNumber("relative_humidity_13", 3 / 2.0);
+    return;
+  }
+
+  /* the 17 bytes of means and status, the statistics go in the next frame */
+  lpp_next(&Lpp);
+  lpp_fit(&Lpp, sizeof(Buff));
+
+  Case(deferred);
+  SendStatistics();
+}
+
+/* Public functions ----------------------------------------------------------*/
+int main(void)
+{
+  FixtureBegin("examples/devices/stm32/Tests/fixtures/fixture_cayenne_lpp.c");
+  EveryType();
+  Clamping();
+  SendLayout(lpp_get_max_size(), "frame of main.c at the largest payload", NULL);
+  SendLayout(17, "frame of main.c fitted in 17 bytes",
+             "statistics deferred to the next frame of main.c");
+  FixtureEnd();
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,162 @@
+/**
+  ******************************************************************************
+  * @file    fixture_cbor_writer.c
+  * @author  MCD Application Team
+  * @brief   CBOR payloads encoded by cbor_writer.c, with the values
+  *          lib/dataModels/cbor.js must decode from them
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fixture.h"
+#include "cbor_writer.h"
+
+/* Private define ------------------------------------------------------------*/
+/* levels of CborEncode() in main.c */
+#define CBOR_MEANS            0
+#define CBOR_STATUS           1
+#define CBOR_SUMMARIES        2
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Buff[242];
+static cbor_Writer_t Cbor;
+
+/* Private functions ---------------------------------------------------------*/
+/* Value decoded from a single precision float, or from the half precision one
+   it is exactly converted to */
+static void Single(const char *key, float value)
+{
+  FixtureNumber(key, value);
+}
+
+/* Value decoded from a half precision float, rounded to nearest even by the
+   compiler to check the conversion of the writer */
+static void Half(const char *key, float value)
+{
+  FixtureNumber(key, (_Float16)value);
+}
+
+/* CborEncode() of main.c on a window of pressure 1013.2 hPa, temperature
+   21.30 degC and humidity 48.5 % */
+static void MainFrame(uint8_t level, const char *description)
+{
+  cbor_init(&Cbor, Buff, sizeof(Buff));
+  cbor_put_map(&Cbor, (level >= CBOR_SUMMARIES) ? 8 : (level >= CBOR_STATUS) ? 5 : 3);
+  cbor_put_string(&Cbor, "bp0");
+  cbor_put_float(&Cbor, 10132 / 10.0f);
+  cbor_put_string(&Cbor, "t1");
+  cbor_put_float16(&Cbor, 2130 / 100.0f);
+  cbor_put_string(&Cbor, "rh2");
+  cbor_put_float16(&Cbor, 485 / 10.0f);
+  if (level >= CBOR_STATUS)
+  {
+    cbor_put_string(&Cbor, "di3");
+    cbor_put_uint(&Cbor, 88);
+    cbor_put_string(&Cbor, "do4");
+    cbor_put_uint(&Cbor, 1);
+  }
+  if (level >= CBOR_SUMMARIES)
+  {
+    cbor_put_string(&Cbor, "bp0s");
+    cbor_put_array(&Cbor, 3);
+    cbor_put_float(&Cbor, 10101 / 10.0f);
+    cbor_put_float(&Cbor, 10155 / 10.0f);
+    cbor_put_float16(&Cbor, 12 / 10.0f);
+    cbor_put_string(&Cbor, "t1s");
+    cbor_put_array(&Cbor, 3);
+    cbor_put_float16(&Cbor, 1980 / 100.0f);
+    cbor_put_float16(&Cbor, -705 / 100.0f);
+    cbor_put_float16(&Cbor, 37 / 100.0f);
+    cbor_put_string(&Cbor, "rh2s");
+    cbor_put_array(&Cbor, 3);
+    cbor_put_float16(&Cbor, 425 / 10.0f);
+    cbor_put_float16(&Cbor, 995 / 10.0f);
+    cbor_put_float16(&Cbor, 15 / 10.0f);
+  }
+
+  FixtureCase(description, Buff, cbor_get_size(&Cbor));
+  Single("bp0", 10132 / 10.0f);
+  Half("t1", 2130 / 100.0f);
+  Half("rh2", 485 / 10.0f);
+  if (level >= CBOR_STATUS)
+  {
+    FixtureNumber("di3", 88);
+    FixtureNumber("do4", 1);
+  }
+  if (level >= CBOR_SUMMARIES)
+  {
+    FixtureArrayBegin("bp0s");
+    Single(NULL, 10101 / 10.0f);
+    Single(NULL, 10155 / 10.0f);
+    Half(NULL, 12 / 10.0f);
+    FixtureArrayEnd();
+    FixtureArrayBegin("t1s");
+    Half(NULL, 1980 / 100.0f);
+    Half(NULL, -705 / 100.0f);
+    Half(NULL, 37 / 100.0f);
+    FixtureArrayEnd();
+    FixtureArrayBegin("rh2s");
+    Half(NULL, 425 / 10.0f);
+    Half(NULL, 995 / 10.0f);
+    Half(NULL, 15 / 10.0f);
+    FixtureArrayEnd();
+  }
+}
+
+/* Integer keys, the argument widths of the major types and the simple values */
+static void Integers(void)
+{
+  cbor_init(&Cbor, Buff, sizeof(Buff));
+  cbor_put_map(&Cbor, 8);
+  cbor_put_uint(&Cbor, 1);
+  cbor_put_int(&Cbor, -300);
+  cbor_put_uint(&Cbor, 2);
+  cbor_put_float(&Cbor, -0.5f);
+  cbor_put_uint(&Cbor, 3);
+  cbor_put_uint(&Cbor, 100000);
+  cbor_put_uint(&Cbor, 4);
+  cbor_put_bool(&Cbor, false);
+  cbor_put_uint(&Cbor, 5);
+  cbor_put_int(&Cbor, -24);
+  cbor_put_uint(&Cbor, 23);
+  cbor_put_uint(&Cbor, 255);
+  cbor_put_uint(&Cbor, 24);
+  cbor_put_int(&Cbor, -2147483647 - 1);
+  cbor_put_uint(&Cbor, 256);
+  cbor_put_uint(&Cbor, 4294967295u);
+
+  FixtureCase("integer keys, negative and 32 bit integers", Buff, cbor_get_size(&Cbor));
+  FixtureNumber("1", -300);
+  Single("2", -0.5f);
+  FixtureNumber("3", 100000);
+  FixtureBool("4", false);
+  FixtureNumber("5", -24);
+  FixtureNumber("23", 255);
+  FixtureNumber("24", -2147483648.0);
+  FixtureNumber("256", 4294967295.0);
+}
+
+/* Public functions ----------------------------------------------------------*/
+int main(void)
+{
+  FixtureBegin("examples/devices/stm32/Tests/fixtures/fixture_cbor_writer.c");
+  MainFrame(CBOR_MEANS, "frame of main.c with the means");
+  MainFrame(CBOR_STATUS, "frame of main.c with the means and the status");
+  MainFrame(CBOR_SUMMARIES, "frame of main.c with the means, the status and the summaries");
+  Integers();
+  FixtureEnd();
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file    fixture_time_series.c
+  * @author  MCD Application Team
+  * @brief   Time series payloads encoded by time_series.c, with the series
+  *          lib/dataModels/timeSeries.js must decode from them
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fixture.h"
+#include "time_series.h"
+
+/* Private define ------------------------------------------------------------*/
+/* 1 Hz pressure, temperature and humidity samples of the agent tests */
+#define TRACE_FILE            "../../../../test/timeSeries/sensorTrace.json"
+#define TRACE_MAX_SAMPLES     512
+#define TRACE_NB_CHANNELS     3
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Buff[242];
+static ts_Writer_t Ts;
+
+static int16_t Trace[TRACE_MAX_SAMPLES][TRACE_NB_CHANNELS];
+static int TraceNbSamples;
+static uint32_t TracePeriod;
+
+/* Private functions ---------------------------------------------------------*/
+/* Reads the period and the [pressure, temperature, humidity] rows, oldest first */
+static void ReadTrace(void)
+{
+  FILE *f = fopen(TRACE_FILE, "r");
+  char line[256];
+  int v[TRACE_NB_CHANNELS];
+
+  if (f == NULL)
+  {
+    perror(TRACE_FILE);
+    exit(1);
+  }
+  while (fgets(line, sizeof(line), f) != NULL)
+  {
+    char *p = line + strspn(line, " \t");
+
+    if (sscanf(p, "\"period\": %u", &TracePeriod) == 1)
+    {
+      continue;
+    }
+    if ((sscanf(p, "[%d, %d, %d]", &v[0], &v[1], &v[2]) == TRACE_NB_CHANNELS) &&
+        (TraceNbSamples < TRACE_MAX_SAMPLES))
+    {
+      for (int c = 0; c < TRACE_NB_CHANNELS; c++)
+      {
+        Trace[TraceNbSamples][c] = (int16_t)v[c];
+      }
+      TraceNbSamples++;
+    }
+  }
+  fclose(f);
+  if ((TraceNbSamples == 0) || (TracePeriod == 0))
+  {
+    fprintf(stderr, "%s: no samples\n", TRACE_FILE);
+    exit(1);
+  }
+}
+
+/* Encodes the samples newest first as Send() of main.c, until the payload is
+   full, and writes the series decoded from the samples that fit */
+static void Series(const char *description, int16_t (*samples)[TRACE_NB_CHANNELS], int nbSamples,
+                   uint8_t nbChannels, uint32_t age, uint32_t period, uint8_t capacity)
+{
+  int nbEncoded = 0;
+
+  ts_init(&Ts, Buff, capacity, nbChannels, age, period);
+  while ((nbEncoded < nbSamples) && ts_add_sample(&Ts, samples[nbSamples - 1 - nbEncoded]))
+  {
+    nbEncoded++;
+  }
+
+  FixtureCase(description, Buff, ts_get_size(&Ts));
+  FixtureNumber("age", age);
+  FixtureNumber("period", period);
+  FixtureArrayBegin("channels");
+  for (uint8_t c = 0; c < nbChannels; c++)
+  {
+    FixtureArrayBegin(NULL);
+    for (int i = nbSamples - nbEncoded; i < nbSamples; i++)
+    {
+      FixtureNumber(NULL, samples[i][c]);
+    }
+    FixtureArrayEnd();
+  }
+  FixtureArrayEnd();
+}
+
+/* Public functions ----------------------------------------------------------*/
+int main(void)
+{
+  static int16_t window[][TRACE_NB_CHANNELS] =
+  {
+    { 10130, 2168, 479 }, { 10133, 2171, 480 }, { 10131, 2160, 486 },
+    { 10131, 2149, 487 }, { 10132, 2153, 485 },
+  };
+  static int16_t extremes[][TRACE_NB_CHANNELS] =
+  {
+    { 0 }, { 32767 }, { -32768 },
+  };
+  char description[64];
+
+  ReadTrace();
+
+  FixtureBegin("examples/devices/stm32/Tests/fixtures/fixture_time_series.c");
+  Series("three channels, oldest first", window, 5, TRACE_NB_CHANNELS, 250, 1000, sizeof(Buff));
+  Series("truncated to the payload size allowed", window, 5, TRACE_NB_CHANNELS, 250, 1000, 14);
+  Series("extreme 16 bit values", extremes, 3, 1, 0, 60000, sizeof(Buff));
+  /* sizes allowed at DR0, DR3 and DR5 of EU868 */
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    static const uint8_t maxSize[] = { 51, 115, 242 };
+
+    snprintf(description, sizeof(description), "sensor trace in %u byte frames", maxSize[i]);
+    Series(description, Trace, TraceNbSamples, TRACE_NB_CHANNELS, 0, TracePeriod, maxSize[i]);
+  }
+  FixtureEnd();
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
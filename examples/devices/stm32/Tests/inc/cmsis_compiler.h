@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+  * @file    cmsis_compiler.h
+  * @author  MCD Application Team
+  * @brief   Host build: the interrupt mask functions the sensor bus uses, from
+  *          the host core of hw_conf.h
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw_conf.h"
+
+#endif /* __CMSIS_COMPILER_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    debug.h
+  * @author  MCD Application Team
+  * @brief   Host build debug interface, the debug GPIOs do not exist
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DEBUG_H__
+#define __DEBUG_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <stdio.h>
+#include "hw_conf.h"
+
+/* Exported macros -----------------------------------------------------------*/
+#define DBG_GPIO_WRITE( gpio, n, x )
+#define DBG_GPIO_SET( gpio, n )
+#define DBG_GPIO_RST( gpio, n )
+#define DBG( x ) do{  } while(0)
+
+/* Exported functions ------------------------------------------------------- */
+void DBG_Init( void );
+
+/**
+ * @brief  Aborts the test run
+ * @param  None
+ * @retval None
+ */
+void Error_Handler( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DEBUG_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    host_radio.h
+  * @author  MCD Application Team
+  * @brief   Host build virtual radio: the frames sent and the frames to
+  *          receive in the next windows, on the virtual RTC
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_RADIO_H__
+#define __HOST_RADIO_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "radio.h"
+
+/* Exported types ------------------------------------------------------------*/
+/*!
+ * Frame on the air, sent or to receive
+ */
+typedef struct
+{
+  RadioModems_t Modem;
+  uint32_t Frequency;   /* Hz */
+  uint32_t Datarate;    /* spreading factor in LoRa, bits/s in FSK */
+  uint32_t Bandwidth;   /* 0: 125 kHz, 1: 250 kHz, 2: 500 kHz in LoRa */
+  int8_t Power;         /* dBm, frames sent only */
+  uint32_t Time;        /* RTC ticks at the start of the frame */
+  uint32_t TimeOnAir;   /* ms */
+  uint8_t Size;
+  uint8_t Payload[255];
+} HostRadioFrame_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*!
+ * @brief Sets the handler of the frames sent, called at the end of each
+ *        transmission. The last frame sent is kept either way.
+ * @param [IN] handler frame handler, NULL for none
+ * @retval none
+ */
+void HostRadioSetTxHandler( void ( *handler )( const HostRadioFrame_t *frame ) );
+
+/*!
+ * @brief Sets the handler of the frames sent, called at the start of each
+ *        transmission, for a medium shared with other devices
+ * @param [IN] handler frame handler, NULL for none
+ * @retval none
+ */
+void HostRadioSetTxStartHandler( void ( *handler )( const HostRadioFrame_t *frame ) );
+
+/*!
+ * @brief Returns the last frame sent and clears it
+ * @param [OUT] frame last frame sent
+ * @retval true when a frame was sent since the last call
+ */
+bool HostRadioGetTx( HostRadioFrame_t *frame );
+
+/*!
+ * @brief Queues a frame for the reception window open on its frequency, or
+ *        for the next one opened, at any datarate
+ * @param [IN] frequency frequency in Hz, 0 for any window
+ * @param [IN] payload frame
+ * @param [IN] size frame size
+ * @param [IN] rssi RSSI reported, in dBm
+ * @param [IN] snr SNR reported, in dB
+ * @retval false when the queue is full
+ */
+bool HostRadioQueueRx( uint32_t frequency, const uint8_t *payload, uint8_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * @brief Returns the parameters of the last reception window opened
+ * @param [OUT] frame modem, frequency, datarate, bandwidth and opening time,
+ *                    the payload is not set
+ * @retval true when a window was opened since the last reset
+ */
+bool HostRadioGetRxWindow( HostRadioFrame_t *frame );
+
+/*!
+ * @brief Drops the queued frames, stops any activity and seeds Radio.Random
+ * @param [IN] seed seed of the pseudo random numbers
+ * @retval none
+ */
+void HostRadioReset( uint32_t seed );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_RADIO_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
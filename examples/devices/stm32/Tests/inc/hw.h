@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    hw.h
+  * @author  MCD Application Team
+  * @brief   Host build hardware interface: the middlewares are built against
+  *          the virtual RTC and the captured console of Tests/src
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HW_H__
+#define __HW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_conf.h"
+#include "hw_rtc.h"
+#include "util_console.h"
+#include "debug.h"
+
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Returns a seed for the pseudo random generator
+ * @param  None
+ * @retval Seed, fixed on host so that the runs are reproducible
+ */
+uint32_t HW_GetRandomSeed( void );
+
+/**
+ * @brief  Returns the unique Id of the board
+ * @param  id: pointer on 8 bytes
+ * @retval None
+ */
+void HW_GetUniqueId( uint8_t *id );
+
+/**
+ * @brief  Returns the battery level, 254 means fully charged
+ * @param  None
+ * @retval Battery level
+ */
+uint8_t HW_GetBatteryLevel( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HW_H__ */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
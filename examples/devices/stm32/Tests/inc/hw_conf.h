@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file    hw_conf.h
+  * @author  MCD Application Team
+  * @brief   Host build configuration: stands in for the Cube HAL and CMSIS
+  *          core definitions the middlewares use
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HW_CONF_H__
+#define __HW_CONF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  RESET = 0,
+  SET = !RESET
+} FlagStatus, ITStatus;
+
+/* Exported constants --------------------------------------------------------*/
+#define __IO    volatile
+#define __weak  __attribute__((weak))
+
+/* External variables --------------------------------------------------------*/
+/* Interrupt mask of the host "core", 1 while interrupts are disabled */
+extern uint32_t HostPrimask;
+
+/* Core clock reported by the latency statistics */
+extern uint32_t SystemCoreClock;
+
+/* Exported macros -----------------------------------------------------------*/
+/* Cycle counter of the latency statistics, there is no DWT nor SysTick */
+#define LATENCY_GET_CYCLES()  HostGetCycles()
+
+#define __DMB()   __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#define __REV( x ) __builtin_bswap32( x )
+#define __NOP()   do{ }while(0)
+
+static inline uint32_t __get_PRIMASK(void)
+{
+  return HostPrimask;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+  HostPrimask = priMask;
+}
+
+static inline void __disable_irq(void)
+{
+  HostPrimask = 1;
+}
+
+static inline void __enable_irq(void)
+{
+  HostPrimask = 0;
+}
+
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Milliseconds elapsed on the virtual RTC
+ * @param  None
+ * @retval Tick in ms
+ */
+uint32_t HAL_GetTick(void);
+
+/**
+ * @brief  Advances the virtual RTC, running the timers falling due
+ * @param  Delay: delay in ms
+ * @retval None
+ */
+void HAL_Delay(uint32_t Delay);
+
+/**
+ * @brief  Core clock cycles of the host, its monotonic clock at SystemCoreClock
+ * @note   Measures the execution time of the host, the virtual RTC does not
+ *         move while code runs
+ * @param  None
+ * @retval Cycles, wrapping like CYCCNT
+ */
+uint32_t HostGetCycles(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HW_CONF_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
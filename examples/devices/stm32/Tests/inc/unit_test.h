@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    unit_test.h
+  * @author  MCD Application Team
+  * @brief   Minimal assertions for the host unit tests. A test program runs
+  *          its cases with UT_RUN and returns UT_RESULT() from main
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __UNIT_TEST_H__
+#define __UNIT_TEST_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* External variables --------------------------------------------------------*/
+/* Failed assertions of the current case and failed cases of the program */
+extern int UtCaseFailures;
+extern int UtFailures;
+extern int UtCases;
+
+/* Exported macros -----------------------------------------------------------*/
+#define UT_ASSERT( cond )                                                          \
+  do{                                                                              \
+    if( !( cond ) )                                                                \
+    {                                                                              \
+      printf( "  %s:%d: assertion failed: %s\n", __FILE__, __LINE__, #cond );      \
+      UtCaseFailures++;                                                            \
+    }                                                                              \
+  }while(0)
+
+#define UT_ASSERT_EQ( actual, expected )                                           \
+  do{                                                                              \
+    long long ut_a = ( long long )( actual );                                      \
+    long long ut_e = ( long long )( expected );                                    \
+    if( ut_a != ut_e )                                                             \
+    {                                                                              \
+      printf( "  %s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__,          \
+              #actual, ut_a, ut_e );                                               \
+      UtCaseFailures++;                                                            \
+    }                                                                              \
+  }while(0)
+
+#define UT_ASSERT_MEM( actual, expected, size )                                    \
+  do{                                                                              \
+    if( memcmp( ( actual ), ( expected ), ( size ) ) != 0 )                        \
+    {                                                                              \
+      printf( "  %s:%d: %s differs from %s\n", __FILE__, __LINE__,                 \
+              #actual, #expected );                                                \
+      UtCaseFailures++;                                                            \
+    }                                                                              \
+  }while(0)
+
+#define UT_RUN( test )                                                             \
+  do{                                                                              \
+    UtCaseFailures = 0;                                                            \
+    UtCases++;                                                                     \
+    test( );                                                                       \
+    printf( "%s %s\n", ( UtCaseFailures == 0 ) ? "ok  " : "FAIL", #test );         \
+    if( UtCaseFailures != 0 )                                                      \
+    {                                                                              \
+      UtFailures++;                                                                \
+    }                                                                              \
+  }while(0)
+
+#define UT_RESULT( )                                                               \
+  ( printf( "%d/%d passed\n", UtCases - UtFailures, UtCases ), ( UtFailures != 0 ) )
+
+/* Defines the counters, once per test program */
+#define UT_DEFINE( )                                                               \
+  int UtCaseFailures;                                                              \
+  int UtFailures;                                                                  \
+  int UtCases
+
+#endif /* __UNIT_TEST_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    vcom.h
+  * @author  MCD Application Team
+  * @brief   Host build virtual com port: the traces are captured in memory
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __VCOM_H__
+#define __VCOM_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Size of the capture buffer */
+#define VCOM_CAPTURE_SIZE   65536
+
+/* Exported functions ------------------------------------------------------- */
+/**
+ * @brief  Init the capture
+ * @param  Txcb: callback run at the end of each transfer
+ * @retval None
+ */
+void vcom_Init(  void (*Txcb)(void) );
+
+/**
+ * @brief  Starts a transfer. Completes at once in automatic mode, otherwise
+ *         on the next vcom_Complete
+ * @param  p_data: data to send
+ * @param  size: number of bytes
+ * @retval None
+ */
+void vcom_Trace(  uint8_t *p_data, uint16_t size );
+
+/**
+ * @brief  Selects whether transfers complete at once (default) or are held
+ *         until vcom_Complete, as a DMA still running would
+ * @param  automatic: 1 for immediate completion
+ * @retval None
+ */
+void vcom_SetAutoComplete( int automatic );
+
+/**
+ * @brief  Completes the transfer in flight, if any
+ * @param  None
+ * @retval 1 when a transfer was completed, 0 otherwise
+ */
+int vcom_Complete( void );
+
+/**
+ * @brief  Returns the captured bytes and clears the capture
+ * @param  buff: destination, VCOM_CAPTURE_SIZE bytes at most are written
+ * @retval Number of bytes
+ */
+uint32_t vcom_Capture( uint8_t *buff );
+
+/**
+ * @brief  Number of transfers started since vcom_Init
+ * @param  None
+ * @retval Number of transfers
+ */
+uint32_t vcom_Transfers( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VCOM_H__*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,463 @@
+/**
+  ******************************************************************************
+  * @file    sim_node.c
+  * @author  MCD Application Team
+  * @brief   End device of the network simulator (examples/network-simulator):
+  *          the LoRaMAC of the firmware, EU868, over the virtual RTC and
+  *          radio of src/, driven in lockstep by the virtual clock of the
+  *          simulator through stdin and stdout.
+  *
+  *          The device joins over the air, then sends the Cayenne LPP uplink
+  *          of the simulated devices every period: channel 0 carries an
+  *          uplink counter as a luminosity, then a temperature and a relative
+  *          humidity. Port 2, confirmed or not, at a fixed datarate.
+  *
+  *          Commands, one per line, times in ms of the virtual clock:
+  *            run <time>                       runs the device up to time
+  *            rx <time> <freq> <rssi> <snr> <hex>
+  *                                             runs the device up to time, then
+  *                                             a frame starts on the air, 0 Hz
+  *                                             for any frequency
+  *          Each command is answered with the events, then the time of the
+  *          next alarm of the device, -1 for none:
+  *            tx <start> <freq> <sf> <time on air> <hex>
+  *            join <0|1>                       join-accept received or not
+  *            confirm <confirmed> <ack> <transmissions> <airtime>
+  *            downlink <port> <size>
+  *            deferred                         uplink refused, MAC busy
+  *            next <time|-1>
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "hw.h"
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "host_radio.h"
+#include "cayenne_lpp.h"
+#include "retrans_policy.h"
+#include "trace.h"
+#include "energy_meter.h"
+#include "utilities.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Application port of the uplinks */
+#define APP_PORT              2
+
+/* Period of the join attempts, as in End_Node, in ms */
+#define JOIN_RETRY_PERIOD     10000
+
+/* Trials of the confirmed uplinks, as in LORA_send */
+#define CONFIRMED_NB_TRIALS   8
+
+/* Longest command line: rx, its fields and 255 bytes in hex */
+#define LINE_SIZE             600
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t DevEui[8];
+static uint8_t JoinEui[8];
+static uint8_t AppKey[16];
+static int8_t Datarate = DR_5;
+static uint32_t Period = 300000;
+static uint32_t StartDelay;
+static bool Confirmed;
+
+/* adaptive policy of End_Node */
+static const RetransAdaptiveConfig_t RetransConfig = { 1, 8, 2000, 32000, 60000 };
+
+static bool ProcessPending;
+static bool Joined;
+static TimerEvent_t TxTimer;
+
+static uint16_t Counter;
+static int16_t Temperature;
+static uint8_t AppBuff[32];
+static lpp_Buffer_t Lpp;
+
+/* Private functions ---------------------------------------------------------*/
+static void PrintHex( const uint8_t *buff, uint8_t size )
+{
+  for( uint8_t i = 0; i < size; i++ )
+  {
+    printf( "%02x", buff[i] );
+  }
+}
+
+static bool ParseHex( const char *hex, uint8_t *buff, uint8_t capacity, uint8_t *size )
+{
+  unsigned int byte;
+  uint8_t n = 0;
+
+  while( ( hex[0] != '\0' ) && ( hex[0] != '\n' ) )
+  {
+    if( ( n == capacity ) || ( sscanf( hex, "%2x", &byte ) != 1 ) )
+    {
+      return false;
+    }
+    buff[n++] = ( uint8_t )byte;
+    hex += 2;
+  }
+  *size = n;
+  return true;
+}
+
+static void OnTxStart( const HostRadioFrame_t *frame )
+{
+  printf( "tx %u %u %u %u ", ( unsigned )frame->Time, ( unsigned )frame->Frequency,
+          ( unsigned )frame->Datarate, ( unsigned )frame->TimeOnAir );
+  PrintHex( frame->Payload, frame->Size );
+  printf( "\n" );
+}
+
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+  printf( "confirm %d %d %u %u\n", ( mcpsConfirm->McpsRequest == MCPS_CONFIRMED ) ? 1 : 0,
+          ( mcpsConfirm->AckReceived == true ) ? 1 : 0, mcpsConfirm->NbRetries,
+          ( unsigned )mcpsConfirm->TotalTimeOnAir );
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  if( mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK )
+  {
+    printf( "downlink %u %u\n", mcpsIndication->Port, ( mcpsIndication->RxData == true ) ? mcpsIndication->BufferSize : 0 );
+  }
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+  if( mlmeConfirm->MlmeRequest != MLME_JOIN )
+  {
+    return;
+  }
+  Joined = ( mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK );
+  printf( "join %d\n", ( Joined == true ) ? 1 : 0 );
+
+  /* the first uplink somewhere in the first period */
+  if( Joined == true )
+  {
+    TimerStop( &TxTimer );
+    TimerSetValue( &TxTimer, randr( 1, Period ) );
+    TimerStart( &TxTimer );
+  }
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void NvmContextChange( LoRaMacNvmCtxModule_t module )
+{
+}
+
+static void MacProcessNotify( void )
+{
+  ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+static LoRaMacCallback_t Callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmContextChange, MacProcessNotify };
+
+static void Join( void )
+{
+  MlmeReq_t mlmeReq;
+
+  mlmeReq.Type = MLME_JOIN;
+  mlmeReq.Req.Join.DevEui = DevEui;
+  mlmeReq.Req.Join.JoinEui = JoinEui;
+  mlmeReq.Req.Join.Datarate = Datarate;
+  LoRaMacMlmeRequest( &mlmeReq );
+}
+
+/* Uplink of the simulated devices, sent as LORA_send does */
+static void Send( void )
+{
+  McpsReq_t mcpsReq;
+
+  Temperature += randr( -2, 2 );
+  lpp_reset( &Lpp );
+  lpp_add_luminosity( &Lpp, 0, Counter );
+  lpp_add_temperature( &Lpp, 1, Temperature );
+  lpp_add_relative_humidity( &Lpp, 2, randr( 80, 119 ) );
+
+  if( Confirmed == true )
+  {
+    mcpsReq.Type = MCPS_CONFIRMED;
+    mcpsReq.Req.Confirmed.fPort = APP_PORT;
+    mcpsReq.Req.Confirmed.fBuffer = Lpp.Buff;
+    mcpsReq.Req.Confirmed.fBufferSize = Lpp.Length;
+    mcpsReq.Req.Confirmed.NbTrials = CONFIRMED_NB_TRIALS;
+    mcpsReq.Req.Confirmed.Datarate = Datarate;
+  }
+  else
+  {
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = APP_PORT;
+    mcpsReq.Req.Unconfirmed.fBuffer = Lpp.Buff;
+    mcpsReq.Req.Unconfirmed.fBufferSize = Lpp.Length;
+    mcpsReq.Req.Unconfirmed.Datarate = Datarate;
+  }
+
+  if( LoRaMacMcpsRequest( &mcpsReq ) == LORAMAC_STATUS_OK )
+  {
+    Counter++;
+    return;
+  }
+  /* the retransmissions of the previous uplink still run */
+  RetransFresherData( );
+  printf( "deferred\n" );
+}
+
+/* Joins until accepted, then sends an uplink every period, jittered by 10 % */
+static void OnTxTimerEvent( void *context )
+{
+  if( Joined == false )
+  {
+    Join( );
+    TimerSetValue( &TxTimer, JOIN_RETRY_PERIOD );
+  }
+  else
+  {
+    Send( );
+    TimerSetValue( &TxTimer, Period - Period / 10 + randr( 0, Period / 5 ) );
+  }
+  TimerStart( &TxTimer );
+}
+
+static void Process( void )
+{
+  while( ProcessPending == true )
+  {
+    ProcessPending = false;
+    LoRaMacProcess( );
+  }
+}
+
+/* Runs the device up to time, the MAC processed after each alarm */
+static void RunUntil( uint32_t time )
+{
+  uint32_t alarm;
+  uint32_t now;
+
+  for( ; ; )
+  {
+    Process( );
+    now = HW_RTC_GetTimerValue( );
+    if( ( HostRtcGetAlarm( &alarm ) == true ) && ( ( int32_t )( alarm - time ) <= 0 ) )
+    {
+      HostRtcRun( ( ( int32_t )( alarm - now ) > 0 ) ? ( alarm - now ) : 0 );
+      continue;
+    }
+    if( ( int32_t )( time - now ) > 0 )
+    {
+      HostRtcRun( time - now );
+    }
+    Process( );
+    return;
+  }
+}
+
+static void Next( void )
+{
+  uint32_t alarm;
+
+  if( HostRtcGetAlarm( &alarm ) == true )
+  {
+    printf( "next %u\n", ( unsigned )alarm );
+  }
+  else
+  {
+    printf( "next -1\n" );
+  }
+  fflush( stdout );
+}
+
+static void Command( char *line )
+{
+  uint8_t payload[255];
+  uint8_t size;
+  unsigned int time;
+  unsigned int freq;
+  int rssi;
+  int snr;
+  int hex;
+
+  if( sscanf( line, "run %u", &time ) == 1 )
+  {
+    RunUntil( time );
+  }
+  else if( ( sscanf( line, "rx %u %u %d %d %n", &time, &freq, &rssi, &snr, &hex ) == 4 ) &&
+           ( ParseHex( &line[hex], payload, sizeof( payload ), &size ) == true ) )
+  {
+    RunUntil( time );
+    if( HostRadioQueueRx( freq, payload, size, ( int16_t )rssi, ( int8_t )snr ) == false )
+    {
+      fprintf( stderr, "sim_node: rx queue full\n" );
+    }
+    Process( );
+  }
+  else
+  {
+    fprintf( stderr, "sim_node: bad command %s", line );
+  }
+  Next( );
+}
+
+static bool ParseKey( const char *hex, uint8_t *key, uint8_t size )
+{
+  uint8_t n;
+
+  return ( strlen( hex ) == 2 * size ) && ( ParseHex( hex, key, size, &n ) == true );
+}
+
+static void Usage( void )
+{
+  fprintf( stderr, "usage: sim_node -e <DevEUI> -j <JoinEUI> -k <AppKey> [-d <datarate>] [-p <period ms>]\n"
+                   "                [-s <start ms>] [-r <seed>] [-c] [-a]\n"
+                   "  -c  confirmed uplinks\n"
+                   "  -a  adaptive retransmission policy of End_Node\n" );
+  exit( 2 );
+}
+
+static void Setup( uint32_t seed, bool adaptive )
+{
+  MibRequestConfirm_t mibReq;
+
+  HostRadioReset( seed );
+  HostRadioSetTxStartHandler( OnTxStart );
+  srand1( seed );
+  Temperature = 200 + randr( 0, 49 );
+  lpp_init( &Lpp, AppBuff, sizeof( AppBuff ) );
+
+  /* the MAC traces its radio events and accounts their energy */
+  TraceInit( );
+  EnergyInit( );
+
+  /* as LORA_Init, without ADR: the network server stand-in sends no MAC commands */
+  LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 );
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_PUBLIC_NETWORK;
+  mibReq.Param.EnablePublicNetwork = true;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_APP_KEY;
+  mibReq.Param.AppKey = AppKey;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_NWK_KEY;
+  mibReq.Param.NwkKey = AppKey;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_DEVICE_CLASS;
+  mibReq.Param.Class = CLASS_A;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  LoRaMacTestSetDutyCycleOn( true );
+  mibReq.Type = MIB_SYSTEM_MAX_RX_ERROR;
+  mibReq.Param.SystemMaxRxError = 20;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+
+  if( adaptive == true )
+  {
+    RetransAdaptiveInit( &RetransConfig );
+    mibReq.Type = MIB_RETRANS_POLICY;
+    mibReq.Param.RetransPolicy = &RetransAdaptivePolicy;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+  }
+  LoRaMacStart( );
+
+  TimerInit( &TxTimer, OnTxTimerEvent );
+  TimerSetValue( &TxTimer, ( StartDelay != 0 ) ? StartDelay : 1 );
+  TimerStart( &TxTimer );
+}
+
+/* lpp_get_max_size stand-in of the LoRaWAN layer, as in lora.c */
+uint8_t LORA_GetMaxPayloadSize( void )
+{
+  LoRaMacTxInfo_t txInfo;
+
+  txInfo.MaxPossibleApplicationDataSize = 0;
+  LoRaMacQueryTxPossible( 0, &txInfo );
+  return txInfo.MaxPossibleApplicationDataSize;
+}
+
+int main( int argc, char **argv )
+{
+  char line[LINE_SIZE];
+  uint32_t seed = 1;
+  bool adaptive = false;
+  uint8_t keys = 0;
+  int opt;
+
+  while( ( opt = getopt( argc, argv, "e:j:k:d:p:s:r:ca" ) ) != -1 )
+  {
+    switch( opt )
+    {
+      case 'e':
+        keys |= ( ParseKey( optarg, DevEui, sizeof( DevEui ) ) == true ) ? 1 : 0;
+        break;
+      case 'j':
+        keys |= ( ParseKey( optarg, JoinEui, sizeof( JoinEui ) ) == true ) ? 2 : 0;
+        break;
+      case 'k':
+        keys |= ( ParseKey( optarg, AppKey, sizeof( AppKey ) ) == true ) ? 4 : 0;
+        break;
+      case 'd':
+        Datarate = ( int8_t )atoi( optarg );
+        break;
+      case 'p':
+        Period = ( uint32_t )strtoul( optarg, NULL, 10 );
+        break;
+      case 's':
+        StartDelay = ( uint32_t )strtoul( optarg, NULL, 10 );
+        break;
+      case 'r':
+        seed = ( uint32_t )strtoul( optarg, NULL, 10 );
+        break;
+      case 'c':
+        Confirmed = true;
+        break;
+      case 'a':
+        adaptive = true;
+        break;
+      default:
+        Usage( );
+    }
+  }
+  if( ( keys != 7 ) || ( Datarate < DR_0 ) || ( Datarate > DR_5 ) || ( Period < 10 ) )
+  {
+    Usage( );
+  }
+
+  Setup( seed, adaptive );
+  Next( );
+  while( fgets( line, sizeof( line ), stdin ) != NULL )
+  {
+    Command( line );
+  }
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
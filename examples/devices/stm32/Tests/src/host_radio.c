@@ -0,0 +1,525 @@
+/**
+  ******************************************************************************
+  * @file    host_radio.c
+  * @author  MCD Application Team
+  * @brief   Host build virtual radio. Transmissions last their time on air on
+  *          the virtual RTC, reception windows time out after their symbol
+  *          timeout or receive the frames queued by the host
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "hw.h"
+#include "timeServer.h"
+#include "host_radio.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  RadioModems_t Modem;
+  uint32_t Bandwidth;
+  uint32_t Datarate;
+  uint8_t Coderate;
+  uint16_t PreambleLen;
+  bool FixLen;
+  bool CrcOn;
+} ModemConfig_t;
+
+typedef struct
+{
+  uint32_t Frequency;
+  int16_t Rssi;
+  int8_t Snr;
+  uint8_t Size;
+  uint8_t Payload[255];
+} RxFrame_t;
+
+/* Private define ------------------------------------------------------------*/
+#define RX_QUEUE_SIZE                 4
+
+/* Radio wake up time reported to the MAC, in ms */
+#define WAKEUP_TIME                   1
+
+/* Private variables ---------------------------------------------------------*/
+static RadioEvents_t *Events;
+static RadioState_t State = RF_IDLE;
+static uint32_t Frequency;
+static uint32_t RandomState = 1;
+
+static ModemConfig_t TxConfig;
+static int8_t TxPower;
+static ModemConfig_t RxConfig;
+static uint16_t RxSymbTimeout;
+static bool RxContinuous;
+
+static TimerEvent_t TxTimer;
+static TimerEvent_t RxTimer;
+static bool TimersInitialized = false;
+
+static HostRadioFrame_t LastTx;
+static bool LastTxValid = false;
+static void ( *TxHandler )( const HostRadioFrame_t *frame );
+static void ( *TxStartHandler )( const HostRadioFrame_t *frame );
+
+static HostRadioFrame_t RxWindow;
+static bool RxWindowValid = false;
+
+static RxFrame_t RxQueue[RX_QUEUE_SIZE];
+static uint8_t RxQueueCount;
+
+/* Frame being received in the open window */
+static RxFrame_t RxFrame;
+static bool RxFramePending = false;
+
+/* Private function prototypes -----------------------------------------------*/
+static void OnTxTimerEvent( void *context );
+static void OnRxTimerEvent( void *context );
+
+/* Private functions ---------------------------------------------------------*/
+static void InitTimers( void )
+{
+  if( TimersInitialized == false )
+  {
+    TimerInit( &TxTimer, OnTxTimerEvent );
+    TimerInit( &RxTimer, OnRxTimerEvent );
+    TimersInitialized = true;
+  }
+}
+
+/* Duration of one LoRa symbol, in us */
+static uint32_t SymbolTime( const ModemConfig_t *config )
+{
+  return ( ( 1 << config->Datarate ) * 1000000 ) / ( 125000 << config->Bandwidth );
+}
+
+/* Time on air of a frame, in ms rounded up, as computed by the transceivers */
+static uint32_t TimeOnAir( const ModemConfig_t *config, uint8_t pktLen )
+{
+  double airTime;
+
+  if( config->Modem == MODEM_FSK )
+  {
+    /* preamble, 3 sync word bytes, length byte, payload and CRC */
+    airTime = ( 8.0 * ( config->PreambleLen + 3 + ( config->FixLen ? 0 : 1 ) + pktLen +
+                        ( config->CrcOn ? 2 : 0 ) ) ) / config->Datarate;
+  }
+  else
+  {
+    uint32_t sf = config->Datarate;
+    bool lowDatarateOptimize = ( ( config->Bandwidth == 0 ) && ( sf >= 11 ) ) ||
+                               ( ( config->Bandwidth == 1 ) && ( sf == 12 ) );
+    double ts = SymbolTime( config ) / 1000000.0;
+    double tmp = ceil( ( 8.0 * pktLen - 4.0 * sf + 28 + ( config->CrcOn ? 16 : 0 ) - ( config->FixLen ? 20 : 0 ) ) /
+                       ( 4.0 * ( sf - ( lowDatarateOptimize ? 2 : 0 ) ) ) ) * ( config->Coderate + 4 );
+
+    airTime = ( config->PreambleLen + 4.25 ) * ts + ( 8 + ( ( tmp > 0 ) ? tmp : 0 ) ) * ts;
+  }
+  return ( uint32_t )ceil( airTime * 1000 );
+}
+
+static void StartRxFrame( void )
+{
+  uint8_t i;
+
+  for( i = 0; i < RxQueueCount; i++ )
+  {
+    if( ( RxQueue[i].Frequency == 0 ) || ( RxQueue[i].Frequency == Frequency ) )
+    {
+      break;
+    }
+  }
+  if( i == RxQueueCount )
+  {
+    return;
+  }
+
+  RxFrame = RxQueue[i];
+  RxFramePending = true;
+  RxQueueCount--;
+  memmove( &RxQueue[i], &RxQueue[i + 1], ( RxQueueCount - i ) * sizeof( RxQueue[0] ) );
+
+  /* the frame starts with the window, RxDone comes at its end */
+  TimerStop( &RxTimer );
+  TimerSetValue( &RxTimer, TimeOnAir( &RxConfig, RxFrame.Size ) );
+  TimerStart( &RxTimer );
+}
+
+static void OnTxTimerEvent( void *context )
+{
+  State = RF_IDLE;
+  LastTxValid = true;
+  if( TxHandler != NULL )
+  {
+    TxHandler( &LastTx );
+  }
+  if( ( Events != NULL ) && ( Events->TxDone != NULL ) )
+  {
+    Events->TxDone( );
+  }
+}
+
+static void OnRxTimerEvent( void *context )
+{
+  if( RxFramePending == true )
+  {
+    RxFramePending = false;
+    if( RxContinuous == false )
+    {
+      State = RF_IDLE;
+    }
+    if( ( Events != NULL ) && ( Events->RxDone != NULL ) )
+    {
+      Events->RxDone( RxFrame.Payload, RxFrame.Size, RxFrame.Rssi, RxFrame.Snr );
+    }
+    /* a continuous window keeps receiving the queued frames */
+    if( ( State == RF_RX_RUNNING ) && ( RxContinuous == true ) )
+    {
+      StartRxFrame( );
+    }
+    return;
+  }
+
+  State = RF_IDLE;
+  if( ( Events != NULL ) && ( Events->RxTimeout != NULL ) )
+  {
+    Events->RxTimeout( );
+  }
+}
+
+static void IoInit( void )
+{
+}
+
+static void IoDeInit( void )
+{
+}
+
+static uint32_t Init( RadioEvents_t *events )
+{
+  Events = events;
+  InitTimers( );
+  return 0;
+}
+
+static RadioState_t GetStatus( void )
+{
+  return State;
+}
+
+static void SetModem( RadioModems_t modem )
+{
+  TxConfig.Modem = modem;
+  RxConfig.Modem = modem;
+}
+
+static void SetChannel( uint32_t freq )
+{
+  Frequency = freq;
+}
+
+static bool IsChannelFree( RadioModems_t modem, uint32_t freq, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+  return true;
+}
+
+/* xorshift32, reproducible from the seed of HostRadioReset */
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static void SetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                         uint32_t datarate, uint8_t coderate,
+                         uint32_t bandwidthAfc, uint16_t preambleLen,
+                         uint16_t symbTimeout, bool fixLen,
+                         uint8_t payloadLen,
+                         bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                         bool iqInverted, bool rxContinuous )
+{
+  RxConfig.Modem = modem;
+  RxConfig.Bandwidth = bandwidth;
+  RxConfig.Datarate = datarate;
+  RxConfig.Coderate = coderate;
+  RxConfig.PreambleLen = preambleLen;
+  RxConfig.FixLen = fixLen;
+  RxConfig.CrcOn = crcOn;
+  RxSymbTimeout = symbTimeout;
+  RxContinuous = rxContinuous;
+}
+
+static void SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                         uint32_t bandwidth, uint32_t datarate,
+                         uint8_t coderate, uint16_t preambleLen,
+                         bool fixLen, bool crcOn, bool freqHopOn,
+                         uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+  TxConfig.Modem = modem;
+  TxConfig.Bandwidth = bandwidth;
+  TxConfig.Datarate = datarate;
+  TxConfig.Coderate = coderate;
+  TxConfig.PreambleLen = preambleLen;
+  TxConfig.FixLen = fixLen;
+  TxConfig.CrcOn = crcOn;
+  TxPower = power;
+}
+
+static bool CheckRfFrequency( uint32_t frequency )
+{
+  return true;
+}
+
+static uint32_t GetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
+{
+  ModemConfig_t config = TxConfig;
+
+  config.Modem = modem;
+  return TimeOnAir( &config, pktLen );
+}
+
+static void Send( uint8_t *buffer, uint8_t size )
+{
+  InitTimers( );
+  TimerStop( &RxTimer );
+  RxFramePending = false;
+
+  LastTx.Modem = TxConfig.Modem;
+  LastTx.Frequency = Frequency;
+  LastTx.Datarate = TxConfig.Datarate;
+  LastTx.Bandwidth = TxConfig.Bandwidth;
+  LastTx.Power = TxPower;
+  LastTx.Time = HW_RTC_GetTimerValue( );
+  LastTx.TimeOnAir = TimeOnAir( &TxConfig, size );
+  LastTx.Size = size;
+  memcpy( LastTx.Payload, buffer, size );
+  LastTxValid = false;
+
+  State = RF_TX_RUNNING;
+  TimerStop( &TxTimer );
+  TimerSetValue( &TxTimer, LastTx.TimeOnAir );
+  TimerStart( &TxTimer );
+  if( TxStartHandler != NULL )
+  {
+    TxStartHandler( &LastTx );
+  }
+}
+
+static void Sleep( void )
+{
+  InitTimers( );
+  TimerStop( &TxTimer );
+  TimerStop( &RxTimer );
+  RxFramePending = false;
+  State = RF_IDLE;
+}
+
+static void Rx( uint32_t timeout )
+{
+  uint32_t windowTime;
+
+  InitTimers( );
+  TimerStop( &RxTimer );
+  RxFramePending = false;
+  State = RF_RX_RUNNING;
+
+  RxWindow.Modem = RxConfig.Modem;
+  RxWindow.Frequency = Frequency;
+  RxWindow.Datarate = RxConfig.Datarate;
+  RxWindow.Bandwidth = RxConfig.Bandwidth;
+  RxWindow.Time = HW_RTC_GetTimerValue( );
+  RxWindow.Size = 0;
+  RxWindowValid = true;
+
+  StartRxFrame( );
+  if( ( RxFramePending == true ) || ( RxContinuous == true ) )
+  {
+    return;
+  }
+
+  /* no preamble detected within the symbol timeout */
+  if( RxConfig.Modem == MODEM_FSK )
+  {
+    windowTime = ( ( RxSymbTimeout * 8 * 1000 ) + RxConfig.Datarate - 1 ) / RxConfig.Datarate;
+  }
+  else
+  {
+    windowTime = ( ( RxSymbTimeout * SymbolTime( &RxConfig ) ) + 999 ) / 1000;
+  }
+  if( ( timeout != 0 ) && ( timeout < windowTime ) )
+  {
+    windowTime = timeout;
+  }
+  TimerSetValue( &RxTimer, windowTime );
+  TimerStart( &RxTimer );
+}
+
+static void StartCad( void )
+{
+  State = RF_CAD;
+  if( ( Events != NULL ) && ( Events->CadDone != NULL ) )
+  {
+    State = RF_IDLE;
+    Events->CadDone( false );
+  }
+}
+
+static void SetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time )
+{
+}
+
+static int16_t Rssi( RadioModems_t modem )
+{
+  return -120;
+}
+
+static void Write( uint16_t addr, uint8_t data )
+{
+}
+
+static uint8_t Read( uint16_t addr )
+{
+  return 0;
+}
+
+static void WriteBuffer( uint16_t addr, uint8_t *buffer, uint8_t size )
+{
+}
+
+static void ReadBuffer( uint16_t addr, uint8_t *buffer, uint8_t size )
+{
+}
+
+static void SetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+}
+
+static void SetPublicNetwork( bool enable )
+{
+}
+
+static uint32_t GetWakeupTime( void )
+{
+  return WAKEUP_TIME;
+}
+
+static void IrqProcess( void )
+{
+}
+
+static void SetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime )
+{
+}
+
+/* Exported variables --------------------------------------------------------*/
+const struct Radio_s Radio =
+{
+  .IoInit = IoInit,
+  .IoDeInit = IoDeInit,
+  .Init = Init,
+  .GetStatus = GetStatus,
+  .SetModem = SetModem,
+  .SetChannel = SetChannel,
+  .IsChannelFree = IsChannelFree,
+  .Random = Random,
+  .SetRxConfig = SetRxConfig,
+  .SetTxConfig = SetTxConfig,
+  .CheckRfFrequency = CheckRfFrequency,
+  .TimeOnAir = GetTimeOnAir,
+  .Send = Send,
+  .Sleep = Sleep,
+  .Standby = Sleep,
+  .Rx = Rx,
+  .StartCad = StartCad,
+  .SetTxContinuousWave = SetTxContinuousWave,
+  .Rssi = Rssi,
+  .Write = Write,
+  .Read = Read,
+  .WriteBuffer = WriteBuffer,
+  .ReadBuffer = ReadBuffer,
+  .SetMaxPayloadLength = SetMaxPayloadLength,
+  .SetPublicNetwork = SetPublicNetwork,
+  .GetWakeupTime = GetWakeupTime,
+  .IrqProcess = IrqProcess,
+  .RxBoosted = Rx,
+  .SetRxDutyCycle = SetRxDutyCycle,
+};
+
+/* Exported functions ---------------------------------------------------------*/
+void HostRadioSetTxHandler( void ( *handler )( const HostRadioFrame_t *frame ) )
+{
+  TxHandler = handler;
+}
+
+void HostRadioSetTxStartHandler( void ( *handler )( const HostRadioFrame_t *frame ) )
+{
+  TxStartHandler = handler;
+}
+
+bool HostRadioGetTx( HostRadioFrame_t *frame )
+{
+  bool valid = LastTxValid;
+
+  if( valid == true )
+  {
+    *frame = LastTx;
+    LastTxValid = false;
+  }
+  return valid;
+}
+
+bool HostRadioQueueRx( uint32_t frequency, const uint8_t *payload, uint8_t size, int16_t rssi, int8_t snr )
+{
+  RxFrame_t *frame;
+
+  if( RxQueueCount == RX_QUEUE_SIZE )
+  {
+    return false;
+  }
+  frame = &RxQueue[RxQueueCount++];
+  frame->Frequency = frequency;
+  frame->Rssi = rssi;
+  frame->Snr = snr;
+  frame->Size = size;
+  memcpy( frame->Payload, payload, size );
+
+  /* a window open on its frequency receives it now, a single window as long
+     as its symbol timeout has not expired */
+  if( ( State == RF_RX_RUNNING ) && ( RxFramePending == false ) )
+  {
+    StartRxFrame( );
+  }
+  return true;
+}
+
+bool HostRadioGetRxWindow( HostRadioFrame_t *frame )
+{
+  *frame = RxWindow;
+  return RxWindowValid;
+}
+
+void HostRadioReset( uint32_t seed )
+{
+  Sleep( );
+  RxQueueCount = 0;
+  LastTxValid = false;
+  RxWindowValid = false;
+  TxHandler = NULL;
+  TxStartHandler = NULL;
+  RandomState = ( seed != 0 ) ? seed : 1;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    hw.c
+  * @author  MCD Application Team
+  * @brief   Host build board support: interrupt mask, HAL tick and the few
+  *          board services the middlewares call
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <time.h>
+#include "hw.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+uint32_t HostPrimask = 0;
+
+uint32_t SystemCoreClock = 32000000;
+
+/* Exported functions ---------------------------------------------------------*/
+uint32_t HAL_GetTick( void )
+{
+  return HW_RTC_GetTimerValue( );
+}
+
+void HAL_Delay( uint32_t Delay )
+{
+  HostRtcRun( Delay );
+}
+
+uint32_t HostGetCycles( void )
+{
+  struct timespec now;
+
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return ( uint32_t )( ( uint64_t )now.tv_sec * SystemCoreClock +
+                       ( uint64_t )now.tv_nsec * SystemCoreClock / 1000000000 );
+}
+
+uint32_t HW_GetRandomSeed( void )
+{
+  return 0x2C8F3E61;
+}
+
+void HW_GetUniqueId( uint8_t *id )
+{
+  for( uint8_t i = 0; i < 8; i++ )
+  {
+    id[i] = 0x10 + i;
+  }
+}
+
+uint8_t HW_GetBatteryLevel( void )
+{
+  return 254;
+}
+
+void DBG_Init( void )
+{
+}
+
+void Error_Handler( void )
+{
+  printf( "Error_Handler\n" );
+  abort( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
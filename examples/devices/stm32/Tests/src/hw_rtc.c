@@ -0,0 +1,180 @@
+/**
+  ******************************************************************************
+  * @file    hw_rtc.c
+  * @author  MCD Application Team
+  * @brief   Host build virtual RTC. The counter only moves in HostRtcRun, which
+  *          runs the alarm IRQ each time the alarm falls due, so the timer
+  *          server and everything above it run on a deterministic clock
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "timeServer.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Shortest alarm the board driver programs, in ticks */
+#define MIN_ALARM_DELAY               3
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint32_t RtcNow;
+static uint32_t RtcContext;
+static uint32_t RtcAlarm;
+static bool RtcAlarmArmed = false;
+static uint32_t RtcIrqLatency;
+static int16_t McuWakeUpTimeCal;
+static uint32_t RtcBackup[2];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions ---------------------------------------------------------*/
+void HW_RTC_Init( void )
+{
+  RtcNow = 0;
+  RtcContext = 0;
+  RtcAlarmArmed = false;
+}
+
+void HW_RTC_StopAlarm( void )
+{
+  RtcAlarmArmed = false;
+}
+
+uint32_t HW_RTC_GetMinimumTimeout( void )
+{
+  return MIN_ALARM_DELAY;
+}
+
+void HW_RTC_SetAlarm( uint32_t timeout )
+{
+  RtcAlarm = RtcContext + timeout;
+  RtcAlarmArmed = true;
+}
+
+uint32_t HW_RTC_GetTimerElapsedTime( void )
+{
+  return RtcNow - RtcContext;
+}
+
+uint32_t HW_RTC_GetTimerValue( void )
+{
+  return RtcNow;
+}
+
+uint32_t HW_RTC_SetTimerContext( void )
+{
+  RtcContext = RtcNow;
+  return RtcContext;
+}
+
+uint32_t HW_RTC_GetTimerContext( void )
+{
+  return RtcContext;
+}
+
+void HW_RTC_IrqHandler( void )
+{
+  TimerIrqHandler( );
+}
+
+void HW_RTC_DelayMs( uint32_t delay )
+{
+  HostRtcRun( delay );
+}
+
+void HW_RTC_setMcuWakeUpTime( void )
+{
+}
+
+int16_t HW_RTC_getMcuWakeUpTime( void )
+{
+  return McuWakeUpTimeCal;
+}
+
+uint32_t HW_RTC_ms2Tick( TimerTime_t timeMilliSec )
+{
+  return timeMilliSec;
+}
+
+TimerTime_t HW_RTC_Tick2ms( uint32_t tick )
+{
+  return tick;
+}
+
+TimerTime_t RtcTempCompensation( TimerTime_t period, float temperature )
+{
+  return period;
+}
+
+uint32_t HW_RTC_GetCalendarTime( uint16_t *subSeconds )
+{
+  *subSeconds = RtcNow % 1000;
+  return RtcNow / 1000;
+}
+
+void HW_RTC_BKUPRead( uint32_t *Data0, uint32_t *Data1 )
+{
+  *Data0 = RtcBackup[0];
+  *Data1 = RtcBackup[1];
+}
+
+void HW_RTC_BKUPWrite( uint32_t Data0, uint32_t Data1 )
+{
+  RtcBackup[0] = Data0;
+  RtcBackup[1] = Data1;
+}
+
+void HostRtcRun( uint32_t ms )
+{
+  uint32_t end = RtcNow + ms;
+  uint32_t irq;
+
+  /* the IRQ runs RtcIrqLatency after the alarm, never before the current time */
+  while( ( RtcAlarmArmed == true ) &&
+         ( ( int32_t )( RtcAlarm + RtcIrqLatency - end ) <= 0 ) )
+  {
+    irq = RtcAlarm + RtcIrqLatency;
+    if( ( int32_t )( irq - RtcNow ) > 0 )
+    {
+      RtcNow = irq;
+    }
+    RtcAlarmArmed = false;
+    HW_RTC_IrqHandler( );
+  }
+  RtcNow = end;
+}
+
+void HostRtcSet( uint32_t ticks )
+{
+  RtcNow = ticks;
+}
+
+bool HostRtcGetAlarm( uint32_t *ticks )
+{
+  *ticks = RtcAlarm;
+  return RtcAlarmArmed;
+}
+
+void HostRtcSetMcuWakeUpTime( int16_t ticks )
+{
+  McuWakeUpTimeCal = ticks;
+}
+
+void HostRtcSetIrqLatency( uint32_t ticks )
+{
+  RtcIrqLatency = ticks;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
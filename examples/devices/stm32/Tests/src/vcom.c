@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file    vcom.c
+  * @author  MCD Application Team
+  * @brief   Host build virtual com port. The bytes sent are appended to a
+  *          capture buffer; a transfer completes at once, or when the test
+  *          calls vcom_Complete to model a DMA still running
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "vcom.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static void (*TxCpltCallback)(void);
+static uint8_t CaptureBuff[VCOM_CAPTURE_SIZE];
+static uint32_t CaptureLen;
+static uint32_t Transfers;
+static int AutoComplete = 1;
+static int InFlight = 0;
+/* Set while the completion callback runs, a transfer it starts is completed
+   by the loop of the outer call instead of recursing */
+static int InCallback = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions ---------------------------------------------------------*/
+void vcom_Init( void (*Txcb)(void) )
+{
+  TxCpltCallback = Txcb;
+  CaptureLen = 0;
+  Transfers = 0;
+  InFlight = 0;
+}
+
+void vcom_Trace( uint8_t *p_data, uint16_t size )
+{
+  if( ( CaptureLen + size ) <= VCOM_CAPTURE_SIZE )
+  {
+    memcpy( &CaptureBuff[CaptureLen], p_data, size );
+    CaptureLen += size;
+  }
+  Transfers++;
+  InFlight = 1;
+
+  if( ( AutoComplete != 0 ) && ( InCallback == 0 ) )
+  {
+    while( vcom_Complete( ) != 0 )
+    {
+    }
+  }
+}
+
+void vcom_SetAutoComplete( int automatic )
+{
+  AutoComplete = automatic;
+}
+
+int vcom_Complete( void )
+{
+  if( InFlight == 0 )
+  {
+    return 0;
+  }
+  InFlight = 0;
+  InCallback = 1;
+  TxCpltCallback( );
+  InCallback = 0;
+  return 1;
+}
+
+uint32_t vcom_Capture( uint8_t *buff )
+{
+  uint32_t len = CaptureLen;
+
+  memcpy( buff, CaptureBuff, len );
+  CaptureLen = 0;
+  return len;
+}
+
+uint32_t vcom_Transfers( void )
+{
+  return Transfers;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,483 @@
+/**
+  ******************************************************************************
+  * @file    test_accelero_fifo.c
+  * @author  MCD Application Team
+  * @brief   FIFO streaming of the LSM6DSL, LSM6DS3 and LSM303AGR accelerometer
+  *          drivers against a model of the sensor FIFO: register setup, INT1 at
+  *          the watermark, one transaction per batch and overrun reporting
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "LSM6DSL_ACC_GYRO_driver_HL.h"
+#include "LSM6DS3_ACC_GYRO_driver_HL.h"
+#include "LSM303AGR_ACC_driver_HL.h"
+#include "unit_test.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  MODEL_LSM6DSX,
+  MODEL_LSM303AGR,
+} ModelKind_t;
+
+/* FIFO streaming API of a LSM6DSx driver */
+typedef struct
+{
+  const char *name;
+  void *drv;
+  uint16_t maxSamples;
+  DrvStatusTypeDef ( *start )( DrvContextTypeDef *, uint16_t );
+  DrvStatusTypeDef ( *stop )( DrvContextTypeDef * );
+  DrvStatusTypeDef ( *getNum )( DrvContextTypeDef *, uint16_t * );
+  DrvStatusTypeDef ( *getRaw )( DrvContextTypeDef *, SensorAxesRaw_t *, uint16_t );
+} StreamApi_t;
+
+/* Private define ------------------------------------------------------------*/
+#define MODEL_MAX_SAMPLES     LSM6DS3_X_FIFO_MAX_SAMPLES
+
+/* LSM6DSx registers */
+#define DSX_FIFO_CTRL1        0x06
+#define DSX_FIFO_CTRL2        0x07
+#define DSX_FIFO_CTRL3        0x08
+#define DSX_FIFO_CTRL5        0x0A
+#define DSX_INT1_CTRL         0x0D
+#define DSX_CTRL1_XL          0x10
+#define DSX_FIFO_STATUS1      0x3A
+#define DSX_FIFO_STATUS2      0x3B
+#define DSX_FIFO_DATA_OUT_L   0x3E
+
+/* LSM303AGR accelerometer registers */
+#define AGR_CTRL_REG1         0x20
+#define AGR_CTRL_REG3         0x22
+#define AGR_CTRL_REG4         0x23
+#define AGR_CTRL_REG5         0x24
+#define AGR_OUT_X_L           0x28
+#define AGR_FIFO_CTRL_REG     0x2E
+#define AGR_FIFO_SRC_REG      0x2F
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+/* Register file and FIFO of the sensor: a ring of samples of three words,
+   whose oldest sample may be partly read */
+static ModelKind_t Kind;
+static uint8_t Regs[128];
+static int16_t Fifo[MODEL_MAX_SAMPLES][3];
+static int FifoCapacity;
+static int FifoHead;
+static int FifoCount;
+static int FifoWord;
+static int FifoOverrun;
+static int Produced;
+static int Transactions;
+
+static DrvContextTypeDef Ctx;
+static SensorAxesRaw_t Samples[MODEL_MAX_SAMPLES];
+
+static const StreamApi_t Lsm6dsl =
+{
+  "LSM6DSL", ( void * )&LSM6DSL_X_Drv, LSM6DSL_X_FIFO_MAX_SAMPLES,
+  LSM6DSL_X_FIFO_Stream_Start, LSM6DSL_X_FIFO_Stream_Stop,
+  LSM6DSL_X_FIFO_Get_Num_Of_Axes, LSM6DSL_X_FIFO_Get_Axes_Raw
+};
+
+static const StreamApi_t Lsm6ds3 =
+{
+  "LSM6DS3", ( void * )&LSM6DS3_X_Drv, LSM6DS3_X_FIFO_MAX_SAMPLES,
+  LSM6DS3_X_FIFO_Stream_Start, LSM6DS3_X_FIFO_Stream_Stop,
+  LSM6DS3_X_FIFO_Get_Num_Of_Axes, LSM6DS3_X_FIFO_Get_Axes_Raw
+};
+
+/* Private functions ---------------------------------------------------------*/
+static void ModelReset( ModelKind_t kind, int capacity )
+{
+  Kind = kind;
+  memset( Regs, 0, sizeof( Regs ) );
+  FifoCapacity = capacity;
+  FifoHead = 0;
+  FifoCount = 0;
+  FifoWord = 0;
+  FifoOverrun = 0;
+  Produced = 0;
+  Transactions = 0;
+}
+
+static void ModelEmpty( void )
+{
+  FifoCount = 0;
+  FifoWord = 0;
+  FifoOverrun = 0;
+}
+
+/* Sample k is ( 16 k, -16 k, 500 ), left justified by shift bits */
+static void ModelProduce( int n, int shift )
+{
+  for( int i = 0; i < n; i++, Produced++ )
+  {
+    int slot;
+
+    if( FifoCount == FifoCapacity )
+    {
+      /* Stream mode: the newest sample overwrites the oldest */
+      FifoHead = ( FifoHead + 1 ) % FifoCapacity;
+      FifoWord = 0;
+      FifoCount--;
+      FifoOverrun = 1;
+    }
+    slot = ( FifoHead + FifoCount ) % FifoCapacity;
+    Fifo[slot][0] = ( int16_t )( Produced * 16 );
+    Fifo[slot][1] = ( int16_t )( -Produced * 16 );
+    Fifo[slot][2] = ( int16_t )( 500 << shift );
+    FifoCount++;
+  }
+}
+
+static int16_t ModelPop( void )
+{
+  int16_t word = 0;
+
+  if( FifoCount > 0 )
+  {
+    word = Fifo[FifoHead][FifoWord];
+    if( ++FifoWord == 3 )
+    {
+      FifoWord = 0;
+      FifoHead = ( FifoHead + 1 ) % FifoCapacity;
+      FifoCount--;
+    }
+  }
+  return word;
+}
+
+static void ModelUpdateStatus( void )
+{
+  if( Kind == MODEL_LSM6DSX )
+  {
+    int words = FifoCount * 3 - FifoWord;
+    int wtm = Regs[DSX_FIFO_CTRL1] | ( ( Regs[DSX_FIFO_CTRL2] & 0x0F ) << 8 );
+
+    Regs[DSX_FIFO_STATUS1] = ( uint8_t )words;
+    Regs[DSX_FIFO_STATUS2] = ( ( words >> 8 ) & 0x0F ) | ( ( wtm != 0 && words >= wtm ) ? 0x80 : 0 ) |
+                             ( FifoOverrun ? 0x40 : 0 ) | ( ( words == 0 ) ? 0x10 : 0 );
+  }
+  else
+  {
+    int wtm = Regs[AGR_FIFO_CTRL_REG] & 0x1F;
+
+    Regs[AGR_FIFO_SRC_REG] = ( ( FifoCount >= wtm ) ? 0x80 : 0 ) | ( FifoOverrun ? 0x40 : 0 ) |
+                             ( ( FifoCount == 0 ) ? 0x20 : 0 ) | ( ( FifoCount > 31 ) ? 31 : FifoCount );
+  }
+}
+
+static int ModelInt1( void )
+{
+  ModelUpdateStatus( );
+  if( Kind == MODEL_LSM6DSX )
+  {
+    return ( Regs[DSX_INT1_CTRL] & 0x08 ) && ( Regs[DSX_FIFO_STATUS2] & 0x80 );
+  }
+  return ( Regs[AGR_CTRL_REG3] & 0x04 ) && ( Regs[AGR_FIFO_SRC_REG] & 0x80 );
+}
+
+/* One I2C transaction each. The LSM6DSx increments the address by default and
+   rolls back on the FIFO output, the LSM303AGR needs the MSB of the address */
+uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
+{
+  uint8_t reg = WriteAddr & 0x7F;
+
+  Transactions++;
+  for( int i = 0; i < nBytesToWrite; i++ )
+  {
+    Regs[reg + i] = pBuffer[i];
+  }
+
+  /* The bypass mode empties the FIFO */
+  if( Kind == MODEL_LSM6DSX && reg == DSX_FIFO_CTRL5 && ( pBuffer[0] & 0x07 ) == 0 )
+  {
+    ModelEmpty( );
+  }
+  if( Kind == MODEL_LSM303AGR && reg == AGR_FIFO_CTRL_REG && ( pBuffer[0] & 0xC0 ) == 0 )
+  {
+    ModelEmpty( );
+  }
+  return 0;
+}
+
+uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
+{
+  uint8_t reg = ReadAddr & 0x7F;
+  int fifoRead;
+
+  Transactions++;
+  ModelUpdateStatus( );
+
+  if( Kind == MODEL_LSM6DSX )
+  {
+    fifoRead = ( reg == DSX_FIFO_DATA_OUT_L );
+  }
+  else
+  {
+    fifoRead = ( reg == AGR_OUT_X_L ) && ( ReadAddr & 0x80 ) && ( Regs[AGR_CTRL_REG5] & 0x40 );
+  }
+
+  if( fifoRead )
+  {
+    for( int i = 0; i + 1 < nBytesToRead; i += 2 )
+    {
+      int16_t word = ModelPop( );
+      pBuffer[i] = ( uint8_t )word;
+      pBuffer[i + 1] = ( uint8_t )( ( uint16_t )word >> 8 );
+    }
+    return 0;
+  }
+
+  for( int i = 0; i < nBytesToRead; i++ )
+  {
+    pBuffer[i] = Regs[reg + i];
+  }
+  return 0;
+}
+
+/* The FIFO is read by polling only */
+uint8_t Sensor_IO_Read_IT( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
+{
+  return 1;
+}
+
+uint8_t Sensor_IO_Write_IT( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
+{
+  return 1;
+}
+
+static int CheckSamples( int n, int first, int shift )
+{
+  for( int i = 0; i < n; i++ )
+  {
+    int k = first + i;
+    if( Samples[i].AXIS_X != ( int16_t )( k * 16 ) >> shift ||
+        Samples[i].AXIS_Y != ( int16_t )( -k * 16 ) >> shift ||
+        Samples[i].AXIS_Z != 500 )
+    {
+      printf( "  sample %d is ( %d, %d, %d )\n", k, Samples[i].AXIS_X, Samples[i].AXIS_Y, Samples[i].AXIS_Z );
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void SetupLsm6dsx( const StreamApi_t *api )
+{
+  ModelReset( MODEL_LSM6DSX, api->maxSamples );
+  memset( &Ctx, 0, sizeof( Ctx ) );
+  Ctx.pVTable = api->drv;
+  /* Accelerometer at 104 Hz */
+  Regs[DSX_CTRL1_XL] = 0x40;
+}
+
+static void Lsm6dsxStart( const StreamApi_t *api )
+{
+  printf( "  %s\n", api->name );
+  SetupLsm6dsx( api );
+
+  UT_ASSERT_EQ( api->start( &Ctx, 0 ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( api->start( &Ctx, api->maxSamples + 1 ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( api->start( &Ctx, 100 ), COMPONENT_OK );
+
+  /* Dynamic stream mode, FIFO at 104 Hz, accelerometer only */
+  UT_ASSERT_EQ( Regs[DSX_FIFO_CTRL5] & 0x07, 6 );
+  UT_ASSERT_EQ( Regs[DSX_FIFO_CTRL5] & 0x78, 0x20 );
+  UT_ASSERT_EQ( Regs[DSX_FIFO_CTRL3] & 0x07, 1 );
+  UT_ASSERT_EQ( Regs[DSX_FIFO_CTRL3] & 0x38, 0 );
+  /* Watermark in words, routed to INT1 */
+  UT_ASSERT_EQ( Regs[DSX_FIFO_CTRL1] | ( ( Regs[DSX_FIFO_CTRL2] & 0x0F ) << 8 ), 300 );
+  UT_ASSERT( Regs[DSX_INT1_CTRL] & 0x08 );
+
+  /* The FIFO cannot follow an accelerometer powered down */
+  SetupLsm6dsx( api );
+  Regs[DSX_CTRL1_XL] = 0x00;
+  UT_ASSERT_EQ( api->start( &Ctx, 100 ), COMPONENT_ERROR );
+}
+
+static void Lsm6dsxBatches( const StreamApi_t *api )
+{
+  uint16_t n = 0;
+
+  printf( "  %s\n", api->name );
+  SetupLsm6dsx( api );
+  api->start( &Ctx, 100 );
+
+  ModelProduce( 99, 0 );
+  UT_ASSERT( !ModelInt1( ) );
+  ModelProduce( 1, 0 );
+  UT_ASSERT( ModelInt1( ) );
+
+  /* The whole batch in one transaction */
+  ModelProduce( 20, 0 );
+  UT_ASSERT_EQ( api->getNum( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, 120 );
+  Transactions = 0;
+  UT_ASSERT_EQ( api->getRaw( &Ctx, Samples, n ), COMPONENT_OK );
+  UT_ASSERT_EQ( Transactions, 1 );
+  UT_ASSERT( CheckSamples( 120, 0, 0 ) );
+  UT_ASSERT( !ModelInt1( ) );
+  UT_ASSERT_EQ( api->getNum( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, 0 );
+
+  /* A full FIFO still fits one transaction */
+  ModelProduce( api->maxSamples, 0 );
+  UT_ASSERT_EQ( api->getNum( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, api->maxSamples );
+  Transactions = 0;
+  UT_ASSERT_EQ( api->getRaw( &Ctx, Samples, n ), COMPONENT_OK );
+  UT_ASSERT_EQ( Transactions, 1 );
+  UT_ASSERT( CheckSamples( n, 120, 0 ) );
+  UT_ASSERT_EQ( api->getRaw( &Ctx, Samples, api->maxSamples + 1 ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( api->getRaw( &Ctx, Samples, 0 ), COMPONENT_ERROR );
+}
+
+static void Lsm6dsxStop( const StreamApi_t *api )
+{
+  DrvContextTypeDef other;
+
+  printf( "  %s\n", api->name );
+  SetupLsm6dsx( api );
+  api->start( &Ctx, 10 );
+  ModelProduce( 12, 0 );
+
+  UT_ASSERT_EQ( api->stop( &Ctx ), COMPONENT_OK );
+  UT_ASSERT( !( Regs[DSX_INT1_CTRL] & 0x08 ) );
+  UT_ASSERT_EQ( Regs[DSX_FIFO_CTRL5] & 0x07, 0 );
+  UT_ASSERT_EQ( FifoCount, 0 );
+
+  /* Another driver's handle is refused */
+  memset( &other, 0, sizeof( other ) );
+  other.pVTable = &LSM303AGR_X_Drv;
+  UT_ASSERT_EQ( api->start( &other, 10 ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( api->getRaw( &other, Samples, 1 ), COMPONENT_ERROR );
+}
+
+static void test_lsm6dsx_stream_start( void )
+{
+  Lsm6dsxStart( &Lsm6dsl );
+  Lsm6dsxStart( &Lsm6ds3 );
+}
+
+static void test_lsm6dsx_batches( void )
+{
+  Lsm6dsxBatches( &Lsm6dsl );
+  Lsm6dsxBatches( &Lsm6ds3 );
+}
+
+static void test_lsm6dsx_stream_stop( void )
+{
+  Lsm6dsxStop( &Lsm6dsl );
+  Lsm6dsxStop( &Lsm6ds3 );
+}
+
+static void SetupLsm303agr( uint8_t ctrlReg1, uint8_t ctrlReg4 )
+{
+  ModelReset( MODEL_LSM303AGR, LSM303AGR_X_FIFO_MAX_SAMPLES );
+  memset( &Ctx, 0, sizeof( Ctx ) );
+  Ctx.pVTable = &LSM303AGR_X_Drv;
+  Regs[AGR_CTRL_REG1] = ctrlReg1;
+  Regs[AGR_CTRL_REG4] = ctrlReg4;
+}
+
+static void test_lsm303agr_stream_start( void )
+{
+  SetupLsm303agr( 0x57, 0x08 );
+
+  /* FTH is 5 bits wide */
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Stream_Start( &Ctx, 0 ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Stream_Start( &Ctx, 32 ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Stream_Start( &Ctx, 25 ), COMPONENT_OK );
+
+  /* Stream mode, watermark on INT1, FIFO enabled */
+  UT_ASSERT_EQ( Regs[AGR_FIFO_CTRL_REG] & 0xC0, 0x80 );
+  UT_ASSERT_EQ( Regs[AGR_FIFO_CTRL_REG] & 0x1F, 25 );
+  UT_ASSERT( Regs[AGR_CTRL_REG5] & 0x40 );
+  UT_ASSERT( Regs[AGR_CTRL_REG3] & 0x04 );
+}
+
+static void test_lsm303agr_batches( void )
+{
+  uint16_t n = 0;
+
+  /* High resolution mode: 12 bits left justified */
+  SetupLsm303agr( 0x57, 0x08 );
+  LSM303AGR_X_FIFO_Stream_Start( &Ctx, 25 );
+
+  ModelProduce( 24, 4 );
+  UT_ASSERT( !ModelInt1( ) );
+  ModelProduce( 1, 4 );
+  UT_ASSERT( ModelInt1( ) );
+
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Num_Of_Axes( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, 25 );
+  Transactions = 0;
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Axes_Raw( &Ctx, Samples, n ), COMPONENT_OK );
+  /* The operating mode, from two registers, then the batch */
+  UT_ASSERT_EQ( Transactions, 3 );
+  UT_ASSERT( CheckSamples( 25, 0, 4 ) );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Num_Of_Axes( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, 0 );
+
+  /* Normal mode: 10 bits */
+  SetupLsm303agr( 0x57, 0x00 );
+  LSM303AGR_X_FIFO_Stream_Start( &Ctx, 4 );
+  ModelProduce( 4, 6 );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Axes_Raw( &Ctx, Samples, 4 ), COMPONENT_OK );
+  UT_ASSERT( CheckSamples( 4, 0, 6 ) );
+}
+
+static void test_lsm303agr_overrun( void )
+{
+  uint16_t n = 0;
+
+  SetupLsm303agr( 0x57, 0x08 );
+  LSM303AGR_X_FIFO_Stream_Start( &Ctx, 25 );
+
+  /* FSS stops at 31, the overrun flag tells the 32 samples */
+  ModelProduce( 31, 4 );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Num_Of_Axes( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, 31 );
+  ModelProduce( 9, 4 );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Num_Of_Axes( &Ctx, &n ), COMPONENT_OK );
+  UT_ASSERT_EQ( n, 32 );
+
+  /* The newest 32 samples, oldest first */
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Axes_Raw( &Ctx, Samples, n ), COMPONENT_OK );
+  UT_ASSERT( CheckSamples( 32, 40 - 32, 4 ) );
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Get_Axes_Raw( &Ctx, Samples, 33 ), COMPONENT_ERROR );
+
+  UT_ASSERT_EQ( LSM303AGR_X_FIFO_Stream_Stop( &Ctx ), COMPONENT_OK );
+  UT_ASSERT( !( Regs[AGR_CTRL_REG3] & 0x04 ) );
+  UT_ASSERT( !( Regs[AGR_CTRL_REG5] & 0x40 ) );
+  UT_ASSERT_EQ( Regs[AGR_FIFO_CTRL_REG] & 0xC0, 0 );
+}
+
+int main( void )
+{
+  UT_RUN( test_lsm6dsx_stream_start );
+  UT_RUN( test_lsm6dsx_batches );
+  UT_RUN( test_lsm6dsx_stream_stop );
+  UT_RUN( test_lsm303agr_stream_start );
+  UT_RUN( test_lsm303agr_batches );
+  UT_RUN( test_lsm303agr_overrun );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,329 @@
+/**
+  ******************************************************************************
+  * @file    test_at_engine.c
+  * @author  MCD Application Team
+  * @brief   AT engine (at_engine.c) over a pseudo serial link: responses and
+  *          unsolicited lines, the drain window that keeps a late final
+  *          result from completing the next command, receive overruns and
+  *          the quiet time of the modems without final result codes
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "at_engine.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define NO_RESULT             0x7FFF     /* done not called */
+
+#define RESULT_OK             0
+#define RESULT_ERROR          1
+
+/* Private typedef -----------------------------------------------------------*/
+/* Command of the test and what the engine reported of it */
+typedef struct
+{
+  int16_t Result;
+  uint8_t Lines;
+  char LastLine[AT_ENGINE_LINE_SIZE];
+} TestCmd_t;
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint32_t Now;                 /* time of the link, in ms */
+static uint32_t RxWritten;           /* bytes the modem wrote into the ring */
+static char Sent[AT_ENGINE_CMD_SIZE + 1];
+static uint8_t SentCount;
+static uint8_t UrcCount;
+static char LastUrc[AT_ENGINE_LINE_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+static bool LinkTransmit( const uint8_t *buff, uint16_t size )
+{
+  memcpy( Sent, buff, size );
+  Sent[size] = '\0';
+  SentCount++;
+  return true;
+}
+
+static bool LinkIsTxBusy( void )
+{
+  return false;
+}
+
+static uint32_t LinkGetRxCount( void )
+{
+  return RxWritten;
+}
+
+static uint32_t LinkGetTime( void )
+{
+  return Now;
+}
+
+static int16_t LinkClassify( const char *line )
+{
+  if( strcmp( line, "OK" ) == 0 )
+  {
+    return RESULT_OK;
+  }
+  if( strcmp( line, "ERROR" ) == 0 )
+  {
+    return RESULT_ERROR;
+  }
+  if( strncmp( line, "+EVT", 4 ) == 0 )
+  {
+    return AT_ENGINE_URC;
+  }
+  return AT_ENGINE_INFO;
+}
+
+static const AtEngineIo_t Link =
+{
+  LinkTransmit,
+  LinkIsTxBusy,
+  LinkGetRxCount,
+  LinkGetTime,
+  LinkClassify,
+  NULL
+};
+
+static void OnUrc( const char *line )
+{
+  strcpy( LastUrc, line );
+  UrcCount++;
+}
+
+static void OnLine( void *context, const char *line )
+{
+  TestCmd_t *cmd = ( TestCmd_t * )context;
+
+  strcpy( cmd->LastLine, line );
+  cmd->Lines++;
+}
+
+static void OnDone( void *context, int16_t result )
+{
+  ( ( TestCmd_t * )context )->Result = result;
+}
+
+/* The modem writes into the ring as the receiver would */
+static void ModemWrite( const char *s )
+{
+  uint8_t *ring = AtEngineGetRxBuffer( );
+
+  while( *s != '\0' )
+  {
+    ring[RxWritten & ( AT_ENGINE_RX_SIZE - 1 )] = ( uint8_t )*s++;
+    RxWritten++;
+  }
+}
+
+static void Reset( void )
+{
+  Now = 1000;
+  RxWritten = 0;
+  SentCount = 0;
+  UrcCount = 0;
+  AtEngineInit( &Link, OnUrc );
+}
+
+static void Submit( TestCmd_t *cmd, const char *at, uint32_t timeout )
+{
+  memset( cmd, 0, sizeof( *cmd ) );
+  cmd->Result = NO_RESULT;
+  UT_ASSERT( AtEngineSubmit( at, strlen( at ), timeout, OnLine, OnDone, cmd ) );
+}
+
+static void test_response( void )
+{
+  TestCmd_t cmd;
+
+  Reset( );
+  Submit( &cmd, "AT+X?\r\n", 100 );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( SentCount, 1 );
+  UT_ASSERT( strcmp( Sent, "AT+X?\r\n" ) == 0 );
+
+  /* an unsolicited line in the middle of the response is not part of it */
+  ModemWrite( "\r\n+X: 5\r\n+EVT: 1\r\n\r\nOK\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( cmd.Result, RESULT_OK );
+  UT_ASSERT_EQ( cmd.Lines, 1 );
+  UT_ASSERT( strcmp( cmd.LastLine, "+X: 5" ) == 0 );
+  UT_ASSERT_EQ( UrcCount, 1 );
+  UT_ASSERT( strcmp( LastUrc, "+EVT: 1" ) == 0 );
+  UT_ASSERT( AtEngineIsIdle( ) );
+}
+
+static void test_late_result_after_timeout( void )
+{
+  TestCmd_t first;
+  TestCmd_t second;
+
+  Reset( );
+  Submit( &first, "AT+A\r\n", 100 );
+  Submit( &second, "AT+B\r\n", 100 );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( SentCount, 1 );
+
+  Now += 100;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( first.Result, AT_ENGINE_TIMEOUT );
+  /* held while the answer of the first command may still come */
+  UT_ASSERT_EQ( SentCount, 1 );
+
+  /* the late answer closes the window, it completes nothing */
+  ModemWrite( "\r\nOK\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( SentCount, 2 );
+  UT_ASSERT( strcmp( Sent, "AT+B\r\n" ) == 0 );
+  UT_ASSERT_EQ( second.Result, NO_RESULT );
+
+  ModemWrite( "\r\nERROR\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( second.Result, RESULT_ERROR );
+}
+
+static void test_drain_after_no_response( void )
+{
+  TestCmd_t reset;
+  TestCmd_t next;
+
+  Reset( );
+  Submit( &reset, "ATZ\r\n", 0 );
+  Submit( &next, "AT\r\n", 100 );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( SentCount, 1 );
+
+  /* released once sent, the window opens */
+  AtEngineProcess( );
+  UT_ASSERT_EQ( reset.Result, 0 );
+  UT_ASSERT_EQ( SentCount, 1 );
+
+  /* the banner of the reboot goes on the window */
+  Now += AT_ENGINE_DRAIN_TIME - 10;
+  ModemWrite( "\r\nBOOT\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( UrcCount, 1 );
+  Now += 10;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( SentCount, 1 );
+
+  /* until the line has been quiet for the drain time */
+  Now += AT_ENGINE_DRAIN_TIME - 10;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( SentCount, 2 );
+  UT_ASSERT( strcmp( Sent, "AT\r\n" ) == 0 );
+
+  ModemWrite( "\r\nOK\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( next.Result, RESULT_OK );
+}
+
+static void test_rx_overrun( void )
+{
+  TestCmd_t first;
+  TestCmd_t second;
+  char line[AT_ENGINE_RX_SIZE + 1];
+
+  Reset( );
+  Submit( &first, "AT+A\r\n", 100 );
+  AtEngineProcess( );
+
+  /* exactly one ring of unread bytes is no overrun */
+  memset( line, 'a', AT_ENGINE_RX_SIZE - 2 );
+  strcpy( &line[AT_ENGINE_RX_SIZE - 2], "\r\n" );
+  ModemWrite( line );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( first.Result, NO_RESULT );
+  UT_ASSERT_EQ( first.Lines, 1 );
+
+  /* one byte more and the oldest byte is lost */
+  memset( line, 'b', AT_ENGINE_RX_SIZE + 1 );
+  line[AT_ENGINE_RX_SIZE] = '\0';
+  ModemWrite( line );
+  ModemWrite( "b" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( first.Result, AT_ENGINE_RX_OVERRUN );
+  UT_ASSERT_EQ( first.Lines, 1 );
+
+  /* the rest of the broken line is skipped, its final result drained */
+  Submit( &second, "AT+B\r\n", 100 );
+  ModemWrite( "bbb\r\nOK\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( UrcCount, 0 );
+  UT_ASSERT( strcmp( Sent, "AT+B\r\n" ) == 0 );
+  UT_ASSERT_EQ( second.Result, NO_RESULT );
+
+  ModemWrite( "\r\nOK\r\n" );
+  AtEngineProcess( );
+  UT_ASSERT_EQ( second.Result, RESULT_OK );
+  UT_ASSERT_EQ( second.Lines, 0 );
+}
+
+static void test_quiet_response( void )
+{
+  TestCmd_t cmd;
+
+  Reset( );
+  memset( &cmd, 0, sizeof( cmd ) );
+  cmd.Result = NO_RESULT;
+  UT_ASSERT( AtEngineSubmitQuiet( "AT+ID\r\n", 7, 300, 50, OnLine, OnDone, &cmd ) );
+  AtEngineProcess( );
+
+  /* no line yet, the timeout bounds the wait for the first one */
+  Now += 299;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( cmd.Result, NO_RESULT );
+
+  ModemWrite( "+ID: DevAddr, 01\r\n" );
+  AtEngineProcess( );
+  Now += 49;
+  ModemWrite( "+ID: DevEui, 02\r\n" );
+  AtEngineProcess( );
+  Now += 49;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( cmd.Result, NO_RESULT );
+
+  Now += 1;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( cmd.Result, 0 );
+  UT_ASSERT_EQ( cmd.Lines, 2 );
+  UT_ASSERT( strcmp( cmd.LastLine, "+ID: DevEui, 02" ) == 0 );
+
+  /* no answer at all times out */
+  memset( &cmd, 0, sizeof( cmd ) );
+  cmd.Result = NO_RESULT;
+  UT_ASSERT( AtEngineSubmitQuiet( "AT+ID\r\n", 7, 300, 50, OnLine, OnDone, &cmd ) );
+  AtEngineProcess( );
+  Now += 300;
+  AtEngineProcess( );
+  UT_ASSERT_EQ( cmd.Result, AT_ENGINE_TIMEOUT );
+}
+
+int main( void )
+{
+  UT_RUN( test_response );
+  UT_RUN( test_late_result_after_timeout );
+  UT_RUN( test_drain_after_no_response );
+  UT_RUN( test_rx_overrun );
+  UT_RUN( test_quiet_response );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,274 @@
+/**
+  ******************************************************************************
+  * @file    test_beacon_drift.c
+  * @author  MCD Application Team
+  * @brief   Class B beacon drift estimation of LoRaMacClassB.c on a virtual
+  *          clock: lock, window widths, drift correction and restarts
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* the estimator is private to the class B module, which is built in this unit */
+#include "LoRaMacClassB.c"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+/* receive error of the default beacon window, in ms (lora.c) */
+#define SYSTEM_MAX_RX_ERROR   20
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static LoRaMacParams_t MacParams;
+static LoRaMacRegion_t MacRegion = LORAMAC_REGION_EU868;
+static MlmeIndication_t MlmeIndication;
+static McpsIndication_t McpsIndication;
+
+/* receive error of the last beacon window opened */
+static uint32_t WindowRxError;
+
+/* Local time of the beacon receptions, in ms */
+static TimerTime_t BeaconRx;
+
+/* Private functions ---------------------------------------------------------*/
+/* Radio and region stand-ins, only the beacon window parameters are recorded */
+const struct Radio_s Radio;
+
+PhyParam_t RegionGetPhyParam( LoRaMacRegion_t region, GetPhyParams_t* getPhy )
+{
+  PhyParam_t phyParam = { 0 };
+
+  return phyParam;
+}
+
+bool RegionVerify( LoRaMacRegion_t region, VerifyParams_t* verify, PhyAttribute_t phyAttribute )
+{
+  return true;
+}
+
+bool RegionRxConfig( LoRaMacRegion_t region, RxConfigParams_t* rxConfig, int8_t* datarate )
+{
+  return true;
+}
+
+void RegionComputeRxWindowParameters( LoRaMacRegion_t region, int8_t datarate, uint8_t minRxSymbols,
+                                      uint32_t rxError, RxConfigParams_t *rxConfigParams )
+{
+  WindowRxError = rxError;
+  rxConfigParams->WindowTimeout = rxError;
+}
+
+void RegionRxBeaconSetup( LoRaMacRegion_t region, RxBeaconSetup_t* rxBeaconSetup, uint8_t* outDr )
+{
+}
+
+void LoRaMacConfirmQueueSetStatus( LoRaMacEventInfoStatus_t status, Mlme_t request )
+{
+}
+
+bool LoRaMacConfirmQueueIsCmdActive( Mlme_t request )
+{
+  return false;
+}
+
+SecureElementStatus_t SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
+{
+  return SECURE_ELEMENT_SUCCESS;
+}
+
+SecureElementStatus_t SecureElementAesEncrypt( uint8_t* buffer, uint16_t size, KeyIdentifier_t keyID, uint8_t* encBuffer )
+{
+  return SECURE_ELEMENT_SUCCESS;
+}
+
+static void Setup( void )
+{
+  memset1( ( uint8_t* )&Ctx.BeaconDrift, 0, sizeof( Ctx.BeaconDrift ) );
+  memset1( ( uint8_t* )&NvmCtx, 0, sizeof( NvmCtx ) );
+  MacParams.SystemMaxRxError = SYSTEM_MAX_RX_ERROR;
+  MacParams.MinRxSymbols = 6;
+  Ctx.NvmCtx = &NvmCtx;
+  Ctx.LoRaMacClassBParams.LoRaMacParams = &MacParams;
+  Ctx.LoRaMacClassBParams.LoRaMacRegion = &MacRegion;
+  Ctx.LoRaMacClassBParams.MlmeIndication = &MlmeIndication;
+  Ctx.LoRaMacClassBParams.McpsIndication = &McpsIndication;
+  Ctx.NvmCtx->BeaconCtx.Ctrl.BeaconAcquired = 1;
+  BeaconRx = 1000;
+}
+
+/* Receives a beacon nbIntervals later, the local clock running fast by
+   driftUs per interval, plus the arrival jitter in ms */
+static void Beacon( uint32_t nbIntervals, int32_t driftUs, int32_t jitterMs )
+{
+  static int32_t driftRemainder;
+
+  driftRemainder += driftUs * ( int32_t )nbIntervals;
+  BeaconRx += nbIntervals * CLASSB_BEACON_INTERVAL + driftRemainder / 1000;
+  driftRemainder %= 1000;
+  UpdateBeaconDrift( BeaconRx + jitterMs );
+}
+
+/* Width of the beacon window opened now, through RxBeaconSetup */
+static uint32_t WindowWidth( void )
+{
+  WindowRxError = 0;
+  RxBeaconSetup( 0, false );
+  return WindowRxError;
+}
+
+static void test_lock_and_window_widths( void )
+{
+  /* the reference, then the drift of the local clock: 5 ms per beacon interval
+     (39 ppm). The jitter starts at the first drift sample and is filtered down */
+  static const struct
+  {
+    bool IsLocked;
+    uint32_t RxError;
+  } expected[] =
+  {
+    { false, SYSTEM_MAX_RX_ERROR },
+    { false, SYSTEM_MAX_RX_ERROR },
+    { false, SYSTEM_MAX_RX_ERROR },
+    { true, 11 },
+    { true, 9 },
+    { true, 7 },
+    { true, 6 },
+    { true, 5 },
+    { true, 5 },
+    { true, 4 },
+  };
+
+  Setup( );
+  for( uint32_t i = 0; i < sizeof( expected ) / sizeof( expected[0] ); i++ )
+  {
+    Beacon( 1, 5000, 0 );
+    UT_ASSERT_EQ( Ctx.BeaconDrift.IsLocked, expected[i].IsLocked );
+    UT_ASSERT_EQ( WindowWidth( ), expected[i].RxError );
+  }
+  UT_ASSERT_EQ( Ctx.BeaconDrift.DriftPerInterval, 5000 );
+
+  /* without jitter the window closes down to its minimum, plus the filter floor */
+  for( int i = 0; i < 20; i++ )
+  {
+    Beacon( 1, 5000, 0 );
+  }
+  UT_ASSERT_EQ( WindowWidth( ), CLASSB_DRIFT_RX_ERROR_MIN + 1 );
+}
+
+static void test_drift_tracking( void )
+{
+  Setup( );
+
+  /* a clock 1.25 ms per interval slow, sampled at 1 ms resolution */
+  for( int i = 0; i < 40; i++ )
+  {
+    Beacon( 1, -1250, 0 );
+  }
+  UT_ASSERT( Ctx.BeaconDrift.IsLocked );
+  UT_ASSERT( ( Ctx.BeaconDrift.DriftPerInterval <= -1000 ) && ( Ctx.BeaconDrift.DriftPerInterval >= -1500 ) );
+
+  /* the next beacon, 2 intervals ahead, is expected 2.5 ms early, rounded
+     towards 0 */
+  UT_ASSERT_EQ( ApplyBeaconDrift( BeaconRx + 2 * CLASSB_BEACON_INTERVAL, 2 * CLASSB_BEACON_INTERVAL ),
+                2 * CLASSB_BEACON_INTERVAL + ( Ctx.BeaconDrift.DriftPerInterval * 2 ) / 1000 );
+
+  /* a correction never moves the window before now */
+  UT_ASSERT_EQ( ApplyBeaconDrift( BeaconRx + 2 * CLASSB_BEACON_INTERVAL, 1 ), 1 );
+}
+
+static void test_jitter_widens_window( void )
+{
+  uint32_t quiet;
+  uint32_t noisy;
+
+  Setup( );
+  for( int i = 0; i < 30; i++ )
+  {
+    Beacon( 1, 2000, 0 );
+  }
+  quiet = WindowWidth( );
+
+  /* +-3 ms of arrival jitter */
+  for( int i = 0; i < 30; i++ )
+  {
+    Beacon( 1, 2000, ( i & 1 ) ? 3 : -3 );
+  }
+  noisy = WindowWidth( );
+
+  UT_ASSERT( Ctx.BeaconDrift.IsLocked );
+  UT_ASSERT( noisy > quiet );
+  UT_ASSERT( noisy <= SYSTEM_MAX_RX_ERROR );
+
+  /* never wider than the default window */
+  for( int i = 0; i < 30; i++ )
+  {
+    Beacon( 1, 2000, ( i & 1 ) ? 9 : -9 );
+  }
+  UT_ASSERT_EQ( WindowWidth( ), SYSTEM_MAX_RX_ERROR );
+}
+
+static void test_missed_beacons( void )
+{
+  Setup( );
+  for( int i = 0; i < 6; i++ )
+  {
+    Beacon( 1, 4000, 0 );
+  }
+  UT_ASSERT( Ctx.BeaconDrift.IsLocked );
+
+  /* a missed beacon drops the lock, the last reception stays the reference
+     and the next sample spans 2 intervals */
+  UnlockBeaconDrift( );
+  UT_ASSERT_EQ( WindowWidth( ), SYSTEM_MAX_RX_ERROR );
+  Beacon( 2, 4000, 0 );
+  UT_ASSERT_EQ( Ctx.BeaconDrift.NbSamples, 2 );
+  UT_ASSERT_EQ( Ctx.BeaconDrift.DriftPerInterval, 4000 );
+  Beacon( 1, 4000, 0 );
+  Beacon( 1, 4000, 0 );
+  UT_ASSERT( Ctx.BeaconDrift.IsLocked );
+
+  /* too many intervals since the reference: the estimation restarts */
+  Beacon( CLASSB_DRIFT_MAX_INTERVALS + 1, 4000, 0 );
+  UT_ASSERT_EQ( Ctx.BeaconDrift.NbSamples, 1 );
+  UT_ASSERT( !Ctx.BeaconDrift.IsLocked );
+}
+
+static void test_outlier_restarts( void )
+{
+  Setup( );
+  for( int i = 0; i < 6; i++ )
+  {
+    Beacon( 1, 1000, 0 );
+  }
+  UT_ASSERT( Ctx.BeaconDrift.IsLocked );
+
+  /* a beacon beyond the maximum error is not a drift sample */
+  Beacon( 1, 1000, CLASSB_DRIFT_MAX_ERROR + 1 );
+  UT_ASSERT_EQ( Ctx.BeaconDrift.NbSamples, 1 );
+  UT_ASSERT( !Ctx.BeaconDrift.IsLocked );
+  UT_ASSERT_EQ( WindowWidth( ), SYSTEM_MAX_RX_ERROR );
+}
+
+int main( void )
+{
+  UT_RUN( test_lock_and_window_widths );
+  UT_RUN( test_drift_tracking );
+  UT_RUN( test_jitter_widens_window );
+  UT_RUN( test_missed_beacons );
+  UT_RUN( test_outlier_restarts );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,360 @@
+/**
+  ******************************************************************************
+  * @file    test_dsp_simd.c
+  * @author  MCD Application Team
+  * @brief   Conformance of the x86 CMSIS-DSP kernels of DSP/Source/x86 with
+  *          the C versions of bench/dsp_ref.c: same results for the integer
+  *          types, for the filters, the FFT and the extrema, and within the
+  *          rounding of a reordered sum for the floating point sums
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdbool.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_ref.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_BLOCK             300
+#define MAX_TAPS              40
+#define MAX_STAGES            3
+#define MAX_FFT               4096
+
+/* Relative error of a float sum summed in another order */
+#define MAX_SUM_ERROR         1e-5
+
+/* Private macro -------------------------------------------------------------*/
+#define COUNT( a )            ( sizeof( a ) / sizeof( ( a )[0] ) )
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+/* Block sizes around the lane counts of SSE and AVX2 */
+static const uint32_t Sizes[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 100, 255, 256, MAX_BLOCK };
+
+static uint32_t Seed = 1;
+
+static float32_t F32A[MAX_BLOCK], F32B[MAX_BLOCK];
+static q31_t Q31A[MAX_BLOCK], Q31B[MAX_BLOCK];
+static q15_t Q15A[MAX_BLOCK], Q15B[MAX_BLOCK];
+static q7_t Q7A[MAX_BLOCK], Q7B[MAX_BLOCK];
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  Seed ^= Seed << 13;
+  Seed ^= Seed >> 17;
+  Seed ^= Seed << 5;
+  return Seed;
+}
+
+static float32_t RandomF32( void )
+{
+  return ( float32_t )( int32_t )Random( ) / 2147483648.0f;
+}
+
+/* Random samples, or the most negative one everywhere when extreme */
+static void Fill( uint32_t n, bool extreme )
+{
+  for( uint32_t i = 0; i < n; i++ )
+  {
+    F32A[i] = extreme ? -1.0f : RandomF32( );
+    F32B[i] = extreme ? -1.0f : RandomF32( );
+    Q31A[i] = extreme ? INT32_MIN : ( q31_t )Random( );
+    Q31B[i] = extreme ? INT32_MIN : ( q31_t )Random( );
+    Q15A[i] = extreme ? INT16_MIN : ( q15_t )Random( );
+    Q15B[i] = extreme ? INT16_MIN : ( q15_t )Random( );
+    Q7A[i] = extreme ? INT8_MIN : ( q7_t )Random( );
+    Q7B[i] = extreme ? INT8_MIN : ( q7_t )Random( );
+  }
+}
+
+static bool CloseF32( float32_t actual, float32_t expected, double scale )
+{
+  return fabs( ( double )actual - expected ) <= MAX_SUM_ERROR * scale;
+}
+
+static void TestDotProduct( void )
+{
+  for( int extreme = 0; extreme < 2; extreme++ )
+  {
+    for( uint32_t s = 0; s < COUNT( Sizes ); s++ )
+    {
+      uint32_t n = Sizes[s];
+      float32_t f, fRef;
+      q63_t l, lRef;
+      q31_t w, wRef;
+      double scale = 0;
+
+      Fill( n, extreme );
+      for( uint32_t i = 0; i < n; i++ )
+      {
+        scale += fabs( F32A[i] * F32B[i] );
+      }
+
+      arm_dot_prod_f32( F32A, F32B, n, &f );
+      ref_arm_dot_prod_f32( F32A, F32B, n, &fRef );
+      UT_ASSERT( CloseF32( f, fRef, scale ) );
+
+      arm_dot_prod_q31( Q31A, Q31B, n, &l );
+      ref_arm_dot_prod_q31( Q31A, Q31B, n, &lRef );
+      UT_ASSERT_EQ( l, lRef );
+
+      arm_dot_prod_q15( Q15A, Q15B, n, &l );
+      ref_arm_dot_prod_q15( Q15A, Q15B, n, &lRef );
+      UT_ASSERT_EQ( l, lRef );
+
+      arm_dot_prod_q7( Q7A, Q7B, n, &w );
+      ref_arm_dot_prod_q7( Q7A, Q7B, n, &wRef );
+      UT_ASSERT_EQ( w, wRef );
+    }
+  }
+}
+
+/* Filters three blocks in a row with both versions, the state carries over */
+#define CHECK_FIR( type, t, src, taps, n )                                                  \
+  do{                                                                                       \
+    static type state[MAX_TAPS + MAX_BLOCK], stateRef[MAX_TAPS + MAX_BLOCK];               \
+    static type coeffs[MAX_TAPS], out[MAX_BLOCK], outRef[MAX_BLOCK];                        \
+    arm_fir_instance_##t fir = { ( taps ), state, coeffs };                                 \
+    arm_fir_instance_##t firRef = { ( taps ), stateRef, coeffs };                           \
+    memset( state, 0, sizeof( state ) );                                                    \
+    memset( stateRef, 0, sizeof( stateRef ) );                                              \
+    memcpy( coeffs, ( src ) + MAX_BLOCK - ( taps ), ( taps ) * sizeof( type ) );            \
+    for( int b = 0; b < 3; b++ )                                                            \
+    {                                                                                       \
+      arm_fir_##t( &fir, ( src ) + b, out, ( n ) );                                         \
+      ref_arm_fir_##t( &firRef, ( src ) + b, outRef, ( n ) );                               \
+      UT_ASSERT_MEM( out, outRef, ( n ) * sizeof( type ) );                                 \
+      UT_ASSERT_MEM( state, stateRef, ( ( taps ) - 1 ) * sizeof( type ) );                  \
+    }                                                                                       \
+  }while(0)
+
+static void TestFir( void )
+{
+  static const uint16_t taps[] = { 1, 2, 5, 8, 16, 29, MAX_TAPS };
+
+  for( int extreme = 0; extreme < 2; extreme++ )
+  {
+    Fill( MAX_BLOCK, extreme );
+    for( uint32_t t = 0; t < COUNT( taps ); t++ )
+    {
+      for( uint32_t s = 0; Sizes[s] <= MAX_BLOCK - MAX_TAPS - 2; s++ )
+      {
+        CHECK_FIR( float32_t, f32, F32A, taps[t], Sizes[s] );
+        CHECK_FIR( q31_t, q31, Q31A, taps[t], Sizes[s] );
+        CHECK_FIR( q15_t, q15, Q15A, taps[t], Sizes[s] );
+        CHECK_FIR( q7_t, q7, Q7A, taps[t], Sizes[s] );
+      }
+    }
+  }
+}
+
+/*
+ * Filters a block out of place then in place with both versions, over
+ * coefficients whose poles stay inside the unit circle
+ */
+#define CHECK_BIQUAD( type, t, ncoeffs, shift, stages, n )                                  \
+  do{                                                                                       \
+    static type state[4 * MAX_STAGES], stateRef[4 * MAX_STAGES];                            \
+    static type out[MAX_BLOCK], outRef[MAX_BLOCK];                                          \
+    arm_biquad_casd_df1_inst_##t iir = { ( stages ), state, coeffs##t, shift };             \
+    arm_biquad_casd_df1_inst_##t iirRef = { ( stages ), stateRef, coeffs##t, shift };       \
+    memset( state, 0, sizeof( state ) );                                                    \
+    memset( stateRef, 0, sizeof( stateRef ) );                                              \
+    arm_biquad_cascade_df1_##t( &iir, in##t, out, ( n ) );                                  \
+    ref_arm_biquad_cascade_df1_##t( &iirRef, in##t, outRef, ( n ) );                        \
+    UT_ASSERT_MEM( out, outRef, ( n ) * sizeof( type ) );                                   \
+    arm_biquad_cascade_df1_##t( &iir, out, out, ( n ) );                                    \
+    ref_arm_biquad_cascade_df1_##t( &iirRef, outRef, outRef, ( n ) );                       \
+    UT_ASSERT_MEM( out, outRef, ( n ) * sizeof( type ) );                                   \
+    UT_ASSERT_MEM( state, stateRef, 4 * ( stages ) * sizeof( type ) );                      \
+  }while(0)
+
+static void TestBiquad( void )
+{
+  static float32_t coeffsf32[5 * MAX_STAGES];
+  static q31_t coeffsq31[5 * MAX_STAGES];
+  static q15_t coeffsq15[6 * MAX_STAGES];
+  float32_t *inf32 = F32A;
+  q31_t *inq31 = Q31A;
+  q15_t *inq15 = Q15A;
+
+  for( int extreme = 0; extreme < 2; extreme++ )
+  {
+    Fill( MAX_BLOCK, extreme );
+    for( uint32_t k = 0; k < MAX_STAGES; k++ )
+    {
+      /* b0..b2 in [-1, 1), a1 in [-1, 1), a2 in [-0.5, 0): stable */
+      float32_t c[5] = { RandomF32( ), RandomF32( ), RandomF32( ), RandomF32( ), -fabsf( RandomF32( ) ) / 2 };
+
+      for( uint32_t i = 0; i < 5; i++ )
+      {
+        coeffsf32[5 * k + i] = c[i];
+        /* in 2.30 and 2.14, with a post shift of 1 */
+        coeffsq31[5 * k + i] = ( q31_t )( c[i] * 1073741824.0f );
+        coeffsq15[6 * k + ( ( i == 0 ) ? 0 : i + 1 )] = ( q15_t )( c[i] * 16384.0f );
+      }
+      coeffsq15[6 * k + 1] = 0;
+    }
+
+    for( uint8_t stages = 1; stages <= MAX_STAGES; stages++ )
+    {
+      for( uint32_t s = 0; s < COUNT( Sizes ); s++ )
+      {
+        CHECK_BIQUAD( float32_t, f32, 5, , stages, Sizes[s] );
+        CHECK_BIQUAD( q31_t, q31, 5, 1, stages, Sizes[s] );
+        CHECK_BIQUAD( q15_t, q15, 6, 1, stages, Sizes[s] );
+      }
+    }
+  }
+}
+
+static void TestCfft( void )
+{
+  static const arm_cfft_instance_f32 *ffts[] =
+  {
+    &arm_cfft_sR_f32_len16, &arm_cfft_sR_f32_len32, &arm_cfft_sR_f32_len64,
+    &arm_cfft_sR_f32_len128, &arm_cfft_sR_f32_len256, &arm_cfft_sR_f32_len512,
+    &arm_cfft_sR_f32_len1024, &arm_cfft_sR_f32_len2048, &arm_cfft_sR_f32_len4096
+  };
+  static float32_t buf[2 * MAX_FFT], bufRef[2 * MAX_FFT];
+
+  for( uint32_t f = 0; f < COUNT( ffts ); f++ )
+  {
+    uint32_t n = ffts[f]->fftLen;
+
+    for( uint8_t ifft = 0; ifft < 2; ifft++ )
+    {
+      for( uint32_t i = 0; i < 2 * n; i++ )
+      {
+        buf[i] = bufRef[i] = RandomF32( );
+      }
+      /* a zero sample for the signs of the zero results */
+      buf[2] = bufRef[2] = 0.0f;
+      buf[3] = bufRef[3] = -0.0f;
+
+      arm_cfft_f32( ffts[f], buf, ifft, 1 );
+      ref_arm_cfft_f32( ffts[f], bufRef, ifft, 1 );
+      UT_ASSERT_MEM( buf, bufRef, 2 * n * sizeof( float32_t ) );
+    }
+  }
+}
+
+/* Mean, power, extrema and variance of a block, with both versions */
+#define CHECK_STATS( type, t, powtype, src, n )                                             \
+  do{                                                                                       \
+    type v, vRef;                                                                           \
+    powtype p, pRef;                                                                        \
+    uint32_t i, iRef;                                                                       \
+    arm_mean_##t( src, n, &v );                                                             \
+    ref_arm_mean_##t( src, n, &vRef );                                                      \
+    UT_ASSERT_EQ( v, vRef );                                                                \
+    arm_power_##t( src, n, &p );                                                            \
+    ref_arm_power_##t( src, n, &pRef );                                                     \
+    UT_ASSERT_EQ( p, pRef );                                                                \
+    arm_min_##t( src, n, &v, &i );                                                          \
+    ref_arm_min_##t( src, n, &vRef, &iRef );                                                \
+    UT_ASSERT_EQ( v, vRef );                                                                \
+    UT_ASSERT_EQ( i, iRef );                                                                \
+    arm_max_##t( src, n, &v, &i );                                                          \
+    ref_arm_max_##t( src, n, &vRef, &iRef );                                                \
+    UT_ASSERT_EQ( v, vRef );                                                                \
+    UT_ASSERT_EQ( i, iRef );                                                                \
+  }while(0)
+
+static void TestStatistics( void )
+{
+  for( int pass = 0; pass < 3; pass++ )
+  {
+    for( uint32_t s = 0; s < COUNT( Sizes ); s++ )
+    {
+      uint32_t n = Sizes[s];
+      float32_t f, fRef, fv, fvRef;
+      uint32_t i, iRef;
+      q31_t w, wRef;
+      q15_t h, hRef;
+      double scale = 0, scale2 = 0;
+
+      Fill( n, pass == 1 );
+      if( pass == 2 )
+      {
+        /* ties: the extrema appear several times, the first one is reported */
+        for( uint32_t k = 0; k < n; k++ )
+        {
+          F32A[k] = ( float32_t )( ( int32_t )( Random( ) % 5 ) - 2 );
+          Q31A[k] = Q15A[k] = Q7A[k] = ( int8_t )( F32A[k] * 64 );
+        }
+      }
+
+      CHECK_STATS( q31_t, q31, q63_t, Q31A, n );
+      CHECK_STATS( q15_t, q15, q63_t, Q15A, n );
+      CHECK_STATS( q7_t, q7, q31_t, Q7A, n );
+
+      arm_var_q31( Q31A, n, &w );
+      ref_arm_var_q31( Q31A, n, &wRef );
+      UT_ASSERT_EQ( w, wRef );
+      arm_var_q15( Q15A, n, &h );
+      ref_arm_var_q15( Q15A, n, &hRef );
+      UT_ASSERT_EQ( h, hRef );
+
+      for( uint32_t k = 0; k < n; k++ )
+      {
+        scale += fabs( F32A[k] );
+        scale2 += F32A[k] * F32A[k];
+      }
+      arm_mean_f32( F32A, n, &f );
+      ref_arm_mean_f32( F32A, n, &fRef );
+      UT_ASSERT( CloseF32( f, fRef, scale / n ) );
+      arm_power_f32( F32A, n, &f );
+      ref_arm_power_f32( F32A, n, &fRef );
+      UT_ASSERT( CloseF32( f, fRef, scale2 ) );
+      arm_var_f32( F32A, n, &fv );
+      ref_arm_var_f32( F32A, n, &fvRef );
+      UT_ASSERT( CloseF32( fv, fvRef, ( n > 1 ) ? 4 * scale2 / ( n - 1 ) : 0 ) );
+
+      arm_min_f32( F32A, n, &f, &i );
+      ref_arm_min_f32( F32A, n, &fRef, &iRef );
+      UT_ASSERT_MEM( &f, &fRef, sizeof( f ) );
+      UT_ASSERT_EQ( i, iRef );
+      arm_max_f32( F32A, n, &f, &i );
+      ref_arm_max_f32( F32A, n, &fRef, &iRef );
+      UT_ASSERT_MEM( &f, &fRef, sizeof( f ) );
+      UT_ASSERT_EQ( i, iRef );
+    }
+  }
+}
+
+int main( void )
+{
+#if defined( __AVX2__ )
+  printf( "x86 kernels: AVX2\n" );
+#elif defined( __SSE4_1__ )
+  printf( "x86 kernels: SSE4.1\n" );
+#else
+  printf( "x86 kernels: none, the C versions against themselves\n" );
+#endif
+
+  UT_RUN( TestDotProduct );
+  UT_RUN( TestFir );
+  UT_RUN( TestBiquad );
+  UT_RUN( TestCfft );
+  UT_RUN( TestStatistics );
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
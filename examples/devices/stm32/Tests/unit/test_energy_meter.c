@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file    test_energy_meter.c
+  * @author  MCD Application Team
+  * @brief   Energy integration of energy_meter.c on the virtual RTC: the
+  *          uW x tick integral converted to uJ, the accounts and the RTC wrap
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "utilities_conf.h"
+#include "energy_meter.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Power of the currents of utilities_conf.h at 3.3 V, in uW */
+#define UW( ua )              ( ( ( ua ) * 3300 ) / 1000 )
+#define MCU_RUN_UW            UW( ENERGY_MCU_RUN_UA )
+#define MCU_STOP_UW           UW( ENERGY_MCU_STOP_UA )
+#define RADIO_SLEEP_UW        UW( ENERGY_RADIO_SLEEP_UA )
+#define RADIO_TX_UW           UW( ENERGY_RADIO_TX_UA )
+#define RADIO_RX_UW           UW( ENERGY_RADIO_RX_UA )
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+/* Private functions ---------------------------------------------------------*/
+static void Setup( uint32_t ticks )
+{
+  HostRtcSet( ticks );
+  EnergyInit( );
+}
+
+static uint32_t Total( void )
+{
+  EnergyStats_t stats;
+
+  EnergyGetStats( &stats );
+  return stats.Total;
+}
+
+static void test_idle_integration( void )
+{
+  Setup( 0 );
+  HostRtcRun( 1000 );
+
+  /* 1 s at MCU run and radio sleep */
+  UT_ASSERT_EQ( Total( ), MCU_RUN_UW + RADIO_SLEEP_UW );
+}
+
+static void test_state_changes( void )
+{
+  Setup( 0 );
+  EnergySetRadioState( ENERGY_RADIO_TX );
+  HostRtcRun( 50 );
+  EnergySetRadioState( ENERGY_RADIO_RX );
+  HostRtcRun( 20 );
+  EnergySetRadioState( ENERGY_RADIO_SLEEP );
+  EnergySetMcuState( ENERGY_MCU_STOP );
+  HostRtcRun( 930 );
+  EnergySetMcuState( ENERGY_MCU_RUN );
+
+  /* each state over its own duration, truncated once to uJ */
+  UT_ASSERT_EQ( Total( ), ( ( RADIO_TX_UW + MCU_RUN_UW ) * 50 +
+                            ( RADIO_RX_UW + MCU_RUN_UW ) * 20 +
+                            ( RADIO_SLEEP_UW + MCU_STOP_UW ) * 930 ) / 1000 );
+
+  /* setting the current state again does not restart the integration */
+  EnergySetMcuState( ENERGY_MCU_RUN );
+  EnergyResetStats( );
+  HostRtcRun( 100 );
+  UT_ASSERT_EQ( Total( ), ( MCU_RUN_UW + RADIO_SLEEP_UW ) * 100 / 1000 );
+}
+
+static void test_overlapping_accounts( void )
+{
+  EnergyStats_t stats;
+  uint32_t uplink;
+  uint32_t rx;
+
+  Setup( 0 );
+  EnergySetRadioState( ENERGY_RADIO_TX );
+  EnergyStart( ENERGY_UPLINK );
+  HostRtcRun( 40 );
+
+  /* a second start does not move the opening of the account */
+  EnergyStart( ENERGY_UPLINK );
+  EnergySetRadioState( ENERGY_RADIO_SLEEP );
+  HostRtcRun( 960 );
+
+  EnergySetRadioState( ENERGY_RADIO_RX );
+  EnergyStart( ENERGY_RX_WINDOW );
+  HostRtcRun( 30 );
+  rx = EnergyStop( ENERGY_RX_WINDOW );
+  EnergySetRadioState( ENERGY_RADIO_SLEEP );
+  uplink = EnergyStop( ENERGY_UPLINK );
+
+  UT_ASSERT_EQ( rx, ( RADIO_RX_UW + MCU_RUN_UW ) * 30 / 1000 );
+  UT_ASSERT_EQ( uplink, ( ( RADIO_TX_UW + MCU_RUN_UW ) * 40 +
+                          ( RADIO_SLEEP_UW + MCU_RUN_UW ) * 960 +
+                          ( RADIO_RX_UW + MCU_RUN_UW ) * 30 ) / 1000 );
+
+  /* a closed account is not stopped twice */
+  UT_ASSERT_EQ( EnergyStop( ENERGY_UPLINK ), 0 );
+
+  EnergyGetStats( &stats );
+  UT_ASSERT_EQ( stats.Account[ENERGY_UPLINK].Count, 1 );
+  UT_ASSERT_EQ( stats.Account[ENERGY_UPLINK].Last, uplink );
+  UT_ASSERT_EQ( stats.Account[ENERGY_RX_WINDOW].Count, 1 );
+  UT_ASSERT_EQ( stats.Account[ENERGY_RX_WINDOW].Total, rx );
+  UT_ASSERT_EQ( stats.Account[ENERGY_BEACON].Count, 0 );
+}
+
+static void test_sub_uj_remainders_kept( void )
+{
+  EnergyStats_t stats;
+
+  Setup( 0 );
+
+  /* 10 accounts of 1 ms are truncated each, the total keeps their remainders */
+  for( int i = 0; i < 10; i++ )
+  {
+    EnergyStart( ENERGY_BEACON );
+    HostRtcRun( 1 );
+    UT_ASSERT_EQ( EnergyStop( ENERGY_BEACON ), ( MCU_RUN_UW + RADIO_SLEEP_UW ) / 1000 );
+  }
+  EnergyGetStats( &stats );
+  UT_ASSERT_EQ( stats.Account[ENERGY_BEACON].Total, 10 * ( ( MCU_RUN_UW + RADIO_SLEEP_UW ) / 1000 ) );
+  UT_ASSERT_EQ( stats.Total, 10 * ( MCU_RUN_UW + RADIO_SLEEP_UW ) / 1000 );
+}
+
+static void test_rtc_wrap( void )
+{
+  uint32_t energy;
+
+  /* 256 ticks before the 32-bit RTC counter wraps */
+  Setup( 0xFFFFFF00 );
+  EnergySetRadioState( ENERGY_RADIO_TX );
+  EnergyStart( ENERGY_UPLINK );
+  HostRtcRun( 512 );
+  energy = EnergyStop( ENERGY_UPLINK );
+
+  UT_ASSERT_EQ( HW_RTC_GetTimerValue( ), 256 );
+  UT_ASSERT_EQ( energy, ( RADIO_TX_UW + MCU_RUN_UW ) * 512 / 1000 );
+}
+
+int main( void )
+{
+  UT_RUN( test_idle_integration );
+  UT_RUN( test_state_changes );
+  UT_RUN( test_overlapping_accounts );
+  UT_RUN( test_sub_uj_remainders_kept );
+  UT_RUN( test_rtc_wrap );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,282 @@
+/**
+  ******************************************************************************
+  * @file    test_hts221.c
+  * @author  MCD Application Team
+  * @brief   HTS221 driver against a register model of the sensor: number of
+  *          I2C transactions per measurement, and fixed point conversion
+  *          against a floating point reference over random calibrations
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <math.h>
+#include "HTS221_Driver_HL.h"
+#include "humidity.h"
+#include "temperature.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CALIBRATION_RUNS      200000
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+/* Register file of the sensor and I2C transactions since the last reset */
+static uint8_t Regs[256];
+static int Reads;
+static int Writes;
+
+static HTS221_Combo_Data_t Combo;
+static HTS221_H_Data_t HData = { &Combo };
+static HTS221_T_Data_t TData = { &Combo };
+static HUMIDITY_Data_t HumData = { &HData, 0 };
+static TEMPERATURE_Data_t TempData = { &TData, 0 };
+static DrvContextTypeDef Hum;
+static DrvContextTypeDef Temp;
+
+/* Private functions ---------------------------------------------------------*/
+/* One I2C transaction each, the MSB of the sub-address is the auto increment */
+uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
+{
+  Reads++;
+  for( int i = 0; i < nBytesToRead; i++ )
+  {
+    pBuffer[i] = Regs[( ( ReadAddr & 0x7F ) + i ) & 0xFF];
+  }
+  return 0;
+}
+
+uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
+{
+  Writes++;
+  for( int i = 0; i < nBytesToWrite; i++ )
+  {
+    Regs[( ( WriteAddr & 0x7F ) + i ) & 0xFF] = pBuffer[i];
+  }
+  return 0;
+}
+
+/* Interrupt driven transfers complete at once */
+uint8_t Sensor_IO_Read_IT( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
+{
+  return Sensor_IO_Read( handle, ReadAddr, pBuffer, nBytesToRead );
+}
+
+uint8_t Sensor_IO_Write_IT( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
+{
+  return Sensor_IO_Write( handle, WriteAddr, pBuffer, nBytesToWrite );
+}
+
+static void Put16( int reg, int16_t value )
+{
+  Regs[reg] = ( uint8_t )value;
+  Regs[reg + 1] = ( uint8_t )( ( uint16_t )value >> 8 );
+}
+
+static void ResetCounters( void )
+{
+  Reads = 0;
+  Writes = 0;
+}
+
+/* Calibration and outputs close to the datasheet example */
+static void SetupSensor( void )
+{
+  memset( Regs, 0, sizeof( Regs ) );
+  Regs[HTS221_WHO_AM_I_REG] = HTS221_WHO_AM_I_VAL;
+  Regs[0x30] = 0x34;
+  Regs[0x31] = 0x8B;
+  Regs[0x32] = 0xA8;
+  Regs[0x33] = 0x3E;
+  Regs[0x35] = 0x05;
+  Put16( 0x36, 4 );
+  Put16( 0x3A, -12800 + 4 );
+  Put16( 0x3C, 200 );
+  Put16( 0x3E, 900 );
+  Put16( 0x28, -6000 );
+  Put16( 0x2A, 500 );
+
+  memset( &Combo, 0, sizeof( Combo ) );
+  memset( &Hum, 0, sizeof( Hum ) );
+  memset( &Temp, 0, sizeof( Temp ) );
+  Hum.who_am_i = HTS221_WHO_AM_I_VAL;
+  Hum.pData = &HumData;
+  Hum.pVTable = &HTS221_H_Drv;
+  Temp.who_am_i = HTS221_WHO_AM_I_VAL;
+  Temp.pData = &TempData;
+  Temp.pVTable = &HTS221_T_Drv;
+}
+
+static void test_init_reads_calibration_once( void )
+{
+  SetupSensor( );
+  ResetCounters( );
+  UT_ASSERT_EQ( HTS221_H_Drv.Init( &Hum ), COMPONENT_OK );
+  UT_ASSERT_EQ( HTS221_T_Drv.Init( &Temp ), COMPONENT_OK );
+  /* The calibration is read in one burst, shared by both sensors */
+  UT_ASSERT_EQ( Reads, 5 );
+}
+
+static void test_one_transaction_per_measurement( void )
+{
+  float humidity = 0;
+  float temperature = 0;
+
+  SetupSensor( );
+  HTS221_H_Drv.Init( &Hum );
+  HTS221_T_Drv.Init( &Temp );
+
+  ResetCounters( );
+  UT_ASSERT_EQ( HTS221_H_Drv.Get_Hum( &Hum, &humidity ), COMPONENT_OK );
+  UT_ASSERT_EQ( Reads, 1 );
+  UT_ASSERT_EQ( lroundf( humidity * 10 ), 464 );
+
+  ResetCounters( );
+  UT_ASSERT_EQ( HTS221_T_Drv.Get_Temp( &Temp, &temperature ), COMPONENT_OK );
+  UT_ASSERT_EQ( Reads, 1 );
+  UT_ASSERT_EQ( lroundf( temperature * 10 ), 473 );
+
+  ResetCounters( );
+  humidity = temperature = 0;
+  UT_ASSERT_EQ( HTS221_H_Get_Hum_Temp( &Hum, &humidity, &temperature ), COMPONENT_OK );
+  UT_ASSERT_EQ( Reads, 1 );
+  UT_ASSERT_EQ( lroundf( humidity * 10 ), 464 );
+  UT_ASSERT_EQ( lroundf( temperature * 10 ), 473 );
+  UT_ASSERT_EQ( Writes, 0 );
+}
+
+static void test_async_measurement( void )
+{
+  SensorBusTransfer_t transfer;
+  uint8_t buffer[HTS221_HUM_TEMP_ASYNC_SIZE];
+  float humidity = 0;
+  float temperature = 0;
+
+  SetupSensor( );
+  HTS221_H_Drv.Init( &Hum );
+
+  memset( &transfer, 0, sizeof( transfer ) );
+  ResetCounters( );
+  UT_ASSERT_EQ( HTS221_H_Get_Hum_Temp_Async( &Hum, &transfer, buffer ), COMPONENT_OK );
+  SensorBus_TransferComplete( COMPONENT_OK );
+  UT_ASSERT_EQ( Reads, 1 );
+  UT_ASSERT( !SensorBus_IsBusy( ) );
+  UT_ASSERT_EQ( HTS221_H_Decode_Hum_Temp( &Hum, buffer, &humidity, &temperature ), COMPONENT_OK );
+  UT_ASSERT_EQ( lroundf( humidity * 10 ), 464 );
+  UT_ASSERT_EQ( lroundf( temperature * 10 ), 473 );
+
+  /* Only the humidity handle owns the combined read */
+  UT_ASSERT_EQ( HTS221_H_Get_Hum_Temp_Async( &Temp, &transfer, buffer ), COMPONENT_ERROR );
+}
+
+static void test_low_level_measurement( void )
+{
+  uint16_t humidity = 0;
+  int16_t temperature = 0;
+
+  SetupSensor( );
+
+  /* Without the cached calibration, each read also fetches it */
+  ResetCounters( );
+  UT_ASSERT_EQ( HTS221_Get_Humidity( NULL, &humidity ), HTS221_OK );
+  UT_ASSERT_EQ( Reads, 2 );
+  UT_ASSERT_EQ( humidity, 464 );
+
+  ResetCounters( );
+  UT_ASSERT_EQ( HTS221_Get_Temperature( NULL, &temperature ), HTS221_OK );
+  UT_ASSERT_EQ( Reads, 2 );
+  UT_ASSERT_EQ( temperature, 473 );
+
+  ResetCounters( );
+  humidity = 0;
+  temperature = 0;
+  UT_ASSERT_EQ( HTS221_Get_Measurement( NULL, &humidity, &temperature ), HTS221_OK );
+  UT_ASSERT_EQ( Reads, 2 );
+  UT_ASSERT_EQ( humidity, 464 );
+  UT_ASSERT_EQ( temperature, 473 );
+}
+
+/* Fixed point conversion within 0.1 unit of the interpolation in double */
+static void test_conversion_accuracy( void )
+{
+  HTS221_Calibration_st calibration;
+  double worstHum = 0;
+  double worstTemp = 0;
+
+  srand( 41 );
+  for( int run = 0; run < CALIBRATION_RUNS; run++ )
+  {
+    int h0 = rand( ) % 100;
+    int h1 = h0 + 20 + rand( ) % 100;
+    int t0 = rand( ) % 300;
+    int t1 = t0 + 40 + rand( ) % 400;
+    int16_t h0Out = rand( ) % 20000 - 10000;
+    int16_t h1Out = h0Out - ( 2000 + rand( ) % 20000 );
+    int16_t t0Out = rand( ) % 1000 - 500;
+    int16_t t1Out = t0Out + 200 + rand( ) % 800;
+
+    if( h1 > 255 )
+    {
+      h1 = 255;
+    }
+    if( t1 > 1023 )
+    {
+      t1 = 1023;
+    }
+    if( rand( ) & 1 )
+    {
+      int16_t swap = h0Out;
+      h0Out = h1Out;
+      h1Out = swap;
+    }
+
+    Regs[0x30] = h0;
+    Regs[0x31] = h1;
+    Regs[0x32] = t0 & 0xFF;
+    Regs[0x33] = t1 & 0xFF;
+    Regs[0x35] = ( ( t0 >> 8 ) & 3 ) | ( ( ( t1 >> 8 ) & 3 ) << 2 );
+    Put16( 0x36, h0Out );
+    Put16( 0x3A, h1Out );
+    Put16( 0x3C, t0Out );
+    Put16( 0x3E, t1Out );
+    UT_ASSERT_EQ( HTS221_Get_Calibration( NULL, &calibration ), HTS221_OK );
+
+    int16_t raw = rand( ) % 65536 - 32768;
+    double hum = ( ( ( double )raw - h0Out ) * ( h1 - h0 ) / 2.0 / ( ( double )h1Out - h0Out ) + h0 / 2.0 ) * 10;
+    double temp = ( ( ( double )raw - t0Out ) * ( t1 - t0 ) / 8.0 / ( ( double )t1Out - t0Out ) + t0 / 8.0 ) * 10;
+    hum = fmin( fmax( hum, 0 ), 1000 );
+    temp = fmin( fmax( temp, -32768 ), 32767 );
+
+    worstHum = fmax( worstHum, fabs( HTS221_Calc_Humidity( &calibration, raw ) - hum ) );
+    worstTemp = fmax( worstTemp, fabs( HTS221_Calc_Temperature( &calibration, raw ) - temp ) );
+  }
+
+  printf( "  worst error: humidity %.3f, temperature %.3f (0.1 units)\n", worstHum, worstTemp );
+  UT_ASSERT( worstHum < 1.0 );
+  UT_ASSERT( worstTemp < 1.0 );
+}
+
+int main( void )
+{
+  UT_RUN( test_init_reads_calibration_once );
+  UT_RUN( test_one_transaction_per_measurement );
+  UT_RUN( test_async_measurement );
+  UT_RUN( test_low_level_measurement );
+  UT_RUN( test_conversion_accuracy );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
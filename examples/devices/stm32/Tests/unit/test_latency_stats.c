@@ -0,0 +1,301 @@
+/**
+  ******************************************************************************
+  * @file    test_latency_stats.c
+  * @author  MCD Application Team
+  * @brief   Latency statistics built with LATENCY_STATS=1: lateness histogram
+  *          bins, timer slack not counted as lateness, execution time probes
+  *          on the host cycle counter, and MIB_LATENCY_STATS get and reset
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <time.h>
+#include "hw.h"
+#include "timeServer.h"
+#include "LoRaMac.h"
+#include "latency_stats.h"
+#include "trace.h"
+#include "energy_meter.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Real time spent in the callback of the probe case */
+#define BUSY_WAIT_US          2000
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static TimerEvent_t TimerA;
+static TimerEvent_t TimerB;
+static uint32_t FiredA;
+static uint32_t FiredB;
+
+static uint32_t NbProcess;
+
+/* Private functions ---------------------------------------------------------*/
+static void OnTimerA( void *context )
+{
+  FiredA = HW_RTC_GetTimerValue( );
+}
+
+static void OnTimerB( void *context )
+{
+  FiredB = HW_RTC_GetTimerValue( );
+}
+
+/* Stands for the callback of another timer, only its address is compared */
+static void ( *OtherCallback( uint32_t i ) )( void *context )
+{
+  return ( void ( * )( void *context ) )( uintptr_t )( 0x1000 + i );
+}
+
+static void BusyWait( uint32_t us )
+{
+  struct timespec start;
+  struct timespec now;
+
+  clock_gettime( CLOCK_MONOTONIC, &start );
+  do
+  {
+    clock_gettime( CLOCK_MONOTONIC, &now );
+  } while( ( ( now.tv_sec - start.tv_sec ) * 1000000 + ( now.tv_nsec - start.tv_nsec ) / 1000 ) < us );
+}
+
+static void OnBusyTimer( void *context )
+{
+  BusyWait( BUSY_WAIT_US );
+}
+
+static const LatencyTimerStats_t *FindTimer( void ( *callback )( void *context ) )
+{
+  const LatencyStats_t *stats = LatencyGetStats( );
+
+  for( uint32_t i = 0; i < LATENCY_NB_TIMERS; i++ )
+  {
+    if( stats->Timer[i].Callback == callback )
+    {
+      return &stats->Timer[i];
+    }
+  }
+  return NULL;
+}
+
+static void Setup( void )
+{
+  TimerStop( &TimerA );
+  TimerStop( &TimerB );
+  HostRtcSet( 0 );
+  HW_RTC_SetTimerContext( );
+  HostRtcSetMcuWakeUpTime( 0 );
+  HostRtcSetIrqLatency( 0 );
+  LatencyReset( );
+  FiredA = 0;
+  FiredB = 0;
+}
+
+static void test_histogram_bins( void )
+{
+  static const uint32_t late[] = { 0, 1, 2, 3, 4, 7, 8, 127, 128, 100000 };
+  static const uint16_t hist[LATENCY_HIST_BINS] = { 1, 1, 2, 2, 1, 0, 0, 3 };
+  const LatencyTimerStats_t *timer;
+
+  Setup( );
+  for( uint32_t i = 0; i < sizeof( late ) / sizeof( late[0] ); i++ )
+  {
+    LatencyTimerAdd( OnTimerA, late[i] );
+  }
+  timer = FindTimer( OnTimerA );
+  UT_ASSERT( timer != NULL );
+  UT_ASSERT_MEM( timer->Hist, hist, sizeof( hist ) );
+  UT_ASSERT_EQ( timer->Max, 100000 );
+
+  /* a bin saturates instead of wrapping */
+  for( uint32_t i = 0; i < UINT16_MAX + 10; i++ )
+  {
+    LatencyTimerAdd( OnTimerB, 5 );
+  }
+  UT_ASSERT_EQ( FindTimer( OnTimerB )->Hist[3], UINT16_MAX );
+
+  /* the timers not fitting in the table are counted apart */
+  for( uint32_t i = 0; i < LATENCY_NB_TIMERS; i++ )
+  {
+    LatencyTimerAdd( OtherCallback( i ), 0 );
+  }
+  UT_ASSERT_EQ( LatencyGetStats( )->TimerDropped, 2 );
+  UT_ASSERT( FindTimer( OtherCallback( LATENCY_NB_TIMERS - 3 ) ) != NULL );
+  UT_ASSERT( FindTimer( OtherCallback( LATENCY_NB_TIMERS - 2 ) ) == NULL );
+
+  LatencyReset( );
+  UT_ASSERT( FindTimer( OnTimerA ) == NULL );
+  UT_ASSERT_EQ( LatencyGetStats( )->TimerDropped, 0 );
+}
+
+static void test_slack_not_late( void )
+{
+  const LatencyTimerStats_t *a;
+  const LatencyTimerStats_t *b;
+
+  /* A waits in its slack for the deadline of B, neither is late */
+  Setup( );
+  TimerInit( &TimerA, OnTimerA );
+  TimerSetValue( &TimerA, 1000 );
+  TimerSetSlack( &TimerA, 200 );
+  TimerStart( &TimerA );
+  TimerInit( &TimerB, OnTimerB );
+  TimerSetValue( &TimerB, 1100 );
+  TimerStart( &TimerB );
+  HostRtcRun( 2000 );
+  UT_ASSERT_EQ( FiredA, 1100 );
+  UT_ASSERT_EQ( FiredB, 1100 );
+  a = FindTimer( OnTimerA );
+  b = FindTimer( OnTimerB );
+  UT_ASSERT( ( a != NULL ) && ( b != NULL ) );
+  UT_ASSERT_EQ( a->Hist[0], 1 );
+  UT_ASSERT_EQ( a->Max, 0 );
+  UT_ASSERT_EQ( b->Hist[0], 1 );
+  UT_ASSERT_EQ( b->Max, 0 );
+
+  /* the IRQ latency past the alarm is */
+  Setup( );
+  HostRtcSetIrqLatency( 5 );
+  TimerStart( &TimerA );
+  TimerStart( &TimerB );
+  HostRtcRun( 2000 );
+  HostRtcSetIrqLatency( 0 );
+  UT_ASSERT_EQ( FiredA, 1105 );
+  a = FindTimer( OnTimerA );
+  b = FindTimer( OnTimerB );
+  UT_ASSERT( ( a != NULL ) && ( b != NULL ) );
+  UT_ASSERT_EQ( a->Hist[3], 1 );
+  UT_ASSERT_EQ( a->Max, 5 );
+  UT_ASSERT_EQ( b->Hist[3], 1 );
+  UT_ASSERT_EQ( b->Max, 5 );
+}
+
+static void test_probes( void )
+{
+  const LatencyProbeStats_t *probe = &LatencyGetStats( )->Probe[LATENCY_TIMER_CB];
+  uint32_t minCycles = ( uint32_t )( ( uint64_t )SystemCoreClock * BUSY_WAIT_US / 1000000 );
+  uint32_t start;
+
+  Setup( );
+  LatencyProbeAdd( LATENCY_RADIO_DIO0, 300 );
+  LatencyProbeAdd( LATENCY_RADIO_DIO0, 100 );
+  UT_ASSERT_EQ( LatencyGetStats( )->Probe[LATENCY_RADIO_DIO0].Count, 2 );
+  UT_ASSERT_EQ( LatencyGetStats( )->Probe[LATENCY_RADIO_DIO0].Total, 400 );
+  UT_ASSERT_EQ( LatencyGetStats( )->Probe[LATENCY_RADIO_DIO0].Max, 300 );
+
+  /* the host cycle counter runs with the execution, not the virtual RTC */
+  start = LatencyGetCycles( );
+  BusyWait( BUSY_WAIT_US );
+  UT_ASSERT( LatencyGetCycles( ) - start >= minCycles );
+
+  TimerInit( &TimerA, OnBusyTimer );
+  TimerSetValue( &TimerA, 100 );
+  TimerStart( &TimerA );
+  UT_ASSERT_EQ( LatencyGetStats( )->Probe[LATENCY_IRQOFF_TIMER_START].Count, 1 );
+  HostRtcRun( 200 );
+  UT_ASSERT_EQ( probe->Count, 1 );
+  UT_ASSERT( probe->Max >= minCycles );
+  UT_ASSERT_EQ( probe->Total, probe->Max );
+  printf( "  busy callback: %u cycles for %u us at %u Hz\n",
+          ( unsigned )probe->Max, ( unsigned )BUSY_WAIT_US, ( unsigned )SystemCoreClock );
+}
+
+/* MAC callbacks */
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void NvmContextChange( LoRaMacNvmCtxModule_t module )
+{
+}
+
+static void MacProcessNotify( void )
+{
+}
+
+static LoRaMacPrimitives_t Primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+static LoRaMacCallback_t Callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmContextChange, MacProcessNotify };
+
+static void test_mib_latency_stats( void )
+{
+  MibRequestConfirm_t mibReq;
+  const LatencyStats_t *stats;
+
+  Setup( );
+  UT_ASSERT_EQ( LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 ), LORAMAC_STATUS_OK );
+  LoRaMacStart( );
+  for( NbProcess = 0; NbProcess < 3; NbProcess++ )
+  {
+    LoRaMacProcess( );
+  }
+  LatencyTimerAdd( OnTimerA, 20 );
+
+  mibReq.Type = MIB_LATENCY_STATS;
+  UT_ASSERT_EQ( LoRaMacMibGetRequestConfirm( &mibReq ), LORAMAC_STATUS_OK );
+  stats = ( const LatencyStats_t * )mibReq.Param.LatencyStats;
+  UT_ASSERT( stats == LatencyGetStats( ) );
+  UT_ASSERT_EQ( stats->Probe[LATENCY_MAC_PROCESS].Count, NbProcess );
+  UT_ASSERT_EQ( FindTimer( OnTimerA )->Hist[5], 1 );
+
+  /* any set resets them */
+  mibReq.Type = MIB_LATENCY_STATS;
+  UT_ASSERT_EQ( LoRaMacMibSetRequestConfirm( &mibReq ), LORAMAC_STATUS_OK );
+  UT_ASSERT_EQ( stats->Probe[LATENCY_MAC_PROCESS].Count, 0 );
+  UT_ASSERT_EQ( stats->Probe[LATENCY_MAC_PROCESS].Max, 0 );
+  UT_ASSERT( FindTimer( OnTimerA ) == NULL );
+
+  LoRaMacProcess( );
+  UT_ASSERT_EQ( stats->Probe[LATENCY_MAC_PROCESS].Count, 1 );
+}
+
+int main( void )
+{
+  TraceInit( );
+  EnergyInit( );
+  LatencyInit( );
+
+  UT_RUN( test_histogram_bins );
+  UT_RUN( test_slack_not_late );
+  UT_RUN( test_probes );
+  UT_RUN( test_mib_latency_stats );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,289 @@
+/**
+  ******************************************************************************
+  * @file    test_low_power.c
+  * @author  MCD Application Team
+  * @brief   Low power mode choice of low_power_manager.c on the virtual RTC:
+  *          break-even times against the next timer deadline, MCU wake-up
+  *          time, vetoes and residency statistics
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "hw.h"
+#include "utilities_conf.h"
+#include "low_power_manager.h"
+#include "timeServer.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Break-even times of the costs of utilities_conf.h, in ms:
+   9000 nJ / (3000 - 5) uW and (400000 - 9000) nJ / (5 - 2) uW, rounded up */
+#define STOP_BREAK_EVEN       4
+#define OFF_BREAK_EVEN        130334
+
+/* Idle periods recorded by the energy comparison */
+#define MAX_IDLE              16
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static TimerEvent_t Timer;
+static uint32_t TimerFired;
+
+/* Mode entered by the last LPM_EnterLowPower */
+static int32_t ModeEntered;
+
+/* Idle periods since Setup, in ms, and the mode they were spent in */
+static uint32_t IdleTime[MAX_IDLE];
+static LPM_GetMode_t IdleMode[MAX_IDLE];
+static uint32_t NbIdle;
+
+/* Private functions ---------------------------------------------------------*/
+static void OnTimer( void *context )
+{
+  TimerFired++;
+}
+
+/* The MCU sleeps until the RTC alarm wakes it up */
+static void Sleep( LPM_GetMode_t mode )
+{
+  uint32_t alarm;
+
+  ModeEntered = mode;
+  if( HostRtcGetAlarm( &alarm ) == true )
+  {
+    if( NbIdle < MAX_IDLE )
+    {
+      IdleTime[NbIdle] = HW_RTC_Tick2ms( alarm - HW_RTC_GetTimerValue( ) );
+      IdleMode[NbIdle] = mode;
+    }
+    NbIdle++;
+    HostRtcRun( alarm - HW_RTC_GetTimerValue( ) );
+  }
+}
+
+void LPM_EnterSleepMode( void )
+{
+  Sleep( LPM_SleepMode );
+}
+
+void LPM_EnterStopMode( void )
+{
+  Sleep( LPM_StopMode );
+}
+
+void LPM_EnterOffMode( void )
+{
+  Sleep( LPM_OffMode );
+}
+
+static void Setup( void )
+{
+  TimerStop( &Timer );
+  HostRtcSet( 0 );
+  HostRtcSetMcuWakeUpTime( 0 );
+  LPM_SetStopMode( LPM_APPLI_Id, LPM_Enable );
+  LPM_SetOffMode( LPM_APPLI_Id, LPM_Enable );
+  LPM_ResetStats( );
+  TimerFired = 0;
+  ModeEntered = -1;
+  NbIdle = 0;
+}
+
+/* Enters low power with the next timer deadline ms away, returns the mode */
+static int32_t EnterWithDeadline( uint32_t ms )
+{
+  TimerSetValue( &Timer, ms );
+  TimerStart( &Timer );
+  LPM_EnterLowPower( );
+  return ModeEntered;
+}
+
+static void test_break_even_times( void )
+{
+  UT_ASSERT_EQ( LPM_GetBreakEvenTime( LPM_SleepMode ), 0 );
+  UT_ASSERT_EQ( LPM_GetBreakEvenTime( LPM_StopMode ), STOP_BREAK_EVEN );
+  UT_ASSERT_EQ( LPM_GetBreakEvenTime( LPM_OffMode ), OFF_BREAK_EVEN );
+}
+
+static void test_mode_from_deadline( void )
+{
+  static const struct
+  {
+    uint32_t Deadline;
+    LPM_GetMode_t Mode;
+  } expected[] =
+  {
+    { 1, LPM_SleepMode },
+    { STOP_BREAK_EVEN - 1, LPM_SleepMode },
+    { STOP_BREAK_EVEN, LPM_StopMode },
+    { 1000, LPM_StopMode },
+    { OFF_BREAK_EVEN - 1, LPM_StopMode },
+    { OFF_BREAK_EVEN, LPM_OffMode },
+    { 3600000, LPM_OffMode },
+  };
+
+  for( uint32_t i = 0; i < sizeof( expected ) / sizeof( expected[0] ); i++ )
+  {
+    Setup( );
+    UT_ASSERT_EQ( EnterWithDeadline( expected[i].Deadline ), expected[i].Mode );
+
+    /* woken up by the timer */
+    UT_ASSERT_EQ( TimerFired, 1 );
+  }
+
+  /* no timer pending: nothing to amortize against */
+  Setup( );
+  LPM_EnterLowPower( );
+  UT_ASSERT_EQ( ModeEntered, LPM_OffMode );
+}
+
+static void test_wake_up_time( void )
+{
+  /* 3 ms to restore the clocks out of stop are not spent idle */
+  Setup( );
+  HostRtcSetMcuWakeUpTime( 3 );
+  UT_ASSERT_EQ( EnterWithDeadline( STOP_BREAK_EVEN + 2 ), LPM_SleepMode );
+  Setup( );
+  HostRtcSetMcuWakeUpTime( 3 );
+  UT_ASSERT_EQ( EnterWithDeadline( STOP_BREAK_EVEN + 3 ), LPM_StopMode );
+  Setup( );
+  HostRtcSetMcuWakeUpTime( 3 );
+  UT_ASSERT_EQ( EnterWithDeadline( OFF_BREAK_EVEN + 2 ), LPM_StopMode );
+  Setup( );
+  HostRtcSetMcuWakeUpTime( 3 );
+  UT_ASSERT_EQ( EnterWithDeadline( OFF_BREAK_EVEN + 3 ), LPM_OffMode );
+}
+
+static void test_vetoes( void )
+{
+  /* the vetoes cap the mode, the deadline never deepens it */
+  Setup( );
+  LPM_SetOffMode( LPM_APPLI_Id, LPM_Disable );
+  UT_ASSERT_EQ( EnterWithDeadline( 3600000 ), LPM_StopMode );
+  UT_ASSERT_EQ( EnterWithDeadline( 1 ), LPM_SleepMode );
+
+  Setup( );
+  LPM_SetStopMode( LPM_APPLI_Id, LPM_Disable );
+  UT_ASSERT_EQ( EnterWithDeadline( 3600000 ), LPM_SleepMode );
+  LPM_SetStopMode( LPM_APPLI_Id, LPM_Enable );
+  UT_ASSERT_EQ( EnterWithDeadline( 3600000 ), LPM_OffMode );
+}
+
+static void test_stats( void )
+{
+  LPM_Stats_t stats;
+
+  Setup( );
+  EnterWithDeadline( 3 );
+  EnterWithDeadline( 10 );
+  EnterWithDeadline( 20 );
+  EnterWithDeadline( OFF_BREAK_EVEN );
+  LPM_GetStats( &stats );
+
+  UT_ASSERT_EQ( stats.Entries[LPM_SleepMode], 1 );
+  UT_ASSERT_EQ( stats.Entries[LPM_StopMode], 2 );
+  UT_ASSERT_EQ( stats.Entries[LPM_OffMode], 1 );
+  UT_ASSERT_EQ( stats.Residency[LPM_SleepMode], HW_RTC_ms2Tick( 3 ) );
+  UT_ASSERT_EQ( stats.Residency[LPM_StopMode], HW_RTC_ms2Tick( 30 ) );
+  UT_ASSERT_EQ( stats.Residency[LPM_OffMode], HW_RTC_ms2Tick( OFF_BREAK_EVEN ) );
+
+  /* off mode allowed each time: sleep is 2 steps back, stop 1 step */
+  UT_ASSERT_EQ( stats.Demotions, 4 );
+
+  LPM_ResetStats( );
+  LPM_GetStats( &stats );
+  UT_ASSERT_EQ( stats.Entries[LPM_StopMode], 0 );
+  UT_ASSERT_EQ( stats.Demotions, 0 );
+}
+
+/* Energy of an idle period in a mode, in nJ, with the costs of utilities_conf.h */
+static uint64_t IdleEnergy( LPM_GetMode_t mode, uint32_t ms )
+{
+  switch( mode )
+  {
+    case LPM_SleepMode:
+      return ( uint64_t )LPM_SLEEP_POWER_UW * ms;
+    case LPM_StopMode:
+      return LPM_STOP_TRANSITION_NJ + ( uint64_t )LPM_STOP_POWER_UW * ms;
+    default:
+      return LPM_OFF_TRANSITION_NJ + ( uint64_t )LPM_OFF_POWER_UW * ms;
+  }
+}
+
+/* Timer deadlines of a class A uplink, in ms: radio wake-up, time on air,
+   RX1 delay, RX1 window, RX2 delay, RX2 window, then the TxTimer of the
+   application closes the period */
+static void UplinkEnergy( uint32_t txPeriod, uint64_t *governor, uint64_t *deepest )
+{
+  static const uint32_t deadlines[] = { 2, 62, 990, 25, 975, 40 };
+  uint32_t elapsed = 0;
+
+  Setup( );
+  for( uint32_t i = 0; i < sizeof( deadlines ) / sizeof( deadlines[0] ); i++ )
+  {
+    EnterWithDeadline( deadlines[i] );
+    elapsed += deadlines[i];
+  }
+  EnterWithDeadline( txPeriod - elapsed );
+  UT_ASSERT_EQ( NbIdle, sizeof( deadlines ) / sizeof( deadlines[0] ) + 1 );
+
+  /* the same idle periods, spent in the mode of the governor or always in
+     the deepest mode the vetoes allow */
+  *governor = 0;
+  *deepest = 0;
+  for( uint32_t i = 0; i < NbIdle; i++ )
+  {
+    *governor += IdleEnergy( IdleMode[i], IdleTime[i] );
+    *deepest += IdleEnergy( LPM_GetMode( ), IdleTime[i] );
+  }
+}
+
+static void test_energy_against_deepest( void )
+{
+  /* the TxTimer of End_Node, and a sparse uplink beyond the off break-even */
+  static const uint32_t txPeriods[] = { 10000, 600000 };
+  uint64_t governor;
+  uint64_t deepest;
+
+  for( uint32_t i = 0; i < sizeof( txPeriods ) / sizeof( txPeriods[0] ); i++ )
+  {
+    UplinkEnergy( txPeriods[i], &governor, &deepest );
+    printf( "  uplink every %u ms: %u uJ with the governor, %u uJ always in off mode\n",
+            ( unsigned )txPeriods[i], ( unsigned )( governor / 1000 ), ( unsigned )( deepest / 1000 ) );
+    UT_ASSERT( governor <= deepest );
+  }
+
+  /* the short waits are worth no transition, the long one is spent off */
+  UT_ASSERT_EQ( IdleMode[0], LPM_SleepMode );
+  UT_ASSERT_EQ( IdleMode[2], LPM_StopMode );
+  UT_ASSERT_EQ( IdleMode[NbIdle - 1], LPM_OffMode );
+}
+
+int main( void )
+{
+  TimerInit( &Timer, OnTimer );
+
+  UT_RUN( test_break_even_times );
+  UT_RUN( test_mode_from_deadline );
+  UT_RUN( test_wake_up_time );
+  UT_RUN( test_vetoes );
+  UT_RUN( test_stats );
+  UT_RUN( test_energy_against_deepest );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
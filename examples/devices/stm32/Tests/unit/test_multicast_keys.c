@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+  * @file    test_multicast_keys.c
+  * @author  MCD Application Team
+  * @brief   Multicast group keys of the MAC on the virtual radio: a root key
+  *          set through MIB_MC_GROUP_KEYS is decrypted with the McKEKey,
+  *          stored, and its session keys authenticate the group downlinks
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "LoRaMac.h"
+#include "aes.h"
+#include "cmac.h"
+#include "host_radio.h"
+#include "trace.h"
+#include "energy_meter.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR              0x26011B01
+#define MC_ADDR               0x2601F0F0
+#define MC_PORT               10
+
+/* Beyond the 4 groups of the fixed MIB_MC_KEY_x */
+#define MC_GROUP              ( ( AddressIdentifier_t )( LORAMAC_MAX_MC_CTX - 1 ) )
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t SessionKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+static uint8_t McKEKey[16] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+                               0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10 };
+/* Root key of the group as provisioned, encrypted with the McKEKey */
+static uint8_t McKeyEncrypted[16] = { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+                                      0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF };
+
+static bool ProcessPending;
+static uint32_t SeNvmChanges;
+
+static bool Indicated;
+static McpsIndication_t Indication;
+static uint8_t IndicationBuffer[242];
+
+/* Private functions ---------------------------------------------------------*/
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  if( mcpsIndication->Status != LORAMAC_EVENT_INFO_STATUS_OK )
+  {
+    return;
+  }
+  Indicated = true;
+  Indication = *mcpsIndication;
+  memcpy( IndicationBuffer, mcpsIndication->Buffer, mcpsIndication->BufferSize );
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void NvmContextChange( LoRaMacNvmCtxModule_t module )
+{
+  if( module == LORAMAC_NVMCTXMODULE_SECURE_ELEMENT )
+  {
+    SeNvmChanges++;
+  }
+}
+
+static void MacProcessNotify( void )
+{
+  ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+static LoRaMacCallback_t Callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmContextChange, MacProcessNotify };
+
+/* Runs the MAC on the virtual clock */
+static void Run( uint32_t ms )
+{
+  while( ms-- > 0 )
+  {
+    HostRtcRun( 1 );
+    if( ProcessPending == true )
+    {
+      ProcessPending = false;
+      LoRaMacProcess( );
+    }
+  }
+}
+
+static void MibSet( MibRequestConfirm_t *mibReq )
+{
+  UT_ASSERT_EQ( LoRaMacMibSetRequestConfirm( mibReq ), LORAMAC_STATUS_OK );
+}
+
+/* ABP session of lora.c, in LoRaWAN 1.0.3 */
+static void Setup( void )
+{
+  MibRequestConfirm_t mibReq;
+  MulticastChannel_t channel = { 0 };
+
+  HostRadioReset( 1 );
+  UT_ASSERT_EQ( LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 ), LORAMAC_STATUS_OK );
+
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_F_NWK_S_INT_KEY;
+  mibReq.Param.FNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_S_NWK_S_INT_KEY;
+  mibReq.Param.SNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NWK_S_ENC_KEY;
+  mibReq.Param.NwkSEncKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_APP_S_KEY;
+  mibReq.Param.AppSKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+  mibReq.Param.AbpLrWanVersion.Value = 0x01000300;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_MC_KE_KEY;
+  mibReq.Param.McKEKey = McKEKey;
+  MibSet( &mibReq );
+
+  channel.AddrID = MC_GROUP;
+  channel.Address = MC_ADDR;
+  channel.IsEnabled = true;
+  channel.Frequency = 869525000;
+  channel.Datarate = DR_0;
+  UT_ASSERT_EQ( LoRaMacMulticastChannelSet( channel ), LORAMAC_STATUS_OK );
+
+  LoRaMacStart( );
+  Indicated = false;
+}
+
+static void SetGroupKeys( uint8_t *mcKey, uint8_t *mcAppSKey, uint8_t *mcNwkSKey )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_MC_GROUP_KEYS;
+  mibReq.Param.McGroupKeys.AddrID = MC_GROUP;
+  mibReq.Param.McGroupKeys.McKey = mcKey;
+  mibReq.Param.McGroupKeys.McAppSKey = mcAppSKey;
+  mibReq.Param.McGroupKeys.McNwkSKey = mcNwkSKey;
+  MibSet( &mibReq );
+}
+
+static void Aes( const uint8_t *key, const uint8_t *in, uint8_t *out )
+{
+  aes_context ctx;
+
+  aes_set_key( key, 16, &ctx );
+  aes_encrypt( in, out, &ctx );
+}
+
+/* Session key of the group: aes128_encrypt( McKey, type | McAddr | pad16 ) */
+static void DeriveSessionKey( const uint8_t *mcKey, uint8_t type, uint8_t *key )
+{
+  uint8_t block[16] = { type, MC_ADDR & 0xFF, ( MC_ADDR >> 8 ) & 0xFF,
+                        ( MC_ADDR >> 16 ) & 0xFF, ( MC_ADDR >> 24 ) & 0xFF };
+
+  Aes( mcKey, block, key );
+}
+
+/* Unconfirmed downlink of the group, built by the network server with the
+   session keys derived from the root key given */
+static uint8_t BuildDownlink( const uint8_t *mcKey, uint32_t fCnt, const uint8_t *data, uint8_t size, uint8_t *frame )
+{
+  uint8_t appSKey[16];
+  uint8_t nwkSKey[16];
+  uint8_t block[16];
+  uint8_t stream[16];
+  uint8_t mic[16];
+  AES_CMAC_CTX cmac;
+  uint8_t len = 0;
+
+  DeriveSessionKey( mcKey, 0x01, appSKey );
+  DeriveSessionKey( mcKey, 0x02, nwkSKey );
+
+  frame[len++] = 0x60;
+  frame[len++] = MC_ADDR & 0xFF;
+  frame[len++] = ( MC_ADDR >> 8 ) & 0xFF;
+  frame[len++] = ( MC_ADDR >> 16 ) & 0xFF;
+  frame[len++] = ( MC_ADDR >> 24 ) & 0xFF;
+  frame[len++] = 0x00;
+  frame[len++] = fCnt & 0xFF;
+  frame[len++] = ( fCnt >> 8 ) & 0xFF;
+  frame[len++] = MC_PORT;
+
+  /* FRMPayload: A_i = 0x01 | 0x00000000 | dir | DevAddr | FCnt | 0x00 | i */
+  for( uint8_t i = 0; i < size; i += 16 )
+  {
+    uint8_t a[16] = { 0x01, 0, 0, 0, 0, 0x01, MC_ADDR & 0xFF, ( MC_ADDR >> 8 ) & 0xFF,
+                      ( MC_ADDR >> 16 ) & 0xFF, ( MC_ADDR >> 24 ) & 0xFF, fCnt & 0xFF,
+                      ( fCnt >> 8 ) & 0xFF, ( fCnt >> 16 ) & 0xFF, ( fCnt >> 24 ) & 0xFF, 0, ( i / 16 ) + 1 };
+
+    Aes( appSKey, a, stream );
+    for( uint8_t j = i; ( j < size ) && ( j < i + 16 ); j++ )
+    {
+      frame[len + j] = data[j] ^ stream[j - i];
+    }
+  }
+  len += size;
+
+  /* MIC: cmac( NwkSKey, B0 | msg ), B0 = 0x49 | 0x00000000 | dir | DevAddr | FCnt | 0x00 | len */
+  memset( block, 0, sizeof( block ) );
+  block[0] = 0x49;
+  block[5] = 0x01;
+  memcpy( &block[6], &frame[1], 4 );
+  block[10] = fCnt & 0xFF;
+  block[11] = ( fCnt >> 8 ) & 0xFF;
+  block[12] = ( fCnt >> 16 ) & 0xFF;
+  block[13] = ( fCnt >> 24 ) & 0xFF;
+  block[15] = len;
+  AES_CMAC_Init( &cmac );
+  AES_CMAC_SetKey( &cmac, nwkSKey );
+  AES_CMAC_Update( &cmac, block, sizeof( block ) );
+  AES_CMAC_Update( &cmac, frame, len );
+  AES_CMAC_Final( mic, &cmac );
+  memcpy( &frame[len], mic, 4 );
+
+  return len + 4;
+}
+
+/* Sends an uplink and runs its reception windows, the frame queued is
+   received in the first one */
+static void UplinkWithDownlink( const uint8_t *frame, uint8_t size )
+{
+  McpsReq_t mcpsReq;
+  uint8_t data = 0;
+
+  UT_ASSERT( HostRadioQueueRx( 0, frame, size, -60, 8 ) );
+
+  mcpsReq.Type = MCPS_UNCONFIRMED;
+  mcpsReq.Req.Unconfirmed.fPort = 2;
+  mcpsReq.Req.Unconfirmed.fBuffer = &data;
+  mcpsReq.Req.Unconfirmed.fBufferSize = 1;
+  mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+  UT_ASSERT_EQ( LoRaMacMcpsRequest( &mcpsReq ), LORAMAC_STATUS_OK );
+  Run( 5000 );
+}
+
+static RxDropStats_t DropStats( void )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_RX_DROP_STATS;
+  LoRaMacMibGetRequestConfirm( &mibReq );
+  return mibReq.Param.RxDropStats;
+}
+
+static void test_group_key_authenticates_downlink( void )
+{
+  static const uint8_t data[] = "group actuation";
+  uint8_t mcKey[16];
+  uint8_t frame[64];
+  uint8_t size;
+
+  Setup( );
+  SeNvmChanges = 0;
+  SetGroupKeys( McKeyEncrypted, NULL, NULL );
+
+  /* the root key and both derived session keys are stored */
+  UT_ASSERT_EQ( SeNvmChanges, 3 );
+
+  /* McKey = aes128_encrypt( McKEKey, McKey_encrypted ) */
+  Aes( McKEKey, McKeyEncrypted, mcKey );
+  size = BuildDownlink( mcKey, 1, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+
+  UT_ASSERT( Indicated );
+  UT_ASSERT_EQ( Indication.Multicast, 1 );
+  UT_ASSERT_EQ( Indication.Port, MC_PORT );
+  UT_ASSERT_EQ( Indication.DevAddress, MC_ADDR );
+  UT_ASSERT_EQ( Indication.BufferSize, sizeof( data ) );
+  UT_ASSERT_MEM( IndicationBuffer, data, sizeof( data ) );
+  UT_ASSERT_EQ( DropStats( ).Mic, 0 );
+}
+
+static void test_undecrypted_key_fails_mic( void )
+{
+  uint8_t data[] = { 0x01 };
+  uint8_t frame[64];
+  uint8_t size;
+
+  Setup( );
+  SetGroupKeys( McKeyEncrypted, NULL, NULL );
+
+  /* a server keying the group with the encrypted root key as such */
+  size = BuildDownlink( McKeyEncrypted, 1, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+
+  UT_ASSERT( !Indicated );
+  UT_ASSERT_EQ( DropStats( ).Mic, 1 );
+}
+
+static void test_session_keys_override( void )
+{
+  uint8_t data[] = { 0x5A, 0xA5 };
+  uint8_t mcKey[16];
+  uint8_t appSKey[16];
+  uint8_t nwkSKey[16];
+  uint8_t frame[64];
+  uint8_t size;
+
+  /* session keys set as such, without a root key */
+  Setup( );
+  Aes( McKEKey, McKeyEncrypted, mcKey );
+  DeriveSessionKey( mcKey, 0x01, appSKey );
+  DeriveSessionKey( mcKey, 0x02, nwkSKey );
+  SetGroupKeys( NULL, appSKey, nwkSKey );
+
+  size = BuildDownlink( mcKey, 1, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+
+  UT_ASSERT( Indicated );
+  UT_ASSERT_EQ( Indication.Multicast, 1 );
+  UT_ASSERT_MEM( IndicationBuffer, data, sizeof( data ) );
+}
+
+int main( void )
+{
+  /* the MAC traces its radio events and accounts their energy */
+  TraceInit( );
+  EnergyInit( );
+
+  UT_RUN( test_group_key_authenticates_downlink );
+  UT_RUN( test_undecrypted_key_fails_mic );
+  UT_RUN( test_session_keys_override );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
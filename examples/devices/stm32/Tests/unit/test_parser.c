@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file    test_parser.c
+  * @author  MCD Application Team
+  * @brief   Bounds checks of the LoRaMac frame parser and serializer: replays
+  *          data/parser_corpus.txt, then parses random frames each held in a
+  *          heap block of its exact size. "make fuzz" runs it under the
+  *          address and undefined behaviour sanitizers with more frames
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include "LoRaMacParser.h"
+#include "LoRaMacSerializer.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CORPUS_FILE           "data/parser_corpus.txt"
+
+/* Random frames of the unit test, overridden by the first argument */
+#define RANDOM_FRAMES         200000
+
+/* MHDR + FHDR without FOpts + MIC */
+#define MIN_DATA_FRAME_SIZE   12
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static long RandomFrames = RANDOM_FRAMES;
+static uint32_t RandState = 7;
+static uint8_t Payload[256];
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Rand( void )
+{
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState;
+}
+
+/* Parses a data frame, checks the fields add up to its size */
+static int ParseData( const uint8_t *buffer, uint16_t size )
+{
+  LoRaMacMessageData_t msg = { 0 };
+  uint16_t fields;
+
+  msg.Buffer = ( uint8_t * )buffer;
+  msg.BufSize = size;
+  msg.FRMPayload = Payload;
+  if( LoRaMacParserData( &msg ) != LORAMAC_PARSER_SUCCESS )
+  {
+    return 0;
+  }
+
+  fields = MIN_DATA_FRAME_SIZE + msg.FHDR.FCtrl.Bits.FOptsLen;
+  if( fields < size )
+  {
+    fields += LORAMAC_F_PORT_FIELD_SIZE + msg.FRMPayloadSize;
+  }
+  UT_ASSERT_EQ( fields, size );
+  return 1;
+}
+
+static int ParseJoinAccept( const uint8_t *buffer, uint16_t size )
+{
+  LoRaMacMessageJoinAccept_t msg = { 0 };
+
+  msg.Buffer = ( uint8_t * )buffer;
+  msg.BufSize = size;
+  return LoRaMacParserJoinAccept( &msg ) == LORAMAC_PARSER_SUCCESS;
+}
+
+/* Copy of the frame in a block of its exact size, for the sanitizers */
+static uint8_t *HeapFrame( const uint8_t *frame, uint16_t size )
+{
+  uint8_t *block = malloc( ( size > 0 ) ? size : 1 );
+
+  memcpy( block, frame, size );
+  return block;
+}
+
+static void test_corpus( void )
+{
+  FILE *f = fopen( CORPUS_FILE, "r" );
+  char line[1024];
+  int frames = 0;
+
+  UT_ASSERT( f != NULL );
+  if( f == NULL )
+  {
+    return;
+  }
+
+  while( fgets( line, sizeof( line ), f ) != NULL )
+  {
+    char kind[8] = "";
+    char expected[8] = "";
+    char hex[600] = "";
+    uint8_t frame[300];
+    uint16_t size = 0;
+    uint8_t *block;
+    int ok;
+
+    if( ( line[0] == '#' ) || ( sscanf( line, "%7s %7s %599s", kind, expected, hex ) < 2 ) )
+    {
+      continue;
+    }
+    for( const char *p = hex; ( p[0] != '\0' ) && ( p[1] != '\0' ); p += 2 )
+    {
+      unsigned int byte;
+      sscanf( p, "%2x", &byte );
+      frame[size++] = ( uint8_t )byte;
+    }
+
+    block = HeapFrame( frame, size );
+    ok = ( strcmp( kind, "join" ) == 0 ) ? ParseJoinAccept( block, size ) : ParseData( block, size );
+    free( block );
+
+    if( ok != ( strcmp( expected, "ok" ) == 0 ) )
+    {
+      printf( "  %s frame of %u bytes: %s, expected %s\n", kind, size, ok ? "ok" : "fail", expected );
+      UtCaseFailures++;
+    }
+    frames++;
+  }
+  fclose( f );
+
+  UT_ASSERT( frames > 0 );
+}
+
+/* A data frame parses if and only if its fixed fields and FOpts fit */
+static void test_random_frames( void )
+{
+  uint8_t frame[256];
+  long data = 0;
+  long joins = 0;
+
+  for( long i = 0; i < RandomFrames; i++ )
+  {
+    uint16_t size = ( i < 256 ) ? i : Rand( ) % 256;
+    uint8_t *block;
+    int dataOk;
+    int joinOk;
+
+    for( uint16_t k = 0; k < size; k++ )
+    {
+      frame[k] = Rand( );
+    }
+    block = HeapFrame( frame, size );
+    dataOk = ParseData( block, size );
+    joinOk = ParseJoinAccept( block, size );
+    free( block );
+
+    UT_ASSERT_EQ( dataOk, ( size >= MIN_DATA_FRAME_SIZE ) &&
+                          ( ( frame[5] & 0x0F ) <= size - MIN_DATA_FRAME_SIZE ) );
+    UT_ASSERT_EQ( joinOk, ( size == LORAMAC_JOIN_ACCEPT_MSG_SIZE ) ||
+                          ( size == LORAMAC_JOIN_ACCEPT_MSG_SIZE + LORAMAC_C_FLIST_FIELD_SIZE ) );
+    if( UtCaseFailures != 0 )
+    {
+      printf( "  frame %ld of %u bytes\n", i, size );
+      return;
+    }
+    data += dataOk;
+    joins += joinOk;
+  }
+  printf( "  %ld frames: %ld data frames and %ld join-accepts parsed\n", RandomFrames, data, joins );
+}
+
+/* The serializer counts the whole frame, MIC included, against the buffer */
+static void test_serializer_bounds( void )
+{
+  uint8_t payload[64];
+
+  for( uint8_t foptsLen = 0; foptsLen <= 15; foptsLen++ )
+  {
+    for( uint8_t payloadSize = 0; payloadSize < sizeof( payload ); payloadSize += 9 )
+    {
+      uint16_t frameSize = MIN_DATA_FRAME_SIZE + foptsLen + ( ( payloadSize > 0 ) ? 1 + payloadSize : 0 );
+      LoRaMacMessageData_t msg = { 0 };
+      LoRaMacMessageData_t parsed = { 0 };
+      uint8_t *block;
+
+      msg.MHDR.Value = 0x40;
+      msg.FHDR.DevAddr = Rand( );
+      msg.FHDR.FCnt = Rand( );
+      msg.FHDR.FCtrl.Bits.FOptsLen = foptsLen;
+      memset( msg.FHDR.FOpts, 0xA5, foptsLen );
+      msg.FPort = 1 + Rand( ) % 200;
+      msg.FRMPayload = payload;
+      msg.FRMPayloadSize = payloadSize;
+      msg.MIC = Rand( );
+
+      /* One byte short */
+      block = malloc( frameSize );
+      msg.Buffer = block;
+      msg.BufSize = frameSize - 1;
+      UT_ASSERT_EQ( LoRaMacSerializerData( &msg ), LORAMAC_SERIALIZER_ERROR_BUF_SIZE );
+
+      msg.BufSize = frameSize;
+      UT_ASSERT_EQ( LoRaMacSerializerData( &msg ), LORAMAC_SERIALIZER_SUCCESS );
+      UT_ASSERT_EQ( msg.BufSize, frameSize );
+
+      parsed.Buffer = block;
+      parsed.BufSize = frameSize;
+      parsed.FRMPayload = Payload;
+      UT_ASSERT_EQ( LoRaMacParserData( &parsed ), LORAMAC_PARSER_SUCCESS );
+      UT_ASSERT_EQ( parsed.FHDR.DevAddr, msg.FHDR.DevAddr );
+      UT_ASSERT_EQ( parsed.FHDR.FCnt, msg.FHDR.FCnt );
+      UT_ASSERT_EQ( parsed.MIC, msg.MIC );
+      UT_ASSERT_EQ( parsed.FRMPayloadSize, payloadSize );
+      if( payloadSize > 0 )
+      {
+        UT_ASSERT_EQ( parsed.FPort, msg.FPort );
+      }
+      free( block );
+    }
+  }
+}
+
+int main( int argc, char **argv )
+{
+  if( argc > 1 )
+  {
+    RandomFrames = atol( argv[1] );
+  }
+
+  UT_RUN( test_corpus );
+  UT_RUN( test_random_frames );
+  UT_RUN( test_serializer_bounds );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
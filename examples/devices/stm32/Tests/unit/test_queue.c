@@ -0,0 +1,310 @@
+/**
+  ******************************************************************************
+  * @file    test_queue.c
+  * @author  MCD Application Team
+  * @brief   Single producer / single consumer ring (queue.c): index handling
+  *          at the wrap, then a stress run with the producer and the consumer
+  *          on two threads checking every record
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include "hw.h"
+#include "queue.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STRESS_QUEUE_SIZE     256
+#define STRESS_RECORDS        2000000
+#define RECORD_HDR            3          /* length, sequence number on 16 bits */
+#define RECORD_MAX            64
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static queue_param_t StressQueue;
+static uint8_t StressBuff[STRESS_QUEUE_SIZE];
+static uint32_t StressErrors;
+static uint32_t StressFull;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t NextRandom( uint32_t *state )
+{
+  *state = *state * 1103515245 + 12345;
+  return *state >> 16;
+}
+
+static void WriteRecord( uint8_t *p, uint8_t len, uint16_t seq )
+{
+  p[0] = len;
+  p[1] = ( uint8_t )seq;
+  p[2] = ( uint8_t )( seq >> 8 );
+  for( uint8_t i = RECORD_HDR; i < len; i++ )
+  {
+    p[i] = ( uint8_t )( seq + i );
+  }
+}
+
+/* Checks the records of a peeked span, returns the number of bytes checked */
+static uint16_t CheckRecords( const uint8_t *p, uint16_t size, uint16_t *seq )
+{
+  uint16_t off = 0;
+
+  while( off < size )
+  {
+    uint8_t len = p[off];
+    uint16_t got = p[off + 1] | ( p[off + 2] << 8 );
+
+    if( ( len < RECORD_HDR ) || ( ( off + len ) > size ) || ( got != *seq ) )
+    {
+      StressErrors++;
+      return size;
+    }
+    for( uint8_t i = RECORD_HDR; i < len; i++ )
+    {
+      if( p[off + i] != ( uint8_t )( got + i ) )
+      {
+        StressErrors++;
+        break;
+      }
+    }
+    ( *seq )++;
+    off += len;
+  }
+  return off;
+}
+
+static void test_reserve_empty_queue( void )
+{
+  queue_param_t q;
+  uint8_t buff[16];
+  uint8_t *p;
+  uint16_t size;
+
+  circular_queue_init( &q, buff, sizeof( buff ) );
+  UT_ASSERT_EQ( circular_queue_sense( &q ), -1 );
+
+  /* read index at 0: one byte is kept free */
+  UT_ASSERT( circular_queue_reserve( &q, 16 ) == NULL );
+  p = circular_queue_reserve( &q, 15 );
+  UT_ASSERT( p == buff );
+  memset( p, 0xAA, 15 );
+  circular_queue_commit( &q, 15 );
+
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT( p == buff );
+  UT_ASSERT_EQ( size, 15 );
+  UT_ASSERT( circular_queue_reserve( &q, 1 ) == NULL );
+}
+
+static void test_commit_less_than_reserved( void )
+{
+  queue_param_t q;
+  uint8_t buff[16];
+  uint8_t *p;
+  uint16_t size;
+
+  circular_queue_init( &q, buff, sizeof( buff ) );
+  p = circular_queue_reserve( &q, 10 );
+  circular_queue_commit( &q, 4 );
+  p = circular_queue_reserve( &q, 4 );
+  UT_ASSERT( p == buff + 4 );
+  circular_queue_commit( &q, 4 );
+
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT_EQ( size, 8 );
+}
+
+static void test_wrap( void )
+{
+  queue_param_t q;
+  uint8_t buff[16];
+  uint8_t *p;
+  uint16_t size;
+
+  circular_queue_init( &q, buff, sizeof( buff ) );
+  circular_queue_reserve( &q, 12 );
+  circular_queue_commit( &q, 12 );
+  circular_queue_peek( &q, &p, &size );
+  circular_queue_release( &q, 8 );
+
+  /* 4 bytes left at the end, not enough: wraps to the start */
+  p = circular_queue_reserve( &q, 5 );
+  UT_ASSERT( p == buff );
+  circular_queue_commit( &q, 5 );
+
+  /* the span before the wrap comes first, then the one after */
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT( p == buff + 8 );
+  UT_ASSERT_EQ( size, 4 );
+  /* write index must not catch up the read index */
+  UT_ASSERT( circular_queue_reserve( &q, 3 ) == NULL );
+  circular_queue_release( &q, size );
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT( p == buff );
+  UT_ASSERT_EQ( size, 5 );
+  circular_queue_release( &q, size );
+  UT_ASSERT_EQ( circular_queue_sense( &q ), -1 );
+}
+
+static void test_exact_fit_at_end( void )
+{
+  queue_param_t q;
+  uint8_t buff[16];
+  uint8_t *p;
+  uint16_t size;
+
+  circular_queue_init( &q, buff, sizeof( buff ) );
+  circular_queue_reserve( &q, 8 );
+  circular_queue_commit( &q, 8 );
+  circular_queue_peek( &q, &p, &size );
+  circular_queue_release( &q, size );
+
+  /* fills the end exactly, the write index goes back to 0 */
+  p = circular_queue_reserve( &q, 8 );
+  UT_ASSERT( p == buff + 8 );
+  circular_queue_commit( &q, 8 );
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT( p == buff + 8 );
+  UT_ASSERT_EQ( size, 8 );
+  circular_queue_release( &q, size );
+  UT_ASSERT_EQ( circular_queue_sense( &q ), -1 );
+}
+
+static void test_reserve_max_splits( void )
+{
+  queue_param_t q;
+  uint8_t buff[16];
+  uint8_t *p;
+  uint16_t size;
+
+  circular_queue_init( &q, buff, sizeof( buff ) );
+  circular_queue_reserve( &q, 12 );
+  circular_queue_commit( &q, 12 );
+  circular_queue_peek( &q, &p, &size );
+  circular_queue_release( &q, 8 );
+  UT_ASSERT_EQ( circular_queue_get_free_size( &q ), 11 );
+
+  /* 4 bytes at the end, then 7 at the start */
+  size = 10;
+  p = circular_queue_reserve_max( &q, &size );
+  UT_ASSERT( p == buff + 12 );
+  UT_ASSERT_EQ( size, 4 );
+  circular_queue_commit( &q, size );
+  size = 6;
+  p = circular_queue_reserve_max( &q, &size );
+  UT_ASSERT( p == buff );
+  UT_ASSERT_EQ( size, 6 );
+  circular_queue_commit( &q, size );
+  UT_ASSERT_EQ( circular_queue_get_free_size( &q ), 1 );
+
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT( p == buff + 8 );
+  UT_ASSERT_EQ( size, 8 );
+  circular_queue_release( &q, size );
+  UT_ASSERT_EQ( circular_queue_peek( &q, &p, &size ), 0 );
+  UT_ASSERT( p == buff );
+  UT_ASSERT_EQ( size, 6 );
+  circular_queue_release( &q, size );
+
+  /* full queue */
+  circular_queue_init( &q, buff, sizeof( buff ) );
+  circular_queue_reserve( &q, 15 );
+  circular_queue_commit( &q, 15 );
+  size = 1;
+  UT_ASSERT( circular_queue_reserve_max( &q, &size ) == NULL );
+  UT_ASSERT_EQ( circular_queue_get_free_size( &q ), 0 );
+}
+
+static void *StressProducer( void *arg )
+{
+  uint32_t seed = 1;
+  uint8_t *p;
+
+  for( uint32_t seq = 0; seq < STRESS_RECORDS; seq++ )
+  {
+    uint8_t len = RECORD_HDR + ( NextRandom( &seed ) % ( RECORD_MAX - RECORD_HDR ) );
+
+    while( ( p = circular_queue_reserve( &StressQueue, len ) ) == NULL )
+    {
+      StressFull++;
+      sched_yield( );
+    }
+    WriteRecord( p, len, ( uint16_t )seq );
+    circular_queue_commit( &StressQueue, len );
+  }
+  return arg;
+}
+
+static void *StressConsumer( void *arg )
+{
+  uint32_t received = 0;
+  uint16_t seq = 0;
+  uint16_t prev = 0;
+  uint8_t *p;
+  uint16_t size;
+
+  while( received < STRESS_RECORDS )
+  {
+    if( circular_queue_peek( &StressQueue, &p, &size ) != 0 )
+    {
+      sched_yield( );
+      continue;
+    }
+    circular_queue_release( &StressQueue, CheckRecords( p, size, &seq ) );
+    received += ( uint16_t )( seq - prev );
+    prev = seq;
+    if( StressErrors != 0 )
+    {
+      break;
+    }
+  }
+  return arg;
+}
+
+static void test_stress_two_threads( void )
+{
+  pthread_t producer;
+  pthread_t consumer;
+
+  circular_queue_init( &StressQueue, StressBuff, sizeof( StressBuff ) );
+  StressErrors = 0;
+  StressFull = 0;
+
+  pthread_create( &consumer, NULL, StressConsumer, NULL );
+  pthread_create( &producer, NULL, StressProducer, NULL );
+  pthread_join( producer, NULL );
+  pthread_join( consumer, NULL );
+
+  UT_ASSERT_EQ( StressErrors, 0 );
+  UT_ASSERT_EQ( circular_queue_sense( &StressQueue ), -1 );
+  /* the ring must have been full at times for the run to mean anything */
+  UT_ASSERT( StressFull > 0 );
+}
+
+int main( void )
+{
+  UT_RUN( test_reserve_empty_queue );
+  UT_RUN( test_commit_less_than_reserved );
+  UT_RUN( test_wrap );
+  UT_RUN( test_exact_fit_at_end );
+  UT_RUN( test_reserve_max_splits );
+  UT_RUN( test_stress_two_threads );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,442 @@
+/**
+  ******************************************************************************
+  * @file    test_report_trigger.c
+  * @author  MCD Application Team
+  * @brief   Report triggers of report_trigger.c: the sensor trace of the
+  *          agent tests replayed through the rules of End_Node, with the
+  *          uplinks scheduled as ReportSchedule does, against a reference;
+  *          the threshold hysteresis, the minimum and maximum intervals and
+  *          the postponed reports
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "report_trigger.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+/* 1 Hz pressure, temperature and humidity samples of the agent tests */
+#define TRACE_FILE            "../../../../test/timeSeries/sensorTrace.json"
+#define TRACE_MAX_SAMPLES     512
+#define SENSOR_NB             3
+
+/* Rules of End_Node (main.c), in ms */
+#define APP_REPORT_MIN_INTERVAL       5000
+#define APP_REPORT_MAX_INTERVAL       300000
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static const ReportRule_t ReportRules[SENSOR_NB] =
+{
+  /* deadband, rate of change per sample, threshold, hysteresis, min and max intervals */
+  { 10, 5, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },         /* 1 hPa, 0.5 hPa */
+  { 50, 30, 3000, 100, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },   /* 0.5 degC, 0.3 degC, above 30 degC */
+  { 30, 20, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },        /* 3 %, 2 % */
+};
+
+/* Finer rules, the changes of the trace come faster than the minimum interval */
+static const ReportRule_t FineRules[SENSOR_NB] =
+{
+  { 2, 2, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },
+  { 5, 4, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },
+  { 3, 3, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL },
+};
+
+static int16_t Trace[TRACE_MAX_SAMPLES][SENSOR_NB];
+static int TraceNbSamples;
+static uint32_t TracePeriod;
+
+/* Uplinks of a replay */
+typedef struct
+{
+  uint32_t Uplinks;
+  uint32_t Time[TRACE_MAX_SAMPLES];
+  uint32_t WorstLatency;      /* from the first sample triggering a report to its uplink */
+  uint32_t LongestGap;
+} Replay_t;
+
+static ReportChannel_t Channels[SENSOR_NB];
+static bool TxArmed;
+static uint32_t TxTime;
+static bool Pending;
+static uint32_t PendingSince;
+
+/* Private functions ---------------------------------------------------------*/
+/* Reads the period and the [pressure, temperature, humidity] rows, oldest first */
+static bool ReadTrace( void )
+{
+  FILE *f = fopen( TRACE_FILE, "r" );
+  char line[256];
+  int v[SENSOR_NB];
+
+  UT_ASSERT( f != NULL );
+  if( f == NULL )
+  {
+    return false;
+  }
+  while( fgets( line, sizeof( line ), f ) != NULL )
+  {
+    char *p = line + strspn( line, " \t" );
+
+    if( sscanf( p, "\"period\": %u", &TracePeriod ) == 1 )
+    {
+      continue;
+    }
+    if( ( sscanf( p, "[%d, %d, %d]", &v[0], &v[1], &v[2] ) == SENSOR_NB ) &&
+        ( TraceNbSamples < TRACE_MAX_SAMPLES ) )
+    {
+      for( int s = 0; s < SENSOR_NB; s++ )
+      {
+        Trace[TraceNbSamples][s] = ( int16_t )v[s];
+      }
+      TraceNbSamples++;
+    }
+  }
+  fclose( f );
+  UT_ASSERT( TraceNbSamples > 0 );
+  UT_ASSERT_EQ( TracePeriod, 1000 );
+  return ( TraceNbSamples > 0 ) && ( TracePeriod != 0 );
+}
+
+static void Send( Replay_t *replay, uint32_t now );
+
+/* ReportSchedule of main.c, the MAC allowing the uplinks right away */
+static void Schedule( Replay_t *replay, uint32_t now )
+{
+  uint32_t delay = ReportGetDelay( Channels, SENSOR_NB, now );
+
+  TxArmed = false;
+  if( delay == 0 )
+  {
+    Send( replay, now );
+  }
+  else if( delay != REPORT_NONE )
+  {
+    TxArmed = true;
+    TxTime = now + delay;
+  }
+}
+
+static void Send( Replay_t *replay, uint32_t now )
+{
+  if( Pending == true )
+  {
+    if( now - PendingSince > replay->WorstLatency )
+    {
+      replay->WorstLatency = now - PendingSince;
+    }
+    Pending = false;
+  }
+  if( ( replay->Uplinks > 0 ) && ( now - replay->Time[replay->Uplinks - 1] > replay->LongestGap ) )
+  {
+    replay->LongestGap = now - replay->Time[replay->Uplinks - 1];
+  }
+  replay->Time[replay->Uplinks++] = now;
+  ReportDone( Channels, SENSOR_NB, now );
+  Schedule( replay, now );
+}
+
+/* Samples every period from start, as SamplePush of main.c, and runs the tx
+   timer, up to one period after the last sample */
+static void Replay( const ReportRule_t *rules, int16_t ( *samples )[SENSOR_NB], int nbSamples,
+                    uint32_t period, uint32_t start, Replay_t *replay )
+{
+  memset( replay, 0, sizeof( *replay ) );
+  for( uint8_t s = 0; s < SENSOR_NB; s++ )
+  {
+    ReportInit( &Channels[s], &rules[s], start );
+  }
+  TxArmed = false;
+  Pending = false;
+
+  for( uint32_t t = 0; t < ( uint32_t )nbSamples * period; t++ )
+  {
+    uint32_t now = start + t;
+
+    if( ( t % period ) == 0 )
+    {
+      bool triggered = false;
+
+      for( uint8_t s = 0; s < SENSOR_NB; s++ )
+      {
+        triggered |= ReportSample( &Channels[s], samples[t / period][s] );
+      }
+      if( ( triggered == true ) && ( Pending == false ) )
+      {
+        Pending = true;
+        PendingSince = now;
+      }
+      Schedule( replay, now );
+    }
+    else if( ( TxArmed == true ) && ( now == TxTime ) )
+    {
+      Send( replay, now );
+    }
+  }
+}
+
+/* Uplinks of the rules as specified, sampled on the same period: reported on
+   the first sample, then on a sample past the minimum interval when any
+   sample since the last report moved by the deadband from the value
+   reported or by the rate of change from the sample before; thresholds and
+   maximum interval not reached */
+static uint32_t ReferenceUplinks( const ReportRule_t *rules, int16_t ( *samples )[SENSOR_NB],
+                                  int nbSamples, uint32_t period )
+{
+  int16_t reported[SENSOR_NB];
+  uint32_t reportTime = 0;
+  uint32_t uplinks = 1;
+  bool pending = false;
+
+  memcpy( reported, samples[0], sizeof( reported ) );
+  for( int i = 1; i < nbSamples; i++ )
+  {
+    uint32_t now = i * period;
+
+    for( uint8_t s = 0; s < SENSOR_NB; s++ )
+    {
+      pending |= ( abs( samples[i][s] - reported[s] ) >= rules[s].Deadband );
+      pending |= ( abs( samples[i][s] - samples[i - 1][s] ) >= rules[s].RateOfChange );
+    }
+    if( ( pending == true ) && ( now - reportTime >= APP_REPORT_MIN_INTERVAL ) )
+    {
+      memcpy( reported, samples[i], sizeof( reported ) );
+      reportTime = now;
+      uplinks++;
+      pending = false;
+    }
+  }
+  return uplinks;
+}
+
+/* Replays the trace through the rules, checks the uplinks against the reference */
+static void ReplayTrace( const char *name, const ReportRule_t *rules, Replay_t *replay )
+{
+  static Replay_t wrapped;
+  uint32_t reference;
+
+  Replay( rules, Trace, TraceNbSamples, TracePeriod, 0, replay );
+  reference = ReferenceUplinks( rules, Trace, TraceNbSamples, TracePeriod );
+  printf( "  %s: %u uplinks in %d samples, %u for the reference, worst latency %u ms\n",
+          name, ( unsigned )replay->Uplinks, TraceNbSamples, ( unsigned )reference,
+          ( unsigned )replay->WorstLatency );
+
+  UT_ASSERT_EQ( replay->Uplinks, reference );
+  UT_ASSERT( replay->Uplinks <= 1 + TraceNbSamples * TracePeriod / APP_REPORT_MIN_INTERVAL );
+  UT_ASSERT_EQ( replay->Time[0], 0 );
+  for( uint32_t u = 1; u < replay->Uplinks; u++ )
+  {
+    UT_ASSERT( replay->Time[u] - replay->Time[u - 1] >= APP_REPORT_MIN_INTERVAL );
+  }
+
+  /* a change waits for the minimum interval at most */
+  UT_ASSERT( replay->WorstLatency <= APP_REPORT_MIN_INTERVAL );
+
+  /* the same uplinks with the RTC wrapping around during the trace */
+  Replay( rules, Trace, TraceNbSamples, TracePeriod, UINT32_MAX - 30000, &wrapped );
+  UT_ASSERT_EQ( wrapped.Uplinks, replay->Uplinks );
+  UT_ASSERT_EQ( wrapped.WorstLatency, replay->WorstLatency );
+  UT_ASSERT_EQ( wrapped.LongestGap, replay->LongestGap );
+}
+
+static void test_sensor_trace( void )
+{
+  static Replay_t replay;
+
+  if( ReadTrace( ) == false )
+  {
+    return;
+  }
+  for( int i = 0; i < TraceNbSamples; i++ )
+  {
+    UT_ASSERT( Trace[i][1] < ReportRules[1].Threshold );
+  }
+
+  /* End_Node: the first sample, then the 0.5 degC warming of the trace, sent
+     at once as the minimum interval has long elapsed */
+  ReplayTrace( "End_Node rules", ReportRules, &replay );
+  UT_ASSERT_EQ( replay.Uplinks, 2 );
+  UT_ASSERT_EQ( replay.WorstLatency, 0 );
+
+  /* finer rules: the minimum interval holds most changes back */
+  ReplayTrace( "fine rules", FineRules, &replay );
+  UT_ASSERT( replay.Uplinks > TraceNbSamples * TracePeriod / ( 2 * APP_REPORT_MIN_INTERVAL ) );
+  UT_ASSERT( replay.WorstLatency > 0 );
+}
+
+static void test_threshold_hysteresis( void )
+{
+  static const ReportRule_t rule = { 0, 0, 3000, 100, 0, 0 };
+  /* noise of +-45 around the threshold, less than the hysteresis peak to peak */
+  static const int16_t noise[] = { 0, 20, -20, 45, -45, 10, -30, 30, -10, 0 };
+  ReportChannel_t channel;
+  uint32_t triggers = 0;
+  int16_t sample;
+
+  ReportInit( &channel, &rule, 0 );
+  UT_ASSERT( !ReportSample( &channel, 2900 ) );
+  UT_ASSERT( channel.Triggered );
+  ReportDone( &channel, 1, 0 );
+
+  /* warming up to the threshold and staying around it */
+  for( int i = 0; i < 200; i++ )
+  {
+    sample = ( int16_t )( ( ( i < 50 ) ? 2900 + 2 * i : 3000 ) + noise[i % 10] );
+    if( ReportSample( &channel, sample ) )
+    {
+      triggers++;
+      UT_ASSERT( sample >= rule.Threshold );
+      ReportDone( &channel, 1, i );
+    }
+  }
+  UT_ASSERT_EQ( triggers, 1 );
+  UT_ASSERT( channel.Above );
+
+  /* the falling crossing is at Threshold - Hysteresis, not before */
+  UT_ASSERT( !ReportSample( &channel, 2901 ) );
+  UT_ASSERT( !ReportSample( &channel, 2999 ) );
+  UT_ASSERT( ReportSample( &channel, 2900 ) );
+  UT_ASSERT( !channel.Above );
+  UT_ASSERT( !ReportSample( &channel, 2999 ) );
+  UT_ASSERT( !ReportSample( &channel, 2850 ) );
+  UT_ASSERT( ReportSample( &channel, 3000 ) );
+
+  /* a first sample above the threshold is reported anyway, not crossed again */
+  ReportInit( &channel, &rule, 0 );
+  UT_ASSERT( !ReportSample( &channel, 3100 ) );
+  UT_ASSERT( channel.Above );
+  UT_ASSERT( !ReportSample( &channel, 3050 ) );
+
+  /* no hysteresis, no threshold */
+  {
+    static const ReportRule_t off = { 0, 0, 3000, 0, 0, 0 };
+
+    ReportInit( &channel, &off, 0 );
+    ReportSample( &channel, 2000 );
+    UT_ASSERT( !ReportSample( &channel, 4000 ) );
+    UT_ASSERT( !ReportSample( &channel, 2000 ) );
+  }
+}
+
+static void test_intervals( void )
+{
+  static const ReportRule_t rule = { 10, 0, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL };
+  static const ReportRule_t noMax = { 10, 0, 0, 0, APP_REPORT_MIN_INTERVAL, 0 };
+  ReportChannel_t channel;
+  uint32_t now = 1000;
+
+  /* the first sample is due right away */
+  ReportInit( &channel, &rule, now );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now ), 0 );
+  ReportSample( &channel, 100 );
+  ReportDone( &channel, 1, now );
+  UT_ASSERT( !channel.Triggered );
+
+  /* a still sensor is reported on the maximum interval */
+  UT_ASSERT( !ReportSample( &channel, 105 ) );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + 1000 ), APP_REPORT_MAX_INTERVAL - 1000 );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + APP_REPORT_MAX_INTERVAL ), 0 );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + APP_REPORT_MAX_INTERVAL + 5 ), 0 );
+
+  /* a change is held until the minimum interval */
+  UT_ASSERT( ReportSample( &channel, 110 ) );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + 1000 ), APP_REPORT_MIN_INTERVAL - 1000 );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + APP_REPORT_MIN_INTERVAL ), 0 );
+
+  /* the deadband is from the value reported, the slow drifts add up */
+  ReportDone( &channel, 1, now );
+  UT_ASSERT( !ReportSample( &channel, 115 ) );
+  UT_ASSERT( !ReportSample( &channel, 119 ) );
+  UT_ASSERT( ReportSample( &channel, 120 ) );
+
+  /* nothing due without a trigger or a maximum interval */
+  ReportInit( &channel, &noMax, now );
+  ReportSample( &channel, 100 );
+  ReportDone( &channel, 1, now );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + 10 * APP_REPORT_MAX_INTERVAL ), REPORT_NONE );
+
+  /* the channels of an uplink: the earliest due */
+  {
+    ReportChannel_t channels[2];
+
+    ReportInit( &channels[0], &rule, now );
+    ReportInit( &channels[1], &noMax, now );
+    ReportSample( &channels[0], 0 );
+    ReportSample( &channels[1], 0 );
+    ReportDone( channels, 2, now );
+    UT_ASSERT_EQ( ReportGetDelay( channels, 2, now ), APP_REPORT_MAX_INTERVAL );
+    ReportSample( &channels[1], 50 );
+    UT_ASSERT_EQ( ReportGetDelay( channels, 2, now + 2000 ), APP_REPORT_MIN_INTERVAL - 2000 );
+  }
+
+  /* the intervals across the wrap-around of the RTC */
+  now = UINT32_MAX - 1000;
+  ReportInit( &channel, &rule, now );
+  ReportSample( &channel, 100 );
+  ReportDone( &channel, 1, now );
+  UT_ASSERT( ReportSample( &channel, 200 ) );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + 2000 ), APP_REPORT_MIN_INTERVAL - 2000 );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + APP_REPORT_MIN_INTERVAL ), 0 );
+}
+
+static void test_postpone_keeps_triggers( void )
+{
+  static const ReportRule_t rule = { 10, 0, 0, 0, APP_REPORT_MIN_INTERVAL, APP_REPORT_MAX_INTERVAL };
+  ReportChannel_t channel;
+  uint32_t now = 0;
+
+  ReportInit( &channel, &rule, now );
+  ReportSample( &channel, 100 );
+  ReportDone( &channel, 1, now );
+
+  /* the uplink of a change is refused by the MAC */
+  now += APP_REPORT_MIN_INTERVAL;
+  UT_ASSERT( ReportSample( &channel, 150 ) );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now ), 0 );
+  ReportPostpone( &channel, 1, now );
+
+  /* retried after the minimum interval, still due without a new change */
+  UT_ASSERT( channel.Triggered );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now ), APP_REPORT_MIN_INTERVAL );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + APP_REPORT_MIN_INTERVAL ), 0 );
+
+  /* the value reported is still the one before the refused uplink */
+  UT_ASSERT( ReportSample( &channel, 151 ) );
+  UT_ASSERT_EQ( channel.Reported, 100 );
+  ReportDone( &channel, 1, now + APP_REPORT_MIN_INTERVAL );
+  UT_ASSERT_EQ( channel.Reported, 151 );
+  UT_ASSERT( !channel.Triggered );
+
+  /* a postponed maximum interval restarts it */
+  now += APP_REPORT_MIN_INTERVAL;
+  ReportPostpone( &channel, 1, now + APP_REPORT_MAX_INTERVAL );
+  UT_ASSERT_EQ( ReportGetDelay( &channel, 1, now + APP_REPORT_MAX_INTERVAL ), APP_REPORT_MAX_INTERVAL );
+  UT_ASSERT( !channel.Triggered );
+}
+
+int main( void )
+{
+  UT_RUN( test_sensor_trace );
+  UT_RUN( test_threshold_hysteresis );
+  UT_RUN( test_intervals );
+  UT_RUN( test_postpone_keeps_triggers );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
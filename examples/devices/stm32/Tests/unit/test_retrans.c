@@ -0,0 +1,484 @@
+/**
+  ******************************************************************************
+  * @file    test_retrans.c
+  * @author  MCD Application Team
+  * @brief   Retransmissions of the confirmed uplinks on the virtual radio,
+  *          with the ACKs dropped: the back-off of the retransmission policy
+  *          delays the next trial, the trials are clamped to MAX_ACK_RETRIES,
+  *          the stale frames are abandoned, the confirm adds up the time on
+  *          air and the back-off, and the ACK rate of the adaptive policy
+  *          follows the losses
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <math.h>
+#include "hw.h"
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "cmac.h"
+#include "host_radio.h"
+#include "retrans_policy.h"
+#include "trace.h"
+#include "energy_meter.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR              0x26011B01
+
+/* Transmissions recorded per uplink */
+#define MAX_TX                16
+
+/* Back-off of the test policy, times the retry */
+#define BACKOFF_STEP          3000
+
+/* Age of the stale frames of the adaptive policy */
+#define MAX_AGE               8000
+
+/* Longest uplink: 8 trials, their Rx windows and ACK timeouts, and back-off */
+#define UPLINK_TIME           120000
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t SessionKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+static bool ProcessPending;
+
+static HostRadioFrame_t Tx[MAX_TX];
+static uint8_t NbTx;
+
+static uint32_t NbConfirms;
+static McpsConfirm_t Confirm;
+static uint32_t ConfirmTime;
+
+static uint32_t FCntDown;
+
+/* ACK received in the Rx windows of that trial, 0 for none */
+static uint8_t AckTrial;
+static uint8_t AckFrame[16];
+static uint8_t AckSize;
+
+static uint8_t TestNbTrials;
+
+/* Private functions ---------------------------------------------------------*/
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+  NbConfirms++;
+  Confirm = *mcpsConfirm;
+  ConfirmTime = HW_RTC_GetTimerValue( );
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void NvmContextChange( LoRaMacNvmCtxModule_t module )
+{
+}
+
+static void MacProcessNotify( void )
+{
+  ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+static LoRaMacCallback_t Callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmContextChange, MacProcessNotify };
+
+static void OnTx( const HostRadioFrame_t *frame )
+{
+  if( NbTx < MAX_TX )
+  {
+    Tx[NbTx] = *frame;
+  }
+  NbTx++;
+  /* the ACKs of the trials before are dropped */
+  if( NbTx == AckTrial )
+  {
+    UT_ASSERT( HostRadioQueueRx( 0, AckFrame, AckSize, -60, 8 ) );
+  }
+}
+
+/* Policy of the test: the trials it is set to, a back-off growing with the
+   retry */
+static uint8_t TestGetNbTrials( uint8_t nbTrials )
+{
+  return TestNbTrials;
+}
+
+static uint32_t TestGetBackoff( uint8_t retry )
+{
+  return retry * BACKOFF_STEP;
+}
+
+static const RetransPolicy_t BackoffPolicy = { NULL, TestGetBackoff, NULL, NULL, NULL };
+static const RetransPolicy_t TrialsPolicy = { TestGetNbTrials, NULL, NULL, NULL, NULL };
+
+/* Runs the MAC on the virtual clock */
+static void Run( uint32_t ms )
+{
+  while( ms-- > 0 )
+  {
+    HostRtcRun( 1 );
+    if( ProcessPending == true )
+    {
+      ProcessPending = false;
+      LoRaMacProcess( );
+    }
+  }
+}
+
+/* Runs the MAC up to the end of the nth transmission of the uplink */
+static void RunToTx( uint8_t n )
+{
+  uint32_t ms = UPLINK_TIME;
+
+  while( ( NbTx < n ) && ( ms-- > 0 ) )
+  {
+    Run( 1 );
+  }
+  UT_ASSERT( NbTx >= n );
+}
+
+static void MibSet( MibRequestConfirm_t *mibReq )
+{
+  UT_ASSERT_EQ( LoRaMacMibSetRequestConfirm( mibReq ), LORAMAC_STATUS_OK );
+}
+
+/* ABP session of lora.c, in LoRaWAN 1.0.3, without duty cycle so that only
+   the MAC and the policy space the trials */
+static void Setup( const RetransPolicy_t *policy )
+{
+  MibRequestConfirm_t mibReq;
+
+  HostRadioReset( 1 );
+  HostRadioSetTxHandler( OnTx );
+  UT_ASSERT_EQ( LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 ), LORAMAC_STATUS_OK );
+
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_F_NWK_S_INT_KEY;
+  mibReq.Param.FNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_S_NWK_S_INT_KEY;
+  mibReq.Param.SNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NWK_S_ENC_KEY;
+  mibReq.Param.NwkSEncKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_APP_S_KEY;
+  mibReq.Param.AppSKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+  mibReq.Param.AbpLrWanVersion.Value = 0x01000300;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_RETRANS_POLICY;
+  mibReq.Param.RetransPolicy = policy;
+  MibSet( &mibReq );
+
+  LoRaMacTestSetDutyCycleOn( false );
+  LoRaMacStart( );
+  NbConfirms = 0;
+  FCntDown = 0;
+}
+
+/* Requests a confirmed uplink at DR_5 */
+static void RequestConfirmed( uint8_t nbTrials )
+{
+  McpsReq_t mcpsReq;
+  static uint8_t data = 0;
+
+  NbTx = 0;
+  mcpsReq.Type = MCPS_CONFIRMED;
+  mcpsReq.Req.Confirmed.fPort = 2;
+  mcpsReq.Req.Confirmed.fBuffer = &data;
+  mcpsReq.Req.Confirmed.fBufferSize = 1;
+  mcpsReq.Req.Confirmed.NbTrials = nbTrials;
+  mcpsReq.Req.Confirmed.Datarate = DR_5;
+  UT_ASSERT_EQ( LoRaMacMcpsRequest( &mcpsReq ), LORAMAC_STATUS_OK );
+}
+
+/* Requests an unconfirmed uplink, while the MAC may be busy */
+static LoRaMacStatus_t RequestUnconfirmed( void )
+{
+  McpsReq_t mcpsReq;
+  static uint8_t data = 0;
+
+  mcpsReq.Type = MCPS_UNCONFIRMED;
+  mcpsReq.Req.Unconfirmed.fPort = 2;
+  mcpsReq.Req.Unconfirmed.fBuffer = &data;
+  mcpsReq.Req.Unconfirmed.fBufferSize = 1;
+  mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+  return LoRaMacMcpsRequest( &mcpsReq );
+}
+
+/* Sends a confirmed uplink whose ACKs are all dropped, up to its confirm */
+static void UplinkUnacked( uint8_t nbTrials )
+{
+  uint32_t confirms = NbConfirms;
+
+  RequestConfirmed( nbTrials );
+  Run( UPLINK_TIME );
+  UT_ASSERT_EQ( NbConfirms, confirms + 1 );
+}
+
+/* Empty downlink of the network server acknowledging the last uplink */
+static uint8_t BuildAck( uint8_t *frame )
+{
+  uint8_t block[16];
+  uint8_t mic[16];
+  AES_CMAC_CTX cmac;
+  uint8_t len = 0;
+
+  frame[len++] = 0x60;
+  frame[len++] = DEV_ADDR & 0xFF;
+  frame[len++] = ( DEV_ADDR >> 8 ) & 0xFF;
+  frame[len++] = ( DEV_ADDR >> 16 ) & 0xFF;
+  frame[len++] = ( DEV_ADDR >> 24 ) & 0xFF;
+  frame[len++] = 0x20;
+  frame[len++] = FCntDown & 0xFF;
+  frame[len++] = ( FCntDown >> 8 ) & 0xFF;
+
+  /* MIC: cmac( NwkSKey, B0 | msg ), B0 = 0x49 | 0x00000000 | dir | DevAddr | FCnt | 0x00 | len */
+  memset( block, 0, sizeof( block ) );
+  block[0] = 0x49;
+  block[5] = 0x01;
+  memcpy( &block[6], &frame[1], 4 );
+  block[10] = FCntDown & 0xFF;
+  block[11] = ( FCntDown >> 8 ) & 0xFF;
+  block[15] = len;
+  AES_CMAC_Init( &cmac );
+  AES_CMAC_SetKey( &cmac, SessionKey );
+  AES_CMAC_Update( &cmac, block, sizeof( block ) );
+  AES_CMAC_Update( &cmac, frame, len );
+  AES_CMAC_Final( mic, &cmac );
+  memcpy( &frame[len], mic, 4 );
+  FCntDown++;
+
+  return len + 4;
+}
+
+/* Sends a confirmed uplink, acknowledged in RX1 of the trial given */
+static void UplinkAcked( uint8_t nbTrials, uint8_t trial )
+{
+  AckSize = BuildAck( AckFrame );
+  AckTrial = trial;
+  RequestConfirmed( nbTrials );
+  Run( UPLINK_TIME );
+  AckTrial = 0;
+}
+
+static uint32_t TotalTimeOnAir( void )
+{
+  uint32_t total = 0;
+
+  for( uint8_t i = 0; ( i < NbTx ) && ( i < MAX_TX ); i++ )
+  {
+    total += Tx[i].TimeOnAir;
+  }
+  return total;
+}
+
+static void test_dropped_ack_retransmitted( void )
+{
+  Setup( NULL );
+  UplinkAcked( 4, 3 );
+  UT_ASSERT_EQ( NbTx, 3 );
+  UT_ASSERT_EQ( NbConfirms, 1 );
+  UT_ASSERT( Confirm.AckReceived );
+  UT_ASSERT_EQ( Confirm.NbRetries, 3 );
+  UT_ASSERT( !Confirm.Abandoned );
+
+  /* the trials are the same frame */
+  UT_ASSERT_MEM( Tx[1].Payload, Tx[0].Payload, Tx[0].Size );
+  UT_ASSERT_MEM( Tx[2].Payload, Tx[0].Payload, Tx[0].Size );
+}
+
+static void test_backoff_on_tx_delayed_timer( void )
+{
+  uint32_t gaps[2];
+  uint32_t retransmission;
+  uint32_t alarm;
+
+  /* the MAC alone retransmits at the end of the ACK timeout */
+  Setup( NULL );
+  UplinkUnacked( 3 );
+  UT_ASSERT_EQ( NbTx, 3 );
+  UT_ASSERT_EQ( Confirm.BackoffTime, 0 );
+  gaps[0] = Tx[1].Time - Tx[0].Time;
+  gaps[1] = Tx[2].Time - Tx[1].Time;
+
+  /* the same uplink waits the back-off on top of it */
+  Setup( &BackoffPolicy );
+  RequestConfirmed( 3 );
+  RunToTx( 1 );
+  retransmission = Tx[0].Time + gaps[0] + BACKOFF_STEP;
+  Run( retransmission - HW_RTC_GetTimerValue( ) - BACKOFF_STEP / 2 );
+
+  /* held by TxDelayedTimer, the MAC takes no other request meanwhile */
+  UT_ASSERT_EQ( NbTx, 1 );
+  UT_ASSERT( HostRtcGetAlarm( &alarm ) );
+  UT_ASSERT_EQ( alarm, retransmission );
+  UT_ASSERT_EQ( RequestUnconfirmed( ), LORAMAC_STATUS_BUSY );
+
+  Run( UPLINK_TIME );
+  UT_ASSERT_EQ( NbTx, 3 );
+  UT_ASSERT_EQ( NbConfirms, 1 );
+  UT_ASSERT_EQ( Tx[1].Time, retransmission );
+  UT_ASSERT_EQ( Tx[2].Time - Tx[1].Time, gaps[1] + 2 * BACKOFF_STEP );
+
+  /* the confirm adds up the trials and the back-off */
+  UT_ASSERT( !Confirm.AckReceived );
+  UT_ASSERT_EQ( Confirm.NbRetries, 3 );
+  UT_ASSERT_EQ( Confirm.BackoffTime, BACKOFF_STEP + 2 * BACKOFF_STEP );
+  UT_ASSERT_EQ( Confirm.TotalTimeOnAir, TotalTimeOnAir( ) );
+}
+
+static void test_nb_trials_clamped( void )
+{
+  Setup( NULL );
+  UplinkUnacked( MAX_ACK_RETRIES + 12 );
+  UT_ASSERT_EQ( NbTx, MAX_ACK_RETRIES );
+  UT_ASSERT_EQ( Confirm.NbTrials, MAX_ACK_RETRIES );
+  UT_ASSERT_EQ( Confirm.NbRetries, MAX_ACK_RETRIES );
+  UT_ASSERT( !Confirm.AckReceived );
+  UT_ASSERT_EQ( Confirm.TotalTimeOnAir, TotalTimeOnAir( ) );
+
+  /* nor does a policy go past them, or below one trial */
+  Setup( &TrialsPolicy );
+  TestNbTrials = MAX_ACK_RETRIES + 1;
+  UplinkUnacked( 2 );
+  UT_ASSERT_EQ( NbTx, MAX_ACK_RETRIES );
+  UT_ASSERT_EQ( Confirm.NbRetries, MAX_ACK_RETRIES );
+  TestNbTrials = 0;
+  UplinkUnacked( 2 );
+  UT_ASSERT_EQ( NbTx, 1 );
+  UT_ASSERT_EQ( Confirm.NbRetries, 1 );
+}
+
+static void test_stale_frame_abandoned( void )
+{
+  static const RetransAdaptiveConfig_t fresherOnly = { 0, 0, 0, 0, 0 };
+  static const RetransAdaptiveConfig_t maxAge = { 0, 0, 0, 0, MAX_AGE };
+
+  /* a fresher sample waits: the frame goes no further than its first trial */
+  RetransAdaptiveInit( &fresherOnly );
+  Setup( &RetransAdaptivePolicy );
+  RequestConfirmed( MAX_ACK_RETRIES );
+  RunToTx( 1 );
+  RetransFresherData( );
+  Run( UPLINK_TIME );
+  UT_ASSERT_EQ( NbTx, 1 );
+  UT_ASSERT_EQ( NbConfirms, 1 );
+  UT_ASSERT( Confirm.Abandoned );
+  UT_ASSERT( !Confirm.AckReceived );
+  UT_ASSERT_EQ( Confirm.NbRetries, 1 );
+  UT_ASSERT_EQ( Confirm.TotalTimeOnAir, Tx[0].TimeOnAir );
+
+  /* the next frame starts afresh */
+  UplinkUnacked( 2 );
+  UT_ASSERT_EQ( NbTx, 2 );
+  UT_ASSERT( !Confirm.Abandoned );
+
+  /* an old frame is abandoned at the first retry past its age */
+  RetransAdaptiveInit( &maxAge );
+  Setup( &RetransAdaptivePolicy );
+  UplinkUnacked( MAX_ACK_RETRIES );
+  UT_ASSERT( Confirm.Abandoned );
+  UT_ASSERT( NbTx < MAX_ACK_RETRIES );
+  UT_ASSERT_EQ( Confirm.NbRetries, NbTx );
+  UT_ASSERT( Tx[NbTx - 1].Time - Tx[0].Time < MAX_AGE );
+  UT_ASSERT( ConfirmTime - Tx[0].Time >= MAX_AGE );
+  UT_ASSERT_EQ( Confirm.TotalTimeOnAir, TotalTimeOnAir( ) );
+}
+
+static void test_ack_rate_converges( void )
+{
+  static const RetransAdaptiveConfig_t config = { 1, 8, 0, 0, 0 };
+  double rate = 1.0;
+  uint8_t trials = config.MaxTrials;
+
+  RetransAdaptiveInit( &config );
+  Setup( &RetransAdaptivePolicy );
+
+  /* every ACK lost: each transmission weighs 1/8 in the rate, the trials fall
+     to MinTrials */
+  for( uint8_t i = 0; i < 20; i++ )
+  {
+    UplinkUnacked( MAX_ACK_RETRIES );
+    UT_ASSERT( NbTx <= trials );
+    trials = NbTx;
+    rate *= pow( 7.0 / 8.0, NbTx );
+    /* the integer rate truncates the decrease, by 1/256 at most per loss */
+    UT_ASSERT( fabs( RetransGetAckRate( ) / 256.0 - rate ) < 0.05 );
+  }
+  UT_ASSERT_EQ( trials, config.MinTrials );
+  UT_ASSERT( RetransGetAckRate( ) < 8 );
+
+  /* every first trial acknowledged: the rate climbs back, the trials with it */
+  for( uint8_t i = 0; i < 40; i++ )
+  {
+    UplinkAcked( MAX_ACK_RETRIES, 1 );
+    UT_ASSERT_EQ( NbTx, 1 );
+    UT_ASSERT( Confirm.AckReceived );
+    rate += ( 1.0 - rate ) / 8.0;
+    UT_ASSERT( fabs( RetransGetAckRate( ) / 256.0 - rate ) < 0.05 );
+  }
+  UT_ASSERT( RetransGetAckRate( ) >= 256 - 8 );
+  UT_ASSERT_EQ( RetransAdaptivePolicy.GetNbTrials( MAX_ACK_RETRIES ), config.MaxTrials );
+}
+
+int main( void )
+{
+  /* the MAC traces its radio events and accounts their energy */
+  TraceInit( );
+  EnergyInit( );
+
+  UT_RUN( test_dropped_ack_retransmitted );
+  UT_RUN( test_backoff_on_tx_delayed_timer );
+  UT_RUN( test_nb_trials_clamped );
+  UT_RUN( test_stale_frame_abandoned );
+  UT_RUN( test_ack_rate_converges );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,401 @@
+/**
+  ******************************************************************************
+  * @file    test_rx_drop_stats.c
+  * @author  MCD Application Team
+  * @brief   Receive pipeline of the MAC on the virtual radio: each rejected
+  *          downlink is counted in the MIB_RX_DROP_STATS counter of the stage
+  *          which dropped it, and frames of other devices never reach the
+  *          crypto
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "LoRaMacCrypto.h"
+#include "aes.h"
+#include "cmac.h"
+#include "host_radio.h"
+#include "trace.h"
+#include "energy_meter.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR              0x26011B01
+#define OTHER_DEV_ADDR        0x26011B02
+#define APP_PORT              2
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t SessionKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+static bool ProcessPending;
+
+/* Downlinks delivered to the application */
+static uint32_t NbIndicated;
+
+/* Calls of the MAC to the downlink crypto */
+static uint32_t NbUnsecure;
+
+/* Private functions ---------------------------------------------------------*/
+LoRaMacCryptoStatus_t __real_LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID, uint32_t address, FCntIdentifier_t fCntID, uint32_t fCntDown, LoRaMacMessageData_t* macMsg );
+
+/* Linked with --wrap=LoRaMacCryptoUnsecureMessage */
+LoRaMacCryptoStatus_t __wrap_LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID, uint32_t address, FCntIdentifier_t fCntID, uint32_t fCntDown, LoRaMacMessageData_t* macMsg )
+{
+  NbUnsecure++;
+  return __real_LoRaMacCryptoUnsecureMessage( addrID, address, fCntID, fCntDown, macMsg );
+}
+
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  if( ( mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK ) && ( mcpsIndication->RxData == true ) )
+  {
+    NbIndicated++;
+  }
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void NvmContextChange( LoRaMacNvmCtxModule_t module )
+{
+}
+
+static void MacProcessNotify( void )
+{
+  ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+static LoRaMacCallback_t Callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmContextChange, MacProcessNotify };
+
+/* Runs the MAC on the virtual clock */
+static void Run( uint32_t ms )
+{
+  while( ms-- > 0 )
+  {
+    HostRtcRun( 1 );
+    if( ProcessPending == true )
+    {
+      ProcessPending = false;
+      LoRaMacProcess( );
+    }
+  }
+}
+
+static void MibSet( MibRequestConfirm_t *mibReq )
+{
+  UT_ASSERT_EQ( LoRaMacMibSetRequestConfirm( mibReq ), LORAMAC_STATUS_OK );
+}
+
+/* ABP session of lora.c, in LoRaWAN 1.0.3, without duty cycle so that the
+   uplinks follow each other */
+static void Setup( void )
+{
+  MibRequestConfirm_t mibReq;
+
+  HostRadioReset( 1 );
+  UT_ASSERT_EQ( LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 ), LORAMAC_STATUS_OK );
+
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_F_NWK_S_INT_KEY;
+  mibReq.Param.FNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_S_NWK_S_INT_KEY;
+  mibReq.Param.SNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NWK_S_ENC_KEY;
+  mibReq.Param.NwkSEncKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_APP_S_KEY;
+  mibReq.Param.AppSKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+  mibReq.Param.AbpLrWanVersion.Value = 0x01000300;
+  MibSet( &mibReq );
+
+  LoRaMacTestSetDutyCycleOn( false );
+  LoRaMacStart( );
+  NbIndicated = 0;
+  NbUnsecure = 0;
+}
+
+static void Aes( const uint8_t *key, const uint8_t *in, uint8_t *out )
+{
+  aes_context ctx;
+
+  aes_set_key( key, 16, &ctx );
+  aes_encrypt( in, out, &ctx );
+}
+
+/* Unconfirmed downlink to devAddr built by the network server with the
+   session keys of the device, without FOpts nor FPort when size is 0 */
+static uint8_t BuildDownlink( uint32_t devAddr, uint8_t fCtrl, uint32_t fCnt, const uint8_t *data, uint8_t size, uint8_t *frame )
+{
+  uint8_t block[16];
+  uint8_t stream[16];
+  uint8_t mic[16];
+  AES_CMAC_CTX cmac;
+  uint8_t len = 0;
+
+  frame[len++] = 0x60;
+  frame[len++] = devAddr & 0xFF;
+  frame[len++] = ( devAddr >> 8 ) & 0xFF;
+  frame[len++] = ( devAddr >> 16 ) & 0xFF;
+  frame[len++] = ( devAddr >> 24 ) & 0xFF;
+  frame[len++] = fCtrl;
+  frame[len++] = fCnt & 0xFF;
+  frame[len++] = ( fCnt >> 8 ) & 0xFF;
+
+  if( size > 0 )
+  {
+    frame[len++] = APP_PORT;
+
+    /* FRMPayload: A_i = 0x01 | 0x00000000 | dir | DevAddr | FCnt | 0x00 | i */
+    for( uint8_t i = 0; i < size; i += 16 )
+    {
+      uint8_t a[16] = { 0x01, 0, 0, 0, 0, 0x01, devAddr & 0xFF, ( devAddr >> 8 ) & 0xFF,
+                        ( devAddr >> 16 ) & 0xFF, ( devAddr >> 24 ) & 0xFF, fCnt & 0xFF,
+                        ( fCnt >> 8 ) & 0xFF, ( fCnt >> 16 ) & 0xFF, ( fCnt >> 24 ) & 0xFF, 0, ( i / 16 ) + 1 };
+
+      Aes( SessionKey, a, stream );
+      for( uint8_t j = i; ( j < size ) && ( j < i + 16 ); j++ )
+      {
+        frame[len + j] = data[j] ^ stream[j - i];
+      }
+    }
+    len += size;
+  }
+
+  /* MIC: cmac( NwkSKey, B0 | msg ), B0 = 0x49 | 0x00000000 | dir | DevAddr | FCnt | 0x00 | len */
+  memset( block, 0, sizeof( block ) );
+  block[0] = 0x49;
+  block[5] = 0x01;
+  memcpy( &block[6], &frame[1], 4 );
+  block[10] = fCnt & 0xFF;
+  block[11] = ( fCnt >> 8 ) & 0xFF;
+  block[12] = ( fCnt >> 16 ) & 0xFF;
+  block[13] = ( fCnt >> 24 ) & 0xFF;
+  block[15] = len;
+  AES_CMAC_Init( &cmac );
+  AES_CMAC_SetKey( &cmac, SessionKey );
+  AES_CMAC_Update( &cmac, block, sizeof( block ) );
+  AES_CMAC_Update( &cmac, frame, len );
+  AES_CMAC_Final( mic, &cmac );
+  memcpy( &frame[len], mic, 4 );
+
+  return len + 4;
+}
+
+/* Sends an uplink and runs its reception windows, the frame queued is
+   received in the first one */
+static void UplinkWithDownlink( const uint8_t *frame, uint8_t size )
+{
+  McpsReq_t mcpsReq;
+  uint8_t data = 0;
+
+  UT_ASSERT( HostRadioQueueRx( 0, frame, size, -60, 8 ) );
+
+  mcpsReq.Type = MCPS_UNCONFIRMED;
+  mcpsReq.Req.Unconfirmed.fPort = APP_PORT;
+  mcpsReq.Req.Unconfirmed.fBuffer = &data;
+  mcpsReq.Req.Unconfirmed.fBufferSize = 1;
+  mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+  UT_ASSERT_EQ( LoRaMacMcpsRequest( &mcpsReq ), LORAMAC_STATUS_OK );
+  Run( 5000 );
+}
+
+static RxDropStats_t DropStats( void )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_RX_DROP_STATS;
+  LoRaMacMibGetRequestConfirm( &mibReq );
+  return mibReq.Param.RxDropStats;
+}
+
+static void AssertDropStats( uint32_t header, uint32_t address, uint32_t parser, uint32_t fCnt, uint32_t mic )
+{
+  RxDropStats_t stats = DropStats( );
+
+  UT_ASSERT_EQ( stats.Header, header );
+  UT_ASSERT_EQ( stats.Address, address );
+  UT_ASSERT_EQ( stats.Parser, parser );
+  UT_ASSERT_EQ( stats.FCnt, fCnt );
+  UT_ASSERT_EQ( stats.Mic, mic );
+}
+
+static void test_foreign_address( void )
+{
+  static const uint8_t data[] = "not for us";
+  uint8_t frame[64];
+  uint8_t size;
+
+  Setup( );
+  size = BuildDownlink( OTHER_DEV_ADDR, 0x00, 1, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+
+  AssertDropStats( 0, 1, 0, 0, 0 );
+  UT_ASSERT_EQ( NbUnsecure, 0 );
+  UT_ASSERT_EQ( NbIndicated, 0 );
+
+  /* the same frame to the device goes through */
+  size = BuildDownlink( DEV_ADDR, 0x00, 1, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 0, 1, 0, 0, 0 );
+  UT_ASSERT_EQ( NbUnsecure, 1 );
+  UT_ASSERT_EQ( NbIndicated, 1 );
+}
+
+static void test_bad_header( void )
+{
+  uint8_t data[] = { 0x01 };
+  uint8_t frame[64];
+  uint8_t size;
+
+  Setup( );
+
+  /* shorter than a data frame */
+  frame[0] = 0x60;
+  UplinkWithDownlink( frame, 1 );
+  AssertDropStats( 1, 0, 0, 0, 0 );
+
+  /* major version other than LoRaWAN R1 */
+  size = BuildDownlink( DEV_ADDR, 0x00, 1, data, sizeof( data ), frame );
+  frame[0] = 0x61;
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 2, 0, 0, 0, 0 );
+
+  /* uplink frame type */
+  frame[0] = 0x40;
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 3, 0, 0, 0, 0 );
+
+  UT_ASSERT_EQ( NbUnsecure, 0 );
+  UT_ASSERT_EQ( NbIndicated, 0 );
+}
+
+static void test_malformed_fopts( void )
+{
+  uint8_t frame[64];
+  uint8_t size;
+
+  /* FOptsLen of 15 in a frame with room for none */
+  Setup( );
+  size = BuildDownlink( DEV_ADDR, 0x0F, 1, NULL, 0, frame );
+  UplinkWithDownlink( frame, size );
+
+  AssertDropStats( 0, 0, 1, 0, 0 );
+  UT_ASSERT_EQ( NbUnsecure, 0 );
+  UT_ASSERT_EQ( NbIndicated, 0 );
+}
+
+static void test_replayed_fcnt( void )
+{
+  uint8_t data[] = { 0x42 };
+  uint8_t frame[64];
+  uint8_t size;
+
+  Setup( );
+  size = BuildDownlink( DEV_ADDR, 0x00, 5, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 0, 0, 0, 0, 0 );
+  UT_ASSERT_EQ( NbIndicated, 1 );
+
+  /* replayed as such, rejected before its MIC is checked */
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 0, 0, 0, 1, 0 );
+  UT_ASSERT_EQ( NbUnsecure, 1 );
+  UT_ASSERT_EQ( NbIndicated, 1 );
+
+  /* the next counter is accepted */
+  size = BuildDownlink( DEV_ADDR, 0x00, 6, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 0, 0, 0, 1, 0 );
+  UT_ASSERT_EQ( NbIndicated, 2 );
+}
+
+static void test_reset_by_set( void )
+{
+  MibRequestConfirm_t mibReq;
+  uint8_t data[] = { 0x01 };
+  uint8_t frame[64];
+  uint8_t size;
+
+  Setup( );
+  size = BuildDownlink( OTHER_DEV_ADDR, 0x00, 1, data, sizeof( data ), frame );
+  UplinkWithDownlink( frame, size );
+  frame[0] = 0x61;
+  UplinkWithDownlink( frame, size );
+  size = BuildDownlink( DEV_ADDR, 0x00, 1, data, sizeof( data ), frame );
+  frame[size - 1] ^= 0x01;
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 1, 1, 0, 0, 1 );
+
+  mibReq.Type = MIB_RX_DROP_STATS;
+  MibSet( &mibReq );
+  AssertDropStats( 0, 0, 0, 0, 0 );
+
+  /* and count again from there */
+  UplinkWithDownlink( frame, size );
+  AssertDropStats( 0, 0, 0, 0, 1 );
+}
+
+int main( void )
+{
+  /* the MAC traces its radio events and accounts their energy */
+  TraceInit( );
+  EnergyInit( );
+
+  UT_RUN( test_foreign_address );
+  UT_RUN( test_bad_header );
+  UT_RUN( test_malformed_fopts );
+  UT_RUN( test_replayed_fcnt );
+  UT_RUN( test_reset_by_set );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
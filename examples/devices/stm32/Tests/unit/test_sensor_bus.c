@@ -0,0 +1,207 @@
+/**
+  ******************************************************************************
+  * @file    test_sensor_bus.c
+  * @author  MCD Application Team
+  * @brief   Interrupt driven sensor bus queue over a mock bus: transfers run
+  *          one at a time in submission order, transfers queued by a callback
+  *          run after the pending ones, and failures reach their callbacks
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw_conf.h"
+#include "sensor_bus.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define NO_TRANSFER   -1
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+/* Bus events, as "R28 " for a read started at 0x28, "C28 " for its callback,
+   "C28! " for a failed one and "F28 " for a transfer the bus refused */
+static char Log[256];
+
+/* Register of the transfer on the bus, starts refused before accepting again */
+static int InFlight = NO_TRANSFER;
+static int RefuseStarts;
+static int Overlaps;
+
+static SensorBusTransfer_t Transfers[4];
+static uint8_t Buffer[8];
+static int Device = 1;
+
+/* Private functions ---------------------------------------------------------*/
+static void LogEvent( const char *event, uint8_t reg, const char *suffix )
+{
+  sprintf( Log + strlen( Log ), "%s%02X%s ", event, reg, suffix );
+}
+
+static uint8_t Start( const char *event, uint8_t reg )
+{
+  if( RefuseStarts > 0 )
+  {
+    RefuseStarts--;
+    LogEvent( "F", reg, "" );
+    return 1;
+  }
+  if( InFlight != NO_TRANSFER )
+  {
+    Overlaps++;
+  }
+  InFlight = reg;
+  LogEvent( event, reg, "" );
+  return 0;
+}
+
+uint8_t Sensor_IO_Read_IT( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
+{
+  return Start( "R", ReadAddr );
+}
+
+uint8_t Sensor_IO_Write_IT( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
+{
+  return Start( "W", WriteAddr );
+}
+
+/* Bus interrupt of the board */
+static void BusIrq( DrvStatusTypeDef status )
+{
+  InFlight = NO_TRANSFER;
+  SensorBus_TransferComplete( status );
+}
+
+/* Transfers whose context is set queue Transfers[3] from their callback */
+static void Callback( SensorBusTransfer_t *transfer, DrvStatusTypeDef status )
+{
+  LogEvent( "C", transfer->reg, ( status == COMPONENT_OK ) ? "" : "!" );
+  if( transfer->context != NULL )
+  {
+    transfer->context = NULL;
+    SensorBus_Submit( &Transfers[3] );
+  }
+}
+
+static void Setup( void )
+{
+  static const uint8_t regs[4] = { 0x28, 0xA8, 0x10, 0x30 };
+
+  for( int i = 0; i < 4; i++ )
+  {
+    memset( &Transfers[i], 0, sizeof( Transfers[i] ) );
+    Transfers[i].handle = &Device;
+    Transfers[i].reg = regs[i];
+    Transfers[i].isWrite = ( i == 2 ) ? 1 : 0;
+    Transfers[i].pBuffer = Buffer;
+    Transfers[i].size = 2;
+    Transfers[i].callback = Callback;
+  }
+  Log[0] = '\0';
+  InFlight = NO_TRANSFER;
+  RefuseStarts = 0;
+  Overlaps = 0;
+}
+
+static void RunBus( void )
+{
+  for( int i = 0; i < 16 && SensorBus_IsBusy( ); i++ )
+  {
+    BusIrq( COMPONENT_OK );
+  }
+}
+
+static void test_submission_order( void )
+{
+  Setup( );
+  UT_ASSERT_EQ( SensorBus_Submit( &Transfers[0] ), COMPONENT_OK );
+  UT_ASSERT_EQ( SensorBus_Submit( &Transfers[1] ), COMPONENT_OK );
+  UT_ASSERT_EQ( SensorBus_Submit( &Transfers[2] ), COMPONENT_OK );
+
+  /* Only the first one is on the bus until its interrupt */
+  UT_ASSERT( strcmp( Log, "R28 " ) == 0 );
+  UT_ASSERT( SensorBus_IsBusy( ) );
+
+  RunBus( );
+  UT_ASSERT( strcmp( Log, "R28 C28 RA8 CA8 W10 C10 " ) == 0 );
+  UT_ASSERT( !SensorBus_IsBusy( ) );
+  UT_ASSERT_EQ( Overlaps, 0 );
+  UT_ASSERT_EQ( HostPrimask, 0 );
+}
+
+static void test_chained_from_callback( void )
+{
+  Setup( );
+  Transfers[0].context = ( void * )1;
+  SensorBus_Submit( &Transfers[0] );
+  SensorBus_Submit( &Transfers[1] );
+  SensorBus_Submit( &Transfers[2] );
+  RunBus( );
+
+  /* Queued by the first callback, after the transfers already pending */
+  UT_ASSERT( strcmp( Log, "R28 C28 RA8 CA8 W10 C10 R30 C30 " ) == 0 );
+  UT_ASSERT( !SensorBus_IsBusy( ) );
+  UT_ASSERT_EQ( Overlaps, 0 );
+}
+
+static void test_refused_start( void )
+{
+  Setup( );
+  RefuseStarts = 1;
+  UT_ASSERT_EQ( SensorBus_Submit( &Transfers[1] ), COMPONENT_OK );
+
+  /* Completed at once with an error, the bus is free again */
+  UT_ASSERT( strcmp( Log, "FA8 CA8! " ) == 0 );
+  UT_ASSERT( !SensorBus_IsBusy( ) );
+}
+
+static void test_errors_reach_callbacks( void )
+{
+  Setup( );
+  SensorBus_Submit( &Transfers[1] );
+  SensorBus_Submit( &Transfers[2] );
+  SensorBus_Submit( &Transfers[3] );
+
+  /* Bus error on the first one, the third one refused to start */
+  RefuseStarts = 0;
+  BusIrq( COMPONENT_ERROR );
+  RefuseStarts = 1;
+  BusIrq( COMPONENT_OK );
+
+  UT_ASSERT( strcmp( Log, "RA8 CA8! W10 C10 F30 C30! " ) == 0 );
+  UT_ASSERT( !SensorBus_IsBusy( ) );
+}
+
+static void test_invalid_transfer( void )
+{
+  Setup( );
+  Transfers[1].handle = NULL;
+  UT_ASSERT_EQ( SensorBus_Submit( &Transfers[1] ), COMPONENT_ERROR );
+  UT_ASSERT_EQ( SensorBus_Submit( NULL ), COMPONENT_ERROR );
+  UT_ASSERT( Log[0] == '\0' );
+  UT_ASSERT( !SensorBus_IsBusy( ) );
+}
+
+int main( void )
+{
+  UT_RUN( test_submission_order );
+  UT_RUN( test_chained_from_callback );
+  UT_RUN( test_refused_start );
+  UT_RUN( test_errors_reach_callbacks );
+  UT_RUN( test_invalid_transfer );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,334 @@
+/**
+  ******************************************************************************
+  * @file    test_sensor_window.c
+  * @author  MCD Application Team
+  * @brief   Window summaries of sensor_window.c with the CMSIS-DSP q15
+  *          kernels, against a double reference: random windows of every
+  *          spread, the ring wrap-around, the values near INT16_MIN and
+  *          INT16_MAX, single sample and constant windows, and the rounding
+  *          and saturation of the scaled mean and standard deviation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <math.h>
+#include "sensor_window.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define WINDOW_SIZE           64
+#define NB_RANDOM_WINDOWS     2000
+
+/* Largest errors in the unit of the samples: the mean and the standard
+   deviation are rounded to the unit, the halved samples lose their lowest
+   bit. The q15 variance truncates the standard deviation by up to 0.1 % on
+   top of it. */
+#define MAX_MEAN_ERROR        1
+#define MAX_STD_ERROR         1
+#define MAX_WIDE_MEAN_ERROR   3
+#define MAX_WIDE_STD_ERROR    2
+#define MAX_STD_RELATIVE      0.001
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  int16_t Min;
+  int16_t Max;
+  double Mean;
+  double Std;                 /* sample standard deviation */
+} Reference_t;
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static int16_t Storage[WINDOW_SIZE];
+static SensorWindow_t Window;
+
+/* Private functions ---------------------------------------------------------*/
+static void Reference( const int16_t *samples, uint16_t count, Reference_t *ref )
+{
+  double sum = 0;
+  double squares = 0;
+
+  ref->Min = samples[0];
+  ref->Max = samples[0];
+  for( uint16_t i = 0; i < count; i++ )
+  {
+    ref->Min = ( samples[i] < ref->Min ) ? samples[i] : ref->Min;
+    ref->Max = ( samples[i] > ref->Max ) ? samples[i] : ref->Max;
+    sum += samples[i];
+  }
+  ref->Mean = sum / count;
+  for( uint16_t i = 0; i < count; i++ )
+  {
+    squares += ( samples[i] - ref->Mean ) * ( samples[i] - ref->Mean );
+  }
+  ref->Std = ( count > 1 ) ? sqrt( squares / ( count - 1 ) ) : 0;
+}
+
+/* Reference value as the window gives it: rounded half up, saturated */
+static long Expected( double value )
+{
+  double rounded = floor( value + 0.5 );
+
+  return ( rounded > INT16_MAX ) ? INT16_MAX : ( rounded < INT16_MIN ) ? INT16_MIN : ( long )rounded;
+}
+
+/* Pushes the samples in a window of the capacity given and summarizes it,
+   returns the errors of the mean and of the standard deviation, the latter
+   beyond MAX_STD_RELATIVE */
+static void Check( const int16_t *samples, uint16_t count, uint16_t capacity,
+                   long *meanError, long *stdError )
+{
+  SensorWindowStats_t stats;
+  Reference_t ref;
+  uint16_t held = ( count < capacity ) ? count : capacity;
+
+  SensorWindowInit( &Window, Storage, capacity );
+  for( uint16_t i = 0; i < count; i++ )
+  {
+    SensorWindowPush( &Window, samples[i] );
+  }
+  Reference( &samples[count - held], held, &ref );
+
+  UT_ASSERT( SensorWindowFlush( &Window, &stats ) );
+  UT_ASSERT_EQ( stats.Count, held );
+  UT_ASSERT_EQ( stats.Min, ref.Min );
+  UT_ASSERT_EQ( stats.Max, ref.Max );
+  *meanError = labs( stats.Mean - Expected( ref.Mean ) );
+  *stdError = labs( stats.Std - Expected( ref.Std ) ) - ( long )( ref.Std * MAX_STD_RELATIVE );
+  *stdError = ( *stdError > 0 ) ? *stdError : 0;
+
+  /* flushed */
+  UT_ASSERT_EQ( Window.Count, 0 );
+  UT_ASSERT( !SensorWindowFlush( &Window, &stats ) );
+}
+
+static void test_random_windows( void )
+{
+  /* sensor noise, slow drifts, then the whole 16 bit range */
+  static const int32_t spreads[] = { 4, 60, 1000, 12000, 40000, 65535 };
+  static int16_t samples[WINDOW_SIZE];
+  long worstMean = 0;
+  long worstStd = 0;
+  long worstWideMean = 0;
+  long worstWideStd = 0;
+  long meanError;
+  long stdError;
+
+  srand( 1 );
+  for( int w = 0; w < NB_RANDOM_WINDOWS; w++ )
+  {
+    int32_t spread = spreads[w % ( sizeof( spreads ) / sizeof( spreads[0] ) )];
+    int32_t base = INT16_MIN + rand( ) % ( 65536 - spread );
+    uint16_t count = 2 + rand( ) % ( WINDOW_SIZE - 1 );
+    bool wide = false;
+
+    for( uint16_t i = 0; i < count; i++ )
+    {
+      samples[i] = ( int16_t )( base + rand( ) % spread );
+    }
+    Check( samples, count, WINDOW_SIZE, &meanError, &stdError );
+
+    /* halved when the deviation from the center passes 0x3FFF */
+    for( uint16_t i = 0; i < count; i++ )
+    {
+      for( uint16_t j = 0; j < count; j++ )
+      {
+        wide |= ( samples[i] - samples[j] > 2 * 0x3FFF + 1 );
+      }
+    }
+    if( wide )
+    {
+      worstWideMean = ( meanError > worstWideMean ) ? meanError : worstWideMean;
+      worstWideStd = ( stdError > worstWideStd ) ? stdError : worstWideStd;
+    }
+    else
+    {
+      worstMean = ( meanError > worstMean ) ? meanError : worstMean;
+      worstStd = ( stdError > worstStd ) ? stdError : worstStd;
+    }
+  }
+  printf( "  %d windows, worst error: mean %ld std %ld (beyond 0.1 %%), halved mean %ld std %ld\n",
+          NB_RANDOM_WINDOWS, worstMean, worstStd, worstWideMean, worstWideStd );
+  UT_ASSERT( worstMean <= MAX_MEAN_ERROR );
+  UT_ASSERT( worstStd <= MAX_STD_ERROR );
+  UT_ASSERT( worstWideMean <= MAX_WIDE_MEAN_ERROR );
+  UT_ASSERT( worstWideStd <= MAX_WIDE_STD_ERROR );
+}
+
+static void test_ring_wrap_around( void )
+{
+  int16_t samples[3 * 8 + 5];
+  long meanError;
+  long stdError;
+
+  for( uint16_t i = 0; i < sizeof( samples ) / sizeof( samples[0] ); i++ )
+  {
+    samples[i] = ( int16_t )( 2150 + ( ( i * 37 ) % 23 ) - 11 );
+  }
+
+  /* the samples held are the newest ones, newest first */
+  SensorWindowInit( &Window, Storage, 8 );
+  for( uint16_t i = 0; i < sizeof( samples ) / sizeof( samples[0] ); i++ )
+  {
+    SensorWindowPush( &Window, samples[i] );
+  }
+  UT_ASSERT_EQ( Window.Count, 8 );
+  for( uint16_t age = 0; age < 8; age++ )
+  {
+    UT_ASSERT_EQ( SensorWindowGetSample( &Window, age ),
+                  samples[sizeof( samples ) / sizeof( samples[0] ) - 1 - age] );
+  }
+
+  /* and the summary is theirs, whatever the position of the head */
+  for( uint16_t count = 8; count <= sizeof( samples ) / sizeof( samples[0] ); count++ )
+  {
+    Check( samples, count, 8, &meanError, &stdError );
+    UT_ASSERT( meanError <= MAX_MEAN_ERROR );
+    UT_ASSERT( stdError <= MAX_STD_ERROR );
+  }
+
+  /* a window filled again after a flush starts at its head */
+  Check( samples, 3, 8, &meanError, &stdError );
+  UT_ASSERT_EQ( meanError, 0 );
+}
+
+static void test_extreme_values( void )
+{
+  static const int16_t high[] = { INT16_MAX, INT16_MAX - 1, INT16_MAX - 3, INT16_MAX };
+  static const int16_t low[] = { INT16_MIN, INT16_MIN + 2, INT16_MIN, INT16_MIN + 1 };
+  static const int16_t both[] = { INT16_MIN, INT16_MAX };
+  static const int16_t spread[] = { INT16_MIN, 0, INT16_MAX, -1, INT16_MIN + 1, INT16_MAX - 1 };
+  SensorWindowStats_t stats;
+  long meanError;
+  long stdError;
+
+  Check( high, 4, WINDOW_SIZE, &meanError, &stdError );
+  UT_ASSERT( meanError <= MAX_MEAN_ERROR );
+  UT_ASSERT( stdError <= MAX_STD_ERROR );
+  Check( low, 4, WINDOW_SIZE, &meanError, &stdError );
+  UT_ASSERT( meanError <= MAX_MEAN_ERROR );
+  UT_ASSERT( stdError <= MAX_STD_ERROR );
+  Check( spread, 6, WINDOW_SIZE, &meanError, &stdError );
+  UT_ASSERT( meanError <= MAX_WIDE_MEAN_ERROR );
+  UT_ASSERT( stdError <= MAX_WIDE_STD_ERROR );
+
+  /* the standard deviation of the two ends, 46341, saturates */
+  SensorWindowInit( &Window, Storage, WINDOW_SIZE );
+  SensorWindowPush( &Window, both[0] );
+  SensorWindowPush( &Window, both[1] );
+  UT_ASSERT( SensorWindowFlush( &Window, &stats ) );
+  UT_ASSERT_EQ( stats.Min, INT16_MIN );
+  UT_ASSERT_EQ( stats.Max, INT16_MAX );
+  UT_ASSERT( stats.Mean >= -1 && stats.Mean <= 0 );
+  UT_ASSERT_EQ( stats.Std, INT16_MAX );
+}
+
+static void test_single_sample( void )
+{
+  static const int16_t values[] = { 0, 1, -1, 2154, -4000, INT16_MAX, INT16_MIN };
+  SensorWindowStats_t stats;
+
+  for( uint8_t i = 0; i < sizeof( values ) / sizeof( values[0] ); i++ )
+  {
+    SensorWindowInit( &Window, Storage, WINDOW_SIZE );
+    SensorWindowPush( &Window, values[i] );
+    UT_ASSERT( SensorWindowFlush( &Window, &stats ) );
+    UT_ASSERT_EQ( stats.Count, 1 );
+    UT_ASSERT_EQ( stats.Min, values[i] );
+    UT_ASSERT_EQ( stats.Max, values[i] );
+    UT_ASSERT_EQ( stats.Mean, values[i] );
+    UT_ASSERT_EQ( stats.Std, 0 );
+  }
+
+  /* and a window of one sample through the ring */
+  SensorWindowInit( &Window, Storage, 1 );
+  SensorWindowPush( &Window, 10 );
+  SensorWindowPush( &Window, 20 );
+  UT_ASSERT( SensorWindowFlush( &Window, &stats ) );
+  UT_ASSERT_EQ( stats.Count, 1 );
+  UT_ASSERT_EQ( stats.Mean, 20 );
+}
+
+static void test_constant_window( void )
+{
+  static const int16_t values[] = { 0, 7, -7, 10132, INT16_MAX, INT16_MIN, INT16_MIN + 1 };
+  SensorWindowStats_t stats;
+
+  for( uint8_t i = 0; i < sizeof( values ) / sizeof( values[0] ); i++ )
+  {
+    SensorWindowInit( &Window, Storage, WINDOW_SIZE );
+    for( uint16_t n = 0; n < WINDOW_SIZE + 3; n++ )
+    {
+      SensorWindowPush( &Window, values[i] );
+    }
+    UT_ASSERT( SensorWindowFlush( &Window, &stats ) );
+    UT_ASSERT_EQ( stats.Count, WINDOW_SIZE );
+    UT_ASSERT_EQ( stats.Min, values[i] );
+    UT_ASSERT_EQ( stats.Max, values[i] );
+    UT_ASSERT_EQ( stats.Mean, values[i] );
+    UT_ASSERT_EQ( stats.Std, 0 );
+  }
+}
+
+static void test_rounding( void )
+{
+  static const int16_t halfUp[] = { 0, 1 };
+  static const int16_t halfDown[] = { -1, 0 };
+  static const int16_t thirds[] = { 100, 100, 101 };
+  static const int16_t twoThirds[] = { 100, 101, 101 };
+  SensorWindowStats_t stats;
+
+  /* the means are rounded to the nearest unit, the halves up */
+  SensorWindowInit( &Window, Storage, WINDOW_SIZE );
+  SensorWindowPush( &Window, halfUp[0] );
+  SensorWindowPush( &Window, halfUp[1] );
+  SensorWindowFlush( &Window, &stats );
+  UT_ASSERT_EQ( stats.Mean, 1 );
+
+  SensorWindowPush( &Window, halfDown[0] );
+  SensorWindowPush( &Window, halfDown[1] );
+  SensorWindowFlush( &Window, &stats );
+  UT_ASSERT_EQ( stats.Mean, 0 );
+
+  SensorWindowPush( &Window, thirds[0] );
+  SensorWindowPush( &Window, thirds[1] );
+  SensorWindowPush( &Window, thirds[2] );
+  SensorWindowFlush( &Window, &stats );
+  UT_ASSERT_EQ( stats.Mean, 100 );
+  /* sqrt( 1 / 3 ) */
+  UT_ASSERT_EQ( stats.Std, 1 );
+
+  SensorWindowPush( &Window, twoThirds[0] );
+  SensorWindowPush( &Window, twoThirds[1] );
+  SensorWindowPush( &Window, twoThirds[2] );
+  SensorWindowFlush( &Window, &stats );
+  UT_ASSERT_EQ( stats.Mean, 101 );
+}
+
+int main( void )
+{
+  UT_RUN( test_random_windows );
+  UT_RUN( test_ring_wrap_around );
+  UT_RUN( test_extreme_values );
+  UT_RUN( test_single_sample );
+  UT_RUN( test_constant_window );
+  UT_RUN( test_rounding );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,341 @@
+/**
+  ******************************************************************************
+  * @file    test_slot_schedule.c
+  * @author  MCD Application Team
+  * @brief   Class B slot schedule of LoRaMacClassB.c on a virtual clock: the
+  *          ping offsets, frequencies and slot times cached per beacon period
+  *          match the per slot computation, for the unicast address and the
+  *          multicast groups, and the slot randomization key is set up once
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+/* the schedule is private to the class B module, which is built in this unit */
+#include "LoRaMacClassB.c"
+#include "hw.h"
+#include "aes.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR              0x26011B01
+#define UNICAST_PING_NB       8
+
+/* Local time and GPS time of the first beacon */
+#define FIRST_BEACON_RX       1000000
+#define FIRST_BEACON_TIME     1234567808
+
+/* Floor plan of the stand-in region, 8 beacon channels so that the slots hop */
+#define BEACON_FREQ           923300000
+#define BEACON_STEPWIDTH      600000
+#define BEACON_NB_CHANNELS    8
+
+#define RADIO_WAKEUP_TIME     3
+
+/* Beacon periods of the schedule test, the one given missed */
+#define NB_PERIODS            6
+#define MISSED_PERIOD         3
+
+/* Step of the slot time comparison, prime to the ping slot window */
+#define TIME_STEP             997
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static LoRaMacParams_t MacParams;
+static LoRaMacRegion_t MacRegion = LORAMAC_REGION_EU868;
+static MlmeIndication_t MlmeIndication;
+static McpsIndication_t McpsIndication;
+static MlmeConfirm_t MlmeConfirm;
+static LoRaMacFlags_t MacFlags;
+static uint32_t DevAddr = DEV_ADDR;
+static MulticastCtx_t MulticastChannels[LORAMAC_MAX_MC_CTX];
+
+static uint32_t ZeroKeySets;
+static uint32_t SeNvmChanges;
+
+/* Private functions ---------------------------------------------------------*/
+/* Radio and region stand-ins */
+static uint32_t RadioRandom( void )
+{
+  return 0x12345678;
+}
+
+static uint32_t RadioGetWakeupTime( void )
+{
+  return RADIO_WAKEUP_TIME;
+}
+
+const struct Radio_s Radio = { .Random = RadioRandom, .GetWakeupTime = RadioGetWakeupTime };
+
+PhyParam_t RegionGetPhyParam( LoRaMacRegion_t region, GetPhyParams_t* getPhy )
+{
+  PhyParam_t phyParam = { 0 };
+
+  switch( getPhy->Attribute )
+  {
+    case PHY_BEACON_CHANNEL_FREQ:
+      phyParam.Value = BEACON_FREQ;
+      break;
+    case PHY_BEACON_CHANNEL_STEPWIDTH:
+      phyParam.Value = BEACON_STEPWIDTH;
+      break;
+    case PHY_BEACON_NB_CHANNELS:
+      phyParam.Value = BEACON_NB_CHANNELS;
+      break;
+    default:
+      break;
+  }
+  return phyParam;
+}
+
+bool RegionVerify( LoRaMacRegion_t region, VerifyParams_t* verify, PhyAttribute_t phyAttribute )
+{
+  return true;
+}
+
+bool RegionRxConfig( LoRaMacRegion_t region, RxConfigParams_t* rxConfig, int8_t* datarate )
+{
+  return true;
+}
+
+void RegionComputeRxWindowParameters( LoRaMacRegion_t region, int8_t datarate, uint8_t minRxSymbols,
+                                      uint32_t rxError, RxConfigParams_t *rxConfigParams )
+{
+}
+
+void RegionRxBeaconSetup( LoRaMacRegion_t region, RxBeaconSetup_t* rxBeaconSetup, uint8_t* outDr )
+{
+}
+
+void LoRaMacConfirmQueueSetStatus( LoRaMacEventInfoStatus_t status, Mlme_t request )
+{
+}
+
+bool LoRaMacConfirmQueueIsCmdActive( Mlme_t request )
+{
+  return false;
+}
+
+SecureElementStatus_t __real_SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key );
+
+/* Linked with --wrap=SecureElementSetKey */
+SecureElementStatus_t __wrap_SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
+{
+  static const uint8_t zeroKey[16] = { 0 };
+
+  if( ( keyID == SLOT_RAND_ZERO_KEY ) && ( memcmp( key, zeroKey, sizeof( zeroKey ) ) == 0 ) )
+  {
+    ZeroKeySets++;
+  }
+  return __real_SecureElementSetKey( keyID, key );
+}
+
+static void OnSeNvmChange( void )
+{
+  SeNvmChanges++;
+}
+
+static void OnClassBNvmChange( void )
+{
+}
+
+static uint16_t GetTemperature( void )
+{
+  return 25;
+}
+
+static void Setup( void )
+{
+  LoRaMacClassBParams_t params = { 0 };
+  LoRaMacClassBCallback_t callbacks = { 0 };
+  static const uint8_t pingNb[] = { 1, 16, 128, 4 };
+
+  params.MlmeIndication = &MlmeIndication;
+  params.McpsIndication = &McpsIndication;
+  params.MlmeConfirm = &MlmeConfirm;
+  params.LoRaMacFlags = &MacFlags;
+  params.LoRaMacDevAddr = &DevAddr;
+  params.LoRaMacRegion = &MacRegion;
+  params.LoRaMacParams = &MacParams;
+  params.MulticastChannels = MulticastChannels;
+  callbacks.GetTemperatureLevel = GetTemperature;
+
+  for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+  {
+    MulticastChannels[i].AddrID = ( AddressIdentifier_t )( MULTICAST_0_ADDR + i );
+    MulticastChannels[i].Address = 0x2601F0F0 + 0x01010101 * i;
+    MulticastChannels[i].IsEnabled = true;
+    MulticastChannels[i].PingNb = pingNb[i % sizeof( pingNb )];
+    MulticastChannels[i].PingPeriod = CalcPingPeriod( MulticastChannels[i].PingNb );
+  }
+
+  ZeroKeySets = 0;
+  SeNvmChanges = 0;
+  UT_ASSERT_EQ( SecureElementInit( OnSeNvmChange ), SECURE_ELEMENT_SUCCESS );
+  LoRaMacClassBInit( &params, &callbacks, OnClassBNvmChange );
+
+  NvmCtx.PingSlotCtx.PingNb = UNICAST_PING_NB;
+  NvmCtx.PingSlotCtx.PingPeriod = CalcPingPeriod( UNICAST_PING_NB );
+}
+
+/* Ping offset of the specification: aes128_encrypt( 16 x 0x00, beaconTime | address | pad16 ) */
+static uint16_t AesPingOffset( uint32_t beaconTime, uint32_t address, uint16_t pingPeriod )
+{
+  uint8_t zeroKey[16] = { 0 };
+  uint8_t block[16] = { beaconTime & 0xFF, ( beaconTime >> 8 ) & 0xFF, ( beaconTime >> 16 ) & 0xFF,
+                        ( beaconTime >> 24 ) & 0xFF, address & 0xFF, ( address >> 8 ) & 0xFF,
+                        ( address >> 16 ) & 0xFF, ( address >> 24 ) & 0xFF };
+  uint8_t cipher[16];
+  aes_context ctx;
+
+  aes_set_key( zeroKey, 16, &ctx );
+  aes_encrypt( block, cipher, &ctx );
+  return ( cipher[0] + cipher[1] * 256 ) % pingPeriod;
+}
+
+/* CalcNextSlotTime as it was, the beacon period start derived on each slot */
+static bool RefNextSlotTime( uint16_t slotOffset, uint16_t pingPeriod, uint16_t pingNb, TimerTime_t* timeOffset )
+{
+  uint8_t currentPingSlot = 0;
+  TimerTime_t slotTime = 0;
+  TimerTime_t currentTime = TimerGetCurrentTime( );
+
+  slotTime = ( ( currentTime - NvmCtx.BeaconCtx.LastBeaconRx ) % CLASSB_BEACON_INTERVAL );
+  slotTime = currentTime - slotTime;
+
+  slotTime += CLASSB_BEACON_RESERVED;
+  slotTime += slotOffset * CLASSB_PING_SLOT_WINDOW;
+
+  if( slotTime < currentTime )
+  {
+    currentPingSlot = ( ( currentTime - slotTime ) /
+                      ( pingPeriod * CLASSB_PING_SLOT_WINDOW ) ) + 1;
+    slotTime += ( ( TimerTime_t )( currentPingSlot * pingPeriod ) *
+                CLASSB_PING_SLOT_WINDOW );
+  }
+
+  if( currentPingSlot < pingNb )
+  {
+    if( slotTime <= ( NvmCtx.BeaconCtx.NextBeaconRx - CLASSB_BEACON_GUARD - CLASSB_PING_SLOT_WINDOW ) )
+    {
+      slotTime -= currentTime;
+      slotTime -= Radio.GetWakeupTime( );
+      slotTime = TimerTempCompensation( slotTime, NvmCtx.BeaconCtx.Temperature );
+      *timeOffset = slotTime;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* The cached entry against the per slot computation of the beacon period */
+static void CheckEntry( const LoRaMacClassBSlotEntry_t *entry, uint32_t address, uint16_t pingPeriod )
+{
+  uint16_t pingOffset;
+
+  ComputePingOffset( NvmCtx.BeaconCtx.BeaconTime, address, pingPeriod, &pingOffset );
+  UT_ASSERT( entry->IsValid );
+  UT_ASSERT_EQ( entry->PingOffset, pingOffset );
+  UT_ASSERT_EQ( entry->PingOffset, AesPingOffset( NvmCtx.BeaconCtx.BeaconTime, address, pingPeriod ) );
+  UT_ASSERT_EQ( entry->Frequency, CalcDownlinkChannelAndFrequency( address, NvmCtx.BeaconCtx.BeaconTime,
+                                                                     CLASSB_BEACON_INTERVAL ) );
+}
+
+/* Next slot of an address at the current time, cached and per slot */
+static void CheckSlotTime( uint16_t pingOffset, uint16_t pingPeriod, uint8_t pingNb )
+{
+  TimerTime_t cached = 0;
+  TimerTime_t reference = 0;
+  bool isCached = CalcNextSlotTime( pingOffset, pingPeriod, pingNb, &cached );
+
+  UT_ASSERT_EQ( isCached, RefNextSlotTime( pingOffset, pingPeriod, pingNb, &reference ) );
+  UT_ASSERT_EQ( cached, reference );
+}
+
+static void test_schedule_matches_per_slot( void )
+{
+  uint32_t prevFrequency = 0;
+
+  Setup( );
+  for( uint32_t k = 0; k < NB_PERIODS; k++ )
+  {
+    TimerTime_t periodStart = FIRST_BEACON_RX + k * CLASSB_BEACON_INTERVAL;
+
+    /* the beacon time moves on with a missed beacon, the last reception not */
+    NvmCtx.BeaconCtx.BeaconTime = FIRST_BEACON_TIME + k * ( CLASSB_BEACON_INTERVAL / 1000 );
+    if( k != MISSED_PERIOD )
+    {
+      NvmCtx.BeaconCtx.LastBeaconRx = periodStart;
+    }
+    NvmCtx.BeaconCtx.NextBeaconRx = periodStart + CLASSB_BEACON_INTERVAL;
+    HostRtcSet( periodStart + 50 );
+    UpdateSlotSchedule( TimerGetCurrentTime( ) );
+
+    UT_ASSERT_EQ( Ctx.SlotSchedule.BeaconTime, NvmCtx.BeaconCtx.BeaconTime );
+    UT_ASSERT_EQ( Ctx.SlotSchedule.PeriodStart, periodStart );
+    CheckEntry( &Ctx.SlotSchedule.PingSlot, DEV_ADDR, NvmCtx.PingSlotCtx.PingPeriod );
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+      CheckEntry( &Ctx.SlotSchedule.MulticastSlots[i], MulticastChannels[i].Address,
+                  MulticastChannels[i].PingPeriod );
+    }
+
+    /* the floor plan hops every period */
+    UT_ASSERT( Ctx.SlotSchedule.PingSlot.Frequency != prevFrequency );
+    prevFrequency = Ctx.SlotSchedule.PingSlot.Frequency;
+
+    /* through the period and the next one, which has no schedule yet */
+    for( TimerTime_t t = periodStart; t < periodStart + 2 * CLASSB_BEACON_INTERVAL; t += TIME_STEP )
+    {
+      HostRtcSet( t );
+      CheckSlotTime( Ctx.SlotSchedule.PingSlot.PingOffset, NvmCtx.PingSlotCtx.PingPeriod, UNICAST_PING_NB );
+      for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+      {
+        CheckSlotTime( Ctx.SlotSchedule.MulticastSlots[i].PingOffset, MulticastChannels[i].PingPeriod,
+                       MulticastChannels[i].PingNb );
+      }
+    }
+  }
+}
+
+static void test_zero_key_set_once( void )
+{
+  Setup( );
+  UT_ASSERT_EQ( ZeroKeySets, 1 );
+  UT_ASSERT_EQ( SeNvmChanges, 1 );
+
+  /* nor for the schedules of the next periods, or a group changing address */
+  for( uint32_t k = 0; k < NB_PERIODS; k++ )
+  {
+    NvmCtx.BeaconCtx.BeaconTime = FIRST_BEACON_TIME + k * ( CLASSB_BEACON_INTERVAL / 1000 );
+    NvmCtx.BeaconCtx.LastBeaconRx = FIRST_BEACON_RX + k * CLASSB_BEACON_INTERVAL;
+    HostRtcSet( NvmCtx.BeaconCtx.LastBeaconRx + 50 );
+    UpdateSlotSchedule( TimerGetCurrentTime( ) );
+    MulticastChannels[0].Address++;
+    UpdateSlotEntry( &Ctx.SlotSchedule.MulticastSlots[0], MulticastChannels[0].Address,
+                     MulticastChannels[0].PingPeriod );
+  }
+  UT_ASSERT_EQ( ZeroKeySets, 1 );
+  UT_ASSERT_EQ( SeNvmChanges, 1 );
+}
+
+int main( void )
+{
+  UT_RUN( test_schedule_matches_per_slot );
+  UT_RUN( test_zero_key_set_once );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
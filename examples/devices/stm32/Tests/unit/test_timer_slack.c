@@ -0,0 +1,261 @@
+/**
+  ******************************************************************************
+  * @file    test_timer_slack.c
+  * @author  MCD Application Team
+  * @brief   Timer slack of timeServer.c on the virtual RTC: timers with
+  *          overlapping windows share one alarm, zero slack timers fire on
+  *          time, a timer started inside the armed window brings the alarm
+  *          forward, and the timers of End_Node wake the MCU less often
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "hw.h"
+#include "timeServer.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define NB_TIMERS             4
+
+/* Timers of End_Node (main.c), in ms */
+#define SENSOR_SAMPLE_PERIOD          1000
+#define SENSOR_SAMPLE_PERIOD_SLACK    100
+#define APP_TX_DUTYCYCLE_SLACK        500
+#define TX_LED_TIME                   200
+#define TX_LED_SLACK                  100
+
+/* Uplink period of the wake-up count, not a multiple of the sampling period */
+#define TX_PERIOD                     30250
+
+#define ONE_HOUR                      3600000
+
+/* Private typedef -----------------------------------------------------------*/
+/* Timer of the test and when it fired */
+typedef struct
+{
+  TimerEvent_t Timer;
+  uint32_t Fired;
+  uint32_t FiredAt;
+} TestTimer_t;
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static TestTimer_t Timers[NB_TIMERS];
+
+static TimerEvent_t SampleTimer;
+static TimerEvent_t TxTimer;
+static TimerEvent_t TxLedTimer;
+static bool AppSlack;
+
+/* Private functions ---------------------------------------------------------*/
+static void OnTimer( void *context )
+{
+  TestTimer_t *timer = ( TestTimer_t * )context;
+
+  timer->Fired++;
+  timer->FiredAt = HW_RTC_GetTimerValue( );
+}
+
+static void Setup( void )
+{
+  for( uint8_t i = 0; i < NB_TIMERS; i++ )
+  {
+    TimerStop( &Timers[i].Timer );
+    TimerInit( &Timers[i].Timer, OnTimer );
+    TimerSetContext( &Timers[i].Timer, &Timers[i] );
+    Timers[i].Fired = 0;
+    Timers[i].FiredAt = 0;
+  }
+  TimerStop( &SampleTimer );
+  TimerStop( &TxTimer );
+  TimerStop( &TxLedTimer );
+  HostRtcSet( 0 );
+  HW_RTC_SetTimerContext( );
+  HostRtcSetMcuWakeUpTime( 0 );
+}
+
+static void Start( uint8_t i, uint32_t value, uint32_t slack )
+{
+  TimerSetValue( &Timers[i].Timer, value );
+  TimerSetSlack( &Timers[i].Timer, slack );
+  TimerStart( &Timers[i].Timer );
+}
+
+static uint32_t GetAlarm( void )
+{
+  uint32_t alarm;
+
+  UT_ASSERT( HostRtcGetAlarm( &alarm ) );
+  return alarm;
+}
+
+/* Runs the virtual clock for ms, returns the RTC wake-ups */
+static uint32_t Run( uint32_t ms )
+{
+  uint32_t end = HW_RTC_GetTimerValue( ) + ms;
+  uint32_t wakeUps = 0;
+  uint32_t alarm;
+  uint32_t now;
+
+  while( ( HostRtcGetAlarm( &alarm ) == true ) && ( ( int32_t )( alarm - end ) <= 0 ) )
+  {
+    now = HW_RTC_GetTimerValue( );
+    HostRtcRun( ( ( int32_t )( alarm - now ) > 0 ) ? ( alarm - now ) : 0 );
+    wakeUps++;
+  }
+  HostRtcRun( end - HW_RTC_GetTimerValue( ) );
+  return wakeUps;
+}
+
+static void test_overlapping_windows_share_alarm( void )
+{
+  Setup( );
+  Start( 0, 1000, 200 );      /* [1000, 1200] */
+  Start( 1, 1100, 50 );       /* [1100, 1150] */
+  Start( 2, 1300, 100 );      /* [1300, 1400], apart */
+
+  /* the alarm closes the window ending first */
+  UT_ASSERT_EQ( GetAlarm( ), 1150 );
+  UT_ASSERT_EQ( Run( 1150 ), 1 );
+  UT_ASSERT_EQ( Timers[0].Fired, 1 );
+  UT_ASSERT_EQ( Timers[0].FiredAt, 1150 );
+  UT_ASSERT_EQ( Timers[1].Fired, 1 );
+  UT_ASSERT_EQ( Timers[1].FiredAt, 1150 );
+  UT_ASSERT_EQ( Timers[2].Fired, 0 );
+
+  UT_ASSERT_EQ( Run( 1000 ), 1 );
+  UT_ASSERT_EQ( Timers[2].FiredAt, 1400 );
+}
+
+static void test_zero_slack_on_time( void )
+{
+  /* the window of a slack timer overlaps the deadline of a zero slack one */
+  Setup( );
+  Start( 0, 400, 300 );
+  Start( 1, 500, 0 );
+  Start( 2, 600, 1000 );
+  UT_ASSERT_EQ( Run( 2000 ), 2 );
+  UT_ASSERT_EQ( Timers[1].FiredAt, 500 );
+  UT_ASSERT_EQ( Timers[0].FiredAt, 500 );
+
+  /* a timer not yet due is not run early with them */
+  UT_ASSERT_EQ( Timers[2].FiredAt, 1600 );
+
+  /* nor when it comes first, the later windows are not waited for */
+  Setup( );
+  Start( 0, 300, 0 );
+  Start( 1, 310, 500 );
+  Start( 2, 320, 500 );
+  UT_ASSERT_EQ( Run( 2000 ), 2 );
+  UT_ASSERT_EQ( Timers[0].FiredAt, 300 );
+  UT_ASSERT_EQ( Timers[1].FiredAt, 810 );
+  UT_ASSERT_EQ( Timers[2].FiredAt, 810 );
+
+  /* alone, it fires at its deadline */
+  Setup( );
+  Start( 3, 700, 0 );
+  UT_ASSERT_EQ( Run( 2000 ), 1 );
+  UT_ASSERT_EQ( Timers[3].FiredAt, 700 );
+}
+
+static void test_start_inside_armed_window( void )
+{
+  Setup( );
+  Start( 0, 1000, 500 );
+  UT_ASSERT_EQ( GetAlarm( ), 1500 );
+
+  /* at 100, a zero slack timer due at 1100 inside the window [1000, 1500] */
+  Run( 100 );
+  Start( 1, 1000, 0 );
+  UT_ASSERT_EQ( GetAlarm( ), 1100 );
+  UT_ASSERT_EQ( Run( 2000 ), 1 );
+  UT_ASSERT_EQ( Timers[0].FiredAt, 1100 );
+  UT_ASSERT_EQ( Timers[1].FiredAt, 1100 );
+
+  /* a window closing after the alarm leaves it where it is */
+  Setup( );
+  Start( 0, 1000, 500 );
+  Run( 100 );
+  Start( 1, 1200, 300 );
+  UT_ASSERT_EQ( GetAlarm( ), 1500 );
+  UT_ASSERT_EQ( Run( 2000 ), 1 );
+  UT_ASSERT_EQ( Timers[1].FiredAt, 1500 );
+}
+
+/* End_Node: sampling restarted on each sample, an uplink every TX_PERIOD and
+   the led switched off after each uplink */
+static void OnSampleTimerEvent( void *context )
+{
+  TimerStart( &SampleTimer );
+}
+
+static void OnTxLedTimerEvent( void *context )
+{
+}
+
+static void OnTxTimerEvent( void *context )
+{
+  TimerSetValue( &TxLedTimer, TX_LED_TIME );
+  TimerSetSlack( &TxLedTimer, ( AppSlack == true ) ? TX_LED_SLACK : 0 );
+  TimerStart( &TxLedTimer );
+  TimerStart( &TxTimer );
+}
+
+static uint32_t AppWakeUpsPerHour( bool slack )
+{
+  Setup( );
+  AppSlack = slack;
+  TimerInit( &SampleTimer, OnSampleTimerEvent );
+  TimerSetValue( &SampleTimer, SENSOR_SAMPLE_PERIOD );
+  TimerSetSlack( &SampleTimer, ( slack == true ) ? SENSOR_SAMPLE_PERIOD_SLACK : 0 );
+  TimerStart( &SampleTimer );
+  TimerInit( &TxTimer, OnTxTimerEvent );
+  TimerSetValue( &TxTimer, TX_PERIOD );
+  TimerSetSlack( &TxTimer, ( slack == true ) ? APP_TX_DUTYCYCLE_SLACK : 0 );
+  TimerStart( &TxTimer );
+  TimerInit( &TxLedTimer, OnTxLedTimerEvent );
+
+  return Run( ONE_HOUR );
+}
+
+static void test_app_wake_ups( void )
+{
+  uint32_t exact = AppWakeUpsPerHour( false );
+  uint32_t coalesced = AppWakeUpsPerHour( true );
+
+  printf( "  wake-ups per hour: %u without slack, %u with the End_Node slack\n",
+          ( unsigned )exact, ( unsigned )coalesced );
+
+  /* one sample per second, one uplink and one led per TX_PERIOD, every
+     fourth uplink on a sample */
+  UT_ASSERT_EQ( exact, ONE_HOUR / SENSOR_SAMPLE_PERIOD + 2 * ( ONE_HOUR / TX_PERIOD ) -
+                       ONE_HOUR / ( 4 * TX_PERIOD ) );
+
+  /* the led shares the wake-up of a sample, the samples stretch in their slack */
+  UT_ASSERT( coalesced < exact );
+}
+
+int main( void )
+{
+  UT_RUN( test_overlapping_windows_share_alarm );
+  UT_RUN( test_zero_slack_on_time );
+  UT_RUN( test_start_inside_armed_window );
+  UT_RUN( test_app_wake_ups );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,201 @@
+/**
+  ******************************************************************************
+  * @file    test_trace.c
+  * @author  MCD Application Team
+  * @brief   Text traces (trace.c): messages split over the end of the queue,
+  *          traces from interrupts preempting TraceSend, drop counting.
+  *          Preemption is modelled by running the "interrupt" from the copy
+  *          of the preempted trace into its queue (memcpy is wrapped)
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "vcom.h"
+#include "unit_test.h"
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t Output[VCOM_CAPTURE_SIZE + 1];
+
+/* Interrupts to run from the next copies, innermost last */
+static void ( *PendingIrq[2] )( void );
+static int PendingIrqNb;
+
+/* Private functions ---------------------------------------------------------*/
+void *__real_memcpy( void *dst, const void *src, size_t n );
+
+void *__wrap_memcpy( void *dst, const void *src, size_t n )
+{
+  if( PendingIrqNb > 0 )
+  {
+    void ( *irq )( void ) = PendingIrq[0];
+
+    PendingIrq[0] = PendingIrq[1];
+    PendingIrqNb--;
+    irq( );
+  }
+  return __real_memcpy( dst, src, n );
+}
+
+static const char *Drain( void )
+{
+  uint32_t len;
+
+  while( vcom_Complete( ) != 0 )
+  {
+  }
+  len = vcom_Capture( Output );
+  Output[len] = '\0';
+  return ( const char * )Output;
+}
+
+static void Setup( void )
+{
+  vcom_SetAutoComplete( 1 );
+  TraceInit( );
+  PendingIrqNb = 0;
+}
+
+static void IrqTrace( void )
+{
+  UT_ASSERT_EQ( TraceSend( "irq;" ), 0 );
+}
+
+static void NestedIrqTrace( void )
+{
+  UT_ASSERT_EQ( TraceSend( "nested;" ), -1 );
+}
+
+static void test_trace_in_order( void )
+{
+  Setup( );
+  TraceSend( "a=%d;", 1 );
+  TraceSend( "b=%s;", "x" );
+  UT_ASSERT( strcmp( Drain( ), "a=1;b=x;" ) == 0 );
+  UT_ASSERT_EQ( TraceGetDropped( ), 0 );
+}
+
+static void test_split_over_the_end( void )
+{
+  char msg[DBG_TRACE_MSG_QUEUE_SIZE];
+  char expected[2 * DBG_TRACE_MSG_QUEUE_SIZE];
+
+  Setup( );
+  vcom_SetAutoComplete( 0 );
+
+  /* the first trace is in flight, the second one fills the queue up to its
+     last 40 bytes */
+  memset( msg, 'a', 100 );
+  msg[100] = '\0';
+  TraceSend( "%s", msg );
+  memset( msg, 'b', DBG_TRACE_MSG_QUEUE_SIZE - 140 );
+  msg[DBG_TRACE_MSG_QUEUE_SIZE - 140] = '\0';
+  TraceSend( "%s", msg );
+  vcom_Complete( );
+
+  /* 40 bytes left at the end, 100 free at the start: 90 bytes are split */
+  memset( msg, 'c', 90 );
+  msg[90] = '\0';
+  UT_ASSERT_EQ( TraceSend( "%s", msg ), 0 );
+
+  memset( expected, 'a', 100 );
+  memset( &expected[100], 'b', DBG_TRACE_MSG_QUEUE_SIZE - 140 );
+  memset( &expected[DBG_TRACE_MSG_QUEUE_SIZE - 40], 'c', 90 );
+  expected[DBG_TRACE_MSG_QUEUE_SIZE + 50] = '\0';
+  UT_ASSERT( strcmp( Drain( ), expected ) == 0 );
+  UT_ASSERT_EQ( TraceGetDropped( ), 0 );
+  vcom_SetAutoComplete( 1 );
+}
+
+static void test_longest_trace_in_empty_queue( void )
+{
+  char msg[DBG_TRACE_MSG_QUEUE_SIZE];
+
+  Setup( );
+  vcom_SetAutoComplete( 0 );
+  /* move the indexes to the middle of the buffer */
+  TraceSend( "%0100d", 0 );
+  vcom_Complete( );
+
+  memset( msg, 'l', DBG_TRACE_MSG_QUEUE_SIZE - 1 );
+  msg[DBG_TRACE_MSG_QUEUE_SIZE - 1] = '\0';
+  UT_ASSERT_EQ( TraceSend( "%s", msg ), 0 );
+  UT_ASSERT_EQ( strlen( Drain( ) ), 100 + DBG_TRACE_MSG_QUEUE_SIZE - 1 );
+  vcom_SetAutoComplete( 1 );
+}
+
+static void test_interrupt_preempting_trace( void )
+{
+  Setup( );
+  PendingIrq[0] = IrqTrace;
+  PendingIrqNb = 1;
+  UT_ASSERT_EQ( TraceSend( "main;" ), 0 );
+  UT_ASSERT_EQ( PendingIrqNb, 0 );
+  UT_ASSERT( strcmp( Drain( ), "main;irq;" ) == 0 );
+  UT_ASSERT_EQ( TraceGetDropped( ), 0 );
+}
+
+static void test_nested_interrupts_drop_counted( void )
+{
+  Setup( );
+  PendingIrq[0] = IrqTrace;
+  PendingIrq[1] = NestedIrqTrace;
+  PendingIrqNb = 2;
+  TraceSend( "main;" );
+  UT_ASSERT_EQ( PendingIrqNb, 0 );
+  UT_ASSERT( strcmp( Drain( ), "main;irq;" ) == 0 );
+  UT_ASSERT_EQ( TraceGetDropped( ), 1 );
+
+  /* the next trace reports the drop */
+  TraceSend( "next;" );
+  UT_ASSERT( strcmp( Drain( ), "\r\n[1 traces dropped]\r\nnext;" ) == 0 );
+  UT_ASSERT_EQ( TraceGetDropped( ), 1 );
+}
+
+static void test_full_queue_drop_counted( void )
+{
+  char msg[DBG_TRACE_MSG_QUEUE_SIZE];
+  const char *out;
+
+  Setup( );
+  vcom_SetAutoComplete( 0 );
+  memset( msg, 'f', 200 );
+  msg[200] = '\0';
+  TraceSend( "%s", msg );
+  UT_ASSERT_EQ( TraceSend( "%s", msg ), -1 );
+  UT_ASSERT_EQ( TraceSend( "%s", msg ), -1 );
+  UT_ASSERT_EQ( TraceGetDropped( ), 2 );
+
+  vcom_Complete( );
+  TraceSend( "after;" );
+  out = Drain( );
+  UT_ASSERT( strcmp( out + 200, "\r\n[2 traces dropped]\r\nafter;" ) == 0 );
+  vcom_SetAutoComplete( 1 );
+}
+
+int main( void )
+{
+  UT_RUN( test_trace_in_order );
+  UT_RUN( test_split_over_the_end );
+  UT_RUN( test_longest_trace_in_empty_queue );
+  UT_RUN( test_interrupt_preempting_trace );
+  UT_RUN( test_nested_interrupts_drop_counted );
+  UT_RUN( test_full_queue_drop_counted );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
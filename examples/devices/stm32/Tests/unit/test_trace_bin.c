@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file    test_trace_bin.c
+  * @author  MCD Application Team
+  * @brief   Binary traces (TRACE_BINARY): records the traces of lora.c with
+  *          TPRINTF, renders the capture with Utilities/trace-decode.js and
+  *          this program as the ELF file, and compares the text with what
+  *          the text mode prints
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <unistd.h>
+#include "hw.h"
+#include "vcom.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DECODER           "../Utilities/trace-decode.js"
+
+/* Private macro -------------------------------------------------------------*/
+/* Records the trace and appends its text rendering to Expected */
+#define EXPECT_TPRINTF(...)                                                          \
+  do{                                                                              \
+    ExpectedLen += snprintf( &Expected[ExpectedLen], sizeof( Expected ) - ExpectedLen, \
+                             __VA_ARGS__ );                                        \
+    TPRINTF( __VA_ARGS__ );                                                        \
+  }while(0)
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t Capture[VCOM_CAPTURE_SIZE];
+static char Expected[4096];
+static uint32_t ExpectedLen;
+static char Decoded[4096];
+
+/* Private functions ---------------------------------------------------------*/
+/* Decodes Capture with this program as the ELF file, returns the text length */
+static int Decode( uint32_t len, const char *options )
+{
+  char exe[512];
+  char cmd[1200];
+  FILE *f;
+  ssize_t n = readlink( "/proc/self/exe", exe, sizeof( exe ) - 1 );
+  size_t got;
+
+  exe[( n > 0 ) ? n : 0] = '\0';
+  f = fopen( "build/trace_bin.raw", "wb" );
+  fwrite( Capture, 1, len, f );
+  fclose( f );
+
+  snprintf( cmd, sizeof( cmd ), "node " DECODER " %s %s build/trace_bin.raw", options, exe );
+  f = popen( cmd, "r" );
+  if( f == NULL )
+  {
+    return -1;
+  }
+  got = fread( Decoded, 1, sizeof( Decoded ) - 1, f );
+  Decoded[got] = '\0';
+  return ( pclose( f ) == 0 ) ? ( int )got : -1;
+}
+
+static void Setup( void )
+{
+  vcom_SetAutoComplete( 1 );
+  TraceInit( );
+  ExpectedLen = 0;
+  Expected[0] = '\0';
+}
+
+static void test_lora_frames( void )
+{
+  static const char *slotStrings[] = { "1", "2", "C", "Ping-Slot", "Multicast Ping-Slot" };
+  uint16_t channelsMask[] = { 0x00FF };
+  uint32_t len;
+
+  Setup( );
+  /* TraceUpLinkFrame, TraceDownLinkFrame */
+  EXPECT_TPRINTF( "\r\n" );
+  EXPECT_TPRINTF( "#= U/L FRAME %lu =# Class %c, Port %d, data size %d, pwr %d, ",
+                  ( unsigned long )42, "ABC"[0], 2, 11, -3 );
+  EXPECT_TPRINTF( "Channel Mask " );
+  EXPECT_TPRINTF( "%04X ", channelsMask[0] );
+  EXPECT_TPRINTF( "\r\n\r\n" );
+  EXPECT_TPRINTF( "\r\n" );
+  EXPECT_TPRINTF( "#= D/L FRAME %lu =# RxWin %s, Port %d, data size %d, rssi %d, snr %d\r\n\r\n",
+                  ( unsigned long )7, slotStrings[3], 10, 4, -97, -5 );
+
+  len = vcom_Capture( Capture );
+  /* records only, nothing was formatted on target */
+  UT_ASSERT( memchr( Capture, '#', len ) == NULL );
+  UT_ASSERT_EQ( Decode( len, "" ), ( int )ExpectedLen );
+  UT_ASSERT( strcmp( Decoded, Expected ) == 0 );
+}
+
+static void test_timestamps( void )
+{
+  uint32_t len;
+
+  Setup( );
+  HostRtcRun( 12345 );
+  TPRINTF( "\r\n" );
+  TPRINTF( "#= BEACON %lu =#\r\n", ( unsigned long )1000 );
+  len = vcom_Capture( Capture );
+  UT_ASSERT( Decode( len, "--timestamps --tick-hz 1000" ) > 0 );
+  UT_ASSERT( strcmp( Decoded, "\r\n 12s345: #= BEACON 1000 =#\r\n" ) == 0 );
+}
+
+static void test_dropped_records( void )
+{
+  uint32_t len;
+  uint32_t i;
+
+  Setup( );
+  vcom_SetAutoComplete( 0 );
+  /* the output is stalled on the first record, the ring fills up */
+  for( i = 0; i < DBG_TRACE_BIN_RING_SIZE; i++ )
+  {
+    TPRINTF( "r%d;", i );
+  }
+  UT_ASSERT( TraceGetDropped( ) > 0 );
+  while( vcom_Complete( ) != 0 )
+  {
+  }
+  TPRINTF( "last;" );
+  len = vcom_Capture( Capture );
+  UT_ASSERT( Decode( len, "" ) > 0 );
+  snprintf( Expected, sizeof( Expected ), "[%u binary traces dropped]\r\nlast;", ( unsigned )TraceGetDropped( ) );
+  UT_ASSERT( strstr( Decoded, Expected ) != NULL );
+  vcom_SetAutoComplete( 1 );
+}
+
+int main( void )
+{
+  if( system( "node --version > /dev/null 2>&1" ) != 0 )
+  {
+    printf( "node not found, skipped\n" );
+    return 0;
+  }
+  UT_RUN( test_lora_frames );
+  UT_RUN( test_timestamps );
+  UT_RUN( test_dropped_records );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
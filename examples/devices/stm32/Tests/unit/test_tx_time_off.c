@@ -0,0 +1,252 @@
+/**
+  ******************************************************************************
+  * @file    test_tx_time_off.c
+  * @author  MCD Application Team
+  * @brief   Duty cycle time-off of the MAC on the virtual radio: the
+  *          MIB_TX_TIME_OFF query counts down the band time-off of the last
+  *          uplink and updates nothing, the channels drawn for the uplinks
+  *          are the same with or without queries between them
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "host_radio.h"
+#include "trace.h"
+#include "energy_meter.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR              0x26011B01
+
+/* Uplinks of the channel sequence test */
+#define NB_UPLINKS            8
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t SessionKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+static bool ProcessPending;
+
+/* Private functions ---------------------------------------------------------*/
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void NvmContextChange( LoRaMacNvmCtxModule_t module )
+{
+}
+
+static void MacProcessNotify( void )
+{
+  ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+static LoRaMacCallback_t Callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmContextChange, MacProcessNotify };
+
+/* Runs the MAC on the virtual clock */
+static void Run( uint32_t ms )
+{
+  while( ms-- > 0 )
+  {
+    HostRtcRun( 1 );
+    if( ProcessPending == true )
+    {
+      ProcessPending = false;
+      LoRaMacProcess( );
+    }
+  }
+}
+
+static void MibSet( MibRequestConfirm_t *mibReq )
+{
+  UT_ASSERT_EQ( LoRaMacMibSetRequestConfirm( mibReq ), LORAMAC_STATUS_OK );
+}
+
+/* ABP session of lora.c, in LoRaWAN 1.0.3, with the EU868 duty cycle */
+static void Setup( uint32_t seed )
+{
+  MibRequestConfirm_t mibReq;
+
+  HostRadioReset( seed );
+  UT_ASSERT_EQ( LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 ), LORAMAC_STATUS_OK );
+
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_F_NWK_S_INT_KEY;
+  mibReq.Param.FNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_S_NWK_S_INT_KEY;
+  mibReq.Param.SNwkSIntKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NWK_S_ENC_KEY;
+  mibReq.Param.NwkSEncKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_APP_S_KEY;
+  mibReq.Param.AppSKey = SessionKey;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  MibSet( &mibReq );
+  mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+  mibReq.Param.AbpLrWanVersion.Value = 0x01000300;
+  MibSet( &mibReq );
+
+  LoRaMacTestSetDutyCycleOn( true );
+  LoRaMacStart( );
+}
+
+static TimerTime_t GetTxTimeOff( void )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_TX_TIME_OFF;
+  mibReq.Param.TxTimeOff = 0;
+  UT_ASSERT_EQ( LoRaMacMibGetRequestConfirm( &mibReq ), LORAMAC_STATUS_OK );
+  return mibReq.Param.TxTimeOff;
+}
+
+/* Sends an unconfirmed uplink at DR_3 and runs its reception windows */
+static void Uplink( HostRadioFrame_t *frame )
+{
+  McpsReq_t mcpsReq;
+  uint8_t data = 0;
+
+  mcpsReq.Type = MCPS_UNCONFIRMED;
+  mcpsReq.Req.Unconfirmed.fPort = 2;
+  mcpsReq.Req.Unconfirmed.fBuffer = &data;
+  mcpsReq.Req.Unconfirmed.fBufferSize = 1;
+  mcpsReq.Req.Unconfirmed.Datarate = DR_3;
+  UT_ASSERT_EQ( LoRaMacMcpsRequest( &mcpsReq ), LORAMAC_STATUS_OK );
+  Run( 5000 );
+  UT_ASSERT( HostRadioGetTx( frame ) );
+}
+
+/* Frequencies of NB_UPLINKS uplinks, each sent as soon as the duty cycle
+   allows it, with the time-off queried queries times before each */
+static void UplinkSequence( uint32_t queries, uint32_t *frequencies )
+{
+  HostRadioFrame_t frame;
+
+  Setup( 7 );
+  for( uint8_t i = 0; i < NB_UPLINKS; i++ )
+  {
+    for( uint32_t q = 0; q < queries; q++ )
+    {
+      UT_ASSERT_EQ( GetTxTimeOff( ), 0 );
+    }
+    Uplink( &frame );
+    frequencies[i] = frame.Frequency;
+    Run( GetTxTimeOff( ) );
+  }
+}
+
+static void test_time_off_counts_down( void )
+{
+  HostRadioFrame_t frame;
+  TimerTime_t timeOff;
+  uint32_t txDone;
+
+  Setup( 1 );
+  UT_ASSERT_EQ( GetTxTimeOff( ), 0 );
+  Uplink( &frame );
+  txDone = frame.Time + frame.TimeOnAir;
+
+  /* the 3 default channels share the 1 % band: 99 times the time on air */
+  timeOff = GetTxTimeOff( );
+  UT_ASSERT_EQ( timeOff, 99 * frame.TimeOnAir - ( HAL_GetTick( ) - txDone ) );
+
+  /* queries update nothing */
+  UT_ASSERT_EQ( GetTxTimeOff( ), timeOff );
+  UT_ASSERT_EQ( GetTxTimeOff( ), timeOff );
+
+  Run( 1000 );
+  UT_ASSERT_EQ( GetTxTimeOff( ), timeOff - 1000 );
+  Run( timeOff - 1000 );
+  UT_ASSERT_EQ( GetTxTimeOff( ), 0 );
+}
+
+static void test_no_time_off_without_duty_cycle( void )
+{
+  HostRadioFrame_t frame;
+
+  Setup( 1 );
+  LoRaMacTestSetDutyCycleOn( false );
+  Uplink( &frame );
+  UT_ASSERT_EQ( GetTxTimeOff( ), 0 );
+}
+
+static void test_queries_keep_channel_sequence( void )
+{
+  uint32_t frequencies[NB_UPLINKS];
+  uint32_t queried[NB_UPLINKS];
+  bool hopped = false;
+
+  UplinkSequence( 0, frequencies );
+  UplinkSequence( 5, queried );
+  UT_ASSERT_MEM( queried, frequencies, sizeof( frequencies ) );
+
+  /* the sequence is drawn, not a single channel */
+  for( uint8_t i = 1; i < NB_UPLINKS; i++ )
+  {
+    hopped |= ( frequencies[i] != frequencies[0] );
+  }
+  UT_ASSERT( hopped );
+}
+
+int main( void )
+{
+  /* the MAC traces its radio events and accounts their energy */
+  TraceInit( );
+  EnergyInit( );
+
+  UT_RUN( test_time_off_counts_down );
+  UT_RUN( test_no_time_off_without_duty_cycle );
+  UT_RUN( test_queries_keep_channel_sequence );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
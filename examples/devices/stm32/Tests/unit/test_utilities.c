@@ -0,0 +1,162 @@
+/**
+  ******************************************************************************
+  * @file    test_utilities.c
+  * @author  MCD Application Team
+  * @brief   Memory helpers of utilities.c against the C library, for every
+  *          source and destination alignment and sizes up to 280 bytes, and
+  *          AES-CMAC (cmac.c, which uses them) against the RFC 4493 vectors
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "cmac.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_SIZE      280
+#define BUFF_SIZE     ( MAX_SIZE + 16 )
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static uint8_t Src[BUFF_SIZE] __attribute__( ( aligned( 8 ) ) );
+static uint8_t Dst[BUFF_SIZE] __attribute__( ( aligned( 8 ) ) );
+static uint8_t Ref[BUFF_SIZE] __attribute__( ( aligned( 8 ) ) );
+
+/* Private functions ---------------------------------------------------------*/
+static void Fill( void )
+{
+  for( int i = 0; i < BUFF_SIZE; i++ )
+  {
+    Src[i] = ( uint8_t )( i * 7 + 3 );
+    Dst[i] = ( uint8_t )( i * 13 + 1 );
+  }
+  memcpy( Ref, Dst, BUFF_SIZE );
+}
+
+/* Runs check for all alignments and sizes, reports the first mismatch */
+#define FOR_ALL_ALIGNMENTS( check )                                                \
+  for( int da = 0; da < 4; da++ )                                                  \
+  {                                                                                \
+    for( int sa = 0; sa < 4; sa++ )                                                \
+    {                                                                              \
+      for( int n = 0; n <= MAX_SIZE; n++ )                                         \
+      {                                                                            \
+        Fill( );                                                                   \
+        check;                                                                     \
+        if( memcmp( Ref, Dst, BUFF_SIZE ) != 0 )                                   \
+        {                                                                          \
+          printf( "  dst +%d, src +%d, size %d\n", da, sa, n );                    \
+          UT_ASSERT_MEM( Dst, Ref, BUFF_SIZE );                                    \
+          return;                                                                  \
+        }                                                                          \
+      }                                                                            \
+    }                                                                              \
+  }
+
+static void test_memcpy1( void )
+{
+  FOR_ALL_ALIGNMENTS( memcpy( Ref + da, Src + sa, n ); memcpy1( Dst + da, Src + sa, n ) );
+}
+
+static void test_memcpyr( void )
+{
+  FOR_ALL_ALIGNMENTS( for( int i = 0; i < n; i++ ) { Ref[da + n - 1 - i] = Src[sa + i]; }
+                      memcpyr( Dst + da, Src + sa, n ) );
+}
+
+static void test_memset1( void )
+{
+  FOR_ALL_ALIGNMENTS( memset( Ref + da, 0x5A + n, n ); memset1( Dst + da, 0x5A + n, n ) );
+}
+
+static void test_memxor1( void )
+{
+  FOR_ALL_ALIGNMENTS( for( int i = 0; i < n; i++ ) { Ref[da + i] ^= Src[sa + i]; }
+                      memxor1( Dst + da, Src + sa, n ) );
+}
+
+static void test_memcpy16_memxor16( void )
+{
+  for( int da = 0; da < 4; da++ )
+  {
+    for( int sa = 0; sa < 4; sa++ )
+    {
+      Fill( );
+      memcpy( Ref + da, Src + sa, 16 );
+      memcpy16( Dst + da, Src + sa );
+      UT_ASSERT_MEM( Dst, Ref, BUFF_SIZE );
+
+      Fill( );
+      for( int i = 0; i < 16; i++ )
+      {
+        Ref[da + i] ^= Src[sa + i];
+      }
+      memxor16( Dst + da, Src + sa );
+      UT_ASSERT_MEM( Dst, Ref, BUFF_SIZE );
+    }
+  }
+}
+
+static void test_cmac_rfc4493( void )
+{
+  static const uint8_t key[16] =
+  {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+  };
+  static const uint8_t msg[64] =
+  {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+  };
+  static const uint8_t mac[4][16] =
+  {
+    { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 },
+    { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c },
+    { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 },
+    { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe },
+  };
+  static const uint32_t len[4] = { 0, 16, 40, 64 };
+
+  for( int i = 0; i < 4; i++ )
+  {
+    AES_CMAC_CTX ctx;
+    uint8_t digest[16];
+
+    AES_CMAC_Init( &ctx );
+    AES_CMAC_SetKey( &ctx, key );
+    /* fed in two parts, to go through the partial block path */
+    AES_CMAC_Update( &ctx, msg, len[i] / 3 );
+    AES_CMAC_Update( &ctx, msg + len[i] / 3, len[i] - len[i] / 3 );
+    AES_CMAC_Final( digest, &ctx );
+    UT_ASSERT_MEM( digest, mac[i], 16 );
+  }
+}
+
+int main( void )
+{
+  UT_RUN( test_memcpy1 );
+  UT_RUN( test_memcpyr );
+  UT_RUN( test_memset1 );
+  UT_RUN( test_memxor1 );
+  UT_RUN( test_memcpy16_memxor16 );
+  UT_RUN( test_cmac_rfc4493 );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
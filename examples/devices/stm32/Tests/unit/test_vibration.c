@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file    test_vibration.c
+  * @author  MCD Application Team
+  * @brief   Vibration features of vibration.c, computed with the CMSIS-DSP q15
+  *          kernels, against the double precision numpy reference of
+  *          data/vibration_ref.py
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2018 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <math.h>
+#include "vibration.h"
+#include "unit_test.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STR( x )              #x
+#define XSTR( x )             STR( x )
+#define VECTORS_FILE          "data/vibration_" XSTR( VIBRATION_FFT_SIZE ) ".txt"
+
+/* Largest errors, relative to the reference RMS for the peaks and bands */
+#define MAX_RMS_ERROR         0.01
+#define MAX_CREST_ERROR       0.03
+#define MAX_PEAK_ERROR        0.03
+#define MAX_BAND_ERROR        0.02
+
+/* Peaks below this fraction of the largest may swap with the noise */
+#define MIN_PEAK_RATIO        0.2
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  double Rms;
+  double Crest;
+  int Bins[VIBRATION_NB_PEAKS];
+  double Amplitudes[VIBRATION_NB_PEAKS];
+  double Bands[VIBRATION_NB_BANDS];
+} Reference_t;
+
+/* Private variables ---------------------------------------------------------*/
+UT_DEFINE( );
+
+static int16_t Samples[VIBRATION_FFT_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+static int ReadCase( FILE *f, Reference_t *ref )
+{
+  for( int i = 0; i < VIBRATION_FFT_SIZE; i++ )
+  {
+    int v;
+    if( fscanf( f, "%d", &v ) != 1 )
+    {
+      return 0;
+    }
+    Samples[i] = ( int16_t )v;
+  }
+  if( fscanf( f, "%lf %lf", &ref->Rms, &ref->Crest ) != 2 )
+  {
+    return 0;
+  }
+  for( int k = 0; k < VIBRATION_NB_PEAKS; k++ )
+  {
+    if( fscanf( f, "%d", &ref->Bins[k] ) != 1 )
+    {
+      return 0;
+    }
+  }
+  for( int k = 0; k < VIBRATION_NB_PEAKS; k++ )
+  {
+    if( fscanf( f, "%lf", &ref->Amplitudes[k] ) != 1 )
+    {
+      return 0;
+    }
+  }
+  for( int b = 0; b < VIBRATION_NB_BANDS; b++ )
+  {
+    if( fscanf( f, "%lf", &ref->Bands[b] ) != 1 )
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Errors of one unit are the rounding of the integer features */
+static double Error( double actual, double expected, double scale )
+{
+  return fmax( fabs( actual - expected ) - 1, 0 ) / scale;
+}
+
+static void test_reference_vectors( void )
+{
+  FILE *f = fopen( VECTORS_FILE, "r" );
+  Reference_t ref;
+  VibrationFeatures_t features;
+  double worstRms = 0;
+  double worstCrest = 0;
+  double worstPeak = 0;
+  double worstBand = 0;
+  int cases = 0;
+  int missing = 0;
+
+  UT_ASSERT( f != NULL );
+  if( f == NULL )
+  {
+    return;
+  }
+
+  while( ReadCase( f, &ref ) )
+  {
+    VibrationExtract( Samples, &features );
+
+    worstRms = fmax( worstRms, Error( features.Rms, ref.Rms, ref.Rms ) );
+    worstCrest = fmax( worstCrest, fabs( features.Crest / 256.0 - ref.Crest ) / ref.Crest );
+
+    for( int k = 0; k < VIBRATION_NB_PEAKS; k++ )
+    {
+      int found = 0;
+
+      if( ref.Amplitudes[k] < MIN_PEAK_RATIO * ref.Amplitudes[0] )
+      {
+        continue;
+      }
+      /* Within one line, the amplitude compared on the same line only */
+      for( int j = 0; j < VIBRATION_NB_PEAKS; j++ )
+      {
+        if( abs( features.Peaks[j].Bin - ref.Bins[k] ) <= 1 )
+        {
+          found = 1;
+          if( features.Peaks[j].Bin == ref.Bins[k] )
+          {
+            worstPeak = fmax( worstPeak, Error( features.Peaks[j].Amplitude, ref.Amplitudes[k], ref.Amplitudes[0] ) );
+          }
+          break;
+        }
+      }
+      if( !found )
+      {
+        printf( "  case %d: peak at line %d missing\n", cases, ref.Bins[k] );
+        missing++;
+      }
+    }
+
+    for( int b = 0; b < VIBRATION_NB_BANDS; b++ )
+    {
+      worstBand = fmax( worstBand, Error( features.Bands[b], ref.Bands[b], ref.Rms ) );
+    }
+    cases++;
+  }
+  fclose( f );
+
+  printf( "  %d cases, worst relative error: rms %.4f crest %.4f peak %.4f band %.4f\n",
+          cases, worstRms, worstCrest, worstPeak, worstBand );
+  UT_ASSERT( cases > 0 );
+  UT_ASSERT_EQ( missing, 0 );
+  UT_ASSERT( worstRms <= MAX_RMS_ERROR );
+  UT_ASSERT( worstCrest <= MAX_CREST_ERROR );
+  UT_ASSERT( worstPeak <= MAX_PEAK_ERROR );
+  UT_ASSERT( worstBand <= MAX_BAND_ERROR );
+}
+
+/* A window without vibration has no features, whatever its offset */
+static void test_constant_window( void )
+{
+  VibrationFeatures_t features;
+
+  for( int i = 0; i < VIBRATION_FFT_SIZE; i++ )
+  {
+    Samples[i] = -1234;
+  }
+  VibrationExtract( Samples, &features );
+
+  UT_ASSERT_EQ( features.Rms, 0 );
+  for( int k = 0; k < VIBRATION_NB_PEAKS; k++ )
+  {
+    UT_ASSERT_EQ( features.Peaks[k].Amplitude, 0 );
+  }
+  for( int b = 0; b < VIBRATION_NB_BANDS; b++ )
+  {
+    UT_ASSERT_EQ( features.Bands[b], 0 );
+  }
+}
+
+/* A sinusoid on a line: one peak, its amplitude, RMS and crest of a sine */
+static void test_single_tone( void )
+{
+  VibrationFeatures_t features;
+  const int line = VIBRATION_FFT_SIZE / 8 + 4;
+
+  for( int i = 0; i < VIBRATION_FFT_SIZE; i++ )
+  {
+    Samples[i] = ( int16_t )lround( 500 + 8000 * sin( 2 * M_PI * line * i / VIBRATION_FFT_SIZE ) );
+  }
+  VibrationExtract( Samples, &features );
+
+  UT_ASSERT_EQ( features.Peaks[0].Bin, line );
+  UT_ASSERT( abs( features.Peaks[0].Amplitude - 8000 ) <= 80 );
+  UT_ASSERT( abs( features.Rms - 5657 ) <= 57 );
+  UT_ASSERT( abs( features.Crest - 362 ) <= 4 );
+  /* The line and its Hann leakage all in the second band */
+  UT_ASSERT( abs( features.Bands[1] - 5657 ) <= 57 );
+}
+
+int main( void )
+{
+  UT_RUN( test_reference_vectors );
+  UT_RUN( test_constant_window );
+  UT_RUN( test_single_tone );
+
+  return UT_RESULT( );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,266 @@
+#!/usr/bin/env node
+
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Renders the trace output of the end node firmware built with TRACE_BINARY
+ * set in utilities_conf.h. The output mixes text traces with binary records
+ * (see TraceSendBin in Middlewares/Third_Party/LoRaWAN/Utilities/trace.h):
+ * header 0xA5 | nbArgs << 8 | sequence << 16, RTC timer value, address of the
+ * format string, then the raw arguments, all little endian 32-bit words. The
+ * format strings, and the strings of %s arguments, are read from the firmware
+ * ELF file.
+ *
+ * Usage: trace-decode.js [--tick-hz N] [--timestamps] firmware.elf [capture]
+ *
+ * The capture is read from stdin when not given, e.g. the raw output of the
+ * virtual com port saved by a terminal.
+ */
+
+const fs = require('fs');
+
+const SYNC = 0xa5;
+const MAX_ARGS = 8;
+const HEADER_BYTES = 12;
+
+const SHT_NOBITS = 8;
+const SHF_ALLOC = 2;
+
+/*
+ * Allocated sections of an ELF file, to read constant data by address.
+ */
+class Elf {
+	constructor(buffer) {
+		if (buffer.readUInt32BE(0) !== 0x7f454c46) {
+			throw new Error('not an ELF file');
+		}
+		const is64 = buffer[4] === 2;
+		if (buffer[5] !== 1) {
+			throw new Error('big endian ELF files are not supported');
+		}
+		const word = (offset) => (is64 ? Number(buffer.readBigUInt64LE(offset)) : buffer.readUInt32LE(offset));
+		const shoff = word(is64 ? 0x28 : 0x20);
+		const shentsize = buffer.readUInt16LE(is64 ? 0x3a : 0x2e);
+		const shnum = buffer.readUInt16LE(is64 ? 0x3c : 0x30);
+
+		this.buffer = buffer;
+		this.sections = [];
+		for (let i = 0; i < shnum; i++) {
+			const sh = shoff + i * shentsize;
+			const type = buffer.readUInt32LE(sh + 4);
+			const flags = word(sh + 8);
+			const addr = word(sh + (is64 ? 16 : 12));
+			const offset = word(sh + (is64 ? 24 : 16));
+			const size = word(sh + (is64 ? 32 : 20));
+			if (flags & SHF_ALLOC && type !== SHT_NOBITS && size > 0) {
+				this.sections.push({ addr, offset, size });
+			}
+		}
+	}
+
+	/*
+	 * NUL terminated string at a target address, undefined when the address is
+	 * not in a loaded section.
+	 */
+	string(address) {
+		const section = this.sections.find((s) => address >= s.addr && address < s.addr + s.size);
+		if (!section) {
+			return undefined;
+		}
+		const start = section.offset + address - section.addr;
+		const end = this.buffer.indexOf(0, start);
+		return this.buffer.toString('latin1', start, end < 0 ? section.offset + section.size : end);
+	}
+}
+
+function pad(text, width, left, fill) {
+	if (text.length >= width) {
+		return text;
+	}
+	if (left) {
+		return text + ' '.repeat(width - text.length);
+	}
+	if (fill === '0') {
+		const sign = /^[-+ ]|^0[xX]/.exec(text);
+		const prefix = sign ? sign[0] : '';
+		return prefix + '0'.repeat(width - text.length) + text.slice(prefix.length);
+	}
+	return ' '.repeat(width - text.length) + text;
+}
+
+/*
+ * printf of the newlib subset the firmware uses, arguments being the raw 32-bit
+ * words the target pushed (long is 32 bits on Cortex-M).
+ */
+function format(fmt, args, elf) {
+	let next = 0;
+	const arg = () => (next < args.length ? args[next++] : 0);
+
+	return fmt.replace(
+		/%([-+ 0#]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])/g,
+		(match, flags, width, precision, length, conv) => {
+			if (conv === '%') {
+				return '%';
+			}
+			width = width === '*' ? arg() | 0 : parseInt(width || '0', 10);
+			precision = precision === '*' ? arg() | 0 : precision === undefined ? undefined : parseInt(precision, 10);
+			const left = flags.includes('-') || width < 0;
+			width = Math.abs(width);
+			const fill = flags.includes('0') && precision === undefined ? '0' : ' ';
+			let value = arg();
+			let text;
+
+			switch (conv) {
+				case 'd':
+				case 'i':
+					value = length === 'hh' ? (value << 24) >> 24 : length === 'h' ? (value << 16) >> 16 : value | 0;
+					text = Math.abs(value).toString();
+					break;
+				case 'c':
+					return pad(String.fromCharCode(value & 0xff), width, left, ' ');
+				case 's': {
+					const str = elf.string(value);
+					text = str === undefined ? '<0x' + value.toString(16).padStart(8, '0') + '>' : str;
+					if (precision !== undefined) {
+						text = text.slice(0, precision);
+					}
+					return pad(text, width, left, ' ');
+				}
+				case 'p':
+					return pad('0x' + value.toString(16), width, left, ' ');
+				default:
+					value = length === 'hh' ? value & 0xff : length === 'h' ? value & 0xffff : value >>> 0;
+					text = value.toString(conv === 'o' ? 8 : conv === 'u' ? 10 : 16);
+					if (conv === 'X') {
+						text = text.toUpperCase();
+					}
+			}
+			if (precision !== undefined) {
+				text = precision === 0 && value === 0 ? '' : text.padStart(precision, '0');
+			}
+			if (conv === 'd' || conv === 'i') {
+				text = (value < 0 ? '-' : flags.includes('+') ? '+' : flags.includes(' ') ? ' ' : '') + text;
+			} else if (flags.includes('#') && value !== 0) {
+				text = (conv === 'o' ? '0' : conv === 'x' ? '0x' : conv === 'X' ? '0X' : '') + text;
+			}
+			return pad(text, width, left, fill);
+		}
+	);
+}
+
+/*
+ * Decodes a capture. Returns the text, and the number of bytes at the end
+ * holding an incomplete record.
+ */
+function decode(capture, elf, options) {
+	const tickHz = options.tickHz || 1024;
+	let out = '';
+	let seq;
+	let i = 0;
+
+	while (i < capture.length) {
+		if (capture[i] !== SYNC) {
+			let end = capture.indexOf(SYNC, i);
+			end = end < 0 ? capture.length : end;
+			out += capture.toString('latin1', i, end);
+			i = end;
+			continue;
+		}
+		if (i + HEADER_BYTES > capture.length) {
+			break;
+		}
+		const header = capture.readUInt32LE(i);
+		const nbArgs = (header >> 8) & 0xff;
+		if (nbArgs > MAX_ARGS) {
+			/* not a record header */
+			out += String.fromCharCode(SYNC);
+			i++;
+			continue;
+		}
+		if (i + HEADER_BYTES + 4 * nbArgs > capture.length) {
+			break;
+		}
+		const recordSeq = header >>> 16;
+		const ticks = capture.readUInt32LE(i + 4);
+		const fmtAddress = capture.readUInt32LE(i + 8);
+		const args = [];
+		for (let a = 0; a < nbArgs; a++) {
+			args.push(capture.readUInt32LE(i + HEADER_BYTES + 4 * a));
+		}
+		i += HEADER_BYTES + 4 * nbArgs;
+
+		if (seq !== undefined && recordSeq !== seq) {
+			out += '[' + ((recordSeq - seq) & 0xffff) + ' binary traces dropped]\r\n';
+		}
+		seq = (recordSeq + 1) & 0xffff;
+
+		const fmt = elf.string(fmtAddress);
+		let text =
+			fmt === undefined
+				? '<format 0x' + fmtAddress.toString(16).padStart(8, '0') + '> ' + args.join(' ') + '\r\n'
+				: format(fmt, args, elf);
+		if (options.timestamps && (out.length === 0 || out.endsWith('\n')) && !/^[\r\n]/.test(text)) {
+			/* as PRINTNOW does in text mode */
+			const ms = Math.floor((ticks * 1000) / tickHz);
+			text =
+				String(Math.floor(ms / 1000)).padStart(3, ' ') + 's' + String(ms % 1000).padStart(3, '0') + ': ' + text;
+		}
+		out += text;
+	}
+	return { text: out, remaining: capture.length - i };
+}
+
+function main(argv) {
+	const options = {};
+	const files = [];
+
+	for (let i = 0; i < argv.length; i++) {
+		if (argv[i] === '--tick-hz') {
+			options.tickHz = parseInt(argv[++i], 10);
+		} else if (argv[i] === '--timestamps') {
+			options.timestamps = true;
+		} else {
+			files.push(argv[i]);
+		}
+	}
+	if (files.length < 1 || files.length > 2) {
+		process.stderr.write('usage: trace-decode.js [--tick-hz N] [--timestamps] firmware.elf [capture]\n');
+		process.exit(2);
+	}
+
+	const elf = new Elf(fs.readFileSync(files[0]));
+	const capture = fs.readFileSync(files.length > 1 ? files[1] : 0);
+	const result = decode(capture, elf, options);
+
+	process.stdout.write(Buffer.from(result.text, 'latin1'));
+	if (result.remaining !== 0) {
+		process.stderr.write('trace-decode: ' + result.remaining + ' bytes of an incomplete record at the end\n');
+	}
+}
+
+if (require.main === module) {
+	main(process.argv.slice(2));
+}
+
+exports.Elf = Elf;
+exports.format = format;
+exports.decode = decode;
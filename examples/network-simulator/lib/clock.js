@@ -0,0 +1,201 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* Events handled in a row before yielding to the I/O of the event loop */
+const BATCH_SIZE = 256;
+
+/**
+ *Virtual clock: a queue of events ordered by their time in ms
+ */
+class VirtualClock {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Number}  speed   Virtual ms per wall ms, 0 to run as fast as possible
+	 */
+	constructor(speed) {
+		this.speed = speed || 0;
+		this.now = 0;
+		this.heap = [];
+		this.sequence = 0;
+		this.stopped = false;
+		this.gate = null;
+		this.holds = 0;
+		this.resume = null;
+	}
+
+	/**
+	 * It schedules an event
+	 *
+	 * @param      {Number}    time      The virtual time in ms, not before now
+	 * @param      {Function}  handler   The handler
+	 */
+	at(time, handler) {
+		const event = { time: Math.max(time, this.now), sequence: this.sequence++, handler };
+		const heap = this.heap;
+		let i = heap.length;
+
+		heap.push(event);
+		while (i > 0) {
+			const parent = (i - 1) >> 1;
+			if (!before(event, heap[parent])) {
+				break;
+			}
+			heap[i] = heap[parent];
+			i = parent;
+		}
+		heap[i] = event;
+	}
+
+	/**
+	 * It sets a condition to hold the clock, e.g. while the I/O is behind
+	 *
+	 * @param      {Function}  gate    Returns false to hold the clock, null to never hold
+	 */
+	setGate(gate) {
+		this.gate = gate;
+	}
+
+	/**
+	 * It holds the clock until release, e.g. while a device process computes
+	 * its answer to an event
+	 */
+	hold() {
+		this.holds++;
+	}
+
+	/**
+	 * It releases a hold, the run goes on once no hold is left
+	 */
+	release() {
+		this.holds--;
+		if (this.holds === 0 && this.resume) {
+			const resume = this.resume;
+			this.resume = null;
+			setImmediate(resume);
+		}
+	}
+
+	/**
+	 * It schedules an event after a delay
+	 *
+	 * @param      {Number}    delay     The delay in ms
+	 * @param      {Function}  handler   The handler
+	 */
+	after(delay, handler) {
+		this.at(this.now + delay, handler);
+	}
+
+	/**
+	 * It runs the events until a virtual time
+	 *
+	 * @param      {Number}    until     The virtual time in ms
+	 * @param      {Function}  callback  The callback, once until is reached or stop called
+	 */
+	run(until, callback) {
+		const wallStart = Date.now();
+		const virtualStart = this.now;
+
+		const step = () => {
+			let handled = 0;
+
+			while (!this.stopped && (this.holds !== 0 || (this.heap.length !== 0 && this.heap[0].time <= until))) {
+				if (this.holds !== 0) {
+					this.resume = step;
+					return;
+				}
+				if (this.gate && !this.gate()) {
+					return setTimeout(step, 1);
+				}
+				if (this.speed > 0) {
+					const wait = virtualStart + (Date.now() - wallStart) * this.speed;
+					if (this.heap[0].time > wait) {
+						return setTimeout(step, Math.max(1, (this.heap[0].time - wait) / this.speed));
+					}
+				} else if (handled === BATCH_SIZE) {
+					return setImmediate(step);
+				}
+
+				const event = this.pop();
+				this.now = event.time;
+				event.handler();
+				handled++;
+			}
+
+			this.now = this.stopped ? this.now : until;
+			callback();
+		};
+
+		step();
+	}
+
+	/**
+	 * It stops a run after the current event
+	 */
+	stop() {
+		this.stopped = true;
+	}
+
+	/**
+	 * It removes the earliest event
+	 *
+	 * @return     {Object}  The event
+	 */
+	pop() {
+		const heap = this.heap;
+		const top = heap[0];
+		const last = heap.pop();
+
+		if (heap.length !== 0) {
+			let i = 0;
+			for (;;) {
+				const left = 2 * i + 1;
+				let child = left;
+				if (left >= heap.length) {
+					break;
+				}
+				if (left + 1 < heap.length && before(heap[left + 1], heap[left])) {
+					child = left + 1;
+				}
+				if (!before(heap[child], last)) {
+					break;
+				}
+				heap[i] = heap[child];
+				i = child;
+			}
+			heap[i] = last;
+		}
+		return top;
+	}
+}
+
+/**
+ * Order of the events, by time then by scheduling order
+ *
+ * @param      {Object}   a       The event
+ * @param      {Object}   b       The event
+ * @return     {Boolean}  True if a runs before b
+ */
+function before(a, b) {
+	return a.time < b.time || (a.time === b.time && a.sequence < b.sequence);
+}
+
+exports.VirtualClock = VirtualClock;
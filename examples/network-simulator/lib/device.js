@@ -0,0 +1,350 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+const lorawan = require('./lorawan');
+const radio = require('./radio');
+const retransPolicy = require('./retransPolicy');
+
+/* LoRaWAN 1.0 EU868 timings, in ms */
+const JOIN_ACCEPT_DELAY1 = 5000;
+const RECEIVE_DELAY1 = 1000;
+const RECEIVE_DELAY2 = 2000;
+const RX_WINDOW = 1000;
+
+/* ACK_TIMEOUT: the MAC waits 2 +/- 1 s after RX2 before a retransmission */
+const ACK_TIMEOUT = 2000;
+const ACK_TIMEOUT_RND = 1000;
+
+/* Trials requested by LORA_send for the confirmed uplinks */
+const CONFIRMED_NB_TRIALS = 8;
+
+/* Duty cycle of the EU868 sub-bands: 1 % */
+const DUTY_CYCLE = 100;
+
+/* Join-requests are retried after a random time, doubled at each attempt up to
+ * the maximum, in ms */
+const JOIN_RETRY_MIN = 10000;
+const JOIN_RETRY_MAX = 3600000;
+
+/* Cayenne LPP types of the generated payload */
+const LPP_LUMINOSITY = 101;
+const LPP_TEMPERATURE = 103;
+const LPP_RELATIVE_HUMIDITY = 104;
+
+/* Application port of the uplinks */
+const APP_PORT = 2;
+
+/**
+ *End device: OTAA join, then periodic Cayenne LPP uplinks. Channel 0 carries
+ *the low 16 bits of the frame counter as a luminosity, to match the uplinks
+ *with the entity updates downstream. The confirmed uplinks are retransmitted
+ *until acknowledged, as the retransmission policy decides
+ */
+class Device {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Object}    params  devEui, appEui, appKey (hex strings), sf, period (ms),
+	 *                                 confirmed (Boolean), retrans (stock or adaptive),
+	 *                                 random (Function returning [0, 1[)
+	 * @param      {Object}    clock   The virtual clock
+	 * @param      {Object}    medium  The radio
+	 */
+	constructor(params, clock, medium) {
+		this.devEui = params.devEui;
+		this.appEui = params.appEui;
+		this.appKey = Buffer.from(params.appKey, 'hex');
+		this.sf = params.sf;
+		this.period = params.period;
+		this.confirmed = !!params.confirmed;
+		this.random = params.random || Math.random;
+		this.policy = retransPolicy.create(params.retrans || 'stock', this.random);
+		this.clock = clock;
+		this.medium = medium;
+
+		this.devNonce = Math.floor(this.random() * 0x10000);
+		this.session = null;
+		this.fCntUp = 0;
+		this.fCntDown = -1;
+		this.ackPending = false;
+		this.pending = null;
+		this.deferred = false;
+		this.waiting = null;
+		this.joinAttempts = 0;
+		this.txAllowed = 0;
+		this.temperature = 200 + Math.floor(this.random() * 50);
+		this.stats = {
+			joinRequests: 0,
+			uplinks: 0,
+			downlinks: 0,
+			rejected: 0,
+			confirmed: 0,
+			acked: 0,
+			unacked: 0,
+			abandoned: 0,
+			deferred: 0,
+			confirmedTransmissions: 0,
+			confirmedAirtime: 0,
+			ackDelay: 0
+		};
+	}
+
+	/**
+	 * It starts the device: join then uplinks
+	 *
+	 * @param      {Number}  delay   The delay before the join-request in ms
+	 */
+	start(delay) {
+		this.clock.after(delay, () => this.join());
+	}
+
+	/**
+	 * It sends a join-request, retried until a join-accept is received
+	 */
+	join() {
+		this.devNonce = (this.devNonce + 1) & 0xffff;
+		const frame = lorawan.buildJoinRequest({
+			appEui: this.appEui,
+			devEui: this.devEui,
+			devNonce: this.devNonce,
+			appKey: this.appKey
+		});
+
+		this.stats.joinRequests++;
+		const end = this.transmit(frame, this.sf);
+		this.waiting = { type: 'join', until: end + JOIN_ACCEPT_DELAY1 + RX_WINDOW };
+		this.clock.at(this.waiting.until, () => {
+			if (!this.session) {
+				const backoff = Math.min(JOIN_RETRY_MIN * Math.pow(2, this.joinAttempts++), JOIN_RETRY_MAX);
+				const retry = backoff * (0.5 + this.random());
+				this.clock.at(Math.max(this.clock.now + retry, this.txAllowed), () => this.join());
+			}
+		});
+	}
+
+	/**
+	 * It sends an uplink, then schedules the next one
+	 */
+	tick() {
+		const jitter = (this.random() - 0.5) * 0.2 * this.period;
+
+		this.clock.at(Math.max(this.clock.now + this.period + jitter, this.txAllowed), () => this.tick());
+		if (this.pending) {
+			// The MAC is busy with the retransmissions of the previous sample
+			this.stats.deferred++;
+			this.deferred = true;
+			this.policy.fresherData();
+			return;
+		}
+		this.uplink();
+	}
+
+	/**
+	 * It sends an uplink of a new sample
+	 */
+	uplink() {
+		const seq = this.fCntUp & 0xffff;
+		const payload = Buffer.alloc(11);
+
+		this.temperature += Math.round((this.random() - 0.5) * 4);
+		payload.writeUInt8(0, 0);
+		payload.writeUInt8(LPP_LUMINOSITY, 1);
+		payload.writeUInt16BE(seq, 2);
+		payload.writeUInt8(1, 4);
+		payload.writeUInt8(LPP_TEMPERATURE, 5);
+		payload.writeInt16BE(this.temperature, 6);
+		payload.writeUInt8(2, 8);
+		payload.writeUInt8(LPP_RELATIVE_HUMIDITY, 9);
+		payload.writeUInt8(80 + Math.floor(this.random() * 40), 10);
+
+		const frame = lorawan.buildDataFrame({
+			mhdr: this.confirmed ? lorawan.MHDR_CONFIRMED_UP : lorawan.MHDR_UNCONFIRMED_UP,
+			devAddr: this.session.devAddr,
+			fCtrl: this.ackPending ? lorawan.FCTRL_ACK : 0,
+			fCnt: this.fCntUp,
+			fPort: APP_PORT,
+			payload,
+			nwkSKey: this.session.nwkSKey,
+			appSKey: this.session.appSKey
+		});
+
+		this.ackPending = false;
+		this.stats.uplinks++;
+
+		if (!this.confirmed) {
+			this.fCntUp++;
+			const end = this.transmit(frame, this.sf);
+			this.waiting = { type: 'data', until: end + RECEIVE_DELAY1 + RX_WINDOW };
+			return;
+		}
+
+		this.stats.confirmed++;
+		this.pending = {
+			frame,
+			sf: this.sf,
+			start: this.clock.now,
+			trials: this.policy.nbTrials(CONFIRMED_NB_TRIALS),
+			trans: 0
+		};
+		this.retransmit();
+	}
+
+	/**
+	 * It sends the confirmed uplink in progress, then waits for its ACK
+	 */
+	retransmit() {
+		const pending = this.pending;
+		const start = this.clock.now;
+		const end = this.transmit(pending.frame, pending.sf);
+		const trans = ++pending.trans;
+
+		this.stats.confirmedTransmissions++;
+		this.stats.confirmedAirtime += end - start;
+		this.waiting = { type: 'data', until: end + RECEIVE_DELAY1 + RX_WINDOW };
+
+		const timeout = RECEIVE_DELAY2 + ACK_TIMEOUT + (2 * this.random() - 1) * ACK_TIMEOUT_RND;
+		this.clock.at(end + timeout, () => {
+			if (this.pending === pending && pending.trans === trans) {
+				this.ackTimeout();
+			}
+		});
+	}
+
+	/**
+	 * No ACK came: the confirmed uplink is retransmitted, as LoRaMacHandleMcpsRequest
+	 * does, unless the trials are over or the policy abandons it
+	 */
+	ackTimeout() {
+		const pending = this.pending;
+		const retry = pending.trans;
+
+		if (pending.trans >= pending.trials) {
+			return this.confirm(false);
+		}
+		if (this.policy.isStale(this.clock.now - pending.start)) {
+			this.stats.abandoned++;
+			return this.confirm(false);
+		}
+		if (this.policy.stepDownDatarate(retry)) {
+			pending.sf = Math.min(pending.sf + 1, 12);
+		}
+		const backoff = this.policy.backoff(retry);
+		this.clock.at(Math.max(this.clock.now + backoff, this.txAllowed), () => this.retransmit());
+	}
+
+	/**
+	 * End of the confirmed uplink in progress, a deferred sample is sent
+	 * right away
+	 *
+	 * @param      {Boolean}  ackReceived  The frame was acknowledged
+	 */
+	confirm(ackReceived) {
+		const pending = this.pending;
+
+		this.policy.onResult(ackReceived, pending.trans);
+		if (ackReceived) {
+			this.stats.acked++;
+			this.stats.ackDelay += this.clock.now - pending.start;
+		} else {
+			this.stats.unacked++;
+		}
+		this.pending = null;
+		this.fCntUp++;
+
+		if (this.deferred) {
+			this.deferred = false;
+			this.clock.at(Math.max(this.clock.now, this.txAllowed), () => {
+				if (!this.pending) {
+					this.uplink();
+				}
+			});
+		}
+	}
+
+	/**
+	 * It transmits a frame on a random channel, within the duty cycle
+	 *
+	 * @param      {Buffer}  frame   The frame
+	 * @param      {Number}  sf      The spreading factor
+	 * @return     {Number}  The end of the transmission
+	 */
+	transmit(frame, sf) {
+		const channel = Math.floor(this.random() * radio.CHANNELS.length);
+		const toa = this.medium.transmit(frame, sf, channel, this);
+
+		this.txAllowed = this.clock.now + toa * DUTY_CYCLE;
+		return this.clock.now + toa;
+	}
+
+	/**
+	 * It handles a frame sent to the device in its receive window
+	 *
+	 * @param      {Buffer}  frame   The frame
+	 */
+	receive(frame) {
+		if (!this.waiting || this.clock.now > this.waiting.until) {
+			this.stats.rejected++;
+			return;
+		}
+
+		if (this.waiting.type === 'join') {
+			const accept = lorawan.parseJoinAccept(frame, this.appKey);
+			if (!accept) {
+				this.stats.rejected++;
+				return;
+			}
+			const keys = lorawan.deriveSessionKeys(this.appKey, accept.joinNonce, accept.netId, this.devNonce);
+			this.session = { devAddr: accept.devAddr, nwkSKey: keys.nwkSKey, appSKey: keys.appSKey };
+			this.fCntUp = 0;
+			this.fCntDown = -1;
+			this.waiting = null;
+			this.joinAttempts = 0;
+			this.clock.at(Math.max(this.clock.now + this.random() * this.period, this.txAllowed), () =>
+				this.tick()
+			);
+			return;
+		}
+
+		const msg = lorawan.parseDataFrame(frame);
+		if (!msg || msg.devAddr !== this.session.devAddr) {
+			this.stats.rejected++;
+			return;
+		}
+		const fCnt = lorawan.expandFCnt(this.fCntDown, msg.fCnt);
+		const payload = lorawan.unsecureDataFrame(msg, fCnt, this.session.nwkSKey, this.session.appSKey);
+		if (!payload || fCnt <= this.fCntDown) {
+			this.stats.rejected++;
+			return;
+		}
+
+		this.fCntDown = fCnt;
+		this.waiting = null;
+		this.ackPending = msg.mhdr === lorawan.MHDR_CONFIRMED_DOWN;
+		this.stats.downlinks++;
+		if (this.pending && msg.fCtrl & lorawan.FCTRL_ACK) {
+			this.confirm(true);
+		}
+	}
+}
+
+exports.JOIN_ACCEPT_DELAY1 = JOIN_ACCEPT_DELAY1;
+exports.RECEIVE_DELAY1 = RECEIVE_DELAY1;
+exports.Device = Device;
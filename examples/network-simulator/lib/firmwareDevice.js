@@ -0,0 +1,248 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+const childProcess = require('child_process');
+const path = require('path');
+const readline = require('readline');
+const radio = require('./radio');
+
+/* Host build of the firmware device, make -C examples/devices/stm32/Tests sim */
+const BINARY = path.join(__dirname, '../../devices/stm32/Tests/build/sim_node');
+
+/* Radio metadata of the downlinks, as the device measures them */
+const RX_RSSI = -60;
+const RX_SNR = 8;
+
+/**
+ *End device running the LoRaMac stack of the STM32 firmware, in its own
+ *process over the virtual radio and RTC of the host tests (sim_node). The
+ *process answers each command with the frames it sent and the time of its
+ *next alarm. The clock is held meanwhile, so the device runs in lockstep
+ *with the others.
+ */
+class FirmwareDevice {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Object}  params  devEui, appEui, appKey (hex strings), sf, period (ms),
+	 *                               confirmed (Boolean), retrans (stock or adaptive),
+	 *                               seed (Number), binary (path of sim_node)
+	 * @param      {Object}  clock   The virtual clock
+	 * @param      {Object}  medium  The radio
+	 */
+	constructor(params, clock, medium) {
+		this.args = [
+			'-e',
+			params.devEui,
+			'-j',
+			params.appEui,
+			'-k',
+			params.appKey,
+			'-d',
+			String(radio.dataRate(params.sf)),
+			'-p',
+			String(Math.round(params.period)),
+			'-r',
+			String(params.seed)
+		];
+		if (params.confirmed) {
+			this.args.push('-c');
+		}
+		if (params.retrans === 'adaptive') {
+			this.args.push('-a');
+		}
+		this.binary = params.binary || BINARY;
+		this.clock = clock;
+		this.medium = medium;
+		this.child = null;
+		this.alarm = 0;
+		this.uplinkStart = null;
+		this.stats = {
+			joinRequests: 0,
+			uplinks: 0,
+			downlinks: 0,
+			confirmed: 0,
+			acked: 0,
+			unacked: 0,
+			deferred: 0,
+			confirmedTransmissions: 0,
+			confirmedAirtime: 0,
+			ackDelay: 0
+		};
+	}
+
+	/**
+	 * It starts the device process, the device joins after the delay
+	 *
+	 * @param      {Number}  delay   The delay before the join-request in ms
+	 */
+	start(delay) {
+		const start = Math.round(this.clock.now + delay);
+
+		this.child = childProcess.spawn(this.binary, this.args.concat(['-s', String(start)]), {
+			stdio: ['pipe', 'pipe', 'inherit']
+		});
+		this.child.on('error', (error) => {
+			console.error('Error running ' + this.binary + ': ' + error.message);
+			process.exit(1);
+		});
+		this.child.on('exit', (code) => {
+			if (this.child) {
+				console.error(this.binary + ' exited with ' + code);
+				process.exit(1);
+			}
+		});
+		readline.createInterface({ input: this.child.stdout }).on('line', (line) => this.answer(line));
+
+		// Held until the process reports its first alarm
+		this.clock.hold();
+	}
+
+	/**
+	 * It stops the device process
+	 */
+	stop() {
+		const child = this.child;
+
+		if (child) {
+			this.child = null;
+			child.stdin.end();
+		}
+	}
+
+	/**
+	 * It sends a command to the process and holds the clock until the answer
+	 *
+	 * @param      {String}  command  The command line
+	 */
+	command(command) {
+		this.clock.hold();
+		this.child.stdin.write(command + '\n');
+	}
+
+	/**
+	 * It handles a line of the answer of the process
+	 *
+	 * @param      {String}  line    The line
+	 */
+	answer(line) {
+		const fields = line.split(' ');
+
+		switch (fields[0]) {
+			case 'tx':
+				this.transmit(Number(fields[2]), Number(fields[3]), Buffer.from(fields[5], 'hex'));
+				break;
+			case 'confirm':
+				this.confirm(fields[1] === '1', fields[2] === '1', Number(fields[3]), Number(fields[4]));
+				break;
+			case 'downlink':
+				this.stats.downlinks++;
+				break;
+			case 'deferred':
+				this.stats.deferred++;
+				break;
+			case 'next':
+				this.schedule(Number(fields[1]));
+				this.clock.release();
+				break;
+			default:
+				break;
+		}
+	}
+
+	/**
+	 * It runs the process at its next alarm. An alarm that a later answer
+	 * replaced is ignored.
+	 *
+	 * @param      {Number}  time    The time of the alarm in ms, -1 for none
+	 */
+	schedule(time) {
+		const alarm = ++this.alarm;
+
+		if (time >= 0) {
+			this.clock.at(time, () => {
+				if (this.alarm === alarm && this.child) {
+					this.command('run ' + time);
+				}
+			});
+		}
+	}
+
+	/**
+	 * It puts a frame the process sent on the air
+	 *
+	 * @param      {Number}  frequency  The frequency in Hz
+	 * @param      {Number}  sf         The spreading factor
+	 * @param      {Buffer}  frame      The frame
+	 */
+	transmit(frequency, sf, frame) {
+		const channel = radio.CHANNELS.indexOf(frequency);
+
+		if (channel < 0) {
+			console.error('Frame of ' + this.args[1] + ' on ' + frequency + ' Hz, out of the simulated channels');
+			return;
+		}
+		if ((frame[0] & 0xe0) === 0) {
+			this.stats.joinRequests++;
+		} else if (this.uplinkStart === null) {
+			this.uplinkStart = this.clock.now;
+		}
+		this.medium.transmit(frame, sf, channel, this);
+	}
+
+	/**
+	 * End of an uplink, acknowledged or not if confirmed
+	 *
+	 * @param      {Boolean}  confirmed    The uplink was confirmed
+	 * @param      {Boolean}  ackReceived  The uplink was acknowledged
+	 * @param      {Number}   nbTrans      The transmissions of the uplink
+	 * @param      {Number}   airtime      The time on air of the transmissions in ms
+	 */
+	confirm(confirmed, ackReceived, nbTrans, airtime) {
+		this.stats.uplinks++;
+		if (confirmed) {
+			this.stats.confirmed++;
+			this.stats.confirmedTransmissions += nbTrans;
+			this.stats.confirmedAirtime += airtime;
+			if (ackReceived) {
+				this.stats.acked++;
+				this.stats.ackDelay += this.clock.now - this.uplinkStart;
+			} else {
+				this.stats.unacked++;
+			}
+		}
+		this.uplinkStart = null;
+	}
+
+	/**
+	 * It hands a frame the gateway sent to the radio of the process, which
+	 * receives it if a window is open
+	 *
+	 * @param      {Buffer}  frame   The frame
+	 */
+	receive(frame) {
+		if (this.child) {
+			this.command(['rx', Math.ceil(this.clock.now), 0, RX_RSSI, RX_SNR, frame.toString('hex')].join(' '));
+		}
+	}
+}
+
+exports.FirmwareDevice = FirmwareDevice;
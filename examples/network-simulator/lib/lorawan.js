@@ -0,0 +1,435 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * LoRaWAN 1.0.x frames, as built and checked by the LoRaMac stack of the
+ * STM32 end node (Mac/LoRaMacSerializer.c, LoRaMacParser.c, LoRaMacCrypto.c).
+ * Multi-byte fields are little endian, EUIs are reversed on air.
+ */
+
+const crypto = require('crypto');
+
+const MHDR_JOIN_REQUEST = 0x00;
+const MHDR_JOIN_ACCEPT = 0x20;
+const MHDR_UNCONFIRMED_UP = 0x40;
+const MHDR_UNCONFIRMED_DOWN = 0x60;
+const MHDR_CONFIRMED_UP = 0x80;
+const MHDR_CONFIRMED_DOWN = 0xa0;
+
+const UPLINK = 0;
+const DOWNLINK = 1;
+
+const MIC_SIZE = 4;
+const FHDR_MIN_SIZE = 7;
+const JOIN_REQUEST_SIZE = 23;
+const JOIN_ACCEPT_SIZE = 17;
+const CFLIST_SIZE = 16;
+const DATA_MIN_SIZE = 1 + FHDR_MIN_SIZE + MIC_SIZE;
+
+const ZERO_BLOCK = Buffer.alloc(16);
+
+/**
+ * AES-128 of a single block
+ *
+ * @param      {Buffer}  key     The key
+ * @param      {Buffer}  block   The 16 bytes block
+ * @return     {Buffer}  The encrypted block
+ */
+function aesEncrypt(key, block) {
+	const cipher = crypto.createCipheriv('aes-128-ecb', key, null);
+	cipher.setAutoPadding(false);
+	return cipher.update(block);
+}
+
+/**
+ * AES-128 ECB decryption, used by the network server to "encrypt" a
+ * join-accept that the device decrypts with an AES encryption
+ *
+ * @param      {Buffer}  key     The key
+ * @param      {Buffer}  data    Multiple of 16 bytes
+ * @return     {Buffer}  The decrypted data
+ */
+function aesDecrypt(key, data) {
+	const decipher = crypto.createDecipheriv('aes-128-ecb', key, null);
+	decipher.setAutoPadding(false);
+	return decipher.update(data);
+}
+
+/**
+ * Doubles a block in GF(2^128), RFC 4493 subkey generation
+ *
+ * @param      {Buffer}  block   The block
+ * @return     {Buffer}  The doubled block
+ */
+function double(block) {
+	const out = Buffer.alloc(16);
+	for (let i = 0; i < 15; i++) {
+		out[i] = ((block[i] << 1) | (block[i + 1] >> 7)) & 0xff;
+	}
+	out[15] = (block[15] << 1) & 0xff;
+	if (block[0] & 0x80) {
+		out[15] ^= 0x87;
+	}
+	return out;
+}
+
+/**
+ * AES-CMAC (RFC 4493)
+ *
+ * @param      {Buffer}  key     The key
+ * @param      {Buffer}  data    The message
+ * @return     {Buffer}  The 16 bytes CMAC
+ */
+function cmac(key, data) {
+	const k1 = double(aesEncrypt(key, ZERO_BLOCK));
+	const blocks = Math.max(1, Math.ceil(data.length / 16));
+	const last = Buffer.alloc(16);
+	const complete = data.length !== 0 && data.length % 16 === 0;
+
+	data.copy(last, 0, (blocks - 1) * 16);
+	if (complete) {
+		for (let i = 0; i < 16; i++) {
+			last[i] ^= k1[i];
+		}
+	} else {
+		const k2 = double(k1);
+		last[data.length - (blocks - 1) * 16] = 0x80;
+		for (let i = 0; i < 16; i++) {
+			last[i] ^= k2[i];
+		}
+	}
+
+	const cipher = crypto.createCipheriv('aes-128-cbc', key, ZERO_BLOCK);
+	cipher.setAutoPadding(false);
+	if (blocks > 1) {
+		cipher.update(data.subarray(0, (blocks - 1) * 16));
+	}
+	return cipher.update(last);
+}
+
+/**
+ * Builds the B0 block of the MIC of a data frame
+ *
+ * @param      {Number}  dir      UPLINK or DOWNLINK
+ * @param      {Number}  devAddr  The device address
+ * @param      {Number}  fCnt     The 32 bits frame counter
+ * @param      {Number}  length   The size of the frame without MIC
+ * @return     {Buffer}  The block
+ */
+function b0(dir, devAddr, fCnt, length) {
+	const block = Buffer.alloc(16);
+	block[0] = 0x49;
+	block[5] = dir;
+	block.writeUInt32LE(devAddr >>> 0, 6);
+	block.writeUInt32LE(fCnt >>> 0, 10);
+	block[15] = length;
+	return block;
+}
+
+/**
+ * Encrypts or decrypts a FRMPayload (AES-CTR with the A_i blocks)
+ *
+ * @param      {Buffer}  key      AppSKey, or NwkSKey on port 0
+ * @param      {Number}  dir      UPLINK or DOWNLINK
+ * @param      {Number}  devAddr  The device address
+ * @param      {Number}  fCnt     The 32 bits frame counter
+ * @param      {Buffer}  payload  The payload
+ * @return     {Buffer}  The payload, encrypted or decrypted
+ */
+function cryptPayload(key, dir, devAddr, fCnt, payload) {
+	const blocks = Math.ceil(payload.length / 16);
+	const a = Buffer.alloc(blocks * 16);
+
+	for (let i = 0; i < blocks; i++) {
+		const ai = a.subarray(i * 16, i * 16 + 16);
+		ai[0] = 0x01;
+		ai[5] = dir;
+		ai.writeUInt32LE(devAddr >>> 0, 6);
+		ai.writeUInt32LE(fCnt >>> 0, 10);
+		ai[15] = i + 1;
+	}
+
+	const s = aesEncrypt(key, a);
+	const out = Buffer.alloc(payload.length);
+	for (let i = 0; i < payload.length; i++) {
+		out[i] = payload[i] ^ s[i];
+	}
+	return out;
+}
+
+/**
+ * Builds a join-request
+ *
+ * @param      {Object}  params  appEui, devEui (hex strings), devNonce, appKey (Buffer)
+ * @return     {Buffer}  The frame
+ */
+function buildJoinRequest(params) {
+	const frame = Buffer.alloc(JOIN_REQUEST_SIZE);
+	frame[0] = MHDR_JOIN_REQUEST;
+	Buffer.from(params.appEui, 'hex').reverse().copy(frame, 1);
+	Buffer.from(params.devEui, 'hex').reverse().copy(frame, 9);
+	frame.writeUInt16LE(params.devNonce, 17);
+	cmac(params.appKey, frame.subarray(0, 19)).copy(frame, 19, 0, MIC_SIZE);
+	return frame;
+}
+
+/**
+ * Parses a join-request
+ *
+ * @param      {Buffer}  frame   The frame
+ * @return     {Object}  appEui, devEui, devNonce and the frame, null if malformed
+ */
+function parseJoinRequest(frame) {
+	if (frame.length !== JOIN_REQUEST_SIZE || frame[0] !== MHDR_JOIN_REQUEST) {
+		return null;
+	}
+	return {
+		appEui: Buffer.from(frame.subarray(1, 9)).reverse().toString('hex'),
+		devEui: Buffer.from(frame.subarray(9, 17)).reverse().toString('hex'),
+		devNonce: frame.readUInt16LE(17),
+		frame
+	};
+}
+
+/**
+ * Checks the MIC of a join-request
+ *
+ * @param      {Buffer}  frame   The frame
+ * @param      {Buffer}  appKey  The application key
+ * @return     {Boolean}  True if valid
+ */
+function verifyJoinRequest(frame, appKey) {
+	return cmac(appKey, frame.subarray(0, 19)).compare(frame, 19, 23, 0, MIC_SIZE) === 0;
+}
+
+/**
+ * Builds an encrypted join-accept, LoRaWAN 1.0 (OptNeg cleared)
+ *
+ * @param      {Object}  params  joinNonce, netId, devAddr, dlSettings, rxDelay,
+ *                               cfList (optional Buffer), appKey
+ * @return     {Buffer}  The frame
+ */
+function buildJoinAccept(params) {
+	const size = JOIN_ACCEPT_SIZE + (params.cfList ? CFLIST_SIZE : 0);
+	const frame = Buffer.alloc(size);
+	frame[0] = MHDR_JOIN_ACCEPT;
+	frame.writeUIntLE(params.joinNonce, 1, 3);
+	frame.writeUIntLE(params.netId, 4, 3);
+	frame.writeUInt32LE(params.devAddr >>> 0, 7);
+	frame[11] = params.dlSettings & 0x7f;
+	frame[12] = params.rxDelay;
+	if (params.cfList) {
+		params.cfList.copy(frame, 13);
+	}
+	cmac(params.appKey, frame.subarray(0, size - MIC_SIZE)).copy(frame, size - MIC_SIZE, 0, MIC_SIZE);
+	aesDecrypt(params.appKey, frame.subarray(1)).copy(frame, 1);
+	return frame;
+}
+
+/**
+ * Decrypts and checks a join-accept, as LoRaMacCryptoHandleJoinAccept does
+ *
+ * @param      {Buffer}  frame   The frame
+ * @param      {Buffer}  appKey  The application key
+ * @return     {Object}  joinNonce, netId, devAddr, dlSettings, rxDelay, null if
+ *                       malformed or the MIC is wrong
+ */
+function parseJoinAccept(frame, appKey) {
+	if (
+		(frame.length !== JOIN_ACCEPT_SIZE && frame.length !== JOIN_ACCEPT_SIZE + CFLIST_SIZE) ||
+		frame[0] !== MHDR_JOIN_ACCEPT
+	) {
+		return null;
+	}
+
+	const plain = Buffer.concat([frame.subarray(0, 1), aesEncrypt(appKey, frame.subarray(1))]);
+	const micOffset = plain.length - MIC_SIZE;
+	if (cmac(appKey, plain.subarray(0, micOffset)).compare(plain, micOffset, plain.length, 0, MIC_SIZE) !== 0) {
+		return null;
+	}
+
+	return {
+		joinNonce: plain.readUIntLE(1, 3),
+		netId: plain.readUIntLE(4, 3),
+		devAddr: plain.readUInt32LE(7),
+		dlSettings: plain[11],
+		rxDelay: plain[12],
+		cfList: plain.length > JOIN_ACCEPT_SIZE ? plain.subarray(13, 29) : null
+	};
+}
+
+/**
+ * Derives the LoRaWAN 1.0 session keys
+ *
+ * @param      {Buffer}  appKey     The application key
+ * @param      {Number}  joinNonce  The join nonce
+ * @param      {Number}  netId      The network identifier
+ * @param      {Number}  devNonce   The device nonce
+ * @return     {Object}  nwkSKey and appSKey
+ */
+function deriveSessionKeys(appKey, joinNonce, netId, devNonce) {
+	const block = Buffer.alloc(16);
+	block.writeUIntLE(joinNonce, 1, 3);
+	block.writeUIntLE(netId, 4, 3);
+	block.writeUInt16LE(devNonce, 7);
+
+	block[0] = 0x01;
+	const nwkSKey = aesEncrypt(appKey, block);
+	block[0] = 0x02;
+	const appSKey = aesEncrypt(appKey, block);
+	return { nwkSKey, appSKey };
+}
+
+/**
+ * Builds a data frame, payload encrypted and MIC computed
+ *
+ * @param      {Object}  params  mhdr, devAddr, fCtrl, fCnt (32 bits), fOpts
+ *                               (optional Buffer), fPort, payload (optional
+ *                               Buffer), nwkSKey, appSKey
+ * @return     {Buffer}  The frame
+ */
+function buildDataFrame(params) {
+	const fOpts = params.fOpts || Buffer.alloc(0);
+	const payload = params.payload || Buffer.alloc(0);
+	const dir = params.mhdr === MHDR_UNCONFIRMED_DOWN || params.mhdr === MHDR_CONFIRMED_DOWN ? DOWNLINK : UPLINK;
+	const portSize = payload.length > 0 ? 1 : 0;
+	const size = 1 + FHDR_MIN_SIZE + fOpts.length + portSize + payload.length + MIC_SIZE;
+
+	if (fOpts.length > 15 || size > 255) {
+		throw new Error('Frame too large');
+	}
+
+	const frame = Buffer.alloc(size);
+	let cursor = 0;
+	frame[cursor++] = params.mhdr;
+	frame.writeUInt32LE(params.devAddr >>> 0, cursor);
+	cursor += 4;
+	frame[cursor++] = (params.fCtrl & 0xf0) | fOpts.length;
+	frame.writeUInt16LE(params.fCnt & 0xffff, cursor);
+	cursor += 2;
+	cursor += fOpts.copy(frame, cursor);
+	if (portSize) {
+		frame[cursor++] = params.fPort;
+		const key = params.fPort === 0 ? params.nwkSKey : params.appSKey;
+		cursor += cryptPayload(key, dir, params.devAddr, params.fCnt, payload).copy(frame, cursor);
+	}
+	cmac(params.nwkSKey, Buffer.concat([b0(dir, params.devAddr, params.fCnt, cursor), frame.subarray(0, cursor)])).copy(
+		frame,
+		cursor,
+		0,
+		MIC_SIZE
+	);
+	return frame;
+}
+
+/**
+ * Parses the clear fields of a data frame, with the bounds checks of
+ * LoRaMacParserData
+ *
+ * @param      {Buffer}  frame   The frame
+ * @return     {Object}  mhdr, devAddr, fCtrl, fCnt (16 bits), fOpts, fPort,
+ *                       payload (still encrypted), null if malformed
+ */
+function parseDataFrame(frame) {
+	if (frame.length < DATA_MIN_SIZE) {
+		return null;
+	}
+
+	const micOffset = frame.length - MIC_SIZE;
+	const fCtrl = frame[5];
+	const fOptsEnd = 1 + FHDR_MIN_SIZE + (fCtrl & 0x0f);
+	if (fOptsEnd > micOffset) {
+		return null;
+	}
+
+	return {
+		mhdr: frame[0],
+		devAddr: frame.readUInt32LE(1),
+		fCtrl,
+		fCnt: frame.readUInt16LE(6),
+		fOpts: frame.subarray(8, fOptsEnd),
+		fPort: fOptsEnd < micOffset ? frame[fOptsEnd] : null,
+		payload: fOptsEnd < micOffset ? frame.subarray(fOptsEnd + 1, micOffset) : Buffer.alloc(0),
+		frame
+	};
+}
+
+/**
+ * Checks the MIC of a parsed data frame, then decrypts its payload
+ *
+ * @param      {Object}  msg      The result of parseDataFrame
+ * @param      {Number}  fCnt     The 32 bits frame counter, rebuilt from the 16 bits of the frame
+ * @param      {Buffer}  nwkSKey  The network session key
+ * @param      {Buffer}  appSKey  The application session key
+ * @return     {Buffer}  The clear payload, null if the MIC is wrong
+ */
+function unsecureDataFrame(msg, fCnt, nwkSKey, appSKey) {
+	const frame = msg.frame;
+	const micOffset = frame.length - MIC_SIZE;
+	const dir = msg.mhdr === MHDR_UNCONFIRMED_DOWN || msg.mhdr === MHDR_CONFIRMED_DOWN ? DOWNLINK : UPLINK;
+	const mic = cmac(nwkSKey, Buffer.concat([b0(dir, msg.devAddr, fCnt, micOffset), frame.subarray(0, micOffset)]));
+
+	if (mic.compare(frame, micOffset, frame.length, 0, MIC_SIZE) !== 0) {
+		return null;
+	}
+	if (msg.payload.length === 0) {
+		return msg.payload;
+	}
+	return cryptPayload(msg.fPort === 0 ? nwkSKey : appSKey, dir, msg.devAddr, fCnt, msg.payload);
+}
+
+/**
+ * Rebuilds a 32 bits frame counter from its 16 low bits, the closest value
+ * at or after the last one received
+ *
+ * @param      {Number}  last    The last 32 bits counter, -1 if none
+ * @param      {Number}  fCnt16  The 16 bits of the frame
+ * @return     {Number}  The 32 bits counter
+ */
+function expandFCnt(last, fCnt16) {
+	if (last < 0) {
+		return fCnt16;
+	}
+	let fCnt = last - (last % 0x10000) + fCnt16;
+	if (fCnt < last) {
+		fCnt += 0x10000;
+	}
+	return fCnt % 0x100000000;
+}
+
+exports.MHDR_JOIN_REQUEST = MHDR_JOIN_REQUEST;
+exports.MHDR_JOIN_ACCEPT = MHDR_JOIN_ACCEPT;
+exports.MHDR_UNCONFIRMED_UP = MHDR_UNCONFIRMED_UP;
+exports.MHDR_UNCONFIRMED_DOWN = MHDR_UNCONFIRMED_DOWN;
+exports.MHDR_CONFIRMED_UP = MHDR_CONFIRMED_UP;
+exports.MHDR_CONFIRMED_DOWN = MHDR_CONFIRMED_DOWN;
+exports.FCTRL_ACK = 0x20;
+exports.cmac = cmac;
+exports.buildJoinRequest = buildJoinRequest;
+exports.parseJoinRequest = parseJoinRequest;
+exports.verifyJoinRequest = verifyJoinRequest;
+exports.buildJoinAccept = buildJoinAccept;
+exports.parseJoinAccept = parseJoinAccept;
+exports.deriveSessionKeys = deriveSessionKeys;
+exports.buildDataFrame = buildDataFrame;
+exports.parseDataFrame = parseDataFrame;
+exports.unsecureDataFrame = unsecureDataFrame;
+exports.expandFCnt = expandFCnt;
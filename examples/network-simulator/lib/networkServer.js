@@ -0,0 +1,454 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+const lorawan = require('./lorawan');
+const device = require('./device');
+
+const PROVIDER_CHIRPSTACK = 'chirpstack';
+const PROVIDER_TTN = 'ttn';
+
+/* Downlinks queued per device, the oldest are dropped */
+const DOWNLINK_QUEUE_SIZE = 8;
+
+/* LoRaWAN 1.0 MAX_FCNT_GAP: a larger jump of the uplink counter is a replay */
+const MAX_FCNT_GAP = 16384;
+
+/* EU868 CFList: 867.1 to 867.9 MHz in 100 Hz units, then CFListType 0 */
+const CFLIST = Buffer.from([
+	0x18, 0x4f, 0x84, 0xe8, 0x56, 0x84, 0xb8, 0x5e, 0x84, 0x88, 0x66, 0x84, 0x58, 0x6e, 0x84, 0x00
+]);
+
+/**
+ *Minimal network server and application server stand-in: it answers the
+ *joins, checks the MIC and the frame counter of the uplinks, decrypts them
+ *and publishes them in ChirpStack (v3) or TTN (v3) format. Downlinks pushed
+ *on the MQTT broker are sent in the receive window of the next uplink
+ */
+class NetworkServer {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Object}  options  provider ('chirpstack' or 'ttn'), applicationId,
+	 *                                netId, devices (Map of devEui to { deviceId, appKey })
+	 * @param      {Object}  clock    The virtual clock
+	 * @param      {Object}  client   The MQTT client, publish and subscribe
+	 */
+	constructor(options, clock, client) {
+		if (options.provider !== PROVIDER_CHIRPSTACK && options.provider !== PROVIDER_TTN) {
+			throw new Error('Unknown provider ' + options.provider);
+		}
+
+		this.provider = options.provider;
+		this.applicationId = options.applicationId;
+		this.netId = options.netId || 0x13;
+		this.devices = options.devices;
+		this.clock = clock;
+		this.client = client;
+
+		this.sessions = new Map();
+		this.sessionsByEui = new Map();
+		this.sessionsById = new Map();
+		this.joinNonce = 0;
+		this.nextDevAddr = 1;
+		this.pending = 0;
+		this.onUplink = null;
+		this.stats = {
+			joins: 0,
+			joinsRejected: 0,
+			uplinks: 0,
+			micErrors: 0,
+			replays: 0,
+			retransmissions: 0,
+			unknown: 0,
+			published: 0,
+			publishErrors: 0,
+			downlinksQueued: 0,
+			downlinksSent: 0
+		};
+	}
+
+	/**
+	 * It subscribes to the downlink topics of the application
+	 */
+	start() {
+		this.client.subscribe(this.downlinkTopic('+'));
+	}
+
+	/**
+	 * It handles a frame received by the gateway
+	 *
+	 * @param      {Buffer}  frame    The frame
+	 * @param      {Object}  rxInfo   The radio metadata, time of the end of the frame
+	 * @param      {Object}  sender   The device, to answer in its receive windows
+	 */
+	receive(frame, rxInfo, sender) {
+		const mtype = frame[0] & 0xe0;
+
+		if (mtype === lorawan.MHDR_JOIN_REQUEST) {
+			this.join(frame, rxInfo, sender);
+		} else if (mtype === lorawan.MHDR_UNCONFIRMED_UP || mtype === lorawan.MHDR_CONFIRMED_UP) {
+			this.uplink(frame, rxInfo, sender);
+		} else {
+			this.stats.unknown++;
+		}
+	}
+
+	/**
+	 * It answers a join-request
+	 *
+	 * @param      {Buffer}  frame    The frame
+	 * @param      {Object}  rxInfo   The radio metadata
+	 * @param      {Object}  sender   The device
+	 */
+	join(frame, rxInfo, sender) {
+		const request = lorawan.parseJoinRequest(frame);
+		const profile = request && this.devices.get(request.devEui);
+
+		if (!profile || !lorawan.verifyJoinRequest(frame, profile.appKey)) {
+			this.stats.joinsRejected++;
+			return;
+		}
+		profile.devNonces = profile.devNonces || new Set();
+		if (profile.devNonces.has(request.devNonce)) {
+			this.stats.joinsRejected++;
+			return;
+		}
+		profile.devNonces.add(request.devNonce);
+
+		const previous = this.sessionsByEui.get(request.devEui);
+		if (previous) {
+			this.sessions.delete(previous.devAddr);
+		}
+
+		this.joinNonce = (this.joinNonce + 1) & 0xffffff;
+		const devAddr = (((this.netId & 0x7f) << 25) | this.nextDevAddr++) >>> 0;
+		const keys = lorawan.deriveSessionKeys(profile.appKey, this.joinNonce, this.netId, request.devNonce);
+		const session = {
+			devEui: request.devEui,
+			deviceId: profile.deviceId,
+			devAddr,
+			nwkSKey: keys.nwkSKey,
+			appSKey: keys.appSKey,
+			fCntUp: -1,
+			fCntDown: 0,
+			queue: previous ? previous.queue : []
+		};
+		this.sessions.set(devAddr, session);
+		this.sessionsByEui.set(session.devEui, session);
+		this.sessionsById.set(session.deviceId, session);
+		this.stats.joins++;
+
+		const accept = lorawan.buildJoinAccept({
+			joinNonce: this.joinNonce,
+			netId: this.netId,
+			devAddr,
+			dlSettings: 0,
+			rxDelay: 1,
+			cfList: CFLIST,
+			appKey: profile.appKey
+		});
+		this.clock.at(rxInfo.time + device.JOIN_ACCEPT_DELAY1, () => rxInfo.gateway.downlink(accept, rxInfo, sender));
+	}
+
+	/**
+	 * It checks, decrypts and publishes an uplink, then answers it in RX1
+	 * when a downlink is queued or the uplink is confirmed
+	 *
+	 * @param      {Buffer}  frame    The frame
+	 * @param      {Object}  rxInfo   The radio metadata
+	 * @param      {Object}  sender   The device
+	 */
+	uplink(frame, rxInfo, sender) {
+		const msg = lorawan.parseDataFrame(frame);
+		const session = msg && this.sessions.get(msg.devAddr);
+
+		if (!session) {
+			this.stats.unknown++;
+			return;
+		}
+
+		const fCnt = lorawan.expandFCnt(session.fCntUp, msg.fCnt);
+		const confirmed = (msg.mhdr & 0xe0) === lorawan.MHDR_CONFIRMED_UP;
+		// A confirmed uplink is sent again with the same counter until acknowledged
+		const retransmission = confirmed && fCnt === session.fCntUp;
+		if (!retransmission && (fCnt <= session.fCntUp || fCnt - session.fCntUp > MAX_FCNT_GAP)) {
+			this.stats.replays++;
+			return;
+		}
+		const payload = lorawan.unsecureDataFrame(msg, fCnt, session.nwkSKey, session.appSKey);
+		if (!payload) {
+			this.stats.micErrors++;
+			return;
+		}
+		if (retransmission) {
+			// Already published, the ACK was lost
+			this.stats.retransmissions++;
+			this.downlink(session, true, rxInfo, sender);
+			return;
+		}
+		session.fCntUp = fCnt;
+		this.stats.uplinks++;
+
+		if (msg.fPort) {
+			this.publish(this.uplinkTopic(session), this.uplinkMessage(session, msg, fCnt, payload, rxInfo));
+			if (this.onUplink) {
+				this.onUplink(session, fCnt, payload);
+			}
+		}
+
+		if (session.queue.length !== 0 || confirmed) {
+			this.downlink(session, confirmed, rxInfo, sender);
+		}
+	}
+
+	/**
+	 * It sends the next queued downlink, or an empty ACK, in RX1. A downlink
+	 * the gateway could not send stays queued
+	 *
+	 * @param      {Object}   session    The session
+	 * @param      {Boolean}  ack        The uplink was confirmed
+	 * @param      {Object}   rxInfo     The radio metadata of the uplink
+	 * @param      {Object}   sender     The device
+	 */
+	downlink(session, ack, rxInfo, sender) {
+		const item = session.queue.shift();
+		const frame = lorawan.buildDataFrame({
+			mhdr: item && item.confirmed ? lorawan.MHDR_CONFIRMED_DOWN : lorawan.MHDR_UNCONFIRMED_DOWN,
+			devAddr: session.devAddr,
+			fCtrl: ack ? lorawan.FCTRL_ACK : 0,
+			fCnt: session.fCntDown++,
+			fPort: item ? item.fPort : 0,
+			payload: item ? item.payload : null,
+			nwkSKey: session.nwkSKey,
+			appSKey: session.appSKey
+		});
+
+		this.clock.at(rxInfo.time + device.RECEIVE_DELAY1, () => {
+			if (!rxInfo.gateway.downlink(frame, rxInfo, sender)) {
+				if (item) {
+					session.queue.unshift(item);
+				}
+				return;
+			}
+			if (item) {
+				this.stats.downlinksSent++;
+				this.publish(this.downlinkSentTopic(session), this.downlinkSentMessage(session, item));
+			}
+		});
+	}
+
+	/**
+	 * It queues a downlink pushed on the MQTT broker
+	 *
+	 * @param      {String}  topic    The MQTT topic
+	 * @param      {Buffer}  message  The message
+	 * @return     {Boolean}  True if the message was a downlink of a known device
+	 */
+	handleMessage(topic, message) {
+		const levels = topic.split('/');
+		let session;
+		let items;
+
+		try {
+			message = JSON.parse(message);
+		} catch (e) {
+			return false;
+		}
+
+		if (this.provider === PROVIDER_CHIRPSTACK) {
+			// application/<applicationID>/device/<devEUI>/command/down
+			if (levels.length !== 6 || levels[1] !== String(this.applicationId)) {
+				return false;
+			}
+			session = this.sessionsByEui.get(levels[3].toLowerCase());
+			items = [message];
+		} else {
+			// v3/<application_id>/devices/<device_id>/down/push
+			if (levels.length !== 6 || levels[1] !== this.applicationId) {
+				return false;
+			}
+			session = this.sessionsById.get(levels[3]);
+			items = Array.isArray(message.downlinks) ? message.downlinks : [];
+		}
+		if (!session) {
+			return false;
+		}
+
+		items.forEach((item) => {
+			const fPort = this.provider === PROVIDER_CHIRPSTACK ? item.fPort : item.f_port;
+			const data = this.provider === PROVIDER_CHIRPSTACK ? item.data : item.frm_payload;
+			if (!(fPort > 0 && fPort < 224)) {
+				return;
+			}
+			session.queue.push({
+				fPort,
+				payload: Buffer.from(data || '', 'base64'),
+				confirmed: !!item.confirmed
+			});
+			if (session.queue.length > DOWNLINK_QUEUE_SIZE) {
+				session.queue.shift();
+			}
+			this.stats.downlinksQueued++;
+		});
+		return true;
+	}
+
+	/**
+	 * It publishes a message, counting those not yet written
+	 *
+	 * @param      {String}  topic    The MQTT topic
+	 * @param      {Object}  message  The message
+	 */
+	publish(topic, message) {
+		this.pending++;
+		this.client.publish(topic, JSON.stringify(message), { qos: 0 }, (error) => {
+			this.pending--;
+			if (error) {
+				this.stats.publishErrors++;
+			} else {
+				this.stats.published++;
+			}
+		});
+	}
+
+	/**
+	 * Topic of the uplinks of a device
+	 *
+	 * @param      {Object}  session  The session
+	 * @return     {String}  The topic
+	 */
+	uplinkTopic(session) {
+		if (this.provider === PROVIDER_CHIRPSTACK) {
+			return 'application/' + this.applicationId + '/device/' + session.devEui + '/event/up';
+		}
+		return 'v3/' + this.applicationId + '/devices/' + session.deviceId + '/up';
+	}
+
+	/**
+	 * Topic of the downlinks pushed for a device
+	 *
+	 * @param      {String}  device  The device EUI (ChirpStack) or identifier (TTN), or '+'
+	 * @return     {String}  The topic
+	 */
+	downlinkTopic(device) {
+		if (this.provider === PROVIDER_CHIRPSTACK) {
+			return 'application/' + this.applicationId + '/device/' + device + '/command/down';
+		}
+		return 'v3/' + this.applicationId + '/devices/' + device + '/down/push';
+	}
+
+	/**
+	 * Topic of the downlinks sent to a device
+	 *
+	 * @param      {Object}  session  The session
+	 * @return     {String}  The topic
+	 */
+	downlinkSentTopic(session) {
+		if (this.provider === PROVIDER_CHIRPSTACK) {
+			return 'application/' + this.applicationId + '/device/' + session.devEui + '/event/txack';
+		}
+		return 'v3/' + this.applicationId + '/devices/' + session.deviceId + '/down/sent';
+	}
+
+	/**
+	 * Uplink message. The TTN one also carries the fields of the TTN v2
+	 * format that the agent reads (payload_raw, hardware_serial)
+	 *
+	 * @param      {Object}  session  The session
+	 * @param      {Object}  msg      The parsed frame
+	 * @param      {Number}  fCnt     The 32 bits frame counter
+	 * @param      {Buffer}  payload  The clear payload
+	 * @param      {Object}  rxInfo   The radio metadata
+	 * @return     {Object}  The message
+	 */
+	uplinkMessage(session, msg, fCnt, payload, rxInfo) {
+		const data = payload.toString('base64');
+
+		if (this.provider === PROVIDER_CHIRPSTACK) {
+			return {
+				applicationID: String(this.applicationId),
+				applicationName: String(this.applicationId),
+				deviceName: session.deviceId,
+				devEUI: session.devEui,
+				rxInfo: [{ gatewayID: '0000000000000000', rssi: -60, loRaSNR: 7 }],
+				txInfo: { frequency: rxInfo.frequency, dr: rxInfo.dr },
+				adr: false,
+				fCnt,
+				fPort: msg.fPort,
+				data
+			};
+		}
+
+		return {
+			end_device_ids: {
+				device_id: session.deviceId,
+				application_ids: { application_id: this.applicationId },
+				dev_eui: session.devEui.toUpperCase(),
+				dev_addr: ('0000000' + session.devAddr.toString(16)).slice(-8).toUpperCase()
+			},
+			uplink_message: {
+				f_port: msg.fPort,
+				f_cnt: fCnt,
+				frm_payload: data,
+				rx_metadata: [{ gateway_ids: { gateway_id: 'simulator' }, rssi: -60, snr: 7 }],
+				settings: {
+					data_rate: { lora: { bandwidth: 125000, spreading_factor: rxInfo.sf } },
+					frequency: String(rxInfo.frequency)
+				}
+			},
+			app_id: this.applicationId,
+			dev_id: session.deviceId,
+			hardware_serial: session.devEui.toUpperCase(),
+			port: msg.fPort,
+			counter: fCnt,
+			payload_raw: data
+		};
+	}
+
+	/**
+	 * Downlink sent message
+	 *
+	 * @param      {Object}  session  The session
+	 * @param      {Object}  item     The downlink
+	 * @return     {Object}  The message
+	 */
+	downlinkSentMessage(session, item) {
+		if (this.provider === PROVIDER_CHIRPSTACK) {
+			return {
+				applicationID: String(this.applicationId),
+				deviceName: session.deviceId,
+				devEUI: session.devEui,
+				fCnt: session.fCntDown - 1
+			};
+		}
+		return {
+			end_device_ids: {
+				device_id: session.deviceId,
+				application_ids: { application_id: this.applicationId }
+			},
+			downlink_sent: { f_port: item.fPort, f_cnt: session.fCntDown - 1, frm_payload: item.payload.toString('base64') }
+		};
+	}
+}
+
+exports.PROVIDER_CHIRPSTACK = PROVIDER_CHIRPSTACK;
+exports.PROVIDER_TTN = PROVIDER_TTN;
+exports.NetworkServer = NetworkServer;
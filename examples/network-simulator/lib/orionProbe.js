@@ -0,0 +1,189 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+const http = require('http');
+
+/**
+ *End of the latency measurement: an NGSI v2 subscription of the Context
+ *Broker notifies the entity updates of the agent, matched with the uplinks
+ *by device identifier and sequence number
+ */
+class OrionProbe {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Object}  options  orionUrl, notifyHost, notifyPort, service, subservice,
+	 *                                entityType, attribute (the sequence number)
+	 */
+	constructor(options) {
+		this.options = options;
+		this.sent = new Map();
+		this.latencies = [];
+		this.unmatched = 0;
+		this.subscriptionUrl = null;
+	}
+
+	/**
+	 * It starts the notification server, then subscribes
+	 *
+	 * @param      {Function}  callback  The callback
+	 */
+	start(callback) {
+		this.server = http.createServer((req, res) => {
+			let body = '';
+			req.on('data', (chunk) => {
+				body += chunk;
+			});
+			req.on('end', () => {
+				res.writeHead(204);
+				res.end();
+				this.notification(body);
+			});
+		});
+
+		this.server.listen(this.options.notifyPort, () => {
+			const subscription = {
+				description: 'iotagent-lora network simulator',
+				subject: {
+					entities: [{ idPattern: '.*', type: this.options.entityType }],
+					condition: { attrs: [this.options.attribute] }
+				},
+				notification: {
+					http: { url: 'http://' + this.options.notifyHost + ':' + this.options.notifyPort + '/notify' },
+					attrs: [this.options.attribute],
+					attrsFormat: 'keyValues'
+				}
+			};
+			this.request('POST', '/v2/subscriptions', subscription, (error, res) => {
+				if (error || res.statusCode !== 201) {
+					return callback(error || new Error('Subscription refused: ' + res.statusCode));
+				}
+				this.subscriptionUrl = res.headers.location;
+				callback();
+			});
+		});
+	}
+
+	/**
+	 * It unsubscribes, then stops the notification server
+	 *
+	 * @param      {Function}  callback  The callback
+	 */
+	stop(callback) {
+		const close = () => this.server.close(() => callback());
+
+		if (!this.subscriptionUrl) {
+			return close();
+		}
+		this.request('DELETE', this.subscriptionUrl, null, close);
+	}
+
+	/**
+	 * It records the publication of an uplink
+	 *
+	 * @param      {String}  deviceId  The device identifier
+	 * @param      {Number}  seq       The sequence number carried by the uplink
+	 */
+	published(deviceId, seq) {
+		this.sent.set(deviceId + '#' + seq, process.hrtime.bigint());
+	}
+
+	/**
+	 * It matches a notification with the uplinks. The device identifier is
+	 * the last part of the entity identifier, e.g. urn:Type:<device_id>
+	 *
+	 * @param      {String}  body    The notification
+	 */
+	notification(body) {
+		const now = process.hrtime.bigint();
+		let data;
+
+		try {
+			data = JSON.parse(body).data || [];
+		} catch (e) {
+			return;
+		}
+
+		data.forEach((entity) => {
+			const deviceId = entity.id.split(':').pop();
+			const key = deviceId + '#' + Number(entity[this.options.attribute]);
+			const sent = this.sent.get(key);
+
+			if (sent === undefined) {
+				this.unmatched++;
+				return;
+			}
+			this.sent.delete(key);
+			this.latencies.push(Number(now - sent) / 1e6);
+		});
+	}
+
+	/**
+	 * Latency statistics of the matched uplinks, in ms
+	 *
+	 * @return     {Object}  count, missing, unmatched, p50, p95, p99 and max
+	 */
+	summary() {
+		const sorted = this.latencies.slice().sort((a, b) => a - b);
+		const percentile = (p) => (sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))] : null);
+
+		return {
+			count: sorted.length,
+			missing: this.sent.size,
+			unmatched: this.unmatched,
+			p50: percentile(0.5),
+			p95: percentile(0.95),
+			p99: percentile(0.99),
+			max: sorted.length ? sorted[sorted.length - 1] : null
+		};
+	}
+
+	/**
+	 * It sends a request to the Context Broker
+	 *
+	 * @param      {String}    method    The method
+	 * @param      {String}    path      The path
+	 * @param      {Object}    body      The JSON body, or null
+	 * @param      {Function}  callback  The callback, with (error, response)
+	 */
+	request(method, path, body, callback) {
+		const url = new URL(path, this.options.orionUrl);
+		const payload = body ? JSON.stringify(body) : null;
+		const headers = {
+			'fiware-service': this.options.service,
+			'fiware-servicepath': this.options.subservice
+		};
+
+		if (payload) {
+			headers['Content-Type'] = 'application/json';
+			headers['Content-Length'] = Buffer.byteLength(payload);
+		}
+
+		const req = http.request(url, { method, headers }, (res) => {
+			res.resume();
+			res.on('end', () => callback(null, res));
+		});
+		req.on('error', callback);
+		req.end(payload);
+	}
+}
+
+exports.OrionProbe = OrionProbe;
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* EU868 uplink channels once the join-accept CFList is applied, in Hz */
+const CHANNELS = [868100000, 868300000, 868500000, 867100000, 867300000, 867500000, 867700000, 867900000];
+
+const BANDWIDTH = 125000;
+const PREAMBLE_SYMBOLS = 8;
+const CODING_RATE = 1; // 4/5
+
+/* Duty cycle of the EU868 sub-bands g (865-868 MHz) and g1 (868-868.6 MHz), in % */
+const DUTY_CYCLE = 1;
+
+/**
+ * Time on air of a LoRa frame: explicit header, CRC on, 125 kHz (SX1276
+ * datasheet, LoRa modem section)
+ *
+ * @param      {Number}  sf      The spreading factor, 7 to 12
+ * @param      {Number}  size    The PHY payload size in bytes
+ * @return     {Number}  The time on air in ms
+ */
+function timeOnAir(sf, size) {
+	const symbol = (1 << sf) / BANDWIDTH;
+	const lowDataRate = sf >= 11 ? 1 : 0;
+	const payloadSymbols =
+		8 +
+		Math.max(Math.ceil((8 * size - 4 * sf + 28 + 16) / (4 * (sf - 2 * lowDataRate))) * (CODING_RATE + 4), 0);
+
+	return (PREAMBLE_SYMBOLS + 4.25 + payloadSymbols) * symbol * 1000;
+}
+
+/**
+ * EU868 data rate of a spreading factor
+ *
+ * @param      {Number}  sf      The spreading factor
+ * @return     {Number}  The data rate, DR0 to DR5
+ */
+function dataRate(sf) {
+	return 12 - sf;
+}
+
+/**
+ * EU868 sub-band of a frequency
+ *
+ * @param      {Number}  frequency  The frequency in Hz
+ * @return     {Number}  0 for g, 1 for g1
+ */
+function subBand(frequency) {
+	return frequency >= 868000000 ? 1 : 0;
+}
+
+/**
+ *Shared medium heard by a single gateway: frames on the same channel and
+ *spreading factor that overlap are all lost, other combinations are
+ *considered orthogonal. The gateway is half duplex: the uplinks are lost
+ *while it sends a downlink
+ */
+class Radio {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Object}    clock      The virtual clock
+	 * @param      {Function}  receiver   Called with (frame, rxInfo, sender) for each frame received
+	 * @param      {Number}    dutyCycle  Duty cycle of the gateway in %, 0 for no limit
+	 */
+	constructor(clock, receiver, dutyCycle = DUTY_CYCLE) {
+		this.clock = clock;
+		this.receiver = receiver;
+		this.offTime = dutyCycle > 0 ? 100 / dutyCycle : 0;
+		this.active = new Map();
+		this.gatewayTxAllowed = [0, 0];
+		this.gatewayBusyUntil = 0;
+		this.stats = {
+			transmitted: 0,
+			received: 0,
+			collided: 0,
+			missed: 0,
+			airtime: 0,
+			downlinks: 0,
+			downlinkAirtime: 0,
+			downlinksDropped: 0
+		};
+	}
+
+	/**
+	 * It transmits a frame
+	 *
+	 * @param      {Buffer}  frame    The frame
+	 * @param      {Number}  sf       The spreading factor
+	 * @param      {Number}  channel  The channel index
+	 * @param      {Object}  sender   The device, handed to the receiver to answer in its receive windows
+	 * @return     {Number}  The time on air in ms
+	 */
+	transmit(frame, sf, channel, sender) {
+		const key = channel * 16 + sf;
+		const toa = timeOnAir(sf, frame.length);
+		const tx = { collided: false, missed: this.clock.now < this.gatewayBusyUntil };
+		let active = this.active.get(key);
+
+		if (!active) {
+			active = new Set();
+			this.active.set(key, active);
+		}
+		if (active.size !== 0) {
+			tx.collided = true;
+			active.forEach((other) => {
+				other.collided = true;
+			});
+		}
+		active.add(tx);
+
+		this.stats.transmitted++;
+		this.stats.airtime += toa;
+		this.clock.after(toa, () => {
+			active.delete(tx);
+			if (tx.missed) {
+				this.stats.missed++;
+				return;
+			}
+			if (tx.collided) {
+				this.stats.collided++;
+				return;
+			}
+			this.stats.received++;
+			this.receiver(
+				frame,
+				{
+					frequency: CHANNELS[channel],
+					sf,
+					dr: dataRate(sf),
+					airtime: toa,
+					time: this.clock.now,
+					gateway: this
+				},
+				sender
+			);
+		});
+		return toa;
+	}
+
+	/**
+	 * It sends a downlink from the gateway, in RX1 of an uplink: same
+	 * frequency and spreading factor. The device gets it if the duty cycle
+	 * of the gateway allows it.
+	 *
+	 * @param      {Buffer}   frame     The frame
+	 * @param      {Object}   rxInfo    The radio metadata of the uplink
+	 * @param      {Object}   receiver  The device
+	 * @return     {Boolean}  False if the duty cycle held the downlink back
+	 */
+	downlink(frame, rxInfo, receiver) {
+		const band = subBand(rxInfo.frequency);
+		const toa = timeOnAir(rxInfo.sf, frame.length);
+
+		if (this.clock.now < this.gatewayTxAllowed[band]) {
+			this.stats.downlinksDropped++;
+			return false;
+		}
+		this.gatewayTxAllowed[band] = this.clock.now + toa * this.offTime;
+		this.gatewayBusyUntil = Math.max(this.gatewayBusyUntil, this.clock.now + toa);
+		this.active.forEach((active) =>
+			active.forEach((tx) => {
+				tx.missed = true;
+			})
+		);
+
+		this.stats.downlinks++;
+		this.stats.downlinkAirtime += toa;
+		receiver.receive(frame);
+		return true;
+	}
+}
+
+exports.CHANNELS = CHANNELS;
+exports.timeOnAir = timeOnAir;
+exports.dataRate = dataRate;
+exports.Radio = Radio;
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* Trials of the MAC, MAX_ACK_RETRIES of LoRaMac.h */
+const MAX_ACK_RETRIES = 8;
+
+/* ACK rate of 100 % in 1/256 units, and weight of a transmission: 1/8 */
+const RATE_ONE = 256;
+const RATE_SHIFT = 3;
+
+/**
+ *Retransmissions of the LoRaMac stack without a policy: the trials requested,
+ *no back-off beyond the ACK timeout, the datarate lowered every 2 trials
+ */
+class StockPolicy {
+	/**
+	 * Trials of a new confirmed uplink
+	 *
+	 * @param      {Number}  nbTrials  The trials requested
+	 * @return     {Number}  The trials
+	 */
+	nbTrials(nbTrials) {
+		return Math.min(Math.max(nbTrials, 1), MAX_ACK_RETRIES);
+	}
+
+	/**
+	 * Delay of a retransmission after the ACK timeout
+	 *
+	 * @param      {Number}  retry   1 for the first retransmission
+	 * @return     {Number}  The delay in ms
+	 */
+	backoff(retry) {
+		return 0;
+	}
+
+	/**
+	 * Whether a retransmission lowers the datarate
+	 *
+	 * @param      {Number}   retry   1 for the first retransmission
+	 * @return     {Boolean}  True to use the next lower datarate
+	 */
+	stepDownDatarate(retry) {
+		return retry % 2 === 0;
+	}
+
+	/**
+	 * Whether the frame is abandoned instead of retransmitted
+	 *
+	 * @param      {Number}   age     The time since the request in ms
+	 * @return     {Boolean}  True to abandon the frame
+	 */
+	isStale(age) {
+		return false;
+	}
+
+	/**
+	 * Outcome of a confirmed uplink
+	 *
+	 * @param      {Boolean}  ackReceived  The frame was acknowledged
+	 * @param      {Number}   nbTrans      The transmissions of the frame
+	 */
+	onResult(ackReceived, nbTrans) {}
+
+	/**
+	 * A fresher sample waits for the uplink in progress
+	 */
+	fresherData() {}
+}
+
+/**
+ *Adaptive policy of Utilities/retrans_policy.c, with the same integer
+ *arithmetic
+ */
+class AdaptivePolicy extends StockPolicy {
+	/**
+	 * Constructs the object.
+	 *
+	 * @param      {Object}    config  minTrials, maxTrials, backoffBase, backoffMax and maxAge (ms)
+	 * @param      {Function}  random  Returns numbers in [0, 1[
+	 */
+	constructor(config, random) {
+		super();
+		this.config = config;
+		this.random = random;
+		this.ackRate = RATE_ONE;
+		this.fresher = false;
+	}
+
+	nbTrials(nbTrials) {
+		const config = this.config;
+
+		this.fresher = false;
+		return super.nbTrials(
+			config.minTrials + (((config.maxTrials - config.minTrials) * this.ackRate + RATE_ONE / 2) >> 8)
+		);
+	}
+
+	backoff(retry) {
+		const config = this.config;
+		let mean = config.backoffBase;
+
+		if (mean === 0) {
+			return 0;
+		}
+		for (; retry > 1 && mean < config.backoffMax; retry--) {
+			mean *= 2;
+		}
+		mean = Math.min(mean, config.backoffMax);
+		return Math.floor(mean / 2) + Math.floor(this.random() * (mean + 1));
+	}
+
+	stepDownDatarate(retry) {
+		return retry % 2 === 0 && this.ackRate >= RATE_ONE / 2;
+	}
+
+	isStale(age) {
+		if (this.fresher) {
+			this.fresher = false;
+			return true;
+		}
+		return this.config.maxAge !== 0 && age >= this.config.maxAge;
+	}
+
+	onResult(ackReceived, nbTrans) {
+		let lost = ackReceived ? Math.max(nbTrans - 1, 0) : nbTrans;
+
+		for (; lost > 0; lost--) {
+			this.ackRate -= this.ackRate >> RATE_SHIFT;
+		}
+		if (ackReceived) {
+			this.ackRate += (RATE_ONE - this.ackRate) >> RATE_SHIFT;
+		}
+	}
+
+	fresherData() {
+		this.fresher = true;
+	}
+}
+
+/* Configuration of the End_Node application */
+const ADAPTIVE_CONFIG = { minTrials: 1, maxTrials: 8, backoffBase: 2000, backoffMax: 32000, maxAge: 60000 };
+
+/**
+ * It creates the retransmission policy of a device
+ *
+ * @param      {String}    name    stock or adaptive
+ * @param      {Function}  random  Returns numbers in [0, 1[
+ * @return     {Object}    The policy
+ */
+function create(name, random) {
+	if (name === 'adaptive') {
+		return new AdaptivePolicy(ADAPTIVE_CONFIG, random);
+	}
+	if (name === 'stock') {
+		return new StockPolicy();
+	}
+	throw new Error('Unknown retransmission policy ' + name);
+}
+
+exports.MAX_ACK_RETRIES = MAX_ACK_RETRIES;
+exports.StockPolicy = StockPolicy;
+exports.AdaptivePolicy = AdaptivePolicy;
+exports.create = create;
@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+
+# Device group of the simulated devices: the agent provisions them on their
+# first uplink. The luminosity of channel 0 carries the sequence number of
+# the uplink, read by the latency probe of the simulator as 'seq'.
+
+IOTA=${IOTA:-localhost:4041}
+MQTT_HOST=${MQTT_HOST:-mqtt}
+PROVIDER=${PROVIDER:-TTN}
+APPLICATION_ID=${APPLICATION_ID:-demoTTN}
+
+echo 'registering device group'
+
+curl --location --request POST "$IOTA/iot/services" \
+--header 'fiware-service: smartgondor' \
+--header 'fiware-servicePath: /environment' \
+--header 'Content-Type: application/json' \
+--data-raw '{
+    "services": [
+        {
+            "entity_type": "WeatherObserved",
+            "apikey": "",
+            "resource": "70B3D57ED00006B2",
+            "attributes": [
+                {
+                    "object_id": "luminosity_0",
+                    "name": "seq",
+                    "type": "Number"
+                },
+                {
+                    "object_id": "temperature_1",
+                    "name": "temperature",
+                    "type": "Number"
+                },
+                {
+                    "object_id": "relative_humidity_2",
+                    "name": "relative_humidity",
+                    "type": "Number"
+                }
+            ],
+            "internal_attributes": {
+                "lorawan": {
+                    "application_server": {
+                        "host": "'"$MQTT_HOST"'",
+                        "username": "admin",
+                        "password": "password",
+                        "provider": "'"$PROVIDER"'"
+                    },
+                    "app_eui": "70B3D57ED00006B2",
+                    "application_id": "'"$APPLICATION_ID"'",
+                    "application_key": "BE6996EEE2B2D6AFFD951383C1F3C3BD",
+                    "data_model": "cayennelpp"
+                }
+            }
+        }
+    ]
+}'
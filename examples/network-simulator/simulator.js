@@ -0,0 +1,301 @@
+#!/usr/bin/env node
+
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Network scale simulation: end devices on a virtual clock and radio, modelled
+ * or running the MAC of the firmware, a network server stand-in publishing
+ * their uplinks to the MQTT broker of the agent, and optionally the latency up
+ * to the Context Broker. See README.md.
+ */
+
+const VirtualClock = require('./lib/clock').VirtualClock;
+const Radio = require('./lib/radio').Radio;
+const Device = require('./lib/device').Device;
+const FirmwareDevice = require('./lib/firmwareDevice').FirmwareDevice;
+const NetworkServer = require('./lib/networkServer').NetworkServer;
+const OrionProbe = require('./lib/orionProbe').OrionProbe;
+
+/* Publications written to the broker late before the clock is held */
+const MAX_PENDING = 1000;
+
+const defaults = {
+	devices: 1000,
+	firmware: 0,
+	period: 300,
+	duration: 3600,
+	speed: 0,
+	provider: 'ttn',
+	mqtt: 'mqtt://localhost:1883',
+	username: undefined,
+	password: undefined,
+	'app-id': 'demoTTN',
+	'app-eui': '70B3D57ED00006B2',
+	'app-key': 'BE6996EEE2B2D6AFFD951383C1F3C3BD',
+	'dev-eui-prefix': 'a0b1c2d3',
+	sf: '7',
+	confirmed: 0,
+	retrans: 'stock',
+	'gateway-duty-cycle': 1,
+	seed: 1,
+	report: 10,
+	orion: undefined,
+	'notify-host': 'localhost',
+	'notify-port': 4090,
+	service: 'smartgondor',
+	subservice: '/environment',
+	'entity-type': 'WeatherObserved',
+	'seq-attribute': 'seq',
+	'dry-run': false
+};
+
+/**
+ * It parses the command line, --name value or --flag
+ *
+ * @param      {Array}   argv    The arguments
+ * @return     {Object}  The options
+ */
+function parseArguments(argv) {
+	const options = Object.assign({}, defaults);
+
+	for (let i = 0; i < argv.length; i++) {
+		const name = argv[i].replace(/^--/, '');
+		if (!(name in defaults) || name === argv[i]) {
+			throw new Error('Unknown option ' + argv[i]);
+		}
+		if (typeof defaults[name] === 'boolean') {
+			options[name] = true;
+		} else if (typeof defaults[name] === 'number') {
+			options[name] = Number(argv[++i]);
+		} else {
+			options[name] = argv[++i];
+		}
+	}
+	return options;
+}
+
+/**
+ * Seeded pseudo random generator (mulberry32)
+ *
+ * @param      {Number}    seed    The seed
+ * @return     {Function}  Returns numbers in [0, 1[
+ */
+function generator(seed) {
+	let state = seed >>> 0;
+	return function () {
+		state = (state + 0x6d2b79f5) >>> 0;
+		let t = state;
+		t = Math.imul(t ^ (t >>> 15), t | 1);
+		t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+		return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+	};
+}
+
+/**
+ * MQTT client that drops the messages, to measure the simulator alone
+ *
+ * @return     {Object}  The client
+ */
+function dryRunClient() {
+	return {
+		subscribe() {},
+		publish(topic, message, options, callback) {
+			setImmediate(callback);
+		},
+		on() {},
+		end(force, callback) {
+			callback();
+		}
+	};
+}
+
+/**
+ * It connects to the MQTT broker
+ *
+ * @param      {Object}    options   The options
+ * @param      {Function}  callback  The callback, with (error, client)
+ */
+function connect(options, callback) {
+	if (options['dry-run']) {
+		return callback(null, dryRunClient());
+	}
+
+	const client = require('mqtt').connect(options.mqtt, {
+		username: options.username,
+		password: options.password,
+		clientId: 'iotagent-lora-simulator_' + Math.random().toString(16).substr(2, 8)
+	});
+	client.once('connect', () => callback(null, client));
+	client.once('error', (error) => callback(error));
+}
+
+/**
+ * It runs the simulation
+ *
+ * @param      {Object}  options  The options
+ */
+function simulate(options) {
+	const random = generator(options.seed);
+	const clock = new VirtualClock(options.speed);
+	const profiles = new Map();
+	const devices = [];
+	const firmware = [];
+	const period = options.period * 1000;
+	const wallStart = Date.now();
+	let ns;
+	let probe;
+
+	const radio = new Radio(
+		clock,
+		(frame, rxInfo, sender) => ns.receive(frame, rxInfo, sender),
+		options['gateway-duty-cycle']
+	);
+
+	for (let i = 0; i < options.devices; i++) {
+		const devEui = (options['dev-eui-prefix'] + ('0000000' + i.toString(16)).slice(-8)).toLowerCase();
+		const deviceId = 'sim-' + ('00000' + i).slice(-6);
+		const sf = options.sf === 'mixed' ? 7 + Math.floor(random() * 6) : Number(options.sf);
+		const params = {
+			devEui,
+			appEui: options['app-eui'],
+			appKey: options['app-key'],
+			sf,
+			period,
+			confirmed: random() < options.confirmed,
+			retrans: options.retrans
+		};
+		profiles.set(devEui, { deviceId, appKey: Buffer.from(options['app-key'], 'hex') });
+		if (i < options.firmware) {
+			params.seed = 1 + Math.floor(random() * 0x7fffffff);
+			firmware.push(new FirmwareDevice(params, clock, radio));
+			devices.push(firmware[firmware.length - 1]);
+		} else {
+			params.random = random;
+			devices.push(new Device(params, clock, radio));
+		}
+	}
+
+	const report = () => {
+		const wall = (Date.now() - wallStart) / 1000;
+		const line = [
+			'virtual ' + Math.round(clock.now / 1000) + ' s',
+			'wall ' + wall.toFixed(1) + ' s',
+			'joined ' + ns.sessions.size + '/' + devices.length,
+			'uplinks ' + ns.stats.uplinks,
+			'published ' + ns.stats.published + ' (' + (ns.stats.published / wall).toFixed(0) + '/s)',
+			'collided ' + radio.stats.collided,
+			'missed ' + radio.stats.missed
+		];
+		if (probe) {
+			const latency = probe.summary();
+			line.push('agent p50 ' + (latency.p50 === null ? '-' : latency.p50.toFixed(1) + ' ms'));
+		}
+		console.log(line.join(', '));
+	};
+
+	const finish = (client) => {
+		clearInterval(timer);
+		firmware.forEach((device) => device.stop());
+		report();
+		const summary = {
+			options,
+			virtualSeconds: clock.now / 1000,
+			wallSeconds: (Date.now() - wallStart) / 1000,
+			radio: radio.stats,
+			networkServer: ns.stats,
+			devices: devices.reduce((sum, device) => {
+				Object.keys(device.stats).forEach((key) => {
+					sum[key] = (sum[key] || 0) + device.stats[key];
+				});
+				return sum;
+			}, {})
+		};
+		summary.publishedPerSecond = ns.stats.published / summary.wallSeconds;
+		if (summary.devices.confirmed) {
+			const confirmed = summary.devices;
+			summary.confirmedUplinks = {
+				policy: options.retrans,
+				ackSuccess: confirmed.acked / (confirmed.acked + confirmed.unacked),
+				transmissionsPerUplink: confirmed.confirmedTransmissions / confirmed.confirmed,
+				airtimePerAck: confirmed.acked ? confirmed.confirmedAirtime / confirmed.acked : null,
+				ackDelay: confirmed.acked ? confirmed.ackDelay / confirmed.acked : null
+			};
+		}
+
+		const end = () => client.end(false, () => console.log(JSON.stringify(summary, null, 4)));
+		if (!probe) {
+			return end();
+		}
+		// Leave the agent time to forward the last uplinks
+		setTimeout(() => {
+			summary.agentLatency = probe.summary();
+			probe.stop(end);
+		}, 5000);
+	};
+
+	let timer;
+	connect(options, (error, client) => {
+		if (error) {
+			console.error('Error connecting to the MQTT broker: ' + error.message);
+			process.exit(1);
+		}
+
+		ns = new NetworkServer(
+			{ provider: options.provider, applicationId: options['app-id'], devices: profiles },
+			clock,
+			client
+		);
+		client.on('message', (topic, message) => ns.handleMessage(topic, message));
+		ns.start();
+		clock.setGate(() => ns.pending < MAX_PENDING);
+
+		const run = () => {
+			devices.forEach((device) => device.start(random() * period));
+			timer = setInterval(report, options.report * 1000);
+			process.once('SIGINT', () => clock.stop());
+			clock.run(options.duration * 1000, () => finish(client));
+		};
+
+		if (!options.orion) {
+			return run();
+		}
+		probe = new OrionProbe({
+			orionUrl: options.orion,
+			notifyHost: options['notify-host'],
+			notifyPort: options['notify-port'],
+			service: options.service,
+			subservice: options.subservice,
+			entityType: options['entity-type'],
+			attribute: options['seq-attribute']
+		});
+		ns.onUplink = (session, fCnt, payload) => probe.published(session.deviceId, payload.readUInt16BE(2));
+		probe.start((error) => {
+			if (error) {
+				console.error('Error subscribing to the Context Broker: ' + error.message);
+				process.exit(1);
+			}
+			run();
+		});
+	});
+}
+
+simulate(parseArguments(process.argv.slice(2)));
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2019 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* eslint-disable consistent-return */
+
+const config = require('../configService');
+const context = {
+	op: 'IoTAgentLoRaWAN.TimeSeries'
+};
+
+const TIMESERIES_VERSION = 1;
+const TIMESERIES_HEADER_SIZE = 3; // version, number of channels, number of samples
+const TIMESERIES_VARINT_MAX_SIZE = 5;
+
+// resolution of the channels of the STM32 example firmware: pressure in hPa * 10, temperature in degC * 100 and
+// humidity in % * 10; the values of any other channel are reported as sent
+const TIMESERIES_CHANNEL_DIVISORS = [10, 100, 10];
+
+/**
+ * Decodes a time series payload (time_series.c in the STM32 example firmware)
+ *
+ * Each channel gives the newest value, the time it was taken as TimeInstant metadata and the whole series, oldest
+ * first, as series metadata.
+ *
+ * @param      {String}    payload  Time series payload
+ */
+function decodePayload(payload) {
+	const decodedObject = {};
+	config.getLogger().info(context, 'Decoding time series message:' + payload);
+	try {
+		const series = decodeTimeSeries(payload);
+		const receptionTime = Date.now();
+		const nbSamples = series.channels.length > 0 ? series.channels[0].length : 0;
+		for (let channel = 0; channel < series.channels.length && nbSamples > 0; channel++) {
+			const divisor = TIMESERIES_CHANNEL_DIVISORS[channel] || 1;
+			const samples = series.channels[channel].map(function (value, index) {
+				const age = series.age + (nbSamples - 1 - index) * series.period;
+				return { value: value / divisor, timestamp: new Date(receptionTime - age).toISOString() };
+			});
+			const newest = samples[nbSamples - 1];
+			decodedObject[channel.toString()] = {
+				value: newest.value,
+				metadata: {
+					TimeInstant: { type: 'DateTime', value: newest.timestamp },
+					series: { type: 'StructuredValue', value: samples }
+				}
+			};
+		}
+	} catch (e) {
+		config.getLogger().error(context, 'Error decoding time series message:' + e);
+		return;
+	}
+	return decodedObject;
+}
+
+/**
+ * Decodes the samples of a time series payload
+ *
+ * @param      {String}  bufferBase64  Time series payload
+ * @return     {Object}  {age of the newest sample and sampling period in ms, values of each channel, oldest first}
+ */
+function decodeTimeSeries(bufferBase64) {
+	const buffer = Buffer.from(bufferBase64, 'base64');
+	if (buffer.length < TIMESERIES_HEADER_SIZE) {
+		throw new Error('Invalid time series buffer size');
+	}
+	if (buffer[0] !== TIMESERIES_VERSION) {
+		throw new Error('Unsupported time series version ' + buffer[0]);
+	}
+
+	const nbChannels = buffer[1];
+	const nbSamples = buffer[2];
+	const cursor = { offset: TIMESERIES_HEADER_SIZE };
+	const age = readVarint(buffer, cursor);
+	const period = readVarint(buffer, cursor);
+	const channels = [];
+	const values = [];
+	for (let channel = 0; channel < nbChannels; channel++) {
+		channels.push([]);
+		values.push(0);
+	}
+
+	// samples come newest first, each one as the difference with the more recent one
+	for (let sample = 0; sample < nbSamples; sample++) {
+		for (let channel = 0; channel < nbChannels; channel++) {
+			values[channel] += unzigzag(readVarint(buffer, cursor));
+			channels[channel].unshift(values[channel]);
+		}
+	}
+	if (cursor.offset !== buffer.length) {
+		throw new Error('Invalid time series message');
+	}
+
+	return { age, period, channels };
+}
+
+/**
+ * It reads an unsigned varint, 7 bits per byte, least significant first
+ *
+ * @param      {Buffer}  buffer  The buffer
+ * @param      {Object}  cursor  The offset of the varint, moved past it
+ * @return     {number}  The value
+ */
+function readVarint(buffer, cursor) {
+	let value = 0;
+	let weight = 1;
+	for (let i = 0; i < TIMESERIES_VARINT_MAX_SIZE; i++) {
+		if (cursor.offset >= buffer.length) {
+			throw new Error('Invalid time series message');
+		}
+		const byte = buffer[cursor.offset];
+		cursor.offset++;
+		value += (byte & 0x7f) * weight;
+		if ((byte & 0x80) === 0) {
+			return value;
+		}
+		weight *= 128;
+	}
+	throw new Error('Invalid time series varint');
+}
+
+/**
+ * It maps back zig-zag encoded values: 0, 1, 2, 3, 4... are 0, -1, 1, -2, 2...
+ *
+ * @param      {number}  value  The zig-zag encoded value
+ * @return     {number}  The signed value
+ */
+function unzigzag(value) {
+	return value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+}
+
+exports.decodePayload = decodePayload;
+exports.decodeTimeSeries = decodeTimeSeries;
@@ -23,6 +23,7 @@
 
 const cayenneLpp = require('./dataModels/cayenneLpp');
 const cbor = require('./dataModels/cbor');
+const timeSeries = require('./dataModels/timeSeries');
 const config = require('./configService');
 const context = {
 	op: 'IoTAgentLoRaWAN.dataTranslation'
@@ -38,6 +39,7 @@ const context = {
 function toNgsi(payload, device) {
 	const ngsiAtts = [];
 	let decodedPayload = {};
+	let dataModel;
 	if (payload && device) {
 		if (device.internalAttributes) {
 			let lorawanConf = {};
@@ -53,10 +55,13 @@ function toNgsi(payload, device) {
 			}
 
 			if (lorawanConf) {
+				dataModel = lorawanConf.data_model;
 				if (lorawanConf.data_model === 'application_server') {
 					decodedPayload = payload;
 				} else if (lorawanConf.data_model === 'cbor') {
 					decodedPayload = cbor.decodePayload(payload);
+				} else if (lorawanConf.data_model === 'timeseries') {
+					decodedPayload = timeSeries.decodePayload(payload);
 				} else {
 					decodedPayload = cayenneLpp.decodePayload(payload);
 				}
@@ -70,23 +75,30 @@ function toNgsi(payload, device) {
 				if (decodedPayload) {
 					for (const field in decodedPayload) {
 						let value = decodedPayload[field];
+						let metadata;
+						if (dataModel === 'timeseries') {
+							// newest sample, the time it was taken and the series as metadata
+							metadata = value.metadata;
+							value = value.value;
+						}
 						for (let i = 0; i < device.active.length; i++) {
 							if (device.active[i].type === 'geo:point' && value.latitude && value.longitude) {
 								value = value.latitude + ',' + value.longitude;
 							}
 
-							if (field === device.active[i].name) {
-								ngsiAtts.push({
-									name: field,
-									type: device.active[i].type,
-									value
-								});
-							} else if (device.active[i].object_id && device.active[i].object_id === field) {
-								ngsiAtts.push({
+							if (
+								field === device.active[i].name ||
+								(device.active[i].object_id && device.active[i].object_id === field)
+							) {
+								const attribute = {
 									name: field,
 									type: device.active[i].type,
 									value
-								});
+								};
+								if (metadata) {
+									attribute.metadata = metadata;
+								}
+								ngsiAtts.push(attribute);
 							}
 						}
 					}
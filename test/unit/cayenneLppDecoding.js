@@ -23,6 +23,7 @@
 
 const decoder = require('../../lib/dataModels/cayenneLpp');
 const translator = require('../../lib/dataTranslationService');
+const firmwareFixture = require('./firmware/cayenne_lpp.json');
 require('chai').should();
 
 describe('CayenneLpp decoding', function () {
@@ -90,6 +91,15 @@ describe('CayenneLpp decoding', function () {
 		decodedMessage.gps_1.should.have.property('altitude', 10);
 		return done();
 	});
+
+	// Payloads encoded by cayenne_lpp.c, see examples/devices/stm32/Tests/fixtures
+	firmwareFixture.cases.forEach(function (fixture) {
+		it('Should decode a payload encoded by the device firmware: ' + fixture.description, function (done) {
+			const decodedMessage = decoder.decodeCayenneLpp(fixture.payload);
+			decodedMessage.should.deep.equal(fixture.expected);
+			return done();
+		});
+	});
 });
 
 describe('NGSI translation', function (done) {
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2019 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* eslint-disable no-unused-vars */
+
+const decoder = require('../../lib/dataModels/cbor');
+const firmwareFixture = require('./firmware/cbor_writer.json');
+require('chai').should();
+
+describe('CBOR decoding of device firmware payloads (cbor_writer.c)', function () {
+	// Payloads encoded by cbor_writer.c, see examples/devices/stm32/Tests/fixtures
+	firmwareFixture.cases.forEach(function (fixture) {
+		it('Should decode a payload encoded by the device firmware: ' + fixture.description, function (done) {
+			const decodedMessage = decoder.decodePayload(fixture.payload);
+			decodedMessage.should.be.an('object');
+			decodedMessage.should.deep.equal(fixture.expected);
+			return done();
+		});
+	});
+});
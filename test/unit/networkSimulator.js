@@ -0,0 +1,283 @@
+/*
+ * Copyright 2022 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* eslint-disable no-unused-vars */
+
+const lorawan = require('../../examples/network-simulator/lib/lorawan');
+const VirtualClock = require('../../examples/network-simulator/lib/clock').VirtualClock;
+const Radio = require('../../examples/network-simulator/lib/radio').Radio;
+const Device = require('../../examples/network-simulator/lib/device').Device;
+const NetworkServer = require('../../examples/network-simulator/lib/networkServer').NetworkServer;
+const retransPolicy = require('../../examples/network-simulator/lib/retransPolicy');
+require('chai').should();
+
+const appKey = Buffer.from('2b7e151628aed2a6abf7158809cf4f3c', 'hex');
+
+/**
+ * MQTT client keeping the messages published
+ */
+function fakeClient() {
+	return {
+		messages: [],
+		subscriptions: [],
+		subscribe(topic) {
+			this.subscriptions.push(topic);
+		},
+		publish(topic, message, options, callback) {
+			this.messages.push({ topic, message: JSON.parse(message) });
+			callback();
+		}
+	};
+}
+
+/**
+ * One device and the network server on a virtual clock
+ */
+function network(provider, confirmed) {
+	const clock = new VirtualClock(0);
+	const client = fakeClient();
+	const devices = new Map([['0102030405060708', { deviceId: 'sim-000000', appKey }]]);
+	const ns = new NetworkServer({ provider, applicationId: 'demoApp', devices }, clock, client);
+	const radio = new Radio(clock, (frame, rxInfo, sender) => ns.receive(frame, rxInfo, sender));
+	const device = new Device(
+		{
+			devEui: '0102030405060708',
+			appEui: '70b3d57ed00006b2',
+			appKey: appKey.toString('hex'),
+			sf: 7,
+			period: 60000,
+			confirmed
+		},
+		clock,
+		radio
+	);
+	ns.start();
+	device.start(0);
+	return { clock, client, ns, device };
+}
+
+describe('Network simulator', function () {
+	describe('LoRaWAN frames', function () {
+		it('Should compute the AES-CMAC of RFC 4493', function (done) {
+			const key = Buffer.from('2b7e151628aed2a6abf7158809cf4f3c', 'hex');
+			const message = Buffer.from('6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411', 'hex');
+			lorawan.cmac(key, Buffer.alloc(0)).toString('hex').should.equal('bb1d6929e95937287fa37d129b756746');
+			lorawan.cmac(key, message.subarray(0, 16)).toString('hex').should.equal('070a16b46b4d4144f79bdd9dd04a287c');
+			lorawan.cmac(key, message.subarray(0, 40)).toString('hex').should.equal('dfa66747de9ae63030ca32611497c827');
+			return done();
+		});
+
+		it('Should build the join-request of the end node LoRaMac stack', function (done) {
+			const frame = lorawan.buildJoinRequest({
+				appEui: '70b3d57ed00006b2',
+				devEui: '0102030405060708',
+				devNonce: 0x0e1c,
+				appKey
+			});
+			frame.toString('hex').should.equal('00b20600d07ed5b37008070605040302011c0e0d19ba0f');
+			lorawan.verifyJoinRequest(frame, appKey).should.equal(true);
+			return done();
+		});
+
+		it('Should decrypt an uplink of the end node LoRaMac stack', function (done) {
+			const keys = lorawan.deriveSessionKeys(appKey, 0x123456, 0x13, 0x0e1c);
+			const msg = lorawan.parseDataFrame(Buffer.from('40da1b012600070002a9d9cab91685fd4ca70246', 'hex'));
+			msg.should.have.property('devAddr', 0x26011bda);
+			msg.should.have.property('fCnt', 7);
+			msg.should.have.property('fPort', 2);
+			lorawan
+				.unsecureDataFrame(msg, 7, keys.nwkSKey, keys.appSKey)
+				.toString('hex')
+				.should.equal('01670110026850');
+			(lorawan.unsecureDataFrame(msg, 8, keys.nwkSKey, keys.appSKey) === null).should.equal(true);
+			return done();
+		});
+
+		it('Should decrypt its own join-accept', function (done) {
+			const frame = lorawan.buildJoinAccept({
+				joinNonce: 0x123456,
+				netId: 0x13,
+				devAddr: 0x26011bda,
+				dlSettings: 3,
+				rxDelay: 1,
+				appKey
+			});
+			const accept = lorawan.parseJoinAccept(frame, appKey);
+			accept.should.have.property('devAddr', 0x26011bda);
+			accept.should.have.property('joinNonce', 0x123456);
+			(lorawan.parseJoinAccept(frame, Buffer.alloc(16)) === null).should.equal(true);
+			return done();
+		});
+
+		it('Should reject the data frames too short for their FOpts', function (done) {
+			(lorawan.parseDataFrame(Buffer.alloc(11)) === null).should.equal(true);
+			(lorawan.parseDataFrame(Buffer.from('40da1b01260200070001020304', 'hex')) === null).should.equal(true);
+			lorawan.parseDataFrame(Buffer.from('40da1b012600000001020304', 'hex')).should.have.property('fPort', null);
+			return done();
+		});
+	});
+
+	describe('Virtual clock', function () {
+		it('Should hold the events until every hold is released', function (done) {
+			const clock = new VirtualClock(0);
+			const handled = [];
+
+			clock.at(10, () => {
+				handled.push(10);
+				clock.hold();
+				setTimeout(() => {
+					// Scheduled while held, still before the next event
+					clock.at(15, () => handled.push(15));
+					clock.release();
+				}, 20);
+			});
+			clock.at(20, () => handled.push(20));
+			clock.hold();
+			setImmediate(() => {
+				handled.length.should.equal(0);
+				clock.release();
+			});
+			clock.run(100, function () {
+				handled.should.eql([10, 15, 20]);
+				clock.now.should.equal(100);
+				return done();
+			});
+		});
+	});
+
+	describe('Network server stand-in', function () {
+		it('Should join the device and publish its uplinks in TTN format', function (done) {
+			const net = network('ttn');
+			net.client.subscriptions.should.eql(['v3/demoApp/devices/+/down/push']);
+			net.clock.run(150000, function () {
+				net.ns.stats.should.have.property('joins', 1);
+				net.client.messages.length.should.be.above(1);
+				const uplink = net.client.messages[0];
+				uplink.topic.should.equal('v3/demoApp/devices/sim-000000/up');
+				uplink.message.should.have.property('hardware_serial', '0102030405060708');
+				uplink.message.uplink_message.should.have.property('f_cnt', 0);
+				Buffer.from(uplink.message.payload_raw, 'base64')
+					.toString('hex')
+					.should.match(/^00650000/);
+				return done();
+			});
+		});
+
+		it('Should publish the uplinks in ChirpStack format', function (done) {
+			const net = network('chirpstack');
+			net.clock.run(90000, function () {
+				const uplink = net.client.messages[0];
+				uplink.topic.should.equal('application/demoApp/device/0102030405060708/event/up');
+				uplink.message.should.have.property('devEUI', '0102030405060708');
+				uplink.message.should.have.property('deviceName', 'sim-000000');
+				uplink.message.should.have.property('fPort', 2);
+				return done();
+			});
+		});
+
+		it('Should send a downlink pushed on the broker after the next uplink', function (done) {
+			const net = network('chirpstack');
+			net.clock.run(90000, function () {
+				net.ns
+					.handleMessage(
+						'application/demoApp/device/0102030405060708/command/down',
+						JSON.stringify({ confirmed: false, fPort: 10, data: 'AQI=' })
+					)
+					.should.equal(true);
+				net.clock.run(160000, function () {
+					net.ns.stats.should.have.property('downlinksSent', 1);
+					net.device.stats.should.have.property('downlinks', 1);
+					net.client.messages
+						.filter((m) => m.topic.endsWith('/event/txack'))
+						.length.should.equal(1);
+					return done();
+				});
+			});
+		});
+
+		it('Should drop the replayed uplinks', function (done) {
+			const net = network('ttn');
+			let replayed;
+			const receive = net.ns.receive.bind(net.ns);
+			net.ns.receive = function (frame, rxInfo, sender) {
+				if ((frame[0] & 0xe0) === lorawan.MHDR_UNCONFIRMED_UP && !replayed) {
+					replayed = frame;
+				}
+				receive(frame, rxInfo, sender);
+			};
+			net.clock.run(150000, function () {
+				net.ns.receive(replayed, { time: net.clock.now }, net.device);
+				net.ns.stats.should.have.property('replays', 1);
+				return done();
+			});
+		});
+
+		it('Should acknowledge again a confirmed uplink whose ACK was lost', function (done) {
+			const net = network('ttn', true);
+			let lost = false;
+			const receive = net.device.receive.bind(net.device);
+			net.device.receive = function (frame) {
+				if ((frame[0] & 0xe0) === lorawan.MHDR_UNCONFIRMED_DOWN && !lost) {
+					lost = true;
+					return;
+				}
+				receive(frame);
+			};
+			net.clock.run(90000, function () {
+				const confirmed = net.device.stats.confirmed;
+				net.ns.stats.retransmissions.should.be.above(0);
+				net.ns.stats.should.have.property('published', confirmed);
+				net.device.stats.should.have.property('acked', confirmed);
+				net.device.stats.should.have.property(
+					'confirmedTransmissions',
+					confirmed + net.ns.stats.retransmissions
+				);
+				return done();
+			});
+		});
+	});
+
+	describe('Retransmission policies', function () {
+		it('Should lower the trials of the adaptive policy with the ACK rate', function (done) {
+			const policy = retransPolicy.create('adaptive', () => 0.5);
+			policy.nbTrials(8).should.equal(8);
+			policy.onResult(false, 8);
+			policy.nbTrials(8).should.equal(3);
+			policy.stepDownDatarate(2).should.equal(false);
+			policy.onResult(true, 1);
+			policy.nbTrials(8).should.equal(4);
+			retransPolicy.create('stock').nbTrials(20).should.equal(retransPolicy.MAX_ACK_RETRIES);
+			return done();
+		});
+
+		it('Should double the back-off of the adaptive policy up to its maximum', function (done) {
+			const policy = retransPolicy.create('adaptive', () => 0.5);
+			policy.backoff(1).should.equal(2000);
+			policy.backoff(2).should.equal(4000);
+			policy.backoff(9).should.equal(32000);
+			policy.isStale(1000).should.equal(false);
+			policy.fresherData();
+			policy.isStale(1000).should.equal(true);
+			policy.isStale(60000).should.equal(true);
+			return done();
+		});
+	});
+});
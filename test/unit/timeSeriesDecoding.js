@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019 Atos Spain S.A
+ *
+ * This file is part of iotagent-lora
+ *
+ * iotagent-lora is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * iotagent-lora is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public
+ * License along with iotagent-lora.
+ * If not, seehttp://www.gnu.org/licenses/.
+ *
+ */
+
+/* eslint-disable no-unused-vars */
+
+const decoder = require('../../lib/dataModels/timeSeries');
+const translator = require('../../lib/dataTranslationService');
+const trace = require('../timeSeries/sensorTrace.json');
+const firmwareFixture = require('./firmware/time_series.json');
+require('chai').should();
+
+// LoRaWAN MAC header, frame header, port and MIC of an uplink without options
+const LORAWAN_OVERHEAD = 13;
+
+describe('Time series decoding of device firmware payloads (time_series.c)', function () {
+	// Payloads encoded by time_series.c, see examples/devices/stm32/Tests/fixtures
+	firmwareFixture.cases.forEach(function (fixture) {
+		it('Should decode a payload encoded by the device firmware: ' + fixture.description, function (done) {
+			const series = decoder.decodeTimeSeries(fixture.payload);
+			series.should.deep.equal(fixture.expected);
+			return done();
+		});
+	});
+
+	it('Should report the newest scaled value of each channel with its timestamped series', function (done) {
+		const before = Date.now();
+		const decodedMessage = decoder.decodePayload(firmwareFixture.cases[0].payload);
+		const after = Date.now();
+		decodedMessage.should.have.all.keys('0', '1', '2');
+		decodedMessage['0'].should.have.property('value', 1013.2);
+		decodedMessage['1'].should.have.property('value', 21.53);
+		decodedMessage['2'].should.have.property('value', 48.5);
+		const series = decodedMessage['1'].metadata.series.value;
+		series.map((sample) => sample.value).should.deep.equal([21.68, 21.71, 21.6, 21.49, 21.53]);
+		decodedMessage['1'].metadata.TimeInstant.should.deep.equal({ type: 'DateTime', value: series[4].timestamp });
+		const times = series.map((sample) => Date.parse(sample.timestamp));
+		times[4].should.be.within(before - 250, after - 250);
+		for (let i = 1; i < times.length; i++) {
+			(times[i] - times[i - 1]).should.equal(1000);
+		}
+		return done();
+	});
+
+	it('Should reject unknown versions and truncated messages', function (done) {
+		(decoder.decodePayload('AgMF+gHoB6ieAdIhygcBBwQAFgEEFgsFBQE=') === undefined).should.equal(true);
+		(decoder.decodePayload('AQMF+gHoB6ieAdIhygcBBwQAFgEEFgsF') === undefined).should.equal(true);
+		(decoder.decodePayload('AQMA+gHoB6ieAdIhygc=') === undefined).should.equal(true);
+		return done();
+	});
+
+	firmwareFixture.cases
+		.filter((fixture) => fixture.description.startsWith('sensor trace'))
+		.forEach(function (fixture) {
+			it('Should round trip the ' + fixture.description + ' at least 3 times smaller', function (done) {
+				const payload = Buffer.from(fixture.payload, 'base64');
+				const series = decoder.decodeTimeSeries(fixture.payload);
+				const nbSamples = series.channels[0].length;
+				nbSamples.should.be.above(1);
+				for (let channel = 0; channel < series.channels.length; channel++) {
+					series.channels[channel].should.deep.equal(
+						trace.samples.slice(-nbSamples).map((sample) => sample[channel])
+					);
+				}
+
+				// against one uplink per sample of 16 bit values
+				const ratio =
+					(nbSamples * (LORAWAN_OVERHEAD + 2 * series.channels.length)) / (LORAWAN_OVERHEAD + payload.length);
+				ratio.should.be.above(3);
+				return done();
+			});
+		});
+});
+
+describe('NGSI translation of time series', function () {
+	const device = {
+		active: [
+			{ object_id: '0', name: 'pressure', type: 'Number' },
+			{ object_id: '1', name: 'temperature', type: 'Number' },
+			{ object_id: '2', name: 'humidity', type: 'Number' }
+		],
+		internalAttributes: {
+			lorawan: {
+				data_model: 'timeseries'
+			}
+		}
+	};
+
+	it('Should translate each channel to its newest scaled value, with the series as metadata', function (done) {
+		const ngsiAtts = translator.toNgsi(firmwareFixture.cases[0].payload, device);
+		ngsiAtts.should.be.an('array');
+		ngsiAtts.should.have.length(3);
+		ngsiAtts.map((attribute) => attribute.value).should.deep.equal([1013.2, 21.53, 48.5]);
+		ngsiAtts.forEach(function (attribute) {
+			attribute.should.have.property('type', 'Number');
+			attribute.metadata.TimeInstant.should.have.property('type', 'DateTime');
+			attribute.metadata.series.should.have.property('type', 'StructuredValue');
+			attribute.metadata.series.value.should.have.length(5);
+			attribute.metadata.TimeInstant.value.should.equal(attribute.metadata.series.value[4].timestamp);
+		});
+		ngsiAtts[0].metadata.series.value
+			.map((sample) => sample.value)
+			.should.deep.equal([1013, 1013.3, 1013.1, 1013.1, 1013.2]);
+		return done();
+	});
+});